@@ -4,7 +4,24 @@
  *
  * This file contains the implementation of a simple DSP practice
  * using the RP2040 microcontroller. It reads ADC values periodically
- * and sends the data over UART.
+ * and sends the data over UART in binary frames of FRAME_SAMPLES samples
+ * (see sample_frame.h).
+ *
+ * The ADC runs OVERSAMPLING times faster than the output rate (500 kS/s by default), and a
+ * 4th-order CIC decimator with a droop compensation FIR (oversample_process() in
+ * fixed_filter.h) turns the conversions into 16-bit samples with 13 to 15 effective bits
+ * (about 13.5 bits at the default factor of 50 with an LSB of noise). They are sent as RAW16 frames.
+ *
+ * By default the sample instants are set by the ADC's own clock divider and the samples are
+ * moved by DMA (see adc_capture.h), so they do not depend on how long the main loop takes.
+ * The original timer-flag method is kept as SAMPLING_TIMER for comparison. In both modes the
+ * timing is measured with the 64-bit timer and reported once per STATUS_PERIOD_US in a status
+ * frame (see capture_stats.h): min/max/mean interval, jitter and overrun counts.
+ *
+ * The peripherals are reached through libs/hal, so with HAL_HOST the program runs as a Linux
+ * executable on the HAL simulator (hal_sim.h). The simulator has no ADC DMA, so the host build
+ * uses SAMPLING_TIMER, where each sample's OVERSAMPLING conversions must fit in SAMPLE_TIME;
+ * its build decimates by 32 instead of 50.
  *
  * @author Adrián Silva Palafox
  *
@@ -12,90 +29,227 @@
  */
 
 #include <stdio.h>
+#include "hal.h"
+#ifndef HAL_HOST
 #include "pico/stdlib.h"
 #include "hardware/pll.h"
 #include "hardware/clocks.h"
 #include "hardware/structs/pll.h"
 #include "hardware/structs/clocks.h"
-#include "hardware/timer.h"
-#include "hardware/uart.h"
-#include "hardware/adc.h"
+#include "adc_capture.h"
+#endif
+#include "sample_frame.h"
+#include "capture_stats.h"
+#include "fixed_filter.h"
+#include "build_config.h"
 
 // PINOUTS MCU
-#define ADC_PIN 26     ///< The GPIO pin used for ADC input.
 #define UART0_TX_PIN 0 ///< The GPIO pin used for UART0 transmit.
 #define UART0_RX_PIN 1 ///< The GPIO pin used for UART0 receive.
 
 // UART PARAMS
-#define BAUD_RATE 115200 ///< The baud rate for UART communication.
+#define BAUD_RATE CFG_LINK_BAUD ///< The baud rate for UART communication (build parameter).
+
+// FRAME PARAMS
+#define ADC_INPUT 0                     ///< ADC input 0 (GPIO26).
+#define FRAME_SAMPLES CFG_BLOCK_LENGTH  ///< Samples sent in each binary frame (build parameter).
+
+// SAMPLING PARAMS
+#define SAMPLING_ADC_CLOCK 0             ///< ADC paced by its clock divider, DMA into a ping-pong buffer.
+#define SAMPLING_TIMER 1                 ///< Repeating timer sets a flag, the main loop reads the ADC.
+#ifdef HAL_HOST
+#define SAMPLING_MODE SAMPLING_TIMER     ///< Sampling method in use; no ADC DMA on the host.
+#else
+#define SAMPLING_MODE SAMPLING_ADC_CLOCK ///< Sampling method in use.
+#endif
+#define OVERSAMPLING CFG_OVERSAMPLING    ///< ADC conversions decimated into each sample, 4 to 256 (build parameter).
+#define SAMPLE_TIME CFG_SAMPLE_PERIOD_US ///< The time between samples, in microseconds (build parameter).
+#define STATUS_PERIOD_US 1000000         ///< Time between two status frames, in microseconds.
+
+#define ADC_CONVERSION_US 2              ///< One blocking conversion: 96 cycles of the 48 MHz ADC clock.
+#define TIMER_MARGIN_US 20               ///< Time a timer-paced sample must leave for decimating and framing.
+
+#if SAMPLING_MODE == SAMPLING_TIMER && !CFG_SAMPLE_PERIOD_EXACT
+#error "SAMPLING_TIMER needs a sample rate with a whole number of microseconds per sample"
+#endif
+
+#if SAMPLING_MODE == SAMPLING_TIMER
+// The conversions of a sample are read back to back after its tick. If they fill the period,
+// the loop starts every sample a little later than the last until a tick finds the previous
+// one still pending and the sample is lost (1% of them at OVERSAMPLING 50 and 10 kS/s).
+_Static_assert(OVERSAMPLING * ADC_CONVERSION_US + TIMER_MARGIN_US <= SAMPLE_TIME,
+               "SAMPLING_TIMER: the OVERSAMPLING conversions of a sample do not fit in SAMPLE_TIME");
+#endif
 
 // PROTOTYPES
-volatile bool timer_flag = false;           ///< A flag to indicate that the timer has fired.
-bool timer_callback(repeating_timer_t *rt); ///< The callback function for the repeating timer.
+volatile bool timer_flag = false;     ///< A flag to indicate that the timer has fired.
+bool timer_callback(hal_timer_t *rt); ///< The callback function for the repeating timer.
 
 // GLOBAL
-const int64_t SAMPLE_TIME = 100; ///< The time between ADC samples, in microseconds.
 volatile uint32_t adc_value;     ///< A variable to store the ADC value.
-char buffer[10];                 ///< A buffer to store the string to be transmitted over UART.
+uint16_t samples[FRAME_SAMPLES]; ///< Samples waiting to be sent (16-bit, ADC code * 16).
+uint16_t n_samples = 0;          ///< Number of samples currently in samples[].
+uint16_t frame_seq = 0;          ///< Sequence number of the next frame.
+uint8_t frame[SAMPLE_FRAME_WORDS16_LEN(FRAME_SAMPLES)]; ///< Encoded frame being transmitted.
+uint8_t status_frame[SAMPLE_FRAME_STATUS_LEN(CAPTURE_STATS_FIELDS)]; ///< Encoded status frame.
+capture_stats_t stats;           ///< Sample timing statistics.
+uint64_t last_status = 0;        ///< Time the last status frame was sent.
+volatile uint32_t missed_ticks;  ///< Timer ticks that found the previous one still pending.
+
+// The compensation taps (cfg_cic_comp_taps) are designed for OVERSAMPLING by the build (build_config.h)
+static q15_t comp_state[2 * CFG_CIC_COMP_TAPS]; ///< Compensation FIR delay line.
+static oversample_t oversampler;                ///< CIC decimator + compensation FIR.
+
+#if SAMPLING_MODE == SAMPLING_ADC_CLOCK
+static uint16_t adc_buffer[2 * CFG_DMA_TRANSFERS]; ///< Ping-pong storage written by DMA.
+static adc_capture_t capture;                                 ///< ADC + DMA capture engine.
+#endif
+
+/**
+ * @brief Writes a binary frame to stdout without CR/LF translation.
+ *
+ * @param data Encoded frame.
+ * @param len Frame length in bytes.
+ */
+static void send_frame(const uint8_t *data, size_t len)
+{
+    hal_stdio_write(data, len);
+}
+
+/**
+ * @brief Sends the samples collected so far as one binary frame.
+ */
+static void flush_samples(void)
+{
+    // A frame of 64 16-bit samples is 138 bytes (2.16 bytes/sample) instead of ~6 characters
+    // per sample as text.
+    size_t len = sample_frame_encode16(frame, sizeof(frame), SAMPLE_FRAME_TYPE_RAW16, ADC_INPUT, frame_seq++,
+                                       samples, n_samples);
+    send_frame(frame, len);
+    n_samples = 0;
+}
+
+/**
+ * @brief Sends a status frame with the timing statistics of the last period, then starts a
+ * new period. Status frames share the data frames' sequence counter.
+ */
+static void send_status(void)
+{
+    capture_stats_report_t report;
+    uint32_t fields[CAPTURE_STATS_FIELDS];
+
+    capture_stats_report(&stats, &report);
+    capture_stats_to_fields(&report, fields);
+    size_t len = sample_frame_encode_status(status_frame, sizeof(status_frame), ADC_INPUT, frame_seq++,
+                                            fields, CAPTURE_STATS_FIELDS);
+    send_frame(status_frame, len);
+    capture_stats_restart(&stats);
+}
 
 /**
  * @brief The main function of the program.
  *
- * This function initializes the necessary peripherals (stdio, UART, ADC), sets up a repeating timer
- * to trigger ADC readings, and then enters an infinite loop to process the ADC data.
+ * This function initializes the necessary peripherals (stdio, UART, ADC), starts the sampling
+ * (free-running ADC + DMA, or a repeating timer), and then enters an infinite loop to process
+ * the ADC data and send the periodic status frames.
  *
  * @return int This function should not return.
  */
 int main()
 {
     // Initialize all standard I/O
-    stdio_init_all();
-    // Initialize UART0 with the specified baud rate
-    uart_init(uart0, BAUD_RATE);
-    // Initialize the ADC
-    adc_init();
-
-    // Create a repeating timer that calls timer_callback every SAMPLE_TIME microseconds
-    repeating_timer_t timer;
-    add_repeating_timer_us(SAMPLE_TIME, timer_callback, NULL, &timer);
-
-    // Set the GPIO function for the UART pins
-    gpio_set_function(UART0_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(UART0_RX_PIN, GPIO_FUNC_UART);
-
-    // Initialize the ADC GPIO pin
-    adc_gpio_init(ADC_PIN);
-    // Select ADC input 0 (GPIO26)
-    adc_select_input(0);
+    hal_init();
+    // Initialize UART0 with the specified baud rate on its pins
+    hal_uart_init(0, BAUD_RATE, UART0_TX_PIN, UART0_RX_PIN);
+    // Initialize the ADC and select input 0 (GPIO26)
+    hal_adc_init(ADC_INPUT);
 
+    printf("Code running OK :)\n");
+#ifndef HAL_HOST
     // Get and print the clock frequencies
     uint f_clk_sys = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_SYS);
     uint f_clk_adc = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_ADC);
-    printf("Code running OK :)\n");
     printf("clk_adc  = %dkHz\n", f_clk_adc);
     printf("clk_sys  = %dkHz\n", f_clk_sys);
-    sleep_ms(5000);
+#endif
+    hal_sleep_us(5000000);
+
+    oversample_init(&oversampler, OVERSAMPLING, cfg_cic_comp_taps, CFG_CIC_COMP_TAPS, comp_state);
+
+#if SAMPLING_MODE == SAMPLING_ADC_CLOCK
+    // The ADC converts OVERSAMPLING times per SAMPLE_TIME; one half of the ping-pong buffer
+    // holds one frame worth of conversions.
+    adc_capture_init(&capture, ADC_INPUT, CFG_ADC_RATE_HZ, adc_buffer, CFG_DMA_TRANSFERS);
+    capture_stats_init(&stats, CFG_BLOCK_PERIOD_US);
+    uint32_t seen_overruns = 0;
+    adc_capture_start(&capture);
+#else
+    // Create a repeating timer that calls timer_callback every SAMPLE_TIME microseconds
+    hal_timer_t timer;
+    capture_stats_init(&stats, SAMPLE_TIME);
+    hal_timer_start(&timer, SAMPLE_TIME, timer_callback, NULL);
+#endif
+    last_status = hal_time_us();
 
     // Infinite loop
     while (true)
     {
+#if SAMPLING_MODE == SAMPLING_ADC_CLOCK
+        // Check if a half of the buffer is full
+        uint32_t seq;
+        const uint16_t *block = adc_capture_acquire(&capture, &seq);
+        if (block != NULL)
+        {
+            // The DMA interrupt stamped the block when its last conversion landed.
+            capture_stats_record(&stats, pingpong_stamp(&capture.pp, seq));
+
+            // Decimate the half to one frame of 16-bit samples. A half is FRAME_SAMPLES *
+            // OVERSAMPLING conversions, so it always yields exactly FRAME_SAMPLES outputs.
+            n_samples += (uint16_t)oversample_process(&oversampler, block, &samples[n_samples], CFG_DMA_TRANSFERS);
+            adc_capture_release(&capture);
+
+            uint32_t overruns = capture.pp.overruns;
+            capture_stats_add_overruns(&stats, overruns - seen_overruns);
+            seen_overruns = overruns;
+
+            flush_samples();
+        }
+#else
         // Check if the timer has fired
         if (timer_flag)
         {
             // Reset the timer flag
             timer_flag = false;
 
-            // Oversampling and averaging to reduce noise
-            adc_value = 0;
-            for (int i = 0; i < 4; i++)
+            // The sample instant is whenever the loop got here, not when the timer fired.
+            capture_stats_record(&stats, hal_time_us());
+            uint32_t missed = missed_ticks;
+            missed_ticks = 0;
+            capture_stats_add_overruns(&stats, missed);
+
+            // A burst of OVERSAMPLING conversions decimated to one 16-bit sample
+            uint16_t burst[OVERSAMPLING];
+            for (unsigned i = 0; i < OVERSAMPLING; i++)
+            {
+                burst[i] = hal_adc_read();
+            }
+            oversample_process(&oversampler, burst, &samples[n_samples], OVERSAMPLING);
+            adc_value = samples[n_samples++];
+
+            // Collect samples and send them as one binary frame.
+            if (n_samples == FRAME_SAMPLES)
             {
-                adc_value += adc_read();
+                flush_samples();
             }
-            adc_value /= 4;
+        }
+#endif
 
-            // Print the ADC value to the console. This data can be captured by a Python script for further analysis.
-            printf("%d\n", adc_value); // It takes approximately 434.028us to transmit 5 characters at 115200 baudrate
+        if (hal_time_us() - last_status >= STATUS_PERIOD_US)
+        {
+            last_status = hal_time_us();
+            send_status();
         }
+        hal_idle();
     }
 }
 
@@ -103,12 +257,19 @@ int main()
  * @brief The callback function for the repeating timer.
  *
  * This function is called every time the repeating timer fires. It sets the timer_flag to true.
+ * If the previous tick has not been serviced yet, that sample is lost and counted.
  *
- * @param rt A pointer to the repeating_timer_t structure.
+ * @param rt A pointer to the repeating timer.
  * @return bool Always returns true to keep the timer repeating.
  */
-bool timer_callback(repeating_timer_t *rt)
+bool timer_callback(hal_timer_t *rt)
 {
+    (void)rt;
+
+    if (timer_flag)
+    {
+        missed_ticks++;
+    }
     timer_flag = true;
     return true;
 }
\ No newline at end of file
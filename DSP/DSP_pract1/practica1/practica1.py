@@ -4,21 +4,24 @@ import serial
 import numpy as np
 import matplotlib.pyplot as plt
 from time import sleep
+import os
+import sys
+
+# Decodificador de tramas binarias compartido con el firmware (libs/sample_frame)
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'libs', 'sample_frame'))
+from sample_frame import read_samples, TYPE_RAW16
 
 def adquirir_datos(puerto='COM3', muestras=1000):
-    ser = serial.Serial(puerto, 115200)
+    ser = serial.Serial(puerto, 460800, timeout=1)  # LINK_BAUD del firmware
     sleep(2)  # Esperar a que el puerto serial esté listo
 
-    # Leer datos
-    datos = []
-    for i in range(muestras):
-        if ser.in_waiting:
-            linea = ser.readline()
-            valor = int(linea.decode().strip())
-            datos.append(valor)
+    # Leer tramas binarias hasta juntar las muestras pedidas. Son muestras de 16 bits
+    # sobremuestreadas (código ADC * 16), así que se dividen entre 16 para volver a la escala del ADC
+    ser.reset_input_buffer()
+    datos = read_samples(ser, muestras, frame_type=TYPE_RAW16) / 16.0
 
     ser.close()
-    return np.array(datos)
+    return datos
 
 def cuantizar(datos, bits):
     niveles = 2**bits
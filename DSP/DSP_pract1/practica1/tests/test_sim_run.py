@@ -0,0 +1,155 @@
+"""
+@brief Runs the DSP_pract1 host build on the HAL simulator and checks the frames it sends.
+
+The simulated ADC plays a 97 Hz sine with uniform noise. Every sample must arrive: the
+frames decode without CRC errors or sequence gaps, the status frames report no overruns,
+and the simulator made exactly OVERSAMPLING conversions per timer tick. The decimated
+samples must then follow the sine, at its amplitude and offset (ADC code * 16), with more
+effective bits than the conversions they come from.
+
+The frames are read with struct and binascii so the test runs without numpy.
+
+Usage: python test_sim_run.py <path to the DSP_pract1 host executable> <OVERSAMPLING>
+"""
+
+import binascii
+import math
+import os
+import re
+import struct
+import subprocess
+import sys
+
+SYNC = b'\xA5\x5A'
+TYPE_STATUS = 0x04
+TYPE_RAW16 = 0x05
+STATUS_FIELDS = ('nominal_us', 'intervals', 'min_interval', 'max_interval', 'mean_interval',
+                 'max_jitter', 'mean_jitter', 'late', 'overruns')
+
+SECONDS = 8           # Virtual run time: the 5 s start-up delay and 3 s of samples
+FRAME_SAMPLES = 64    # FRAME_SAMPLES of the default configuration
+SAMPLE_RATE_HZ = 10000
+SINE = (2048, 1500, 97, 4)  # offset, amplitude, frequency, noise of the simulated input
+
+checks = 0
+failures = 0
+
+def check(cond, what):
+    """@brief Counts a check and reports it on stderr if it failed."""
+    global checks, failures
+    checks += 1
+    if not cond:
+        failures += 1
+        print(f"test_sim_run.py: {what} failed", file=sys.stderr)
+
+def frames(data):
+    """@brief Yields (type, channel, seq, payload) for each frame in a stream, and None for
+    each frame with a bad CRC."""
+    pos = data.find(SYNC)
+    while pos >= 0 and pos + 8 <= len(data):
+        frame_type, channel, seq, count = struct.unpack_from('<BBHH', data, pos + 2)
+        words = {TYPE_STATUS: 2, TYPE_RAW16: 1}.get(frame_type)
+        end = pos + 8 + 2 * (words or 0) * count + 2
+        if words is None or end > len(data):
+            pos = data.find(SYNC, pos + 1)
+            continue
+        (crc,) = struct.unpack_from('<H', data, end - 2)
+        if binascii.crc_hqx(data[pos + 2:end - 2], 0xFFFF) != crc:
+            yield None
+            pos = data.find(SYNC, pos + 1)
+            continue
+        yield frame_type, channel, seq, data[pos + 8:end - 2]
+        pos = data.find(SYNC, end)
+
+def fit_sine(samples, freq_hz, rate_hz):
+    """@brief Least-squares fit of a + b cos + c sin at a known frequency; returns the
+    offset, the amplitude and the rms of the residual."""
+    rows = []
+    for k in range(len(samples)):
+        w = 2 * math.pi * freq_hz * k / rate_hz
+        rows.append((1.0, math.cos(w), math.sin(w)))
+    ata = [[sum(r[i] * r[j] for r in rows) for j in range(3)] for i in range(3)]
+    aty = [sum(r[i] * y for r, y in zip(rows, samples)) for i in range(3)]
+
+    # Gaussian elimination on the 3x3 normal equations
+    m = [ata[i] + [aty[i]] for i in range(3)]
+    for i in range(3):
+        for j in range(i + 1, 3):
+            f = m[j][i] / m[i][i]
+            m[j] = [a - f * b for a, b in zip(m[j], m[i])]
+    x = [0.0] * 3
+    for i in reversed(range(3)):
+        x[i] = (m[i][3] - sum(m[i][j] * x[j] for j in range(i + 1, 3))) / m[i][i]
+
+    resid = [y - sum(c * v for c, v in zip(x, r)) for r, y in zip(rows, samples)]
+    rms = math.sqrt(sum(e * e for e in resid) / len(resid))
+    return x[0], math.hypot(x[1], x[2]), rms
+
+def enob(rms, full_scale):
+    """@brief Effective bits of a full-scale sine against an error of this rms."""
+    sinad = 20 * math.log10(full_scale / math.sqrt(2) / rms)
+    return (sinad - 1.76) / 6.02
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: python test_sim_run.py <DSP_pract1> <OVERSAMPLING>")
+        return 2
+    oversampling = int(sys.argv[2])
+    env = dict(os.environ, HAL_SIM_SECONDS=str(SECONDS), HAL_SIM_ADC0='sine,%d,%d,%d,%d' % SINE)
+    run = subprocess.run([sys.argv[1]], env=env, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                         timeout=60)
+    check(run.returncode == 0, "exit status")
+
+    # Every tick was served with a full burst of conversions
+    summary = re.search(rb'(\d+) ADC reads, (\d+) timer calls', run.stderr)
+    check(summary is not None, "simulator summary")
+    if summary:
+        reads, ticks = int(summary.group(1)), int(summary.group(2))
+        check(ticks >= (SECONDS - 5) * SAMPLE_RATE_HZ - 1, f"timer ticks {ticks}")
+        check(reads == oversampling * ticks, f"{reads} ADC reads for {ticks} ticks")
+
+    samples = []
+    status = []
+    seqs = []
+    crc_errors = 0
+    for f in frames(run.stdout):
+        if f is None:
+            crc_errors += 1
+            continue
+        frame_type, channel, seq, payload = f
+        check(channel == 0, "channel")
+        seqs.append(seq)
+        if frame_type == TYPE_RAW16:
+            check(len(payload) == 2 * FRAME_SAMPLES, "RAW16 frame length")
+            samples += struct.unpack('<%dH' % (len(payload) // 2), payload)
+        else:
+            status.append(dict(zip(STATUS_FIELDS, struct.unpack('<%dI' % (len(payload) // 4), payload))))
+    check(crc_errors == 0, "no CRC errors")
+    check(all(b == (a + 1) & 0xFFFF for a, b in zip(seqs, seqs[1:])), "no sequence gaps")
+
+    # A status frame a second once sampling starts; the run ends as the third is due
+    check(len(status) == SECONDS - 5 - 1, f"status frames {len(status)}")
+    for s in status:
+        check(s['overruns'] == 0, f"overruns in {s}")
+        check(s['nominal_us'] == 1000000 // SAMPLE_RATE_HZ, "nominal interval")
+        check(s['intervals'] >= SAMPLE_RATE_HZ - 1, f"intervals in {s}")
+        check(s['max_interval'] <= 1000000 // SAMPLE_RATE_HZ + 1, f"max interval in {s}")
+
+    # The samples follow the input; the first frame holds the CIC and FIR start-up
+    check(len(samples) >= (SECONDS - 5) * SAMPLE_RATE_HZ - FRAME_SAMPLES, f"samples {len(samples)}")
+    offset, amplitude, rms = fit_sine(samples[FRAME_SAMPLES:], SINE[2], SAMPLE_RATE_HZ)
+    check(abs(offset - 16 * SINE[0]) < 16, f"offset {offset / 16:.2f} codes")
+    check(abs(amplitude - 16 * SINE[1]) < 0.01 * 16 * SINE[1], f"amplitude {amplitude / 16:.2f} codes")
+
+    # Uniform noise of +-4 codes leaves the conversions about 10 effective bits; decimating by
+    # OVERSAMPLING should add at least half a bit per doubling
+    bits_in = enob(math.sqrt(SINE[3] ** 2 / 3 + 1 / 12), 4096)
+    bits_out = enob(rms / 16, 4096)
+    check(bits_out >= bits_in + 0.5 * math.log2(oversampling) - 0.25,
+          f"{bits_out:.2f} effective bits from {bits_in:.2f}")
+
+    print(f"sim_run.py: {checks} checks, {failures} failed ({bits_in:.2f} -> {bits_out:.2f} effective bits)")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
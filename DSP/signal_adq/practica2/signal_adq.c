@@ -22,6 +22,9 @@
 // ADC defines
 #define ADC_PIN 26        ///< ADC pin
 #define BUFFER_LENGTH 256 ///< Buffer length
+#define SAMPLE_RATE_HZ 5000                        ///< Sampling rate
+#define SAMPLE_PERIOD_US (1000000 / SAMPLE_RATE_HZ) ///< Time between samples
+_Static_assert(1000000 % SAMPLE_RATE_HZ == 0, "SAMPLE_RATE_HZ must give a whole number of microseconds");
 
 volatile uint16_t adc_buffer[BUFFER_LENGTH]; ///< Buffer for ADC values
 volatile uint16_t buffer_index = 0;          ///< Index for the buffer
@@ -74,7 +77,7 @@ int main()
     initialize_adc_buffer();
 
     // Create a repeating timer for periodic sampling (200us -> 5kHz)
-    add_repeating_timer_us(-200, repeating_timer_callback, NULL, &timer);
+    add_repeating_timer_us(-SAMPLE_PERIOD_US, repeating_timer_callback, NULL, &timer);
 
     while (true)
     {
@@ -95,7 +98,7 @@ int main()
             buffer_index = 0; // Reset buffer index
 
             // Restart the timer
-            add_repeating_timer_us(-200, repeating_timer_callback, NULL, &timer);
+            add_repeating_timer_us(-SAMPLE_PERIOD_US, repeating_timer_callback, NULL, &timer);
         }
     }
 }
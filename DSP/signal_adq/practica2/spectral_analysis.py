@@ -10,7 +10,7 @@ Usage:
 4. The results will be displayed and can be saved to a file.
 5. The script will create a 'results' directory if it doesn't exist.
 6. The script will exit if the user chooses to do so.
-7. The script will handle invalid data gracefully and skip over it.
+7. The script will handle invalid data gracefully: corrupted frames are discarded and dropped frames are reported.
 8. The script will remove the DC component from the data before performing spectral analysis.
 9. The script will apply different window functions to the data and plot the results.
 10. The script will save the results to a PNG file in the 'results' directory.
@@ -23,12 +23,19 @@ import matplotlib.pyplot as plt
 from scipy import signal
 from time import sleep
 import os
+import sys
+
+# Binary frame decoder shared with the firmware (libs/sample_frame)
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'libs', 'sample_frame'))
+from sample_frame import read_samples, read_frame, TYPE_SPECTRUM16
 
 # 128 256 512 1024
 
 def daq(port='/dev/ttyACM0', buffer_size=1024):
     """
     Function to read data from a serial port and return it as a numpy array.
+    The MCU sends binary frames (see libs/sample_frame); gaps in the frame
+    sequence numbers are reported as dropped frames.
     Args:
         port (str): The serial port to read from.
         buffer_size (int): The number of data points to read.
@@ -41,24 +48,46 @@ def daq(port='/dev/ttyACM0', buffer_size=1024):
         print(f"Connected to {port}")
         sleep(2)  # Allow time for the connection to establish
 
-        # Read data from the serial port
-        data = []
-        while len(data) < buffer_size:
-            if ser.in_waiting > 0:  # Read available data
-                try:
-                    line = ser.readline()
-                    valor = int(line.decode('utf-8').strip())
-                    data.append(valor)
-                except ValueError:
-                    print("Invalid data received, skipping...")
-        
+        # Read frames from the serial port
+        ser.reset_input_buffer()
+        data = read_samples(ser, buffer_size)
+
         ser.close()
-        return np.array(data)
+        return data.astype(int)
     
     except Exception as e:
         print(f"Error connection to mcu: {e}")
         return None
     
+def daq_spectrum(port='/dev/ttyACM0', fs=5000):
+    """
+    Function to read one magnitude spectrum computed on the MCU (signal_adq built with
+    OUTPUT_MODE = OUTPUT_SPECTRUM).
+    The MCU sends |X[k]|/N of the Q15 block, one u16 per bin. Bin values are scaled here
+    to the same units as espectra_analysis(): 2*|X[k]|/N in ADC codes (Q15 = 16 x ADC code).
+    Args:
+        port (str): The serial port to read from.
+        fs (int): Sampling frequency.
+    Returns:
+        tuple: Frequencies and corresponding FFT magnitudes, or None on error.
+    """
+    try:
+        ser = pyserial.Serial(port, baudrate=115200, timeout=1)
+        print(f"Connected to {port}")
+        sleep(2)  # Allow time for the connection to establish
+
+        ser.reset_input_buffer()
+        frame = read_frame(ser, TYPE_SPECTRUM16)
+        ser.close()
+
+        n_bins = len(frame.data)
+        freq = np.arange(n_bins) * fs / (2 * n_bins)
+        return freq, 2 * frame.data.astype(float) / 16
+
+    except Exception as e:
+        print(f"Error connection to mcu: {e}")
+        return None
+
 def windos(data, window_type='rectangle'):
     """
     Function to apply a window function to the data.
@@ -173,7 +202,8 @@ if __name__ == "__main__":
 
     # Menu
     print("1. Acquire data and analyze")
-    print("2. Exit")
+    print("2. Acquire the spectrum computed on the MCU")
+    print("3. Exit")
 
     option = input("Select an option: ")
 
@@ -223,5 +253,20 @@ if __name__ == "__main__":
                 plot_spectral_analysis(data, fs, window_types, save_path)
         else:
             print("Data acquisition failed. Exiting...")
+    elif option == '2':
+        port = input("Enter the port (default is /dev/ttyACM0): ") or port
+
+        result = daq_spectrum(port, fs)
+        if result is not None:
+            freq, fft_magnitude = result
+            plt.figure(figsize=(10, 4))
+            plt.plot(freq, fft_magnitude)
+            plt.title('On-device FFT (window set by SPECTRUM_WINDOW in signal_adq.c)')
+            plt.xlabel('Frequency (Hz)')
+            plt.ylabel('Magnitude')
+            plt.grid()
+            plt.show()
+        else:
+            print("Data acquisition failed. Exiting...")
     else:
         print("Exiting... see you soon!")
\ No newline at end of file
@@ -3,9 +3,27 @@
  * @brief ADC data acquisition and UART transmission on RP2040
  *
  * This program reads analog signals using the ADC on the RP2040 microcontroller
- * and transmits the sampled data over UART. The ADC samples are stored in a buffer,
- * and once the buffer is full, the data is sent via UART. The sampling rate is
- * controlled using a repeating timer.
+ * and transmits the sampled data over UART. The ADC runs in free-running mode, paced
+ * by its own clock divider, and two chained DMA channels fill a ping-pong buffer: while
+ * one half is being filled, the other half is sent. Sampling never stops, and no CPU
+ * work is done per sample. Blocks are sent as binary frames (see sample_frame.h), each
+ * tagged with the block sequence number so the host can detect lost blocks.
+ *
+ * The work is split between the two cores: core0 owns acquisition and hands each finished
+ * block to core1 through a lock-free queue (see pipeline.h); core1 formats and transmits.
+ * A slow link therefore never pauses the capture.
+ *
+ * ADC_CHANNEL_MASK selects the inputs to capture. With more than one, the ADC cycles through
+ * them (round robin) and core0 de-interleaves every DMA block into one ring per channel (see
+ * adc_deinterleave.h); each channel is sent in its own frames, tagged with its ADC input.
+ *
+ * With OUTPUT_MODE set to OUTPUT_SPECTRUM or OUTPUT_PEAKS, core1 runs a Q15 FFT on each block
+ * (see fft_q15.h) and sends only the magnitude spectrum or its largest peaks, which takes
+ * a fraction of the link bandwidth of the raw samples.
+ *
+ * With OUTPUT_MODE set to OUTPUT_TRIGGERED, core0 feeds TRIGGER_INPUT through an oscilloscope
+ * style trigger (see scope_trigger.h) instead of queueing every block: only the windows of
+ * BUFFER_LENGTH samples around a trigger event, TRIGGER_PRE of them from before it, are sent.
  *
  * Author: Adrián Silva Palafox
  * Date: 2025-03-06
@@ -14,63 +32,228 @@
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
 #include "hardware/adc.h"
+#include "adc_capture.h"
+#include "sample_frame.h"
+#include "pipeline_multicore.h"
+#include "fixed_filter.h"
+#include "fft_q15.h"
+#include "adc_deinterleave.h"
+#include "scope_trigger.h"
+#include "build_config.h"
 
 // UART defines
 #define BAUD_RATE 115200
 #define UART0_TX_PIN 0 ///< UART0 TX pin
 
 // ADC defines
-#define ADC_PIN 26         ///< ADC pin to be used for analog input.
-#define BUFFER_LENGTH 1024 ///< The length of the buffer to store ADC samples.
-#define TSAMPLE_RATE 200   ///< The sampling period in microseconds (200us = 5kHz sampling rate).
+// The channel mask, block length and sample rate are build parameters (CMakeLists.txt); the
+// generated build_config.h rejects a mask with no input or an aggregate rate above 500 kS/s.
+#define ADC_FIRST_PIN 26                        ///< GPIO of ADC input 0; input n is on GPIO 26 + n.
+#define ADC_CHANNEL_MASK CFG_ADC_CHANNEL_MASK   ///< Inputs to capture: bit n = ADC input n (0-3), bit 4 = temperature sensor.
+#define ADC_NUM_CHANNELS CFG_ADC_CHANNELS       ///< Number of inputs in ADC_CHANNEL_MASK.
+#define BUFFER_LENGTH CFG_BLOCK_LENGTH          ///< The number of samples in each half of the ping-pong buffer, and per frame.
+#define SAMPLE_RATE_HZ CFG_SAMPLE_RATE_HZ       ///< The sampling rate of each channel, in samples per second.
+#define PIPELINE_BLOCKS 4                       ///< Blocks queued between core0 and core1 (power of two).
+#define LOWPASS_FILTER 0                        ///< 1 to low-pass filter each block on core1 before sending it.
+#define CHANNEL_RING_LENGTH (2 * BUFFER_LENGTH) ///< Samples buffered per channel (power of two).
+
+_Static_assert((BUFFER_LENGTH & (BUFFER_LENGTH - 1)) == 0, "BUFFER_LENGTH must be a power of two (channel rings)");
+
+// Output modes
+#define OUTPUT_RAW 0                       ///< Send every block of samples (RAW12 frames).
+#define OUTPUT_SPECTRUM 1                  ///< Send the magnitude spectrum of every block (SPECTRUM16 frames).
+#define OUTPUT_PEAKS 2                     ///< Send only the largest spectral peaks (PEAKS frames).
+#define OUTPUT_TRIGGERED 3                 ///< Send only the windows around a trigger event (RAW12 frames).
+#define OUTPUT_MODE OUTPUT_RAW             ///< What core1 sends for each block.
+#define SPECTRUM_WINDOW FFT_WINDOW_HANN    ///< Window applied before the FFT.
+#define NUM_PEAKS 8                        ///< Peaks per frame in OUTPUT_PEAKS mode.
+
+// Trigger settings of OUTPUT_TRIGGERED mode. A window is BUFFER_LENGTH samples of TRIGGER_INPUT,
+// with the trigger sample at index TRIGGER_PRE.
+#define TRIGGER_INPUT 0                    ///< ADC input the trigger looks at and whose windows are sent.
+#define TRIGGER_TYPE SCOPE_TRIGGER_RISING  ///< SCOPE_TRIGGER_RISING, _FALLING or _WINDOW.
+#define TRIGGER_MODE SCOPE_MODE_AUTO       ///< SCOPE_MODE_SINGLE, _NORMAL or _AUTO.
+#define TRIGGER_LEVEL 2048                 ///< Edge trigger level, in ADC codes.
+#define TRIGGER_LOW 1024                   ///< Window trigger: fires when the signal drops below ...
+#define TRIGGER_HIGH 3072                  ///< ... or rises above these codes.
+#define TRIGGER_PRE (BUFFER_LENGTH / 4)    ///< Samples sent from before the trigger.
+#define TRIGGER_AUTO_TIMEOUT SAMPLE_RATE_HZ ///< Auto mode: samples to wait before forcing a window (1 s).
+#define TRIGGER_CHUNK 64                   ///< Samples moved from the channel ring to the trigger at a time.
+#define SCOPE_HISTORY_LENGTH (2 * BUFFER_LENGTH) ///< History of the trigger channel (power of two).
+
+#if OUTPUT_MODE == OUTPUT_TRIGGERED && (ADC_CHANNEL_MASK & (1u << TRIGGER_INPUT)) == 0
+#error "TRIGGER_INPUT must be one of the inputs in ADC_CHANNEL_MASK"
+#endif
+
+#if (OUTPUT_MODE == OUTPUT_SPECTRUM || OUTPUT_MODE == OUTPUT_PEAKS) && (BUFFER_LENGTH > FFT_Q15_MAX_N || (BUFFER_LENGTH & (BUFFER_LENGTH - 1)) != 0)
+#error "The spectrum modes need BUFFER_LENGTH to be a power of two up to FFT_Q15_MAX_N"
+#endif
+
+// The low-pass taps (cfg_lowpass_taps) are designed for SAMPLE_RATE_HZ by the build (build_config.h)
+static q15_t lowpass_state[ADC_NUM_CHANNELS][2 * CFG_LOWPASS_TAPS]; ///< FIR delay lines, persist across blocks.
+static fir_q15_t lowpass[ADC_NUM_CHANNELS];           ///< Low-pass filter of each channel, run by core1.
+static uint8_t slot_of_input[ADC_DEINTERLEAVE_MAX_CHANNELS]; ///< Channel slot of each ADC input.
 
-volatile uint16_t adc_buffer[BUFFER_LENGTH]; ///< Buffer to store the acquired ADC values.
-volatile uint16_t buffer_index = 0;          ///< Index to keep track of the current position in the ADC buffer.
-volatile bool full_buffer = false;           ///< Flag to indicate when the ADC buffer is full.
-struct repeating_timer timer;                ///< Repeating timer instance.
+static uint16_t adc_buffer[2 * BUFFER_LENGTH]; ///< Ping-pong storage written by DMA.
+static adc_capture_t capture;                  ///< ADC + DMA capture engine.
+static uint16_t channel_storage[ADC_NUM_CHANNELS][CHANNEL_RING_LENGTH]; ///< Per-channel ring storage.
+static sample_ring_t channel_rings[ADC_NUM_CHANNELS]; ///< De-interleaved samples of each channel.
+static adc_deinterleaver_t deinterleaver;      ///< Splits the round-robin stream per channel.
+static uint32_t block_seq = 0;                 ///< Sequence number of the next block, over all channels.
+static uint32_t next_half = 0;                 ///< Ping-pong sequence number expected next.
+static uint16_t block_pool[PIPELINE_BLOCKS * BUFFER_LENGTH]; ///< Blocks in flight to core1.
+static pipeline_t pipeline;                    ///< Core0 -> core1 block queue.
+static uint8_t tx_frame[SAMPLE_FRAME_RAW12_LEN(BUFFER_LENGTH)]; ///< Encoded frame being sent (core1), large enough for every mode.
+
+#if OUTPUT_MODE == OUTPUT_SPECTRUM || OUTPUT_MODE == OUTPUT_PEAKS
+static q15_t fft_buffer[2 * BUFFER_LENGTH];    ///< Interleaved complex FFT work area (core1).
+static uint16_t spectrum[BUFFER_LENGTH / 2];   ///< Magnitudes of the positive-frequency bins.
+static fft_peak_t peaks[NUM_PEAKS];            ///< Largest peaks of the last spectrum.
+static uint16_t peak_words[2 * NUM_PEAKS];     ///< Peaks flattened to (bin, magnitude) pairs.
+#endif
+
+#if OUTPUT_MODE == OUTPUT_TRIGGERED
+static uint16_t scope_history[SCOPE_HISTORY_LENGTH]; ///< Circular history of TRIGGER_INPUT (core0).
+static scope_trigger_t scope;                  ///< Trigger detector and window capture (core0).
+#endif
 
 /**
- * @brief Initializes the ADC buffer with zeros.
+ * @brief Writes a binary frame to stdout without CR/LF translation.
+ *
+ * @param frame Encoded frame.
+ * @param len Frame length in bytes.
  */
-void initialize_adc_buffer()
+static void send_frame(const uint8_t *frame, size_t len)
 {
-    for (int i = 0; i < BUFFER_LENGTH; i++)
+    for (size_t i = 0; i < len; i++)
     {
-        adc_buffer[i] = 0;
+        putchar_raw(frame[i]);
     }
 }
 
+#if OUTPUT_MODE == OUTPUT_SPECTRUM || OUTPUT_MODE == OUTPUT_PEAKS
 /**
- * @brief Callback function for the repeating timer.
+ * @brief Computes the magnitude spectrum of a block into spectrum[].
  *
- * This function is called periodically by the timer. It reads a value from the ADC,
- * stores it in the buffer, and increments the buffer index. When the buffer is full,
- * it sets a flag and stops the timer.
+ * The samples are converted to Q15, the mean is removed so the DC bin does not leak over the
+ * low bins, then the block is windowed and transformed. Bin k is |X[k]| / N in Q15 units.
+ *
+ * @param blk Block of BUFFER_LENGTH ADC codes.
+ */
+static void compute_spectrum(const block_desc_t *blk)
+{
+    q15_t *x = fft_buffer; // Real samples in the first half, expanded in place to complex
+    int32_t sum = 0;
+
+    q15_from_adc12(blk->data, x, BUFFER_LENGTH);
+    for (size_t i = 0; i < BUFFER_LENGTH; i++)
+    {
+        sum += x[i];
+    }
+    q15_t mean = (q15_t)(sum / BUFFER_LENGTH);
+    for (size_t i = 0; i < BUFFER_LENGTH; i++)
+    {
+        x[i] = q15_sat((int32_t)x[i] - mean);
+    }
+
+    fft_q15_window(x, BUFFER_LENGTH, SPECTRUM_WINDOW);
+    fft_q15_load_real(fft_buffer, x, BUFFER_LENGTH);
+    fft_q15_forward(fft_buffer, BUFFER_LENGTH);
+    fft_q15_magnitude(fft_buffer, spectrum, BUFFER_LENGTH / 2);
+}
+#endif
+
+#if OUTPUT_MODE == OUTPUT_TRIGGERED
+/**
+ * @brief Moves the samples of the trigger channel through the scope, and queues every window
+ *        it captures for core1. Runs on core0.
+ *
+ * If core1 is still busy with every queued block, the window is dropped and the gap shows up in
+ * the frame sequence numbers, as for the other modes.
+ *
+ * @param ring Samples of TRIGGER_INPUT.
+ */
+static void trigger_feed(sample_ring_t *ring)
+{
+    uint16_t chunk[TRIGGER_CHUNK];
+    size_t n;
+
+    while ((n = sample_ring_read(ring, chunk, TRIGGER_CHUNK)) > 0)
+    {
+        size_t done = 0;
+        while (done < n)
+        {
+            done += scope_trigger_process(&scope, chunk + done, n - done);
+            if (!scope_trigger_ready(&scope))
+            {
+                continue;
+            }
+
+            uint16_t *blk = pipeline_get_free(&pipeline);
+            if (blk == NULL)
+            {
+                scope_trigger_read(&scope, NULL, NULL);
+                pipeline.dropped++;
+            }
+            else
+            {
+                size_t len = scope_trigger_read(&scope, blk, NULL);
+                pipeline_multicore_submit(&pipeline, blk, len, TRIGGER_INPUT, block_seq);
+            }
+            block_seq++;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Pipeline sink, runs on core1: encodes a block and transmits it.
  *
- * @param t Pointer to the repeating_timer structure.
- * @return true to keep the timer running (unless canceled).
+ * @param blk Block queued by core0.
+ * @param ctx Unused.
  */
-bool repeating_timer_callback(struct repeating_timer *t)
+static void transmit_block(const block_desc_t *blk, void *ctx)
 {
-    // Read the ADC and store the value in the buffer.
-    adc_buffer[buffer_index] = adc_read();
-    buffer_index++;
+    (void)ctx;
+
+    if (LOWPASS_FILTER)
+    {
+        // Filter in place: ADC codes -> Q15 -> FIR -> ADC codes.
+        q15_t *q = (q15_t *)blk->data;
+        q15_from_adc12(blk->data, q, blk->count);
+        fir_q15_process(&lowpass[slot_of_input[blk->channel]], q, q, blk->count);
+        q15_to_adc12(q, blk->data, blk->count);
+    }
 
-    // Check if the buffer is full.
-    if (buffer_index >= BUFFER_LENGTH)
+#if OUTPUT_MODE == OUTPUT_SPECTRUM
+    compute_spectrum(blk);
+    size_t len = sample_frame_encode16(tx_frame, sizeof(tx_frame), SAMPLE_FRAME_TYPE_SPECTRUM16, blk->channel,
+                                       (uint16_t)blk->seq, spectrum, BUFFER_LENGTH / 2);
+#elif OUTPUT_MODE == OUTPUT_PEAKS
+    compute_spectrum(blk);
+    size_t found = fft_q15_peaks(spectrum, BUFFER_LENGTH / 2, peaks, NUM_PEAKS);
+    for (size_t i = 0; i < found; i++)
     {
-        full_buffer = true;        // Set the flag to indicate the buffer is full.
-        cancel_repeating_timer(t); // Stop the timer.
+        peak_words[2 * i] = peaks[i].bin;
+        peak_words[2 * i + 1] = peaks[i].mag;
     }
-    return true; // Return true to keep the timer running.
+    size_t len = sample_frame_encode16(tx_frame, sizeof(tx_frame), SAMPLE_FRAME_TYPE_PEAKS, blk->channel,
+                                       (uint16_t)blk->seq, peak_words, (uint16_t)found);
+#else
+    size_t len = sample_frame_encode12(tx_frame, sizeof(tx_frame), blk->channel, (uint16_t)blk->seq,
+                                       blk->data, blk->count);
+#endif
+    send_frame(tx_frame, len);
 }
 
 /**
  * @brief Main function of the program.
  *
- * Initializes peripherals, sets up a repeating timer for ADC sampling, and enters
- * an infinite loop. When the ADC buffer is full, it transmits the data over USB-CDC
- * and then restarts the sampling process.
+ * Initializes peripherals, launches the transmit stage on core1, starts the free-running
+ * ADC capture, and enters an infinite loop. Every time a half of the ping-pong buffer is
+ * full, it is split per channel, and every BUFFER_LENGTH samples of a channel are queued
+ * for core1, which packs them into a binary frame and transmits it over USB-CDC while the
+ * DMA keeps filling the other half.
  *
  * @return int Should not return.
  */
@@ -82,37 +265,119 @@ int main()
     // Delay to ensure USB is ready before proceeding.
     sleep_ms(1);
 
-    // Initialize ADC peripheral.
+    // Initialize ADC peripheral and the GPIO of every external input in the mask.
     adc_init();
-    adc_gpio_init(ADC_PIN);
-    adc_select_input(0); // Select ADC input 0 (GPIO26).
+    for (uint input = 0; input < 4; input++)
+    {
+        if (ADC_CHANNEL_MASK & (1u << input))
+        {
+            adc_gpio_init(ADC_FIRST_PIN + input);
+        }
+    }
 
-    // Initialize the ADC buffer.
-    initialize_adc_buffer();
+    // One ring per channel, filled by the de-interleaver on core0.
+    for (uint slot = 0; slot < ADC_NUM_CHANNELS; slot++)
+    {
+        sample_ring_init(&channel_rings[slot], channel_storage[slot], CHANNEL_RING_LENGTH);
+    }
+    adc_deinterleaver_init(&deinterleaver, ADC_CHANNEL_MASK, channel_rings);
+    for (uint slot = 0; slot < ADC_NUM_CHANNELS; slot++)
+    {
+        slot_of_input[deinterleaver.inputs[slot]] = (uint8_t)slot;
+    }
 
-    // Create a repeating timer for periodic sampling.
-    // A negative value for the delay makes the timer fire immediately and then repeat.
-    add_repeating_timer_us(-TSAMPLE_RATE, repeating_timer_callback, NULL, &timer);
+    // Start the transmit stage on core1.
+    for (uint slot = 0; slot < ADC_NUM_CHANNELS; slot++)
+    {
+        fir_q15_init(&lowpass[slot], cfg_lowpass_taps, CFG_LOWPASS_TAPS, lowpass_state[slot]);
+    }
+    pipeline_init(&pipeline, block_pool, BUFFER_LENGTH, PIPELINE_BLOCKS, transmit_block, NULL);
+    pipeline_multicore_launch(&pipeline);
+
+#if OUTPUT_MODE == OUTPUT_TRIGGERED
+    const scope_trigger_config_t trigger_cfg = {
+        .type = TRIGGER_TYPE,
+        .mode = TRIGGER_MODE,
+        .level = TRIGGER_LEVEL,
+        .low = TRIGGER_LOW,
+        .high = TRIGGER_HIGH,
+        .pre = TRIGGER_PRE,
+        .post = BUFFER_LENGTH - TRIGGER_PRE,
+        .auto_timeout = TRIGGER_AUTO_TIMEOUT,
+    };
+    scope_trigger_init(&scope, &trigger_cfg, scope_history, SCOPE_HISTORY_LENGTH);
+    scope_trigger_arm(&scope);
+#endif
+
+    // Configure the ADC clock divider, round robin and DMA, then start sampling.
+    adc_capture_init_round_robin(&capture, ADC_CHANNEL_MASK, SAMPLE_RATE_HZ * ADC_NUM_CHANNELS, adc_buffer,
+                                 BUFFER_LENGTH);
+    adc_capture_start(&capture);
 
     while (true)
     {
-        // Check if the buffer is full and ready to be processed.
-        if (full_buffer)
+        // Check if a half of the buffer is full and ready to be processed.
+        uint32_t half_seq;
+        const uint16_t *block = adc_capture_acquire(&capture, &half_seq);
+        if (block == NULL)
         {
-            // Transmit the entire buffer over USB (stdout).
-            // Each value is printed on a new line.
-            for (int i = 0; i < BUFFER_LENGTH; i++)
-            {
-                printf("%d\r\n", adc_buffer[i]);
-            }
+            tight_loop_contents();
+            continue;
+        }
+
+        // Halves overwritten before core0 got to them leave a hole in every channel: drop the
+        // partial frames and skip a sequence number so the host sees the gap.
+        if (half_seq != next_half)
+        {
+            adc_deinterleaver_skip(&deinterleaver, (half_seq - next_half) * BUFFER_LENGTH);
+            block_seq++;
+#if OUTPUT_MODE == OUTPUT_TRIGGERED
+            scope_trigger_flush(&scope); // A window must not span the hole
+#endif
+        }
+        next_half = half_seq + 1;
 
-            // Reset the flag and buffer for the next acquisition cycle.
-            full_buffer = false;
-            initialize_adc_buffer();
-            buffer_index = 0; // Reset buffer index.
+        // Split the block per channel and hand the half back to the DMA right away.
+        adc_deinterleave(&deinterleaver, block, BUFFER_LENGTH);
+        adc_capture_release(&capture);
 
-            // Restart the timer to begin a new sampling period.
-            add_repeating_timer_us(-TSAMPLE_RATE, repeating_timer_callback, NULL, &timer);
+#if OUTPUT_MODE == OUTPUT_TRIGGERED
+        // Only the trigger channel is looked at; the others are discarded.
+        for (uint slot = 0; slot < ADC_NUM_CHANNELS; slot++)
+        {
+            sample_ring_t *ring = &channel_rings[slot];
+            if (deinterleaver.inputs[slot] == TRIGGER_INPUT)
+            {
+                trigger_feed(ring);
+            }
+            else
+            {
+                sample_ring_skip(ring, sample_ring_count(ring));
+            }
+        }
+#else
+        // Queue every full frame's worth of samples for core1. If core1 is still busy with
+        // every queued block, the samples are dropped and the gap shows up in the frame
+        // sequence numbers.
+        for (uint slot = 0; slot < ADC_NUM_CHANNELS; slot++)
+        {
+            sample_ring_t *ring = &channel_rings[slot];
+            while (sample_ring_count(ring) >= BUFFER_LENGTH)
+            {
+                uint16_t *blk = pipeline_get_free(&pipeline);
+                if (blk == NULL)
+                {
+                    sample_ring_skip(ring, BUFFER_LENGTH);
+                    pipeline.dropped++;
+                }
+                else
+                {
+                    sample_ring_read(ring, blk, BUFFER_LENGTH);
+                    pipeline_multicore_submit(&pipeline, blk, BUFFER_LENGTH, deinterleaver.inputs[slot], block_seq);
+                }
+                block_seq++;
+            }
         }
+#endif
     }
 }
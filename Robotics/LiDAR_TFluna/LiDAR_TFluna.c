@@ -3,46 +3,282 @@
  * @brief Main application for a 2D LiDAR scanner using a TF-Luna sensor and a servo motor.
  *
  * This program orchestrates a TF-Luna LiDAR sensor and a servo motor to create a
- * simple 2D LiDAR scanner. It uses an interrupt to detect when a new distance
- * measurement is ready from the LiDAR, reads the value, and then moves the servo
- * to the next position to build a 2D map of the surroundings.
+ * simple 2D LiDAR scanner. The LiDAR's "data ready" interrupt starts a DMA read of
+ * the whole measurement block (tf_luna_async.h), so the CPU never waits on the I2C bus.
+ *
+ * With SCAN_CONTINUOUS set, the servo sweeps without stopping along a timed trajectory
+ * driven by the PWM wrap interrupt, and every LiDAR frame is printed with the servo angle
+ * interpolated at its data-ready time: at 100 Hz and 2 s per pass that is about 200 points
+ * per sweep. The points are binned by angle and filtered (scan_filter.h), and the filtered
+ * points build an occupancy grid (occupancy_grid.h). The host picks what is sent by writing
+ * one character: 'r' raw points or 'f' filtered points, one binary frame per half-sweep
+ * (scan_frame.h), or 'g' the grid once per GRID_SEND_SWEEPS sweeps when it has changed;
+ * 'c' clears the grid. With SCAN_BINARY cleared the points are printed one per line.
+ *
+ * Otherwise the servo steps ANGLE_STEP degrees; once it has settled, the first frame
+ * measured after that is printed and the servo moves to the next position.
+ *
+ * Time, stdio and I2C go through libs/hal, so with HAL_HOST the program runs as a Linux
+ * executable on the HAL simulator: the TF-Luna is the simulator's sensor model
+ * (hal_sim_tfluna.h) looking at a scripted room, the reads use the blocking HAL backend
+ * (tf_luna_hal.h), the main loop polls the model's data-ready output instead of taking the
+ * GPIO interrupt, and the servo is driven from a HAL timer (sg90_hal.c).
  */
 
 #include <stdio.h>
+#include "hal.h"
+#ifndef HAL_HOST
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/irq.h"
+#endif
 
 // User-defined includes for the servo and LiDAR sensor
-#include "sg90.h"      // Header for servo control
-#include "tf_luna.h"   // Header for TF-Luna LiDAR sensor
+#include "sg90.h"           // Header for servo control
+#include "tf_luna.h"        // Header for TF-Luna LiDAR sensor
+#include "tf_luna_async.h"  // Non-blocking block reads
+#ifndef HAL_HOST
+#include "tf_luna_dma.h"    // I2C DMA backend for the reads
+#else
+#include <math.h>
+#include "tf_luna_hal.h"    // Blocking HAL backend for the reads
+#include "hal_sim_tfluna.h" // Simulated sensor
+#endif
+#include "scan_frame.h"     // Binary point-cloud frames
+#include "scan_filter.h"    // Point rejection and median filter
+#include "occupancy_grid.h" // Bit-packed map of the returns
+
+// Scan mode: 1 = continuous sweep with interpolated angles, 0 = step and settle
+#define SCAN_CONTINUOUS 1
+
+// Continuous-mode output: 1 = binary frames (ui/radar.py default), 0 = "angle:distance" lines
+#define SCAN_BINARY 1
+#define SCAN_BIN_CDEG 100   // Angle bin width in hundredths of a degree
+#define SCAN_SECTOR_BINS 91 // Bins per frame: 0-90 and 91-180 degrees, one frame per half-sweep
+
+// Occupancy grid: 16 m x 8 m in 10 cm cells, the sensor at the middle of the bottom edge
+#define GRID_WIDTH 160
+#define GRID_HEIGHT 80
+#define GRID_CELL_CM 10
+#define GRID_SEND_SWEEPS 2 // Sweeps between grid frames in 'g' mode
 
 // Instances
-tf_luna_t LiDAR; // Create an instance of the LiDAR sensor structure
-volatile bool data_ready = true; // Flag to indicate if new data is ready from the LiDAR.
+#ifndef HAL_HOST
+tf_luna_dma_t lidar_dma; // DMA channels and command list for the I2C reads
+#else
+tf_luna_hal_t lidar_hal;      // Blocking reads on the simulated I2C bus
+hal_sim_tfluna_t lidar_model; // Sensor answering on that bus
+bool sweeping;                // The sweep has started, so get_sweep_angle() can be used
+#endif
+tf_luna_bus_t lidar_bus; // Backend bound to lidar_dma, or to lidar_hal on the host
+tf_luna_async_t LiDAR;   // Reader started from the "data ready" interrupt
+
+#ifdef HAL_HOST
+// Simulated room, in cm from the sensor: x to the right (0 degrees), y ahead (90 degrees)
+#define ROOM_HALF_WIDTH 250 // Side walls
+#define ROOM_DEPTH 350      // Far wall
+#define PILLAR_X -80        // Centre of a square pillar ahead-left
+#define PILLAR_Y 150
+#define PILLAR_HALF 20
+#define LIDAR_RANGE_CM 800 // No return beyond this
+
+/**
+ * @brief Distance to the nearest wall or pillar face along the servo's angle at a frame time
+ *
+ * The servo is taken to be where the sweep model puts it (get_sweep_angle()), so a scan
+ * should draw the room in place; the step mode uses the commanded angle.
+ */
+static uint16_t room_scene(uint64_t t_us, void *user)
+{
+    (void)user;
+#if SCAN_CONTINUOUS
+    int32_t cdeg = sweeping ? get_sweep_angle((uint32_t)t_us) : 0;
+#else
+    (void)t_us;
+    int32_t cdeg = current_angle * SERVO_SWEEP_CDEG;
+#endif
+    double a = cdeg * (M_PI / 18000.0);
+    double dx = cos(a), dy = sin(a);
+    double d = LIDAR_RANGE_CM;
+
+    // Walls
+    if (fabs(dx) > 1e-9)
+    {
+        d = fmin(d, ROOM_HALF_WIDTH / fabs(dx));
+    }
+    if (dy > 1e-9)
+    {
+        d = fmin(d, ROOM_DEPTH / dy);
+    }
+
+    // Pillar: the ray enters the square where it is inside both slabs
+    double tmin = 0.0, tmax = LIDAR_RANGE_CM;
+    const double lo[2] = {PILLAR_X - PILLAR_HALF, PILLAR_Y - PILLAR_HALF};
+    const double hi[2] = {PILLAR_X + PILLAR_HALF, PILLAR_Y + PILLAR_HALF};
+    const double dir[2] = {dx, dy};
+    for (int k = 0; k < 2; k++)
+    {
+        if (fabs(dir[k]) < 1e-9)
+        {
+            tmax = (lo[k] <= 0.0 && 0.0 <= hi[k]) ? tmax : -1.0;
+            continue;
+        }
+        double t0 = lo[k] / dir[k], t1 = hi[k] / dir[k];
+        tmin = fmax(tmin, fmin(t0, t1));
+        tmax = fmin(tmax, fmax(t0, t1));
+    }
+    if (tmin <= tmax)
+    {
+        d = fmin(d, tmin);
+    }
+
+    return d >= LIDAR_RANGE_CM ? 0u : (uint16_t)lround(d);
+}
+#endif
+
+#if SCAN_CONTINUOUS && SCAN_BINARY
+// Bytes of grid cells, and of the largest frame sent (a grid frame is longer than a sector's)
+#define GRID_BYTES OCC_GRID_BYTES(GRID_WIDTH, GRID_HEIGHT)
+#define SCAN_OUT_LEN SCAN_GRID_FRAME_LEN(GRID_BYTES)
+
+scan_accum_t scan;                                      // Points of the sector being swept
+uint16_t filtered[SCAN_SECTOR_BINS];                    // Filtered points of the closed sector
+scan_filter_config_t filter_cfg = SCAN_FILTER_DEFAULTS; // Filter thresholds
+scan_filter_stats_t filter_stats;                       // Filter counters
+uint8_t grid_bits[GRID_BYTES];                          // Grid cells
+occ_grid_t grid;                                        // Map built from the filtered points
+uint8_t scan_out[SCAN_OUT_LEN];                         // Frame being sent
+char output_mode = 'f';                                 // 'r' raw, 'f' filtered or 'g' grid
+
+/**
+ * @brief Writes a binary frame to stdio without newline translation
+ */
+static void send_frame(const uint8_t *frame, size_t len)
+{
+    hal_stdio_write(frame, len);
+}
+
+/**
+ * @brief Filters a closed sector, adds it to the grid and sends what the host asked for
+ *
+ * @param s Sector closed by the accumulator, valid until the next point is added
+ */
+static void process_sector(const scan_sector_t *s)
+{
+    static uint16_t last_sweep;    // Sweep of the previous sector
+    static uint32_t sweeps;        // Sweeps completed
+    static uint16_t grid_crc_sent; // CRC of the last grid frame sent
+    size_t len = 0;
+
+    scan_filter_run(&filter_cfg, s->points, filtered, s->header.n_points, &filter_stats);
+    occ_grid_add_points(&grid, s->header.start_cdeg, s->header.step_cdeg, filtered, s->header.n_points, true);
+
+    if (output_mode == 'r')
+    {
+        len = scan_sector_encode(s, scan_out, sizeof(scan_out));
+    }
+    else if (output_mode == 'f')
+    {
+        len = scan_frame_encode(&s->header, filtered, scan_out, sizeof(scan_out));
+    }
+
+    // A new sweep number means the previous sweep is complete
+    if (s->header.sweep != last_sweep)
+    {
+        last_sweep = s->header.sweep;
+        sweeps++;
+        if (output_mode == 'g' && sweeps % GRID_SEND_SWEEPS == 0)
+        {
+            scan_grid_header_t h = {
+                .sweep = s->header.sweep,
+                .width = grid.width,
+                .height = grid.height,
+                .cell_cm = grid.cell_cm,
+                .origin_x = grid.origin_x,
+                .origin_y = grid.origin_y,
+            };
+            len = scan_grid_encode(&h, grid.bits, scan_out, sizeof(scan_out));
 
+            // The frame CRC covers the header too, so compare the cells' own CRC
+            uint16_t crc = scan_frame_crc16(grid.bits, GRID_BYTES);
+            if (crc == grid_crc_sent)
+            {
+                len = 0;
+            }
+            grid_crc_sent = crc;
+        }
+    }
+
+    if (len)
+    {
+        send_frame(scan_out, len);
+    }
+}
+
+/**
+ * @brief Applies a one-character command from the host, if one has arrived
+ */
+static void poll_command(void)
+{
+    int c = hal_stdio_getc(0);
+    if (c == 'r' || c == 'f' || c == 'g')
+    {
+        output_mode = (char)c;
+    }
+    else if (c == 'c')
+    {
+        occ_grid_clear(&grid);
+    }
+}
+#endif
+
+#ifndef HAL_HOST
 // Function prototypes
 void gpio_callback(uint gpio, uint32_t events);
+#endif
+
+#ifdef HAL_HOST
+/**
+ * @brief Stands in for the data-ready interrupt on the host: starts a read when the sensor
+ *        model has a new frame, then lets the simulator's virtual time run on
+ */
+static void poll_data_ready(void)
+{
+    if (hal_sim_tfluna_ready(&lidar_model))
+    {
+        tf_luna_async_start(&LiDAR, hal_time_us_32());
+    }
+    hal_idle();
+}
+#endif
 
 /**
  * @brief The main function of the program.
  *
- * Initializes the servo, I2C for the LiDAR, and a GPIO interrupt. It then enters
- * an infinite loop to scan the environment.
+ * Initializes the servo, I2C and DMA for the LiDAR, and a GPIO interrupt. It then
+ * enters an infinite loop that completes the reads and steps the servo, without sleeping.
  *
  * @return int This function should not return.
  */
 int main()
 {
-    stdio_init_all();
+    hal_init();
 
     // Initialize the servo motor
     setup_servo();
 
     // Initialize I2C for the TF-Luna LiDAR sensor
-    i2c_init(I2C_PORT, 400 * 1000); // Use I2C port 0 at 400kHz
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
+    hal_i2c_init(I2C_PORT_NUM, 400 * 1000, I2C_SDA, I2C_SCL); // Use I2C port 0 at 400kHz
+#ifndef HAL_HOST
+    tf_luna_dma_init(&lidar_dma, I2C_PORT, &lidar_bus);
+#else
+    hal_sim_tfluna_init(&lidar_model, TF_LUNA_ADDR, room_scene, NULL);
+    hal_sim_i2c_attach(I2C_PORT_NUM, &lidar_model.dev);
+    tf_luna_hal_init(&lidar_hal, I2C_PORT_NUM, &lidar_bus);
+#endif
+    tf_luna_async_init(&LiDAR, &lidar_bus, TF_LUNA_ADDR, NULL, NULL);
+
+#ifndef HAL_HOST
 
     // Initialize the GPIO pin for the LiDAR's "data ready" signal
     gpio_init(TF_LUNA_MUX_OUT);
@@ -51,35 +287,87 @@ int main()
 
     // Configure an interrupt to fire on the rising edge of the "data ready" signal
     gpio_set_irq_enabled_with_callback(TF_LUNA_MUX_OUT, GPIO_IRQ_EDGE_RISE, true, &gpio_callback);
+#endif
 
     printf("LiDAR TF-Luna with MG995 servo scanning system initialized\n");
 
+    tf_luna_sample_t sample;
+
+#if SCAN_CONTINUOUS
+    // The PWM wrap interrupt moves the servo from now on
+#if SCAN_BINARY
+    scan_accum_init(&scan, 0, 180, SCAN_BIN_CDEG, SCAN_SECTOR_BINS);
+    occ_grid_init(&grid, grid_bits, GRID_WIDTH, GRID_HEIGHT, GRID_CELL_CM, GRID_WIDTH / 2, 0);
+    scan_sector_t sector;
+#endif
+    start_servo_sweep(SWEEP_TIME_MS, SWEEP_LAG_US);
+#ifdef HAL_HOST
+    sweeping = true;
+#endif
+
     // Main loop for scanning
     while (true)
     {
-        // Check if the LiDAR has indicated that a new measurement is ready
-        if (data_ready)
+        // Finish the read in flight, if any; the DMA does the transfer itself
+        tf_luna_async_service(&LiDAR, hal_time_us_32());
+#if SCAN_BINARY
+        poll_command();
+#endif
+
+        // Print every frame at the angle the servo was at when it was measured
+        if (tf_luna_async_take(&LiDAR, &sample))
         {
-            data_ready = false;   // Reset the flag
-            get_distance(&LiDAR); // Read the distance value from the LiDAR sensor
+            int32_t cdeg = get_sweep_angle(sample.ready_us);
+#if SCAN_BINARY
+            // A sector is processed each time the sweep leaves it
+            uint16_t point = scan_point(sample.distance, scan_quality(sample.amplitude, sample.valid));
+            if (scan_accum_add(&scan, get_sweep_index(sample.ready_us), cdeg, point, &sector))
+            {
+                process_sector(&sector);
+            }
+#else
+            printf("%d:%d\n", (int)((cdeg + SERVO_SWEEP_CDEG / 2) / SERVO_SWEEP_CDEG), sample.distance);
+#endif
+        }
+#ifdef HAL_HOST
+        poll_data_ready();
+#endif
+    }
+#else
+    uint32_t moved_us = hal_time_us_32(); // Time of the last servo step
+
+    // Main loop for scanning
+    while (true)
+    {
+        // Finish the read in flight, if any; the DMA does the transfer itself
+        tf_luna_async_service(&LiDAR, hal_time_us_32());
 
+        // Use the first frame measured SCAN_DELAY_MS or more after the last step,
+        // once the servo has settled at the new angle
+        if (tf_luna_async_take(&LiDAR, &sample) &&
+            (int32_t)(sample.ready_us - moved_us) >= SCAN_DELAY_MS * 1000)
+        {
             // Print the angle and distance in a format that can be parsed by the Python UI
-            printf("%d:%d\n", current_angle, LiDAR.distance);
+            printf("%d:%d\n", current_angle, sample.distance);
 
             // Move the servo to the next scanning position
             scan_servo();
-
-            // Wait for a short period before the next measurement
-            sleep_ms(SCAN_DELAY_MS);
+            moved_us = hal_time_us_32();
         }
+#ifdef HAL_HOST
+        poll_data_ready();
+#endif
     }
+#endif
 }
 
+#ifndef HAL_HOST
 /**
  * @brief GPIO interrupt callback function.
  *
  * This function is triggered when a rising edge is detected on the `TF_LUNA_MUX_OUT` pin,
- * which is connected to the LiDAR's data ready output.
+ * which is connected to the LiDAR's data ready output. It starts the DMA read of the new
+ * frame at once; the edge time becomes the sample's timestamp.
  *
  * @param gpio The GPIO pin that triggered the interrupt.
  * @param events The type of event (e.g., rising edge).
@@ -89,7 +377,8 @@ void gpio_callback(uint gpio, uint32_t events)
     // Check if the interrupt was triggered by the correct pin and event
     if (gpio == TF_LUNA_MUX_OUT && (events & GPIO_IRQ_EDGE_RISE))
     {
-        // Set the flag to indicate that a new distance measurement is ready to be read
-        data_ready = true;
+        // Start reading the new measurement block; a frame is skipped if a read is still in flight
+        tf_luna_async_start(&LiDAR, time_us_32());
     }
 }
+#endif
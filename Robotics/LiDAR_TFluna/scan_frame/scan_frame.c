@@ -0,0 +1,336 @@
+/**
+ * @file scan_frame.c
+ * @brief Binary point-cloud frames for the LiDAR link, and the per-sector accumulator that
+ * fills them.
+ */
+
+#include <string.h>
+#include "scan_frame.h"
+
+static inline void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint16_t scan_frame_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint8_t scan_quality(uint16_t amplitude, bool valid)
+{
+    if (!valid || amplitude == 0)
+    {
+        return 0;
+    }
+    // Bit length of the amplitude: 64 .. 127 gives 7, i.e. quality 1.
+    uint8_t bits = 0;
+    while (amplitude)
+    {
+        bits++;
+        amplitude >>= 1;
+    }
+    int q = bits - 6;
+    return (uint8_t)(q < 1 ? 1 : (q > 15 ? 15 : q));
+}
+
+size_t scan_frame_encode(const scan_frame_header_t *h, const uint16_t *points, uint8_t *out, size_t cap)
+{
+    size_t n = h->n_points;
+    if (n > SCAN_FRAME_MAX_POINTS || cap < SCAN_FRAME_LEN(n))
+    {
+        return 0;
+    }
+
+    out[0] = SCAN_FRAME_SYNC0;
+    out[1] = SCAN_FRAME_SYNC1;
+    out[2] = SCAN_FRAME_VERSION;
+    out[3] = h->flags;
+    put16(&out[4], h->sweep);
+    put16(&out[6], (uint16_t)h->start_cdeg);
+    put16(&out[8], (uint16_t)h->step_cdeg);
+    put16(&out[10], (uint16_t)n);
+    for (size_t i = 0; i < n; i++)
+    {
+        put16(&out[SCAN_FRAME_HEADER_LEN + 2 * i], points[i]);
+    }
+
+    size_t body = SCAN_FRAME_HEADER_LEN + 2 * n;
+    put16(&out[body], scan_frame_crc16(&out[2], body - 2));
+    return body + 2;
+}
+
+int scan_frame_decode(const uint8_t *buf, size_t len, scan_frame_header_t *h, uint16_t *points,
+                      size_t max_points)
+{
+    if (len < 2)
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+    if (buf[0] != SCAN_FRAME_SYNC0 || buf[1] != SCAN_FRAME_SYNC1)
+    {
+        return SCAN_FRAME_ERR_SYNC;
+    }
+    if (len < SCAN_FRAME_HEADER_LEN)
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+    if (buf[2] != SCAN_FRAME_VERSION)
+    {
+        return SCAN_FRAME_ERR_VERSION;
+    }
+
+    size_t n = get16(&buf[10]);
+    if (n > max_points || n > SCAN_FRAME_MAX_POINTS)
+    {
+        return SCAN_FRAME_ERR_LEN;
+    }
+    if (len < SCAN_FRAME_LEN(n))
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+
+    size_t body = SCAN_FRAME_HEADER_LEN + 2 * n;
+    if (get16(&buf[body]) != scan_frame_crc16(&buf[2], body - 2))
+    {
+        return SCAN_FRAME_ERR_CRC;
+    }
+
+    h->flags = buf[3];
+    h->sweep = get16(&buf[4]);
+    h->start_cdeg = (int16_t)get16(&buf[6]);
+    h->step_cdeg = (int16_t)get16(&buf[8]);
+    h->n_points = (uint16_t)n;
+    for (size_t i = 0; i < n; i++)
+    {
+        points[i] = get16(&buf[SCAN_FRAME_HEADER_LEN + 2 * i]);
+    }
+    return (int)(body + 2);
+}
+
+size_t scan_frame_find(const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (buf[i] == SCAN_FRAME_SYNC0 &&
+            (i + 1 == len || buf[i + 1] == SCAN_FRAME_SYNC1 || buf[i + 1] == SCAN_GRID_SYNC1))
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+size_t scan_grid_encode(const scan_grid_header_t *h, const uint8_t *bits, uint8_t *out, size_t cap)
+{
+    size_t bytes = scan_grid_bytes(h);
+    if (bytes > SCAN_GRID_MAX_BYTES || cap < SCAN_GRID_FRAME_LEN(bytes))
+    {
+        return 0;
+    }
+
+    out[0] = SCAN_FRAME_SYNC0;
+    out[1] = SCAN_GRID_SYNC1;
+    out[2] = SCAN_FRAME_VERSION;
+    out[3] = 0;
+    put16(&out[4], h->sweep);
+    put16(&out[6], h->width);
+    put16(&out[8], h->height);
+    put16(&out[10], h->cell_cm);
+    put16(&out[12], (uint16_t)h->origin_x);
+    put16(&out[14], (uint16_t)h->origin_y);
+    memcpy(&out[SCAN_GRID_HEADER_LEN], bits, bytes);
+
+    size_t body = SCAN_GRID_HEADER_LEN + bytes;
+    put16(&out[body], scan_frame_crc16(&out[2], body - 2));
+    return body + 2;
+}
+
+int scan_grid_decode(const uint8_t *buf, size_t len, scan_grid_header_t *h, uint8_t *bits, size_t max_bytes)
+{
+    if (len < 2)
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+    if (buf[0] != SCAN_FRAME_SYNC0 || buf[1] != SCAN_GRID_SYNC1)
+    {
+        return SCAN_FRAME_ERR_SYNC;
+    }
+    if (len < SCAN_GRID_HEADER_LEN)
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+    if (buf[2] != SCAN_FRAME_VERSION)
+    {
+        return SCAN_FRAME_ERR_VERSION;
+    }
+
+    scan_grid_header_t g = {
+        .sweep = get16(&buf[4]),
+        .width = get16(&buf[6]),
+        .height = get16(&buf[8]),
+        .cell_cm = get16(&buf[10]),
+        .origin_x = (int16_t)get16(&buf[12]),
+        .origin_y = (int16_t)get16(&buf[14]),
+    };
+    size_t bytes = scan_grid_bytes(&g);
+    if (bytes > max_bytes || bytes > SCAN_GRID_MAX_BYTES)
+    {
+        return SCAN_FRAME_ERR_LEN;
+    }
+    if (len < SCAN_GRID_FRAME_LEN(bytes))
+    {
+        return SCAN_FRAME_ERR_SHORT;
+    }
+
+    size_t body = SCAN_GRID_HEADER_LEN + bytes;
+    if (get16(&buf[body]) != scan_frame_crc16(&buf[2], body - 2))
+    {
+        return SCAN_FRAME_ERR_CRC;
+    }
+    *h = g;
+    memcpy(bits, &buf[SCAN_GRID_HEADER_LEN], bytes);
+    return (int)(body + 2);
+}
+
+void scan_accum_init(scan_accum_t *a, int32_t min_deg, int32_t max_deg, int32_t step_cdeg, uint16_t sector_bins)
+{
+    if (step_cdeg <= 0)
+    {
+        step_cdeg = 100;
+    }
+    int32_t span = (max_deg - min_deg) * 100;
+    uint32_t n = (uint32_t)(span / step_cdeg) + 1u;
+    if (n > SCAN_ACCUM_MAX_BINS)
+    {
+        n = SCAN_ACCUM_MAX_BINS;
+    }
+    if (sector_bins == 0 || sector_bins > n)
+    {
+        sector_bins = (uint16_t)n;
+    }
+    if (sector_bins > SCAN_FRAME_MAX_POINTS)
+    {
+        sector_bins = SCAN_FRAME_MAX_POINTS;
+    }
+
+    a->min_cdeg = min_deg * 100;
+    a->step_cdeg = step_cdeg;
+    a->n_bins = (uint16_t)n;
+    a->sector_bins = sector_bins;
+    memset(a->bins, 0, sizeof(a->bins));
+    a->sweep = 0;
+    a->sector = 0;
+    a->open = false;
+    a->held = false;
+    a->sectors = 0;
+}
+
+/**
+ * @brief First bin and bin count of a sector.
+ */
+static uint16_t sector_span(const scan_accum_t *a, uint16_t sector, uint16_t *n)
+{
+    uint16_t first = (uint16_t)(sector * a->sector_bins);
+    *n = a->sector_bins;
+    if (first + *n > a->n_bins)
+    {
+        *n = (uint16_t)(a->n_bins - first);
+    }
+    return first;
+}
+
+/**
+ * @brief Empties the open sector and stores its held first point, once the caller is done
+ * with the sector closed at a turnaround.
+ */
+static void release_held(scan_accum_t *a)
+{
+    if (a->held)
+    {
+        uint16_t n;
+        uint16_t first = sector_span(a, a->sector, &n);
+        memset(&a->bins[first], 0, n * sizeof(a->bins[0]));
+        a->bins[a->held_bin] = a->held_point;
+        a->held = false;
+    }
+}
+
+bool scan_accum_flush(scan_accum_t *a, scan_sector_t *closed)
+{
+    release_held(a);
+    if (!a->open)
+    {
+        return false;
+    }
+    a->open = false;
+
+    uint16_t n;
+    uint16_t first = sector_span(a, a->sector, &n);
+    closed->header = (scan_frame_header_t){
+        .flags = (a->sweep & 1u) ? SCAN_FRAME_REVERSE : 0,
+        .sweep = (uint16_t)a->sweep,
+        .start_cdeg = (int16_t)(a->min_cdeg + (int32_t)first * a->step_cdeg),
+        .step_cdeg = (int16_t)a->step_cdeg,
+        .n_points = n,
+    };
+    closed->points = &a->bins[first];
+    a->sectors++;
+    return true;
+}
+
+bool scan_accum_add(scan_accum_t *a, uint32_t sweep, int32_t cdeg, uint16_t point, scan_sector_t *closed)
+{
+    release_held(a);
+
+    // Nearest bin, clamped to the sweep.
+    int32_t offset = cdeg - a->min_cdeg;
+    int32_t bin = offset < 0 ? 0 : (offset + a->step_cdeg / 2) / a->step_cdeg;
+    if (bin >= a->n_bins)
+    {
+        bin = a->n_bins - 1;
+    }
+    uint16_t sector = (uint16_t)(bin / a->sector_bins);
+
+    bool done = false;
+    if (a->open && (sweep != a->sweep || sector != a->sector))
+    {
+        done = scan_accum_flush(a, closed);
+    }
+    if (!a->open)
+    {
+        a->sweep = sweep;
+        a->sector = sector;
+        a->open = true;
+
+        // At a turnaround the new sector is the one just closed: keep it intact for the
+        // caller and empty it on the next call instead.
+        uint16_t n;
+        uint16_t first = sector_span(a, sector, &n);
+        if (done && closed->points == &a->bins[first])
+        {
+            a->held = true;
+            a->held_bin = (uint16_t)bin;
+            a->held_point = point;
+            return true;
+        }
+        memset(&a->bins[first], 0, n * sizeof(a->bins[0]));
+    }
+    a->bins[bin] = point;
+    return done;
+}
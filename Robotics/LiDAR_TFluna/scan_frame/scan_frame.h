@@ -0,0 +1,272 @@
+/**
+ * @file scan_frame.h
+ * @brief Binary point-cloud frames for the LiDAR link, and the per-sector accumulator that
+ * fills them.
+ *
+ * @details
+ * A frame carries one sector of a sweep as evenly spaced angle bins. All fields are
+ * little-endian:
+ *
+ * | Offset | Size | Field                                                        |
+ * |--------|------|--------------------------------------------------------------|
+ * | 0      | 2    | Sync, 0xA5 0x5A                                              |
+ * | 2      | 1    | Version (SCAN_FRAME_VERSION)                                 |
+ * | 3      | 1    | Flags (SCAN_FRAME_REVERSE: the sweep runs from max to min)   |
+ * | 4      | 2    | Sweep number, wraps at 2^16                                  |
+ * | 6      | 2    | Angle of the first bin, 0.01 degree (signed)                 |
+ * | 8      | 2    | Angle step between bins, 0.01 degree (signed)                |
+ * | 10     | 2    | Number of points n                                           |
+ * | 12     | 2n   | Points: distance in cm (bits 0-11), quality (bits 12-15)     |
+ * | 12+2n  | 2    | CRC-16/CCITT-FALSE of bytes 2 .. 11+2n                       |
+ *
+ * Quality 0 means no usable return in that bin (nothing measured, or an amplitude outside
+ * the reliable range); 1 .. 15 grows with the log2 of the amplitude. Distances above
+ * 4095 cm (beyond the TF-Luna's range) are clamped. At two bytes per point a 90-bin sector
+ * is 194 bytes, against about 760 bytes for the same points as "angle:distance" lines.
+ *
+ * An occupancy grid (occupancy_grid.h) travels in a frame of its own, told apart by its
+ * second sync byte:
+ *
+ * | Offset | Size | Field                                                        |
+ * |--------|------|--------------------------------------------------------------|
+ * | 0      | 2    | Sync, 0xA5 0x5B                                              |
+ * | 2      | 1    | Version (SCAN_FRAME_VERSION)                                 |
+ * | 3      | 1    | Flags (none defined)                                         |
+ * | 4      | 2    | Sweep number when the grid was sent                          |
+ * | 6      | 2    | Width w in cells                                             |
+ * | 8      | 2    | Height h in cells                                            |
+ * | 10     | 2    | Cell size in cm                                              |
+ * | 12     | 2    | Sensor cell column (signed)                                  |
+ * | 14     | 2    | Sensor cell row (signed)                                     |
+ * | 16     | b    | Cells, b = ceil(w / 8) * h, rows from y = 0, LSB first       |
+ * | 16+b   | 2    | CRC-16/CCITT-FALSE of bytes 2 .. 15+b                        |
+ *
+ * The CRC is the one Python's binascii.crc_hqx(data, 0xFFFF) computes, so the UI needs no
+ * table of its own.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SCAN_FRAME_H
+#define SCAN_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SCAN_FRAME_SYNC0 0xA5u       ///< First sync byte.
+#define SCAN_FRAME_SYNC1 0x5Au       ///< Second sync byte.
+#define SCAN_FRAME_VERSION 1u        ///< Format version.
+#define SCAN_FRAME_HEADER_LEN 12u    ///< Bytes before the points.
+#define SCAN_FRAME_MAX_POINTS 256u   ///< Largest point count accepted.
+#define SCAN_FRAME_REVERSE 0x01u     ///< Flag: the sweep runs from max to min.
+#define SCAN_DIST_MAX 4095u          ///< Largest distance a point holds, in cm.
+#define SCAN_QUALITY_SHIFT 12u       ///< Position of the quality in a point.
+#define SCAN_GRID_SYNC1 0x5Bu        ///< Second sync byte of a grid frame.
+#define SCAN_GRID_HEADER_LEN 16u     ///< Bytes before the grid cells.
+#define SCAN_GRID_MAX_BYTES 4096u    ///< Largest grid accepted, in bytes.
+
+/// Bytes in a frame of n points.
+#define SCAN_FRAME_LEN(n) (SCAN_FRAME_HEADER_LEN + 2u * (n) + 2u)
+
+/// Bytes in a grid frame holding b bytes of cells.
+#define SCAN_GRID_FRAME_LEN(b) (SCAN_GRID_HEADER_LEN + (b) + 2u)
+
+// Error codes returned by scan_frame_decode()
+#define SCAN_FRAME_ERR_SHORT -1   ///< Not enough bytes yet for the whole frame.
+#define SCAN_FRAME_ERR_SYNC -2    ///< No sync at the start of the buffer.
+#define SCAN_FRAME_ERR_VERSION -3 ///< Unknown version.
+#define SCAN_FRAME_ERR_LEN -4     ///< Point count above the caller's limit.
+#define SCAN_FRAME_ERR_CRC -5     ///< CRC mismatch.
+
+typedef struct scan_frame_header
+{
+    uint8_t flags;      ///< SCAN_FRAME_* flags.
+    uint16_t sweep;     ///< Sweep number.
+    int16_t start_cdeg; ///< Angle of the first bin, 0.01 degree.
+    int16_t step_cdeg;  ///< Angle step between bins, 0.01 degree.
+    uint16_t n_points;  ///< Number of points.
+} scan_frame_header_t;
+
+typedef struct scan_grid_header
+{
+    uint16_t sweep;    ///< Sweep number when the grid was sent.
+    uint16_t width;    ///< Cells along x.
+    uint16_t height;   ///< Cells along y.
+    uint16_t cell_cm;  ///< Cell size.
+    int16_t origin_x;  ///< Cell column of the sensor.
+    int16_t origin_y;  ///< Cell row of the sensor.
+} scan_grid_header_t;
+
+/**
+ * @brief Bytes of cells in a grid of the header's size.
+ */
+static inline size_t scan_grid_bytes(const scan_grid_header_t *h)
+{
+    return (size_t)((h->width + 7u) / 8u) * h->height;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ */
+uint16_t scan_frame_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Quality class of an amplitude: 0 if not valid, else 1 + log2(amplitude / 64),
+ * clamped to 1 .. 15.
+ */
+uint8_t scan_quality(uint16_t amplitude, bool valid);
+
+/**
+ * @brief Packs a distance and a quality into a point.
+ */
+static inline uint16_t scan_point(uint16_t distance, uint8_t quality)
+{
+    if (distance > SCAN_DIST_MAX)
+    {
+        distance = SCAN_DIST_MAX;
+    }
+    return (uint16_t)(distance | ((uint16_t)(quality & 0x0Fu) << SCAN_QUALITY_SHIFT));
+}
+
+/**
+ * @brief Distance of a point in cm.
+ */
+static inline uint16_t scan_point_distance(uint16_t point)
+{
+    return point & SCAN_DIST_MAX;
+}
+
+/**
+ * @brief Quality of a point, 0 .. 15.
+ */
+static inline uint8_t scan_point_quality(uint16_t point)
+{
+    return (uint8_t)(point >> SCAN_QUALITY_SHIFT);
+}
+
+/**
+ * @brief Writes a frame.
+ *
+ * @param h Header; n_points points follow.
+ * @param points Packed points (scan_point()).
+ * @param out Output buffer.
+ * @param cap Size of out.
+ * @return size_t Bytes written, or 0 if out is too small or n_points too large.
+ */
+size_t scan_frame_encode(const scan_frame_header_t *h, const uint16_t *points, uint8_t *out, size_t cap);
+
+/**
+ * @brief Reads a frame from the start of a buffer.
+ *
+ * @param buf Received bytes, starting at a sync.
+ * @param len Bytes available.
+ * @param h Output header.
+ * @param points Output points, max_points entries.
+ * @param max_points Largest point count accepted.
+ * @return int Frame length in bytes, or a negative SCAN_FRAME_ERR_* code.
+ */
+int scan_frame_decode(const uint8_t *buf, size_t len, scan_frame_header_t *h, uint16_t *points,
+                      size_t max_points);
+
+/**
+ * @brief Offset of the first possible frame start of either kind (a sync pair, or a lone
+ * first sync byte at the end), or len if there is none.
+ *
+ * After a SYNC, VERSION, LEN or CRC error, search again from offset 1.
+ */
+size_t scan_frame_find(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Writes a grid frame.
+ *
+ * @param h Header.
+ * @param bits Grid cells, scan_grid_bytes(h) bytes.
+ * @param out Output buffer.
+ * @param cap Size of out.
+ * @return size_t Bytes written, or 0 if out is too small or the grid too large.
+ */
+size_t scan_grid_encode(const scan_grid_header_t *h, const uint8_t *bits, uint8_t *out, size_t cap);
+
+/**
+ * @brief Reads a grid frame from the start of a buffer.
+ *
+ * @param buf Received bytes, starting at a sync.
+ * @param len Bytes available.
+ * @param h Output header.
+ * @param bits Output cells, max_bytes bytes.
+ * @param max_bytes Largest grid accepted.
+ * @return int Frame length in bytes, or a negative SCAN_FRAME_ERR_* code.
+ */
+int scan_grid_decode(const uint8_t *buf, size_t len, scan_grid_header_t *h, uint8_t *bits, size_t max_bytes);
+
+#define SCAN_ACCUM_MAX_BINS 361u ///< Bins an accumulator holds (0 .. 360 degrees at 1 degree).
+
+typedef struct scan_sector
+{
+    scan_frame_header_t header; ///< Header for the sector's frame.
+    uint16_t *points;           ///< header.n_points packed points, 0 where nothing was measured.
+} scan_sector_t;
+
+typedef struct scan_accum
+{
+    int32_t min_cdeg;                     ///< Angle of bin 0.
+    int32_t step_cdeg;                    ///< Width of a bin.
+    uint16_t n_bins;                      ///< Bins covering the sweep.
+    uint16_t sector_bins;                 ///< Bins per frame.
+    uint16_t bins[SCAN_ACCUM_MAX_BINS];   ///< Latest point in each bin, 0 if none.
+    uint32_t sweep;                       ///< Sweep of the open sector.
+    uint16_t sector;                      ///< Open sector.
+    bool open;                            ///< A sector is being filled.
+    bool held;                            ///< held_point waits for the closed sector to be used.
+    uint16_t held_bin;                    ///< Bin of the held point.
+    uint16_t held_point;                  ///< First point of a sector reopened at a turnaround.
+    uint32_t sectors;                     ///< Sectors closed.
+} scan_accum_t;
+
+/**
+ * @brief Initializes an accumulator for a sweep between two angles.
+ *
+ * @param a Pointer to the accumulator.
+ * @param min_deg Angle of the first bin in degrees.
+ * @param max_deg Angle of the last bin in degrees.
+ * @param step_cdeg Bin width in 0.01 degree.
+ * @param sector_bins Bins per frame: the whole sweep for one frame per sweep, about half
+ *                    of it for one per half-sweep.
+ */
+void scan_accum_init(scan_accum_t *a, int32_t min_deg, int32_t max_deg, int32_t step_cdeg, uint16_t sector_bins);
+
+/**
+ * @brief Adds a point to its angle bin; a later point in the same bin replaces it.
+ *
+ * A point in a different sweep or sector than the open one first closes the open sector
+ * and returns it in closed. The closed points stay in the accumulator and are only valid
+ * until the next call: encode or filter them before adding another point.
+ *
+ * @param a Pointer to the accumulator.
+ * @param sweep Sweep number (even: min to max, odd: back).
+ * @param cdeg Angle in 0.01 degree.
+ * @param point Packed point.
+ * @param closed Output: the sector closed by this point.
+ * @return true if a sector was closed.
+ */
+bool scan_accum_add(scan_accum_t *a, uint32_t sweep, int32_t cdeg, uint16_t point, scan_sector_t *closed);
+
+/**
+ * @brief Closes the open sector, if any.
+ *
+ * @return true if a sector was closed into closed.
+ */
+bool scan_accum_flush(scan_accum_t *a, scan_sector_t *closed);
+
+/**
+ * @brief Writes the frame of a closed sector.
+ *
+ * @return size_t Bytes written, or 0 if out is too small.
+ */
+static inline size_t scan_sector_encode(const scan_sector_t *s, uint8_t *out, size_t cap)
+{
+    return scan_frame_encode(&s->header, s->points, out, cap);
+}
+
+#endif // SCAN_FRAME_H
@@ -0,0 +1,372 @@
+/**
+ * @file test_scan_frame.c
+ * @brief Scan and grid frame round trips, the sector accumulator, and a stream for the
+ * Python decoder.
+ *
+ * @details
+ * Random frames of every size are encoded and decoded back, both kinds; the CRC is checked
+ * against its standard check value, and each decoder error is provoked: short buffers,
+ * missing sync, unknown version, too many points and every single-bit error.
+ *
+ * The accumulator is fed three passes of a sweep as the firmware feeds it (one sample every
+ * 0.9 degree, one frame per half-sweep): every sector must close with the latest point of
+ * each bin, and at a turnaround the closed sector must stay intact until the next call.
+ *
+ * The sectors are then written into one stream with boot text, junk, false syncs, a grid
+ * frame and a frame with a bad CRC, and decoded from the start as ScanFrameDecoder does it.
+ * With a path argument, the stream and the decoder's expected listing are written to
+ * <path>.bin and <path>.txt, which ui/tests/test_scan_frame.py replays through the Python
+ * decoder in chunks of several sizes.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "scan_frame.h"
+
+#define STREAM_CAP 16384u
+#define GRID_W 20u
+#define GRID_H 10u
+#define SECTOR_BINS 91u
+
+static uint8_t stream[STREAM_CAP];
+static size_t stream_len;
+
+static void random_header(scan_frame_header_t *h, uint16_t n)
+{
+    h->flags = (uint8_t)(rand() & 1);
+    h->sweep = (uint16_t)rand();
+    h->start_cdeg = (int16_t)(rand() % 36000 - 18000);
+    h->step_cdeg = (int16_t)(rand() % 400 - 200);
+    h->n_points = n;
+}
+
+static void test_codec(void)
+{
+    // CRC-16/CCITT-FALSE check value
+    CHECK_EQ(scan_frame_crc16((const uint8_t *)"123456789", 9), 0x29B1);
+
+    static uint8_t buf[SCAN_GRID_FRAME_LEN(SCAN_GRID_MAX_BYTES)];
+    static uint16_t points[SCAN_FRAME_MAX_POINTS], back[SCAN_FRAME_MAX_POINTS];
+    scan_frame_header_t h, hb;
+
+    for (uint16_t n = 0; n <= SCAN_FRAME_MAX_POINTS; n++)
+    {
+        random_header(&h, n);
+        for (uint16_t i = 0; i < n; i++)
+        {
+            points[i] = (uint16_t)rand();
+        }
+        size_t len = scan_frame_encode(&h, points, buf, sizeof(buf));
+        CHECK_EQ(len, SCAN_FRAME_LEN(n));
+        CHECK_EQ(scan_frame_decode(buf, len, &hb, back, SCAN_FRAME_MAX_POINTS), (int)len);
+        CHECK(hb.flags == h.flags && hb.sweep == h.sweep && hb.start_cdeg == h.start_cdeg &&
+              hb.step_cdeg == h.step_cdeg && hb.n_points == n);
+        CHECK(memcmp(back, points, 2u * n) == 0);
+
+        // Every prefix is short; the buffer may hold more than the frame
+        CHECK_EQ(scan_frame_decode(buf, len - 1u, &hb, back, SCAN_FRAME_MAX_POINTS), SCAN_FRAME_ERR_SHORT);
+        CHECK_EQ(scan_frame_decode(buf, 1, &hb, back, SCAN_FRAME_MAX_POINTS), SCAN_FRAME_ERR_SHORT);
+        CHECK_EQ(scan_frame_decode(buf, len + 5u, &hb, back, SCAN_FRAME_MAX_POINTS), (int)len);
+        if (n > 0)
+        {
+            CHECK_EQ(scan_frame_decode(buf, len, &hb, back, n - 1u), SCAN_FRAME_ERR_LEN);
+        }
+        CHECK_EQ(scan_frame_encode(&h, points, buf, len - 1u), 0);
+    }
+    h.n_points = SCAN_FRAME_MAX_POINTS + 1u;
+    CHECK_EQ(scan_frame_encode(&h, points, buf, sizeof(buf)), 0);
+
+    // Any single bit error past the sync is caught, as a CRC, version or length error
+    random_header(&h, 40);
+    size_t len = scan_frame_encode(&h, points, buf, sizeof(buf));
+    for (size_t bit = 16; bit < 8u * len; bit++)
+    {
+        buf[bit / 8u] ^= (uint8_t)(1u << (bit % 8u));
+        int r = scan_frame_decode(buf, len, &hb, back, SCAN_FRAME_MAX_POINTS);
+        CHECK(r == SCAN_FRAME_ERR_CRC || r == SCAN_FRAME_ERR_VERSION || r == SCAN_FRAME_ERR_LEN ||
+              r == SCAN_FRAME_ERR_SHORT);
+        buf[bit / 8u] ^= (uint8_t)(1u << (bit % 8u));
+    }
+    buf[1] = SCAN_GRID_SYNC1;
+    CHECK_EQ(scan_frame_decode(buf, len, &hb, back, SCAN_FRAME_MAX_POINTS), SCAN_FRAME_ERR_SYNC);
+    buf[1] = SCAN_FRAME_SYNC1;
+    buf[2] = SCAN_FRAME_VERSION + 1u;
+    CHECK_EQ(scan_frame_decode(buf, len, &hb, back, SCAN_FRAME_MAX_POINTS), SCAN_FRAME_ERR_VERSION);
+
+    // Grids of every shape up to a few bytes per row
+    static uint8_t bits[SCAN_GRID_MAX_BYTES], bits_back[SCAN_GRID_MAX_BYTES];
+    for (uint16_t w = 1; w <= 40u; w += 3u)
+    {
+        for (uint16_t hgt = 1; hgt <= 30u; hgt += 7u)
+        {
+            scan_grid_header_t g = {(uint16_t)rand(), w, hgt, 10, (int16_t)(w / 2u), (int16_t)-1}, gb;
+            size_t bytes = scan_grid_bytes(&g);
+            CHECK_EQ(bytes, ((w + 7u) / 8u) * hgt);
+            for (size_t i = 0; i < bytes; i++)
+            {
+                bits[i] = (uint8_t)rand();
+            }
+            len = scan_grid_encode(&g, bits, buf, sizeof(buf));
+            CHECK_EQ(len, SCAN_GRID_FRAME_LEN(bytes));
+            CHECK_EQ(scan_grid_decode(buf, len, &gb, bits_back, sizeof(bits_back)), (int)len);
+            CHECK(memcmp(&gb, &g, sizeof(g)) == 0);
+            CHECK(memcmp(bits_back, bits, bytes) == 0);
+            CHECK_EQ(scan_grid_decode(buf, len - 1u, &gb, bits_back, sizeof(bits_back)), SCAN_FRAME_ERR_SHORT);
+            CHECK_EQ(scan_grid_decode(buf, len, &gb, bits_back, bytes - 1u), SCAN_FRAME_ERR_LEN);
+            buf[len - 1u] ^= 0x80u;
+            CHECK_EQ(scan_grid_decode(buf, len, &gb, bits_back, sizeof(bits_back)), SCAN_FRAME_ERR_CRC);
+            CHECK_EQ(scan_frame_decode(buf, len, &hb, back, SCAN_FRAME_MAX_POINTS), SCAN_FRAME_ERR_SYNC);
+        }
+    }
+    scan_grid_header_t big = {0, 8u * 64u, 65u, 10, 0, 0};
+    CHECK_EQ(scan_grid_encode(&big, bits, buf, sizeof(buf)), 0);
+
+    // Sync search
+    const uint8_t junk[] = {0x00, 0xA5, 0x00, 0xA5, 0x5B, 0xA5};
+    CHECK_EQ(scan_frame_find(junk, sizeof(junk)), 3);
+    CHECK_EQ(scan_frame_find(junk + 4, 2), 1); // A lone first byte at the end
+    CHECK_EQ(scan_frame_find(junk, 3), 3);
+    CHECK_EQ(scan_frame_find(junk, 0), 0);
+
+    // Points and quality classes
+    CHECK_EQ(scan_point(5000, 3), SCAN_DIST_MAX | (3u << SCAN_QUALITY_SHIFT));
+    CHECK_EQ(scan_point_distance(scan_point(1234, 15)), 1234);
+    CHECK_EQ(scan_point_quality(scan_point(1234, 15)), 15);
+    CHECK_EQ(scan_point_quality(scan_point(1234, 0x1F)), 15);
+    CHECK_EQ(scan_quality(5000, false), 0);
+    CHECK_EQ(scan_quality(0, true), 0);
+    CHECK_EQ(scan_quality(1, true), 1);
+    CHECK_EQ(scan_quality(127, true), 1);
+    CHECK_EQ(scan_quality(128, true), 2);
+    CHECK_EQ(scan_quality(0xFFFF, true), 10);
+}
+
+/**
+ * @brief Distance seen at an angle in a made-up room, in cm.
+ */
+static uint16_t room(int32_t cdeg, uint32_t pass)
+{
+    return (uint16_t)(150u + (uint32_t)(cdeg / 100) * 3u + pass * 7u + (uint32_t)(rand() % 5));
+}
+
+/**
+ * @brief Appends bytes to the stream.
+ */
+static void put(const void *data, size_t len)
+{
+    CHECK(stream_len + len <= STREAM_CAP);
+    if (stream_len + len <= STREAM_CAP)
+    {
+        memcpy(stream + stream_len, data, len);
+        stream_len += len;
+    }
+}
+
+/**
+ * @brief Checks a closed sector against the points last put in its bins and encodes it.
+ */
+static void take_sector(const scan_sector_t *s, const uint16_t *latest, int32_t step, bool corrupt)
+{
+    uint16_t first = (uint16_t)(s->header.start_cdeg / step);
+    CHECK_EQ(s->header.step_cdeg, step);
+    CHECK(s->header.n_points == SECTOR_BINS || s->header.n_points == 181u - SECTOR_BINS);
+    CHECK_EQ(s->header.flags, (s->header.sweep & 1u) ? SCAN_FRAME_REVERSE : 0);
+    CHECK(memcmp(s->points, latest + first, 2u * s->header.n_points) == 0);
+
+    uint8_t frame[SCAN_FRAME_LEN(SECTOR_BINS)];
+    size_t len = scan_sector_encode(s, frame, sizeof(frame));
+    CHECK_EQ(len, SCAN_FRAME_LEN(s->header.n_points));
+    if (corrupt)
+    {
+        frame[len / 2u] ^= 0x04u;
+    }
+    put(frame, len);
+}
+
+static void test_accum(void)
+{
+    const int32_t step = 100;
+    scan_accum_t a;
+    scan_accum_init(&a, 0, 180, step, SECTOR_BINS);
+    CHECK_EQ(a.n_bins, 181);
+    CHECK_EQ(a.sector_bins, SECTOR_BINS);
+
+    static const char boot[] = "TF-Luna ready\r\nsweep 2000 ms\r\n";
+    put(boot, sizeof(boot) - 1u);
+
+    // latest mirrors the bins: a sector starts empty each time it is (re)opened
+    uint16_t latest[181] = {0};
+    scan_sector_t closed;
+    uint32_t sectors = 0;
+    uint32_t open_sweep = 0;
+    int32_t open_sector = -1;
+    for (uint32_t sweep = 0; sweep < 6u; sweep++)
+    {
+        for (int32_t k = 0; k <= 200; k++)
+        {
+            int32_t cdeg = (sweep & 1u) ? 18000 - 90 * k : 90 * k;
+            uint16_t point = scan_point(room(cdeg, sweep / 2u), (uint8_t)(1u + (uint32_t)k % 15u));
+            int32_t bin = (cdeg + step / 2) / step;
+            int32_t sector = bin / (int32_t)SECTOR_BINS;
+
+            if (scan_accum_add(&a, sweep, cdeg, point, &closed))
+            {
+                // Corrupt one frame of the third pass; junk and a false sync after the first
+                take_sector(&closed, latest, step, sectors == 9u);
+                sectors++;
+                if (sectors == 2u)
+                {
+                    const uint8_t noise[] = {0xA5, 0x5A, 0x07, 0x00, 0xA5, 0x00, 'o', 'k', '\n', 0xA5};
+                    put(noise, sizeof(noise));
+                }
+
+                // At a turnaround the reopened sector is the closed one: it is held
+                CHECK_EQ(a.held, sector == open_sector);
+            }
+            if (sector != open_sector || sweep != open_sweep)
+            {
+                int32_t first = sector * (int32_t)SECTOR_BINS;
+                int32_t n = (sector == 0) ? (int32_t)SECTOR_BINS : 181 - (int32_t)SECTOR_BINS;
+                memset(latest + first, 0, 2u * (size_t)n);
+                open_sector = sector;
+                open_sweep = sweep;
+            }
+            latest[bin] = point;
+        }
+    }
+    CHECK(scan_accum_flush(&a, &closed));
+    take_sector(&closed, latest, step, false);
+    sectors++;
+    CHECK(!scan_accum_flush(&a, &closed));
+    CHECK_EQ(sectors, 12);
+    CHECK_EQ(a.sectors, 12);
+
+    // A grid frame, then a sector added after the grid, as the firmware interleaves them
+    scan_grid_header_t g = {5, GRID_W, GRID_H, 10, GRID_W / 2, 0};
+    uint8_t bits[((GRID_W + 7u) / 8u) * GRID_H];
+    for (size_t i = 0; i < sizeof(bits); i++)
+    {
+        bits[i] = (uint8_t)rand();
+    }
+    uint8_t frame[SCAN_GRID_FRAME_LEN(sizeof(bits))];
+    put(frame, scan_grid_encode(&g, bits, frame, sizeof(frame)));
+    scan_accum_add(&a, 6, 0, scan_point(321, 4), &closed);
+    CHECK(scan_accum_flush(&a, &closed));
+    CHECK_EQ(closed.points[0], scan_point(321, 4));
+    CHECK_EQ(closed.points[1], 0);
+    uint8_t last[SCAN_FRAME_LEN(SECTOR_BINS)];
+    put(last, scan_sector_encode(&closed, last, sizeof(last)));
+}
+
+/**
+ * @brief Decodes the stream from the start as ScanFrameDecoder does, and writes the
+ * listing the Python decoder must reproduce.
+ */
+static void decode_stream(FILE *listing)
+{
+    static uint16_t points[SCAN_FRAME_MAX_POINTS];
+    static uint8_t bits[SCAN_GRID_MAX_BYTES];
+    size_t pos = 0;
+    uint32_t frames = 0, grids = 0, crc_errors = 0, skipped = 0;
+
+    while (pos < stream_len)
+    {
+        size_t start = pos + scan_frame_find(stream + pos, stream_len - pos);
+        if (start + 1u >= stream_len)
+        {
+            skipped += (uint32_t)(stream_len - pos) - (start + 1u == stream_len);
+            break;
+        }
+        skipped += (uint32_t)(start - pos);
+        pos = start;
+
+        int r;
+        if (stream[pos + 1u] == SCAN_GRID_SYNC1)
+        {
+            scan_grid_header_t g;
+            r = scan_grid_decode(stream + pos, stream_len - pos, &g, bits, sizeof(bits));
+            if (r > 0 && listing)
+            {
+                fprintf(listing, "grid %u %u %u %u %d %d ", g.sweep, g.width, g.height, g.cell_cm, g.origin_x,
+                        g.origin_y);
+                for (size_t i = 0; i < scan_grid_bytes(&g); i++)
+                {
+                    fprintf(listing, "%02x", bits[i]);
+                }
+                fprintf(listing, "\n");
+            }
+            grids += r > 0;
+        }
+        else
+        {
+            scan_frame_header_t h;
+            r = scan_frame_decode(stream + pos, stream_len - pos, &h, points, SCAN_FRAME_MAX_POINTS);
+            if (r > 0 && listing)
+            {
+                fprintf(listing, "scan %u %u %d %d", h.sweep, h.flags, h.start_cdeg, h.step_cdeg);
+                for (size_t i = 0; i < h.n_points; i++)
+                {
+                    fprintf(listing, " %u:%u", scan_point_distance(points[i]), scan_point_quality(points[i]));
+                }
+                fprintf(listing, "\n");
+            }
+        }
+        if (r == SCAN_FRAME_ERR_SHORT)
+        {
+            break;
+        }
+        if (r < 0)
+        {
+            crc_errors += r == SCAN_FRAME_ERR_CRC;
+            skipped++;
+            pos++;
+            continue;
+        }
+        frames++;
+        pos += (size_t)r;
+    }
+
+    // 13 sectors less the corrupted one, and the grid
+    CHECK_EQ(frames, 13);
+    CHECK_EQ(grids, 1);
+    CHECK_EQ(crc_errors, 1);
+    CHECK_EQ(pos, stream_len);
+    if (listing)
+    {
+        fprintf(listing, "frames=%u crc_errors=%u skipped=%u\n", frames, crc_errors, skipped);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    srand(17);
+
+    test_codec();
+    test_accum();
+
+    FILE *listing = NULL;
+    if (argc > 1)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s.bin", argv[1]);
+        FILE *bin = fopen(path, "wb");
+        CHECK(bin != NULL);
+        if (bin)
+        {
+            CHECK_EQ(fwrite(stream, 1, stream_len, bin), stream_len);
+            fclose(bin);
+        }
+        snprintf(path, sizeof(path), "%s.txt", argv[1]);
+        listing = fopen(path, "w");
+        CHECK(listing != NULL);
+    }
+    decode_stream(listing);
+    if (listing)
+    {
+        fclose(listing);
+    }
+
+    return host_test_result("scan_frame");
+}
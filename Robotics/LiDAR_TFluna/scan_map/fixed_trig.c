@@ -0,0 +1,64 @@
+/**
+ * @file fixed_trig.c
+ * @brief Q15 sine and cosine of angles in hundredths of a degree, from a 1-degree table.
+ */
+
+#include "fixed_trig.h"
+
+/// round(32767 * sin(k degrees)), k = 0 .. 90.
+static const int16_t sin_deg_q15[91] = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767,
+};
+
+/**
+ * @brief Sine of an angle within the first quadrant, 0 .. 9000.
+ */
+static inline int32_t sin_quadrant(int32_t cdeg)
+{
+    int32_t k = cdeg / 100;
+    int32_t frac = cdeg % 100;
+    int32_t s = sin_deg_q15[k];
+    if (frac)
+    {
+        s += ((sin_deg_q15[k + 1] - s) * frac + 50) / 100;
+    }
+    return s;
+}
+
+int32_t fixed_sin_q15(int32_t cdeg)
+{
+    cdeg %= 36000;
+    if (cdeg < 0)
+    {
+        cdeg += 36000;
+    }
+
+    // sin(180 - a) = sin(a), sin(180 + a) = -sin(a)
+    int32_t sign = 1;
+    if (cdeg >= 18000)
+    {
+        cdeg -= 18000;
+        sign = -1;
+    }
+    if (cdeg > 9000)
+    {
+        cdeg = 18000 - cdeg;
+    }
+    return sign * sin_quadrant(cdeg);
+}
+
+void fixed_polar_to_xy(int32_t cdeg, int32_t r, int32_t *x, int32_t *y)
+{
+    // |r| < 2^16 keeps the products within 32 bits.
+    *x = (r * fixed_cos_q15(cdeg) + (1 << 14)) >> 15;
+    *y = (r * fixed_sin_q15(cdeg) + (1 << 14)) >> 15;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file fixed_trig.h
+ * @brief Q15 sine and cosine of angles in hundredths of a degree, from a 1-degree table.
+ *
+ * @details
+ * A 91-entry quarter-wave table (182 bytes) holds sin(k deg) for k = 0 .. 90. Other
+ * quadrants are unfolded by symmetry and the hundredths are interpolated linearly between
+ * table entries. The worst-case error is about 6e-5 (2 LSB in Q15): at the TF-Luna's
+ * 8 m range that is 0.5 mm, far below the 1 cm distance resolution.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef FIXED_TRIG_H
+#define FIXED_TRIG_H
+
+#include <stdint.h>
+
+#define FIXED_TRIG_ONE 32767 ///< Q15 value of 1.0.
+
+/**
+ * @brief sin(cdeg / 100 degrees) in Q15; any angle, positive or negative.
+ */
+int32_t fixed_sin_q15(int32_t cdeg);
+
+/**
+ * @brief cos(cdeg / 100 degrees) in Q15.
+ */
+static inline int32_t fixed_cos_q15(int32_t cdeg)
+{
+    return fixed_sin_q15(cdeg + 9000);
+}
+
+/**
+ * @brief Cartesian coordinates of a polar point, rounded to the nearest unit.
+ *
+ * @param cdeg Angle in hundredths of a degree, 0 along +x, 9000 along +y.
+ * @param r Radius (e.g. a distance in cm).
+ * @param x Output x, in the units of r.
+ * @param y Output y, in the units of r.
+ */
+void fixed_polar_to_xy(int32_t cdeg, int32_t r, int32_t *x, int32_t *y);
+
+#endif // FIXED_TRIG_H
@@ -0,0 +1,127 @@
+/**
+ * @file occupancy_grid.c
+ * @brief Bit-packed occupancy grid filled from polar LiDAR points.
+ */
+
+#include <string.h>
+#include "occupancy_grid.h"
+#include "fixed_trig.h"
+#include "scan_frame.h"
+
+void occ_grid_init(occ_grid_t *g, uint8_t *bits, uint16_t width, uint16_t height, uint16_t cell_cm,
+                   int16_t origin_x, int16_t origin_y)
+{
+    g->bits = bits;
+    g->width = width;
+    g->height = height;
+    g->stride = (uint16_t)((width + 7u) / 8u);
+    g->cell_cm = cell_cm ? cell_cm : 1;
+    g->origin_x = origin_x;
+    g->origin_y = origin_y;
+    occ_grid_clear(g);
+}
+
+void occ_grid_clear(occ_grid_t *g)
+{
+    memset(g->bits, 0, (size_t)g->stride * g->height);
+    g->hits = 0;
+    g->outside = 0;
+}
+
+static inline void cell_write(occ_grid_t *g, int32_t cx, int32_t cy, bool occupied)
+{
+    if (cx < 0 || cy < 0 || cx >= g->width || cy >= g->height)
+    {
+        return;
+    }
+    uint8_t *b = &g->bits[cy * g->stride + (cx >> 3)];
+    uint8_t mask = (uint8_t)(1u << (cx & 7));
+    *b = occupied ? (uint8_t)(*b | mask) : (uint8_t)(*b & ~mask);
+}
+
+/**
+ * @brief Cell index of a coordinate, rounding towards minus infinity.
+ */
+static inline int32_t cell_of(int32_t v_cm, uint16_t cell_cm)
+{
+    return v_cm >= 0 ? v_cm / cell_cm : -((cell_cm - 1 - v_cm) / cell_cm);
+}
+
+/**
+ * @brief Clears the cells on the line from (x0, y0) up to, but not including, (x1, y1).
+ */
+static void clear_line(occ_grid_t *g, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    int32_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int32_t dy = y1 > y0 ? y0 - y1 : y1 - y0; // -|dy|
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+
+    while (x0 != x1 || y0 != y1)
+    {
+        cell_write(g, x0, y0, false);
+        int32_t e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+bool occ_grid_add(occ_grid_t *g, int32_t cdeg, uint16_t distance_cm, bool clear_ray)
+{
+    int32_t x, y;
+    fixed_polar_to_xy(cdeg, distance_cm, &x, &y);
+    int32_t cx = g->origin_x + cell_of(x, g->cell_cm);
+    int32_t cy = g->origin_y + cell_of(y, g->cell_cm);
+
+    if (clear_ray)
+    {
+        // Cells outside the grid are skipped by cell_write(), so a far return still
+        // clears the part of its beam inside the grid.
+        clear_line(g, g->origin_x, g->origin_y, cx, cy);
+    }
+    if (cx < 0 || cy < 0 || cx >= g->width || cy >= g->height)
+    {
+        g->outside++;
+        return false;
+    }
+    cell_write(g, cx, cy, true);
+    g->hits++;
+    return true;
+}
+
+void occ_grid_add_points(occ_grid_t *g, int32_t start_cdeg, int32_t step_cdeg, const uint16_t *points, size_t n,
+                         bool clear_ray)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (points[i])
+        {
+            occ_grid_add(g, start_cdeg + (int32_t)i * step_cdeg, scan_point_distance(points[i]), clear_ray);
+        }
+    }
+}
+
+uint32_t occ_grid_count(const occ_grid_t *g)
+{
+    uint32_t count = 0;
+    size_t bytes = (size_t)g->stride * g->height;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        uint8_t b = g->bits[i];
+        while (b)
+        {
+            b &= (uint8_t)(b - 1u);
+            count++;
+        }
+    }
+    return count;
+}
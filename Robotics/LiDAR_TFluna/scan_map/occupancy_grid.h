@@ -0,0 +1,101 @@
+/**
+ * @file occupancy_grid.h
+ * @brief Bit-packed occupancy grid filled from polar LiDAR points.
+ *
+ * @details
+ * Each cell is one bit, set when a return landed in it. Rows run along +x and are stored
+ * bottom (y = 0) first, ceil(width / 8) bytes per row, least significant bit first, so a
+ * 160 x 80 grid of 10 cm cells (16 m x 8 m, the sensor at the middle of the bottom edge)
+ * takes 1600 bytes. Points are converted with the fixed-point table in fixed_trig.h.
+ *
+ * With clear_ray set, the cells the beam crossed before its return are cleared (a
+ * Bresenham walk from the sensor cell), so objects that moved away fade from the map
+ * instead of staying forever.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/// Bytes of storage for a grid of w x h cells.
+#define OCC_GRID_BYTES(w, h) ((((w) + 7u) / 8u) * (h))
+
+typedef struct occ_grid
+{
+    uint8_t *bits;     ///< Caller-provided storage, OCC_GRID_BYTES(width, height).
+    uint16_t width;    ///< Cells along x.
+    uint16_t height;   ///< Cells along y.
+    uint16_t stride;   ///< Bytes per row.
+    uint16_t cell_cm;  ///< Cell size.
+    int16_t origin_x;  ///< Cell column of the sensor.
+    int16_t origin_y;  ///< Cell row of the sensor.
+    uint32_t hits;     ///< Points that landed in the grid.
+    uint32_t outside;  ///< Points beyond its edges.
+} occ_grid_t;
+
+/**
+ * @brief Initializes an empty grid.
+ *
+ * @param g Pointer to the grid.
+ * @param bits Storage, OCC_GRID_BYTES(width, height) bytes.
+ * @param width Cells along x.
+ * @param height Cells along y.
+ * @param cell_cm Cell size in cm.
+ * @param origin_x Cell column of the sensor.
+ * @param origin_y Cell row of the sensor.
+ */
+void occ_grid_init(occ_grid_t *g, uint8_t *bits, uint16_t width, uint16_t height, uint16_t cell_cm,
+                   int16_t origin_x, int16_t origin_y);
+
+/**
+ * @brief Empties the grid and its counters.
+ */
+void occ_grid_clear(occ_grid_t *g);
+
+/**
+ * @brief Whether a cell is occupied; cells outside the grid are free.
+ */
+static inline bool occ_grid_get(const occ_grid_t *g, int32_t cx, int32_t cy)
+{
+    if (cx < 0 || cy < 0 || cx >= g->width || cy >= g->height)
+    {
+        return false;
+    }
+    return (g->bits[cy * g->stride + (cx >> 3)] >> (cx & 7)) & 1u;
+}
+
+/**
+ * @brief Adds one return.
+ *
+ * @param g Pointer to the grid.
+ * @param cdeg Beam angle in hundredths of a degree, 0 along +x, 9000 along +y.
+ * @param distance_cm Distance of the return.
+ * @param clear_ray Also clear the cells between the sensor and the return.
+ * @return true if the return fell inside the grid.
+ */
+bool occ_grid_add(occ_grid_t *g, int32_t cdeg, uint16_t distance_cm, bool clear_ray);
+
+/**
+ * @brief Adds a sector of packed points (scan_frame.h); points equal to 0 are skipped.
+ *
+ * @param g Pointer to the grid.
+ * @param start_cdeg Angle of the first point.
+ * @param step_cdeg Angle step between points.
+ * @param points Packed points.
+ * @param n Number of points.
+ * @param clear_ray Also clear the cells each beam crossed.
+ */
+void occ_grid_add_points(occ_grid_t *g, int32_t start_cdeg, int32_t step_cdeg, const uint16_t *points, size_t n,
+                         bool clear_ray);
+
+/**
+ * @brief Number of occupied cells.
+ */
+uint32_t occ_grid_count(const occ_grid_t *g);
+
+#endif // OCCUPANCY_GRID_H
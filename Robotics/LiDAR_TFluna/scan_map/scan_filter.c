@@ -0,0 +1,83 @@
+/**
+ * @file scan_filter.c
+ * @brief Rejects unreliable LiDAR points and removes single-bin spikes across a sector.
+ */
+
+#include "scan_filter.h"
+#include "scan_frame.h"
+
+static inline uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    if (a > b)
+    {
+        uint16_t t = a;
+        a = b;
+        b = t;
+    }
+    // With a <= b, the median is whichever of a, c and b is in the middle.
+    if (c < a)
+    {
+        return a;
+    }
+    return c < b ? c : b;
+}
+
+void scan_filter_run(const scan_filter_config_t *cfg, const uint16_t *in, uint16_t *out, size_t n,
+                     scan_filter_stats_t *stats)
+{
+    uint8_t min_quality = cfg->min_quality ? cfg->min_quality : 1;
+
+    // Pass 1: gate each point on its own.
+    for (size_t i = 0; i < n; i++)
+    {
+        uint16_t p = in[i];
+        out[i] = 0;
+        if (p == 0)
+        {
+            continue;
+        }
+        stats->points++;
+
+        uint16_t d = scan_point_distance(p);
+        if (scan_point_quality(p) < min_quality)
+        {
+            stats->weak++;
+        }
+        else if (d < cfg->min_cm || d > cfg->max_cm)
+        {
+            stats->range++;
+        }
+        else
+        {
+            out[i] = p;
+        }
+    }
+
+    // Pass 2: median of each gated point and its gated neighbours, left to right. prev keeps
+    // the gated value of the left neighbour, since out[i - 1] has already been replaced.
+    uint16_t prev = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint16_t p = out[i];
+        uint16_t left = prev;
+        uint16_t right = i + 1 < n ? out[i + 1] : 0;
+        prev = p;
+        if (p == 0)
+        {
+            continue;
+        }
+        if (cfg->outlier_cm && left && right)
+        {
+            uint16_t d = scan_point_distance(p);
+            uint16_t m = median3(scan_point_distance(left), d, scan_point_distance(right));
+            if ((d > m ? d - m : m - d) > cfg->outlier_cm)
+            {
+                stats->outliers++;
+                out[i] = 0;
+                continue;
+            }
+            out[i] = scan_point(m, scan_point_quality(p));
+        }
+        stats->kept++;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file scan_filter.h
+ * @brief Rejects unreliable LiDAR points and removes single-bin spikes across a sector.
+ *
+ * @details
+ * The filter works on one sector of packed points (scan_frame.h), in angle order, in
+ * two passes:
+ *
+ * 1. Gate: a point is dropped if its quality is below min_quality (quality 0 already
+ *    marks an amplitude the sensor flags as unreliable) or its distance is outside
+ *    min_cm .. max_cm.
+ * 2. Median of three: a point with gated neighbours on both sides is replaced by the
+ *    median of the three distances. If it differs from that median by more than
+ *    outlier_cm it is a spike (a stray reflection, a beam grazing an edge) and is
+ *    dropped instead. Points with fewer than two neighbours are kept as they are.
+ *
+ * The median keeps step edges between near and far objects, where a mean would smear
+ * them. Dropped points become 0, so the output can be sent as a frame of its own.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SCAN_FILTER_H
+#define SCAN_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct scan_filter_config
+{
+    uint8_t min_quality; ///< Lowest quality kept, 1 .. 15.
+    uint16_t min_cm;     ///< Shortest distance kept.
+    uint16_t max_cm;     ///< Longest distance kept.
+    uint16_t outlier_cm; ///< Largest distance from the local median, 0 to skip the median.
+} scan_filter_config_t;
+
+typedef struct scan_filter_stats
+{
+    uint32_t points;   ///< Points measured (non-zero) in the input.
+    uint32_t weak;     ///< Dropped for their quality.
+    uint32_t range;    ///< Dropped for their distance.
+    uint32_t outliers; ///< Dropped as spikes.
+    uint32_t kept;     ///< Points in the output.
+} scan_filter_stats_t;
+
+/// TF-Luna defaults: its 0.2 .. 8 m range, any usable amplitude, 30 cm spikes.
+#define SCAN_FILTER_DEFAULTS {.min_quality = 1, .min_cm = 20, .max_cm = 800, .outlier_cm = 30}
+
+/**
+ * @brief Filters one sector of packed points.
+ *
+ * @param cfg Thresholds.
+ * @param in Input points, 0 where nothing was measured.
+ * @param out Output points (not in), 0 where a point was dropped.
+ * @param n Number of points.
+ * @param stats Counters, added to.
+ */
+void scan_filter_run(const scan_filter_config_t *cfg, const uint16_t *in, uint16_t *out, size_t n,
+                     scan_filter_stats_t *stats);
+
+#endif // SCAN_FILTER_H
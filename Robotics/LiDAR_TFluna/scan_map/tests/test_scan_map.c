@@ -0,0 +1,592 @@
+/**
+ * @file test_scan_map.c
+ * @brief Fixed-point trigonometry, the point filter and the occupancy grid, on simulated
+ * sweeps of a room, and the RAM footprint of the scan path.
+ *
+ * @details
+ * fixed_sin_q15() is compared with sin() at every hundredth of a degree over two turns each
+ * way, and fixed_polar_to_xy() over the TF-Luna's range. scan_filter_run() is compared with
+ * a plain reference on random sectors and checked on hand-made ones: gate, spikes, step
+ * edges, the ends of a sector. The grid is checked cell by cell: bit layout, rounding of
+ * negative coordinates, points outside, and the cells a ray clears.
+ *
+ * A room is then swept as the firmware sweeps it (sectors from scan_accum, filtered, added
+ * to the grid with ray clearing), with 2 cm of noise, 5 % weak returns and 5 % stray
+ * reflections. The filter must more than halve the mean distance error, nearly all the
+ * occupied cells must lie next to a wall, and once an obstacle is taken away its cells
+ * must be cleared by the beams that now pass through them.
+ *
+ * Last, the buffers of the scan path are summed up as LiDAR_TFluna.c declares them and
+ * printed; the total must match the table in the README.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "fixed_trig.h"
+#include "occupancy_grid.h"
+#include "scan_filter.h"
+#include "scan_frame.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// The firmware's sweep and grid (LiDAR_TFluna.c)
+#define BIN_CDEG 100
+#define SECTOR_BINS 91u
+#define GRID_W 160u
+#define GRID_H 80u
+#define CELL_CM 10u
+
+static void test_trig(void)
+{
+    double worst = 0.0;
+    for (int32_t cdeg = -72000; cdeg <= 72000; cdeg++)
+    {
+        double e = fabs(fixed_sin_q15(cdeg) - 32767.0 * sin(cdeg * M_PI / 18000.0));
+        worst = e > worst ? e : worst;
+    }
+    CHECK(worst < 2.1); // 1.25 LSB of interpolation, and the rounding of the table and of the result
+
+    CHECK_EQ(fixed_sin_q15(0), 0);
+    CHECK_EQ(fixed_sin_q15(9000), FIXED_TRIG_ONE);
+    CHECK_EQ(fixed_sin_q15(18000), 0);
+    CHECK_EQ(fixed_sin_q15(27000), -FIXED_TRIG_ONE);
+    CHECK_EQ(fixed_sin_q15(-9000), -FIXED_TRIG_ONE);
+    CHECK_EQ(fixed_cos_q15(0), FIXED_TRIG_ONE);
+    CHECK_EQ(fixed_cos_q15(18000), -FIXED_TRIG_ONE);
+
+    // Rounded to the nearest cm, plus at most 2 LSB of the table at 8 m
+    double worst_xy = 0.0;
+    for (int32_t r = 0; r <= 800; r += 7)
+    {
+        for (int32_t cdeg = -18000; cdeg <= 36000; cdeg += 37)
+        {
+            int32_t x, y;
+            fixed_polar_to_xy(cdeg, r, &x, &y);
+            double a = cdeg * M_PI / 18000.0;
+            double ex = fabs(x - r * cos(a));
+            double ey = fabs(y - r * sin(a));
+            worst_xy = ex > worst_xy ? ex : worst_xy;
+            worst_xy = ey > worst_xy ? ey : worst_xy;
+        }
+    }
+    CHECK(worst_xy < 0.56);
+}
+
+/**
+ * @brief scan_filter_run() written out plainly: gate everything first, then take the
+ * median of each gated point with its gated neighbours.
+ */
+static void filter_reference(const scan_filter_config_t *cfg, const uint16_t *in, uint16_t *out, size_t n,
+                             scan_filter_stats_t *st)
+{
+    uint16_t gated[SCAN_FRAME_MAX_POINTS];
+    uint8_t min_quality = cfg->min_quality ? cfg->min_quality : 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint16_t d = scan_point_distance(in[i]);
+        gated[i] = 0;
+        if (in[i] == 0)
+        {
+            continue;
+        }
+        st->points++;
+        if (scan_point_quality(in[i]) < min_quality)
+        {
+            st->weak++;
+        }
+        else if (d < cfg->min_cm || d > cfg->max_cm)
+        {
+            st->range++;
+        }
+        else
+        {
+            gated[i] = in[i];
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = gated[i];
+        if (gated[i] == 0)
+        {
+            continue;
+        }
+        if (cfg->outlier_cm && i > 0 && i + 1 < n && gated[i - 1] && gated[i + 1])
+        {
+            int d[3] = {scan_point_distance(gated[i - 1]), scan_point_distance(gated[i]),
+                        scan_point_distance(gated[i + 1])};
+            int lo = d[0] < d[2] ? d[0] : d[2];
+            int hi = d[0] < d[2] ? d[2] : d[0];
+            int m = d[1] < lo ? lo : (d[1] > hi ? hi : d[1]);
+            if (abs(d[1] - m) > cfg->outlier_cm)
+            {
+                st->outliers++;
+                out[i] = 0;
+                continue;
+            }
+            out[i] = scan_point((uint16_t)m, scan_point_quality(gated[i]));
+        }
+        st->kept++;
+    }
+}
+
+static void test_filter(void)
+{
+    scan_filter_config_t cfg = SCAN_FILTER_DEFAULTS;
+    scan_filter_stats_t st;
+    uint16_t in[SCAN_FRAME_MAX_POINTS], out[SCAN_FRAME_MAX_POINTS], ref[SCAN_FRAME_MAX_POINTS];
+
+    // A spike between two points of a wall is dropped; a step edge is kept as it is
+    const uint16_t spike[] = {scan_point(300, 9), scan_point(302, 9), scan_point(420, 9), scan_point(301, 9),
+                              scan_point(150, 9), scan_point(151, 9), scan_point(152, 9)};
+    memset(&st, 0, sizeof(st));
+    scan_filter_run(&cfg, spike, out, 7, &st);
+    CHECK_EQ(out[0], scan_point(300, 9)); // One neighbour only: kept as it is
+    CHECK_EQ(out[1], scan_point(302, 9));
+    CHECK_EQ(out[2], 0);
+    CHECK_EQ(out[3], scan_point(301, 9)); // Median of 420 (gated, not dropped), 301 and 150
+    CHECK_EQ(out[4], scan_point(151, 9));
+    CHECK_EQ(out[5], scan_point(151, 9));
+    CHECK_EQ(out[6], scan_point(152, 9));
+    CHECK_EQ(st.points, 7);
+    CHECK_EQ(st.outliers, 1);
+    CHECK_EQ(st.kept, 6);
+
+    // The gate: quality 0, too near, too far; a gap leaves its neighbours as they are
+    const uint16_t gate[] = {scan_point(500, 0), scan_point(19, 5), scan_point(20, 5), 0,
+                             scan_point(800, 1), scan_point(801, 15), scan_point(4000, 15)};
+    memset(&st, 0, sizeof(st));
+    scan_filter_run(&cfg, gate, out, 7, &st);
+    const uint16_t gate_out[] = {0, 0, scan_point(20, 5), 0, scan_point(800, 1), 0, 0};
+    CHECK(memcmp(out, gate_out, sizeof(gate_out)) == 0);
+    CHECK_EQ(st.points, 6);
+    CHECK_EQ(st.weak, 1);
+    CHECK_EQ(st.range, 3);
+    CHECK_EQ(st.kept, 2);
+
+    // A higher quality threshold; outlier_cm 0 skips the median
+    scan_filter_config_t strict = {.min_quality = 6, .min_cm = 0, .max_cm = SCAN_DIST_MAX, .outlier_cm = 0};
+    memset(&st, 0, sizeof(st));
+    scan_filter_run(&strict, spike, out, 7, &st);
+    CHECK(memcmp(out, spike, sizeof(spike)) == 0);
+    CHECK_EQ(st.outliers, 0);
+    memset(&st, 0, sizeof(st));
+    scan_filter_run(&strict, gate, out, 7, &st);
+    CHECK_EQ(st.weak, 4);
+
+    // Random sectors against the reference, counters added up across calls
+    scan_filter_stats_t st_ref;
+    memset(&st, 0, sizeof(st));
+    memset(&st_ref, 0, sizeof(st_ref));
+    size_t bad = 0;
+    for (int run = 0; run < 3000; run++)
+    {
+        size_t n = (size_t)(rand() % (int)(SCAN_FRAME_MAX_POINTS + 1u));
+        uint16_t base = (uint16_t)(rand() % 900);
+        for (size_t i = 0; i < n; i++)
+        {
+            int kind = rand() % 10;
+            uint16_t d = (uint16_t)(base + rand() % 40);
+            if (kind == 0)
+            {
+                in[i] = 0;
+            }
+            else if (kind == 1)
+            {
+                in[i] = scan_point((uint16_t)(rand() % (int)(SCAN_DIST_MAX + 1u)), (uint8_t)(rand() % 16));
+            }
+            else
+            {
+                in[i] = scan_point(d, (uint8_t)(rand() % 16));
+            }
+            if (in[i] == 0 && kind != 0)
+            {
+                in[i] = scan_point(0, 1);
+            }
+        }
+        scan_filter_config_t c = {
+            .min_quality = (uint8_t)(rand() % 16),
+            .min_cm = (uint16_t)(rand() % 100),
+            .max_cm = (uint16_t)(400 + rand() % 600),
+            .outlier_cm = (uint16_t)(rand() % 4 ? rand() % 60 : 0),
+        };
+        scan_filter_run(&c, in, out, n, &st);
+        filter_reference(&c, in, ref, n, &st_ref);
+        bad += memcmp(out, ref, n * sizeof(out[0])) != 0;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(memcmp(&st, &st_ref, sizeof(st)) == 0);
+    CHECK_EQ(st.points, st.weak + st.range + st.outliers + st.kept);
+    CHECK(st.outliers > 1000u);
+}
+
+static void test_grid(void)
+{
+    uint8_t bits[OCC_GRID_BYTES(20u, 10u)];
+    occ_grid_t g;
+    CHECK_EQ(sizeof(bits), 30);
+    memset(bits, 0x5A, sizeof(bits));
+    occ_grid_init(&g, bits, 20, 10, 10, 10, 0);
+    CHECK_EQ(g.stride, 3);
+    CHECK_EQ(occ_grid_count(&g), 0);
+
+    // 55 cm along +x is cell 15 of row 0: byte 1, bit 7
+    CHECK(occ_grid_add(&g, 0, 55, false));
+    CHECK_EQ(bits[1], 0x80);
+    CHECK(occ_grid_get(&g, 15, 0));
+
+    // Along -x, -55 cm rounds down to cell -6 from the sensor
+    CHECK(occ_grid_add(&g, 18000, 55, false));
+    CHECK(occ_grid_get(&g, 4, 0));
+    CHECK(occ_grid_add(&g, 18000, 50, false));
+    CHECK(occ_grid_get(&g, 5, 0));
+    CHECK(occ_grid_add(&g, 18000, 49, false));
+    CHECK(occ_grid_get(&g, 5, 0));
+    CHECK_EQ(occ_grid_count(&g), 3);
+
+    // Straight up, the top row is 9
+    CHECK(occ_grid_add(&g, 9000, 99, false));
+    CHECK(occ_grid_get(&g, 10, 9));
+    CHECK(occ_grid_get(&g, 10, 9) == ((bits[9 * 3 + 1] >> 2) & 1u));
+
+    // Outside, and out of range of occ_grid_get()
+    CHECK(!occ_grid_add(&g, 9000, 100, false));
+    CHECK(!occ_grid_add(&g, 0, 200, false));
+    CHECK(!occ_grid_add(&g, 27000, 20, false));
+    CHECK_EQ(g.hits, 5);
+    CHECK_EQ(g.outside, 3);
+    CHECK(!occ_grid_get(&g, -1, 0));
+    CHECK(!occ_grid_get(&g, 20, 0));
+    CHECK(!occ_grid_get(&g, 0, 10));
+
+    // Rays: straight up clears the cells below the return only
+    memset(bits, 0xFF, sizeof(bits));
+    uint32_t full = occ_grid_count(&g);
+    CHECK_EQ(full, 20u * 10u + 4u * 10u); // Padding bits of each row are counted too
+    CHECK(occ_grid_add(&g, 9000, 55, true));
+    for (int32_t y = 0; y < 10; y++)
+    {
+        CHECK(occ_grid_get(&g, 10, y) == (y >= 5));
+    }
+    CHECK_EQ(occ_grid_count(&g), full - 5u);
+
+    // A diagonal clears one cell per step
+    CHECK(occ_grid_add(&g, 4500, 71, true));
+    for (int32_t k = 0; k < 5; k++)
+    {
+        CHECK(!occ_grid_get(&g, 10 + k, k));
+    }
+    CHECK(occ_grid_get(&g, 15, 5));
+    CHECK(occ_grid_get(&g, 11, 0));
+    CHECK_EQ(occ_grid_count(&g), full - 9u); // (10, 0) was already clear
+
+    // A return beyond the edge still clears the part of the beam inside
+    CHECK(!occ_grid_add(&g, 0, 300, true));
+    for (int32_t x = 10; x < 20; x++)
+    {
+        CHECK(!occ_grid_get(&g, x, 0));
+    }
+
+    // Rays in every direction: one cell cleared per step along the longer axis, none of
+    // them more than a cell's half-diagonal off the beam
+    static uint8_t big[OCC_GRID_BYTES(64u, 64u)];
+    occ_grid_t wide;
+    occ_grid_init(&wide, big, 64, 64, 1, 32, 32);
+    size_t bad = 0;
+    for (int32_t cdeg = 0; cdeg < 36000; cdeg += 113)
+    {
+        memset(big, 0xFF, sizeof(big));
+        uint16_t r = (uint16_t)(5 + cdeg % 25);
+        occ_grid_add(&wide, cdeg, r, true);
+        int32_t ex, ey;
+        fixed_polar_to_xy(cdeg, r, &ex, &ey);
+        double len = sqrt((double)ex * ex + (double)ey * ey);
+        uint32_t cleared = 0;
+        for (int32_t cy = 0; cy < 64; cy++)
+        {
+            for (int32_t cx = 0; cx < 64; cx++)
+            {
+                if (!occ_grid_get(&wide, cx, cy))
+                {
+                    double px = cx - 32, py = cy - 32;
+                    bad += fabs(px * ey - py * ex) / len > 0.7072;
+                    cleared++;
+                }
+            }
+        }
+        bad += cleared != (uint32_t)(abs(ex) > abs(ey) ? abs(ex) : abs(ey));
+    }
+    CHECK_EQ(bad, 0);
+
+    // A sector of packed points: zeros are skipped
+    occ_grid_clear(&g);
+    CHECK_EQ(g.hits, 0);
+    CHECK_EQ(g.outside, 0);
+    const uint16_t pts[] = {scan_point(35, 3), 0, scan_point(35, 3), 0, scan_point(35, 3)};
+    occ_grid_add_points(&g, 0, 4500, pts, 5, true);
+    CHECK_EQ(g.hits, 3);
+    CHECK(occ_grid_get(&g, 13, 0));
+    CHECK(occ_grid_get(&g, 10, 3));
+    CHECK(occ_grid_get(&g, 6, 0));
+    CHECK_EQ(occ_grid_count(&g), 3);
+}
+
+/// An axis-aligned rectangle, in cm, the sensor at (0, 0).
+typedef struct box
+{
+    double x0, y0, x1, y1;
+} box_t;
+
+// A 8 m x 5 m room with the sensor in the middle of one wall, and a crate in it
+static const box_t room = {-400.0, -1.0, 400.0, 500.0};
+static const box_t crate = {100.0, 150.0, 180.0, 230.0};
+
+/**
+ * @brief Distance along a ray to the walls of the room (from inside) or to the crate.
+ */
+static double cast(double a, bool with_crate)
+{
+    double dx = cos(a), dy = sin(a);
+    double t = 1e9;
+    if (dx > 1e-12)
+    {
+        t = fmin(t, room.x1 / dx);
+    }
+    if (dx < -1e-12)
+    {
+        t = fmin(t, room.x0 / dx);
+    }
+    if (dy > 1e-12)
+    {
+        t = fmin(t, room.y1 / dy);
+    }
+    if (with_crate)
+    {
+        // Slab test
+        double tmin = 0.0, tmax = 1e9;
+        const double lo[2] = {crate.x0, crate.y0}, hi[2] = {crate.x1, crate.y1}, d[2] = {dx, dy};
+        for (int k = 0; k < 2; k++)
+        {
+            if (fabs(d[k]) < 1e-12)
+            {
+                if (lo[k] > 0.0 || hi[k] < 0.0)
+                {
+                    tmax = -1.0;
+                }
+                continue;
+            }
+            double t0 = lo[k] / d[k], t1 = hi[k] / d[k];
+            tmin = fmax(tmin, fmin(t0, t1));
+            tmax = fmin(tmax, fmax(t0, t1));
+        }
+        if (tmax >= tmin && tmin > 0.0)
+        {
+            t = fmin(t, tmin);
+        }
+    }
+    return t;
+}
+
+/**
+ * @brief Gaussian noise from the sum of twelve uniforms.
+ */
+static double noise(double sigma)
+{
+    double s = -6.0;
+    for (int k = 0; k < 12; k++)
+    {
+        s += rand() / (double)RAND_MAX;
+    }
+    return s * sigma;
+}
+
+/**
+ * @brief Whether a cell lies within one cell of a wall or of the crate.
+ */
+static bool near_surface(int32_t cx, int32_t cy, bool with_crate)
+{
+    double x = ((double)cx - GRID_W / 2u + 0.5) * CELL_CM;
+    double y = ((double)cy + 0.5) * CELL_CM;
+    double reach = 1.5 * CELL_CM;
+    if (fabs(x - room.x0) <= reach || fabs(x - room.x1) <= reach || fabs(y - room.y1) <= reach)
+    {
+        return true;
+    }
+    return with_crate && x >= crate.x0 - reach && x <= crate.x1 + reach && y >= crate.y0 - reach &&
+           y <= crate.y1 + reach;
+}
+
+typedef struct room_stats
+{
+    double raw_error;      ///< Sum of |distance - truth| over the raw points.
+    double filtered_error; ///< Same over the filtered points.
+    uint32_t raw;          ///< Raw points measured.
+    uint32_t filtered;     ///< Filtered points kept.
+} room_stats_t;
+
+/**
+ * @brief Sweeps the room through scan_accum, filters each sector and adds it to the grid,
+ * as process_sector() does.
+ */
+static void sweep_room(occ_grid_t *g, uint32_t sweeps, bool with_crate, room_stats_t *rs)
+{
+    static scan_accum_t acc;
+    static uint16_t truth[181];
+    scan_filter_config_t cfg = SCAN_FILTER_DEFAULTS;
+    scan_filter_stats_t st;
+    uint16_t filtered[SECTOR_BINS];
+    scan_sector_t s;
+
+    memset(&st, 0, sizeof(st));
+    scan_accum_init(&acc, 0, 180, BIN_CDEG, SECTOR_BINS);
+    for (uint32_t sweep = 0; sweep < sweeps; sweep++)
+    {
+        // One sample per bin, at its centre, so that each point has a known true distance
+        for (int32_t k = 0; k <= 180; k++)
+        {
+            int32_t bin = (sweep & 1u) ? 180 - k : k;
+            double d = cast(bin * M_PI / 180.0, with_crate);
+            truth[bin] = (uint16_t)lround(d);
+
+            double measured = d + noise(2.0);
+            uint8_t quality = (uint8_t)(4 + rand() % 12);
+            int kind = rand() % 20;
+            if (kind == 0)
+            {
+                measured = d + (rand() % 200 - 100); // Weak return
+                quality = 0;
+            }
+            else if (kind == 1)
+            {
+                measured = 20 + rand() % 781; // Stray reflection
+            }
+            uint16_t point = scan_point((uint16_t)lround(fmax(measured, 1.0)), quality);
+
+            if (scan_accum_add(&acc, sweep, bin * BIN_CDEG, point, &s) ||
+                (sweep + 1u == sweeps && k == 180 && scan_accum_flush(&acc, &s)))
+            {
+                int32_t first = s.header.start_cdeg / BIN_CDEG;
+                CHECK(s.header.n_points <= SECTOR_BINS);
+                scan_filter_run(&cfg, s.points, filtered, s.header.n_points, &st);
+                occ_grid_add_points(g, s.header.start_cdeg, s.header.step_cdeg, filtered, s.header.n_points, true);
+                for (size_t i = 0; i < s.header.n_points; i++)
+                {
+                    uint16_t t = truth[first + (int32_t)i];
+                    if (s.points[i])
+                    {
+                        rs->raw++;
+                        rs->raw_error += abs(scan_point_distance(s.points[i]) - t);
+                    }
+                    if (filtered[i])
+                    {
+                        rs->filtered++;
+                        rs->filtered_error += abs(scan_point_distance(filtered[i]) - t);
+                    }
+                }
+            }
+        }
+    }
+    // The last sector has been flushed along with the last sample
+    CHECK(!scan_accum_flush(&acc, &s));
+    CHECK_EQ(st.points, rs->raw);
+    CHECK_EQ(st.kept, rs->filtered);
+}
+
+static void test_room(void)
+{
+    static uint8_t bits[OCC_GRID_BYTES(GRID_W, GRID_H)];
+    occ_grid_t g;
+    occ_grid_init(&g, bits, GRID_W, GRID_H, CELL_CM, GRID_W / 2u, 0);
+
+    room_stats_t rs = {0};
+    sweep_room(&g, 10, true, &rs);
+    double raw = rs.raw_error / rs.raw;
+    double filtered = rs.filtered_error / rs.filtered;
+    CHECK_EQ(rs.raw, 10u * 181u);
+    CHECK(rs.filtered > rs.raw * 85u / 100u);
+    CHECK(filtered < raw / 2.0);
+    CHECK(filtered < 5.0);
+
+    uint32_t occupied = 0, near = 0, crate_cells = 0;
+    for (int32_t cy = 0; cy < (int32_t)GRID_H; cy++)
+    {
+        for (int32_t cx = 0; cx < (int32_t)GRID_W; cx++)
+        {
+            if (occ_grid_get(&g, cx, cy))
+            {
+                occupied++;
+                near += near_surface(cx, cy, true);
+                crate_cells += near_surface(cx, cy, true) && !near_surface(cx, cy, false);
+            }
+        }
+    }
+    CHECK_EQ(occupied, occ_grid_count(&g));
+    CHECK(occupied > 100u);
+    CHECK(crate_cells > 5u);
+    double on_walls = 100.0 * near / occupied;
+    CHECK(on_walls > 95.0);
+    printf("room: mean error %.1f cm raw, %.1f cm filtered; %.1f %% of %u occupied cells next to a surface\n", raw,
+           filtered, on_walls, (unsigned)occupied);
+
+    // The crate is taken away: the beams now reach the wall behind it and clear its cells
+    room_stats_t after = {0};
+    sweep_room(&g, 4, false, &after);
+    crate_cells = 0;
+    for (int32_t cy = 0; cy < (int32_t)GRID_H; cy++)
+    {
+        for (int32_t cx = 0; cx < (int32_t)GRID_W; cx++)
+        {
+            crate_cells += occ_grid_get(&g, cx, cy) && near_surface(cx, cy, true) && !near_surface(cx, cy, false);
+        }
+    }
+    CHECK_EQ(crate_cells, 0);
+}
+
+/**
+ * @brief Size of occ_grid_t on the RP2040, where its pointer takes 4 bytes.
+ */
+static size_t occ_grid_size_32(void)
+{
+    return sizeof(uint32_t) + offsetof(occ_grid_t, outside) + sizeof(uint32_t) - offsetof(occ_grid_t, width);
+}
+
+static void test_footprint(void)
+{
+    // The buffers of LiDAR_TFluna.c, in the order of the README table
+    const size_t accum = sizeof(scan_accum_t);
+    const size_t filtered = SECTOR_BINS * sizeof(uint16_t);
+    const size_t cells = OCC_GRID_BYTES(GRID_W, GRID_H);
+    const size_t out = SCAN_GRID_FRAME_LEN(OCC_GRID_BYTES(GRID_W, GRID_H));
+    const size_t misc = occ_grid_size_32() + sizeof(scan_filter_config_t) + sizeof(scan_filter_stats_t);
+
+    CHECK_EQ(accum, 752);
+    CHECK_EQ(filtered, 182);
+    CHECK_EQ(cells, 1600);
+    CHECK_EQ(out, 1618);
+    CHECK_EQ(misc, 52);
+    CHECK_EQ(accum + filtered + cells + out + misc, 4204);
+    CHECK(out >= SCAN_FRAME_LEN(SECTOR_BINS)); // Also holds a sector's frame
+    CHECK(sizeof(void *) != 4 || occ_grid_size_32() == sizeof(occ_grid_t));
+
+    printf("scan path RAM: accumulator %zu, filtered sector %zu, grid cells %zu, output frame %zu, "
+           "grid, settings and counters %zu: %zu bytes\n",
+           accum, filtered, cells, out, misc, accum + filtered + cells + out + misc);
+}
+
+int main(void)
+{
+    srand(18);
+
+    test_trig();
+    test_filter();
+    test_grid();
+    test_room();
+    test_footprint();
+
+    return host_test_result("scan_map");
+}
@@ -0,0 +1,80 @@
+/**
+ * @file servo_sweep.c
+ * @brief Timed triangle trajectory for a continuously sweeping servo.
+ */
+
+#include "servo_sweep.h"
+
+void servo_sweep_init(servo_sweep_t *s, int32_t min_deg, int32_t max_deg, uint32_t sweep_ms, uint32_t lag_us,
+                      uint32_t start_us)
+{
+    if (sweep_ms == 0)
+    {
+        sweep_ms = 1;
+    }
+    s->start_us = start_us;
+    s->sweep_us = sweep_ms * 1000u;
+    s->lag_us = lag_us;
+    s->periods = 0;
+    s->min_cdeg = min_deg * SERVO_SWEEP_CDEG;
+    s->max_cdeg = max_deg * SERVO_SWEEP_CDEG;
+}
+
+void servo_sweep_advance(servo_sweep_t *s, uint32_t now_us)
+{
+    uint32_t period = 2u * s->sweep_us;
+    while ((int32_t)(now_us - s->start_us) >= (int32_t)period)
+    {
+        s->start_us += period;
+        s->periods++;
+    }
+}
+
+/**
+ * @brief Position of a time within the period, 0 .. 2 * sweep_us - 1, and the periods
+ * elapsed since init (negative before it).
+ */
+static uint32_t sweep_phase(const servo_sweep_t *s, uint32_t t_us, int32_t *period)
+{
+    int32_t period_us = (int32_t)(2u * s->sweep_us);
+    int32_t e = (int32_t)(t_us - s->start_us);
+
+    // Floor division, so that times before the origin fall in the previous period.
+    int32_t q = e / period_us;
+    int32_t r = e % period_us;
+    if (r < 0)
+    {
+        r += period_us;
+        q--;
+    }
+    *period = (int32_t)s->periods + q;
+    return (uint32_t)r;
+}
+
+int32_t servo_sweep_command_at(const servo_sweep_t *s, uint32_t t_us)
+{
+    int32_t period;
+    uint32_t p = sweep_phase(s, t_us, &period);
+    if (period < 0)
+    {
+        return s->min_cdeg;
+    }
+
+    int64_t span = (int64_t)s->max_cdeg - s->min_cdeg;
+    if (p < s->sweep_us)
+    {
+        return s->min_cdeg + (int32_t)(span * p / s->sweep_us);
+    }
+    return s->max_cdeg - (int32_t)(span * (p - s->sweep_us) / s->sweep_us);
+}
+
+uint32_t servo_sweep_index_at(const servo_sweep_t *s, uint32_t t_us)
+{
+    int32_t period;
+    uint32_t p = sweep_phase(s, t_us - s->lag_us, &period);
+    if (period < 0)
+    {
+        return 0;
+    }
+    return 2u * (uint32_t)period + (p >= s->sweep_us ? 1u : 0u);
+}
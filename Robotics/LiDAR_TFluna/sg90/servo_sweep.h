@@ -0,0 +1,81 @@
+/**
+ * @file servo_sweep.h
+ * @brief Timed triangle trajectory for a continuously sweeping servo.
+ *
+ * @details
+ * Instead of stepping and waiting for the servo to settle, the scanner keeps the servo
+ * moving at a constant rate between two angles. The trajectory is a function of time
+ * only, so two things are read off the same curve:
+ *
+ * - the angle to command: the PWM wrap interrupt writes the angle due at the next wrap,
+ *   which is when a new compare value takes effect;
+ * - the angle a measurement was taken at: the LiDAR's data-ready time, minus the servo's
+ *   lag behind its command, gives an angle interpolated between two PWM updates.
+ *
+ * One sweep is one pass from min to max or back; a period is two sweeps. The curve is
+ * periodic, so servo_sweep_advance() can move the origin forward by whole periods to keep
+ * times close to it, and a timestamp from just before the origin still maps to the right
+ * angle. Times are microseconds from a free-running 32-bit counter and must lie within
+ * 2^31 us of the origin. Angles are in hundredths of a degree.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SERVO_SWEEP_H
+#define SERVO_SWEEP_H
+
+#include <stdint.h>
+
+#define SERVO_SWEEP_CDEG 100 ///< Angle units per degree.
+
+typedef struct servo_sweep
+{
+    uint32_t start_us;  ///< Origin: the servo is at min_cdeg heading up.
+    uint32_t sweep_us;  ///< Time of one pass between the limits.
+    uint32_t lag_us;    ///< Delay from command to servo position.
+    uint32_t periods;   ///< Whole periods the origin has been moved by.
+    int32_t min_cdeg;   ///< Lower limit.
+    int32_t max_cdeg;   ///< Upper limit.
+} servo_sweep_t;
+
+/**
+ * @brief Initializes a sweep starting at the lower limit.
+ *
+ * @param s Pointer to the sweep.
+ * @param min_deg Lower limit in degrees.
+ * @param max_deg Upper limit in degrees.
+ * @param sweep_ms Time of one pass between the limits, in ms (at least 1).
+ * @param lag_us Delay from command to servo position.
+ * @param start_us Time the sweep starts.
+ */
+void servo_sweep_init(servo_sweep_t *s, int32_t min_deg, int32_t max_deg, uint32_t sweep_ms, uint32_t lag_us,
+                      uint32_t start_us);
+
+/**
+ * @brief Moves the origin forward by whole periods so that it is no later than now_us.
+ *
+ * Call it regularly (e.g. from the PWM wrap interrupt); the curve is unchanged.
+ */
+void servo_sweep_advance(servo_sweep_t *s, uint32_t now_us);
+
+/**
+ * @brief Commanded angle at a time, in hundredths of a degree.
+ */
+int32_t servo_sweep_command_at(const servo_sweep_t *s, uint32_t t_us);
+
+/**
+ * @brief Estimated servo angle at a time: the command lag_us earlier.
+ */
+static inline int32_t servo_sweep_angle_at(const servo_sweep_t *s, uint32_t t_us)
+{
+    return servo_sweep_command_at(s, t_us - s->lag_us);
+}
+
+/**
+ * @brief Number of the sweep the servo is in at a time, counted from init.
+ *
+ * Even sweeps go from min to max, odd ones back. Like the angle, it accounts for lag_us.
+ */
+uint32_t servo_sweep_index_at(const servo_sweep_t *s, uint32_t t_us);
+
+#endif // SERVO_SWEEP_H
@@ -0,0 +1,92 @@
+/**
+ * @file servo_table.c
+ * @brief PWM timing for hobby servos and per-servo angle-to-level lookup tables.
+ */
+
+#include "servo_table.h"
+
+bool servo_timing_init(servo_timing_t *t, uint32_t sys_hz, uint32_t freq_hz)
+{
+    if (sys_hz == 0 || freq_hz == 0)
+    {
+        return false;
+    }
+
+    // Clock cycles per frame in 1/16 units, matching the divider's 4 fractional bits.
+    uint64_t cycles16 = (uint64_t)sys_hz * 16u / freq_hz;
+
+    // Smallest divider that keeps the frame within 65536 counts.
+    uint64_t div16 = (cycles16 + 65535u) / 65536u;
+    if (div16 < SERVO_DIV_MIN)
+    {
+        div16 = SERVO_DIV_MIN;
+    }
+    if (div16 > SERVO_DIV_MAX)
+    {
+        return false;
+    }
+
+    uint64_t counts = (cycles16 + div16 / 2u) / div16;
+    if (counts < 2u || counts > 65536u)
+    {
+        return false;
+    }
+
+    t->sys_hz = sys_hz;
+    t->freq_hz = freq_hz;
+    t->div16 = (uint16_t)div16;
+    t->top = (uint16_t)(counts - 1u);
+    return true;
+}
+
+uint16_t servo_timing_level(const servo_timing_t *t, uint32_t pulse_ns)
+{
+    // level = pulse * sys_hz / (div16 / 16) / 1e9, rounded.
+    uint64_t den = (uint64_t)t->div16 * 1000000000u;
+    uint64_t level = ((uint64_t)pulse_ns * t->sys_hz * 16u + den / 2u) / den;
+    if (level > (uint64_t)t->top + 1u)
+    {
+        level = (uint64_t)t->top + 1u;
+    }
+    return (uint16_t)level;
+}
+
+uint32_t servo_timing_period_ns(const servo_timing_t *t)
+{
+    uint64_t cycles16 = ((uint64_t)t->top + 1u) * t->div16;
+    return (uint32_t)((cycles16 * 1000000000u / 16u + t->sys_hz / 2u) / t->sys_hz);
+}
+
+bool servo_table_init(servo_table_t *tab, const servo_timing_t *t, const servo_cal_t *cal)
+{
+    if (cal->range_deg == 0 || cal->range_deg >= SERVO_TABLE_LEN || cal->max_us <= cal->min_us)
+    {
+        return false;
+    }
+
+    int32_t max_cdeg = (int32_t)cal->range_deg * 100;
+    uint32_t span_ns = (uint32_t)(cal->max_us - cal->min_us) * 1000u;
+    tab->max_cdeg = (uint16_t)max_cdeg;
+
+    for (uint32_t deg = 0; deg <= cal->range_deg; deg++)
+    {
+        int32_t cdeg = (int32_t)deg * 100 + cal->trim_cdeg;
+        if (cdeg < 0)
+        {
+            cdeg = 0;
+        }
+        if (cdeg > max_cdeg)
+        {
+            cdeg = max_cdeg;
+        }
+        if (cal->reversed)
+        {
+            cdeg = max_cdeg - cdeg;
+        }
+
+        uint32_t pulse_ns = cal->min_us * 1000u + (uint32_t)(((uint64_t)span_ns * (uint32_t)cdeg + (uint32_t)max_cdeg / 2u) /
+                                                            (uint32_t)max_cdeg);
+        tab->level[deg] = servo_timing_level(t, pulse_ns);
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file servo_table.h
+ * @brief PWM timing for hobby servos and per-servo angle-to-level lookup tables.
+ *
+ * @details
+ * servo_timing_init() picks the PWM divider and wrap for a servo frame rate from the
+ * actual system clock. The divider is the smallest one that fits the period in the 16-bit
+ * counter, which gives the finest pulse resolution: at 125 MHz and 50 Hz one count is
+ * about 0.31 us, against 1 us with a divider of 125.
+ *
+ * servo_table_init() turns a servo's calibration into one PWM level per whole degree.
+ * The calibration holds the pulse widths at both ends of the travel, a trim and the
+ * direction. All the divisions happen there, once, in 64-bit arithmetic. At run time
+ * servo_table_level() is a lookup plus a linear interpolation between two entries, using
+ * only multiplies and shifts. The Cortex-M0+ has no divide instruction, and this runs
+ * from the PWM wrap interrupt.
+ *
+ * Tables depend on the system clock: rebuild them after changing it.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SERVO_TABLE_H
+#define SERVO_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SERVO_TABLE_LEN 181u ///< Entries in a table: 0 .. 180 degrees.
+#define SERVO_DIV_MIN 16u    ///< Smallest PWM divider, 1.0 in 8.4 fixed point.
+#define SERVO_DIV_MAX 4095u  ///< Largest PWM divider, 255 + 15/16.
+
+typedef struct servo_timing
+{
+    uint32_t sys_hz;  ///< System clock the timing was computed for.
+    uint32_t freq_hz; ///< Requested frame rate.
+    uint16_t div16;   ///< Divider in 8.4 fixed point (integer part div16 >> 4).
+    uint16_t top;     ///< Wrap value; the period is top + 1 counts.
+} servo_timing_t;
+
+typedef struct servo_cal
+{
+    uint16_t min_us;    ///< Pulse width at 0 degrees.
+    uint16_t max_us;    ///< Pulse width at range_deg.
+    uint16_t range_deg; ///< Travel, 1 .. 180 degrees.
+    int16_t trim_cdeg;  ///< Added to every commanded angle, 0.01 degree.
+    bool reversed;      ///< Angle 0 is at max_us.
+} servo_cal_t;
+
+/// SG90 datasheet limits with no trim.
+#define SERVO_CAL_SG90 {.min_us = 500, .max_us = 2400, .range_deg = 180, .trim_cdeg = 0, .reversed = false}
+
+typedef struct servo_table
+{
+    uint16_t max_cdeg;               ///< Largest angle, range_deg * 100.
+    uint16_t level[SERVO_TABLE_LEN]; ///< PWM level at each whole degree.
+} servo_table_t;
+
+/**
+ * @brief Computes the divider and wrap for a frame rate.
+ *
+ * @param t Output timing.
+ * @param sys_hz System clock in Hz, e.g. clock_get_hz(clk_sys).
+ * @param freq_hz Frame rate in Hz (50 for most servos).
+ * @return true if the rate can be reached with the 8.4 divider and a 16-bit counter.
+ */
+bool servo_timing_init(servo_timing_t *t, uint32_t sys_hz, uint32_t freq_hz);
+
+/**
+ * @brief PWM level of a pulse width, rounded to the nearest count and clamped to top + 1.
+ *
+ * @param t Timing.
+ * @param pulse_ns Pulse width in nanoseconds.
+ */
+uint16_t servo_timing_level(const servo_timing_t *t, uint32_t pulse_ns);
+
+/**
+ * @brief Actual period of the timing in nanoseconds.
+ */
+uint32_t servo_timing_period_ns(const servo_timing_t *t);
+
+/**
+ * @brief Builds a servo's lookup table.
+ *
+ * The trimmed angle is clamped to the travel, so a trim never drives the pulse past
+ * min_us or max_us.
+ *
+ * @param tab Output table.
+ * @param t Timing of the slice the servo is on.
+ * @param cal Calibration.
+ * @return true on success, false if the calibration is out of range.
+ */
+bool servo_table_init(servo_table_t *tab, const servo_timing_t *t, const servo_cal_t *cal);
+
+/**
+ * @brief PWM level for an angle, clamped to 0 .. max_cdeg.
+ *
+ * @param tab Table.
+ * @param cdeg Angle in 0.01 degree.
+ */
+static inline uint16_t servo_table_level(const servo_table_t *tab, int32_t cdeg)
+{
+    if (cdeg <= 0)
+    {
+        return tab->level[0];
+    }
+    if (cdeg > tab->max_cdeg)
+    {
+        cdeg = tab->max_cdeg;
+    }
+
+    // cdeg / 100 as a multiply and shift, exact for cdeg up to 43698.
+    uint32_t i = ((uint32_t)cdeg * 5243u) >> 19;
+    uint32_t frac = (uint32_t)cdeg - i * 100u;
+    uint16_t a = tab->level[i];
+    if (frac == 0)
+    {
+        return a;
+    }
+    uint16_t b = tab->level[i + 1];
+
+    // frac / 100 as frac * 656 / 65536: 0.1% high, a small fraction of a count.
+    if (b >= a)
+    {
+        return (uint16_t)(a + (((uint32_t)(b - a) * frac * 656u + 32768u) >> 16));
+    }
+    return (uint16_t)(a - (((uint32_t)(a - b) * frac * 656u + 32768u) >> 16));
+}
+
+#endif // SERVO_TABLE_H
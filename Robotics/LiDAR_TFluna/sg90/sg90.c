@@ -1,12 +1,199 @@
 #include "sg90.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 
-// PWM configuration variables
-uint slice_num;
-uint16_t pwm_wrap = 20000;
+// Driver owning the PWM wrap interrupt
+static sg90_t *wrap_owner;
+
+// The scanner's servo
+static sg90_t scanner;
+static int scanner_id = -1;
 
 int current_angle = 0;
 bool scanning_direction = true;
 
+// Continuous sweep, advanced from the PWM wrap interrupt
+static servo_sweep_t sweep;
+
+/**
+ * @brief Program a slice with the driver's timing, stopped
+ */
+static void configure_slice(const sg90_t *d, uint slice)
+{
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, (uint8_t)(d->timing.div16 >> 4), (uint8_t)(d->timing.div16 & 0x0F));
+    pwm_config_set_wrap(&config, d->timing.top);
+    pwm_init(slice, &config, false);
+}
+
+/**
+ * @brief Restart all the slices in use from zero with a single write, so they wrap together
+ */
+static void sync_slices(const sg90_t *d)
+{
+    for (uint slice = 0; slice < NUM_PWM_SLICES; slice++)
+    {
+        if (d->slice_mask & (1u << slice))
+        {
+            pwm_set_enabled(slice, false);
+            pwm_set_counter(slice, 0);
+        }
+    }
+    hw_set_bits(&pwm_hw->en, d->slice_mask);
+}
+
+bool sg90_init(sg90_t *d, uint32_t freq_hz)
+{
+    d->count = 0;
+    d->slice_mask = 0;
+    d->next_mask = 0;
+    d->pending_mask = 0;
+    d->on_wrap = NULL;
+    d->user = NULL;
+    return servo_timing_init(&d->timing, clock_get_hz(clk_sys), freq_hz);
+}
+
+int sg90_add(sg90_t *d, uint gpio, const servo_cal_t *cal)
+{
+    if (d->count >= SG90_MAX_SERVOS)
+    {
+        return -1;
+    }
+
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    uint chan = pwm_gpio_to_channel(gpio);
+    for (int i = 0; i < d->count; i++)
+    {
+        if (d->servos[i].slice == slice && d->servos[i].chan == chan)
+        {
+            return -1;
+        }
+    }
+
+    sg90_servo_t *s = &d->servos[d->count];
+    if (!servo_table_init(&s->table, &d->timing, cal))
+    {
+        return -1;
+    }
+    s->gpio = gpio;
+    s->slice = slice;
+    s->chan = chan;
+    s->cal = *cal;
+    s->cdeg = 0;
+
+    // A new slice gets the shared timing; its other channel stays low until used
+    if (!(d->slice_mask & (1u << slice)))
+    {
+        configure_slice(d, slice);
+        pwm_set_chan_level(slice, chan == PWM_CHAN_A ? PWM_CHAN_B : PWM_CHAN_A, 0);
+        d->slice_mask |= 1u << slice;
+    }
+    pwm_set_chan_level(slice, chan, servo_table_level(&s->table, 0));
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    sync_slices(d);
+
+    return d->count++;
+}
+
+void sg90_set(sg90_t *d, int id, int32_t cdeg)
+{
+    sg90_servo_t *s = &d->servos[id];
+    s->cdeg = cdeg;
+    pwm_set_chan_level(s->slice, s->chan, servo_table_level(&s->table, cdeg));
+}
+
+void sg90_stage(sg90_t *d, int id, int32_t cdeg)
+{
+    d->servos[id].cdeg = cdeg;
+    d->next[id] = servo_table_level(&d->servos[id].table, cdeg);
+    d->next_mask |= (uint16_t)(1u << id);
+}
+
+void sg90_commit(sg90_t *d)
+{
+    // The interrupt must not see half of a commit
+    uint32_t irq = save_and_disable_interrupts();
+    for (int i = 0; i < d->count; i++)
+    {
+        if (d->next_mask & (1u << i))
+        {
+            d->pending[i] = d->next[i];
+        }
+    }
+    d->pending_mask |= d->next_mask;
+    restore_interrupts(irq);
+    d->next_mask = 0;
+}
+
+/**
+ * @brief PWM wrap interrupt: write the committed levels, then run the driver's callback
+ *
+ * All the slices have just wrapped; levels written now are latched together at the next wrap.
+ */
+static void sg90_wrap_isr(void)
+{
+    sg90_t *d = wrap_owner;
+    pwm_clear_irq(d->servos[0].slice);
+
+    uint16_t mask = d->pending_mask;
+    for (int i = 0; mask; i++, mask >>= 1)
+    {
+        if (mask & 1u)
+        {
+            pwm_set_chan_level(d->servos[i].slice, d->servos[i].chan, d->pending[i]);
+        }
+    }
+    d->pending_mask = 0;
+
+    if (d->on_wrap)
+    {
+        d->on_wrap(d, d->user);
+    }
+}
+
+void sg90_start_wrap_irq(sg90_t *d, sg90_wrap_cb_t on_wrap, void *user)
+{
+    d->on_wrap = on_wrap;
+    d->user = user;
+    wrap_owner = d;
+
+    uint slice = d->servos[0].slice;
+    pwm_clear_irq(slice);
+    pwm_set_irq_enabled(slice, true);
+    irq_set_exclusive_handler(PWM_IRQ_WRAP, sg90_wrap_isr);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+}
+
+bool sg90_clock_changed(sg90_t *d)
+{
+    servo_timing_t timing;
+    if (!servo_timing_init(&timing, clock_get_hz(clk_sys), d->timing.freq_hz))
+    {
+        return false;
+    }
+
+    uint32_t irq = save_and_disable_interrupts();
+    d->timing = timing;
+    d->pending_mask = 0;
+    for (uint slice = 0; slice < NUM_PWM_SLICES; slice++)
+    {
+        if (d->slice_mask & (1u << slice))
+        {
+            configure_slice(d, slice);
+        }
+    }
+    for (int i = 0; i < d->count; i++)
+    {
+        sg90_servo_t *s = &d->servos[i];
+        servo_table_init(&s->table, &d->timing, &s->cal);
+        pwm_set_chan_level(s->slice, s->chan, servo_table_level(&s->table, s->cdeg));
+    }
+    sync_slices(d);
+    restore_interrupts(irq);
+    return true;
+}
+
 /**
  * @brief Set the servo to a specific angle
  *
@@ -20,20 +207,8 @@ static void set_servo_angle(int angle)
     if (angle > 180)
         angle = 180;
 
-    // Map angle (0-180) to pulse width (500-2400 µs)
-    uint16_t pulse_width = SERVO_MIN_PULSE + (angle * (SERVO_MAX_PULSE - SERVO_MIN_PULSE) / 180);
-
-    // Convert pulse width in µs to PWM cycles (at 1MHz clock)
-    uint16_t level = (pulse_width * pwm_wrap) / 20000;
-
-    // Ensure level is within valid range
-    if (level > pwm_wrap)
-        level = pwm_wrap;
-    if (level < 0)
-        level = 0;
-
-    // Set PWM level
-    pwm_set_gpio_level(SERVO_GPIO, level);
+    // Set PWM level for the angle; it takes effect at the next wrap
+    sg90_set(&scanner, scanner_id, angle * SERVO_SWEEP_CDEG);
 
     // Update current angle
     current_angle = angle;
@@ -73,25 +248,71 @@ void scan_servo(void)
  */
 void setup_servo(void)
 {
-    // Set GPIO function to PWM
-    gpio_set_function(SERVO_GPIO, GPIO_FUNC_PWM);
+    // Divider and wrap for 50Hz come from the actual clk_sys
+    sg90_init(&scanner, SERVO_FREQ);
 
-    // Get PWM slice number
-    slice_num = pwm_gpio_to_slice_num(SERVO_GPIO);
+    servo_cal_t cal = {
+        .min_us = SERVO_MIN_PULSE,
+        .max_us = SERVO_MAX_PULSE,
+        .range_deg = 180,
+        .trim_cdeg = 0,
+        .reversed = false,
+    };
+    scanner_id = sg90_add(&scanner, SERVO_GPIO, &cal);
 
-    // Calculate the wrap value for 50Hz frequency
-    // Clock frequency is 125MHz, with a divider of 125 gives 1MHz
-    // For 50Hz, we need a wrap value of 20000 (1000000/50)
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 125.0f); // 125MHz / 125 = 1MHz
-    pwm_config_set_wrap(&config, pwm_wrap - 1);
+    // Set initial position to 0 degrees
+    set_servo_angle(0);
+}
 
-    // Initialize PWM
-    pwm_init(slice_num, &config, true);
+/**
+ * @brief Wrap callback: command the sweep angle due at the next wrap
+ */
+static void sweep_on_wrap(sg90_t *d, void *user)
+{
+    (void)user;
 
-    // Enable PWM output on the GPIO
-    pwm_set_enabled(slice_num, true);
+    // A level written now is used from the next wrap, one PWM period from now
+    uint32_t now = time_us_32();
+    servo_sweep_advance(&sweep, now);
+    int32_t cdeg = servo_sweep_command_at(&sweep, now + 1000000u / SERVO_FREQ);
+    sg90_set(d, scanner_id, cdeg);
+    current_angle = cdeg / SERVO_SWEEP_CDEG;
+}
 
-    // Set initial position to 0 degrees
-    set_servo_angle(0);
-}
\ No newline at end of file
+/**
+ * @brief Start sweeping the servo continuously between 0 and 180 degrees
+ *
+ * @param sweep_ms Time of one pass between the limits in milliseconds
+ * @param lag_us Delay from command to servo position
+ */
+void start_servo_sweep(uint32_t sweep_ms, uint32_t lag_us)
+{
+    servo_sweep_init(&sweep, 0, 180, sweep_ms, lag_us, time_us_32());
+    sg90_start_wrap_irq(&scanner, sweep_on_wrap, NULL);
+}
+
+/**
+ * @brief Estimated servo angle at a time during the sweep
+ *
+ * @param t_us Time from time_us_32()
+ * @return int32_t Angle in hundredths of a degree
+ */
+int32_t get_sweep_angle(uint32_t t_us)
+{
+    // Copy the sweep with the wrap interrupt masked, so its origin is read consistently
+    uint32_t irq = save_and_disable_interrupts();
+    servo_sweep_t s = sweep;
+    restore_interrupts(irq);
+    return servo_sweep_angle_at(&s, t_us);
+}
+
+/**
+ * @brief Number of the sweep the servo is in at a time
+ */
+uint32_t get_sweep_index(uint32_t t_us)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    servo_sweep_t s = sweep;
+    restore_interrupts(irq);
+    return servo_sweep_index_at(&s, t_us);
+}
@@ -1,12 +1,16 @@
 #ifndef SG90_H
 #define SG90_H
 
+#ifndef HAL_HOST
 #include <hardware/gpio.h>
 #include "pico/stdlib.h"
 #include "hardware/pwm.h"
+#endif
+#include "servo_sweep.h"
+#include "servo_table.h"
 
 // Servo Configuration
-#define SERVO_GPIO 0         // GPIO pin for servo control
+#define SERVO_GPIO 0         // GPIO pin of the scanner's servo
 #define SERVO_MIN_PULSE 500  // Pulse width in µs for 0 degrees (1ms)
 #define SERVO_MAX_PULSE 2400 // Pulse width in µs for 180 degrees (2ms)
 #define SERVO_FREQ 50        // PWM frequency in Hz (standard for servos is 50Hz)
@@ -14,8 +18,116 @@
 // Variables for servo control
 #define ANGLE_STEP 10     // Step size for angle change in degrees
 #define SCAN_DELAY_MS 250 // Delay between angle changes in milliseconds
+#define SWEEP_TIME_MS 2000 // Time of one continuous pass from 0 to 180 degrees
+#define SWEEP_LAG_US 30000 // Servo lag behind its command (hold time plus response), calibrate per servo
 extern int current_angle;
 
+#ifndef HAL_HOST
+// Multi-servo driver
+#define SG90_MAX_SERVOS 16 // One per PWM channel: 8 slices, channels A and B
+
+typedef struct sg90 sg90_t;
+
+/**
+ * @brief Called from the PWM wrap interrupt, after the staged levels have been written
+ */
+typedef void (*sg90_wrap_cb_t)(sg90_t *d, void *user);
+
+typedef struct sg90_servo
+{
+    uint gpio;           // GPIO pin
+    uint slice;          // PWM slice of the pin
+    uint chan;           // PWM channel of the pin (PWM_CHAN_A or PWM_CHAN_B)
+    servo_cal_t cal;     // Calibration
+    servo_table_t table; // PWM level for each degree, rebuilt when the clock changes
+    int32_t cdeg;        // Last commanded angle in hundredths of a degree
+} sg90_servo_t;
+
+struct sg90
+{
+    servo_timing_t timing;                // Divider and wrap shared by all slices
+    sg90_servo_t servos[SG90_MAX_SERVOS]; // Servos added so far
+    uint8_t count;                        // Number of servos
+    uint32_t slice_mask;                  // Slices in use, started in phase
+    uint16_t next[SG90_MAX_SERVOS];       // Levels staged by sg90_stage()
+    uint16_t next_mask;                   // Servos staged since the last commit
+    uint16_t pending[SG90_MAX_SERVOS];    // Levels committed, written at the next wrap
+    volatile uint16_t pending_mask;       // Servos committed and not yet written
+    sg90_wrap_cb_t on_wrap;               // Wrap callback, NULL if none
+    void *user;                           // Argument for on_wrap
+};
+
+/**
+ * @brief Initialize a servo driver for a frame rate, timed from the current clk_sys
+ *
+ * @param d Pointer to the driver
+ * @param freq_hz Frame rate in Hz (SERVO_FREQ)
+ * @return true if the rate can be generated at the current clock
+ */
+bool sg90_init(sg90_t *d, uint32_t freq_hz);
+
+/**
+ * @brief Add a servo on a GPIO pin
+ *
+ * All the slices in use are restarted in phase, so their wraps coincide; the servos
+ * already running see one shortened frame.
+ *
+ * @param d Pointer to the driver
+ * @param gpio GPIO pin of the servo's signal
+ * @param cal Calibration (SERVO_CAL_SG90 for the datasheet values)
+ * @return int Servo id, or -1 if the driver is full, the pin's PWM channel is taken, or
+ *         the calibration is invalid
+ */
+int sg90_add(sg90_t *d, uint gpio, const servo_cal_t *cal);
+
+/**
+ * @brief Command a servo at once
+ *
+ * The level takes effect at the next wrap of the servo's slice; all slices wrap together,
+ * but a call that straddles a wrap can move servos one frame apart. Use
+ * sg90_stage() and sg90_commit() to move several servos in the same frame.
+ *
+ * @param d Pointer to the driver
+ * @param id Servo id from sg90_add()
+ * @param cdeg Angle in hundredths of a degree, clamped to the servo's travel
+ */
+void sg90_set(sg90_t *d, int id, int32_t cdeg);
+
+/**
+ * @brief Stage an angle for the next sg90_commit()
+ */
+void sg90_stage(sg90_t *d, int id, int32_t cdeg);
+
+/**
+ * @brief Hand the staged angles to the wrap interrupt, which writes them all at once
+ *
+ * They take effect together one frame later. Requires the wrap interrupt
+ * (sg90_start_wrap_irq()).
+ */
+void sg90_commit(sg90_t *d);
+
+/**
+ * @brief Enable the PWM wrap interrupt of the driver's first slice
+ *
+ * The interrupt writes committed angles and then calls on_wrap. Only one driver can own
+ * the PWM wrap interrupt.
+ *
+ * @param d Pointer to the driver, with at least one servo
+ * @param on_wrap Callback, or NULL
+ * @param user Argument for on_wrap
+ */
+void sg90_start_wrap_irq(sg90_t *d, sg90_wrap_cb_t on_wrap, void *user);
+
+/**
+ * @brief Recompute the timing and tables after clk_sys has changed, and restore the angles
+ *
+ * @return true if the frame rate can still be generated
+ */
+bool sg90_clock_changed(sg90_t *d);
+#endif // HAL_HOST
+
+// Scanner servo: sg90.c on the RP2040, sg90_hal.c on libs/hal for the host build
+
 /**
  * @brief Scan the servo back and forth
  */
@@ -26,4 +138,28 @@ void scan_servo(void);
  */
 void setup_servo(void);
 
-#endif // SG90_H
\ No newline at end of file
+/**
+ * @brief Start sweeping the servo continuously between 0 and 180 degrees
+ *
+ * The PWM wrap interrupt commands the trajectory from then on; scan_servo() must not be
+ * called while the sweep runs.
+ *
+ * @param sweep_ms Time of one pass between the limits in milliseconds
+ * @param lag_us Delay from command to servo position, used by get_sweep_angle()
+ */
+void start_servo_sweep(uint32_t sweep_ms, uint32_t lag_us);
+
+/**
+ * @brief Estimated servo angle at a time during the sweep
+ *
+ * @param t_us Time from time_us_32(), e.g. a LiDAR data-ready timestamp
+ * @return int32_t Angle in hundredths of a degree
+ */
+int32_t get_sweep_angle(uint32_t t_us);
+
+/**
+ * @brief Number of the sweep the servo is in at a time (even: 0 to 180, odd: back)
+ */
+uint32_t get_sweep_index(uint32_t t_us);
+
+#endif // SG90_H
@@ -0,0 +1,131 @@
+/**
+ * @file sg90_hal.c
+ * @brief The scanner servo functions of sg90.h on libs/hal, for the HAL_HOST build.
+ *
+ * @details
+ * The host has no PWM wrap interrupt, so a repeating HAL timer at SERVO_FREQ stands in for
+ * it and commands the sweep exactly as sweep_on_wrap() in sg90.c does. The PWM levels come
+ * from the same servo_timing/servo_table code, for a 125 MHz clk_sys: the simulator's cycle
+ * counter runs at 1 GHz, which no PWM divider reaches at 50 Hz, and the levels only matter
+ * as a record of what the board would output.
+ */
+
+#include "hal.h"
+#include "sg90.h"
+
+#define SERVO_SYS_HZ 125000000u // clk_sys the levels are computed for
+
+int current_angle = 0;
+bool scanning_direction = true;
+
+static servo_timing_t timing; // Divider and wrap of the scanner's slice
+static servo_table_t table;   // PWM level for each degree
+static hal_timer_t frame;     // Stands in for the PWM wrap interrupt
+static servo_sweep_t sweep;   // Continuous sweep, advanced once per frame
+
+/**
+ * @brief Set the servo to a specific angle
+ *
+ * @param cdeg Angle in hundredths of a degree, clamped to 0-180 degrees by the table
+ */
+static void set_servo_cdeg(int32_t cdeg)
+{
+    hal_pwm_set_level(SERVO_GPIO, servo_table_level(&table, cdeg));
+}
+
+/**
+ * @brief Scan the servo back and forth
+ */
+void scan_servo(void)
+{
+    // Change direction when reaching limits
+    if (scanning_direction)
+    {
+        current_angle += ANGLE_STEP;
+        if (current_angle >= 180)
+        {
+            current_angle = 180;
+            scanning_direction = false;
+        }
+    }
+    else
+    {
+        current_angle -= ANGLE_STEP;
+        if (current_angle <= 0)
+        {
+            current_angle = 0;
+            scanning_direction = true;
+        }
+    }
+
+    set_servo_cdeg(current_angle * SERVO_SWEEP_CDEG);
+}
+
+/**
+ * @brief Setup the servo motor PWM
+ */
+void setup_servo(void)
+{
+    servo_cal_t cal = {
+        .min_us = SERVO_MIN_PULSE,
+        .max_us = SERVO_MAX_PULSE,
+        .range_deg = 180,
+        .trim_cdeg = 0,
+        .reversed = false,
+    };
+    servo_timing_init(&timing, SERVO_SYS_HZ, SERVO_FREQ);
+    servo_table_init(&table, &timing, &cal);
+
+    // Set initial position to 0 degrees
+    hal_pwm_init(SERVO_GPIO, timing.top, servo_table_level(&table, 0));
+    current_angle = 0;
+}
+
+/**
+ * @brief Frame timer: command the sweep angle due at the next frame
+ */
+static bool sweep_on_frame(hal_timer_t *t)
+{
+    (void)t;
+
+    uint32_t now = hal_time_us_32();
+    servo_sweep_advance(&sweep, now);
+    int32_t cdeg = servo_sweep_command_at(&sweep, now + 1000000u / SERVO_FREQ);
+    set_servo_cdeg(cdeg);
+    current_angle = cdeg / SERVO_SWEEP_CDEG;
+    return true;
+}
+
+/**
+ * @brief Start sweeping the servo continuously between 0 and 180 degrees
+ *
+ * @param sweep_ms Time of one pass between the limits in milliseconds
+ * @param lag_us Delay from command to servo position
+ */
+void start_servo_sweep(uint32_t sweep_ms, uint32_t lag_us)
+{
+    servo_sweep_init(&sweep, 0, 180, sweep_ms, lag_us, hal_time_us_32());
+    hal_timer_start(&frame, 1000000u / SERVO_FREQ, sweep_on_frame, NULL);
+}
+
+/**
+ * @brief Estimated servo angle at a time during the sweep
+ *
+ * The timer runs between main-loop statements on the host, never inside one, so the sweep
+ * needs no copy.
+ *
+ * @param t_us Time from hal_time_us_32()
+ * @return int32_t Angle in hundredths of a degree
+ */
+int32_t get_sweep_angle(uint32_t t_us)
+{
+    return servo_sweep_angle_at(&sweep, t_us);
+}
+
+/**
+ * @brief Number of the sweep the servo is in at a time
+ */
+uint32_t get_sweep_index(uint32_t t_us)
+{
+    return servo_sweep_index_at(&sweep, t_us);
+}
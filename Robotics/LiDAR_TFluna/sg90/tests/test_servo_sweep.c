@@ -0,0 +1,188 @@
+/**
+ * @file test_servo_sweep.c
+ * @brief The sweep trajectory and sample-angle interpolation against a closed form.
+ *
+ * @details
+ * The reference is the triangle wave written directly on 64-bit time since init, with no
+ * origin and no wrap. The sweep is run as the firmware runs it, for 10 minutes of 20 ms PWM
+ * wraps that cross the 2^32 us wrap of the counter: each wrap advances the origin and
+ * commands the angle due at the next wrap, and LiDAR samples are stamped at random times
+ * around it, including times older than the current origin. Command, angle and sweep
+ * number must equal the closed form at every one of them, and the angles stay within one
+ * unit (0.01 degree) of the ideal real-valued curve.
+ *
+ * The limits, the turnarounds, the lag, the interpolation between two commands, times before
+ * the start and a sweep time of 0 are checked on their own.
+ */
+
+#include <stdbool.h>
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "servo_sweep.h"
+
+#define WRAP_US 20000u ///< PWM frame of a 50 Hz servo.
+
+/**
+ * @brief Commanded angle at t_us (64-bit, from init), written as a triangle wave.
+ */
+static int32_t reference_command(const servo_sweep_t *s, int64_t t_us, int32_t min_cdeg, uint32_t *index)
+{
+    int64_t span = (int64_t)s->max_cdeg - min_cdeg;
+    int64_t sweep = s->sweep_us;
+    if (t_us < 0)
+    {
+        *index = 0;
+        return min_cdeg;
+    }
+    int64_t n = t_us / sweep;
+    int64_t p = t_us % sweep;
+    *index = (uint32_t)n;
+    return (n % 2 == 0) ? (int32_t)(min_cdeg + span * p / sweep) : (int32_t)(s->max_cdeg - span * p / sweep);
+}
+
+static double ideal_command(const servo_sweep_t *s, int64_t t_us)
+{
+    if (t_us < 0)
+    {
+        return s->min_cdeg;
+    }
+    double span = (double)s->max_cdeg - s->min_cdeg;
+    double x = (double)(t_us % (2 * (int64_t)s->sweep_us)) / s->sweep_us;
+    return (x < 1.0) ? s->min_cdeg + span * x : s->max_cdeg - span * (x - 1.0);
+}
+
+static void test_shape(void)
+{
+    servo_sweep_t s;
+    servo_sweep_init(&s, 0, 180, 2000u, 0u, 1000u);
+    CHECK_EQ(s.sweep_us, 2000000u);
+    CHECK_EQ(s.min_cdeg, 0);
+    CHECK_EQ(s.max_cdeg, 18000);
+
+    // Limits and turnarounds
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u), 0);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 1000000u), 9000);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 2000000u), 18000);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 2000000u - 1u), 17999);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 3000000u), 9000);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 4000000u), 0);
+    CHECK_EQ(servo_sweep_index_at(&s, 1000u), 0);
+    CHECK_EQ(servo_sweep_index_at(&s, 1000u + 1999999u), 0);
+    CHECK_EQ(servo_sweep_index_at(&s, 1000u + 2000000u), 1);
+    CHECK_EQ(servo_sweep_index_at(&s, 1000u + 4000000u), 2);
+
+    // Before the start the servo waits at the lower limit, in sweep 0
+    CHECK_EQ(servo_sweep_command_at(&s, 999u), 0);
+    CHECK_EQ(servo_sweep_command_at(&s, 0u - 5000000u), 0);
+    CHECK_EQ(servo_sweep_index_at(&s, 0u), 0);
+
+    // Advancing to a time before the origin, e.g. one read before the origin moved, is a no-op
+    servo_sweep_advance(&s, 999u);
+    CHECK_EQ(s.start_us, 1000u);
+    servo_sweep_advance(&s, 1000u + 4000000u);
+    CHECK_EQ(s.start_us, 1000u + 4000000u);
+    CHECK_EQ(s.periods, 1);
+    servo_sweep_advance(&s, 1000u + 3999999u);
+    CHECK_EQ(s.start_us, 1000u + 4000000u);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u + 3000000u), 9000);
+    CHECK_EQ(servo_sweep_index_at(&s, 1000u + 3000000u), 1);
+
+    // The measured angle trails the command by the lag, and so does the sweep number
+    servo_sweep_init(&s, 0, 180, 2000u, 30000u, 0u);
+    for (uint32_t t = 0; t < 10000000u; t += 7919u)
+    {
+        CHECK_EQ(servo_sweep_angle_at(&s, t), servo_sweep_command_at(&s, t - 30000u));
+    }
+    CHECK_EQ(servo_sweep_angle_at(&s, 30000u), 0);
+    CHECK_EQ(servo_sweep_angle_at(&s, 2030000u), 18000);
+    CHECK_EQ(servo_sweep_index_at(&s, 2029999u), 0);
+    CHECK_EQ(servo_sweep_index_at(&s, 2030000u), 1);
+
+    // A sample between two wraps lies on the segment between the two commands
+    for (uint32_t wrap = 0; wrap < 4000000u; wrap += WRAP_US)
+    {
+        int32_t a = servo_sweep_command_at(&s, wrap);
+        int32_t b = servo_sweep_command_at(&s, wrap + WRAP_US);
+        uint32_t dt = (uint32_t)rand() % WRAP_US;
+        int32_t x = servo_sweep_command_at(&s, wrap + dt);
+        if (servo_sweep_index_at(&s, wrap + s.lag_us) == servo_sweep_index_at(&s, wrap + WRAP_US - 1u + s.lag_us))
+        {
+            double lerp = a + (double)(b - a) * dt / WRAP_US;
+            CHECK_RANGE(x, lerp - 1.0, lerp + 1.0);
+        }
+        CHECK(abs(b - a) <= 180); // 180 degrees in 2 s is 1.8 degrees per frame
+    }
+
+    // Other limits, and a sweep time of 0 taken as 1 ms
+    servo_sweep_init(&s, -45, 45, 0u, 0u, 0u);
+    CHECK_EQ(s.sweep_us, 1000u);
+    CHECK_EQ(servo_sweep_command_at(&s, 0u), -4500);
+    CHECK_EQ(servo_sweep_command_at(&s, 500u), 0);
+    CHECK_EQ(servo_sweep_command_at(&s, 1000u), 4500);
+    CHECK_EQ(servo_sweep_command_at(&s, 1500u), 0);
+}
+
+/**
+ * @brief 10 minutes of wraps across the 2^32 us wrap, as the firmware runs the sweep.
+ */
+static void test_long_run(int32_t min_deg, int32_t max_deg, uint32_t sweep_ms, uint32_t lag_us)
+{
+    const uint32_t start = 0xFFFFFFFFu - 300000000u; // Wraps 5 minutes in
+    servo_sweep_t s;
+    servo_sweep_init(&s, min_deg, max_deg, sweep_ms, lag_us, start);
+    int32_t min_cdeg = s.min_cdeg;
+
+    size_t bad = 0;
+    size_t far = 0;
+    int32_t prev_cmd = min_cdeg;
+    uint32_t last_index = 0;
+    for (int64_t t = 0; t < 600000000; t += WRAP_US)
+    {
+        uint32_t now = start + (uint32_t)t;
+        servo_sweep_advance(&s, now);
+        bad += (int32_t)(now - s.start_us) < 0 || now - s.start_us >= 2u * s.sweep_us;
+
+        // The command written at this wrap takes effect at the next one
+        uint32_t index;
+        int32_t cmd = servo_sweep_command_at(&s, now + WRAP_US);
+        bad += cmd != reference_command(&s, t + WRAP_US, min_cdeg, &index);
+        far += abs(cmd - prev_cmd) > (int32_t)((int64_t)(s.max_cdeg - min_cdeg) * WRAP_US / s.sweep_us + 1);
+        prev_cmd = cmd;
+
+        // Samples from the last two frames, some older than the origin
+        for (int k = 0; k < 4; k++)
+        {
+            int64_t ts = t - (int64_t)(rand() % (2 * WRAP_US));
+            uint32_t stamp = start + (uint32_t)ts;
+            int32_t angle = servo_sweep_angle_at(&s, stamp);
+            int32_t ref = reference_command(&s, ts - lag_us, min_cdeg, &index);
+            double ideal = ideal_command(&s, ts - lag_us);
+            bad += angle != ref;
+            bad += fabs(angle - ideal) >= 1.0; // Truncated towards the lower limit
+            bad += servo_sweep_index_at(&s, stamp) != index;
+        }
+
+        // The sweep number at the wrap itself
+        reference_command(&s, t - (int64_t)lag_us, min_cdeg, &index);
+        last_index = servo_sweep_index_at(&s, now);
+        bad += last_index != index;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(far, 0);
+    CHECK_EQ(s.periods, (600000000u - WRAP_US) / (2u * s.sweep_us));
+    CHECK(last_index >= 2u * s.periods);
+}
+
+int main(void)
+{
+    srand(16);
+
+    test_shape();
+    test_long_run(0, 180, 2000u, 0u);
+    test_long_run(0, 180, 2000u, 35000u);
+    test_long_run(10, 170, 1300u, 12345u);
+    test_long_run(-90, 90, 7u, 0u);
+
+    return host_test_result("servo_sweep");
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_servo_table.c
+ * @brief PWM timing from the system clock and the per-servo angle tables, on the host.
+ *
+ * @details
+ * servo_timing_init() is run for the clocks the RP2040 is commonly set to, from 12 to
+ * 250 MHz: the divider must be the smallest that fits the frame in the 16-bit counter and
+ * the period must be the nearest one to the frame rate. Rates that cannot be reached must
+ * be refused.
+ *
+ * servo_table_init() is then run for four calibrations at each clock, and
+ * servo_table_level() is compared with the exact pulse width, in counts, at every
+ * hundredth of a degree from below 0 to past the travel. The multiply-and-shift divide by
+ * 100 and the interpolation are checked exactly on a linear table, and trims and
+ * reversed servos must never drive the pulse past the calibrated ends.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "servo_table.h"
+
+static const uint32_t clocks[] = {12000000u, 48000000u, 125000000u, 133000000u, 200000000u, 250000000u};
+#define N_CLOCKS (sizeof(clocks) / sizeof(clocks[0]))
+
+static void test_timing(void)
+{
+    static const uint32_t rates[] = {50u, 60u, 100u, 330u};
+    servo_timing_t t;
+
+    for (size_t c = 0; c < N_CLOCKS; c++)
+    {
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+        {
+            uint32_t sys = clocks[c], f = rates[r];
+            CHECK(servo_timing_init(&t, sys, f));
+            CHECK_EQ(t.sys_hz, sys);
+            CHECK_EQ(t.freq_hz, f);
+
+            // The smallest divider: one less would need more than 65536 counts
+            double cycles = (double)sys / f;
+            CHECK(t.div16 >= SERVO_DIV_MIN && t.div16 <= SERVO_DIV_MAX);
+            CHECK(t.div16 == SERVO_DIV_MIN || cycles * 16.0 / (t.div16 - 1u) > 65536.0);
+
+            // The period is within half a count of the frame
+            double count_ns = t.div16 / 16.0 * 1e9 / sys;
+            double period_ns = (t.top + 1.0) * count_ns;
+            CHECK(fabs(period_ns - 1e9 / f) <= count_ns / 2.0 + 1e-6);
+            CHECK(fabs(servo_timing_period_ns(&t) - period_ns) <= 1.0);
+
+            // Levels are rounded to the nearest count and stop at top + 1
+            for (uint32_t ns = 0; ns <= 3000000u; ns += 997u)
+            {
+                double exact = ns / count_ns;
+                uint16_t level = servo_timing_level(&t, ns);
+                CHECK(fabs(level - exact) <= 0.5 + 1e-9);
+            }
+            CHECK_EQ(servo_timing_level(&t, 1000000000u / f + 5000u), t.top + 1u);
+        }
+    }
+
+    // 125 MHz, 50 Hz: a divider of 38.1875 and about 0.31 us per count
+    CHECK(servo_timing_init(&t, 125000000u, 50u));
+    CHECK_EQ(t.div16, 611);
+    CHECK_EQ(t.top, 65465);
+    CHECK_EQ(servo_timing_period_ns(&t), 19999863u); // 137 ns short of 20 ms
+
+    // Out of reach: no clock or rate, too slow for the largest divider, too fast for 2 counts
+    CHECK(!servo_timing_init(&t, 0u, 50u));
+    CHECK(!servo_timing_init(&t, 125000000u, 0u));
+    CHECK(!servo_timing_init(&t, 250000000u, 14u));
+    CHECK(servo_timing_init(&t, 250000000u, 15u));
+    CHECK_EQ(t.div16, 4070);
+    CHECK(servo_timing_init(&t, 12000000u, 6000000u));
+    CHECK_EQ(t.top, 1);
+    CHECK(!servo_timing_init(&t, 12000000u, 10000000u));
+}
+
+/**
+ * @brief Exact level for a command, as a fraction of a count.
+ */
+static double exact_level(const servo_timing_t *t, const servo_cal_t *cal, int32_t cdeg)
+{
+    double max = cal->range_deg * 100.0;
+    double a = cdeg < 0 ? 0.0 : (cdeg > max ? max : cdeg);
+    a += cal->trim_cdeg;
+    a = a < 0.0 ? 0.0 : (a > max ? max : a);
+    if (cal->reversed)
+    {
+        a = max - a;
+    }
+    double pulse_ns = (cal->min_us + (cal->max_us - cal->min_us) * a / max) * 1000.0;
+    return pulse_ns * t->sys_hz * 16.0 / t->div16 / 1e9;
+}
+
+static void test_tables(void)
+{
+    // Trims in whole degrees keep the clamp on a table entry; see test_trim() for the others
+    static const servo_cal_t cals[] = {
+        SERVO_CAL_SG90,
+        {.min_us = 544, .max_us = 2400, .range_deg = 180, .trim_cdeg = -300, .reversed = true},
+        {.min_us = 1000, .max_us = 2000, .range_deg = 90, .trim_cdeg = 200, .reversed = false},
+        {.min_us = 600, .max_us = 2300, .range_deg = 120, .trim_cdeg = 0, .reversed = true},
+    };
+
+    for (size_t c = 0; c < N_CLOCKS; c++)
+    {
+        servo_timing_t t;
+        CHECK(servo_timing_init(&t, clocks[c], 50u));
+        double worst = 0.0;
+        for (size_t k = 0; k < sizeof(cals) / sizeof(cals[0]); k++)
+        {
+            servo_table_t tab;
+            CHECK(servo_table_init(&tab, &t, &cals[k]));
+            CHECK_EQ(tab.max_cdeg, cals[k].range_deg * 100u);
+            for (int32_t cdeg = -1000; cdeg <= tab.max_cdeg + 1000; cdeg++)
+            {
+                double e = fabs(servo_table_level(&tab, cdeg) - exact_level(&t, &cals[k], cdeg));
+                worst = e > worst ? e : worst;
+            }
+        }
+        CHECK(worst < 0.97);
+    }
+}
+
+static void test_interpolation(void)
+{
+    // A linear table: the level must be exactly 3 per hundredth of a degree, so any error in
+    // the index or the fraction shows. Descending as well, for reversed servos.
+    servo_table_t up, down;
+    up.max_cdeg = 18000;
+    down.max_cdeg = 18000;
+    for (uint32_t i = 0; i < SERVO_TABLE_LEN; i++)
+    {
+        up.level[i] = (uint16_t)(300u * i);
+        down.level[i] = (uint16_t)(60000u - 300u * i);
+    }
+    size_t bad = 0;
+    for (int32_t cdeg = 0; cdeg <= 18000; cdeg++)
+    {
+        bad += servo_table_level(&up, cdeg) != 3 * cdeg;
+        bad += servo_table_level(&down, cdeg) != 60000 - 3 * cdeg;
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(servo_table_level(&up, -5), 0);
+    CHECK_EQ(servo_table_level(&up, 18001), 54000);
+    CHECK_EQ(servo_table_level(&up, 1000000), 54000);
+
+    // The same on a shorter travel, on the largest steps a 16-bit table can hold
+    servo_table_t steep;
+    steep.max_cdeg = 9000;
+    for (uint32_t i = 0; i <= 90u; i++)
+    {
+        steep.level[i] = (uint16_t)(i & 1u ? 65535u : 0u);
+    }
+    bad = 0;
+    for (int32_t cdeg = 0; cdeg <= 9000; cdeg++)
+    {
+        int32_t i = cdeg / 100, frac = cdeg % 100;
+        double exact = steep.level[i] + (frac ? (steep.level[i + 1] - steep.level[i]) * frac / 100.0 : 0.0);
+        bad += fabs(servo_table_level(&steep, cdeg) - exact) > 0.5 + 65535.0 * 0.001;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static void test_trim(void)
+{
+    servo_timing_t t;
+    CHECK(servo_timing_init(&t, 125000000u, 50u));
+    uint16_t lo = servo_timing_level(&t, 500000u), hi = servo_timing_level(&t, 2400000u);
+
+    // Trims that clamp between two entries, either way and in both directions: the level
+    // stays between the ends and follows the angle monotonically
+    static const int16_t trims[] = {-18000, -1250, -150, -1, 1, 150, 1250, 18000};
+    for (size_t k = 0; k < sizeof(trims) / sizeof(trims[0]); k++)
+    {
+        for (int rev = 0; rev < 2; rev++)
+        {
+            servo_cal_t cal = SERVO_CAL_SG90;
+            cal.trim_cdeg = trims[k];
+            cal.reversed = rev;
+            servo_table_t tab;
+            CHECK(servo_table_init(&tab, &t, &cal));
+            size_t bad = 0;
+            uint16_t prev = servo_table_level(&tab, 0);
+            for (int32_t cdeg = 0; cdeg <= 18000; cdeg++)
+            {
+                uint16_t level = servo_table_level(&tab, cdeg);
+                bad += level < lo || level > hi;
+                bad += rev ? level > prev : level < prev;
+                prev = level;
+            }
+            CHECK_EQ(bad, 0);
+        }
+    }
+
+    // A trim of a whole travel pins the servo to one end
+    servo_cal_t cal = SERVO_CAL_SG90;
+    servo_table_t tab;
+    cal.trim_cdeg = 18000;
+    CHECK(servo_table_init(&tab, &t, &cal));
+    CHECK_EQ(servo_table_level(&tab, 0), hi);
+    cal.reversed = true;
+    CHECK(servo_table_init(&tab, &t, &cal));
+    CHECK_EQ(servo_table_level(&tab, 9000), lo);
+
+    // Calibrations out of range
+    cal = (servo_cal_t)SERVO_CAL_SG90;
+    cal.range_deg = 0;
+    CHECK(!servo_table_init(&tab, &t, &cal));
+    cal.range_deg = 181;
+    CHECK(!servo_table_init(&tab, &t, &cal));
+    cal.range_deg = 180;
+    cal.max_us = cal.min_us;
+    CHECK(!servo_table_init(&tab, &t, &cal));
+}
+
+int main(void)
+{
+    srand(19);
+
+    test_timing();
+    test_tables();
+    test_interpolation();
+    test_trim();
+
+    return host_test_result("servo_table");
+}
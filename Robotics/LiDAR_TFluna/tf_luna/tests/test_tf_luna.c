@@ -0,0 +1,278 @@
+/**
+ * @file test_tf_luna.c
+ * @brief Block decoding and the asynchronous reader on TF-Luna register dumps.
+ *
+ * @details
+ * Each dump is the sensor's register file from 0x00 to 0x2F, laid out as in the register
+ * table of the user manual: measurement block, error code, firmware version, serial number,
+ * then the configuration (I2C address 0x10, continuous mode, 100 Hz, amplitude threshold
+ * 100). The measurements cover a good return, a weak one, a saturated one, a negative chip
+ * temperature and the amplitude threshold from both sides.
+ *
+ * tf_luna_decode() must read every field of the block, and the reader, on the register-file
+ * stub, must return the same sample stamped with its data-ready time, reading the block and
+ * nothing else. Missed edges, NACKs, a wrong address, a refused start and hung transfers
+ * (also across the 2^32 wrap of the microsecond counter) must each be aborted and counted.
+ * Finally 200 frames with random values and injected faults are read as the firmware does:
+ * every completed sample must match the frame the stub held, and every fault be counted.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "tf_luna_regs.h"
+#include "tf_luna_async.h"
+#include "tf_luna_stub.h"
+
+#define N_DUMPS 5u
+
+// Error code, version 3.2.3, serial number
+#define DUMP_ID 0x00, 0x00, 0x03, 0x02, 0x03, 0x00, 0x00, 0x00, \
+                'T', 'F', 'L', 'U', 'N', 'A', '2', '2', '0', '4', '1', '3', '7', '5', 0x00, 0x00
+// Save, reboot, I2C address, mode, trigger, enable, 100 Hz, low power, restore,
+// amplitude threshold 100, dummy distance, minimum distance
+#define DUMP_CONFIG 0x00, 0x00, 0x10, 0x00, 0x00, 0x01, 0x64, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00
+
+static const uint8_t dumps[N_DUMPS][TF_LUNA_STUB_REGS] = {
+    // Wall at 1.23 m, strong return, 41.50 °C
+    {0x7B, 0x00, 0x98, 0x05, 0x36, 0x10, 0xB2, 0xA1, DUMP_ID, DUMP_CONFIG},
+    // Dark target at 8.12 m, amplitude 57
+    {0x2C, 0x03, 0x39, 0x00, 0x23, 0x0F, 0x10, 0x00, DUMP_ID, DUMP_CONFIG},
+    // Retro-reflector at 2 cm, saturated receiver
+    {0x02, 0x00, 0xFF, 0xFF, 0x96, 0x0F, 0xFF, 0xFF, DUMP_ID, DUMP_CONFIG},
+    // Outdoors at -10.25 °C, amplitude exactly 100
+    {0x4D, 0x03, 0x64, 0x00, 0xFF, 0xFB, 0x00, 0x00, DUMP_ID, DUMP_CONFIG},
+    // Amplitude 99, just below the threshold
+    {0x84, 0x03, 0x63, 0x00, 0xC4, 0x09, 0x34, 0x12, DUMP_ID, DUMP_CONFIG},
+};
+
+static const tf_luna_sample_t expected[N_DUMPS] = {
+    {.distance = 123, .amplitude = 1432, .temp_centi = 4150, .tick_ms = 0xA1B2, .valid = true},
+    {.distance = 812, .amplitude = 57, .temp_centi = 3875, .tick_ms = 0x0010, .valid = false},
+    {.distance = 2, .amplitude = 0xFFFF, .temp_centi = 3990, .tick_ms = 0xFFFF, .valid = false},
+    {.distance = 845, .amplitude = 100, .temp_centi = -1025, .tick_ms = 0x0000, .valid = true},
+    {.distance = 900, .amplitude = 99, .temp_centi = 2500, .tick_ms = 0x1234, .valid = false},
+};
+
+static void check_sample(const tf_luna_sample_t *s, const tf_luna_sample_t *e)
+{
+    CHECK_EQ(s->distance, e->distance);
+    CHECK_EQ(s->amplitude, e->amplitude);
+    CHECK_EQ(s->temp_centi, e->temp_centi);
+    CHECK_EQ(s->tick_ms, e->tick_ms);
+    CHECK_EQ(s->valid, e->valid);
+}
+
+static void test_decode(void)
+{
+    for (size_t i = 0; i < N_DUMPS; i++)
+    {
+        tf_luna_sample_t s;
+        s.ready_us = 12345u;
+        tf_luna_decode(dumps[i], &s);
+        check_sample(&s, &expected[i]);
+        CHECK_EQ(s.ready_us, 12345u); // Left to the reader
+
+        // The dumps agree with the configuration the driver expects
+        CHECK_EQ(dumps[i][0x22], TF_LUNA_ADDR);
+        CHECK_EQ(dumps[i][0x2A] | (dumps[i][0x2B] << 8), TF_LUNA_AMP_MIN);
+    }
+
+    CHECK(!tf_luna_amp_ok(0));
+    CHECK(!tf_luna_amp_ok(TF_LUNA_AMP_MIN - 1u));
+    CHECK(tf_luna_amp_ok(TF_LUNA_AMP_MIN));
+    CHECK(tf_luna_amp_ok(TF_LUNA_AMP_SATURATED - 1u));
+    CHECK(!tf_luna_amp_ok(TF_LUNA_AMP_SATURATED));
+}
+
+static unsigned done_calls;
+static tf_luna_sample_t done_sample;
+
+static void on_done(const tf_luna_sample_t *s, void *user)
+{
+    CHECK(user == &done_calls);
+    done_calls++;
+    done_sample = *s;
+}
+
+/**
+ * @brief Services the reader once per 10 us until the read ends.
+ *
+ * @return true if it ended with a sample.
+ */
+static bool finish(tf_luna_async_t *t, uint32_t *now_us)
+{
+    for (int i = 0; i < 1000 && tf_luna_async_busy(t); i++)
+    {
+        *now_us += 10u;
+        if (tf_luna_async_service(t, *now_us))
+        {
+            CHECK(!tf_luna_async_busy(t));
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_reader(void)
+{
+    tf_luna_stub_t stub;
+    tf_luna_bus_t bus;
+    tf_luna_async_t t;
+    tf_luna_sample_t s;
+    uint32_t now = 1000u;
+
+    // Every dump comes back through the reader, stamped with its edge
+    tf_luna_stub_init(&stub, TF_LUNA_ADDR, 3, &bus);
+    tf_luna_async_init(&t, &bus, TF_LUNA_ADDR, on_done, &done_calls);
+    for (size_t i = 0; i < N_DUMPS; i++)
+    {
+        tf_luna_stub_load(&stub, dumps[i], sizeof(dumps[i]));
+        uint32_t edge = now;
+        CHECK(tf_luna_async_start(&t, edge));
+        CHECK(tf_luna_async_busy(&t));
+        CHECK_EQ(stub.reg, TF_LUNA_DIST_LOW_ADDR);
+        CHECK_EQ(stub.len, TF_LUNA_BLOCK_LEN);
+        CHECK(finish(&t, &now));
+        CHECK_EQ(done_calls, i + 1u);
+        check_sample(&done_sample, &expected[i]);
+        CHECK_EQ(done_sample.ready_us, edge);
+        CHECK(tf_luna_async_take(&t, &s));
+        check_sample(&s, &expected[i]);
+        CHECK(!tf_luna_async_take(&t, &s));
+        CHECK(memcmp(t.block, dumps[i], TF_LUNA_BLOCK_LEN) == 0);
+        now += 10000u;
+    }
+    CHECK_EQ(t.stats.reads, N_DUMPS);
+    CHECK_EQ(t.stats.weak, 3);
+    CHECK_EQ(t.stats.missed + t.stats.errors + t.stats.timeouts, 0);
+    CHECK_EQ(stub.reads, N_DUMPS);
+    CHECK_EQ(stub.aborts, 0);
+
+    // An edge during a read is dropped, not queued
+    tf_luna_async_init(&t, &bus, TF_LUNA_ADDR, NULL, NULL);
+    CHECK(tf_luna_async_start(&t, now));
+    CHECK(!tf_luna_async_start(&t, now + 5u));
+    CHECK_EQ(t.stats.missed, 1);
+    CHECK(finish(&t, &now));
+    CHECK(tf_luna_async_take(&t, &s));
+    CHECK_EQ(s.ready_us, now - 40u);
+
+    // A NACK ends the read with an error and frees the bus
+    stub.nack_every = 1;
+    CHECK(tf_luna_async_start(&t, now));
+    CHECK(!finish(&t, &now));
+    CHECK(!tf_luna_async_busy(&t));
+    CHECK_EQ(t.stats.errors, 1);
+    CHECK_EQ(stub.aborts, 1);
+    CHECK(!stub.active);
+    stub.nack_every = 0;
+
+    // So does a sensor on another address
+    tf_luna_async_init(&t, &bus, TF_LUNA_ADDR + 1u, NULL, NULL);
+    CHECK(tf_luna_async_start(&t, now));
+    CHECK(!finish(&t, &now));
+    CHECK_EQ(t.stats.errors, 1);
+    CHECK(!tf_luna_async_take(&t, &s));
+
+    // A backend that refuses the start counts an error and stays idle
+    tf_luna_async_init(&t, &bus, TF_LUNA_ADDR, NULL, NULL);
+    uint8_t scratch[TF_LUNA_BLOCK_LEN];
+    CHECK(bus.start(bus.ctx, TF_LUNA_ADDR, 0, scratch, sizeof(scratch)));
+    CHECK(!tf_luna_async_start(&t, now));
+    CHECK_EQ(t.stats.errors, 1);
+    CHECK(!tf_luna_async_busy(&t));
+    bus.abort(bus.ctx);
+
+    // A hung read is aborted timeout_us after its edge, also across the counter wrap
+    static const uint32_t edges[] = {5000u, 0xFFFFFFFFu - TF_LUNA_TIMEOUT_US / 2u};
+    stub.hang_every = 1;
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    {
+        tf_luna_async_init(&t, &bus, TF_LUNA_ADDR, NULL, NULL);
+        CHECK(tf_luna_async_start(&t, edges[i]));
+        CHECK(!tf_luna_async_service(&t, edges[i] + TF_LUNA_TIMEOUT_US - 1u));
+        CHECK(tf_luna_async_busy(&t));
+        CHECK_EQ(t.stats.timeouts, 0);
+        CHECK(!tf_luna_async_service(&t, edges[i] + TF_LUNA_TIMEOUT_US));
+        CHECK(!tf_luna_async_busy(&t));
+        CHECK_EQ(t.stats.timeouts, 1);
+        CHECK(!stub.active);
+    }
+    stub.hang_every = 0;
+
+    // Nothing happens while idle
+    CHECK(!tf_luna_async_service(&t, now));
+    CHECK_EQ(t.stats.reads + t.stats.errors, 0);
+}
+
+/**
+ * @brief 200 frames at 100 Hz with random values, latencies and faults.
+ */
+static void test_stream(void)
+{
+    tf_luna_stub_t stub;
+    tf_luna_bus_t bus;
+    tf_luna_async_t t;
+    tf_luna_stub_init(&stub, TF_LUNA_ADDR, 0, &bus);
+    tf_luna_async_init(&t, &bus, TF_LUNA_ADDR, NULL, NULL);
+    stub.nack_every = 7;
+    stub.hang_every = 11;
+
+    uint32_t now = 0xFFF00000u; // Wraps during the run
+    uint32_t started = 0;
+    uint32_t completed = 0;
+    size_t bad = 0;
+    for (int frame = 0; frame < 200; frame++)
+    {
+        tf_luna_sample_t e = {
+            .distance = (uint16_t)(rand() % 1200),
+            .amplitude = (uint16_t)(rand() % 4 == 0 ? rand() % 120 : rand()),
+            .temp_centi = (int16_t)(rand() % 8000 - 2000),
+            .tick_ms = (uint16_t)(frame * 10),
+        };
+        e.valid = tf_luna_amp_ok(e.amplitude);
+        tf_luna_stub_set(&stub, e.distance, e.amplitude, e.temp_centi, e.tick_ms);
+        stub.latency_polls = (uint32_t)rand() % 15u; // Within the 2 ms timeout at 100 us per poll
+
+        uint32_t edge = now;
+        started += tf_luna_async_start(&t, edge);
+
+        // The main loop services the reader every 100 us until the next frame
+        for (int k = 0; k < 100; k++)
+        {
+            now += 100u;
+            if (tf_luna_async_service(&t, now))
+            {
+                tf_luna_sample_t s;
+                CHECK(tf_luna_async_take(&t, &s));
+                bad += s.distance != e.distance || s.amplitude != e.amplitude || s.temp_centi != e.temp_centi ||
+                       s.tick_ms != e.tick_ms || s.valid != e.valid || s.ready_us != edge;
+                completed++;
+            }
+        }
+        CHECK(!tf_luna_async_busy(&t));
+    }
+
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(started, 200);
+    CHECK_EQ(t.stats.missed, 0);
+    CHECK_EQ(t.stats.reads, completed);
+    CHECK_EQ(completed + t.stats.errors + t.stats.timeouts, started);
+    CHECK_EQ(stub.aborts, t.stats.errors + t.stats.timeouts);
+    // Read n fails if n is a multiple of 7, or hangs if it is a multiple of 11 only
+    CHECK_EQ(t.stats.errors, 200 / 7);
+    CHECK_EQ(t.stats.timeouts, 200 / 11 - 200 / 77);
+}
+
+int main(void)
+{
+    srand(15);
+
+    test_decode();
+    test_reader();
+    test_stream();
+
+    return host_test_result("tf_luna");
+}
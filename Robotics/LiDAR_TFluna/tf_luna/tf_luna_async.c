@@ -0,0 +1,94 @@
+/**
+ * @file tf_luna_async.c
+ * @brief Non-blocking TF-Luna reader: one burst read per data-ready edge.
+ */
+
+#include "tf_luna_async.h"
+
+void tf_luna_async_init(tf_luna_async_t *t, const tf_luna_bus_t *bus, uint8_t addr, tf_luna_done_t done,
+                        void *user)
+{
+    t->bus = bus;
+    t->addr = addr;
+    atomic_init(&t->busy, false);
+    t->started_us = 0;
+    t->timeout_us = TF_LUNA_TIMEOUT_US;
+    t->fresh = false;
+    t->done = done;
+    t->user = user;
+    t->stats = (tf_luna_stats_t){0};
+}
+
+bool tf_luna_async_start(tf_luna_async_t *t, uint32_t now_us)
+{
+    if (atomic_load_explicit(&t->busy, memory_order_acquire))
+    {
+        t->stats.missed++;
+        return false;
+    }
+    if (!t->bus->start(t->bus->ctx, t->addr, TF_LUNA_DIST_LOW_ADDR, t->block, TF_LUNA_BLOCK_LEN))
+    {
+        t->stats.errors++;
+        return false;
+    }
+    t->started_us = now_us;
+    atomic_store_explicit(&t->busy, true, memory_order_release);
+    return true;
+}
+
+bool tf_luna_async_service(tf_luna_async_t *t, uint32_t now_us)
+{
+    if (!atomic_load_explicit(&t->busy, memory_order_acquire))
+    {
+        return false;
+    }
+
+    int state = t->bus->poll(t->bus->ctx);
+    if (state == TF_LUNA_BUS_BUSY)
+    {
+        if (now_us - t->started_us >= t->timeout_us)
+        {
+            t->bus->abort(t->bus->ctx);
+            t->stats.timeouts++;
+            atomic_store_explicit(&t->busy, false, memory_order_release);
+        }
+        return false;
+    }
+    if (state != TF_LUNA_BUS_DONE)
+    {
+        t->bus->abort(t->bus->ctx);
+        t->stats.errors++;
+        atomic_store_explicit(&t->busy, false, memory_order_release);
+        return false;
+    }
+
+    // Decode before clearing busy: the next edge may restart the DMA into block at once.
+    tf_luna_sample_t s;
+    tf_luna_decode(t->block, &s);
+    s.ready_us = t->started_us;
+    atomic_store_explicit(&t->busy, false, memory_order_release);
+
+    t->stats.reads++;
+    if (!s.valid)
+    {
+        t->stats.weak++;
+    }
+    t->last = s;
+    t->fresh = true;
+    if (t->done)
+    {
+        t->done(&t->last, t->user);
+    }
+    return true;
+}
+
+bool tf_luna_async_take(tf_luna_async_t *t, tf_luna_sample_t *s)
+{
+    if (!t->fresh)
+    {
+        return false;
+    }
+    *s = t->last;
+    t->fresh = false;
+    return true;
+}
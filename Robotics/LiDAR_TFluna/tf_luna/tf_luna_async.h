@@ -0,0 +1,125 @@
+/**
+ * @file tf_luna_async.h
+ * @brief Non-blocking TF-Luna reader: one burst read per data-ready edge.
+ *
+ * @details
+ * The reader never waits on the bus. tf_luna_async_start() is called from the data-ready
+ * (MUX_OUT) interrupt; it hands the whole measurement block read to an I2C backend and
+ * returns. The main loop calls tf_luna_async_service(), which polls the backend, decodes the
+ * block when it is complete and hands the sample to the completion callback, or keeps it for
+ * tf_luna_async_take(). A read that does not finish within timeout_us is aborted.
+ *
+ * The backend is a small table of functions, so the same state machine drives the DMA
+ * backend on the RP2040 (tf_luna_dma.h) and the register-file stub on a host
+ * (tf_luna_stub.h). Only start() is called from interrupt context.
+ *
+ * A data-ready edge that arrives while a read is still in flight is counted as missed and
+ * not queued: the sensor only holds one frame, and the next edge brings a fresher one.
+ *
+ * All times are microseconds from a free-running 32-bit counter, compared modulo 2^32.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef TF_LUNA_ASYNC_H
+#define TF_LUNA_ASYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "tf_luna_regs.h"
+
+#define TF_LUNA_TIMEOUT_US 2000u ///< Default read timeout, about 8 block reads at 400 kHz.
+
+// Return values of tf_luna_bus_t.poll()
+#define TF_LUNA_BUS_BUSY 0   ///< The transfer is still running.
+#define TF_LUNA_BUS_DONE 1   ///< All bytes are in the destination buffer.
+#define TF_LUNA_BUS_ERROR -1 ///< The transfer ended early (e.g. no ACK).
+
+typedef struct tf_luna_bus
+{
+    /// Starts a register read of len bytes into dst; returns false if it could not start.
+    bool (*start)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *dst, size_t len);
+    /// Reports the transfer state as a TF_LUNA_BUS_* value.
+    int (*poll)(void *ctx);
+    /// Stops a running transfer and leaves the bus ready for the next start().
+    void (*abort)(void *ctx);
+    void *ctx; ///< Backend state passed to every call.
+} tf_luna_bus_t;
+
+typedef void (*tf_luna_done_t)(const tf_luna_sample_t *s, void *user);
+
+typedef struct tf_luna_stats
+{
+    uint32_t reads;    ///< Blocks read and decoded.
+    uint32_t weak;     ///< Decoded samples flagged invalid by their amplitude.
+    uint32_t missed;   ///< Data-ready edges dropped because a read was in flight.
+    uint32_t errors;   ///< Reads that failed to start or ended in a bus error.
+    uint32_t timeouts; ///< Reads aborted after timeout_us.
+} tf_luna_stats_t;
+
+typedef struct tf_luna_async
+{
+    const tf_luna_bus_t *bus;           ///< I2C backend.
+    uint8_t addr;                       ///< Sensor I2C address.
+    atomic_bool busy;                   ///< A read is in flight.
+    uint32_t started_us;                ///< Time of the data-ready edge of the read in flight.
+    uint32_t timeout_us;                ///< Read timeout.
+    uint8_t block[TF_LUNA_BLOCK_LEN];   ///< DMA destination for the block.
+    tf_luna_sample_t last;              ///< Latest decoded sample.
+    bool fresh;                         ///< last has not been taken yet.
+    tf_luna_done_t done;                ///< Completion callback, or NULL.
+    void *user;                         ///< Passed to done.
+    tf_luna_stats_t stats;              ///< Counters.
+} tf_luna_async_t;
+
+/**
+ * @brief Initializes an idle reader.
+ *
+ * @param t Pointer to the reader.
+ * @param bus Backend, already initialized.
+ * @param addr Sensor I2C address (TF_LUNA_ADDR by default).
+ * @param done Called from tf_luna_async_service() with each new sample, or NULL to poll
+ *             with tf_luna_async_take().
+ * @param user Passed to done.
+ */
+void tf_luna_async_init(tf_luna_async_t *t, const tf_luna_bus_t *bus, uint8_t addr, tf_luna_done_t done,
+                        void *user);
+
+/**
+ * @brief Starts a block read; safe to call from the data-ready interrupt.
+ *
+ * @param t Pointer to the reader.
+ * @param now_us Time of the data-ready edge, copied to the sample's ready_us.
+ * @return true if a read was started, false if one was in flight or the bus refused.
+ */
+bool tf_luna_async_start(tf_luna_async_t *t, uint32_t now_us);
+
+/**
+ * @brief Advances the read in flight; call from the main loop.
+ *
+ * @param t Pointer to the reader.
+ * @param now_us Current time, for the timeout.
+ * @return true if a sample was completed by this call.
+ */
+bool tf_luna_async_service(tf_luna_async_t *t, uint32_t now_us);
+
+/**
+ * @brief Copies the latest sample if it has not been taken yet.
+ *
+ * @param t Pointer to the reader.
+ * @param s Output sample.
+ * @return true if a new sample was copied.
+ */
+bool tf_luna_async_take(tf_luna_async_t *t, tf_luna_sample_t *s);
+
+/**
+ * @brief Whether a read is in flight.
+ */
+static inline bool tf_luna_async_busy(tf_luna_async_t *t)
+{
+    return atomic_load_explicit(&t->busy, memory_order_acquire);
+}
+
+#endif // TF_LUNA_ASYNC_H
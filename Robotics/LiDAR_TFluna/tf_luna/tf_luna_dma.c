@@ -0,0 +1,95 @@
+/**
+ * @file tf_luna_dma.c
+ * @brief RP2040 I2C register reads driven entirely by two DMA channels.
+ */
+
+#include "tf_luna_dma.h"
+#include "hardware/dma.h"
+
+static bool dma_start(void *ctx, uint8_t addr, uint8_t reg, uint8_t *dst, size_t len)
+{
+    tf_luna_dma_t *d = ctx;
+    i2c_hw_t *hw = i2c_get_hw(d->i2c);
+
+    if (len == 0 || len > TF_LUNA_DMA_MAX_LEN || dma_channel_is_busy(d->rx_chan))
+    {
+        return false;
+    }
+
+    // The target address can only change with the controller disabled; it stays set after.
+    if (d->addr != addr)
+    {
+        hw->enable = 0;
+        hw->tar = addr;
+        hw->enable = 1;
+        d->addr = addr;
+    }
+
+    d->cmd[0] = reg;
+    for (size_t i = 0; i < len; i++)
+    {
+        d->cmd[1 + i] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    d->cmd[1] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    d->cmd[len] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    (void)hw->clr_tx_abrt;
+
+    // Receiver first, so no byte arrives before its channel is listening.
+    dma_channel_config c = dma_channel_get_default_config(d->rx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, i2c_get_dreq(d->i2c, false));
+    dma_channel_configure(d->rx_chan, &c, dst, &hw->data_cmd, len, true);
+
+    c = dma_channel_get_default_config(d->tx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(d->i2c, true));
+    dma_channel_configure(d->tx_chan, &c, &hw->data_cmd, d->cmd, len + 1, true);
+    return true;
+}
+
+static int dma_poll(void *ctx)
+{
+    tf_luna_dma_t *d = ctx;
+    i2c_hw_t *hw = i2c_get_hw(d->i2c);
+
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        return TF_LUNA_BUS_ERROR;
+    }
+    return dma_channel_is_busy(d->rx_chan) ? TF_LUNA_BUS_BUSY : TF_LUNA_BUS_DONE;
+}
+
+static void dma_abort(void *ctx)
+{
+    tf_luna_dma_t *d = ctx;
+    i2c_hw_t *hw = i2c_get_hw(d->i2c);
+
+    dma_channel_abort(d->tx_chan);
+    dma_channel_abort(d->rx_chan);
+
+    // Disabling the controller flushes both FIFOs and releases the bus after the current byte.
+    hw->enable = 0;
+    (void)hw->clr_tx_abrt;
+    hw->enable = 1;
+}
+
+void tf_luna_dma_init(tf_luna_dma_t *d, i2c_inst_t *i2c, tf_luna_bus_t *bus)
+{
+    d->i2c = i2c;
+    d->tx_chan = (uint)dma_claim_unused_channel(true);
+    d->rx_chan = (uint)dma_claim_unused_channel(true);
+    d->addr = -1;
+
+    // DREQ signalling towards the DMA (i2c_init() sets this too).
+    i2c_get_hw(i2c)->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+
+    bus->start = dma_start;
+    bus->poll = dma_poll;
+    bus->abort = dma_abort;
+    bus->ctx = d;
+}
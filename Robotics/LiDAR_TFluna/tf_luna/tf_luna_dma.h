@@ -0,0 +1,45 @@
+/**
+ * @file tf_luna_dma.h
+ * @brief RP2040 I2C register reads driven entirely by two DMA channels.
+ *
+ * @details
+ * The RP2040 I2C controller takes one command word per byte in IC_DATA_CMD: a byte to send,
+ * or a read request, with RESTART and STOP flags. A register read is therefore a list of
+ * len + 1 words: the register address, then len reads, the first with RESTART and the last
+ * with STOP. One DMA channel feeds that list to the controller, paced by the TX DREQ, and a
+ * second channel collects the received bytes into the destination, paced by the RX DREQ.
+ * The CPU only writes the channel registers; an 8-byte TF-Luna block at 400 kHz then takes
+ * about 250 us on the bus without it.
+ *
+ * A missing ACK aborts the transfer in the controller (TX_ABRT), which poll() reports as a
+ * bus error; abort() stops both channels and flushes the controller.
+ */
+
+#ifndef TF_LUNA_DMA_H
+#define TF_LUNA_DMA_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "tf_luna_async.h"
+
+#define TF_LUNA_DMA_MAX_LEN 16u ///< Longest read the command list has room for.
+
+typedef struct tf_luna_dma
+{
+    i2c_inst_t *i2c;                       ///< I2C instance, already initialized.
+    uint tx_chan;                          ///< Channel feeding command words.
+    uint rx_chan;                          ///< Channel collecting received bytes.
+    int addr;                              ///< Target address programmed, -1 if none.
+    uint32_t cmd[TF_LUNA_DMA_MAX_LEN + 1]; ///< Command list of the transfer in flight.
+} tf_luna_dma_t;
+
+/**
+ * @brief Claims two DMA channels for an I2C instance and fills in a bus.
+ *
+ * @param d Pointer to the backend.
+ * @param i2c I2C instance, set up with i2c_init() and its pins.
+ * @param bus Output backend bound to d.
+ */
+void tf_luna_dma_init(tf_luna_dma_t *d, i2c_inst_t *i2c, tf_luna_bus_t *bus);
+
+#endif // TF_LUNA_DMA_H
@@ -0,0 +1,47 @@
+/**
+ * @file tf_luna_hal.c
+ * @brief TF-Luna register reads over the blocking libs/hal I2C calls.
+ */
+
+#include "hal.h"
+#include "tf_luna_hal.h"
+
+static bool hal_bus_start(void *ctx, uint8_t addr, uint8_t reg, uint8_t *dst, size_t len)
+{
+    tf_luna_hal_t *h = ctx;
+
+    // Register address with a repeated start, then the block; a missing ACK ends it early
+    if (hal_i2c_write(h->port, addr, &reg, 1, true) != 1 ||
+        hal_i2c_read(h->port, addr, dst, len, false) != (int)len)
+    {
+        h->result = TF_LUNA_BUS_ERROR;
+    }
+    else
+    {
+        h->result = TF_LUNA_BUS_DONE;
+    }
+    return true;
+}
+
+static int hal_bus_poll(void *ctx)
+{
+    tf_luna_hal_t *h = ctx;
+    return h->result;
+}
+
+static void hal_bus_abort(void *ctx)
+{
+    // start() has already finished by the time a transfer could be aborted
+    (void)ctx;
+}
+
+void tf_luna_hal_init(tf_luna_hal_t *h, uint8_t port, tf_luna_bus_t *bus)
+{
+    h->port = port;
+    h->result = TF_LUNA_BUS_ERROR;
+
+    bus->start = hal_bus_start;
+    bus->poll = hal_bus_poll;
+    bus->abort = hal_bus_abort;
+    bus->ctx = h;
+}
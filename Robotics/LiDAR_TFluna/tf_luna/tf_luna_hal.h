@@ -0,0 +1,36 @@
+/**
+ * @file tf_luna_hal.h
+ * @brief TF-Luna register reads over the blocking libs/hal I2C calls, as a tf_luna_bus_t backend.
+ *
+ * @details
+ * start() does the whole transfer, the register address written without a stop and then
+ * the block read, and returns when it is over; poll() only reports how it ended. That
+ * keeps the reader's state machine unchanged but gives up what the DMA backend is for, so
+ * it is meant for the HAL_HOST build, where the HAL simulator's I2C models take virtual
+ * time and start() is called from the main loop rather than from the data-ready interrupt.
+ */
+
+#ifndef TF_LUNA_HAL_H
+#define TF_LUNA_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "tf_luna_async.h"
+
+typedef struct tf_luna_hal
+{
+    uint8_t port; ///< libs/hal I2C port, set up with hal_i2c_init().
+    int result;   ///< TF_LUNA_BUS_* state of the last transfer.
+} tf_luna_hal_t;
+
+/**
+ * @brief Binds a backend to an I2C port and fills in a bus.
+ *
+ * @param h Pointer to the backend.
+ * @param port I2C port, 0 or 1.
+ * @param bus Output backend bound to h.
+ */
+void tf_luna_hal_init(tf_luna_hal_t *h, uint8_t port, tf_luna_bus_t *bus);
+
+#endif // TF_LUNA_HAL_H
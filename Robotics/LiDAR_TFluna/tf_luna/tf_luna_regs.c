@@ -0,0 +1,23 @@
+/**
+ * @file tf_luna_regs.c
+ * @brief TF-Luna I2C register map and decoding of the measurement block.
+ */
+
+#include "tf_luna_regs.h"
+
+/**
+ * @brief Little-endian 16-bit register pair starting at a block offset.
+ */
+static inline uint16_t reg16(const uint8_t *block, uint8_t low)
+{
+    return (uint16_t)(block[low] | (block[low + 1] << 8));
+}
+
+void tf_luna_decode(const uint8_t block[TF_LUNA_BLOCK_LEN], tf_luna_sample_t *s)
+{
+    s->distance = reg16(block, TF_LUNA_DIST_LOW_ADDR);
+    s->amplitude = reg16(block, TF_LUNA_AMP_LOW_ADDR);
+    s->temp_centi = (int16_t)reg16(block, TF_LUNA_TEMP_LOW_ADDR);
+    s->tick_ms = reg16(block, TF_LUNA_TICK_LOW_ADDR);
+    s->valid = tf_luna_amp_ok(s->amplitude);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file tf_luna_regs.h
+ * @brief TF-Luna I2C register map and decoding of the measurement block.
+ *
+ * @details
+ * The TF-Luna keeps its latest measurement in eight consecutive little-endian registers:
+ * distance (cm), signal amplitude, chip temperature (0.01 °C) and a free-running tick
+ * (ms). The I2C address pointer auto-increments, so one burst read starting at
+ * TF_LUNA_DIST_LOW_ADDR returns the whole block, and all four values come from the same
+ * frame.
+ *
+ * The manual flags a distance as unreliable when the amplitude is below 100 (too little
+ * light came back) or is 65535 (the receiver is saturated); tf_luna_decode() keeps the
+ * distance but clears `valid`.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef TF_LUNA_REGS_H
+#define TF_LUNA_REGS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// TF-Luna addresses
+#define TF_LUNA_ADDR 0x10    // I2C address
+#define TF_LUNA_WO_ADDR 0x20 // Write-only address
+#define TF_LUNA_RO_ADDR 0x21 // Read-only address
+
+// TF-Luna registers
+#define TF_LUNA_DIST_LOW_ADDR 0x00  // Low byte of distance
+#define TF_LUNA_DIST_HIGH_ADDR 0x01 // High byte of distance
+#define TF_LUNA_AMP_LOW_ADDR 0x02   // Low byte of signal amplitude
+#define TF_LUNA_AMP_HIGH_ADDR 0x03  // High byte of signal amplitude
+#define TF_LUNA_TEMP_LOW_ADDR 0x04  // Low byte of chip temperature
+#define TF_LUNA_TEMP_HIGH_ADDR 0x05 // High byte of chip temperature
+#define TF_LUNA_TICK_LOW_ADDR 0x06  // Low byte of the timestamp
+#define TF_LUNA_TICK_HIGH_ADDR 0x07 // High byte of the timestamp
+
+#define TF_LUNA_BLOCK_LEN 8u          ///< Bytes in the measurement block (0x00 .. 0x07).
+#define TF_LUNA_AMP_MIN 100u          ///< Smallest amplitude with a reliable distance.
+#define TF_LUNA_AMP_SATURATED 0xFFFFu ///< Amplitude reported when the receiver saturates.
+
+typedef struct tf_luna_sample
+{
+    uint16_t distance;  ///< Distance in cm.
+    uint16_t amplitude; ///< Signal amplitude.
+    int16_t temp_centi; ///< Chip temperature in 0.01 °C.
+    uint16_t tick_ms;   ///< Sensor timestamp in ms, wraps at 2^16.
+    uint32_t ready_us;  ///< Local time of the data-ready edge that started the read.
+    bool valid;         ///< The amplitude is within the reliable range.
+} tf_luna_sample_t;
+
+/**
+ * @brief Whether a distance measured at this amplitude is reliable.
+ */
+static inline bool tf_luna_amp_ok(uint16_t amplitude)
+{
+    return amplitude >= TF_LUNA_AMP_MIN && amplitude != TF_LUNA_AMP_SATURATED;
+}
+
+/**
+ * @brief Decodes a measurement block read from TF_LUNA_DIST_LOW_ADDR.
+ *
+ * ready_us is left untouched; the reader stamps it.
+ *
+ * @param block TF_LUNA_BLOCK_LEN register bytes, in address order.
+ * @param s Output sample.
+ */
+void tf_luna_decode(const uint8_t block[TF_LUNA_BLOCK_LEN], tf_luna_sample_t *s);
+
+#endif // TF_LUNA_REGS_H
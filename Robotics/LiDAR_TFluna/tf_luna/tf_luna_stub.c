@@ -0,0 +1,97 @@
+/**
+ * @file tf_luna_stub.c
+ * @brief Host stand-in for the TF-Luna on an I2C bus, as a tf_luna_bus_t backend.
+ */
+
+#include <string.h>
+#include "tf_luna_stub.h"
+
+static bool stub_start(void *ctx, uint8_t addr, uint8_t reg, uint8_t *dst, size_t len)
+{
+    tf_luna_stub_t *s = ctx;
+    if (s->active)
+    {
+        return false;
+    }
+
+    s->reads++;
+    s->active = true;
+    // A wrong address is not acknowledged; the failure shows up on the first poll().
+    s->nack = addr != s->addr || (s->nack_every && s->reads % s->nack_every == 0);
+    s->hang = s->hang_every && s->reads % s->hang_every == 0;
+    s->remaining = s->latency_polls;
+    s->reg = reg;
+    s->dst = dst;
+    s->len = len;
+    return true;
+}
+
+static int stub_poll(void *ctx)
+{
+    tf_luna_stub_t *s = ctx;
+    if (!s->active)
+    {
+        return TF_LUNA_BUS_ERROR;
+    }
+    if (s->nack)
+    {
+        return TF_LUNA_BUS_ERROR;
+    }
+    if (s->hang)
+    {
+        return TF_LUNA_BUS_BUSY;
+    }
+    if (s->remaining)
+    {
+        s->remaining--;
+        return TF_LUNA_BUS_BUSY;
+    }
+
+    // The address pointer auto-increments; reads past the modelled registers return 0.
+    for (size_t i = 0; i < s->len; i++)
+    {
+        size_t r = (size_t)s->reg + i;
+        s->dst[i] = r < TF_LUNA_STUB_REGS ? s->regs[r] : 0;
+    }
+    s->active = false;
+    return TF_LUNA_BUS_DONE;
+}
+
+static void stub_abort(void *ctx)
+{
+    tf_luna_stub_t *s = ctx;
+    s->active = false;
+    s->aborts++;
+}
+
+void tf_luna_stub_init(tf_luna_stub_t *s, uint8_t addr, uint32_t latency_polls, tf_luna_bus_t *bus)
+{
+    memset(s, 0, sizeof(*s));
+    s->addr = addr;
+    s->latency_polls = latency_polls;
+
+    bus->start = stub_start;
+    bus->poll = stub_poll;
+    bus->abort = stub_abort;
+    bus->ctx = s;
+}
+
+void tf_luna_stub_load(tf_luna_stub_t *s, const uint8_t *dump, size_t len)
+{
+    if (len > TF_LUNA_STUB_REGS)
+    {
+        len = TF_LUNA_STUB_REGS;
+    }
+    memcpy(s->regs, dump, len);
+}
+
+void tf_luna_stub_set(tf_luna_stub_t *s, uint16_t distance, uint16_t amplitude, int16_t temp_centi,
+                      uint16_t tick_ms)
+{
+    const uint16_t values[4] = {distance, amplitude, (uint16_t)temp_centi, tick_ms};
+    for (int i = 0; i < 4; i++)
+    {
+        s->regs[2 * i] = (uint8_t)(values[i] & 0xFF);
+        s->regs[2 * i + 1] = (uint8_t)(values[i] >> 8);
+    }
+}
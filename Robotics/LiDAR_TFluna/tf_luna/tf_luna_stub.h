@@ -0,0 +1,69 @@
+/**
+ * @file tf_luna_stub.h
+ * @brief Host stand-in for the TF-Luna on an I2C bus, as a tf_luna_bus_t backend.
+ *
+ * @details
+ * The stub holds a copy of the sensor's register file, loaded from a captured register
+ * dump, and answers register reads the way the DMA backend does: start() returns at once,
+ * and the bytes land in the destination only when the transfer completes, latency_polls
+ * poll() calls later. Faults can be injected: every nack_every-th read fails with a bus
+ * error, and every hang_every-th read never completes, so the reader's error and timeout
+ * paths run on a host exactly as they would on the board.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef TF_LUNA_STUB_H
+#define TF_LUNA_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "tf_luna_async.h"
+
+#define TF_LUNA_STUB_REGS 0x30u ///< Registers modelled (0x00 .. 0x2F).
+
+typedef struct tf_luna_stub
+{
+    uint8_t regs[TF_LUNA_STUB_REGS]; ///< Register file.
+    uint8_t addr;                    ///< Address the stub answers on.
+    uint32_t latency_polls;          ///< poll() calls before a transfer completes.
+    uint32_t nack_every;             ///< Fail every n-th read with a bus error (0 = never).
+    uint32_t hang_every;             ///< Never complete every n-th read (0 = never).
+    uint32_t reads;                  ///< Reads started.
+    uint32_t aborts;                 ///< abort() calls.
+    bool active;                     ///< A transfer is in flight.
+    bool nack;                       ///< The transfer in flight will fail.
+    bool hang;                       ///< The transfer in flight will not complete.
+    uint32_t remaining;              ///< Polls left before the transfer in flight completes.
+    uint8_t reg;                     ///< First register of the transfer in flight.
+    uint8_t *dst;                    ///< Destination of the transfer in flight.
+    size_t len;                      ///< Length of the transfer in flight.
+} tf_luna_stub_t;
+
+/**
+ * @brief Initializes a stub with a zero register file and no faults, and fills in a bus.
+ *
+ * @param s Pointer to the stub.
+ * @param addr I2C address the stub answers on.
+ * @param latency_polls poll() calls before a transfer completes.
+ * @param bus Output backend bound to the stub.
+ */
+void tf_luna_stub_init(tf_luna_stub_t *s, uint8_t addr, uint32_t latency_polls, tf_luna_bus_t *bus);
+
+/**
+ * @brief Copies a captured register dump into the register file, starting at register 0.
+ *
+ * @param s Pointer to the stub.
+ * @param dump Register bytes in address order.
+ * @param len Number of bytes (at most TF_LUNA_STUB_REGS are used).
+ */
+void tf_luna_stub_load(tf_luna_stub_t *s, const uint8_t *dump, size_t len);
+
+/**
+ * @brief Writes one measurement into the register block, as the sensor does each frame.
+ */
+void tf_luna_stub_set(tf_luna_stub_t *s, uint16_t distance, uint16_t amplitude, int16_t temp_centi,
+                      uint16_t tick_ms);
+
+#endif // TF_LUNA_STUB_H
@@ -1,21 +1,61 @@
-import serial
+import argparse
+import queue
+import threading
+import time
 import tkinter as tk
 import math
-import threading
 
-# Global variable to track the current angle of the radar
-current_angle = 0
-ANGLE_STEP = 10 # Angle increment for each data point (in degrees)
+from scan_frame import GridFrame, ScanFrame, ScanFrameDecoder, decode_file
+
+UPDATE_MS = 30          # Interval between redraws of the radar (in milliseconds)
+REPLAY_FRAME_S = 1.0    # Delay between frames when replaying a recording (one half-sweep)
+MODES = {"raw": b"r", "filtered": b"f", "grid": b"g"}  # Command byte selecting what the Pico sends
 
-# Dictionary to store the distance values for each angle
-distance_data = {}
+# Frames and points from the reader thread to the Tkinter thread; Tkinter calls are only
+# made from the thread running mainloop()
+updates = queue.Queue()
 
 # ============================
 # Function Definitions
 # ============================
 
 """
-@brief Reads data from the serial port and updates the radar interface.
+@brief Reads binary scan frames from the serial port and queues them for the radar.
+
+The Pico sends one frame per half-sweep, or an occupancy grid every few sweeps in grid
+mode (see scan_frame.py for the formats). The raw bytes can also be appended to a file,
+which --replay plays back later.
+
+@param port The serial port to listen to (e.g., '/dev/ttyACM0').
+@param baudrate The baud rate for the serial communication.
+@param record Path of a file to append the received bytes to, or None.
+@param mode Key of MODES to request, or None to keep the Pico's current mode.
+"""
+def read_serial(port, baudrate, record=None, mode=None):
+    import serial
+    decoder = ScanFrameDecoder()
+    out = open(record, "ab") if record else None
+    try:
+        with serial.Serial(port, baudrate, timeout=0.05) as ser:
+            print("Listening on serial port...")
+            if mode:
+                ser.write(MODES[mode])
+            while True:
+                data = ser.read(ser.in_waiting or 1)
+                if not data:
+                    continue
+                if out:
+                    out.write(data)
+                for frame in decoder.feed(data):
+                    updates.put(frame)
+    except serial.SerialException as e:
+        print(f"Error: {e}")  # Handle serial port errors
+    finally:
+        if out:
+            out.close()
+
+"""
+@brief Reads "angle:distance" lines, as sent in step mode or with SCAN_BINARY cleared.
 
 The data format should be: <angle>:<distance>\n
 - <angle>: The angle in degrees (0-360).
@@ -25,94 +65,157 @@ Example: "90:150\n" (angle 90°, distance 150 cm).
 
 @param port The serial port to listen to (e.g., '/dev/ttyACM0').
 @param baudrate The baud rate for the serial communication.
-@param canvas The Tkinter canvas object used for drawing the radar.
-@param radar_center A tuple representing the center coordinates of the radar.
-@param radar_radius The radius of the radar visualization.
 """
-def read_serial(port, baudrate, canvas, radar_center, radar_radius):
-    global distance_data
+def read_serial_text(port, baudrate):
+    import serial
     try:
         with serial.Serial(port, baudrate, timeout=1) as ser:
             print("Listening on serial port...")
             while True:
-                if ser.in_waiting > 0:  # Check if data is available
-                    data = ser.readline().decode('utf-8').strip()  # Read and decode the data
-                    try:
-                        # Split the data into angle and distance
-                        angle_str, distance_str = data.split(':')
-                        angle = int(angle_str)  # Convert angle to integer
-                        distance = int(distance_str)  # Convert distance to integer
-
-                        # Validate angle and distance
-                        if 0 <= angle <= 360 and distance >= 0:
-                            # Store the distance for the given angle
-                            distance_data[angle] = distance
-                            # Update the radar visualization
-                            update_radar(canvas, radar_center, radar_radius, angle, distance)
-                        else:
-                            print(f"Invalid data: {data}")  # Handle out-of-range values
-                    except (ValueError, IndexError):
-                        print(f"Invalid data format: {data}")  # Handle invalid data
+                data = ser.readline().decode("utf-8", errors="replace").strip()
+                if not data:
+                    continue
+                try:
+                    # Split the data into angle and distance
+                    angle_str, distance_str = data.split(":")
+                    angle = int(angle_str)
+                    distance = int(distance_str)
+
+                    # Validate angle and distance
+                    if 0 <= angle <= 360 and distance >= 0:
+                        # A one-point frame; quality 1 marks it as a usable return
+                        updates.put(ScanFrame(0, 0, angle * 100, 100, [(distance, 1 if distance else 0)]))
+                    else:
+                        print(f"Invalid data: {data}")  # Handle out-of-range values
+                except (ValueError, IndexError):
+                    print(f"Invalid data format: {data}")  # Handle invalid data
     except serial.SerialException as e:
         print(f"Error: {e}")  # Handle serial port errors
 
 """
-@brief Updates the radar visualization for a specific angle.
+@brief Plays back a recording made with --record, one frame every REPLAY_FRAME_S seconds.
 
-This function draws or updates a point at the end of the radar line for the given angle and distance.
-It also draws a rotating radius in a different color to indicate the current angle and distance.
-Additionally, it displays the distance value (in centimeters) near the point.
+@param path File with the raw bytes received from the Pico.
+"""
+def replay_file(path):
+    frames, decoder = decode_file(path)
+    print(f"Replaying {decoder.frames} frames ({decoder.crc_errors} CRC errors, {decoder.skipped} bytes skipped)")
+    for frame in frames:
+        updates.put(frame)
+        time.sleep(REPLAY_FRAME_S)
 
-@param canvas The Tkinter canvas object used for drawing the radar.
-@param radar_center A tuple representing the center coordinates of the radar.
-@param radar_radius The radius of the radar visualization.
-@param angle The angle at which to draw the radar point.
-@param distance The distance value to represent at the given angle.
 """
-def update_radar(canvas, radar_center, radar_radius, angle, distance):
-    # Remove the previous point, radius, and text for this angle, if they exist
-    point_tag = f"radar_point_{angle}"
-    radius_tag = "radar_radius"
-    text_tag = f"radar_text_{angle}"
-    canvas.delete(point_tag)
-    canvas.delete(radius_tag)
-    canvas.delete(text_tag)
-
-    # Calculate the x and y coordinates for the point
-    x = radar_center[0] + distance * math.cos(math.radians(angle))
-    y = radar_center[1] - distance * math.sin(math.radians(angle))
-
-    # Draw the radar point for the current angle
-    canvas.create_oval(
-        x - 2, y - 2, x + 2, y + 2,  # Small circle to represent the point
-        fill="green", outline="green", tags=point_tag
-    )
+@brief Radar display that only touches the points whose value changed.
 
-    # Draw the rotating radius in red
-    canvas.create_line(
-        radar_center[0], radar_center[1], x, y,
-        fill="red", width=1, tags=radius_tag
-    )
+Every angle bin owns one oval on the canvas, created the first time the bin is seen and
+then moved or hidden. A frame only costs work for the bins whose distance or quality
+differs from what is drawn, and all frames queued since the last redraw are merged first,
+so a redraw never takes longer than one full sweep's worth of points, however far
+behind the display is.
+"""
+class RadarView:
+    def __init__(self, canvas, radar_center, radar_radius):
+        self.canvas = canvas
+        self.center = radar_center
+        self.radius = radar_radius
+        self.points = {}  # angle (cdeg) -> (distance, quality) as drawn
+        self.items = {}   # angle (cdeg) -> canvas oval
+        self.cells = {}   # (column, row) -> canvas rectangle of an occupied grid cell
+        self.redrawn = 0  # Points moved or hidden since start
 
-    # Remove the previous distance text
-    canvas.delete("distance_text")
+    def apply(self, pending):
+        """@brief Draws the merged changes {angle_cdeg: (distance, quality)}."""
+        for cdeg, (distance, quality) in pending.items():
+            if self.points.get(cdeg) == (distance, quality):
+                continue
+            self.points[cdeg] = (distance, quality)
+            self.redrawn += 1
 
-    # Display the distance value (in centimeters) in the top-right corner
-    canvas.create_text(
-        radar_center[0] + radar_radius - 10, 10, 
-        text=f"{distance} cm", fill="white", font=("Arial", 20), tags=("distance_text", text_tag), anchor="ne"
-    )
+            item = self.items.get(cdeg)
+            if quality == 0:
+                # No usable return: hide the point instead of deleting it
+                if item is not None:
+                    self.canvas.itemconfigure(item, state="hidden")
+                continue
+
+            # Calculate the x and y coordinates for the point
+            angle = math.radians(cdeg / 100.0)
+            x = self.center[0] + distance * math.cos(angle)
+            y = self.center[1] - distance * math.sin(angle)
+            if item is None:
+                self.items[cdeg] = self.canvas.create_oval(x - 2, y - 2, x + 2, y + 2, fill="green", outline="green")
+            else:
+                self.canvas.coords(item, x - 2, y - 2, x + 2, y + 2)
+                self.canvas.itemconfigure(item, state="normal")
+
+    def apply_grid(self, grid):
+        """@brief Draws an occupancy grid, adding and deleting only the cells that changed."""
+        occupied = grid.occupied()
+        for cell in self.cells.keys() - occupied:
+            self.canvas.delete(self.cells.pop(cell))
+            self.redrawn += 1
+        for cx, cy in occupied - self.cells.keys():
+            # One pixel per centimeter, as for the points
+            x = self.center[0] + (cx - grid.origin_x) * grid.cell_cm
+            y = self.center[1] - (cy - grid.origin_y) * grid.cell_cm
+            self.cells[(cx, cy)] = self.canvas.create_rectangle(x, y - grid.cell_cm, x + grid.cell_cm, y,
+                                                                fill="green", outline="")
+            self.redrawn += 1
+
+    def sweep_line(self, frame):
+        """@brief Moves the red radius to the last angle of a frame, in the sweep's direction."""
+        angles = frame.angles()
+        if not angles:
+            return
+        angle = math.radians(angles[0] if frame.flags & 1 else angles[-1])
+        x = self.center[0] + self.radius * math.cos(angle)
+        y = self.center[1] - self.radius * math.sin(angle)
+        self.canvas.coords("radar_radius", self.center[0], self.center[1], x, y)
+
+"""
+@brief Applies the queued frames to the radar and schedules the next redraw.
+
+@param root The Tkinter root window.
+@param view The RadarView to update.
+@param status Canvas text item showing the link statistics.
+"""
+def redraw(root, view, status):
+    pending = {}
+    last = None
+    grid = None
+    while True:
+        try:
+            frame = updates.get_nowait()
+        except queue.Empty:
+            break
+        if isinstance(frame, GridFrame):
+            # Only the newest grid matters
+            grid = frame
+            continue
+        for i, point in enumerate(frame.points):
+            pending[frame.start_cdeg + i * frame.step_cdeg] = point
+        last = frame
+
+    if last is not None:
+        view.apply(pending)
+        view.sweep_line(last)
+    if grid is not None:
+        view.apply_grid(grid)
+    newest = grid if grid is not None else last
+    if newest is not None:
+        view.canvas.itemconfigure(status, text=f"sweep {newest.sweep}  points redrawn {view.redrawn}")
+    root.after(UPDATE_MS, redraw, root, view, status)
 
 """
 @brief Creates the radar interface using Tkinter.
 
-This function initializes a Tkinter window with a radar visualization. It also starts
-a separate thread to read data from the serial port and update the radar in real-time.
+This function initializes a Tkinter window with a radar visualization, and starts a
+separate thread that reads the serial port (or a recording) and queues the updates.
 
-@param serial_port The serial port to listen to (e.g., '/dev/ttyACM0').
-@param baud_rate The baud rate for the serial communication.
+@param source Function run in the reader thread.
+@param args Arguments for source.
 """
-def create_radar_interface(serial_port, baud_rate):
+def create_radar_interface(source, args):
     root = tk.Tk()
     root.title("Radar Interface")
 
@@ -138,8 +241,16 @@ def create_radar_interface(serial_port, baud_rate):
     canvas.create_line(radar_center[0], radar_center[1] - radar_radius, radar_center[0], radar_center[1] + radar_radius, fill="green")
     canvas.create_line(radar_center[0] - radar_radius, radar_center[1], radar_center[0] + radar_radius, radar_center[1], fill="green")
 
-    # Start reading from the serial port in a separate thread
-    threading.Thread(target=read_serial, args=(serial_port, baud_rate, canvas, radar_center, radar_radius), daemon=True).start()
+    # The rotating radius and the status line, moved and updated in place
+    canvas.create_line(radar_center[0], radar_center[1], radar_center[0] + radar_radius, radar_center[1],
+                       fill="red", width=1, tags="radar_radius")
+    status = canvas.create_text(10, 10, text="waiting for data", fill="white", font=("Arial", 12), anchor="nw")
+
+    view = RadarView(canvas, radar_center, radar_radius)
+
+    # Start reading in a separate thread; the canvas is only updated from redraw()
+    threading.Thread(target=source, args=args, daemon=True).start()
+    root.after(UPDATE_MS, redraw, root, view, status)
 
     # Start the Tkinter main loop
     root.mainloop()
@@ -151,11 +262,24 @@ def create_radar_interface(serial_port, baud_rate):
 """
 @brief Main entry point of the program.
 
-This script initializes the radar interface and starts reading data from the serial port.
-Replace the `serial_port` and `baud_rate` variables with the appropriate values for your setup.
+By default the script reads binary frames from the serial port; --mode asks the Pico for
+raw points, filtered points or the occupancy grid. --text reads the older
+"angle:distance" lines, --record keeps a copy of the received bytes, and --replay shows
+a recording without a Pico attached.
 """
 if __name__ == "__main__":
-    # Replace '/dev/ttyACM0' with your serial port and adjust the baud rate
-    serial_port = '/dev/ttyACM0'
-    baud_rate = 15200
-    create_radar_interface(serial_port, baud_rate)
\ No newline at end of file
+    parser = argparse.ArgumentParser(description="LiDAR radar display")
+    parser.add_argument("--port", default="/dev/ttyACM0", help="serial port of the Pico")
+    parser.add_argument("--baud", type=int, default=15200, help="baud rate (ignored by USB CDC)")
+    parser.add_argument("--mode", choices=MODES, help="what the Pico sends (default: filtered points)")
+    parser.add_argument("--text", action="store_true", help='read "angle:distance" lines')
+    parser.add_argument("--record", metavar="FILE", help="append the received bytes to FILE")
+    parser.add_argument("--replay", metavar="FILE", help="play back a recording instead of reading the port")
+    args = parser.parse_args()
+
+    if args.replay:
+        create_radar_interface(replay_file, (args.replay,))
+    elif args.text:
+        create_radar_interface(read_serial_text, (args.port, args.baud))
+    else:
+        create_radar_interface(read_serial, (args.port, args.baud, args.record, args.mode))
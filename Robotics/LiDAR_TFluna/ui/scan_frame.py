@@ -0,0 +1,230 @@
+import binascii
+import struct
+import sys
+
+# ============================
+# Frame format (see scan_frame/scan_frame.h)
+# ============================
+
+SYNC = b"\xa5\x5a"     # Sync bytes at the start of every frame
+GRID_SYNC = b"\xa5\x5b" # Sync bytes at the start of a grid frame
+VERSION = 1            # Format version
+HEADER_LEN = 12        # Bytes before the points
+MAX_POINTS = 256       # Largest point count accepted
+REVERSE = 0x01         # Flag: the sweep runs from max to min
+DIST_MASK = 0x0FFF     # Distance bits of a point
+QUALITY_SHIFT = 12     # Position of the quality in a point
+GRID_HEADER_LEN = 16   # Bytes before the grid cells
+GRID_MAX_BYTES = 4096  # Largest grid accepted
+
+HEADER = struct.Struct("<2sBBHhhH")
+GRID_HEADER = struct.Struct("<2sBBHHHHhh")
+
+"""
+@brief One decoded sector of a sweep.
+
+@param sweep Sweep number (wraps at 65536).
+@param flags Frame flags (REVERSE).
+@param start_cdeg Angle of the first point, in hundredths of a degree.
+@param step_cdeg Angle step between points, in hundredths of a degree.
+@param points List of (distance_cm, quality) tuples; quality 0 means no usable return.
+"""
+class ScanFrame:
+    def __init__(self, sweep, flags, start_cdeg, step_cdeg, points):
+        self.sweep = sweep
+        self.flags = flags
+        self.start_cdeg = start_cdeg
+        self.step_cdeg = step_cdeg
+        self.points = points
+
+    def angles(self):
+        """@brief Angle of each point in degrees."""
+        return [(self.start_cdeg + i * self.step_cdeg) / 100.0 for i in range(len(self.points))]
+
+    def __repr__(self):
+        return (f"ScanFrame(sweep={self.sweep}, start={self.start_cdeg / 100:.2f}, "
+                f"step={self.step_cdeg / 100:.2f}, n={len(self.points)})")
+
+"""
+@brief One decoded occupancy grid.
+
+@param sweep Sweep number when the grid was sent.
+@param width Cells along x.
+@param height Cells along y.
+@param cell_cm Cell size in centimeters.
+@param origin_x Cell column of the sensor.
+@param origin_y Cell row of the sensor.
+@param cells Packed cells: rows from y = 0, ceil(width / 8) bytes each, LSB first.
+"""
+class GridFrame:
+    def __init__(self, sweep, width, height, cell_cm, origin_x, origin_y, cells):
+        self.sweep = sweep
+        self.width = width
+        self.height = height
+        self.cell_cm = cell_cm
+        self.origin_x = origin_x
+        self.origin_y = origin_y
+        self.cells = bytes(cells)
+
+    def occupied(self):
+        """@brief Set of (column, row) of the occupied cells."""
+        stride = (self.width + 7) // 8
+        result = set()
+        for i, byte in enumerate(self.cells):
+            while byte:
+                bit = (byte & -byte).bit_length() - 1
+                byte &= byte - 1
+                x = (i % stride) * 8 + bit
+                if x < self.width:
+                    result.add((x, i // stride))
+        return result
+
+    def __repr__(self):
+        return (f"GridFrame(sweep={self.sweep}, {self.width}x{self.height} cells of {self.cell_cm} cm, "
+                f"occupied={len(self.occupied())})")
+
+"""
+@brief Encodes a frame; the inverse of ScanFrameDecoder, used to write replay files.
+
+@param frame ScanFrame to encode.
+@return bytes The frame, CRC included.
+"""
+def encode_frame(frame):
+    words = [min(d, DIST_MASK) | ((q & 0x0F) << QUALITY_SHIFT) for d, q in frame.points]
+    body = HEADER.pack(SYNC, VERSION, frame.flags, frame.sweep & 0xFFFF, frame.start_cdeg,
+                       frame.step_cdeg, len(words))
+    body += struct.pack(f"<{len(words)}H", *words)
+    return body + struct.pack("<H", binascii.crc_hqx(body[2:], 0xFFFF))
+
+"""
+@brief Incremental decoder for a byte stream of scan frames and grid frames.
+
+Bytes are fed in chunks of any size; complete frames come out in order. Bytes that are
+not part of a valid frame (line noise, text printed at boot, a frame with a bad CRC) are
+skipped and counted, and decoding resumes at the next sync.
+"""
+class ScanFrameDecoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frames = 0      # Frames decoded
+        self.crc_errors = 0  # Frames dropped for a CRC mismatch
+        self.skipped = 0     # Bytes discarded while searching for a sync
+
+    def feed(self, data):
+        """@brief Adds received bytes and returns the list of frames (ScanFrame or GridFrame)
+        completed by them."""
+        self.buffer += data
+        frames = []
+        while True:
+            start = self._find_sync()
+            if start < 0:
+                # Keep a trailing first sync byte; its pair may be in the next chunk
+                keep = 1 if self.buffer[-1:] == SYNC[:1] else 0
+                self._skip(len(self.buffer) - keep)
+                return frames
+            self._skip(start)
+
+            if self.buffer.startswith(GRID_SYNC):
+                grid = self._grid()
+                if grid is None:
+                    return frames
+                if grid is not False:
+                    frames.append(grid)
+                continue
+
+            if len(self.buffer) < HEADER_LEN:
+                return frames
+            _, version, flags, sweep, start_cdeg, step_cdeg, n = HEADER.unpack_from(self.buffer)
+            if version != VERSION or n > MAX_POINTS:
+                self._skip(1)
+                continue
+            length = HEADER_LEN + 2 * n + 2
+            if len(self.buffer) < length:
+                return frames
+
+            body = bytes(self.buffer[:length - 2])
+            (crc,) = struct.unpack_from("<H", self.buffer, length - 2)
+            if crc != binascii.crc_hqx(body[2:], 0xFFFF):
+                self.crc_errors += 1
+                self._skip(1)
+                continue
+
+            words = struct.unpack_from(f"<{n}H", body, HEADER_LEN)
+            points = [(w & DIST_MASK, w >> QUALITY_SHIFT) for w in words]
+            frames.append(ScanFrame(sweep, flags, start_cdeg, step_cdeg, points))
+            self.frames += 1
+            del self.buffer[:length]
+
+    def _find_sync(self):
+        found = [i for i in (self.buffer.find(SYNC), self.buffer.find(GRID_SYNC)) if i >= 0]
+        return min(found) if found else -1
+
+    def _grid(self):
+        """@brief Decodes the grid frame at the start of the buffer: a GridFrame, None if
+        more bytes are needed, or False if it was invalid and skipped."""
+        if len(self.buffer) < GRID_HEADER_LEN:
+            return None
+        _, version, _, sweep, width, height, cell_cm, origin_x, origin_y = GRID_HEADER.unpack_from(self.buffer)
+        size = (width + 7) // 8 * height
+        if version != VERSION or size > GRID_MAX_BYTES:
+            self._skip(1)
+            return False
+        length = GRID_HEADER_LEN + size + 2
+        if len(self.buffer) < length:
+            return None
+
+        (crc,) = struct.unpack_from("<H", self.buffer, length - 2)
+        if crc != binascii.crc_hqx(bytes(self.buffer[2:length - 2]), 0xFFFF):
+            self.crc_errors += 1
+            self._skip(1)
+            return False
+
+        grid = GridFrame(sweep, width, height, cell_cm, origin_x, origin_y, self.buffer[GRID_HEADER_LEN:length - 2])
+        self.frames += 1
+        del self.buffer[:length]
+        return grid
+
+    def _skip(self, count):
+        if count > 0:
+            self.skipped += count
+            del self.buffer[:count]
+
+"""
+@brief Decodes a recorded byte stream (e.g. from radar.py --record) in fixed-size chunks.
+
+@param path File holding the raw bytes received from the Pico.
+@param chunk Bytes fed to the decoder at a time, to exercise the resynchronisation.
+@return tuple (frames, decoder) with every frame decoded and the decoder's counters.
+"""
+def decode_file(path, chunk=64):
+    decoder = ScanFrameDecoder()
+    frames = []
+    with open(path, "rb") as f:
+        while True:
+            data = f.read(chunk)
+            if not data:
+                break
+            frames.extend(decoder.feed(data))
+    return frames, decoder
+
+# ============================
+# Main Execution
+# ============================
+
+"""
+@brief Prints the frames of a recording and the decoder's counters.
+
+Usage: python scan_frame.py capture.bin
+"""
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("usage: python scan_frame.py <capture.bin>")
+        sys.exit(2)
+    frames, decoder = decode_file(sys.argv[1])
+    for frame in frames:
+        if isinstance(frame, GridFrame):
+            print(frame)
+            continue
+        valid = sum(1 for _, q in frame.points if q)
+        print(f"{frame}  valid={valid}")
+    print(f"frames={decoder.frames} crc_errors={decoder.crc_errors} skipped={decoder.skipped}")
@@ -0,0 +1,80 @@
+"""
+@brief Replays the stream written by scan_frame/tests/test_scan_frame.c through the Python
+decoder.
+
+The C test writes <prefix>.bin, a byte stream of scan frames, a grid frame, boot text, junk,
+false syncs and a frame with a bad CRC, and <prefix>.txt, the frames and counters the C
+decoder got from it. ScanFrameDecoder must produce the same listing whatever the size of
+the chunks it is fed, decode_file() must agree, and encode_frame() must give back the bytes
+the firmware sent for every scan frame.
+
+Usage: python test_scan_frame.py <prefix>
+"""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from scan_frame import GridFrame, ScanFrameDecoder, decode_file, encode_frame  # noqa: E402
+
+checks = 0
+failures = 0
+
+def check(cond, what):
+    """@brief Counts a check and reports it on stderr if it failed."""
+    global checks, failures
+    checks += 1
+    if not cond:
+        failures += 1
+        print(f"test_scan_frame.py: {what} failed", file=sys.stderr)
+
+def listing(frames, decoder):
+    """@brief The frames and counters in the format of the C listing."""
+    lines = []
+    for f in frames:
+        if isinstance(f, GridFrame):
+            lines.append(f"grid {f.sweep} {f.width} {f.height} {f.cell_cm} {f.origin_x} {f.origin_y} {f.cells.hex()}")
+        else:
+            points = "".join(f" {d}:{q}" for d, q in f.points)
+            lines.append(f"scan {f.sweep} {f.flags} {f.start_cdeg} {f.step_cdeg}{points}")
+    lines.append(f"frames={decoder.frames} crc_errors={decoder.crc_errors} skipped={decoder.skipped}")
+    return lines
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: python test_scan_frame.py <prefix>")
+        return 2
+    with open(sys.argv[1] + ".bin", "rb") as f:
+        data = f.read()
+    with open(sys.argv[1] + ".txt") as f:
+        expected = f.read().splitlines()
+    check(len(expected) > 10, "listing length")
+
+    for chunk in (1, 2, 7, 64, 1000, len(data)):
+        decoder = ScanFrameDecoder()
+        frames = []
+        for i in range(0, len(data), chunk):
+            frames.extend(decoder.feed(data[i:i + chunk]))
+        got = listing(frames, decoder)
+        check(got == expected, f"listing in chunks of {chunk}")
+        if got != expected:
+            for i, (a, b) in enumerate(zip(got, expected)):
+                if a != b:
+                    print(f"  line {i}: {a[:80]!r} != {b[:80]!r}", file=sys.stderr)
+                    break
+        check(len(decoder.buffer) == 0, f"nothing left over in chunks of {chunk}")
+
+    frames, decoder = decode_file(sys.argv[1] + ".bin", chunk=7)
+    check(listing(frames, decoder) == expected, "decode_file")
+
+    scans = [f for f in frames if not isinstance(f, GridFrame)]
+    check(len(scans) + 1 == len(frames), "one grid frame")
+    for f in scans:
+        check(encode_frame(f) in data, f"re-encoding sweep {f.sweep} at {f.start_cdeg}")
+
+    print(f"scan_frame.py: {checks} checks, {failures} failed")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
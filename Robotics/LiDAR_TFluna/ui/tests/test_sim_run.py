@@ -0,0 +1,100 @@
+"""
+@brief Runs the LiDAR_TFluna host build on the HAL simulator and checks the scan it sends.
+
+The program's simulated TF-Luna looks at a scripted room (room_scene() in LiDAR_TFluna.c):
+side walls 250 cm away, a far wall at 350 cm and a 40 cm pillar ahead-left. The filtered
+frames it writes to stdout must decode without CRC errors, come one per half-sweep in
+order, and draw that room: the points are compared with the same room traced here.
+
+Usage: python test_sim_run.py <path to the LiDAR_TFluna host executable>
+"""
+
+import math
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from scan_frame import GridFrame, ScanFrameDecoder  # noqa: E402
+
+# The room of LiDAR_TFluna.c, in cm
+ROOM_HALF_WIDTH = 250
+ROOM_DEPTH = 350
+PILLAR = (-100, 130, -60, 170)  # x0, y0, x1, y1
+RANGE_CM = 800
+
+SECONDS = 9    # Virtual run time: four sweeps of 2 s and the start-up
+TOLERANCE = 3  # cm between a filtered point and the room
+
+checks = 0
+failures = 0
+
+def check(cond, what):
+    """@brief Counts a check and reports it on stderr if it failed."""
+    global checks, failures
+    checks += 1
+    if not cond:
+        failures += 1
+        print(f"test_sim_run.py: {what} failed", file=sys.stderr)
+
+def room(deg):
+    """@brief Distance to the room along an angle, or 0 for no return."""
+    dx, dy = math.cos(math.radians(deg)), math.sin(math.radians(deg))
+    d = RANGE_CM
+    if abs(dx) > 1e-9:
+        d = min(d, ROOM_HALF_WIDTH / abs(dx))
+    if dy > 1e-9:
+        d = min(d, ROOM_DEPTH / dy)
+    tmin, tmax = 0.0, float(RANGE_CM)
+    for lo, hi, v in ((PILLAR[0], PILLAR[2], dx), (PILLAR[1], PILLAR[3], dy)):
+        if abs(v) < 1e-9:
+            if not lo <= 0 <= hi:
+                tmax = -1.0
+            continue
+        t0, t1 = lo / v, hi / v
+        tmin, tmax = max(tmin, min(t0, t1)), min(tmax, max(t0, t1))
+    if tmin <= tmax:
+        d = min(d, tmin)
+    return 0 if d >= RANGE_CM else d
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: python test_sim_run.py <LiDAR_TFluna>")
+        return 2
+    env = dict(os.environ, HAL_SIM_SECONDS=str(SECONDS))
+    run = subprocess.run([sys.argv[1]], env=env, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                         timeout=60)
+    check(run.returncode == 0, "exit status")
+
+    decoder = ScanFrameDecoder()
+    frames = decoder.feed(run.stdout)
+    check(decoder.crc_errors == 0, "no CRC errors")
+    check(not any(isinstance(f, GridFrame) for f in frames), "filtered points only by default")
+
+    # Two sectors per 2 s pass, 0-90 then 91-180 going out and the other way back; the
+    # sector being swept when the run ends is not sent
+    check(len(frames) == SECONDS - 1, f"frame count {len(frames)}")
+    for i, f in enumerate(frames):
+        check(f.sweep == i // 2, f"sweep number of frame {i}")
+        check(f.start_cdeg == (0 if (i % 4) in (0, 3) else 9100), f"sector of frame {i}")
+
+    # Each bin holds the median of the points that fell in it, from a degree either side
+    # at most, so where the room changes fast (corners, the pillar's edges) a point may be
+    # anywhere between the distances seen over those two degrees
+    points = bad = 0
+    for f in frames:
+        for deg, (d, q) in zip(f.angles(), f.points):
+            if not q:
+                continue
+            points += 1
+            near = [room(deg + k / 10) for k in range(-10, 11)]
+            bad += not min(near) - TOLERANCE <= d <= max(near) + TOLERANCE
+    check(points >= 0.98 * sum(len(f.points) for f in frames), f"valid points {points}")
+    check(bad == 0, f"{bad} points off the room")
+
+    print(f"sim_run.py: {checks} checks, {failures} failed")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
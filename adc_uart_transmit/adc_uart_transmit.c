@@ -4,30 +4,48 @@
  *
  * This program initializes the ADC and UART peripherals on the RP2040 MCU.
  * It reads analog values from a specified ADC pin, converts them to digital,
- * and transmits the raw ADC value over UART. The transmitted data can be used
- * for debugging or monitoring purposes.
+ * and transmits the raw ADC values over UART as binary frames (see sample_frame.h).
+ * The transmitted data can be used for debugging or monitoring purposes.
+ *
+ * The peripherals are reached through libs/hal, so with HAL_HOST the program runs as a Linux
+ * executable on the HAL simulator (set HAL_SIM_UART1 to a file to keep the frames).
  *
  * @author Adrián Silva Palafox
  * @date 2025-02-20
  */
 
 #include <stdio.h>
-#include "pico/stdlib.h"
-#include "hardware/uart.h"
-#include "hardware/adc.h"
+#include "hal.h"
+#include "sample_frame.h"
+#include "fixed_filter.h"
+#include "build_config.h"
 
 // PINOUTS MCU
-#define ADC_PIN 26     ///< ADC input pin to be used.
 #define UART0_TX_PIN 0 ///< UART0 TX pin.
 #define UART1_TX_PIN 8 ///< UART1 TX pin.
 
 // UART PARAMS
-#define BAUD_RATE 115200 ///< UART baud rate in bits per second.
+#define BAUD_RATE CFG_LINK_BAUD ///< UART baud rate in bits per second (build parameter).
+
+// SAMPLING PARAMS, set in CMakeLists.txt and generated into build_config.h
+#define ADC_INPUT 0                             ///< ADC input connected to ADC_PIN (GPIO26).
+#define SAMPLE_PERIOD_US CFG_SAMPLE_PERIOD_US   ///< Time between ADC readings in microseconds.
+#define FRAME_SAMPLES CFG_BLOCK_LENGTH          ///< Samples per binary frame.
+
+// One frame and one debug line every REPORT_PERIOD_MS (CMakeLists.txt, 500 ms by default,
+// the cadence at which the original firmware sent its single readings)
+_Static_assert((uint64_t)FRAME_SAMPLES * SAMPLE_PERIOD_US == (uint64_t)REPORT_PERIOD_MS * 1000u,
+               "A frame must span exactly REPORT_PERIOD_MS");
 
 // GLOBAL
-const float conversion_factor = 3.3f / (1 << 12); ///< Conversion factor for 12-bit ADC.
 volatile uint16_t adc_value;                      ///< Variable to store the raw ADC value.
-char buffer[10];                                  ///< Buffer for storing the string to be transmitted over UART.
+uint16_t samples[FRAME_SAMPLES];                  ///< Samples waiting to be sent.
+uint8_t frame[SAMPLE_FRAME_RAW12_LEN(FRAME_SAMPLES)]; ///< Encoded frame transmitted over UART1.
+
+// 2nd-order Butterworth low-pass designed for the sample rate (cfg_smoothing_sos in build_config.c)
+biquad_state_q15_t smoothing_state[CFG_SMOOTHING_SECTIONS]; ///< Filter state, persists across frames.
+biquad_cascade_q15_t smoothing;        ///< Noise filter applied to each frame.
+q15_t filtered[FRAME_SAMPLES];         ///< Working buffer for the filter.
 
 /**
  * @brief Main function of the program.
@@ -40,38 +58,48 @@ char buffer[10];                                  ///< Buffer for storing the st
 int main()
 {
     // Initialize stdio for printf
-    stdio_init_all();
-    // Initialize UART0 and UART1 with the specified baud rate
-    uart_init(uart0, BAUD_RATE);
-    uart_init(uart1, BAUD_RATE);
-    // Initialize the ADC
-    adc_init();
+    hal_init();
+    // Initialize UART0 and UART1 with the specified baud rate, transmit pins only
+    hal_uart_init(0, BAUD_RATE, UART0_TX_PIN, -1);
+    hal_uart_init(1, BAUD_RATE, UART1_TX_PIN, -1);
 
-    // Set the GPIO pins for UART transmission
-    gpio_set_function(UART0_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(UART1_TX_PIN, GPIO_FUNC_UART);
+    // ADC configuration: input 0 (GPIO26)
+    hal_adc_init(ADC_INPUT);
 
-    // ADC configuration
-    // Initialize the GPIO pin for ADC functionality
-    adc_gpio_init(ADC_PIN);
-    // Select the ADC input channel (0 for GPIO26)
-    adc_select_input(0);
+    // Noise filter for the samples
+    biquad_cascade_q15_init(&smoothing, cfg_smoothing_sos, smoothing_state, CFG_SMOOTHING_SECTIONS);
 
     // Infinite loop to continuously read and transmit data
+    uint16_t frame_seq = 0;
+    uint64_t next_us = hal_time_us();
     while (true)
     {
-        // Read the ADC value and clear the last 4 bits to reduce noise
-        adc_value = adc_read() & 0xFFF0;
+        for (unsigned i = 0; i < FRAME_SAMPLES; i++)
+        {
+            // Read the full 12-bit ADC value; noise is removed by the filter below
+            adc_value = hal_adc_read();
+            samples[i] = adc_value;
+
+            // Wait for the next reading, counted from the previous deadline so the time spent
+            // converting, filtering and transmitting does not stretch the frame period
+            next_us += SAMPLE_PERIOD_US;
+            uint64_t now_us = hal_time_us();
+            if (next_us > now_us)
+            {
+                hal_sleep_us(next_us - now_us);
+            }
+        }
 
-        // Print the raw ADC value and the calculated voltage to the console for debugging
-        printf("Raw value: 0x%03x, voltage: %02fV\n", adc_value, adc_value * conversion_factor);
+        // Low-pass filter the frame instead of throwing away the 4 LSBs
+        q15_from_adc12(samples, filtered, FRAME_SAMPLES);
+        biquad_cascade_q15_process(&smoothing, filtered, filtered, FRAME_SAMPLES);
+        q15_to_adc12(filtered, samples, FRAME_SAMPLES);
 
-        // Format the ADC value as a hexadecimal string and store it in the buffer
-        sprintf(buffer, "0x%03x\n", adc_value);
-        // Transmit the buffer content over UART1
-        uart_puts(uart1, buffer);
+        // Print the last raw ADC value and the calculated voltage to the console for debugging
+        printf("Raw value: 0x%03x, voltage: %lumV\n", adc_value, (unsigned long)CFG_ADC_TO_MV(adc_value));
 
-        // Wait for 500 milliseconds before the next reading
-        sleep_ms(500);
+        // Pack the samples into a binary frame and transmit it over UART1
+        size_t len = sample_frame_encode12(frame, sizeof(frame), ADC_INPUT, frame_seq++, samples, FRAME_SAMPLES);
+        hal_uart_write(1, frame, len);
     }
 }
@@ -0,0 +1,115 @@
+"""
+Captures a pipeline_bench JSON report from a board's serial port and stores it.
+
+The RP2040 build prints its report over USB-CDC when the run ends, about 23 seconds after
+reset, and then again every 10 seconds, so the port can be opened at any time. Boot text
+and partial reports around it are skipped. The report is checked before it is written: it
+must come from the expected target, hold every pipeline of the baseline it will be compared
+with, and have no overruns unless --allow-overruns is given.
+
+Usage:
+    python bench_capture.py --port /dev/ttyACM0 -o report.json
+    python bench_capture.py --log minicom.cap -o report.json
+
+--log reads a terminal capture instead of the port. pyserial is needed for --port only.
+"""
+
+import argparse
+import json
+import sys
+import time
+
+REPORT_START = '{"target"'
+
+
+def find_report(text):
+    """Returns the last complete report in a stream of text, or None."""
+    decoder = json.JSONDecoder()
+    report = None
+    pos = text.find(REPORT_START)
+    while pos >= 0:
+        try:
+            report, end = decoder.raw_decode(text, pos)
+        except ValueError:
+            # Cut off by the end of the capture, or by a reset
+            end = pos + 1
+        pos = text.find(REPORT_START, end)
+    return report
+
+
+def check_report(report, target, reference, allow_overruns):
+    """Returns a list of reasons the report cannot be used as a baseline."""
+    problems = []
+    if report.get('target') != target:
+        problems.append('report is from %s, expected %s' % (report.get('target'), target))
+    names = [p['name'] for p in report.get('pipelines', [])]
+    if reference is not None:
+        missing = [p['name'] for p in reference['pipelines'] if p['name'] not in names]
+        if missing:
+            problems.append('pipelines missing: %s' % ', '.join(missing))
+    if not allow_overruns:
+        late = [p['name'] for p in report.get('pipelines', []) if p['overruns']]
+        if late:
+            problems.append('overruns in: %s' % ', '.join(late))
+    return problems
+
+
+def read_port(port, timeout):
+    """Reads the port until a complete report has arrived, or the timeout."""
+    import serial
+
+    text = ''
+    deadline = time.monotonic() + timeout
+    with serial.Serial(port, 115200, timeout=0.5) as link:
+        while time.monotonic() < deadline:
+            text += link.read(4096).decode('ascii', errors='replace')
+            report = find_report(text)
+            if report is not None:
+                return report
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Store a pipeline_bench report from a board.')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='serial port of the board, e.g. /dev/ttyACM0')
+    source.add_argument('--log', help='text captured from the port')
+    parser.add_argument('-o', '--output', required=True, help='report file to write')
+    parser.add_argument('--target', default='rp2040', help='target the report must come from')
+    parser.add_argument('--reference', default='baseline_host.json',
+                        help='baseline whose pipelines the report must all have ("" for none)')
+    parser.add_argument('--timeout', type=float, default=60.0, help='seconds to wait on the port')
+    parser.add_argument('--allow-overruns', action='store_true', help='store a report with overruns')
+    args = parser.parse_args()
+
+    if args.port:
+        report = read_port(args.port, args.timeout)
+    else:
+        with open(args.log, errors='replace') as f:
+            report = find_report(f.read())
+    if report is None:
+        print('no complete report found')
+        return 1
+
+    reference = None
+    if args.reference:
+        with open(args.reference) as f:
+            reference = json.load(f)
+    problems = check_report(report, args.target, reference, args.allow_overruns)
+    for problem in problems:
+        print(problem)
+    if problems:
+        return 1
+
+    # One pipeline per line, as pipeline_bench prints it, so baselines diff well
+    with open(args.output, 'w') as f:
+        f.write('{"target":%s,"counter_hz":%d,"pipelines":[\n' % (json.dumps(report['target']), report['counter_hz']))
+        f.write(',\n'.join(json.dumps(p, separators=(',', ':')) for p in report['pipelines']))
+        f.write('\n]}\n')
+    print('%s: %d pipelines from %s at %d counts/s' % (args.output, len(report['pipelines']), report['target'],
+                                                     report['counter_hz']))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
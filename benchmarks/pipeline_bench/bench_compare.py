@@ -0,0 +1,86 @@
+"""
+Compares a pipeline_bench JSON report with a baseline and flags regressions.
+
+The counts that do not depend on the speed of the machine (blocks, samples, bytes, overruns)
+must match exactly. The timings may get worse by at most the tolerance: per-stage mean cost,
+worst-case latency and capacity (samples per second of busy time). Improvements are listed
+but never fail the check; store a new baseline when they are expected.
+
+Both reports must come from the same target: host costs are nanoseconds of host CPU time,
+RP2040 costs are clk_sys cycles.
+
+Usage:
+    python bench_compare.py baseline_host.json report.json [--tolerance 25]
+
+The exit status is 1 if anything regressed.
+"""
+
+import argparse
+import json
+import sys
+
+EXACT_FIELDS = ('blocks', 'samples', 'bytes', 'overruns')
+
+
+def change_pct(base, new):
+    """Relative change from base to new, in percent."""
+    if base == 0:
+        return 0.0 if new == 0 else float('inf')
+    return 100.0 * (new - base) / base
+
+
+def compare(baseline, report, tolerance):
+    """Returns a list of (pipeline, metric, base, new, change %, regressed) rows."""
+    rows = []
+    if baseline['target'] != report['target']:
+        raise ValueError('baseline is from %s, report from %s' % (baseline['target'], report['target']))
+
+    base_pipes = {p['name']: p for p in baseline['pipelines']}
+    for pipe in report['pipelines']:
+        base = base_pipes.get(pipe['name'])
+        if base is None:
+            continue
+
+        for field in EXACT_FIELDS:
+            if pipe[field] != base[field]:
+                rows.append((pipe['name'], field, base[field], pipe[field], change_pct(base[field], pipe[field]), True))
+
+        # Lower is better
+        metrics = [('latency_max_us', base['latency_us']['max'], pipe['latency_us']['max'])]
+        base_stages = {s['name']: s for s in base['stages']}
+        for stage in pipe['stages']:
+            if stage['name'] in base_stages:
+                metrics.append((stage['name'] + '.mean', base_stages[stage['name']]['mean'], stage['mean']))
+        for name, old, new in metrics:
+            change = change_pct(old, new)
+            rows.append((pipe['name'], name, old, new, change, change > tolerance))
+
+        # Higher is better
+        change = change_pct(base['capacity_sps'], pipe['capacity_sps'])
+        rows.append((pipe['name'], 'capacity_sps', base['capacity_sps'], pipe['capacity_sps'], change,
+                     -change > tolerance))
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare a pipeline_bench report with a baseline.')
+    parser.add_argument('baseline', help='baseline JSON report')
+    parser.add_argument('report', help='new JSON report')
+    parser.add_argument('--tolerance', type=float, default=25.0, help='allowed slowdown in percent')
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.report) as f:
+        report = json.load(f)
+
+    rows = compare(baseline, report, args.tolerance)
+    for pipe, metric, old, new, change, regressed in rows:
+        print('%-14s %-18s %12s %12s %+8.1f%% %s' % (pipe, metric, old, new, change, 'REGRESSED' if regressed else ''))
+    failed = [r for r in rows if r[5]]
+    print('%d regression(s)' % len(failed))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,106 @@
+"""
+Checks that a pipeline of a pipeline_bench report keeps up with its input in real time.
+
+The pipeline must have no overruns, must have processed at least 99% of its input rate over
+the run (sustained_sps), and must have a capacity (samples per second of busy time) at or
+above the input rate. The default pipeline is os_cic50: DSP_pract1's CIC decimator on the
+ADC's full 500 kS/s.
+
+The headroom is also worked out from the mean stage costs: a block's busy time is its
+processing plus the time its frame spends on the wire, and the processing could take
+`slowdown` times longer before the block no longer fits in its period. --min-slowdown sets
+how much must be left. Means over all blocks are used, so a host run is not failed by one
+time slice lost to another process.
+
+The report can come from a board (bench_capture.py) or from a host run. With --run the host
+build is started here; --cpu-scale charges every stage at that multiple of its host CPU time
+(BENCH_CPU_SCALE). Only a board report says how much headroom the RP2040 has.
+
+Usage:
+    python bench_realtime.py report.json [--pipeline os_cic50] [--min-slowdown 2]
+    python bench_realtime.py --run build-host/pipeline_bench --min-slowdown 25
+
+The exit status is 1 if the pipeline does not keep up.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+MIN_SUSTAINED = 0.99  # Share of the input rate that must be processed over the run
+
+
+def slowdown(pipe):
+    """How many times longer the processing of a block could take before the block no longer
+    fits in its period: (period - wire time) / processing time, from the mean stage costs."""
+    period_us = 1e6 * pipe['block_samples'] / pipe['sample_rate_hz']
+    busy_us = pipe['busy_us'] / pipe['blocks']
+    cpu_us = sum(stage['mean_ns'] for stage in pipe['stages']) / 1000.0
+    return (period_us - (busy_us - cpu_us)) / cpu_us
+
+
+def check_pipeline(report, name, min_slowdown, scale):
+    """Returns the pipeline and a list of reasons it does not keep up."""
+    pipes = {p['name']: p for p in report['pipelines']}
+    if name not in pipes:
+        return None, ['no pipeline %s in the report' % name]
+    pipe = pipes[name]
+    rate = pipe['sample_rate_hz']
+
+    # The stage means are host CPU time; their busy time was charged at scale times that
+    pipe = dict(pipe, stages=[dict(s, mean_ns=scale * s['mean_ns']) for s in pipe['stages']])
+
+    problems = []
+    if slowdown(pipe) < min_slowdown:
+        problems.append('processing can only get %.1fx slower, %.1fx required' % (slowdown(pipe), min_slowdown))
+    if pipe['overruns']:
+        problems.append('%d overruns' % pipe['overruns'])
+    if pipe['sustained_sps'] < MIN_SUSTAINED * rate:
+        problems.append('sustained %d S/s of %d' % (pipe['sustained_sps'], rate))
+    if pipe['capacity_sps'] < rate:
+        problems.append('capacity %d S/s below the input rate %d' % (pipe['capacity_sps'], rate))
+    return pipe, problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check that a benchmarked pipeline runs in real time.')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('report', nargs='?', help='pipeline_bench JSON report')
+    source.add_argument('--run', help='host pipeline_bench executable to run')
+    parser.add_argument('--cpu-scale', type=float, default=1.0,
+                        help='with --run, multiple of the host CPU time charged to each stage')
+    parser.add_argument('--pipeline', default='os_cic50', help='pipeline to check')
+    parser.add_argument('--min-slowdown', type=float, default=1.0,
+                        help='how many times slower the processing must be able to get')
+    args = parser.parse_args()
+
+    if args.run:
+        env = dict(os.environ, BENCH_CPU_SCALE=str(args.cpu_scale))
+        out = subprocess.run([args.run], env=env, stdout=subprocess.PIPE, check=True, timeout=300).stdout
+        report = json.loads(out)
+    else:
+        with open(args.report) as f:
+            report = json.load(f)
+
+    scale = args.cpu_scale if args.run else 1.0
+    pipe, problems = check_pipeline(report, args.pipeline, args.min_slowdown, scale)
+    if pipe is not None:
+        rate = pipe['sample_rate_hz']
+        print('%s on %s%s: %d S/s in, capacity %d S/s (%.2fx), %.1f%% idle, %d overruns, '
+              'processing could get %.1fx slower' % (
+                  pipe['name'], report['target'], ' at %gx CPU cost' % scale if scale != 1.0 else '', rate,
+                  pipe['capacity_sps'], pipe['capacity_sps'] / rate, pipe['idle_pct'], pipe['overruns'],
+                  slowdown(pipe)))
+        for stage in pipe['stages']:
+            ns = stage['mean_ns'] / pipe['block_samples']
+            print('  %-10s %8.2f ns per input sample (%.1f%% of the %.0f ns between samples)' % (
+                stage['name'], ns, 100.0 * ns * rate / 1e9, 1e9 / rate))
+    for problem in problems:
+        print(problem)
+    return 1 if problems else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,593 @@
+/**
+ * @file pipeline_bench.c
+ * @brief End-to-end benchmark of the signal_adq and digital_modulators block pipelines.
+ *
+ * Each pipeline runs the same stage code as its firmware on blocks that arrive at the
+ * firmware's sample rate, and reports per-stage costs, the sustained and the attainable
+ * sample rate, the worst ready-to-sent latency and the idle share of the processor as one
+ * JSON object on stdout (see bench.h):
+ *
+ * - adq_raw, adq_filter, adq_spectrum: signal_adq with OUTPUT_RAW, with LOWPASS_FILTER and
+ *   with OUTPUT_SPECTRUM. Stages: acquire (de-interleave the DMA half into the channel ring
+ *   and read a block back), filter (31-tap Q15 FIR), spectrum (windowed 1024-point Q15 FFT
+ *   and magnitudes), format (RAW12 or SPECTRUM16 frame), transmit (frame to the link UART).
+ * - mod_linear8, mod_ulaw: digital_modulators with PCM_LINEAR8 and PCM_ULAW. Stages:
+ *   modulate (the PWM, PPM and PAM frame words of every sample queued into their rings),
+ *   carrier (the DDS levels the PWM-DAC plays during one block), format (PCM encoding),
+ *   transmit (block to UART1).
+ * - os_cic50: DSP_pract1, the ADC at its full 500 kS/s decimated by 50. Stages: decimate
+ *   (4th-order CIC and 15-tap compensation FIR, oversample_process()), format (RAW16 frame),
+ *   transmit (frame to the link UART). Its capacity_sps against the 500 kS/s input is the
+ *   real-time headroom of the oversampling stage.
+ * - fft_256, fft_512, fft_1024, fft_2048: the Q15 FFT alone at each length, on blocks of
+ *   that length at 50 kS/s. Stages: window (ADC counts to Q15, Hann window, real to
+ *   complex), fft (fft_q15_forward()), magnitude. Nothing is transmitted; capacity_sps over
+ *   the length is the number of transforms per second the processor can do.
+ * - pcm_linear4, pcm_linear8, pcm_linear12, pcm_ulaw, pcm_alaw: pcm_encode() alone on
+ *   1024-sample blocks at 500 kS/s, one stage (encode). Nothing is transmitted;
+ *   capacity_sps is the encoder's throughput in samples per second.
+ *
+ * The ADC and its DMA are replaced by a fixed test signal, so every build processes the same
+ * samples; in the firmware they cost no CPU time. Blocks are paced by the HAL clock: block k
+ * is ready (k + 1) block periods after the start, and a block whose processing has not
+ * started one period later would have been overwritten by the DMA and counts as an overrun.
+ * Everything runs on one core, one stage after the other, and the transmit stage is a
+ * blocking UART write, where signal_adq hands the block to core1 and digital_modulators to
+ * a DMA channel. The latency and idle figures are therefore those of a single core doing
+ * all the work.
+ *
+ * Stage costs come from hal_cycles(). On the RP2040 they are clk_sys cycles, counted by
+ * SysTick, and a stage must finish within one SysTick wrap (134 ms at 125 MHz). On the host
+ * (HAL_HOST) they are nanoseconds of host CPU time, and since the simulator's clock does not
+ * move while code runs, each stage's time is charged to it, multiplied by BENCH_CPU_SCALE
+ * (environment, default 1) to model a slower or faster processor; the transfers take their
+ * wire time at the configured baud rate as usual.
+ *
+ * Baseline results are kept next to this file and compared with bench_compare.py.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "hal.h"
+#include "bench.h"
+#include "adc_deinterleave.h"
+#include "fixed_filter.h"
+#include "fft_q15.h"
+#include "sample_frame.h"
+#include "pcm_codec.h"
+#include "pulse_model.h"
+#include "dds.h"
+#ifdef HAL_HOST
+#include "hal_sim.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define US_PER_S 1000000u
+#define REPORT_REPEAT_US 10000000u ///< Time between repeats of the report on the RP2040.
+
+// Test signal: a tone with a little noise around mid-scale, like the ADC would see
+#define TEST_TONE_HZ 250u     ///< Tone frequency.
+#define TEST_AMPLITUDE 1500.0 ///< Tone amplitude, ADC counts.
+#define TEST_NOISE 16u        ///< Peak-to-peak noise, ADC counts.
+
+// signal_adq configuration (DSP/signal_adq/signal_adq.c)
+#define ADQ_CHANNEL_MASK 0x01u  ///< ADC inputs captured.
+#define ADQ_BLOCK_LENGTH 1024u  ///< Samples per block and per frame.
+#define ADQ_SAMPLE_RATE_HZ 5000u ///< Sample rate of the channel.
+#define ADQ_RING_LENGTH (2u * ADQ_BLOCK_LENGTH) ///< Channel ring length.
+#define ADQ_BLOCKS 20u          ///< Blocks per run (4.1 s).
+#define ADQ_LINK_UART 0u        ///< UART of the frame link.
+#define ADQ_LINK_TX_PIN 0u      ///< Its TX pin.
+#define ADQ_LINK_BAUD 921600u   ///< Its baud rate.
+
+// digital_modulators configuration (telecomms/digital_modulators/digital_modulators.c)
+#define MOD_SAMPLE_RATE_HZ 10000u ///< PCM sample rate.
+#define MOD_BLOCK_LENGTH 64u      ///< Samples per block.
+#define MOD_BLOCKS 500u           ///< Blocks per run (3.2 s).
+#define MOD_PCM_UART 1u           ///< UART of the PCM stream.
+#define MOD_PCM_TX_PIN 8u         ///< Its TX pin.
+#define MOD_PCM_BAUD 921600u      ///< Its baud rate.
+#define MOD_SYS_HZ 125000000u     ///< clk_sys the PIO timing is computed for.
+#define MOD_FRAME_HZ 10000u       ///< PWM/PPM/PAM frames per second, one per sample.
+#define MOD_PULSE_NS 2000u        ///< PPM/PAM pulse width.
+#define MOD_PAM_BITS 4u           ///< PAM ladder resolution.
+#define MOD_PULSE_RING 128u       ///< Frame words per ring (PULSE_OUT_RING_LEN).
+#define MOD_CARRIER_TOP 255u      ///< PWM-DAC wrap.
+#define MOD_CARRIER_RATE_MHZ 488281250u ///< PWM-DAC sample rate, clk_sys / 256, in mHz.
+#define MOD_CARRIER_MHZ 10000000u ///< Carrier frequency in mHz (10 kHz).
+#define MOD_CARRIER_BLOCK 256u    ///< Levels per DMA block of the carrier.
+#define MOD_PCM_MAX_BYTES ((MOD_BLOCK_LENGTH * 3u + 1u) / 2u) ///< Largest encoded block.
+
+// DSP_pract1 configuration (DSP/DSP_pract1/DSP_pract1.c)
+#define OS_FACTOR 50u             ///< CIC decimation factor (OVERSAMPLING).
+#define OS_INPUT_RATE_HZ 500000u  ///< ADC conversion rate.
+#define OS_FRAME_SAMPLES 64u      ///< Output samples per frame.
+#define OS_BLOCK_LENGTH (OS_FRAME_SAMPLES * OS_FACTOR) ///< Conversions per ping-pong half.
+#define OS_BLOCKS 500u            ///< Blocks per run (3.2 s).
+#define OS_LINK_BAUD 460800u      ///< LINK_BAUD.
+#define OS_COMP_TAPS 15u          ///< Compensation FIR taps.
+
+// FFT throughput runs
+#define FFT_SAMPLE_RATE_HZ 50000u ///< Rate the blocks arrive at.
+#define FFT_BLOCKS 20u            ///< Blocks per run and length.
+#define FFT_MIN_LOG2 8u           ///< Shortest length measured (256).
+#define FFT_LENGTHS 4u            ///< Lengths measured: 256 to 2048.
+
+// PCM encoder throughput runs, on the DSP_pract1 input
+#define PCM_BLOCK_LENGTH 1024u    ///< Samples per block.
+#define PCM_BLOCKS 200u           ///< Blocks per run and format (0.4 s).
+#define PCM_FORMATS 5u            ///< PCM_LINEAR4 to PCM_ALAW.
+
+#define NUM_PIPELINES (6u + FFT_LENGTHS + PCM_FORMATS)
+
+// signal_adq modes
+typedef enum adq_mode
+{
+    ADQ_RAW = 0,
+    ADQ_FILTER,
+    ADQ_SPECTRUM,
+} adq_mode_t;
+
+/**
+ * @brief Processes one block and returns the bytes it transmitted.
+ */
+typedef size_t (*block_fn_t)(bench_pipeline_t *p, const uint16_t *block, uint32_t seq);
+
+static uint16_t test_signal[2 * ADQ_BLOCK_LENGTH]; ///< Both halves of the simulated DMA buffer.
+static uint16_t os_signal[2 * OS_BLOCK_LENGTH];   ///< The same tone sampled at OS_INPUT_RATE_HZ, also for pcm_*.
+static uint16_t fft_signal[2 * FFT_Q15_MAX_N];    ///< The same tone sampled at FFT_SAMPLE_RATE_HZ.
+static bench_pipeline_t pipelines[NUM_PIPELINES]; ///< Results.
+static double cpu_scale = 1.0;                   ///< Host CPU time charged per ns (HAL_HOST).
+
+// signal_adq state
+static const q15_t lowpass_taps[31] = {
+    0, -64, -57, 86, 210, 0, -439, -378,
+    516, 1130, 0, -2107, -1868, 2949, 9839, 13132,
+    9839, 2949, -1868, -2107, 0, 1130, 516, -378,
+    -439, 0, 210, 86, -57, -64, 0,
+};
+static q15_t lowpass_state[2 * 31];            ///< FIR delay line.
+static fir_q15_t lowpass;                      ///< Low-pass filter.
+static uint16_t channel_storage[ADQ_RING_LENGTH]; ///< Channel ring storage.
+static sample_ring_t channel_ring;             ///< De-interleaved samples.
+static adc_deinterleaver_t deinterleaver;      ///< Splits the DMA stream per channel.
+static uint16_t adq_block[ADQ_BLOCK_LENGTH];   ///< Block read back from the ring.
+static q15_t fft_buffer[2 * FFT_Q15_MAX_N];    ///< Complex FFT work area, also used by the fft_* runs.
+static uint16_t spectrum[FFT_Q15_MAX_N / 2];   ///< Magnitude spectrum.
+static uint8_t tx_frame[SAMPLE_FRAME_RAW12_LEN(ADQ_BLOCK_LENGTH)]; ///< Frame being sent.
+static adq_mode_t adq_mode;                    ///< Mode of the current run.
+
+// digital_modulators state
+static pulse_config_t pulse_cfg;                 ///< PPM/PAM timing.
+static pulse_config_t pwm_cfg;                   ///< PWM timing.
+static uint32_t pwm_words[MOD_PULSE_RING];       ///< PWM frame words (read by DMA in the firmware).
+static uint32_t ppm_words[MOD_PULSE_RING];       ///< PPM frame words.
+static uint32_t pam_words[MOD_PULSE_RING];       ///< PAM frame words.
+static pulse_ring_t pwm_ring;                    ///< PWM sample ring.
+static pulse_ring_t ppm_ring;                    ///< PPM sample ring.
+static pulse_ring_t pam_ring;                    ///< PAM sample ring.
+static dds_t carrier;                            ///< Carrier generator.
+static uint16_t carrier_buffer[MOD_CARRIER_BLOCK]; ///< Carrier DMA block.
+static uint64_t carrier_levels;                  ///< Carrier levels generated so far.
+static uint8_t pcm_buffer[MOD_PCM_MAX_BYTES];    ///< Encoded block.
+static pcm_format_t pcm_format;                  ///< Format of the current run.
+
+// DSP_pract1 state
+static const q15_t cic_comp_taps[OS_COMP_TAPS] = { ///< cfg_cic_comp_taps for OS_FACTOR.
+    141, -354, -120, 1968, -1573, -5481, 9794, 24017,
+    9794, -5481, -1573, 1968, -120, -354, 141,
+};
+static q15_t comp_state[2 * OS_COMP_TAPS];         ///< Compensation FIR delay line.
+static oversample_t oversampler;                   ///< CIC decimator + compensation FIR.
+static uint16_t os_samples[OS_FRAME_SAMPLES];      ///< Decimated frame.
+static uint8_t os_frame[SAMPLE_FRAME_WORDS16_LEN(OS_FRAME_SAMPLES)]; ///< Frame being sent.
+
+// FFT state
+static size_t fft_length;                          ///< Length of the current run.
+static char fft_names[FFT_LENGTHS][12];            ///< Pipeline names, fft_<length>.
+
+// PCM encoder state
+static uint8_t pcm_block_buffer[SAMPLE_FRAME_PACKED12_LEN(PCM_BLOCK_LENGTH)]; ///< Encoded block.
+static const char *const pcm_names[PCM_FORMATS] = { ///< Pipeline names, by pcm_format_t.
+    "pcm_linear4", "pcm_linear8", "pcm_linear12", "pcm_ulaw", "pcm_alaw",
+};
+
+/**
+ * @brief Fills a simulated DMA buffer with the test tone and noise.
+ *
+ * @param out Buffer.
+ * @param n Number of samples.
+ * @param rate_hz Sample rate the tone is computed for.
+ */
+static void make_test_signal(uint16_t *out, uint32_t n, uint32_t rate_hz)
+{
+    uint32_t rng = 0x2545F491u;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        double v = 2048.0 + TEST_AMPLITUDE * sin(2.0 * M_PI * TEST_TONE_HZ * i / rate_hz);
+        out[i] = (uint16_t)(v + (double)(rng % (TEST_NOISE + 1u)) - TEST_NOISE / 2.0);
+    }
+}
+
+/**
+ * @brief Records the cost of a stage started at t0.
+ */
+static void stage_end(bench_pipeline_t *p, int stage, uint32_t t0)
+{
+    uint32_t count = (hal_cycles() - t0) & HAL_CYCLES_MASK;
+    bench_stage_add(p, stage, count);
+#ifdef HAL_HOST
+    // The virtual clock does not move while code runs: charge the stage to it
+    hal_sim_advance_ns((uint64_t)(count * cpu_scale));
+#endif
+}
+
+/**
+ * @brief Feeds blocks to a pipeline at its sample rate and records each one.
+ */
+static void run_pipeline(bench_pipeline_t *p, block_fn_t fn, const uint16_t *signal, uint32_t blocks,
+                         uint32_t block_length)
+{
+    uint64_t block_us = (uint64_t)p->block_samples * US_PER_S / p->sample_rate_hz;
+
+    for (uint32_t k = 0; k < blocks; k++)
+    {
+        uint64_t ready = p->start_us + (k + 1u) * block_us;
+        uint64_t now = hal_time_us();
+        if (now < ready)
+        {
+            hal_sleep_us(ready - now);
+        }
+        else if (now >= ready + block_us)
+        {
+            // The DMA has started refilling this half
+            bench_overrun(p, 1);
+            continue;
+        }
+
+        uint64_t start = hal_time_us();
+        size_t bytes = fn(p, &signal[(k & 1u) * block_length], k);
+        bench_block_done(p, ready, start, hal_time_us(), bytes);
+    }
+    bench_finish(p, hal_time_us());
+}
+
+/**
+ * @brief Magnitude spectrum of adq_block into spectrum[], as signal_adq's compute_spectrum().
+ */
+static void compute_spectrum(void)
+{
+    q15_t *x = fft_buffer;
+    int32_t sum = 0;
+
+    q15_from_adc12(adq_block, x, ADQ_BLOCK_LENGTH);
+    for (size_t i = 0; i < ADQ_BLOCK_LENGTH; i++)
+    {
+        sum += x[i];
+    }
+    q15_t mean = (q15_t)(sum / (int32_t)ADQ_BLOCK_LENGTH);
+    for (size_t i = 0; i < ADQ_BLOCK_LENGTH; i++)
+    {
+        x[i] = q15_sat((int32_t)x[i] - mean);
+    }
+
+    fft_q15_window(x, ADQ_BLOCK_LENGTH, FFT_WINDOW_HANN);
+    fft_q15_load_real(fft_buffer, x, ADQ_BLOCK_LENGTH);
+    fft_q15_forward(fft_buffer, ADQ_BLOCK_LENGTH);
+    fft_q15_magnitude(fft_buffer, spectrum, ADQ_BLOCK_LENGTH / 2);
+}
+
+/**
+ * @brief One signal_adq block: acquire, optional filter or spectrum, format, transmit.
+ *
+ * Stage indices follow the order they were added in adq_start().
+ */
+static size_t adq_block_fn(bench_pipeline_t *p, const uint16_t *block, uint32_t seq)
+{
+    int stage = 0;
+    size_t len;
+
+    uint32_t t0 = hal_cycles();
+    adc_deinterleave(&deinterleaver, block, ADQ_BLOCK_LENGTH);
+    sample_ring_read(&channel_ring, adq_block, ADQ_BLOCK_LENGTH);
+    stage_end(p, stage++, t0);
+
+    if (adq_mode == ADQ_FILTER)
+    {
+        t0 = hal_cycles();
+        q15_t *q = (q15_t *)adq_block;
+        q15_from_adc12(adq_block, q, ADQ_BLOCK_LENGTH);
+        fir_q15_process(&lowpass, q, q, ADQ_BLOCK_LENGTH);
+        q15_to_adc12(q, adq_block, ADQ_BLOCK_LENGTH);
+        stage_end(p, stage++, t0);
+    }
+
+    if (adq_mode == ADQ_SPECTRUM)
+    {
+        t0 = hal_cycles();
+        compute_spectrum();
+        stage_end(p, stage++, t0);
+
+        t0 = hal_cycles();
+        len = sample_frame_encode16(tx_frame, sizeof(tx_frame), SAMPLE_FRAME_TYPE_SPECTRUM16, 0, (uint16_t)seq,
+                                    spectrum, ADQ_BLOCK_LENGTH / 2);
+        stage_end(p, stage++, t0);
+    }
+    else
+    {
+        t0 = hal_cycles();
+        len = sample_frame_encode12(tx_frame, sizeof(tx_frame), 0, (uint16_t)seq, adq_block, ADQ_BLOCK_LENGTH);
+        stage_end(p, stage++, t0);
+    }
+
+    t0 = hal_cycles();
+    hal_uart_write(ADQ_LINK_UART, tx_frame, len);
+    stage_end(p, stage, t0);
+    return len;
+}
+
+/**
+ * @brief Runs signal_adq in one mode.
+ */
+static void adq_run(bench_pipeline_t *p, const char *name, adq_mode_t mode)
+{
+    adq_mode = mode;
+    sample_ring_init(&channel_ring, channel_storage, ADQ_RING_LENGTH);
+    adc_deinterleaver_init(&deinterleaver, ADQ_CHANNEL_MASK, &channel_ring);
+    fir_q15_init(&lowpass, lowpass_taps, 31, lowpass_state);
+
+    bench_init(p, name, ADQ_SAMPLE_RATE_HZ, ADQ_BLOCK_LENGTH, hal_time_us());
+    bench_add_stage(p, "acquire");
+    if (mode == ADQ_FILTER)
+    {
+        bench_add_stage(p, "filter");
+    }
+    if (mode == ADQ_SPECTRUM)
+    {
+        bench_add_stage(p, "spectrum");
+    }
+    bench_add_stage(p, "format");
+    bench_add_stage(p, "transmit");
+    run_pipeline(p, adq_block_fn, test_signal, ADQ_BLOCKS, ADQ_BLOCK_LENGTH);
+}
+
+// digital_modulators stages
+enum
+{
+    MOD_STAGE_MODULATE = 0,
+    MOD_STAGE_CARRIER,
+    MOD_STAGE_FORMAT,
+    MOD_STAGE_TRANSMIT,
+};
+
+/**
+ * @brief One digital_modulators block: modulators, carrier refill, PCM encoding, transmit.
+ */
+static size_t mod_block_fn(bench_pipeline_t *p, const uint16_t *block, uint32_t seq)
+{
+    // Every sample of the block is queued, one frame each; the DMA has played one block of
+    // frames since the last one
+    uint32_t t0 = hal_cycles();
+    uint32_t next = (seq * MOD_BLOCK_LENGTH) & (MOD_PULSE_RING - 1u);
+    pulse_ring_queue(&pwm_ring, next, PULSE_MODE_PWM, &pwm_cfg, block, MOD_BLOCK_LENGTH);
+    pulse_ring_queue(&ppm_ring, next, PULSE_MODE_PPM, &pulse_cfg, block, MOD_BLOCK_LENGTH);
+    pulse_ring_queue(&pam_ring, next, PULSE_MODE_PAM, &pulse_cfg, block, MOD_BLOCK_LENGTH);
+    stage_end(p, MOD_STAGE_MODULATE, t0);
+
+    // The carrier DMA blocks that fell due while this block was captured
+    t0 = hal_cycles();
+    uint64_t due = (uint64_t)(seq + 1u) * MOD_BLOCK_LENGTH * MOD_CARRIER_RATE_MHZ / (MOD_SAMPLE_RATE_HZ * 1000ull);
+    while (carrier_levels + MOD_CARRIER_BLOCK <= due)
+    {
+        dds_fill(&carrier, carrier_buffer, MOD_CARRIER_BLOCK);
+        carrier_levels += MOD_CARRIER_BLOCK;
+    }
+    stage_end(p, MOD_STAGE_CARRIER, t0);
+
+    t0 = hal_cycles();
+    size_t len = pcm_encode(pcm_format, block, MOD_BLOCK_LENGTH, pcm_buffer);
+    stage_end(p, MOD_STAGE_FORMAT, t0);
+
+    t0 = hal_cycles();
+    hal_uart_write(MOD_PCM_UART, pcm_buffer, len);
+    stage_end(p, MOD_STAGE_TRANSMIT, t0);
+    return len;
+}
+
+/**
+ * @brief Runs digital_modulators with one PCM format.
+ */
+static void mod_run(bench_pipeline_t *p, const char *name, pcm_format_t format)
+{
+    pcm_format = format;
+    carrier_levels = 0;
+    dds_init(&carrier, MOD_CARRIER_RATE_MHZ, MOD_CARRIER_TOP, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&carrier, MOD_CARRIER_MHZ);
+    pulse_ring_init(&pwm_ring, pwm_words, MOD_PULSE_RING, pulse_word(PULSE_MODE_PWM, &pwm_cfg, 0));
+    pulse_ring_init(&ppm_ring, ppm_words, MOD_PULSE_RING, pulse_word(PULSE_MODE_PPM, &pulse_cfg, 0));
+    pulse_ring_init(&pam_ring, pam_words, MOD_PULSE_RING, pulse_word(PULSE_MODE_PAM, &pulse_cfg, 0));
+
+    bench_init(p, name, MOD_SAMPLE_RATE_HZ, MOD_BLOCK_LENGTH, hal_time_us());
+    bench_add_stage(p, "modulate");
+    bench_add_stage(p, "carrier");
+    bench_add_stage(p, "format");
+    bench_add_stage(p, "transmit");
+    run_pipeline(p, mod_block_fn, test_signal, MOD_BLOCKS, MOD_BLOCK_LENGTH);
+}
+
+// DSP_pract1 stages
+enum
+{
+    OS_STAGE_DECIMATE = 0,
+    OS_STAGE_FORMAT,
+    OS_STAGE_TRANSMIT,
+};
+
+/**
+ * @brief One DSP_pract1 block: decimate a ping-pong half to a frame, format, transmit.
+ */
+static size_t os_block_fn(bench_pipeline_t *p, const uint16_t *block, uint32_t seq)
+{
+    uint32_t t0 = hal_cycles();
+    size_t n = oversample_process(&oversampler, block, os_samples, OS_BLOCK_LENGTH);
+    stage_end(p, OS_STAGE_DECIMATE, t0);
+
+    t0 = hal_cycles();
+    size_t len = sample_frame_encode16(os_frame, sizeof(os_frame), SAMPLE_FRAME_TYPE_RAW16, 0, (uint16_t)seq,
+                                       os_samples, (uint16_t)n);
+    stage_end(p, OS_STAGE_FORMAT, t0);
+
+    t0 = hal_cycles();
+    hal_uart_write(ADQ_LINK_UART, os_frame, len);
+    stage_end(p, OS_STAGE_TRANSMIT, t0);
+    return len;
+}
+
+/**
+ * @brief Runs DSP_pract1's oversampling pipeline on the 500 kS/s input.
+ */
+static void os_run(bench_pipeline_t *p, const char *name)
+{
+    hal_uart_init(ADQ_LINK_UART, OS_LINK_BAUD, ADQ_LINK_TX_PIN, -1);
+    oversample_init(&oversampler, OS_FACTOR, cic_comp_taps, OS_COMP_TAPS, comp_state);
+
+    bench_init(p, name, OS_INPUT_RATE_HZ, OS_BLOCK_LENGTH, hal_time_us());
+    bench_add_stage(p, "decimate");
+    bench_add_stage(p, "format");
+    bench_add_stage(p, "transmit");
+    run_pipeline(p, os_block_fn, os_signal, OS_BLOCKS, OS_BLOCK_LENGTH);
+}
+
+// FFT stages
+enum
+{
+    FFT_STAGE_WINDOW = 0,
+    FFT_STAGE_FFT,
+    FFT_STAGE_MAGNITUDE,
+};
+
+/**
+ * @brief One FFT block: window, transform, magnitudes.
+ */
+static size_t fft_block_fn(bench_pipeline_t *p, const uint16_t *block, uint32_t seq)
+{
+    (void)seq;
+    uint32_t t0 = hal_cycles();
+    q15_from_adc12(block, fft_buffer, fft_length);
+    fft_q15_window(fft_buffer, fft_length, FFT_WINDOW_HANN);
+    fft_q15_load_real(fft_buffer, fft_buffer, fft_length);
+    stage_end(p, FFT_STAGE_WINDOW, t0);
+
+    t0 = hal_cycles();
+    fft_q15_forward(fft_buffer, fft_length);
+    stage_end(p, FFT_STAGE_FFT, t0);
+
+    t0 = hal_cycles();
+    fft_q15_magnitude(fft_buffer, spectrum, fft_length / 2);
+    stage_end(p, FFT_STAGE_MAGNITUDE, t0);
+    return 0;
+}
+
+/**
+ * @brief Runs the FFT alone at one length.
+ */
+static void fft_run(bench_pipeline_t *p, const char *name, size_t length)
+{
+    fft_length = length;
+    bench_init(p, name, FFT_SAMPLE_RATE_HZ, (uint32_t)length, hal_time_us());
+    bench_add_stage(p, "window");
+    bench_add_stage(p, "fft");
+    bench_add_stage(p, "magnitude");
+    run_pipeline(p, fft_block_fn, fft_signal, FFT_BLOCKS, (uint32_t)length);
+}
+
+/**
+ * @brief One PCM block: encode it in the current run's format.
+ */
+static size_t pcm_block_fn(bench_pipeline_t *p, const uint16_t *block, uint32_t seq)
+{
+    (void)seq;
+    uint32_t t0 = hal_cycles();
+    pcm_encode(pcm_format, block, PCM_BLOCK_LENGTH, pcm_block_buffer);
+    stage_end(p, 0, t0);
+    return 0;
+}
+
+/**
+ * @brief Runs the PCM encoder alone in one format.
+ */
+static void pcm_run(bench_pipeline_t *p, const char *name, pcm_format_t format)
+{
+    pcm_format = format;
+    bench_init(p, name, OS_INPUT_RATE_HZ, PCM_BLOCK_LENGTH, hal_time_us());
+    bench_add_stage(p, "encode");
+    run_pipeline(p, pcm_block_fn, os_signal, PCM_BLOCKS, PCM_BLOCK_LENGTH);
+}
+
+/**
+ * @brief Main function of the program.
+ *
+ * Runs every pipeline once and prints the JSON report; the RP2040 build then repeats it.
+ *
+ * @return int 0 on the host; does not return on the RP2040.
+ */
+int main()
+{
+    hal_init();
+#ifdef HAL_HOST
+    hal_sim_set_end(0, NULL, NULL);
+    const char *scale = getenv("BENCH_CPU_SCALE");
+    if (scale)
+    {
+        cpu_scale = atof(scale);
+    }
+    const char *target = "host";
+#else
+    // Time to open the USB serial port
+    hal_sleep_us(2000000);
+    const char *target = "rp2040";
+#endif
+
+    hal_uart_init(ADQ_LINK_UART, ADQ_LINK_BAUD, ADQ_LINK_TX_PIN, -1);
+    hal_uart_init(MOD_PCM_UART, MOD_PCM_BAUD, MOD_PCM_TX_PIN, -1);
+    pulse_pwm_timing(&pwm_cfg, MOD_SYS_HZ, MOD_FRAME_HZ);
+    pulse_timing(&pulse_cfg, MOD_SYS_HZ, MOD_FRAME_HZ, MOD_PULSE_NS, MOD_PAM_BITS);
+    make_test_signal(test_signal, 2 * ADQ_BLOCK_LENGTH, ADQ_SAMPLE_RATE_HZ);
+    make_test_signal(os_signal, 2 * OS_BLOCK_LENGTH, OS_INPUT_RATE_HZ);
+    make_test_signal(fft_signal, 2 * FFT_Q15_MAX_N, FFT_SAMPLE_RATE_HZ);
+
+    adq_run(&pipelines[0], "adq_raw", ADQ_RAW);
+    adq_run(&pipelines[1], "adq_filter", ADQ_FILTER);
+    adq_run(&pipelines[2], "adq_spectrum", ADQ_SPECTRUM);
+    mod_run(&pipelines[3], "mod_linear8", PCM_LINEAR8);
+    mod_run(&pipelines[4], "mod_ulaw", PCM_ULAW);
+    os_run(&pipelines[5], "os_cic50");
+    for (uint32_t i = 0; i < FFT_LENGTHS; i++)
+    {
+        size_t length = (size_t)1 << (FFT_MIN_LOG2 + i);
+        snprintf(fft_names[i], sizeof(fft_names[i]), "fft_%u", (unsigned)length);
+        fft_run(&pipelines[6 + i], fft_names[i], length);
+    }
+    for (uint32_t i = 0; i < PCM_FORMATS; i++)
+    {
+        pcm_run(&pipelines[6 + FFT_LENGTHS + i], pcm_names[i], (pcm_format_t)i);
+    }
+
+    bench_print_json(target, hal_cycles_hz(), pipelines, NUM_PIPELINES);
+#ifdef HAL_HOST
+    return 0;
+#else
+    // Again every REPORT_REPEAT_US, for a serial port opened after the run (bench_capture.py)
+    while (true)
+    {
+        hal_sleep_us(REPORT_REPEAT_US);
+        bench_print_json(target, hal_cycles_hz(), pipelines, NUM_PIPELINES);
+    }
+#endif
+}
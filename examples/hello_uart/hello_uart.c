@@ -1,128 +1,347 @@
 /**
  * @file hello_uart.c
- * @brief An interrupt-driven UART bridge for the RP2040.
+ * @brief An interrupt/DMA-driven UART bridge and Modbus-RTU gateway for the RP2040.
  *
  * This program configures two UART peripherals on the Raspberry Pi Pico
- * to act as a bridge, forwarding data between them. It uses interrupts
- * for receiving data, making the process efficient and non-blocking.
+ * to connect a host (the INTEL_N100 port) with an RS485 bus. It runs in one
+ * of two modes, chosen with MODBUS_GATEWAY:
+ *
+ * - Bridge (0): a transparent full-duplex bridge. Received bytes are read
+ *   from the UART FIFOs by interrupts into one ring buffer per direction,
+ *   and DMA channels send them out of the other side, so the bridge keeps
+ *   up with back-to-back traffic in both directions at 921600 baud without
+ *   dropping bytes (see libs/uart_bridge).
+ *
+ * - Modbus gateway (1): the Pico parses Modbus-RTU itself (see
+ *   libs/modbus). On the bus it is a master that polls the slaves in POLLS
+ *   and caches their registers. Towards the host it is a slave that answers
+ *   at once from its own register map (ADC, temperature and TF-Luna LiDAR
+ *   readings, plus settings) and from the cache, so the host never waits
+ *   for the bus.
+ *
+ * In both modes the RS485 side is half duplex: bytes for the bus are sent
+ * by a PIO state machine that also drives the transceiver's DE/RE pin,
+ * enabling the driver one bit before each frame and releasing the bus as
+ * the last stop bit ends (see libs/rs485). Replies are received by uart1.
+ *
+ * Counters and latencies are printed over USB serial once a second.
  *
  * @author Adrián Silva Palafox
  * @date October 2025
  */
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/uart.h"
-#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/adc.h"
+#include "hardware/i2c.h"
+#include "uart_bridge.h"
+#include "rs485.h"
+#include "modbus_port.h"
+#include "modbus_slave.h"
+#include "modbus_master.h"
+
+// Operating mode: 0 = transparent bridge, 1 = Modbus-RTU gateway
+#define MODBUS_GATEWAY 0
 
-// UART configuration
-#define BAUD_RATE 115200
-#define DATA_BITS 8
-#define STOP_BITS 1
-#define PARITY UART_PARITY_NONE
+// UART configuration (8 data bits, 1 stop bit, no parity)
+#define BAUD_RATE 921600
 
 // uart0 -- typically connected to a PC or another host
 #define INTEL_N100 uart0
 #define INTEL_N100_TX_PIN 1
 #define INTEL_N100_RX_PIN 0
 
-// uart1 -- can be connected to a peripheral, e.g., an RS485 transceiver
+// uart1 -- connected to an RS485 transceiver (TX on GPIO 20 is driven by PIO)
 #define RS485 uart1
 #define RS485_TX_PIN 20
 #define RS485_RX_PIN 21
+#define RS485_DE_PIN 22 // DE and /RE tied together, high = transmit
+#define RS485_PIO pio0
 
-// Function prototypes for the interrupt service routines
-void on_RS485_rx(void);
-void on_INTEL_N100_rx(void);
+// Bridge buffering and reporting
+#define RING_BYTES 4096      // Per direction: about 44 ms of traffic at 921600 baud
+#define STATS_PERIOD_MS 1000
+
+// Modbus gateway: the host talks to MODBUS_LOCAL_UNIT at BAUD_RATE, the bus runs at
+// MODBUS_BUS_BAUD (8N1, the PIO transmitter's format)
+#define MODBUS_LOCAL_UNIT 247
+#define MODBUS_BUS_BAUD 115200
+#define MODBUS_POLL_PERIOD_MS 100    // Default, holding register 0
+#define MODBUS_TIMEOUT_MS 50         // Default, holding register 1
+#define MODBUS_STALE_PERIODS 5       // Cache invalid after this many missed periods
+#define READ_PERIOD_MS 50            // Local readings refresh
+
+// TF-Luna LiDAR on I2C (optional; its registers read 0xFFFF while it does not answer)
+#define LIDAR_I2C i2c0
+#define LIDAR_SDA_PIN 4
+#define LIDAR_SCL_PIN 5
+#define LIDAR_ADDR 0x10
+#define LIDAR_TIMEOUT_US 2000
+
+static rs485_t rs485;
 
 /**
- * @brief Main function of the program.
- *
- * Initializes two UART peripherals, sets up their GPIOs, and configures
- * interrupts to handle byte reception. The main loop does nothing, as all
- * data forwarding is handled by the ISRs.
+ * @brief Prints the RS485 frame and reply latencies.
  */
-void main()
+static void print_rs485_stats(void)
 {
-    // Initialize stdio for debugging (e.g., via USB serial)
-    stdio_init_all();
+    rs485_stats_t bus;
+    rs485_get_stats(&rs485, &bus);
+    printf("RS485 frames %lu (last %lu us, max %lu us)  replies %lu (last %lu us, max %lu us)\n",
+           (unsigned long)bus.frames, (unsigned long)bus.last_frame_us, (unsigned long)bus.max_frame_us,
+           (unsigned long)bus.replies, (unsigned long)bus.last_reply_us, (unsigned long)bus.max_reply_us);
+}
+
+#if !MODBUS_GATEWAY
+
+static uint8_t ring_storage[2 * RING_BYTES];
+static uart_bridge_t bridge;
+
+/**
+ * @brief Prints the counters of one direction.
+ */
+static void print_stats(const char *name, const bridge_counters_t *s)
+{
+    printf("%-14s rx %10lu  tx %10lu  dma %8lu  overruns %lu  errors %lu  stalls %lu\n", name,
+           (unsigned long)s->rx_bytes, (unsigned long)s->tx_bytes, (unsigned long)s->tx_transfers,
+           (unsigned long)s->overruns, (unsigned long)s->errors, (unsigned long)s->stalls);
+}
+
+/**
+ * @brief Transparent bridge: all forwarding is done by the UART and DMA
+ * interrupts; the loop only reports the counters.
+ */
+static void run_bridge(void)
+{
+    const uart_bridge_port_t ports[2] = {
+        {INTEL_N100, INTEL_N100_TX_PIN, INTEL_N100_RX_PIN},
+        {RS485, RS485_TX_PIN, RS485_RX_PIN},
+    };
+    uart_bridge_init(&bridge, ports, BAUD_RATE, ring_storage, RING_BYTES);
 
-    // Initialize both UART instances with the specified baud rate
-    uart_init(RS485, BAUD_RATE);
-    uart_init(INTEL_N100, BAUD_RATE);
+    // Bytes for the bus go to the PIO transmitter, which switches DE/RE around them.
+    rs485_init(&rs485, RS485_PIO, RS485_TX_PIN, RS485_DE_PIN, RS485_RX_PIN, BAUD_RATE);
+    uart_bridge_set_tx_sink(&bridge, 0, rs485_tx_fifo(&rs485), rs485_tx_dreq(&rs485));
+    uart_bridge_start(&bridge);
 
-    // Set the GPIO pins to their UART function
-    gpio_set_function(RS485_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(RS485_RX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(INTEL_N100_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(INTEL_N100_RX_PIN, GPIO_FUNC_UART);
+    while (1)
+    {
+        sleep_ms(STATS_PERIOD_MS);
 
-    // Disable hardware flow control (CTS/RTS)
-    uart_set_hw_flow(RS485, false, false);
-    uart_set_hw_flow(INTEL_N100, false, false);
+        bridge_counters_t to_rs485, to_n100;
+        uart_bridge_get_stats(&bridge, 0, &to_rs485);
+        uart_bridge_get_stats(&bridge, 1, &to_n100);
+        printf("bridge @ %u baud\n", bridge.baud_rate);
+        print_stats("N100 -> RS485", &to_rs485);
+        print_stats("RS485 -> N100", &to_n100);
+        print_rs485_stats();
+    }
+}
 
-    // Set the data format (8 data bits, 1 stop bit, no parity)
-    uart_set_format(RS485, DATA_BITS, STOP_BITS, PARITY);
-    uart_set_format(INTEL_N100, DATA_BITS, STOP_BITS, PARITY);
+#else
 
-    // Disable the UART FIFOs. This means the UART interrupt is triggered for each character.
-    // Useful for low-latency applications.
-    uart_set_fifo_enabled(RS485, false);
-    uart_set_fifo_enabled(INTEL_N100, false);
+// Local input registers (function 0x04) of MODBUS_LOCAL_UNIT
+enum
+{
+    IREG_ADC0 = 0,   // GPIO 26, raw 12-bit
+    IREG_ADC1,       // GPIO 27, raw 12-bit
+    IREG_ADC2,       // GPIO 28, raw 12-bit
+    IREG_TEMP,       // Die temperature, 0.01 degC, signed
+    IREG_LIDAR_DIST, // TF-Luna distance, cm
+    IREG_LIDAR_AMP,  // TF-Luna signal strength
+    IREG_LIDAR_TEMP, // TF-Luna temperature, 0.01 degC, signed
+    IREG_COUNT
+};
 
-    // Set up the interrupt handlers. One for each UART.
-    // irq_set_exclusive_handler is used to ensure no other handler is registered for these IRQs.
-    irq_set_exclusive_handler(UART0_IRQ, on_INTEL_N100_rx);
-    irq_set_exclusive_handler(UART1_IRQ, on_RS485_rx);
+// Local holding registers (functions 0x03, 0x06, 0x10) of MODBUS_LOCAL_UNIT
+enum
+{
+    HREG_POLL_PERIOD_MS = 0, // Time between passes over POLLS
+    HREG_TIMEOUT_MS,         // Bus response timeout
+    HREG_COUNT
+};
 
-    // Enable the IRQs
-    irq_set_enabled(UART0_IRQ, true);
-    irq_set_enabled(UART1_IRQ, true);
+static uint16_t input_regs[IREG_COUNT];
+static uint16_t holding_regs[HREG_COUNT] = {MODBUS_POLL_PERIOD_MS, MODBUS_TIMEOUT_MS};
 
-    // Enable the UART to generate an interrupt when it receives data
-    uart_set_irq_enables(RS485, true, false); // Only enable RX interrupt
-    uart_set_irq_enables(INTEL_N100, true, false); // Only enable RX interrupt
+// Slave registers polled on the bus and cached for the host; edit for the installation
+static uint16_t cache_unit1[10];
+static uint16_t cache_unit2[4];
+static modbus_poll_t polls[] = {
+    {.unit = 1, .function = MODBUS_FC_READ_HOLDING, .start = 0, .count = 10, .cache = cache_unit1},
+    {.unit = 2, .function = MODBUS_FC_READ_INPUT, .start = 0, .count = 4, .cache = cache_unit2},
+};
+#define N_POLLS (sizeof(polls) / sizeof(polls[0]))
 
-    // The main loop is empty. All the work is done by the interrupts.
-    while (1)
+static modbus_region_t regions[2 + N_POLLS];
+static modbus_port_t host_port;
+static modbus_port_t bus_port;
+static modbus_slave_t slave;
+static modbus_master_t master;
+
+/**
+ * @brief Builds the register map: the local unit plus one read-only region per poll.
+ */
+static void build_register_map(void)
+{
+    regions[0] = (modbus_region_t){MODBUS_LOCAL_UNIT, MODBUS_TABLE_INPUT, 0, IREG_COUNT, input_regs, false, false, NULL};
+    regions[1] = (modbus_region_t){MODBUS_LOCAL_UNIT, MODBUS_TABLE_HOLDING, 0, HREG_COUNT, holding_regs, true, false, NULL};
+    for (size_t i = 0; i < N_POLLS; i++)
     {
-        tight_loop_contents();
+        modbus_poll_t *p = &polls[i];
+        modbus_table_t table = (p->function == MODBUS_FC_READ_INPUT) ? MODBUS_TABLE_INPUT : MODBUS_TABLE_HOLDING;
+        regions[2 + i] = (modbus_region_t){p->unit, table, p->start, p->count, p->cache, false, true, &p->valid};
     }
+    modbus_slave_init(&slave, regions, 2 + N_POLLS, true);
 }
 
 /**
- * @brief Interrupt Service Routine for RS485 (uart1) RX.
- *
- * This function is called whenever a character is received on the RS485 UART.
- * It reads the character and forwards it to the INTEL_N100 UART.
+ * @brief Refreshes the ADC, temperature and LiDAR input registers.
  */
-void on_RS485_rx()
+static void update_readings(void)
 {
-    while (uart_is_readable(RS485))
+    for (uint ch = 0; ch < 3; ch++)
     {
-        uint8_t ch = uart_getc(RS485);
-        // If the other UART is writable, send the character
-        if (uart_is_writable(INTEL_N100))
-        {
-            uart_putc(INTEL_N100, ch);
-        }
+        adc_select_input(ch);
+        input_regs[IREG_ADC0 + ch] = adc_read();
+    }
+
+    // T = 27 - (V - 0.706) / 0.001721, in 0.01 degC
+    adc_select_input(4);
+    int32_t uv = (int32_t)((adc_read() * 3300000u) / 4096u);
+    input_regs[IREG_TEMP] = (uint16_t)(int16_t)(2700 - ((uv - 706000) * 100) / 1721);
+
+    // Distance, strength and temperature are six consecutive little-endian bytes.
+    uint8_t reg = 0x00;
+    uint8_t data[6];
+    if (i2c_write_timeout_us(LIDAR_I2C, LIDAR_ADDR, &reg, 1, true, LIDAR_TIMEOUT_US) == 1 &&
+        i2c_read_timeout_us(LIDAR_I2C, LIDAR_ADDR, data, 6, false, LIDAR_TIMEOUT_US) == 6)
+    {
+        input_regs[IREG_LIDAR_DIST] = (uint16_t)(data[0] | (data[1] << 8));
+        input_regs[IREG_LIDAR_AMP] = (uint16_t)(data[2] | (data[3] << 8));
+        input_regs[IREG_LIDAR_TEMP] = (uint16_t)(data[4] | (data[5] << 8));
+    }
+    else
+    {
+        input_regs[IREG_LIDAR_DIST] = 0xFFFF;
+        input_regs[IREG_LIDAR_AMP] = 0xFFFF;
+        input_regs[IREG_LIDAR_TEMP] = 0xFFFF;
     }
 }
 
 /**
- * @brief Interrupt Service Routine for INTEL_N100 (uart0) RX.
- *
- * This function is called whenever a character is received on the INTEL_N100 UART.
- * It reads the character and forwards it to the RS485 UART.
+ * @brief Prints the gateway counters.
+ */
+static void print_gateway_stats(void)
+{
+    printf("host: frames %lu errors %lu dropped %lu  requests %lu crc %lu exceptions %lu writes %lu\n",
+           (unsigned long)host_port.stats.frames, (unsigned long)host_port.stats.errors,
+           (unsigned long)host_port.stats.dropped, (unsigned long)slave.stats.requests,
+           (unsigned long)slave.stats.crc_errors, (unsigned long)slave.stats.exceptions,
+           (unsigned long)slave.stats.writes);
+    for (size_t i = 0; i < N_POLLS; i++)
+    {
+        const modbus_poll_t *p = &polls[i];
+        printf("unit %3u: %s ok %lu timeouts %lu errors %lu exceptions %lu (last 0x%02x)  latency %lu us (max %lu)\n",
+               p->unit, p->valid ? "valid" : "STALE", (unsigned long)p->ok, (unsigned long)p->timeouts,
+               (unsigned long)p->errors, (unsigned long)p->exceptions, p->last_exception,
+               (unsigned long)p->latency_us, (unsigned long)p->max_latency_us);
+    }
+    print_rs485_stats();
+}
+
+/**
+ * @brief Modbus gateway: answers the host from the local map and the cache,
+ * and polls the bus slaves, all from one loop.
  */
-void on_INTEL_N100_rx()
+static void run_gateway(void)
 {
-    while (uart_is_readable(INTEL_N100))
+    adc_init();
+    adc_gpio_init(26);
+    adc_gpio_init(27);
+    adc_gpio_init(28);
+    adc_set_temp_sensor_enabled(true);
+
+    i2c_init(LIDAR_I2C, 400 * 1000);
+    gpio_set_function(LIDAR_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(LIDAR_SCL_PIN, GPIO_FUNC_I2C);
+
+    modbus_port_init(&host_port, INTEL_N100, INTEL_N100_TX_PIN, INTEL_N100_RX_PIN, BAUD_RATE, UART_PARITY_NONE, 1);
+    modbus_port_init(&bus_port, RS485, RS485_TX_PIN, RS485_RX_PIN, MODBUS_BUS_BAUD, UART_PARITY_NONE, 1);
+    rs485_init(&rs485, RS485_PIO, RS485_TX_PIN, RS485_DE_PIN, RS485_RX_PIN, MODBUS_BUS_BAUD);
+    modbus_port_use_rs485(&bus_port, &rs485);
+
+    build_register_map();
+    modbus_master_init(&master, polls, N_POLLS, MODBUS_POLL_PERIOD_MS * 1000u, MODBUS_TIMEOUT_MS * 1000u,
+                       MODBUS_STALE_PERIODS * MODBUS_POLL_PERIOD_MS * 1000u, bus_port.t35_us);
+
+    uint8_t frame[MODBUS_RTU_MAX_FRAME];
+    uint32_t next_read = time_us_32();
+    uint32_t next_stats = next_read;
+
+    while (1)
     {
-        uint8_t ch = uart_getc(INTEL_N100);
-        // If the other UART is writable, send the character
-        if (uart_is_writable(RS485))
+        size_t len;
+        uint32_t end_us;
+        const uint8_t *rx;
+
+        // Host: answered at once from the local registers or the cache.
+        if ((rx = modbus_port_receive(&host_port, &len, NULL)) != NULL)
+        {
+            size_t n = modbus_slave_handle(&slave, rx, len, frame);
+            modbus_port_release(&host_port);
+            if (n)
+            {
+                modbus_port_send(&host_port, frame, n);
+            }
+        }
+
+        // Bus: responses to the master, then the next request when it is due.
+        if ((rx = modbus_port_receive(&bus_port, &len, &end_us)) != NULL)
+        {
+            modbus_master_on_frame(&master, rx, len, end_us);
+            modbus_port_release(&bus_port);
+        }
+        size_t n = modbus_master_poll(&master, time_us_32(), frame);
+        if (n)
+        {
+            modbus_port_send(&bus_port, frame, n);
+        }
+
+        // Settings written by the host take effect on the next poll.
+        master.period_us = holding_regs[HREG_POLL_PERIOD_MS] * 1000u;
+        master.timeout_us = holding_regs[HREG_TIMEOUT_MS] * 1000u;
+        master.stale_us = MODBUS_STALE_PERIODS * master.period_us;
+
+        uint32_t now = time_us_32();
+        if ((int32_t)(now - next_read) >= 0)
         {
-            uart_putc(RS485, ch);
+            next_read += READ_PERIOD_MS * 1000u;
+            update_readings();
+        }
+        if ((int32_t)(now - next_stats) >= 0)
+        {
+            next_stats += STATS_PERIOD_MS * 1000u;
+            print_gateway_stats();
         }
     }
-}
\ No newline at end of file
+}
+
+#endif // MODBUS_GATEWAY
+
+/**
+ * @brief Main function of the program.
+ *
+ * Starts the bridge or the Modbus gateway, as selected by MODBUS_GATEWAY.
+ */
+int main()
+{
+    // stdio over USB only: uart0 belongs to the bridge
+    stdio_init_all();
+
+#if MODBUS_GATEWAY
+    run_gateway();
+#else
+    run_bridge();
+#endif
+}
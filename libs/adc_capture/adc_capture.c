@@ -0,0 +1,167 @@
+/**
+ * @file adc_capture.c
+ * @brief Free-running ADC capture into a ping-pong buffer using two chained DMA channels.
+ */
+
+#include "adc_capture.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+static adc_capture_t *active_capture = NULL; ///< Capture serviced by the DMA interrupt.
+static bool irq_installed = false;           ///< The shared DMA_IRQ_0 handler is registered once.
+
+float adc_capture_clkdiv(uint32_t rate_hz)
+{
+    // Any divider below 96 cycles gives back-to-back conversions, i.e. 500 kS/s.
+    if (rate_hz >= ADC_CAPTURE_MAX_RATE_HZ || rate_hz == 0)
+    {
+        return 0.0f;
+    }
+    return (float)ADC_CAPTURE_CLOCK_HZ / (float)rate_hz - 1.0f;
+}
+
+float adc_capture_rate(float clkdiv)
+{
+    if (clkdiv + 1.0f < (float)ADC_CAPTURE_CYCLES)
+    {
+        return (float)ADC_CAPTURE_MAX_RATE_HZ;
+    }
+    return (float)ADC_CAPTURE_CLOCK_HZ / (clkdiv + 1.0f);
+}
+
+/**
+ * @brief DMA_IRQ_0 handler: publishes the finished half and rewinds its channel.
+ *
+ * The other channel was triggered by the chain when this one finished, so sampling
+ * continues while this runs. The handler has a whole half-buffer period to complete.
+ */
+static void adc_capture_dma_irq(void)
+{
+    adc_capture_t *cap = active_capture;
+    if (cap == NULL)
+    {
+        return;
+    }
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint ch = cap->dma_chan[i];
+        if (dma_channel_get_irq0_status(ch))
+        {
+            dma_channel_acknowledge_irq0(ch);
+            pingpong_on_half_complete(&cap->pp, time_us_64());
+
+            // TRANS_COUNT reloads on the next chain trigger; only the write address moves.
+            dma_channel_set_write_addr(ch, pingpong_half(&cap->pp, i), false);
+        }
+    }
+}
+
+void adc_capture_init(adc_capture_t *cap, uint input, uint32_t rate_hz, uint16_t *storage, uint32_t half_len)
+{
+    pingpong_init(&cap->pp, storage, half_len);
+    cap->input = input;
+    cap->rr_mask = 0;
+    cap->running = false;
+
+    // Free-running conversions pushed into the FIFO, one DREQ per sample.
+    adc_select_input(input);
+    adc_fifo_setup(true,  // Write each conversion to the FIFO
+                   true,  // Enable the DMA request
+                   1,     // DREQ as soon as one sample is present
+                   false, // No error bit in the samples
+                   false  // Keep the full 12 bits
+    );
+    cap->clkdiv = adc_capture_clkdiv(rate_hz);
+    adc_set_clkdiv(cap->clkdiv);
+
+    cap->dma_chan[0] = dma_claim_unused_channel(true);
+    cap->dma_chan[1] = dma_claim_unused_channel(true);
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint ch = cap->dma_chan[i];
+        dma_channel_config cfg = dma_channel_get_default_config(ch);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, false); // Always read the ADC FIFO
+        channel_config_set_write_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_ADC);
+        channel_config_set_chain_to(&cfg, cap->dma_chan[i ^ 1]); // Hand over to the other half
+
+        dma_channel_configure(ch, &cfg, pingpong_half(&cap->pp, i), &adc_hw->fifo, half_len, false);
+        dma_channel_set_irq0_enabled(ch, true);
+    }
+
+    if (!irq_installed)
+    {
+        irq_add_shared_handler(DMA_IRQ_0, adc_capture_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irq_installed = true;
+    }
+}
+
+void adc_capture_init_round_robin(adc_capture_t *cap, uint mask, uint32_t rate_hz, uint16_t *storage,
+                                  uint32_t half_len)
+{
+    // The round robin starts from the selected input, so select the lowest one in the mask.
+    uint first = 0;
+    while (first < 4 && !(mask & (1u << first)))
+    {
+        first++;
+    }
+
+    if (mask & (1u << 4))
+    {
+        adc_set_temp_sensor_enabled(true);
+    }
+
+    adc_capture_init(cap, first, rate_hz, storage, half_len);
+
+    // A single input does not need the round robin.
+    cap->rr_mask = (mask & (mask - 1u)) ? (mask & 0x1Fu) : 0;
+}
+
+void adc_capture_start(adc_capture_t *cap)
+{
+    if (cap->running)
+    {
+        return;
+    }
+
+    // Rewind both channels so the capture always starts at half 0.
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_set_write_addr(cap->dma_chan[i], pingpong_half(&cap->pp, i), false);
+        dma_channel_set_trans_count(cap->dma_chan[i], cap->pp.half_len, false);
+    }
+    pingpong_init(&cap->pp, cap->pp.storage, cap->pp.half_len);
+
+    active_capture = cap;
+    adc_select_input(cap->input);
+    adc_set_round_robin(cap->rr_mask);
+    adc_fifo_drain();
+    dma_channel_start(cap->dma_chan[0]);
+    adc_run(true);
+    cap->running = true;
+}
+
+void adc_capture_stop(adc_capture_t *cap)
+{
+    if (!cap->running)
+    {
+        return;
+    }
+
+    adc_run(false);
+    adc_set_round_robin(0);
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_abort(cap->dma_chan[i]);
+        // An abort can leave a spurious completion flag behind (RP2040-E13).
+        dma_channel_acknowledge_irq0(cap->dma_chan[i]);
+    }
+    adc_fifo_drain();
+    active_capture = NULL;
+    cap->running = false;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file adc_capture.h
+ * @brief Free-running ADC capture into a ping-pong buffer using two chained DMA channels.
+ *
+ * @details
+ * The ADC runs in free-running FIFO mode, paced by its own clock divider, and raises a DMA
+ * request for every conversion. Two DMA channels are chained to each other, each one filling
+ * one half of the ping-pong buffer. When a channel finishes, the other one is already running,
+ * so the interrupt handler only has to rewind the finished channel's write address and publish
+ * the half. There is no CPU work per sample, which lets the capture run at the ADC's full
+ * 500 kS/s.
+ *
+ * With adc_capture_init_round_robin() the ADC cycles through several inputs and the samples
+ * arrive interleaved; adc_deinterleave.h splits them per channel. The rate is then the
+ * aggregate rate over all the channels.
+ *
+ * Only one capture can be active at a time because the ADC is a single peripheral.
+ */
+
+#ifndef ADC_CAPTURE_H
+#define ADC_CAPTURE_H
+
+#include "pico/stdlib.h"
+#include "pingpong.h"
+
+#define ADC_CAPTURE_CLOCK_HZ 48000000u   ///< ADC clock (clk_adc) frequency.
+#define ADC_CAPTURE_CYCLES 96u           ///< ADC clock cycles per conversion.
+#define ADC_CAPTURE_MAX_RATE_HZ (ADC_CAPTURE_CLOCK_HZ / ADC_CAPTURE_CYCLES) ///< 500 kS/s.
+
+typedef struct adc_capture
+{
+    pingpong_t pp;        ///< Ping-pong bookkeeping shared with the consumer.
+    uint dma_chan[2];     ///< DMA channel filling each half.
+    uint input;           ///< ADC input (0-3 for GPIO26-29, 4 for the temperature sensor).
+    uint rr_mask;         ///< Round-robin input mask, 0 to sample `input` only.
+    float clkdiv;         ///< ADC clock divider programmed for the requested rate.
+    bool running;         ///< True while the ADC and DMA are active.
+} adc_capture_t;
+
+/**
+ * @brief Computes the ADC clock divider for a sample rate.
+ *
+ * The ADC starts a new conversion every (1 + div) clk_adc cycles, with a minimum
+ * of 96 cycles per conversion.
+ *
+ * @param rate_hz Desired sample rate in samples per second.
+ * @return float The divider to pass to adc_set_clkdiv().
+ */
+float adc_capture_clkdiv(uint32_t rate_hz);
+
+/**
+ * @brief Sample rate actually produced by a given ADC clock divider.
+ *
+ * @param clkdiv Divider as passed to adc_set_clkdiv().
+ * @return float Sample rate in samples per second.
+ */
+float adc_capture_rate(float clkdiv);
+
+/**
+ * @brief Configures the ADC and claims two DMA channels for a capture.
+ *
+ * The ADC must already be initialized with adc_init() and the GPIO prepared with
+ * adc_gpio_init().
+ *
+ * @param cap Pointer to the capture instance.
+ * @param input ADC input to sample.
+ * @param rate_hz Sample rate in samples per second (up to ADC_CAPTURE_MAX_RATE_HZ).
+ * @param storage Buffer of at least 2 * half_len samples.
+ * @param half_len Number of samples per half.
+ */
+void adc_capture_init(adc_capture_t *cap, uint input, uint32_t rate_hz, uint16_t *storage, uint32_t half_len);
+
+/**
+ * @brief Configures a capture that cycles through several ADC inputs.
+ *
+ * Conversions start at the lowest input in the mask and go up through the others, so the
+ * buffer holds the inputs interleaved in increasing order. If the mask includes input 4,
+ * the temperature sensor is enabled. The GPIOs of the other inputs must already be prepared
+ * with adc_gpio_init().
+ *
+ * @param cap Pointer to the capture instance.
+ * @param mask Bit n selects ADC input n (0-4).
+ * @param rate_hz Aggregate sample rate over all inputs (up to ADC_CAPTURE_MAX_RATE_HZ).
+ * @param storage Buffer of at least 2 * half_len samples.
+ * @param half_len Number of samples per half (a multiple of the number of inputs keeps
+ *                 every half aligned on the first input).
+ */
+void adc_capture_init_round_robin(adc_capture_t *cap, uint mask, uint32_t rate_hz, uint16_t *storage,
+                                  uint32_t half_len);
+
+/**
+ * @brief Starts the free-running conversion and the DMA transfers.
+ *
+ * @param cap Pointer to the capture instance.
+ */
+void adc_capture_start(adc_capture_t *cap);
+
+/**
+ * @brief Stops the ADC and aborts both DMA channels.
+ *
+ * @param cap Pointer to the capture instance.
+ */
+void adc_capture_stop(adc_capture_t *cap);
+
+/**
+ * @brief Takes the oldest finished half, see pingpong_acquire().
+ */
+static inline const uint16_t *adc_capture_acquire(adc_capture_t *cap, uint32_t *seq)
+{
+    return pingpong_acquire(&cap->pp, seq);
+}
+
+/**
+ * @brief Returns a half obtained with adc_capture_acquire(), see pingpong_release().
+ */
+static inline void adc_capture_release(adc_capture_t *cap)
+{
+    pingpong_release(&cap->pp);
+}
+
+#endif // ADC_CAPTURE_H
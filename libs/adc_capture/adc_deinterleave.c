@@ -0,0 +1,123 @@
+/**
+ * @file adc_deinterleave.c
+ * @brief Splits a round-robin ADC stream into one sample ring per channel.
+ */
+
+#include "adc_deinterleave.h"
+
+void sample_ring_init(sample_ring_t *ring, uint16_t *storage, uint32_t capacity)
+{
+    ring->data = storage;
+    ring->mask = capacity - 1u;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflows = 0;
+}
+
+size_t sample_ring_read(sample_ring_t *ring, uint16_t *out, size_t n)
+{
+    uint32_t avail = sample_ring_count(ring);
+    if (n > avail)
+    {
+        n = avail;
+    }
+
+    uint32_t tail = ring->tail;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = ring->data[(tail + i) & ring->mask];
+    }
+    ring->tail = tail + (uint32_t)n;
+    return n;
+}
+
+size_t sample_ring_skip(sample_ring_t *ring, size_t n)
+{
+    uint32_t avail = sample_ring_count(ring);
+    if (n > avail)
+    {
+        n = avail;
+    }
+    ring->tail += (uint32_t)n;
+    return n;
+}
+
+uint8_t adc_channel_map(uint8_t mask, uint8_t *inputs)
+{
+    uint8_t n = 0;
+
+    for (uint8_t input = 0; input < ADC_DEINTERLEAVE_MAX_CHANNELS; input++)
+    {
+        if (mask & (1u << input))
+        {
+            inputs[n++] = input;
+        }
+    }
+    return n;
+}
+
+void adc_deinterleaver_init(adc_deinterleaver_t *d, uint8_t mask, sample_ring_t *rings)
+{
+    d->n_channels = adc_channel_map(mask, d->inputs);
+    d->rings = rings;
+    d->phase = 0;
+}
+
+void adc_deinterleave(adc_deinterleaver_t *d, const uint16_t *block, size_t count)
+{
+    uint32_t n = d->n_channels;
+    if (n == 0)
+    {
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < n; slot++)
+    {
+        // The first sample of this slot sits (slot - phase) mod n into the block.
+        uint32_t first = (slot + n - d->phase) % n;
+        if (first >= count)
+        {
+            continue;
+        }
+        uint32_t take = (uint32_t)(count - first + n - 1) / n;
+
+        // Make room once per block rather than testing for a full ring per sample.
+        sample_ring_t *r = &d->rings[slot];
+        uint32_t space = r->mask + 1u - sample_ring_count(r);
+        if (take > space)
+        {
+            uint32_t drop = take - space;
+            r->tail += drop;
+            r->overflows += drop;
+        }
+
+        const uint16_t *src = block + first;
+        uint16_t *dst = r->data;
+        uint32_t mask = r->mask;
+        uint32_t head = r->head;
+        for (uint32_t i = 0; i < take; i++)
+        {
+            dst[(head + i) & mask] = *src;
+            src += n;
+        }
+        r->head = head + take;
+    }
+
+    d->phase = (uint8_t)((d->phase + count) % n);
+}
+
+void adc_deinterleaver_skip(adc_deinterleaver_t *d, uint32_t count)
+{
+    uint32_t n = d->n_channels;
+    if (n == 0)
+    {
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < n; slot++)
+    {
+        sample_ring_t *r = &d->rings[slot];
+        r->tail = r->head;
+    }
+    d->phase = (uint8_t)((d->phase + count) % n);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file adc_deinterleave.h
+ * @brief Splits a round-robin ADC stream into one sample ring per channel.
+ *
+ * @details
+ * With a round-robin mask the ADC converts the selected inputs one after the other, in
+ * increasing input order, and the DMA stores them interleaved: `a0 b0 c0 a1 b1 c1 ...`.
+ * adc_deinterleave() copies each channel's samples out of a block with one strided loop per
+ * channel, so there is no test or switch on the channel inside the per-sample loop. Ring
+ * indexes are masked instead of wrapped. Blocks do not need to hold a whole number of rounds:
+ * the de-interleaver remembers which channel the next block starts with.
+ *
+ * Each ring has a single writer (adc_deinterleave()) and a single reader. When a ring does not
+ * have room for a block's worth of samples, the oldest samples are dropped and counted, so the
+ * ring always holds the newest data.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef ADC_DEINTERLEAVE_H
+#define ADC_DEINTERLEAVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ADC_DEINTERLEAVE_MAX_CHANNELS 5u ///< ADC0-3 plus the temperature sensor (input 4).
+
+typedef struct sample_ring
+{
+    uint16_t *data;     ///< Caller-provided storage.
+    uint32_t mask;      ///< Capacity - 1 (capacity is a power of two).
+    uint32_t head;      ///< Samples written since init.
+    uint32_t tail;      ///< Samples read since init.
+    uint32_t overflows; ///< Samples dropped because the ring was full.
+} sample_ring_t;
+
+typedef struct adc_deinterleaver
+{
+    uint8_t n_channels;                            ///< Number of inputs in the round robin.
+    uint8_t inputs[ADC_DEINTERLEAVE_MAX_CHANNELS]; ///< ADC input of each slot, in conversion order.
+    sample_ring_t *rings;                          ///< One ring per slot.
+    uint8_t phase;                                 ///< Slot of the next sample to arrive.
+} adc_deinterleaver_t;
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * @param ring Pointer to the ring.
+ * @param storage Storage for capacity samples.
+ * @param capacity Number of samples, a power of two.
+ */
+void sample_ring_init(sample_ring_t *ring, uint16_t *storage, uint32_t capacity);
+
+/**
+ * @brief Number of samples waiting in a ring.
+ */
+static inline uint32_t sample_ring_count(const sample_ring_t *ring)
+{
+    return ring->head - ring->tail;
+}
+
+/**
+ * @brief Reads up to n of the oldest samples into a contiguous buffer.
+ *
+ * @param ring Pointer to the ring.
+ * @param out Destination, n samples.
+ * @param n Number of samples wanted.
+ * @return size_t Number of samples read.
+ */
+size_t sample_ring_read(sample_ring_t *ring, uint16_t *out, size_t n);
+
+/**
+ * @brief Discards up to n of the oldest samples.
+ *
+ * @return size_t Number of samples discarded.
+ */
+size_t sample_ring_skip(sample_ring_t *ring, size_t n);
+
+/**
+ * @brief Lists the inputs selected by a round-robin mask, in conversion order.
+ *
+ * @param mask Bit n selects ADC input n (0-4).
+ * @param inputs Output, up to ADC_DEINTERLEAVE_MAX_CHANNELS entries.
+ * @return uint8_t Number of inputs.
+ */
+uint8_t adc_channel_map(uint8_t mask, uint8_t *inputs);
+
+/**
+ * @brief Initializes a de-interleaver for a round-robin mask.
+ *
+ * The capture must start converting the lowest input in the mask (adc_capture does this).
+ *
+ * @param d Pointer to the de-interleaver.
+ * @param mask Round-robin mask, bit n selects ADC input n.
+ * @param rings One initialized ring per input in the mask, in increasing input order, each
+ *              large enough for one block's share of samples.
+ */
+void adc_deinterleaver_init(adc_deinterleaver_t *d, uint8_t mask, sample_ring_t *rings);
+
+/**
+ * @brief Distributes a block of interleaved samples to the channel rings.
+ *
+ * @param d Pointer to the de-interleaver.
+ * @param block Interleaved samples as written by the DMA.
+ * @param count Number of samples in the block.
+ */
+void adc_deinterleave(adc_deinterleaver_t *d, const uint16_t *block, size_t count);
+
+/**
+ * @brief Accounts for samples lost before the next block (e.g. a ping-pong overrun).
+ *
+ * Advances the phase past the missing samples and empties the rings, so that no channel
+ * ever joins samples from both sides of the gap.
+ *
+ * @param d Pointer to the de-interleaver.
+ * @param count Number of samples lost.
+ */
+void adc_deinterleaver_skip(adc_deinterleaver_t *d, uint32_t count);
+
+#endif // ADC_DEINTERLEAVE_H
@@ -0,0 +1,100 @@
+/**
+ * @file capture_stats.c
+ * @brief Timing statistics for a periodic capture: interval, jitter and overrun counters.
+ */
+
+#include "capture_stats.h"
+
+void capture_stats_init(capture_stats_t *s, uint32_t nominal_us)
+{
+    s->nominal_us = nominal_us;
+    s->started = false;
+    s->last_stamp = 0;
+    s->total_events = 0;
+    s->total_overruns = 0;
+    capture_stats_restart(s);
+}
+
+void capture_stats_restart(capture_stats_t *s)
+{
+    s->intervals = 0;
+    s->min_interval = UINT32_MAX;
+    s->max_interval = 0;
+    s->sum_interval = 0;
+    s->max_jitter = 0;
+    s->sum_jitter = 0;
+    s->late = 0;
+    s->overruns = 0;
+}
+
+void capture_stats_record(capture_stats_t *s, uint64_t stamp_us)
+{
+    s->total_events++;
+
+    if (!s->started)
+    {
+        s->started = true;
+        s->last_stamp = stamp_us;
+        return;
+    }
+
+    uint64_t delta = stamp_us - s->last_stamp;
+    uint32_t interval = (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta;
+    s->last_stamp = stamp_us;
+
+    uint32_t jitter = (interval > s->nominal_us) ? interval - s->nominal_us : s->nominal_us - interval;
+
+    s->intervals++;
+    s->sum_interval += interval;
+    s->sum_jitter += jitter;
+    if (interval < s->min_interval)
+    {
+        s->min_interval = interval;
+    }
+    if (interval > s->max_interval)
+    {
+        s->max_interval = interval;
+    }
+    if (jitter > s->max_jitter)
+    {
+        s->max_jitter = jitter;
+    }
+
+    // Compare 2 * interval with 3 * nominal to avoid the division.
+    if ((uint64_t)interval * 2u > (uint64_t)s->nominal_us * 3u)
+    {
+        s->late++;
+    }
+}
+
+void capture_stats_add_overruns(capture_stats_t *s, uint32_t count)
+{
+    s->overruns += count;
+    s->total_overruns += count;
+}
+
+void capture_stats_report(const capture_stats_t *s, capture_stats_report_t *r)
+{
+    r->nominal_us = s->nominal_us;
+    r->intervals = s->intervals;
+    r->min_interval = s->intervals ? s->min_interval : 0;
+    r->max_interval = s->max_interval;
+    r->mean_interval = s->intervals ? (uint32_t)(s->sum_interval / s->intervals) : 0;
+    r->max_jitter = s->max_jitter;
+    r->mean_jitter = s->intervals ? (uint32_t)(s->sum_jitter / s->intervals) : 0;
+    r->late = s->late;
+    r->overruns = s->overruns;
+}
+
+void capture_stats_to_fields(const capture_stats_report_t *r, uint32_t *fields)
+{
+    fields[0] = r->nominal_us;
+    fields[1] = r->intervals;
+    fields[2] = r->min_interval;
+    fields[3] = r->max_interval;
+    fields[4] = r->mean_interval;
+    fields[5] = r->max_jitter;
+    fields[6] = r->mean_jitter;
+    fields[7] = r->late;
+    fields[8] = r->overruns;
+}
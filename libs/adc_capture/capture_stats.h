@@ -0,0 +1,109 @@
+/**
+ * @file capture_stats.h
+ * @brief Timing statistics for a periodic capture: interval, jitter and overrun counters.
+ *
+ * @details
+ * The producer side stamps every block (or every sample, for a software-timed capture) with
+ * the 64-bit microsecond timer. capture_stats_record() compares each interval with the
+ * nominal one and keeps the minimum, maximum and mean interval, the largest and mean absolute
+ * deviation from nominal (the jitter) and the number of late events, i.e. intervals longer
+ * than 1.5 nominal periods, which mean a whole block or sample was missed.
+ *
+ * The statistics cover a reporting window: capture_stats_report() takes a snapshot and
+ * capture_stats_restart() starts the next window without losing the last timestamp, so
+ * the first interval of the new window is still measured. The counters that matter over the
+ * whole run (total events and overruns) are never cleared.
+ *
+ * This file has no dependency on the Pico SDK, so it can be fed synthetic timestamp streams
+ * on a host.
+ */
+
+#ifndef CAPTURE_STATS_H
+#define CAPTURE_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CAPTURE_STATS_FIELDS 9u ///< Number of values written by capture_stats_to_fields().
+
+typedef struct capture_stats
+{
+    uint32_t nominal_us;     ///< Expected interval between two stamps.
+    bool started;            ///< At least one stamp has been recorded.
+    uint64_t last_stamp;     ///< Timestamp of the previous event.
+    uint32_t total_events;   ///< Stamps recorded since init (whole run).
+    uint32_t total_overruns; ///< Overruns reported since init (whole run).
+
+    // Current reporting window
+    uint32_t intervals;      ///< Intervals measured in this window.
+    uint32_t min_interval;   ///< Shortest interval, us.
+    uint32_t max_interval;   ///< Longest interval, us.
+    uint64_t sum_interval;   ///< Sum of the intervals, us.
+    uint32_t max_jitter;     ///< Largest |interval - nominal|, us.
+    uint64_t sum_jitter;     ///< Sum of |interval - nominal|, us.
+    uint32_t late;           ///< Intervals longer than 1.5 nominal periods.
+    uint32_t overruns;       ///< Overruns reported in this window.
+} capture_stats_t;
+
+typedef struct capture_stats_report
+{
+    uint32_t nominal_us;     ///< Expected interval, us.
+    uint32_t intervals;      ///< Intervals measured in the window.
+    uint32_t min_interval;   ///< Shortest interval, us (0 if none).
+    uint32_t max_interval;   ///< Longest interval, us.
+    uint32_t mean_interval;  ///< Mean interval, us.
+    uint32_t max_jitter;     ///< Largest deviation from nominal, us.
+    uint32_t mean_jitter;    ///< Mean absolute deviation from nominal, us.
+    uint32_t late;           ///< Late intervals in the window.
+    uint32_t overruns;       ///< Overruns in the window.
+} capture_stats_report_t;
+
+/**
+ * @brief Initializes the statistics for a given nominal interval.
+ *
+ * @param s Pointer to the statistics.
+ * @param nominal_us Expected time between two recorded events, in microseconds.
+ */
+void capture_stats_init(capture_stats_t *s, uint32_t nominal_us);
+
+/**
+ * @brief Records the timestamp of one event (a finished block or a sample).
+ *
+ * @param s Pointer to the statistics.
+ * @param stamp_us Timestamp in microseconds, monotonic.
+ */
+void capture_stats_record(capture_stats_t *s, uint64_t stamp_us);
+
+/**
+ * @brief Adds overruns reported by the capture (e.g. the growth of pingpong_t::overruns).
+ *
+ * @param s Pointer to the statistics.
+ * @param count Number of new overruns.
+ */
+void capture_stats_add_overruns(capture_stats_t *s, uint32_t count);
+
+/**
+ * @brief Takes a snapshot of the current window.
+ *
+ * @param s Pointer to the statistics.
+ * @param r Output for the report.
+ */
+void capture_stats_report(const capture_stats_t *s, capture_stats_report_t *r);
+
+/**
+ * @brief Starts a new reporting window, keeping the last timestamp and the run totals.
+ *
+ * @param s Pointer to the statistics.
+ */
+void capture_stats_restart(capture_stats_t *s);
+
+/**
+ * @brief Flattens a report into CAPTURE_STATS_FIELDS values, in the order of the
+ *        capture_stats_report_t members, for a SAMPLE_FRAME_TYPE_STATUS frame.
+ *
+ * @param r Report to flatten.
+ * @param fields Output, CAPTURE_STATS_FIELDS values.
+ */
+void capture_stats_to_fields(const capture_stats_report_t *r, uint32_t *fields);
+
+#endif // CAPTURE_STATS_H
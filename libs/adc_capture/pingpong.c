@@ -0,0 +1,65 @@
+/**
+ * @file pingpong.c
+ * @brief Ping-pong (double) buffer bookkeeping for DMA-driven sample capture.
+ */
+
+#include <stddef.h>
+#include "pingpong.h"
+
+void pingpong_init(pingpong_t *pp, uint16_t *storage, uint32_t half_len)
+{
+    pp->storage = storage;
+    pp->half_len = half_len;
+    pp->produced = 0;
+    pp->consumed = 0;
+    pp->overruns = 0;
+    pp->stamp[0] = 0;
+    pp->stamp[1] = 0;
+}
+
+void pingpong_on_half_complete(pingpong_t *pp, uint64_t timestamp)
+{
+    uint32_t done = pp->produced;
+    pp->stamp[done & 1u] = timestamp;
+
+    // Publish the half only after its timestamp is in place.
+    pp->produced = done + 1;
+}
+
+const uint16_t *pingpong_acquire(pingpong_t *pp, uint32_t *seq)
+{
+    uint32_t produced = pp->produced;
+    uint32_t consumed = pp->consumed;
+
+    if (produced == consumed)
+    {
+        return NULL; // Nothing finished yet.
+    }
+
+    // Only the newest finished half is still intact; anything older has been refilled.
+    if (produced - consumed > 1)
+    {
+        pp->overruns += produced - consumed - 1;
+        consumed = produced - 1;
+        pp->consumed = consumed;
+    }
+
+    if (seq)
+    {
+        *seq = consumed;
+    }
+    return pingpong_half(pp, consumed);
+}
+
+void pingpong_release(pingpong_t *pp)
+{
+    uint32_t consumed = pp->consumed;
+
+    // Two or more completions since this half was handed out means the producer
+    // has already started writing into it again.
+    if (pp->produced - consumed > 1)
+    {
+        pp->overruns++;
+    }
+    pp->consumed = consumed + 1;
+}
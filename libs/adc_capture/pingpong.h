@@ -0,0 +1,102 @@
+/**
+ * @file pingpong.h
+ * @brief Ping-pong (double) buffer bookkeeping for DMA-driven sample capture.
+ *
+ * @details
+ * The storage is split into two halves of `half_len` samples. The producer (a DMA
+ * completion interrupt, or a simulated ADC on the host) calls pingpong_on_half_complete()
+ * every time a half has been filled, while the consumer (the main loop) takes finished
+ * halves with pingpong_acquire() and gives them back with pingpong_release().
+ *
+ * The producer only ever writes `produced` and the consumer only ever writes `consumed`
+ * and the overrun counter, so no locking is needed between an interrupt and the main loop.
+ * This file has no dependency on the Pico SDK so it can be compiled and exercised on a host.
+ */
+
+#ifndef PINGPONG_H
+#define PINGPONG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct pingpong
+{
+    uint16_t *storage;           ///< Backing storage, 2 * half_len samples.
+    uint32_t half_len;           ///< Samples per half.
+    volatile uint32_t produced;  ///< Number of halves completed by the producer.
+    volatile uint32_t consumed;  ///< Number of halves released by the consumer.
+    volatile uint32_t overruns;  ///< Halves overwritten before the consumer could use them.
+    volatile uint64_t stamp[2];  ///< Completion timestamp of the last block in each half.
+} pingpong_t;
+
+/**
+ * @brief Initializes the ping-pong bookkeeping over caller-provided storage.
+ *
+ * @param pp Pointer to the ping-pong instance.
+ * @param storage Buffer of at least 2 * half_len samples.
+ * @param half_len Number of samples in each half.
+ */
+void pingpong_init(pingpong_t *pp, uint16_t *storage, uint32_t half_len);
+
+/**
+ * @brief Returns the address of one half of the storage.
+ *
+ * @param pp Pointer to the ping-pong instance.
+ * @param half Half index (0 or 1).
+ * @return uint16_t* First sample of that half.
+ */
+static inline uint16_t *pingpong_half(const pingpong_t *pp, uint32_t half)
+{
+    return pp->storage + (half & 1u) * pp->half_len;
+}
+
+/**
+ * @brief Producer side: marks the half currently being written as complete.
+ *
+ * Called from the DMA completion interrupt. The half that completed is
+ * `produced & 1` before the call.
+ *
+ * @param pp Pointer to the ping-pong instance.
+ * @param timestamp Time at which the half completed (any monotonic unit).
+ */
+void pingpong_on_half_complete(pingpong_t *pp, uint64_t timestamp);
+
+/**
+ * @brief Consumer side: takes the oldest finished half.
+ *
+ * If the consumer fell behind by more than one half, the stale halves have already been
+ * overwritten; they are skipped and counted as overruns.
+ *
+ * @param pp Pointer to the ping-pong instance.
+ * @param seq Optional output for the block sequence number (may be NULL).
+ * @return const uint16_t* The finished half, or NULL if none is ready.
+ */
+const uint16_t *pingpong_acquire(pingpong_t *pp, uint32_t *seq);
+
+/**
+ * @brief Consumer side: returns the half obtained with pingpong_acquire().
+ *
+ * If the producer wrapped around onto that half while it was in use, the data the consumer
+ * saw may have been partially overwritten; this is counted as an overrun.
+ *
+ * @param pp Pointer to the ping-pong instance.
+ */
+void pingpong_release(pingpong_t *pp);
+
+/**
+ * @brief Number of finished halves waiting for the consumer.
+ */
+static inline uint32_t pingpong_pending(const pingpong_t *pp)
+{
+    return pp->produced - pp->consumed;
+}
+
+/**
+ * @brief Timestamp recorded by the producer for the half with the given sequence number.
+ */
+static inline uint64_t pingpong_stamp(const pingpong_t *pp, uint32_t seq)
+{
+    return pp->stamp[seq & 1u];
+}
+
+#endif // PINGPONG_H
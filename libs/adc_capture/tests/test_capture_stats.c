@@ -0,0 +1,210 @@
+/**
+ * @file test_capture_stats.c
+ * @brief Capture timing statistics fed with synthetic timestamp streams.
+ *
+ * @details
+ * Each stream is built from known intervals (exact, alternating jitter, missed blocks,
+ * random), so the expected minimum, maximum, mean, jitter and late counts follow from the
+ * construction or from a plain recount in the test. The reporting window, the run totals,
+ * the 1.5-period late threshold and intervals longer than 32 bits are checked separately.
+ */
+
+#include <stdlib.h>
+#include "capture_stats.h"
+#include "host_test.h"
+
+#define NOMINAL_US 1000u
+
+static capture_stats_t s;
+static capture_stats_report_t r;
+
+/**
+ * @brief Records stamps start, start + intervals[0], ... and takes a report.
+ */
+static void feed(uint64_t start, const uint32_t *intervals, uint32_t n)
+{
+    uint64_t t = start;
+    capture_stats_record(&s, t);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        t += intervals[i];
+        capture_stats_record(&s, t);
+    }
+    capture_stats_report(&s, &r);
+}
+
+/**
+ * @brief A stream on time has no jitter and nothing late.
+ */
+static void test_exact(void)
+{
+    uint32_t iv[500];
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        iv[i] = NOMINAL_US;
+    }
+    capture_stats_init(&s, NOMINAL_US);
+    feed(123456789ull, iv, 500);
+
+    CHECK_EQ(r.nominal_us, NOMINAL_US);
+    CHECK_EQ(r.intervals, 500);
+    CHECK_EQ(r.min_interval, NOMINAL_US);
+    CHECK_EQ(r.max_interval, NOMINAL_US);
+    CHECK_EQ(r.mean_interval, NOMINAL_US);
+    CHECK_EQ(r.max_jitter, 0);
+    CHECK_EQ(r.mean_jitter, 0);
+    CHECK_EQ(r.late, 0);
+    CHECK_EQ(s.total_events, 501);
+}
+
+/**
+ * @brief Stamps alternately early and late by d: the mean stays nominal, the jitter is d.
+ *
+ * This is what a polled loop looks like when every other iteration is slowed by a print.
+ */
+static void test_alternating(void)
+{
+    uint32_t iv[400];
+    for (uint32_t i = 0; i < 400; i++)
+    {
+        iv[i] = (i & 1u) ? NOMINAL_US - 70u : NOMINAL_US + 70u;
+    }
+    capture_stats_init(&s, NOMINAL_US);
+    feed(0, iv, 400);
+
+    CHECK_EQ(r.min_interval, NOMINAL_US - 70u);
+    CHECK_EQ(r.max_interval, NOMINAL_US + 70u);
+    CHECK_EQ(r.mean_interval, NOMINAL_US);
+    CHECK_EQ(r.max_jitter, 70);
+    CHECK_EQ(r.mean_jitter, 70);
+    CHECK_EQ(r.late, 0);
+}
+
+/**
+ * @brief An interval is late above 1.5 periods: a missed block shows up as one late event.
+ */
+static void test_late_threshold(void)
+{
+    const uint32_t iv[] = {
+        NOMINAL_US,
+        NOMINAL_US * 3u / 2u,      // Exactly 1.5 periods: not late
+        NOMINAL_US * 3u / 2u + 1u, // Late
+        2u * NOMINAL_US,           // One block missed
+        5u * NOMINAL_US,           // Four missed, still one late interval
+        NOMINAL_US,
+    };
+    capture_stats_init(&s, NOMINAL_US);
+    feed(0, iv, 6);
+
+    CHECK_EQ(r.late, 3);
+    CHECK_EQ(r.max_interval, 5u * NOMINAL_US);
+    CHECK_EQ(r.max_jitter, 4u * NOMINAL_US);
+
+    // Odd nominal periods: 2 * interval against 3 * nominal, no rounding
+    const uint32_t odd[] = {10, 11};
+    capture_stats_init(&s, 7);
+    feed(0, odd, 2);
+    CHECK_EQ(r.late, 1);
+}
+
+/**
+ * @brief Random jitter, checked against a recount of the same intervals.
+ */
+static void test_random(void)
+{
+    enum { N = 20000 };
+    static uint32_t iv[N];
+    uint32_t min = UINT32_MAX, max = 0, max_jitter = 0, late = 0;
+    uint64_t sum = 0, sum_jitter = 0;
+
+    srand(7);
+    for (uint32_t i = 0; i < N; i++)
+    {
+        // Mostly within +-50 us, now and then a stall of up to three periods
+        iv[i] = (rand() % 100 == 0) ? NOMINAL_US + (uint32_t)(rand() % (2 * NOMINAL_US))
+                                    : NOMINAL_US - 50u + (uint32_t)(rand() % 101);
+        uint32_t j = iv[i] > NOMINAL_US ? iv[i] - NOMINAL_US : NOMINAL_US - iv[i];
+        min = iv[i] < min ? iv[i] : min;
+        max = iv[i] > max ? iv[i] : max;
+        max_jitter = j > max_jitter ? j : max_jitter;
+        sum += iv[i];
+        sum_jitter += j;
+        late += 2u * iv[i] > 3u * NOMINAL_US;
+    }
+    capture_stats_init(&s, NOMINAL_US);
+    feed(0xFFFFFFF0ull, iv, N); // Crosses 2^32 us early on
+
+    CHECK_EQ(r.intervals, N);
+    CHECK_EQ(r.min_interval, min);
+    CHECK_EQ(r.max_interval, max);
+    CHECK_EQ(r.mean_interval, sum / N);
+    CHECK_EQ(r.max_jitter, max_jitter);
+    CHECK_EQ(r.mean_jitter, sum_jitter / N);
+    CHECK_EQ(r.late, late);
+    CHECK(late > 0);
+}
+
+/**
+ * @brief A new window starts from the last stamp; the run totals are kept.
+ */
+static void test_windows(void)
+{
+    capture_stats_init(&s, NOMINAL_US);
+
+    // Nothing measured yet: an empty report is all zeros but the nominal period
+    capture_stats_report(&s, &r);
+    CHECK_EQ(r.intervals, 0);
+    CHECK_EQ(r.min_interval, 0);
+    CHECK_EQ(r.mean_interval, 0);
+    CHECK_EQ(r.mean_jitter, 0);
+
+    capture_stats_record(&s, 1000);
+    capture_stats_record(&s, 2000);
+    capture_stats_add_overruns(&s, 2);
+    capture_stats_restart(&s);
+
+    // The first interval of the window runs from the last stamp of the previous one
+    capture_stats_record(&s, 4000);
+    capture_stats_add_overruns(&s, 1);
+    capture_stats_report(&s, &r);
+    CHECK_EQ(r.intervals, 1);
+    CHECK_EQ(r.min_interval, 2000);
+    CHECK_EQ(r.late, 1);
+    CHECK_EQ(r.overruns, 1);
+    CHECK_EQ(s.total_overruns, 3);
+    CHECK_EQ(s.total_events, 3);
+
+    // The fields of a status frame follow the report members
+    uint32_t f[CAPTURE_STATS_FIELDS];
+    capture_stats_to_fields(&r, f);
+    const uint32_t want[CAPTURE_STATS_FIELDS] = {NOMINAL_US, 1, 2000, 2000, 2000, 1000, 1000, 1, 1};
+    for (uint32_t i = 0; i < CAPTURE_STATS_FIELDS; i++)
+    {
+        CHECK_EQ(f[i], want[i]);
+    }
+}
+
+/**
+ * @brief An interval longer than 32 bits of microseconds saturates instead of wrapping.
+ */
+static void test_long_gap(void)
+{
+    capture_stats_init(&s, NOMINAL_US);
+    capture_stats_record(&s, 10);
+    capture_stats_record(&s, 10 + (1ull << 33));
+    capture_stats_report(&s, &r);
+    CHECK_EQ(r.max_interval, UINT32_MAX);
+    CHECK_EQ(r.max_jitter, UINT32_MAX - NOMINAL_US);
+    CHECK_EQ(r.late, 1);
+}
+
+int main(void)
+{
+    test_exact();
+    test_alternating();
+    test_late_threshold();
+    test_random();
+    test_windows();
+    test_long_gap();
+    return host_test_result("test_capture_stats");
+}
@@ -0,0 +1,224 @@
+/**
+ * @file test_deinterleave.c
+ * @brief Round-robin de-interleaving of a synthetic interleaved ADC stream.
+ *
+ * @details
+ * The stream is what the DMA writes for a round-robin mask: the selected inputs in increasing
+ * order, round after round. Every sample carries its input and round number, so a channel
+ * ring that receives a sample of another input, loses one or repeats one is caught. The
+ * stream is cut into blocks of random length, including empty blocks and blocks that end in
+ * the middle of a round, for every mask from one to five inputs.
+ */
+
+#include <stdlib.h>
+#include "adc_deinterleave.h"
+#include "host_test.h"
+
+#define RING_CAPACITY 1024u
+#define ROUNDS 3000u
+#define MAX_BLOCK 700u
+
+static uint16_t storage[ADC_DEINTERLEAVE_MAX_CHANNELS][RING_CAPACITY];
+static sample_ring_t rings[ADC_DEINTERLEAVE_MAX_CHANNELS];
+static adc_deinterleaver_t d;
+static uint16_t stream[ROUNDS * ADC_DEINTERLEAVE_MAX_CHANNELS];
+
+/**
+ * @brief Value of round r of ADC input: the input in the top 3 bits, the round below.
+ */
+static uint16_t sample(uint8_t input, uint32_t round)
+{
+    return (uint16_t)((input << 13) | (round & 0x1FFFu));
+}
+
+static void setup(uint8_t mask, uint32_t capacity)
+{
+    for (uint32_t c = 0; c < ADC_DEINTERLEAVE_MAX_CHANNELS; c++)
+    {
+        sample_ring_init(&rings[c], storage[c], capacity);
+    }
+    adc_deinterleaver_init(&d, mask, rings);
+}
+
+/**
+ * @brief Interleaves ROUNDS rounds of the inputs in d and returns the stream length.
+ */
+static uint32_t make_stream(void)
+{
+    uint32_t n = 0;
+    for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+        for (uint32_t slot = 0; slot < d.n_channels; slot++)
+        {
+            stream[n++] = sample(d.inputs[slot], round);
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Reads a slot's ring empty, checking rounds next, next + 1, ...
+ *
+ * @return uint32_t Round of the next sample expected.
+ */
+static uint32_t drain(uint32_t slot, uint32_t next)
+{
+    uint16_t buf[RING_CAPACITY];
+    size_t got = sample_ring_read(&rings[slot], buf, RING_CAPACITY);
+    uint32_t bad = 0;
+    for (size_t i = 0; i < got; i++)
+    {
+        if (buf[i] != sample(d.inputs[slot], next + (uint32_t)i))
+        {
+            bad++;
+        }
+    }
+    CHECK_EQ(bad, 0);
+    return next + (uint32_t)got;
+}
+
+static void test_channel_map(void)
+{
+    uint8_t inputs[ADC_DEINTERLEAVE_MAX_CHANNELS];
+    CHECK_EQ(adc_channel_map(0x00, inputs), 0);
+    CHECK_EQ(adc_channel_map(0x1F, inputs), 5);
+    CHECK_EQ(adc_channel_map(0x16, inputs), 3);
+    CHECK_EQ(inputs[0], 1);
+    CHECK_EQ(inputs[1], 2);
+    CHECK_EQ(inputs[2], 4);
+    CHECK_EQ(adc_channel_map(0xE1, inputs), 1); // Bits above input 4 are ignored
+    CHECK_EQ(inputs[0], 0);
+}
+
+/**
+ * @brief Every mask, random block lengths: each ring gets exactly its input, in order.
+ */
+static void test_all_masks(void)
+{
+    srand(11);
+    for (uint8_t mask = 1; mask < 0x20u; mask++)
+    {
+        setup(mask, RING_CAPACITY);
+        uint32_t len = make_stream();
+        uint32_t next[ADC_DEINTERLEAVE_MAX_CHANNELS] = {0};
+
+        for (uint32_t pos = 0; pos < len;)
+        {
+            uint32_t block = (uint32_t)rand() % (MAX_BLOCK + 1u);
+            if (block > len - pos)
+            {
+                block = len - pos;
+            }
+            adc_deinterleave(&d, &stream[pos], block);
+            pos += block;
+            CHECK_EQ(d.phase, pos % d.n_channels);
+
+            // Read some rings now and leave the others to fill up, short of overflowing
+            for (uint32_t slot = 0; slot < d.n_channels; slot++)
+            {
+                if ((rand() & 1) || sample_ring_count(&rings[slot]) > RING_CAPACITY - MAX_BLOCK)
+                {
+                    next[slot] = drain(slot, next[slot]);
+                }
+            }
+        }
+        for (uint32_t slot = 0; slot < d.n_channels; slot++)
+        {
+            CHECK_EQ(drain(slot, next[slot]), ROUNDS);
+            CHECK_EQ(rings[slot].overflows, 0);
+        }
+    }
+}
+
+/**
+ * @brief A ring that is not read keeps the newest samples and counts the dropped ones.
+ */
+static void test_overflow(void)
+{
+    setup(0x05, 64); // Inputs 0 and 2
+    make_stream();
+
+    // 100 rounds in blocks of 30 samples; slot 0 is read after every block, slot 1 never
+    uint32_t next0 = 0;
+    for (uint32_t pos = 0; pos < 200; pos += 30)
+    {
+        uint32_t block = pos + 30 > 200 ? 200 - pos : 30;
+        adc_deinterleave(&d, &stream[pos], block);
+        next0 = drain(0, next0);
+    }
+    CHECK_EQ(next0, 100);
+    CHECK_EQ(rings[0].overflows, 0);
+    CHECK_EQ(sample_ring_count(&rings[1]), 64);
+    CHECK_EQ(rings[1].overflows, 100 - 64);
+    CHECK_EQ(drain(1, 100 - 64), 100);
+}
+
+/**
+ * @brief A gap in the stream empties the rings and keeps the following blocks aligned.
+ */
+static void test_skip(void)
+{
+    setup(0x0B, RING_CAPACITY); // Inputs 0, 1 and 3
+    uint32_t len = make_stream();
+
+    adc_deinterleave(&d, stream, 100);  // Rounds 0-32 and input 0 of round 33
+    adc_deinterleaver_skip(&d, 50);     // Samples 100-149 lost
+    for (uint32_t slot = 0; slot < 3; slot++)
+    {
+        CHECK_EQ(sample_ring_count(&rings[slot]), 0);
+    }
+    CHECK_EQ(d.phase, 150 % 3);
+
+    // Sample 150 is input 0 of round 50
+    adc_deinterleave(&d, &stream[150], len - 150);
+    for (uint32_t slot = 0; slot < 3; slot++)
+    {
+        sample_ring_skip(&rings[slot], sample_ring_count(&rings[slot]) - 10);
+        CHECK_EQ(drain(slot, ROUNDS - 10), ROUNDS);
+    }
+}
+
+/**
+ * @brief Ring reads and skips across the wrap of the 32-bit counters.
+ */
+static void test_ring_wrap(void)
+{
+    uint16_t buf[8];
+    setup(0x01, 8);
+    rings[0].head = rings[0].tail = 0xFFFFFFFCu;
+    make_stream();
+    adc_deinterleave(&d, stream, 6);
+    CHECK_EQ(sample_ring_count(&rings[0]), 6);
+    CHECK_EQ(sample_ring_skip(&rings[0], 2), 2);
+    CHECK_EQ(sample_ring_read(&rings[0], buf, 8), 4);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        CHECK_EQ(buf[i], sample(0, 2 + i));
+    }
+    CHECK_EQ(rings[0].tail, 2);
+    CHECK_EQ(sample_ring_read(&rings[0], buf, 8), 0);
+    CHECK_EQ(sample_ring_skip(&rings[0], 1), 0);
+}
+
+/**
+ * @brief An empty mask accepts blocks and does nothing.
+ */
+static void test_no_channels(void)
+{
+    setup(0x00, RING_CAPACITY);
+    adc_deinterleave(&d, stream, 10);
+    adc_deinterleaver_skip(&d, 3);
+    CHECK_EQ(d.phase, 0);
+    CHECK_EQ(sample_ring_count(&rings[0]), 0);
+}
+
+int main(void)
+{
+    test_channel_map();
+    test_all_masks();
+    test_overflow();
+    test_skip();
+    test_ring_wrap();
+    test_no_channels();
+    return host_test_result("test_deinterleave");
+}
@@ -0,0 +1,197 @@
+/**
+ * @file test_pingpong.c
+ * @brief Ping-pong bookkeeping against a simulated ADC and DMA.
+ *
+ * @details
+ * A repeating HAL timer stands in for the ADC FIFO and the DMA channel: every tick it
+ * converts one sample into the half being written and completes the half when it is full,
+ * as the DMA interrupt does. ADC input 0 plays a table whose value is the index of the
+ * conversion, so every sample tells where it came from. The consumer then runs fast, late,
+ * and holding a half for too long, and the test checks the blocks it sees, their sequence
+ * numbers and timestamps, and the overrun count against what the producer did.
+ */
+
+#include "hal.h"
+#include "hal_sim.h"
+#include "host_test.h"
+#include "pingpong.h"
+
+#define HALF_LEN 64u
+#define TICK_US 4u // One conversion every 4 us; the conversion itself takes 2 us
+#define TABLE_LEN 4096u
+#define HALF_US (HALF_LEN * TICK_US)
+
+static uint16_t table[TABLE_LEN];
+static uint16_t storage[2 * HALF_LEN];
+static pingpong_t pp;
+static uint32_t fill;      // Samples written into the current half
+static hal_timer_t dma_timer;
+
+static bool dma_tick(hal_timer_t *t)
+{
+    (void)t;
+    pingpong_half(&pp, pp.produced)[fill] = hal_adc_read();
+    if (++fill == HALF_LEN)
+    {
+        fill = 0;
+        pingpong_on_half_complete(&pp, hal_time_us());
+    }
+    return true;
+}
+
+static void start(void)
+{
+    hal_sim_reset();
+    hal_sim_set_end(0, NULL, NULL);
+    for (uint32_t i = 0; i < TABLE_LEN; i++)
+    {
+        table[i] = (uint16_t)i;
+    }
+    hal_sim_wave_t w = {.kind = HAL_SIM_TABLE, .table = table, .table_len = TABLE_LEN, .table_period_us = TICK_US};
+    hal_sim_adc_wave(0, &w);
+    hal_adc_init(0);
+
+    pingpong_init(&pp, storage, HALF_LEN);
+    fill = 0;
+    hal_timer_start(&dma_timer, TICK_US, dma_tick, NULL);
+}
+
+/**
+ * @brief Checks that a block holds the conversions of half number seq.
+ *
+ * Conversion k (from 1) runs at k * TICK_US and reads table entry k.
+ */
+static void check_block(const uint16_t *b, uint32_t seq)
+{
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < HALF_LEN; i++)
+    {
+        if (b[i] != (seq * HALF_LEN + i + 1u) % TABLE_LEN)
+        {
+            bad++;
+        }
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static const uint16_t *wait_block(uint32_t *seq)
+{
+    const uint16_t *b;
+    while ((b = pingpong_acquire(&pp, seq)) == NULL)
+    {
+        hal_idle();
+    }
+    return b;
+}
+
+/**
+ * @brief A consumer that keeps up sees every half once, in order, intact.
+ */
+static void test_fast_consumer(void)
+{
+    start();
+    for (uint32_t n = 0; n < 200; n++)
+    {
+        uint32_t seq;
+        const uint16_t *b = wait_block(&seq);
+        CHECK_EQ(seq, n);
+        check_block(b, seq);
+        CHECK_EQ(pingpong_stamp(&pp, seq), (uint64_t)(seq + 1u) * HALF_US + HAL_SIM_ADC_CONV_US);
+        hal_sleep_us(HALF_US / 4); // Work on the block for a quarter of its time
+        pingpong_release(&pp);
+    }
+    CHECK_EQ(pp.overruns, 0);
+    hal_timer_stop(&dma_timer);
+}
+
+/**
+ * @brief A consumer that falls behind gets the newest half and the rest count as overruns.
+ */
+static void test_late_consumer(void)
+{
+    start();
+    uint32_t delivered = 0;
+    uint32_t last = 0;
+    for (uint32_t n = 0; n < 100; n++)
+    {
+        uint32_t seq;
+        const uint16_t *b = wait_block(&seq);
+        CHECK_EQ(seq, pp.produced - 1u);
+        if (delivered)
+        {
+            CHECK(seq > last);
+        }
+        check_block(b, seq);
+        pingpong_release(&pp);
+        delivered++;
+        last = seq;
+
+        // Every fourth block, stall for 3.5 halves before asking for the next one: three
+        // halves complete meanwhile and only the newest is still intact
+        if (n % 4 == 3)
+        {
+            hal_sleep_us(HALF_US * 7 / 2);
+        }
+    }
+    // Every half up to the last one released was either delivered or counted as lost
+    CHECK_EQ(delivered + pp.overruns, last + 1u);
+    // The stall after the last block is not seen, the other 24 lose two halves each
+    CHECK_EQ(pp.overruns, 24u * 2u);
+    hal_timer_stop(&dma_timer);
+}
+
+/**
+ * @brief Holding a half while the producer wraps onto it is an overrun at release.
+ */
+static void test_held_too_long(void)
+{
+    start();
+    uint32_t seq;
+    wait_block(&seq);
+    CHECK_EQ(seq, 0);
+
+    // The next half completes, then the producer refills the one still held
+    hal_sleep_us(HALF_US + HALF_US / 2);
+    CHECK_EQ(pingpong_pending(&pp), 2);
+    CHECK(fill > 0);
+    pingpong_release(&pp);
+    CHECK_EQ(pp.overruns, 1);
+
+    // The consumer carries on with the next half, which is still intact
+    const uint16_t *b = wait_block(&seq);
+    CHECK_EQ(seq, 1);
+    check_block(b, seq);
+    pingpong_release(&pp);
+    CHECK_EQ(pp.overruns, 1);
+    hal_timer_stop(&dma_timer);
+}
+
+/**
+ * @brief The counters wrap around 2^32 without losing or inventing halves.
+ */
+static void test_counter_wrap(void)
+{
+    pingpong_init(&pp, storage, HALF_LEN);
+    pp.produced = pp.consumed = 0xFFFFFFFEu;
+    for (uint32_t n = 0; n < 4; n++)
+    {
+        uint32_t seq;
+        CHECK(pingpong_acquire(&pp, &seq) == NULL);
+        pingpong_on_half_complete(&pp, n);
+        CHECK(pingpong_acquire(&pp, &seq) == pingpong_half(&pp, 0xFFFFFFFEu + n));
+        CHECK_EQ(seq, (uint32_t)(0xFFFFFFFEu + n));
+        CHECK_EQ(pingpong_stamp(&pp, seq), n);
+        pingpong_release(&pp);
+    }
+    CHECK_EQ(pp.overruns, 0);
+    CHECK_EQ(pingpong_pending(&pp), 0);
+}
+
+int main(void)
+{
+    test_fast_consumer();
+    test_late_consumer();
+    test_held_too_long();
+    test_counter_wrap();
+    return host_test_result("test_pingpong");
+}
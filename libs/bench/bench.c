@@ -0,0 +1,153 @@
+/**
+ * @file bench.c
+ * @brief Per-stage cost, throughput, latency and idle-time accounting for a block pipeline,
+ * with a JSON report.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+
+#define US_PER_S 1000000u
+#define NS_PER_S 1000000000u
+
+void bench_init(bench_pipeline_t *p, const char *name, uint32_t sample_rate_hz, uint32_t block_samples,
+                uint64_t start_us)
+{
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+    p->sample_rate_hz = sample_rate_hz;
+    p->block_samples = block_samples;
+    p->start_us = start_us;
+    p->end_us = start_us;
+}
+
+int bench_add_stage(bench_pipeline_t *p, const char *name)
+{
+    if (p->n_stages >= BENCH_MAX_STAGES)
+    {
+        return -1;
+    }
+    bench_stage_t *s = &p->stages[p->n_stages];
+    s->name = name;
+    s->min = UINT32_MAX;
+    return p->n_stages++;
+}
+
+void bench_stage_add(bench_pipeline_t *p, int stage, uint32_t count)
+{
+    bench_stage_t *s = &p->stages[stage];
+    s->calls++;
+    s->total += count;
+    if (count < s->min)
+    {
+        s->min = count;
+    }
+    if (count > s->max)
+    {
+        s->max = count;
+    }
+}
+
+void bench_block_done(bench_pipeline_t *p, uint64_t ready_us, uint64_t start_us, uint64_t done_us, size_t bytes)
+{
+    uint32_t latency = (uint32_t)(done_us - ready_us);
+
+    p->blocks++;
+    p->samples += p->block_samples;
+    p->bytes += bytes;
+    p->busy_us += done_us - start_us;
+    p->latency_sum_us += latency;
+    if (latency > p->latency_max_us)
+    {
+        p->latency_max_us = latency;
+    }
+}
+
+void bench_overrun(bench_pipeline_t *p, uint32_t blocks)
+{
+    p->overruns += blocks;
+}
+
+void bench_finish(bench_pipeline_t *p, uint64_t end_us)
+{
+    p->end_us = end_us;
+}
+
+uint32_t bench_sustained_sps(const bench_pipeline_t *p)
+{
+    uint64_t elapsed = p->end_us - p->start_us;
+    return elapsed ? (uint32_t)(p->samples * US_PER_S / elapsed) : 0u;
+}
+
+uint32_t bench_capacity_sps(const bench_pipeline_t *p)
+{
+    return p->busy_us ? (uint32_t)(p->samples * US_PER_S / p->busy_us) : 0u;
+}
+
+uint32_t bench_idle_permille(const bench_pipeline_t *p)
+{
+    uint64_t elapsed = p->end_us - p->start_us;
+    if (elapsed == 0 || p->busy_us >= elapsed)
+    {
+        return 0u;
+    }
+    return (uint32_t)((elapsed - p->busy_us) * 1000u / elapsed);
+}
+
+/**
+ * @brief Converts counter ticks to nanoseconds.
+ */
+static unsigned long long ticks_ns(uint64_t ticks, uint32_t counter_hz)
+{
+    return counter_hz ? (unsigned long long)(ticks * NS_PER_S / counter_hz) : 0ull;
+}
+
+static void print_stage(const bench_stage_t *s, uint32_t counter_hz)
+{
+    uint64_t mean = s->calls ? s->total / s->calls : 0u;
+    printf("{\"name\":\"%s\",\"calls\":%lu,\"min\":%lu,\"mean\":%llu,\"max\":%lu,\"mean_ns\":%llu,"
+           "\"max_ns\":%llu}",
+           s->name, (unsigned long)s->calls, (unsigned long)(s->calls ? s->min : 0u), (unsigned long long)mean,
+           (unsigned long)s->max, ticks_ns(mean, counter_hz), ticks_ns(s->max, counter_hz));
+}
+
+static void print_pipeline(const bench_pipeline_t *p, uint32_t counter_hz)
+{
+    uint32_t idle = bench_idle_permille(p);
+
+    printf("{\"name\":\"%s\",\"sample_rate_hz\":%lu,\"block_samples\":%lu,\"blocks\":%lu,\"overruns\":%lu,"
+           "\"samples\":%llu,\"bytes\":%llu,\"elapsed_us\":%llu,\"busy_us\":%llu,",
+           p->name, (unsigned long)p->sample_rate_hz, (unsigned long)p->block_samples, (unsigned long)p->blocks,
+           (unsigned long)p->overruns, (unsigned long long)p->samples, (unsigned long long)p->bytes,
+           (unsigned long long)(p->end_us - p->start_us), (unsigned long long)p->busy_us);
+    printf("\"sustained_sps\":%lu,\"capacity_sps\":%lu,\"idle_pct\":%lu.%lu,"
+           "\"latency_us\":{\"mean\":%llu,\"max\":%lu},\"stages\":[",
+           (unsigned long)bench_sustained_sps(p), (unsigned long)bench_capacity_sps(p), (unsigned long)(idle / 10u),
+           (unsigned long)(idle % 10u), (unsigned long long)(p->blocks ? p->latency_sum_us / p->blocks : 0u),
+           (unsigned long)p->latency_max_us);
+    for (uint8_t i = 0; i < p->n_stages; i++)
+    {
+        if (i)
+        {
+            putchar(',');
+        }
+        print_stage(&p->stages[i], counter_hz);
+    }
+    printf("]}");
+}
+
+void bench_print_json(const char *target, uint32_t counter_hz, const bench_pipeline_t *p, size_t n)
+{
+    printf("{\"target\":\"%s\",\"counter_hz\":%lu,\"pipelines\":[", target, (unsigned long)counter_hz);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i)
+        {
+            putchar(',');
+        }
+        printf("\n");
+        print_pipeline(&p[i], counter_hz);
+    }
+    printf("\n]}\n");
+}
@@ -0,0 +1,137 @@
+/**
+ * @file bench.h
+ * @brief Per-stage cost, throughput, latency and idle-time accounting for a block pipeline,
+ * with a JSON report.
+ *
+ * @details
+ * A pipeline takes blocks of samples that become ready at a fixed rate and runs each one
+ * through a list of stages (acquisition, filtering, formatting, transmission, ...). The
+ * caller times every stage with any free-running counter (clk_sys cycles, nanoseconds) and
+ * passes the count to bench_stage_add(); the minimum, maximum and total per stage are kept.
+ *
+ * bench_block_done() records a block against the microsecond clock: the time it became
+ * ready, the time its processing started and the time its last stage finished. From these
+ * the report derives
+ *
+ * - the sustained rate: samples processed per second of elapsed time,
+ * - the capacity: samples per second of busy time, i.e. the rate the stages could keep up
+ *   with if the processor never waited for a block,
+ * - the latency from a block being ready to its last byte being sent (mean and worst case),
+ * - the idle share: the part of the elapsed time not spent processing blocks.
+ *
+ * bench_print_json() writes the results of several pipelines as one JSON object on stdout,
+ * so runs can be stored and compared with a script.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BENCH_MAX_STAGES 6u ///< Stages per pipeline.
+
+typedef struct bench_stage
+{
+    const char *name; ///< Stage name in the report.
+    uint32_t calls;   ///< Times the stage ran.
+    uint64_t total;   ///< Sum of the counts.
+    uint32_t min;     ///< Cheapest run.
+    uint32_t max;     ///< Most expensive run.
+} bench_stage_t;
+
+typedef struct bench_pipeline
+{
+    const char *name;                       ///< Pipeline name in the report.
+    uint32_t sample_rate_hz;                ///< Rate samples arrive at.
+    uint32_t block_samples;                 ///< Samples per block.
+    bench_stage_t stages[BENCH_MAX_STAGES]; ///< Stage costs.
+    uint8_t n_stages;                       ///< Stages in use.
+
+    uint32_t blocks;         ///< Blocks processed.
+    uint32_t overruns;       ///< Blocks lost because processing fell a whole block behind.
+    uint64_t samples;        ///< Samples processed.
+    uint64_t bytes;          ///< Bytes transmitted.
+    uint64_t start_us;       ///< Start of the run.
+    uint64_t end_us;         ///< End of the run.
+    uint64_t busy_us;        ///< Time spent processing blocks.
+    uint64_t latency_sum_us; ///< Sum of the ready-to-sent latencies.
+    uint32_t latency_max_us; ///< Worst ready-to-sent latency.
+} bench_pipeline_t;
+
+/**
+ * @brief Initializes a pipeline's accounting.
+ *
+ * @param p Pointer to the pipeline.
+ * @param name Name in the report (not copied).
+ * @param sample_rate_hz Rate samples arrive at.
+ * @param block_samples Samples per block.
+ * @param start_us Start of the run.
+ */
+void bench_init(bench_pipeline_t *p, const char *name, uint32_t sample_rate_hz, uint32_t block_samples,
+                uint64_t start_us);
+
+/**
+ * @brief Adds a stage.
+ *
+ * @param name Name in the report (not copied).
+ * @return int Stage index, or -1 if BENCH_MAX_STAGES are in use.
+ */
+int bench_add_stage(bench_pipeline_t *p, const char *name);
+
+/**
+ * @brief Records one run of a stage.
+ *
+ * @param stage Index from bench_add_stage().
+ * @param count Counter ticks the stage took.
+ */
+void bench_stage_add(bench_pipeline_t *p, int stage, uint32_t count);
+
+/**
+ * @brief Records a processed block.
+ *
+ * @param ready_us Time the block became ready.
+ * @param start_us Time its processing started.
+ * @param done_us Time its last stage finished.
+ * @param bytes Bytes transmitted for it.
+ */
+void bench_block_done(bench_pipeline_t *p, uint64_t ready_us, uint64_t start_us, uint64_t done_us, size_t bytes);
+
+/**
+ * @brief Records blocks lost to an overrun.
+ */
+void bench_overrun(bench_pipeline_t *p, uint32_t blocks);
+
+/**
+ * @brief Ends the run.
+ */
+void bench_finish(bench_pipeline_t *p, uint64_t end_us);
+
+/**
+ * @brief Samples per second of elapsed time, 0 for an empty run.
+ */
+uint32_t bench_sustained_sps(const bench_pipeline_t *p);
+
+/**
+ * @brief Samples per second of busy time, 0 if nothing was processed.
+ */
+uint32_t bench_capacity_sps(const bench_pipeline_t *p);
+
+/**
+ * @brief Idle share of the elapsed time in tenths of a percent (0 .. 1000).
+ */
+uint32_t bench_idle_permille(const bench_pipeline_t *p);
+
+/**
+ * @brief Writes the report of several pipelines as one JSON object on stdout.
+ *
+ * @param target Where the run took place, e.g. "rp2040" or "host".
+ * @param counter_hz Rate of the stage counter, so counts convert to time.
+ * @param p Pipelines.
+ * @param n Number of pipelines.
+ */
+void bench_print_json(const char *target, uint32_t counter_hz, const bench_pipeline_t *p, size_t n);
+
+#endif // BENCH_H
@@ -0,0 +1,48 @@
+# Build-time configuration: generates build_config.h and build_config.c for a target.
+# Included from a project's CMakeLists.txt with include(), after project().
+#
+#   build_config(<target> SAMPLE_RATE_HZ <hz> BLOCK_LENGTH <n>
+#                [ADC_CHANNEL_MASK <mask>] [OVERSAMPLING <n>] [BAUD <baud>] [TIMER_PACED]
+#                [FIR_CUTOFF_HZ <hz> [FIR_TAPS <n>]] [BIQUAD_CUTOFF_HZ <hz>] [VREF_MV <mv>]
+#                [CIC_COMP_TAPS <n>] [FRAME_BITS <12|16>])
+#
+# The files are written when CMake configures the project (gen_config.py), so changing a
+# parameter, e.g. with cmake -DSAMPLE_RATE_HZ=10000 when the project keeps its parameters in
+# cache variables, regenerates them. A rejected filter design stops the configure step; an
+# impossible rate/baud combination stops the build at a static assert.
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+set(BUILD_CONFIG_GENERATOR ${CMAKE_CURRENT_LIST_DIR}/gen_config.py)
+
+function(build_config target)
+    cmake_parse_arguments(PARSE_ARGV 1 CFG "TIMER_PACED"
+        "SAMPLE_RATE_HZ;BLOCK_LENGTH;ADC_CHANNEL_MASK;OVERSAMPLING;BAUD;FIR_CUTOFF_HZ;FIR_TAPS;BIQUAD_CUTOFF_HZ;VREF_MV;CIC_COMP_TAPS;FRAME_BITS" "")
+
+    set(args --sample-rate ${CFG_SAMPLE_RATE_HZ} --block ${CFG_BLOCK_LENGTH})
+    foreach(param ADC_CHANNEL_MASK OVERSAMPLING BAUD FIR_CUTOFF_HZ FIR_TAPS BIQUAD_CUTOFF_HZ VREF_MV CIC_COMP_TAPS FRAME_BITS)
+        if (DEFINED CFG_${param})
+            string(TOLOWER ${param} option)
+            string(REPLACE "_" "-" option ${option})
+            string(REGEX REPLACE "-hz$" "" option ${option})
+            list(APPEND args --${option} ${CFG_${param}})
+        endif()
+    endforeach()
+    if (CFG_TIMER_PACED)
+        list(APPEND args --timer-paced)
+    endif()
+
+    # One directory per target, so several configurations can be built in one project
+    set(out ${CMAKE_CURRENT_BINARY_DIR}/build_config/${target})
+    execute_process(
+        COMMAND ${Python3_EXECUTABLE} ${BUILD_CONFIG_GENERATOR} --out ${out} --name ${target} ${args}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE error
+    )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "build_config(${target}) failed: ${error}")
+    endif()
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${BUILD_CONFIG_GENERATOR})
+
+    target_sources(${target} PRIVATE ${out}/build_config.c)
+    target_include_directories(${target} PRIVATE ${out})
+endfunction()
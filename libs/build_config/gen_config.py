@@ -0,0 +1,371 @@
+"""
+Generates the build-time configuration of a project: build_config.h and build_config.c.
+
+Called by build_config() (build_config.cmake) when CMake configures the project, with the
+parameters set in the project's CMakeLists.txt or overridden on the cmake command line. From
+the sample rate, block length, channel mask, oversampling and link baud rate it derives the
+ADC clock divider, the DMA transfer count of a ping-pong half, the block period, the link
+load and the fixed-point ADC-to-millivolt scale, and it designs the filter tables:
+
+- a Hamming-windowed FIR low-pass in Q15 (as design_filters.py fir, without scipy),
+- a 2nd-order Butterworth low-pass biquad in Q14 (as design_filters.py biquad 2),
+- the Q15 FIR that compensates the sinc^4 droop of the CIC decimator (cic_decim.c) when the
+  oversampling factor is the CIC decimation factor.
+
+The header checks the rate/baud combinations with static asserts, so an impossible
+configuration does not compile; the sample frames may take at most 80% of the link. The tables are checked here before they are written: the
+quantized filters must match the floating-point design (DC gain, passband error, symmetry,
+stability), otherwise the generator fails and so does the CMake configure step.
+
+Only the standard library is used, so the build needs nothing beyond Python 3.
+
+Usage:
+    python gen_config.py --out DIR --name PROJECT --sample-rate HZ --block N
+                         [--adc-channel-mask M] [--oversampling N] [--baud B] [--timer-paced]
+                         [--fir-cutoff HZ --fir-taps N] [--biquad-cutoff HZ] [--vref-mv MV]
+                         [--cic-comp-taps N] [--frame-bits 12|16]
+"""
+
+import argparse
+import math
+import os
+import sys
+
+ADC_CLOCK_HZ = 48000000  # clk_adc, as ADC_CAPTURE_CLOCK_HZ
+ADC_CYCLES = 96          # clk_adc cycles per conversion
+ADC_BITS = 12
+UART_CHAR_BITS = 10      # 8N1
+LINK_MAX_LOAD_PCT = 80   # Share of the link the sample frames may take
+FRAME_OVERHEAD = 10      # RAW12/RAW16 frame header and CRC (sample_frame.h)
+CIC_ORDER = 4            # CIC_ORDER in fixed_filter.h
+CIC_MIN_FACTOR = 4
+CIC_MAX_FACTOR = 256
+CIC_PASSBAND = 0.2       # Flat band of CIC + compensation, fraction of the output rate
+CIC_COMP_CUTOFF = 0.3    # Edge of the compensation's ideal response, same unit
+MAX_CIC_DROOP_DB = 0.25
+
+MAX_PASSBAND_ERROR_DB = 0.1
+
+
+class ConfigError(Exception):
+    pass
+
+
+def raw12_frame_len(n):
+    """Bytes of a RAW12 frame of n samples (SAMPLE_FRAME_RAW12_LEN)."""
+    return FRAME_OVERHEAD + (n * 3 + 1) // 2
+
+
+def raw16_frame_len(n):
+    """Bytes of a RAW16 frame of n samples (SAMPLE_FRAME_WORDS16_LEN)."""
+    return FRAME_OVERHEAD + 2 * n
+
+
+def adc_clkdiv(rate_hz):
+    """ADC divider as (integer, 1/256 fraction, achieved rate in mHz), as adc_capture_clkdiv()."""
+    if rate_hz >= ADC_CLOCK_HZ // ADC_CYCLES:
+        return 0, 0, ADC_CLOCK_HZ * 1000 // ADC_CYCLES
+    div = round((ADC_CLOCK_HZ / rate_hz - 1.0) * 256)
+    actual_mhz = round(ADC_CLOCK_HZ * 1000 * 256 / (div + 256))
+    return div >> 8, div & 0xFF, actual_mhz
+
+
+def quantize(values, frac_bits):
+    """Rounds to signed 16-bit fixed point with frac_bits fractional bits."""
+    return [max(-32768, min(32767, round(v * (1 << frac_bits)))) for v in values]
+
+
+def response_db(b, a, f, fs):
+    """Magnitude of b(z)/a(z) at frequency f, in dB."""
+    w = 2 * math.pi * f / fs
+    z = [complex(math.cos(-w * k), math.sin(-w * k)) for k in range(max(len(b), len(a)))]
+    num = sum(bk * z[k] for k, bk in enumerate(b))
+    den = sum(ak * z[k] for k, ak in enumerate(a))
+    return 20 * math.log10(abs(num / den) + 1e-12)
+
+
+def design_fir(fs, cutoff, taps):
+    """Hamming-windowed sinc low-pass with unit DC gain (scipy.signal.firwin)."""
+    c = 2.0 * cutoff / fs
+    h = []
+    for n in range(taps):
+        m = n - (taps - 1) / 2.0
+        sinc = 1.0 if m == 0 else math.sin(math.pi * c * m) / (math.pi * c * m)
+        window = 0.54 - 0.46 * math.cos(2 * math.pi * n / (taps - 1))
+        h.append(c * sinc * window)
+    s = sum(h)
+    return [v / s for v in h]
+
+
+def check_fir(h, q, fs, cutoff):
+    taps = len(q)
+    if any(q[i] != q[taps - 1 - i] for i in range(taps)):
+        raise ConfigError('FIR taps are not symmetric')
+    if abs(sum(q) - 32768) > taps:
+        raise ConfigError('FIR DC gain is %d / 32768' % sum(q))
+    if sum(abs(v) for v in q) >= 2 * 32768:
+        raise ConfigError('sum(|h|) >= 2, the 32-bit accumulator of fir_q15 can overflow')
+    err = 0.0
+    for k in range(64):
+        f = cutoff * k / 64.0
+        err = max(err, abs(response_db([v / 32768.0 for v in q], [1.0], f, fs) - response_db(h, [1.0], f, fs)))
+    if err > MAX_PASSBAND_ERROR_DB:
+        raise ConfigError('FIR passband error %.3f dB after quantization' % err)
+    return err
+
+
+def design_biquad(fs, cutoff):
+    """2nd-order Butterworth low-pass by the bilinear transform (scipy.signal.butter)."""
+    k = math.tan(math.pi * cutoff / fs)
+    norm = 1.0 / (1.0 + math.sqrt(2.0) * k + k * k)
+    b0 = k * k * norm
+    return [b0, 2 * b0, b0, 2.0 * (k * k - 1.0) * norm, (1.0 - math.sqrt(2.0) * k + k * k) * norm]
+
+
+def check_biquad(c, q, fs, cutoff):
+    b0, b1, b2, a1, a2 = (v / 16384.0 for v in q)
+    if not (abs(a2) < 1.0 and abs(a1) < 1.0 + a2):
+        raise ConfigError('biquad poles are not inside the unit circle after quantization')
+    dc = (b0 + b1 + b2) / (1.0 + a1 + a2)
+    if abs(dc - 1.0) > 0.01:
+        raise ConfigError('biquad DC gain is %.4f after quantization' % dc)
+    err = 0.0
+    for k in range(64):
+        f = cutoff * k / 64.0
+        err = max(err, abs(response_db([b0, b1, b2], [1.0, a1, a2], f, fs) -
+                           response_db(c[:3], [1.0] + c[3:], f, fs)))
+    if err > MAX_PASSBAND_ERROR_DB:
+        raise ConfigError('biquad passband error %.3f dB after quantization' % err)
+    return err
+
+
+def cic_response(f, r):
+    """Magnitude of the normalized CIC at f cycles per output sample."""
+    if f == 0:
+        return 1.0
+    return abs(math.sin(math.pi * f) / (r * math.sin(math.pi * f / r))) ** CIC_ORDER
+
+
+def design_cic_comp(r, taps):
+    """
+    Hamming-windowed FIR at the output rate whose response is 1 / CIC up to CIC_COMP_CUTOFF
+    and 0 above it, with unit DC gain. The ideal taps are integrated numerically.
+    """
+    grid = 2048
+    h = []
+    for n in range(taps):
+        m = n - (taps - 1) / 2.0
+        acc = 0.0
+        for k in range(grid):
+            f = (k + 0.5) / grid * CIC_COMP_CUTOFF
+            acc += math.cos(2 * math.pi * f * m) / cic_response(f, r)
+        window = 0.54 - 0.46 * math.cos(2 * math.pi * n / (taps - 1))
+        h.append(2.0 * CIC_COMP_CUTOFF / grid * acc * window)
+    s = sum(h)
+    return [v / s for v in h]
+
+
+def check_cic_comp(q, r):
+    taps = len(q)
+    if any(q[i] != q[taps - 1 - i] for i in range(taps)):
+        raise ConfigError('CIC compensation taps are not symmetric')
+    if abs(sum(q) - 32768) > taps:
+        raise ConfigError('CIC compensation DC gain is %d / 32768' % sum(q))
+    if sum(abs(v) for v in q) >= 2 * 32768:
+        raise ConfigError('CIC compensation sum(|h|) >= 2, use fewer taps')
+    err = 0.0
+    for k in range(65):
+        f = CIC_PASSBAND * k / 64.0
+        gain = cic_response(f, r) * math.pow(10, response_db([v / 32768.0 for v in q], [1.0], f, 1.0) / 20)
+        err = max(err, abs(20 * math.log10(gain)))
+    if err > MAX_CIC_DROOP_DB:
+        raise ConfigError('CIC + compensation passband error %.3f dB' % err)
+    return err
+
+
+def c_array(ctype, name, values, per_line=8):
+    lines = ['const %s %s[%d] = {' % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    lines.append('};')
+    return lines
+
+
+def generate(args):
+    if args.sample_rate <= 0 or args.block <= 0 or args.oversampling <= 0:
+        raise ConfigError('sample rate, block length and oversampling must be positive')
+    if args.frame_bits not in (12, 16):
+        raise ConfigError('frame bits must be 12 or 16')
+    channels = bin(args.adc_channel_mask & 0x1F).count('1')
+    adc_rate = args.sample_rate * channels * args.oversampling
+    div_int, div_frac, actual_mhz = adc_clkdiv(adc_rate) if adc_rate else (0, 0, 0)
+    period_ns = 1000000000 // args.sample_rate
+    period_exact = 1000000 % args.sample_rate == 0
+    blocks_per_s = math.ceil(args.sample_rate * channels / args.block)
+    frame_len = raw16_frame_len(args.block) if args.frame_bits == 16 else raw12_frame_len(args.block)
+    link_bytes = blocks_per_s * frame_len
+    vref_q16 = round(args.vref_mv * 65536 / (1 << ADC_BITS))
+
+    h = ['/**',
+         ' * @file build_config.h',
+         ' * @brief Build-time configuration of %s.' % args.name,
+         ' *',
+         ' * @details',
+         ' * Generated by libs/build_config/gen_config.py when CMake configures the project. Do not',
+         ' * edit: change the parameters in the project\'s CMakeLists.txt, or override them on the',
+         ' * cmake command line (e.g. -DSAMPLE_RATE_HZ=10000).',
+         ' */',
+         '',
+         '#ifndef BUILD_CONFIG_H',
+         '#define BUILD_CONFIG_H',
+         '',
+         '#include <stdint.h>']
+    if args.fir_cutoff or args.biquad_cutoff or args.cic_comp_taps:
+        h.append('#include "fixed_filter.h"')
+    h += ['',
+          '// Sampling',
+          '#define CFG_SAMPLE_RATE_HZ %du ///< Samples per second of each channel.' % args.sample_rate,
+          '#define CFG_SAMPLE_PERIOD_NS %du ///< Time between two samples of a channel.' % period_ns,
+          '#define CFG_SAMPLE_PERIOD_US %du ///< The same, in whole microseconds.' % (period_ns // 1000),
+          '#define CFG_SAMPLE_PERIOD_EXACT %d ///< 1 if CFG_SAMPLE_PERIOD_US is exact.' % int(period_exact),
+          '#define CFG_BLOCK_LENGTH %du ///< Samples per block and per frame.' % args.block,
+          '#define CFG_BLOCK_PERIOD_US %du ///< Time to fill one block.' % (args.block * 1000000 // args.sample_rate),
+          '#define CFG_ADC_CHANNEL_MASK 0x%02Xu ///< ADC inputs captured (bit 4: temperature sensor).' % args.adc_channel_mask,
+          '#define CFG_ADC_CHANNELS %du ///< Inputs in CFG_ADC_CHANNEL_MASK.' % channels,
+          '#define CFG_OVERSAMPLING %du ///< ADC conversions per output sample.' % args.oversampling,
+          '',
+          '// ADC and DMA',
+          '#define CFG_ADC_PACED %d ///< 1 if the ADC clock divider sets the rate, 0 for a timer.' % int(not args.timer_paced),
+          '#define CFG_ADC_RATE_HZ %du ///< ADC conversions per second over all inputs.' % adc_rate,
+          '#define CFG_ADC_CLKDIV_INT %du ///< ADC clock divider, integer part.' % div_int,
+          '#define CFG_ADC_CLKDIV_FRAC %du ///< ADC clock divider, fraction in 1/256.' % div_frac,
+          '#define CFG_ADC_CLKDIV %.8ff ///< ADC clock divider, for adc_set_clkdiv().' % (div_int + div_frac / 256.0),
+          '#define CFG_ADC_ACTUAL_RATE_MHZ %dull ///< Conversion rate the divider gives, in mHz.' % actual_mhz,
+          '#define CFG_DMA_TRANSFERS %du ///< Conversions per ping-pong half.' % (args.block * channels * args.oversampling),
+          '',
+          '// Link',
+          '#define CFG_LINK_BAUD %du ///< UART baud rate, 0 for a USB-only link.' % args.baud,
+          '#define CFG_FRAME_BITS %du ///< Bits per sample on the link: 12 (RAW12) or 16 (RAW16).' % args.frame_bits,
+          '#define CFG_LINK_BYTES_PER_S %du ///< Bytes per second of the sample frames.' % link_bytes,
+          '#define CFG_LINK_MAX_LOAD_PCT %du ///< Most of the link the sample frames may take, in percent.' % LINK_MAX_LOAD_PCT,
+          '',
+          '// Conversions',
+          '#define CFG_ADC_VREF_MV %du ///< ADC reference voltage.' % args.vref_mv,
+          '#define CFG_ADC_MV_Q16 %du ///< Millivolts per ADC count, Q16.' % vref_q16,
+          '/// ADC code to millivolts, rounded.',
+          '#define CFG_ADC_TO_MV(code) ((uint32_t)(((uint32_t)(code) * CFG_ADC_MV_Q16 + 0x8000u) >> 16))',
+          '']
+    c = ['/**',
+         ' * @file build_config.c',
+         ' * @brief Generated tables of %s (see build_config.h).' % args.name,
+         ' */',
+         '',
+         '#include "build_config.h"',
+         '']
+
+    if args.fir_cutoff:
+        if not 0 < args.fir_cutoff < args.sample_rate / 2 or args.fir_taps < 3:
+            raise ConfigError('FIR cutoff must be below fs / 2 with at least 3 taps')
+        fir = design_fir(args.sample_rate, args.fir_cutoff, args.fir_taps)
+        q = quantize(fir, 15)
+        err = check_fir(fir, q, args.sample_rate, args.fir_cutoff)
+        h += ['// Low-pass FIR: %d-tap Hamming, fs = %d Hz, cutoff = %d Hz, passband error %.3f dB' %
+              (args.fir_taps, args.sample_rate, args.fir_cutoff, err),
+              '#define CFG_LOWPASS_CUTOFF_HZ %du ///< Cutoff (-6 dB) of cfg_lowpass_taps.' % args.fir_cutoff,
+              '#define CFG_LOWPASS_TAPS %du ///< Taps of cfg_lowpass_taps.' % args.fir_taps,
+              'extern const q15_t cfg_lowpass_taps[CFG_LOWPASS_TAPS]; ///< Q15 taps.',
+              '']
+        c += c_array('q15_t', 'cfg_lowpass_taps', q) + ['']
+
+    if args.biquad_cutoff:
+        if not 0 < args.biquad_cutoff < args.sample_rate / 2:
+            raise ConfigError('biquad cutoff must be below fs / 2')
+        bq = design_biquad(args.sample_rate, args.biquad_cutoff)
+        q = quantize(bq, 14)
+        err = check_biquad(bq, q, args.sample_rate, args.biquad_cutoff)
+        h += ['// Smoothing biquad: 2nd-order Butterworth, fs = %d Hz, cutoff = %d Hz, passband error %.3f dB' %
+              (args.sample_rate, args.biquad_cutoff, err),
+              '#define CFG_SMOOTHING_CUTOFF_HZ %du ///< Cutoff (-3 dB) of cfg_smoothing_sos.' % args.biquad_cutoff,
+              '#define CFG_SMOOTHING_SECTIONS 1u ///< Sections of cfg_smoothing_sos.',
+              'extern const biquad_coeffs_q14_t cfg_smoothing_sos[CFG_SMOOTHING_SECTIONS]; ///< Q14 sections.',
+              '']
+        c += ['const biquad_coeffs_q14_t cfg_smoothing_sos[CFG_SMOOTHING_SECTIONS] = {',
+              '    {.b0 = %d, .b1 = %d, .b2 = %d, .a1 = %d, .a2 = %d},' % tuple(q),
+              '};',
+              '']
+
+    if args.cic_comp_taps:
+        r = args.oversampling
+        if not CIC_MIN_FACTOR <= r <= CIC_MAX_FACTOR or args.cic_comp_taps < 3:
+            raise ConfigError('CIC decimation needs an oversampling factor of %d to %d and at least 3 taps' %
+                              (CIC_MIN_FACTOR, CIC_MAX_FACTOR))
+        q = quantize(design_cic_comp(r, args.cic_comp_taps), 15)
+        err = check_cic_comp(q, r)
+        h += ['// CIC compensation FIR: %d taps, R = %d, CIC + FIR flat to %.3f dB up to %.2f fs' %
+              (args.cic_comp_taps, r, err, CIC_PASSBAND),
+              '#define CFG_CIC_DECIMATION %du ///< CIC decimation factor (CFG_OVERSAMPLING).' % r,
+              '#define CFG_CIC_COMP_TAPS %du ///< Taps of cfg_cic_comp_taps.' % args.cic_comp_taps,
+              'extern const q15_t cfg_cic_comp_taps[CFG_CIC_COMP_TAPS]; ///< Q15 taps.',
+              '']
+        c += c_array('q15_t', 'cfg_cic_comp_taps', q) + ['']
+
+    h += ['// Impossible configurations',
+          '_Static_assert(CFG_ADC_CHANNELS > 0, "CFG_ADC_CHANNEL_MASK selects no input");',
+          '_Static_assert(CFG_ADC_RATE_HZ <= 500000u, "ADC conversion rate above 500 kS/s");',
+          '_Static_assert(!CFG_ADC_PACED || CFG_ADC_CLKDIV_INT <= 0xFFFFu,',
+          '               "ADC rate below the slowest clock divider (733 S/s)");',
+          '_Static_assert(CFG_ADC_PACED || CFG_SAMPLE_PERIOD_EXACT,',
+          '               "A timer-paced sample rate must give a whole number of microseconds");',
+          '// The rest of the link is left for status frames and for a late block to catch up',
+          '_Static_assert(CFG_LINK_BAUD == 0 ||',
+          '               CFG_LINK_BAUD / %du * CFG_LINK_MAX_LOAD_PCT / 100u >= CFG_LINK_BYTES_PER_S,' % UART_CHAR_BITS,
+          '               "The link baud rate cannot carry the sample frames at this sample rate in "',
+          '               "%d%% of its bandwidth");' % LINK_MAX_LOAD_PCT,
+          '',
+          '#endif // BUILD_CONFIG_H',
+          '']
+    return '\n'.join(h), '\n'.join(c)
+
+
+def write_if_changed(path, text):
+    """Leaves an unchanged file alone so its dependents are not rebuilt."""
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate build_config.h and build_config.c.')
+    parser.add_argument('--out', required=True, help='output directory')
+    parser.add_argument('--name', required=True, help='project name, for the comments')
+    parser.add_argument('--sample-rate', type=int, required=True, help='samples per second of each channel')
+    parser.add_argument('--block', type=int, required=True, help='samples per block')
+    parser.add_argument('--adc-channel-mask', type=lambda s: int(s, 0), default=1, help='ADC inputs')
+    parser.add_argument('--oversampling', type=int, default=1, help='conversions per sample')
+    parser.add_argument('--baud', type=int, default=0, help='UART link baud rate, 0 for USB')
+    parser.add_argument('--timer-paced', action='store_true', help='samples are timed by a timer, not the ADC')
+    parser.add_argument('--fir-cutoff', type=int, default=0, help='FIR low-pass cutoff in Hz')
+    parser.add_argument('--fir-taps', type=int, default=31, help='FIR taps')
+    parser.add_argument('--biquad-cutoff', type=int, default=0, help='Butterworth biquad cutoff in Hz')
+    parser.add_argument('--cic-comp-taps', type=int, default=0,
+                        help='CIC compensation FIR taps, for a CIC decimating by the oversampling factor')
+    parser.add_argument('--frame-bits', type=int, default=12, help='bits per sample on the link (12 or 16)')
+    parser.add_argument('--vref-mv', type=int, default=3300, help='ADC reference in millivolts')
+    args = parser.parse_args()
+
+    try:
+        header, source = generate(args)
+    except ConfigError as e:
+        print('gen_config.py: %s: %s' % (args.name, e), file=sys.stderr)
+        return 1
+    os.makedirs(args.out, exist_ok=True)
+    write_if_changed(os.path.join(args.out, 'build_config.h'), header)
+    write_if_changed(os.path.join(args.out, 'build_config.c'), source)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
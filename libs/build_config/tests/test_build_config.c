@@ -0,0 +1,302 @@
+/**
+ * @file test_build_config.c
+ * @brief The constants and tables generated by gen_config.py, checked against what they claim.
+ *
+ * @details
+ * The test is built once per configuration, each with its own build_config.h (see
+ * CMakeLists.txt), and checks whatever that configuration generated:
+ *
+ * - the sampling constants, DMA transfer count and link load are recomputed from the
+ *   parameters, and the ADC divider must be the nearest 1/256 step to the exact one;
+ * - CFG_ADC_TO_MV() must be within 0.54 mV of the exact conversion for every 12-bit code;
+ * - the low-pass FIR, the smoothing biquad and the CIC compensation are run on tones
+ *   through the library filters (fixed_filter.h) that the firmware uses them with, and the
+ *   measured gains must meet the design: unit DC gain, a flat passband, the cutoff where it
+ *   was asked for and, for the FIR, the stopband of a Hamming window.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "build_config.h"
+#include "fixed_filter.h"
+#include "host_test.h"
+#include "sample_frame.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ADC_CLOCK_HZ 48000000.0 // clk_adc (ADC_CAPTURE_CLOCK_HZ)
+#define TONE_PERIODS 1000       // Samples a gain is measured over
+#define SETTLE 2000             // Samples run before measuring
+
+/**
+ * @brief Gain in dB of a tone at k / TONE_PERIODS cycles per sample, from its amplitude in
+ *        and out; the samples span a whole number of cycles, so the DC offset drops out.
+ */
+static double tone_gain_db(const double *y, size_t n, int k, double amplitude)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double w = 2.0 * M_PI * k * (double)i / TONE_PERIODS;
+        re += y[i] * cos(w);
+        im += y[i] * sin(w);
+    }
+    return 20.0 * log10(2.0 * sqrt(re * re + im * im) / n / amplitude);
+}
+
+static void test_sampling(void)
+{
+    CHECK_EQ(CFG_SAMPLE_PERIOD_NS, 1000000000u / CFG_SAMPLE_RATE_HZ);
+    CHECK_EQ(CFG_SAMPLE_PERIOD_US, CFG_SAMPLE_PERIOD_NS / 1000u);
+    CHECK_EQ(CFG_SAMPLE_PERIOD_EXACT, 1000000u % CFG_SAMPLE_RATE_HZ == 0);
+    CHECK_EQ(CFG_BLOCK_PERIOD_US, (uint64_t)CFG_BLOCK_LENGTH * 1000000u / CFG_SAMPLE_RATE_HZ);
+
+    unsigned channels = 0;
+    for (unsigned b = 0; b < 5; b++)
+    {
+        channels += (CFG_ADC_CHANNEL_MASK >> b) & 1u;
+    }
+    CHECK_EQ(CFG_ADC_CHANNELS, channels);
+    CHECK_EQ(CFG_ADC_RATE_HZ, CFG_SAMPLE_RATE_HZ * channels * CFG_OVERSAMPLING);
+    CHECK_EQ(CFG_DMA_TRANSFERS, CFG_BLOCK_LENGTH * channels * CFG_OVERSAMPLING);
+
+    // The divider as adc_set_clkdiv() takes it, and the rate it gives
+    CHECK(CFG_ADC_CLKDIV_FRAC < 256u);
+    CHECK(CFG_ADC_CLKDIV == CFG_ADC_CLKDIV_INT + CFG_ADC_CLKDIV_FRAC / 256.0f);
+    double div = CFG_ADC_CLKDIV_INT + CFG_ADC_CLKDIV_FRAC / 256.0;
+    if (CFG_ADC_RATE_HZ >= 500000u)
+    {
+        CHECK_EQ(CFG_ADC_CLKDIV_INT, 0);
+        CHECK_EQ(CFG_ADC_CLKDIV_FRAC, 0);
+        CHECK_EQ(CFG_ADC_ACTUAL_RATE_MHZ, 500000000ull);
+    }
+    else
+    {
+        CHECK(fabs(div - (ADC_CLOCK_HZ / CFG_ADC_RATE_HZ - 1.0)) <= 1.0 / 512.0 + 1e-9);
+        CHECK(llabs((long long)CFG_ADC_ACTUAL_RATE_MHZ - llround(ADC_CLOCK_HZ * 1000.0 / (div + 1.0))) <= 1);
+        CHECK_RANGE(CFG_ADC_ACTUAL_RATE_MHZ / 1000.0 / CFG_ADC_RATE_HZ, 0.9999, 1.0001);
+    }
+
+    // Link: every block of every channel goes out as one frame
+    uint32_t frame = CFG_FRAME_BITS == 16 ? SAMPLE_FRAME_WORDS16_LEN(CFG_BLOCK_LENGTH)
+                                          : SAMPLE_FRAME_RAW12_LEN(CFG_BLOCK_LENGTH);
+    uint32_t blocks = (CFG_SAMPLE_RATE_HZ * channels + CFG_BLOCK_LENGTH - 1u) / CFG_BLOCK_LENGTH;
+    CHECK_EQ(CFG_LINK_BYTES_PER_S, blocks * frame);
+    CHECK(CFG_LINK_BAUD == 0 || CFG_LINK_BYTES_PER_S * 10.0 <= CFG_LINK_BAUD * 0.8);
+
+    // ADC code to millivolts, for every code
+    double worst = 0.0;
+    for (uint32_t code = 0; code < 4096u; code++)
+    {
+        double e = fabs(CFG_ADC_TO_MV(code) - code * (double)CFG_ADC_VREF_MV / 4096.0);
+        worst = e > worst ? e : worst;
+    }
+    CHECK(worst <= 0.54);
+}
+
+#ifdef CFG_LOWPASS_TAPS
+/**
+ * @brief Gain of cfg_lowpass_taps through fir_q15 at k / TONE_PERIODS of the sample rate.
+ */
+static double lowpass_gain_db(int k)
+{
+    static q15_t in[SETTLE + TONE_PERIODS], out[SETTLE + TONE_PERIODS];
+    static double y[TONE_PERIODS];
+    q15_t state[2 * CFG_LOWPASS_TAPS];
+    fir_q15_t f;
+    fir_q15_init(&f, cfg_lowpass_taps, CFG_LOWPASS_TAPS, state);
+
+    const double amplitude = 16000.0;
+    for (int i = 0; i < SETTLE + TONE_PERIODS; i++)
+    {
+        in[i] = (q15_t)lround(amplitude * cos(2.0 * M_PI * k * i / TONE_PERIODS));
+    }
+    fir_q15_process(&f, in, out, SETTLE + TONE_PERIODS);
+    for (int i = 0; i < TONE_PERIODS; i++)
+    {
+        y[i] = out[SETTLE + i];
+    }
+    return tone_gain_db(y, TONE_PERIODS, k, amplitude);
+}
+
+static void test_lowpass(void)
+{
+    // Linear phase and unit DC gain
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < CFG_LOWPASS_TAPS; i++)
+    {
+        CHECK_EQ(cfg_lowpass_taps[i], cfg_lowpass_taps[CFG_LOWPASS_TAPS - 1u - i]);
+        sum += cfg_lowpass_taps[i];
+    }
+    CHECK(abs(sum - 32768) <= (int)CFG_LOWPASS_TAPS);
+
+    // A Hamming window's transition is about 3.3 fs / taps wide, centred on the cutoff, where
+    // the gain is -6 dB; within 0.02 dB of flat below it and about 50 dB down above it (49.4
+    // dB for signal_adq's 31 taps). Tones are measured at 1/1000 of fs steps, and the margins
+    // cover Q15 rounding of taps and output.
+    double fc = (double)CFG_LOWPASS_CUTOFF_HZ / CFG_SAMPLE_RATE_HZ;
+    double half = 3.3 / CFG_LOWPASS_TAPS / 2.0;
+    double pass_worst = 0.0, stop_worst = -200.0;
+    for (int k = 1; k < TONE_PERIODS / 2; k++)
+    {
+        double f = (double)k / TONE_PERIODS;
+        if (f <= fc - half)
+        {
+            pass_worst = fmax(pass_worst, fabs(lowpass_gain_db(k)));
+        }
+        else if (f >= fc + half)
+        {
+            stop_worst = fmax(stop_worst, lowpass_gain_db(k));
+        }
+    }
+    CHECK(pass_worst < 0.05);
+    CHECK(stop_worst < -48.0);
+    CHECK_RANGE(lowpass_gain_db((int)lround(fc * TONE_PERIODS)), -6.5, -5.5);
+}
+#endif
+
+#ifdef CFG_SMOOTHING_SECTIONS
+/**
+ * @brief Gain of cfg_smoothing_sos through biquad_cascade_q15 at k / TONE_PERIODS of fs.
+ */
+static double smoothing_gain_db(int k)
+{
+    static q15_t buf[SETTLE + TONE_PERIODS];
+    static double y[TONE_PERIODS];
+    biquad_state_q15_t state[CFG_SMOOTHING_SECTIONS];
+    biquad_cascade_q15_t c;
+    biquad_cascade_q15_init(&c, cfg_smoothing_sos, state, CFG_SMOOTHING_SECTIONS);
+
+    const double amplitude = 8000.0;
+    for (int i = 0; i < SETTLE + TONE_PERIODS; i++)
+    {
+        buf[i] = (q15_t)lround(amplitude * cos(2.0 * M_PI * k * i / TONE_PERIODS));
+    }
+    biquad_cascade_q15_process(&c, buf, buf, SETTLE + TONE_PERIODS);
+    for (int i = 0; i < TONE_PERIODS; i++)
+    {
+        y[i] = buf[SETTLE + i];
+    }
+    return tone_gain_db(y, TONE_PERIODS, k, amplitude);
+}
+
+static void test_smoothing(void)
+{
+    // Poles inside the unit circle
+    const biquad_coeffs_q14_t *q = &cfg_smoothing_sos[0];
+    double a1 = q->a1 / 16384.0, a2 = q->a2 / 16384.0;
+    CHECK(fabs(a2) < 1.0 && fabs(a1) < 1.0 + a2);
+
+    // A step settles to the input, and the impulse response dies away into the deadband of
+    // the Q15 arithmetic: a constant y with |y (1 + a1 + a2)| under one LSB of rounding
+    static q15_t buf[SETTLE];
+    biquad_state_q15_t state[CFG_SMOOTHING_SECTIONS];
+    biquad_cascade_q15_t c;
+    biquad_cascade_q15_init(&c, cfg_smoothing_sos, state, CFG_SMOOTHING_SECTIONS);
+    for (int i = 0; i < SETTLE; i++)
+    {
+        buf[i] = 16000;
+    }
+    biquad_cascade_q15_process(&c, buf, buf, SETTLE);
+    CHECK(abs(buf[SETTLE - 1] - 16000) <= 16000 / 100);
+
+    biquad_cascade_q15_init(&c, cfg_smoothing_sos, state, CFG_SMOOTHING_SECTIONS);
+    for (int i = 0; i < SETTLE; i++)
+    {
+        buf[i] = i == 0 ? 32767 : 0;
+    }
+    biquad_cascade_q15_process(&c, buf, buf, SETTLE);
+    CHECK(abs(buf[SETTLE - 1]) <= 1.0 / (1.0 + a1 + a2));
+    CHECK_EQ(buf[SETTLE - 1], buf[SETTLE - 2]);
+
+    // Butterworth: -3 dB at the cutoff, no peaking below it, -12.3 dB an octave above
+    double fc = (double)CFG_SMOOTHING_CUTOFF_HZ / CFG_SAMPLE_RATE_HZ;
+    int kc = (int)lround(fc * TONE_PERIODS);
+    double peak = -200.0;
+    for (int k = 1; k < kc; k++)
+    {
+        peak = fmax(peak, smoothing_gain_db(k));
+    }
+    CHECK(peak < 0.05);
+    CHECK_RANGE(smoothing_gain_db(kc), -3.3, -2.7);
+    if (2 * kc < TONE_PERIODS / 2)
+    {
+        // The bilinear transform warps the octave above towards fs / 2, only steeper
+        CHECK(smoothing_gain_db(2 * kc) < -11.5);
+    }
+}
+#endif
+
+#ifdef CFG_CIC_COMP_TAPS
+/**
+ * @brief Gain of the CIC and cfg_cic_comp_taps through oversample_process() at
+ *        k / TONE_PERIODS of the output rate, for ADC codes swinging 1500 around mid-scale.
+ */
+static double cic_gain_db(int k)
+{
+    enum { R = CFG_CIC_DECIMATION, N_IN = (SETTLE / 10 + TONE_PERIODS) * R };
+    static uint16_t in[N_IN];
+    static uint16_t out[N_IN / R];
+    static double y[TONE_PERIODS];
+    q15_t state[2 * CFG_CIC_COMP_TAPS];
+    oversample_t os;
+    CHECK(oversample_init(&os, R, cfg_cic_comp_taps, CFG_CIC_COMP_TAPS, state));
+
+    const double amplitude = 1500.0;
+    for (int i = 0; i < N_IN; i++)
+    {
+        in[i] = (uint16_t)lround(2048.0 + amplitude * cos(2.0 * M_PI * k * i / ((double)TONE_PERIODS * R)));
+    }
+    size_t n = oversample_process(&os, in, out, N_IN);
+    CHECK_EQ(n, N_IN / R);
+    for (int i = 0; i < TONE_PERIODS; i++)
+    {
+        y[i] = out[n - TONE_PERIODS + i];
+    }
+
+    // Outputs are ADC codes * 16
+    return tone_gain_db(y, TONE_PERIODS, k, amplitude * 16.0);
+}
+
+static void test_cic_comp(void)
+{
+    CHECK_EQ(CFG_CIC_DECIMATION, CFG_OVERSAMPLING);
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < CFG_CIC_COMP_TAPS; i++)
+    {
+        CHECK_EQ(cfg_cic_comp_taps[i], cfg_cic_comp_taps[CFG_CIC_COMP_TAPS - 1u - i]);
+        sum += cfg_cic_comp_taps[i];
+    }
+    CHECK(abs(sum - 32768) <= (int)CFG_CIC_COMP_TAPS);
+
+    // The droop of the CIC is made up to within the generator's 0.25 dB up to 0.2 of the
+    // output rate, where the bare CIC would be about 1 dB down
+    double worst = 0.0;
+    for (int k = 1; k <= TONE_PERIODS / 5; k += 7)
+    {
+        worst = fmax(worst, fabs(cic_gain_db(k)));
+    }
+    CHECK(worst < 0.26);
+}
+#endif
+
+int main(void)
+{
+    srand(23);
+
+    test_sampling();
+#ifdef CFG_LOWPASS_TAPS
+    test_lowpass();
+#endif
+#ifdef CFG_SMOOTHING_SECTIONS
+    test_smoothing();
+#endif
+#ifdef CFG_CIC_COMP_TAPS
+    test_cic_comp();
+#endif
+
+    return host_test_result(BUILD_CONFIG_TEST_NAME);
+}
@@ -0,0 +1,110 @@
+"""
+@brief Checks that gen_config.py turns down what it must: bad parameters and filter designs
+at generation time, impossible rate/baud combinations at compile time.
+
+Parameters it cannot design for must raise ConfigError. Configurations it can generate but
+the board cannot run are written out, and build_config.h is compiled with the given C
+compiler: each must fail on its own static assert message, and a valid configuration next
+to it must compile.
+
+Usage: python test_gen_config.py <C compiler> <scratch directory>
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+import gen_config  # noqa: E402
+
+checks = 0
+failures = 0
+
+def check(cond, what):
+    """@brief Counts a check and reports it on stderr if it failed."""
+    global checks, failures
+    checks += 1
+    if not cond:
+        failures += 1
+        print(f"test_gen_config.py: {what} failed", file=sys.stderr)
+
+def params(**kw):
+    """@brief The generator's arguments, with its defaults for anything not given."""
+    args = argparse.Namespace(name="test", sample_rate=5000, block=256, adc_channel_mask=1, oversampling=1,
+                              baud=0, timer_paced=False, fir_cutoff=0, fir_taps=31, biquad_cutoff=0,
+                              cic_comp_taps=0, frame_bits=12, vref_mv=3300)
+    for k, v in kw.items():
+        setattr(args, k, v)
+    return args
+
+def rejected(**kw):
+    """@brief Whether the generator refuses a configuration."""
+    try:
+        gen_config.generate(params(**kw))
+    except gen_config.ConfigError:
+        return True
+    return False
+
+def compile_errors(cc, scratch, name, **kw):
+    """@brief Compiles build_config.h of a configuration; returns the compiler's messages, or
+    None if it compiled."""
+    out = os.path.join(scratch, name)
+    os.makedirs(out, exist_ok=True)
+    header, _ = gen_config.generate(params(**kw))
+    with open(os.path.join(out, "build_config.h"), "w") as f:
+        f.write(header)
+    run = subprocess.run([cc, "-std=c11", "-fsyntax-only", "-I", out, "-x", "c", "-"],
+                         input='#include "build_config.h"\n', capture_output=True, text=True)
+    return None if run.returncode == 0 else run.stderr
+
+def test_rejected():
+    check(not rejected(), "the defaults")
+    check(rejected(sample_rate=0), "no sample rate")
+    check(rejected(block=0), "empty blocks")
+    check(rejected(frame_bits=14), "14-bit frames")
+    check(rejected(fir_cutoff=2500), "FIR cutoff at fs / 2")
+    check(rejected(fir_cutoff=1000, fir_taps=2), "2-tap FIR")
+    check(rejected(biquad_cutoff=3000), "biquad cutoff above fs / 2")
+    check(rejected(oversampling=3, cic_comp_taps=15), "CIC decimation by 3")
+    check(rejected(oversampling=257, cic_comp_taps=15), "CIC decimation by 257")
+
+    # Designs that fail their own checks once quantized: a biquad whose poles are too close
+    # to z = 1 for Q14, and a compensation with too few taps to lift the droop
+    check(rejected(sample_rate=100000, biquad_cutoff=5), "biquad at fc = fs / 20000")
+    check(rejected(oversampling=8, cic_comp_taps=3), "3-tap CIC compensation")
+
+def test_static_asserts(cc, scratch):
+    errors = compile_errors(cc, scratch, "valid", sample_rate=10000, block=64, oversampling=50, baud=460800,
+                            frame_bits=16)
+    check(errors is None, "a valid configuration compiles: %s" % errors)
+
+    cases = [
+        ("no_input", "selects no input", dict(adc_channel_mask=0)),
+        ("too_fast", "above 500 kS/s", dict(sample_rate=100000, adc_channel_mask=0x1F, oversampling=2)),
+        ("too_slow", "slowest clock divider", dict(sample_rate=500)),
+        ("timer_period", "whole number of microseconds", dict(sample_rate=3000, timer_paced=True)),
+        ("baud", "cannot carry", dict(sample_rate=10000, baud=115200)),
+        # 21.7 kB/s of RAW16 frames fits in 23 kB/s, but with no room for anything else
+        ("baud_load", "cannot carry", dict(sample_rate=10000, oversampling=50, baud=230400, frame_bits=16)),
+    ]
+    for name, message, kw in cases:
+        errors = compile_errors(cc, scratch, name, **kw)
+        check(errors is not None and message in errors, "static assert on %s" % name)
+
+    # The same slow rate is fine once a timer paces it
+    check(compile_errors(cc, scratch, "slow_timer", sample_rate=500, timer_paced=True) is None,
+          "500 S/s timer-paced compiles")
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: python test_gen_config.py <C compiler> <scratch directory>")
+        return 2
+    test_rejected()
+    test_static_asserts(sys.argv[1], sys.argv[2])
+    print(f"gen_config.py: {checks} checks, {failures} failed")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,109 @@
+/**
+ * @file dds.c
+ * @brief Direct digital synthesis: 32-bit phase accumulator with sine and square outputs.
+ */
+
+#include "dds.h"
+
+#define QUARTER_BITS (DDS_SINE_BITS - 2u)     ///< Index bits within a quarter period.
+#define QUARTER_POINTS (1u << QUARTER_BITS)   ///< Points per quarter period.
+
+void dds_init(dds_t *d, uint64_t sample_rate_mhz, uint16_t top, dds_wave_t wave)
+{
+    d->phase = 0;
+    d->tuning = 0;
+    d->phase_offset = 0;
+    d->sample_rate_mhz = sample_rate_mhz;
+    d->top = top;
+    d->mid = (uint16_t)((top + 1u) / 2u);
+    d->wave = wave;
+    dds_set_amplitude(d, DDS_AMPLITUDE_FULL);
+}
+
+uint32_t dds_tuning_word(uint32_t freq_mhz, uint64_t sample_rate_mhz)
+{
+    if (sample_rate_mhz == 0)
+    {
+        return 0;
+    }
+
+    // freq < 2^32, so the shifted numerator fits in 64 bits; round on the remainder.
+    uint64_t num = (uint64_t)freq_mhz << 32;
+    uint64_t tw = num / sample_rate_mhz;
+    if ((num % sample_rate_mhz) * 2u >= sample_rate_mhz)
+    {
+        tw++;
+    }
+    return (uint32_t)tw;
+}
+
+uint32_t dds_frequency_mhz(uint32_t tuning, uint64_t sample_rate_mhz)
+{
+    // (tuning * rate) >> 32 without a 96-bit product: split the rate in 32-bit halves.
+    uint64_t hi = (sample_rate_mhz >> 32) * tuning;
+    uint64_t lo = ((sample_rate_mhz & 0xFFFFFFFFu) * tuning) >> 32;
+    return (uint32_t)(hi + lo);
+}
+
+void dds_set_frequency_mhz(dds_t *d, uint32_t freq_mhz)
+{
+    d->tuning = dds_tuning_word(freq_mhz, d->sample_rate_mhz);
+}
+
+void dds_set_amplitude(dds_t *d, uint16_t amplitude)
+{
+    if (amplitude > DDS_AMPLITUDE_FULL)
+    {
+        amplitude = DDS_AMPLITUDE_FULL;
+    }
+    // The headroom is the smaller side of mid, so the sine never clips at 0 or top.
+    uint32_t span = (uint32_t)d->top - d->mid;
+    if (d->mid < span)
+    {
+        span = d->mid;
+    }
+    d->gain = (uint16_t)(((uint32_t)amplitude * span + (1u << 14)) >> 15);
+}
+
+/**
+ * @brief Sine of the top DDS_SINE_BITS of a phase, unfolded from the quarter-wave table.
+ */
+static inline int32_t dds_sine(uint32_t phase)
+{
+    uint32_t index = phase >> (32u - DDS_SINE_BITS);
+    uint32_t k = index & (QUARTER_POINTS - 1u);
+
+    // Odd quadrants run the table backwards; the second half period is negative.
+    int32_t s = (index & QUARTER_POINTS) ? dds_sin_q15[QUARTER_POINTS - k] : dds_sin_q15[k];
+    return (index & (2u * QUARTER_POINTS)) ? -s : s;
+}
+
+void dds_fill(dds_t *d, uint16_t *out, size_t n)
+{
+    uint32_t phase = d->phase;
+    uint32_t tuning = d->tuning;
+    uint32_t offset = d->phase_offset;
+    int32_t mid = d->mid;
+    int32_t gain = d->gain;
+
+    if (d->wave == DDS_WAVE_SQUARE)
+    {
+        uint16_t high = (uint16_t)(mid + gain);
+        uint16_t low = (uint16_t)(mid - gain);
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = ((phase + offset) & 0x80000000u) ? low : high;
+            phase += tuning;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            // |s * gain| < 2^30, so the product cannot overflow; round to nearest.
+            out[i] = (uint16_t)(mid + ((dds_sine(phase + offset) * gain + (1 << 14)) >> 15));
+            phase += tuning;
+        }
+    }
+    d->phase = phase;
+}
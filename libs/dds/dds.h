@@ -0,0 +1,126 @@
+/**
+ * @file dds.h
+ * @brief Direct digital synthesis: 32-bit phase accumulator with sine and square outputs.
+ *
+ * @details
+ * Every output sample advances a 32-bit phase accumulator by a tuning word, so the output
+ * frequency is `tuning * fs / 2^32`. At a 488 kS/s PWM-DAC rate this is a resolution of about
+ * 0.1 mHz, and any frequency below fs / 2 can be reached, unlike a PWM whose frequency is
+ * set by an integer wrap. Changing the tuning word does not touch the accumulator, so a
+ * retune is phase-continuous. A phase offset is added after the accumulator, which is how
+ * PSK modulates a DDS carrier.
+ *
+ * The top 12 bits of the phase index a 4096-point sine, stored as a generated quarter-wave
+ * table (gen_dds_tables.py) and unfolded by symmetry. The phase truncation keeps the
+ * spurs at -72 dBc (6 dB per phase bit); in practice the DAC resolution dominates (a PWM
+ * top of 255 gives 8 bits, about 50 dB SNR). dds_measure.h measures both on a host. The
+ * square wave is the phase MSB. The levels are unsigned, centred on (top + 1) / 2, ready
+ * for a PWM compare register or an R-2R ladder.
+ *
+ * Frequencies are given in millihertz so that sub-Hz settings stay integer. Sample rates
+ * are also in millihertz (as a 64-bit value) because a PWM-DAC rate such as
+ * 125 MHz / 256 = 488281.25 Hz is not a whole number of hertz.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef DDS_H
+#define DDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DDS_SINE_BITS 12u                     ///< Phase bits used to index the sine.
+#define DDS_SINE_POINTS (1u << DDS_SINE_BITS) ///< Points per sine period.
+#define DDS_AMPLITUDE_FULL 32767u             ///< Full-scale amplitude (Q15 1.0).
+
+/// Phase offset for an angle in degrees, 2^32 being a full turn.
+#define DDS_PHASE_DEG(deg) ((uint32_t)(((uint64_t)(deg) << 32) / 360u))
+
+typedef enum dds_wave
+{
+    DDS_WAVE_SINE = 0, ///< Sine from the quarter-wave table.
+    DDS_WAVE_SQUARE,   ///< 50% square, high for the first half period.
+} dds_wave_t;
+
+typedef struct dds
+{
+    uint32_t phase;           ///< Phase accumulator.
+    uint32_t tuning;          ///< Phase increment per sample.
+    uint32_t phase_offset;    ///< Added to the phase at the output.
+    uint64_t sample_rate_mhz; ///< Sample rate in millihertz.
+    uint16_t top;             ///< Largest output level.
+    uint16_t mid;             ///< Output level for a zero sample.
+    uint16_t gain;            ///< Peak deviation from mid at the current amplitude.
+    dds_wave_t wave;          ///< Waveform.
+} dds_t;
+
+// Generated table (dds_tables.c)
+extern const int16_t dds_sin_q15[DDS_SINE_POINTS / 4 + 1]; ///< sin(2*pi*k/POINTS), k = 0 .. POINTS/4.
+
+/**
+ * @brief Initializes a generator at 0 Hz, zero phase and full amplitude.
+ *
+ * @param d Pointer to the generator.
+ * @param sample_rate_mhz Output sample rate in millihertz.
+ * @param top Largest output level (e.g. the PWM wrap value, or 2^bits - 1 for a ladder).
+ * @param wave Waveform.
+ */
+void dds_init(dds_t *d, uint64_t sample_rate_mhz, uint16_t top, dds_wave_t wave);
+
+/**
+ * @brief Tuning word for a frequency, rounded to the nearest step.
+ *
+ * @param freq_mhz Frequency in millihertz.
+ * @param sample_rate_mhz Sample rate in millihertz.
+ * @return uint32_t Phase increment per sample.
+ */
+uint32_t dds_tuning_word(uint32_t freq_mhz, uint64_t sample_rate_mhz);
+
+/**
+ * @brief Frequency produced by a tuning word, in millihertz (rounded down).
+ */
+uint32_t dds_frequency_mhz(uint32_t tuning, uint64_t sample_rate_mhz);
+
+/**
+ * @brief Sets the tuning word; the phase carries on from where it is.
+ */
+static inline void dds_set_tuning(dds_t *d, uint32_t tuning)
+{
+    d->tuning = tuning;
+}
+
+/**
+ * @brief Sets the output frequency; the phase carries on from where it is.
+ *
+ * @param d Pointer to the generator.
+ * @param freq_mhz Frequency in millihertz, below half the sample rate.
+ */
+void dds_set_frequency_mhz(dds_t *d, uint32_t freq_mhz);
+
+/**
+ * @brief Sets the phase offset added at the output (see DDS_PHASE_DEG()).
+ */
+static inline void dds_set_phase_offset(dds_t *d, uint32_t offset)
+{
+    d->phase_offset = offset;
+}
+
+/**
+ * @brief Sets the peak amplitude.
+ *
+ * @param d Pointer to the generator.
+ * @param amplitude Q15 amplitude, 0 to DDS_AMPLITUDE_FULL (larger values are clamped).
+ */
+void dds_set_amplitude(dds_t *d, uint16_t amplitude);
+
+/**
+ * @brief Generates the next n output levels and advances the phase.
+ *
+ * @param d Pointer to the generator.
+ * @param out Output levels, 0 .. top.
+ * @param n Number of samples.
+ */
+void dds_fill(dds_t *d, uint16_t *out, size_t n);
+
+#endif // DDS_H
@@ -0,0 +1,138 @@
+/**
+ * @file dds_measure.c
+ * @brief Spectral quality of a generated sequence: SNR and spur-free dynamic range.
+ */
+
+#include "dds_measure.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define MEASURE_MIN_N 64u ///< Shortest block that leaves room for the lobes.
+
+/**
+ * @brief Power in each bin 0 .. n/2 of the windowed, mean-removed block.
+ */
+static void dds_power_spectrum(const uint16_t *x, size_t n, double *power)
+{
+    const double two_pi = 6.283185307179586;
+    double *w = malloc(n * sizeof(double));
+    double mean = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        mean += x[i];
+    }
+    mean /= (double)n;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double t = two_pi * (double)i / (double)n;
+        double win = 0.35875 - 0.48829 * cos(t) + 0.14128 * cos(2.0 * t) - 0.01168 * cos(3.0 * t);
+        w[i] = ((double)x[i] - mean) * win;
+    }
+
+    for (size_t k = 0; k <= n / 2u; k++)
+    {
+        // Goertzel: one real recurrence per bin, no table of twiddles.
+        double coeff = 2.0 * cos(two_pi * (double)k / (double)n);
+        double s1 = 0.0;
+        double s2 = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double s0 = w[i] + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        power[k] = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    }
+    free(w);
+}
+
+/**
+ * @brief Power of the lobe centred on a bin, clipped to bins first .. n_bins - 1.
+ *
+ * The lower clip keeps the DC lobe out of a tone or spur just above it.
+ */
+static double dds_lobe_power(const double *power, size_t first, size_t n_bins, size_t centre)
+{
+    size_t lo = (centre > first + DDS_MEASURE_LOBE) ? centre - DDS_MEASURE_LOBE : first;
+    size_t hi = centre + DDS_MEASURE_LOBE;
+    double sum = 0.0;
+
+    if (hi >= n_bins)
+    {
+        hi = n_bins - 1u;
+    }
+    for (size_t k = lo; k <= hi; k++)
+    {
+        sum += power[k];
+    }
+    return sum;
+}
+
+int dds_measure(const uint16_t *x, size_t n, dds_measure_t *m)
+{
+    if (n < MEASURE_MIN_N)
+    {
+        return -1;
+    }
+
+    size_t n_bins = n / 2u + 1u;
+    double *power = malloc(n_bins * sizeof(double));
+    if (power == NULL)
+    {
+        return -1;
+    }
+    dds_power_spectrum(x, n, power);
+
+    // The DC lobe is left out: the mean was removed but the window spreads what remains.
+    size_t first = DDS_MEASURE_LOBE + 1u;
+    size_t peak = first;
+    for (size_t k = first; k < n_bins; k++)
+    {
+        if (power[k] > power[peak])
+        {
+            peak = k;
+        }
+    }
+
+    double signal = dds_lobe_power(power, first, n_bins, peak);
+    double total = 0.0;
+    for (size_t k = first; k < n_bins; k++)
+    {
+        total += power[k];
+    }
+    double noise = total - signal;
+
+    // Strongest spur: the largest lobe whose centre is clear of the tone's lobe.
+    double spur = 0.0;
+    size_t spur_bin = 0;
+    for (size_t k = first; k < n_bins; k++)
+    {
+        size_t dist = (k > peak) ? k - peak : peak - k;
+        if (dist <= 2u * DDS_MEASURE_LOBE)
+        {
+            continue;
+        }
+        double p = dds_lobe_power(power, first, n_bins, k);
+        if (p > spur)
+        {
+            spur = p;
+            spur_bin = k;
+        }
+    }
+    free(power);
+
+    if (signal <= 0.0)
+    {
+        return -1;
+    }
+
+    // Floor the denominators so that an ideal tone gives a large finite figure.
+    const double floor_power = signal * 1e-20;
+    m->fundamental_bin = peak;
+    m->spur_bin = spur_bin;
+    m->snr_db = 10.0 * log10(signal / fmax(noise, floor_power));
+    m->sfdr_db = 10.0 * log10(signal / fmax(spur, floor_power));
+    return 0;
+}
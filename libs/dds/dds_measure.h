@@ -0,0 +1,45 @@
+/**
+ * @file dds_measure.h
+ * @brief Spectral quality of a generated sequence: SNR and spur-free dynamic range.
+ *
+ * @details
+ * Meant for checking a DDS configuration on a desktop host before it goes to the DAC:
+ * generate a block with dds_fill() and pass it to dds_measure(). The levels are treated as
+ * an ideal DAC output, so the result covers the phase truncation and the amplitude
+ * quantization of the generator, not the analog filter after the pin.
+ *
+ * The block is windowed with a 4-term Blackman-Harris window (sidelobes at -92 dB, main lobe
+ * 4 bins wide on each side), so the tone does not need to fall on a bin. The power spectrum
+ * is computed bin by bin with the Goertzel recurrence in double precision: O(n^2), a few
+ * milliseconds on a PC for n = 4096, far too slow for the RP2040.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef DDS_MEASURE_H
+#define DDS_MEASURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DDS_MEASURE_LOBE 4u ///< Bins on each side of a tone that belong to it.
+
+typedef struct dds_measure
+{
+    size_t fundamental_bin; ///< Strongest bin, f = bin * fs / n.
+    size_t spur_bin;        ///< Centre of the strongest spur.
+    double snr_db;          ///< Tone power over everything else except DC (spurs included).
+    double sfdr_db;         ///< Tone power over the strongest spur, in dBc.
+} dds_measure_t;
+
+/**
+ * @brief Measures the tone in a block of output levels.
+ *
+ * @param x Output levels, e.g. from dds_fill().
+ * @param n Number of samples, at least 64.
+ * @param m Result.
+ * @return int 0 on success, -1 if the block is too short or has no tone.
+ */
+int dds_measure(const uint16_t *x, size_t n, dds_measure_t *m);
+
+#endif // DDS_MEASURE_H
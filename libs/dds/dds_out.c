@@ -0,0 +1,231 @@
+/**
+ * @file dds_out.c
+ * @brief Streams a DDS generator to a PWM-DAC or a PIO-driven R-2R ladder through DMA.
+ */
+
+#include "dds_out.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "dds_r2r.pio.h"
+
+static dds_out_t *active_out = NULL; ///< Output serviced by the DMA interrupt.
+static bool irq_installed = false;   ///< The shared DMA_IRQ_1 handler is registered once.
+
+/**
+ * @brief Runs the hook and generates one half of the buffer.
+ */
+static void dds_out_fill(dds_out_t *out, uint half)
+{
+    if (out->hook != NULL)
+    {
+        out->hook(out->hook_ctx, out->dds, out->blocks);
+    }
+    dds_fill(out->dds, out->storage + half * out->half_len, out->half_len);
+    out->blocks++;
+}
+
+/**
+ * @brief DMA_IRQ_1 handler: rewinds the channel that just finished and refills its half.
+ *
+ * The other channel was triggered by the chain, so the DAC keeps playing while this runs.
+ */
+static void dds_out_dma_irq(void)
+{
+    dds_out_t *out = active_out;
+    if (out == NULL)
+    {
+        return;
+    }
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint ch = out->dma_chan[i];
+        if (dma_channel_get_irq1_status(ch))
+        {
+            dma_channel_acknowledge_irq1(ch);
+            // TRANS_COUNT reloads on the next chain trigger; only the read address moves.
+            dma_channel_set_read_addr(ch, out->storage + i * out->half_len, false);
+            dds_out_fill(out, i);
+        }
+    }
+}
+
+/**
+ * @brief Claims and configures the two chained DMA channels for the selected DAC.
+ */
+static void dds_out_init_dma(dds_out_t *out, uint16_t *storage, uint32_t half_len)
+{
+    out->storage = storage;
+    out->half_len = half_len;
+    out->hook = NULL;
+    out->hook_ctx = NULL;
+    out->dds = NULL;
+    out->blocks = 0;
+    out->running = false;
+
+    out->dma_chan[0] = dma_claim_unused_channel(true);
+    out->dma_chan[1] = dma_claim_unused_channel(true);
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint ch = out->dma_chan[i];
+        dma_channel_config cfg = dma_channel_get_default_config(ch);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false); // Always the DAC register
+        channel_config_set_dreq(&cfg, out->dreq);
+        channel_config_set_chain_to(&cfg, out->dma_chan[i ^ 1]); // Hand over to the other half
+
+        dma_channel_configure(ch, &cfg, out->dest, storage + i * half_len, half_len, false);
+        dma_channel_set_irq1_enabled(ch, true);
+    }
+
+    if (!irq_installed)
+    {
+        irq_add_shared_handler(DMA_IRQ_1, dds_out_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        irq_installed = true;
+    }
+}
+
+/**
+ * @brief Puts the DAC at mid scale.
+ */
+static void dds_out_park(dds_out_t *out)
+{
+    uint16_t mid = (uint16_t)((out->top + 1u) / 2u);
+
+    if (out->pio == NULL)
+    {
+        pwm_hw->slice[out->slice].cc = ((uint32_t)mid << 16) | mid;
+    }
+    else
+    {
+        pio_sm_set_pins_with_mask(out->pio, out->sm, (uint32_t)mid << out->pin, (uint32_t)out->top << out->pin);
+    }
+}
+
+void dds_out_init_pwm(dds_out_t *out, uint pin, uint16_t top, uint16_t *storage, uint32_t half_len)
+{
+    out->pin = pin;
+    out->top = top;
+    out->pio = NULL;
+    out->slice = pwm_gpio_to_slice_num(pin);
+    out->sample_rate_mhz = (uint64_t)clock_get_hz(clk_sys) * 1000u / ((uint32_t)top + 1u);
+
+    // Full-speed counter: one sample per PWM period, the level written at each wrap.
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_clkdiv_int(&cfg, 1);
+    pwm_config_set_wrap(&cfg, top);
+    pwm_init(out->slice, &cfg, false);
+    dds_out_park(out);
+    pwm_set_enabled(out->slice, true);
+
+    out->dest = &pwm_hw->slice[out->slice].cc;
+    out->dreq = pwm_get_dreq(out->slice);
+    dds_out_init_dma(out, storage, half_len);
+}
+
+void dds_out_init_pio(dds_out_t *out, PIO pio, uint first_pin, uint n_bits, uint32_t rate_hz, uint16_t *storage,
+                      uint32_t half_len)
+{
+    out->pin = first_pin;
+    out->top = (uint16_t)((1u << n_bits) - 1u);
+    out->pio = pio;
+    out->sm = (uint)pio_claim_unused_sm(pio, true);
+
+    // One `out` per sample, so the divider is clk_sys / rate, rounded to 1/256.
+    uint64_t sys_hz = clock_get_hz(clk_sys);
+    uint64_t div256 = (sys_hz * 256u + rate_hz / 2u) / rate_hz;
+    if (div256 < 256u)
+    {
+        div256 = 256u;
+    }
+    else if (div256 > 65536u * 256u)
+    {
+        div256 = 65536u * 256u;
+    }
+    out->sample_rate_mhz = sys_hz * 256000u / div256;
+
+    uint offset = pio_add_program(pio, &dds_r2r_program);
+    pio_sm_config cfg = dds_r2r_program_get_default_config(offset);
+    sm_config_set_out_pins(&cfg, first_pin, n_bits);
+    sm_config_set_out_shift(&cfg, true, true, 16); // Autopull one 16-bit level per `out`
+    sm_config_set_fifo_join(&cfg, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv_int_frac(&cfg, (uint16_t)(div256 >> 8), (uint8_t)(div256 & 0xFFu));
+
+    for (uint i = 0; i < n_bits; i++)
+    {
+        pio_gpio_init(pio, first_pin + i);
+    }
+    pio_sm_set_consecutive_pindirs(pio, out->sm, first_pin, n_bits, true);
+    pio_sm_init(pio, out->sm, offset, &cfg);
+    dds_out_park(out);
+
+    out->dest = &pio->txf[out->sm];
+    out->dreq = pio_get_dreq(pio, out->sm, true);
+    dds_out_init_dma(out, storage, half_len);
+}
+
+void dds_out_set_block_hook(dds_out_t *out, dds_block_hook_t hook, void *ctx)
+{
+    out->hook = hook;
+    out->hook_ctx = ctx;
+}
+
+void dds_out_start(dds_out_t *out, dds_t *dds)
+{
+    if (out->running)
+    {
+        return;
+    }
+
+    out->dds = dds;
+    out->blocks = 0;
+    dds_out_fill(out, 0);
+    dds_out_fill(out, 1);
+
+    // Rewind both channels so playback always starts at half 0.
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_set_read_addr(out->dma_chan[i], out->storage + i * out->half_len, false);
+        dma_channel_set_trans_count(out->dma_chan[i], out->half_len, false);
+    }
+
+    active_out = out;
+    dma_channel_start(out->dma_chan[0]);
+    if (out->pio != NULL)
+    {
+        pio_sm_set_enabled(out->pio, out->sm, true);
+    }
+    out->running = true;
+}
+
+void dds_out_stop(dds_out_t *out)
+{
+    if (!out->running)
+    {
+        return;
+    }
+
+    if (out->pio != NULL)
+    {
+        pio_sm_set_enabled(out->pio, out->sm, false);
+    }
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_abort(out->dma_chan[i]);
+        // An abort can leave a spurious completion flag behind (RP2040-E13).
+        dma_channel_acknowledge_irq1(out->dma_chan[i]);
+    }
+    if (out->pio != NULL)
+    {
+        pio_sm_clear_fifos(out->pio, out->sm);
+    }
+    dds_out_park(out);
+    active_out = NULL;
+    out->running = false;
+}
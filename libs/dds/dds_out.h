@@ -0,0 +1,108 @@
+/**
+ * @file dds_out.h
+ * @brief Streams a DDS generator to a PWM-DAC or a PIO-driven R-2R ladder through DMA.
+ *
+ * @details
+ * Two chained DMA channels read the two halves of a ping-pong buffer into the DAC, paced by
+ * the DAC itself: the PWM wrap DREQ (one sample per PWM period, written to the compare
+ * register, which latches at the wrap) or the PIO TX FIFO DREQ. When a half has been played
+ * the other channel is already running, and the DMA_IRQ_1 handler refills the played half
+ * with dds_fill(). The output timing therefore never depends on the CPU; the handler has a
+ * whole half period to run.
+ *
+ * An optional block hook runs before each half is filled, e.g. to change the phase offset or
+ * the amplitude once per symbol. Changes made to the generator from elsewhere also take
+ * effect at the next half.
+ *
+ * PWM note: the 16-bit DMA write to the compare register is replicated into both channels of
+ * the slice, so the slice's other pin, if set to PWM, carries the same signal.
+ *
+ * Only one output can be active at a time.
+ */
+
+#ifndef DDS_OUT_H
+#define DDS_OUT_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "dds.h"
+
+/**
+ * @brief Called before each half is filled.
+ *
+ * @param ctx Context passed to dds_out_set_block_hook().
+ * @param dds The generator about to fill the half.
+ * @param block Number of halves filled before this one.
+ */
+typedef void (*dds_block_hook_t)(void *ctx, dds_t *dds, uint32_t block);
+
+typedef struct dds_out
+{
+    dds_t *dds;               ///< Generator feeding the output (set by dds_out_start()).
+    uint16_t *storage;        ///< Ping-pong buffer, 2 * half_len levels.
+    uint32_t half_len;        ///< Levels per half.
+    uint dma_chan[2];         ///< DMA channel playing each half.
+    volatile void *dest;      ///< DAC register written by the DMA.
+    uint dreq;                ///< DREQ pacing the DMA.
+    uint16_t top;             ///< Largest level the DAC accepts.
+    uint pin;                 ///< PWM pin, or the first ladder pin.
+    uint64_t sample_rate_mhz; ///< Output sample rate in millihertz.
+    uint slice;               ///< PWM slice (PWM output).
+    PIO pio;                  ///< PIO block, NULL for the PWM output.
+    uint sm;                  ///< State machine (PIO output).
+    dds_block_hook_t hook;    ///< Optional per-block hook.
+    void *hook_ctx;           ///< Context for the hook.
+    volatile uint32_t blocks; ///< Halves filled since start.
+    bool running;             ///< True while the DMA is active.
+} dds_out_t;
+
+/**
+ * @brief Sets up a PWM-DAC output on one pin.
+ *
+ * The PWM counts 0 .. top at the system clock, so the sample rate is clk_sys / (top + 1),
+ * e.g. 488 kS/s for top = 255 at 125 MHz. Follow the pin with an RC low-pass filter.
+ *
+ * @param out Pointer to the output.
+ * @param pin GPIO with a PWM function.
+ * @param top PWM wrap value, the largest level.
+ * @param storage Buffer of at least 2 * half_len levels.
+ * @param half_len Levels per half.
+ */
+void dds_out_init_pwm(dds_out_t *out, uint pin, uint16_t top, uint16_t *storage, uint32_t half_len);
+
+/**
+ * @brief Sets up a parallel output on n_bits consecutive pins driven by a PIO state machine.
+ *
+ * @param out Pointer to the output.
+ * @param pio PIO block to use.
+ * @param first_pin Least significant bit of the ladder.
+ * @param n_bits Ladder resolution (1 to 16); the largest level is 2^n_bits - 1.
+ * @param rate_hz Requested sample rate; the clock divider is rounded to 1/256, see
+ *                sample_rate_mhz for the rate actually produced.
+ * @param storage Buffer of at least 2 * half_len levels.
+ * @param half_len Levels per half.
+ */
+void dds_out_init_pio(dds_out_t *out, PIO pio, uint first_pin, uint n_bits, uint32_t rate_hz, uint16_t *storage,
+                      uint32_t half_len);
+
+/**
+ * @brief Installs a hook called before each half is filled (NULL to remove it).
+ */
+void dds_out_set_block_hook(dds_out_t *out, dds_block_hook_t hook, void *ctx);
+
+/**
+ * @brief Fills both halves and starts the DMA and the DAC.
+ *
+ * The generator should have been initialized with the output's sample_rate_mhz and top.
+ *
+ * @param out Pointer to the output.
+ * @param dds Generator to play.
+ */
+void dds_out_start(dds_out_t *out, dds_t *dds);
+
+/**
+ * @brief Aborts the DMA and leaves the output at mid scale.
+ */
+void dds_out_stop(dds_out_t *out);
+
+#endif // DDS_OUT_H
@@ -0,0 +1,45 @@
+"""
+Generates dds_tables.c: the constant tables used by dds.c.
+
+- dds_sin_q15: a quarter wave of sin(2*pi*k/DDS_SINE_POINTS) for k = 0 .. DDS_SINE_POINTS/4, in
+  Q15. dds.c unfolds it to the full period, so the table stores one point per phase step.
+
+Usage:
+    python gen_dds_tables.py > dds_tables.c
+"""
+
+import math
+
+DDS_SINE_POINTS = 4096
+
+
+def q15(x):
+    return max(-32768, min(32767, int(round(x * 32767))))
+
+
+def table(ctype, name, values, per_line=12):
+    lines = [f"const {ctype} {name}[{len(values)}] = {{"]
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    n = DDS_SINE_POINTS
+    sin_q = [q15(math.sin(2 * math.pi * k / n)) for k in range(n // 4 + 1)]
+
+    print("/**")
+    print(" * @file dds_tables.c")
+    print(" * @brief Constant quarter-wave sine table for dds.c.")
+    print(" *")
+    print(" * Generated by gen_dds_tables.py, do not edit by hand.")
+    print(" */")
+    print()
+    print('#include "dds.h"')
+    print()
+    print(table("int16_t", "dds_sin_q15", sin_q))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,235 @@
+/**
+ * @file test_dds.c
+ * @brief DDS tuning, waveform levels and spectral quality measured with dds_measure().
+ *
+ * @details
+ * The levels of dds_fill() are checked against the sine computed in double precision, then
+ * whole blocks go through dds_measure(): at 8 bits (PWM top 255) the SNR must be that of
+ * 8-bit quantization, and at 16 bits the phase truncation to 12 bits must leave its spurs
+ * where dds.h says. dds_measure() itself is checked on synthetic blocks with a known spur
+ * level and noise.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "dds.h"
+#include "dds_measure.h"
+#include "host_test.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define PWM_RATE_MHZ 488281250ull ///< 125 MHz / 256, in mHz.
+#define N 4096u
+
+static uint16_t block[N];
+static double level[N];
+
+static void test_tuning(void)
+{
+    // 10 kHz at 488281.25 Hz: 10000 / 488281.25 * 2^32 = 87960930.2
+    uint32_t tw = dds_tuning_word(10000000u, PWM_RATE_MHZ);
+    CHECK_EQ(tw, 87960930u);
+    CHECK_EQ(dds_frequency_mhz(tw, PWM_RATE_MHZ), 9999999u);
+
+    // Every frequency comes back within one step (0.11 mHz here)
+    uint32_t rng = 1;
+    for (int i = 0; i < 10000; i++)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        uint32_t f = rng % 244140625u; // Below fs / 2
+        uint32_t back = dds_frequency_mhz(dds_tuning_word(f, PWM_RATE_MHZ), PWM_RATE_MHZ);
+        CHECK_RANGE((double)back - f, -1.0, 1.0);
+    }
+
+    // A sample rate above 2^32 mHz uses the high half of the product
+    uint64_t fast = 125000000000ull; // 125 MHz
+    tw = dds_tuning_word(1000000000u, fast);
+    CHECK_EQ(tw, 34359738u); // 2^32 / 125
+    CHECK_EQ(dds_frequency_mhz(tw, fast), ((uint64_t)tw * fast) >> 32);
+    CHECK_EQ(dds_tuning_word(1000, 0), 0);
+}
+
+/**
+ * @brief Levels follow mid + gain * sin(phase) to within the table and rounding error.
+ */
+static void test_sine_levels(void)
+{
+    static const uint16_t tops[] = {15, 255, 4095, 65535};
+    dds_t d;
+
+    for (size_t t = 0; t < sizeof(tops) / sizeof(tops[0]); t++)
+    {
+        dds_init(&d, PWM_RATE_MHZ, tops[t], DDS_WAVE_SINE);
+        dds_set_tuning(&d, 0x01234567u);
+        dds_fill(&d, block, N);
+
+        double worst = 0.0;
+        uint16_t lo = 0xFFFF, hi = 0;
+        for (uint32_t i = 0; i < N; i++)
+        {
+            uint32_t phase = (uint32_t)(i * 0x01234567u) & ~((1u << (32u - DDS_SINE_BITS)) - 1u);
+            // The table is scaled by 32767, so the peak is gain * 32767 / 32768
+            double want = d.mid + d.gain * (32767.0 / 32768.0) * sin(2.0 * M_PI * phase / 4294967296.0);
+            worst = fmax(worst, fabs(block[i] - want));
+            lo = block[i] < lo ? block[i] : lo;
+            hi = block[i] > hi ? block[i] : hi;
+        }
+        // Half an LSB of rounding plus half a table step scaled by the gain
+        CHECK_RANGE(worst, 0.0, 0.5 + d.gain / 65534.0 + 1e-9);
+        CHECK(hi <= tops[t]);
+        CHECK(d.mid >= d.gain && d.mid + d.gain <= tops[t]);
+        CHECK_EQ(d.phase, (uint32_t)(N * 0x01234567u));
+    }
+}
+
+static void test_controls(void)
+{
+    dds_t d;
+    uint16_t a[64], b[64];
+
+    // A retune keeps the phase: one block at f1 then one at f2 equals the phase walked by hand
+    dds_init(&d, PWM_RATE_MHZ, 255, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&d, 1000000u);
+    dds_fill(&d, a, 64);
+    uint32_t phase = d.phase;
+    dds_set_frequency_mhz(&d, 7000000u);
+    CHECK_EQ(d.phase, phase);
+    dds_fill(&d, b, 1);
+    CHECK_EQ(d.phase, phase + dds_tuning_word(7000000u, PWM_RATE_MHZ));
+
+    // A 90 degree offset turns the sine into a cosine
+    dds_init(&d, PWM_RATE_MHZ, 4095, DDS_WAVE_SINE);
+    dds_set_phase_offset(&d, DDS_PHASE_DEG(90));
+    dds_fill(&d, a, 1);
+    CHECK_EQ(a[0], d.mid + d.gain);
+    CHECK_EQ(DDS_PHASE_DEG(180), 0x80000000u);
+
+    // Amplitude: clamped to full scale, halved at Q15 0.5, zero gives mid
+    dds_set_amplitude(&d, 40000u);
+    CHECK_EQ(d.gain, 2047);
+    dds_set_amplitude(&d, 16384u);
+    CHECK_EQ(d.gain, 1024);
+    dds_set_amplitude(&d, 0);
+    dds_fill(&d, a, 8);
+    CHECK_EQ(a[7], d.mid);
+
+    // Square: high for the first half period, then low
+    dds_init(&d, 64000ull, 255, DDS_WAVE_SQUARE);
+    dds_set_frequency_mhz(&d, 1000u); // 64 samples per period
+    dds_fill(&d, a, 64);
+    uint32_t high = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        high += a[i] == d.mid + d.gain;
+        CHECK(a[i] == d.mid + d.gain || a[i] == d.mid - d.gain);
+    }
+    CHECK_EQ(high, 32);
+    CHECK_EQ(a[0], d.mid + d.gain);
+    CHECK_EQ(a[32], d.mid - d.gain);
+}
+
+/**
+ * @brief A tone of the generator at a frequency that does not fall on a bin.
+ */
+static dds_measure_t measure_dds(uint16_t top, uint32_t freq_mhz)
+{
+    dds_t d;
+    dds_measure_t m = {0};
+    dds_init(&d, PWM_RATE_MHZ, top, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&d, freq_mhz);
+    dds_fill(&d, block, N);
+    CHECK_EQ(dds_measure(block, N, &m), 0);
+    return m;
+}
+
+static void test_dds_spectrum(void)
+{
+    static const uint32_t freqs[] = {1000000u, 3333333u, 10000000u, 12345678u, 77777777u};
+    dds_measure_t m;
+
+    for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++)
+    {
+        // 8-bit PWM-DAC: quantization dominates, SNR about 6.02 * 8 + 1.76 = 49.9 dB
+        m = measure_dds(255, freqs[f]);
+        double bin = freqs[f] / 1000.0 * N / (PWM_RATE_MHZ / 1000.0);
+        CHECK_RANGE(m.fundamental_bin, floor(bin), ceil(bin));
+        CHECK_RANGE(m.snr_db, 48.5, 51.5);
+        CHECK_RANGE(m.sfdr_db, 60.0, 200.0);
+
+        // 16-bit levels: the 12-bit phase truncation sets the spurs, at -6.02 * 12 = -72 dBc
+        m = measure_dds(65535, freqs[f]);
+        CHECK_RANGE(m.sfdr_db, 70.0, 74.0);
+        CHECK_RANGE(m.snr_db, 65.0, 69.0);
+    }
+
+    // A tuning word that is a multiple of 2^20 never uses the truncated bits: no spurs
+    // beyond the 16-bit rounding
+    dds_t d;
+    dds_init(&d, PWM_RATE_MHZ, 65535, DDS_WAVE_SINE);
+    dds_set_tuning(&d, 97u << 20);
+    dds_fill(&d, block, N);
+    CHECK_EQ(dds_measure(block, N, &m), 0);
+    CHECK_RANGE(m.sfdr_db, 90.0, 200.0);
+
+    // A tone just above the DC lobe is measured without it
+    dds_init(&d, PWM_RATE_MHZ, 65535, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&d, 1100000u); // Bin 9.2
+    dds_fill(&d, block, N);
+    CHECK_EQ(dds_measure(block, N, &m), 0);
+    CHECK_RANGE(m.fundamental_bin, 9, 10);
+    CHECK_RANGE(m.sfdr_db, 70.0, 74.0);
+}
+
+/**
+ * @brief dds_measure() on blocks with a known spur and known noise.
+ */
+static void test_measure(void)
+{
+    dds_measure_t m;
+
+    // A tone at bin 300.3 with a second tone 60 dB down at bin 1000.7
+    for (uint32_t i = 0; i < N; i++)
+    {
+        level[i] = 32768.0 + 30000.0 * sin(2.0 * M_PI * 300.3 * i / N) + 30.0 * sin(2.0 * M_PI * 1000.7 * i / N);
+        block[i] = (uint16_t)lround(level[i]);
+    }
+    CHECK_EQ(dds_measure(block, N, &m), 0);
+    CHECK_EQ(m.fundamental_bin, 300);
+    CHECK_RANGE(m.spur_bin, 1000, 1001);
+    CHECK_RANGE(m.sfdr_db, 59.0, 61.0);
+
+    // White noise of known power: 1 LSB tone-to-noise ratio from the variances
+    uint32_t rng = 99;
+    double noise_power = 0.0;
+    for (uint32_t i = 0; i < N; i++)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        double u = ((rng >> 8) / 16777216.0 - 0.5) * 200.0; // Uniform, variance 200^2 / 12
+        noise_power += u * u;
+        block[i] = (uint16_t)lround(32768.0 + 20000.0 * sin(2.0 * M_PI * 511.25 * i / N) + u);
+    }
+    noise_power /= N;
+    double want = 10.0 * log10(20000.0 * 20000.0 / 2.0 / noise_power);
+    CHECK_EQ(dds_measure(block, N, &m), 0);
+    CHECK_RANGE(m.snr_db, want - 1.0, want + 1.0);
+
+    // Too short, or nothing but DC
+    CHECK_EQ(dds_measure(block, 63, &m), -1);
+    for (uint32_t i = 0; i < N; i++)
+    {
+        block[i] = 1234;
+    }
+    CHECK_EQ(dds_measure(block, N, &m), -1);
+}
+
+int main(void)
+{
+    test_tuning();
+    test_sine_levels();
+    test_controls();
+    test_dds_spectrum();
+    test_measure();
+    return host_test_result("test_dds");
+}
@@ -0,0 +1,233 @@
+/**
+ * @file fft_q15.c
+ * @brief In-place radix-2 Q15 FFT, windowing, magnitude and peak search.
+ */
+
+#include <stdbool.h>
+#include "fft_q15.h"
+
+#define QUARTER (FFT_Q15_MAX_N / 4u) ///< Table index of pi/2.
+
+int fft_q15_log2(size_t n)
+{
+    for (int b = 1; b <= FFT_Q15_LOG2_MAX_N; b++)
+    {
+        if (n == ((size_t)1 << b))
+        {
+            return b;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads cos and sin of 2*pi*a/FFT_Q15_MAX_N, for 0 <= a < FFT_Q15_MAX_N / 2.
+ */
+static inline void twiddle(uint32_t a, int32_t *c, int32_t *s)
+{
+    if (a <= QUARTER)
+    {
+        *c = fft_sin_q15[QUARTER - a];
+        *s = fft_sin_q15[a];
+    }
+    else
+    {
+        *c = -fft_sin_q15[a - QUARTER];
+        *s = fft_sin_q15[2u * QUARTER - a];
+    }
+}
+
+/**
+ * @brief Reorders the complex samples into bit-reversed index order.
+ */
+static void bit_reverse(q15_t *data, size_t n, int log2n)
+{
+    int shift = FFT_Q15_LOG2_MAX_N - log2n;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t r = fft_bitrev[i] >> shift;
+        if (r > i)
+        {
+            q15_t re = data[2 * i];
+            q15_t im = data[2 * i + 1];
+            data[2 * i] = data[2 * r];
+            data[2 * i + 1] = data[2 * r + 1];
+            data[2 * r] = re;
+            data[2 * r + 1] = im;
+        }
+    }
+}
+
+int fft_q15_forward(q15_t *data, size_t n)
+{
+    int log2n = fft_q15_log2(n);
+    if (log2n < 0)
+    {
+        return -1;
+    }
+
+    bit_reverse(data, n, log2n);
+
+    // First stage: every twiddle is 1, so no multiplies.
+    for (size_t i = 0; i < 2 * n; i += 4)
+    {
+        int32_t ar = data[i], ai = data[i + 1];
+        int32_t br = data[i + 2], bi = data[i + 3];
+        data[i] = (q15_t)((ar + br) >> 1);
+        data[i + 1] = (q15_t)((ai + bi) >> 1);
+        data[i + 2] = (q15_t)((ar - br) >> 1);
+        data[i + 3] = (q15_t)((ai - bi) >> 1);
+    }
+
+    // Remaining stages. The twiddle for butterfly k is W^k of this stage's length, read once
+    // and applied to every group so the table lookup stays out of the inner loop. Halving
+    // each stage keeps every value inside the unit circle, so nothing can overflow.
+    for (size_t len = 4; len <= n; len <<= 1)
+    {
+        size_t half = len >> 1;
+        uint32_t step = FFT_Q15_MAX_N / (uint32_t)len;
+
+        for (size_t k = 0; k < half; k++)
+        {
+            int32_t c, s;
+            twiddle((uint32_t)k * step, &c, &s);
+
+            for (size_t i = 2 * k; i < 2 * n; i += 2 * len)
+            {
+                size_t j = i + 2 * half;
+                int32_t xr = data[j], xi = data[j + 1];
+
+                // t = x[j] * (c - j s), Q15 * Q15 -> Q30, rounded back to Q15.
+                int32_t tr = (xr * c + xi * s + (1 << 14)) >> 15;
+                int32_t ti = (xi * c - xr * s + (1 << 14)) >> 15;
+                int32_t ar = data[i], ai = data[i + 1];
+
+                data[i] = (q15_t)((ar + tr) >> 1);
+                data[i + 1] = (q15_t)((ai + ti) >> 1);
+                data[j] = (q15_t)((ar - tr) >> 1);
+                data[j + 1] = (q15_t)((ai - ti) >> 1);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void fft_q15_window(q15_t *x, size_t n, fft_window_t window)
+{
+    const q15_t *w;
+
+    switch (window)
+    {
+    case FFT_WINDOW_HANN:
+        w = fft_window_hann;
+        break;
+    case FFT_WINDOW_HAMMING:
+        w = fft_window_hamming;
+        break;
+    case FFT_WINDOW_BLACKMAN:
+        w = fft_window_blackman;
+        break;
+    default:
+        return;
+    }
+
+    if (fft_q15_log2(n) < 0)
+    {
+        return;
+    }
+
+    // The tables hold w[0 .. MAX_N/2] for MAX_N points; the window for n points is every
+    // (MAX_N/n)-th entry, mirrored for the second half.
+    uint32_t step = FFT_Q15_MAX_N / (uint32_t)n;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t idx = (uint32_t)i * step;
+        if (idx > FFT_Q15_MAX_N / 2u)
+        {
+            idx = FFT_Q15_MAX_N - idx;
+        }
+        x[i] = (q15_t)(((int32_t)x[i] * w[idx] + (1 << 14)) >> 15);
+    }
+}
+
+void fft_q15_load_real(q15_t *cplx, const q15_t *x, size_t n)
+{
+    // Walk backwards so x may be the first half of cplx.
+    for (size_t i = n; i-- > 0;)
+    {
+        cplx[2 * i] = x[i];
+        cplx[2 * i + 1] = 0;
+    }
+}
+
+/**
+ * @brief Integer square root (floor), bit by bit: 16 iterations of shifts and adds.
+ */
+static uint16_t isqrt32(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+void fft_q15_magnitude(const q15_t *cplx, uint16_t *mag, size_t n_bins)
+{
+    for (size_t k = 0; k < n_bins; k++)
+    {
+        int32_t re = cplx[2 * k];
+        int32_t im = cplx[2 * k + 1];
+        mag[k] = isqrt32((uint32_t)(re * re) + (uint32_t)(im * im));
+    }
+}
+
+size_t fft_q15_peaks(const uint16_t *mag, size_t n_bins, fft_peak_t *peaks, size_t max_peaks)
+{
+    size_t found = 0;
+
+    if (max_peaks == 0)
+    {
+        return 0;
+    }
+
+    for (size_t k = 1; k < n_bins; k++)
+    {
+        uint16_t m = mag[k];
+        bool is_peak = m > mag[k - 1] && (k + 1 == n_bins || m >= mag[k + 1]);
+        if (!is_peak || (found == max_peaks && m <= peaks[found - 1].mag))
+        {
+            continue;
+        }
+
+        // Insertion into the sorted list, dropping the smallest when it is full.
+        size_t pos = (found < max_peaks) ? found++ : found - 1;
+        while (pos > 0 && peaks[pos - 1].mag < m)
+        {
+            peaks[pos] = peaks[pos - 1];
+            pos--;
+        }
+        peaks[pos].bin = (uint16_t)k;
+        peaks[pos].mag = m;
+    }
+
+    return found;
+}
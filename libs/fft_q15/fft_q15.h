@@ -0,0 +1,108 @@
+/**
+ * @file fft_q15.h
+ * @brief In-place radix-2 Q15 FFT, window tables and spectrum helpers for the Cortex-M0+.
+ *
+ * @details
+ * The transform is a decimation-in-time radix-2 FFT on interleaved complex Q15 data
+ * (`re0, im0, re1, im1, ...`) for any power-of-two length up to FFT_Q15_MAX_N. Every butterfly
+ * stage halves its outputs, so the result is X[k] / N and can never overflow: a full-scale
+ * sine of amplitude A shows up as A / 2 in its bin.
+ *
+ * Nothing is computed at run time from sin()/cos(). The twiddle factors come from a quarter-wave
+ * sine table, the bit-reversal permutation from a precomputed index table and the Hann,
+ * Hamming and Blackman windows from half-window tables, all sized for FFT_Q15_MAX_N and read
+ * with a stride for smaller N. The tables are generated by gen_fft_tables.py and live in flash.
+ *
+ * Radix-4 was not used: on the M0+ the butterfly cost is dominated by the 32-bit multiplies,
+ * and radix-4 only saves a quarter of those at the price of a second code path for odd log2(N).
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef FFT_Q15_H
+#define FFT_Q15_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FFT_Q15_MAX_N 2048u   ///< Largest supported transform length (size of the tables).
+#define FFT_Q15_LOG2_MAX_N 11 ///< log2(FFT_Q15_MAX_N).
+
+typedef int16_t q15_t; ///< Signed Q1.15 value (same type as in fixed_filter.h).
+
+typedef enum fft_window
+{
+    FFT_WINDOW_RECT = 0, ///< No window.
+    FFT_WINDOW_HANN,     ///< Periodic Hann.
+    FFT_WINDOW_HAMMING,  ///< Periodic Hamming.
+    FFT_WINDOW_BLACKMAN, ///< Periodic Blackman.
+} fft_window_t;
+
+typedef struct fft_peak
+{
+    uint16_t bin; ///< Frequency bin, f = bin * fs / N.
+    uint16_t mag; ///< Magnitude at that bin.
+} fft_peak_t;
+
+// Generated tables (fft_tables.c)
+extern const q15_t fft_sin_q15[FFT_Q15_MAX_N / 4 + 1];         ///< sin(2*pi*k/MAX_N), k = 0 .. MAX_N/4.
+extern const uint16_t fft_bitrev[FFT_Q15_MAX_N];               ///< Bit-reversed index for MAX_N points.
+extern const q15_t fft_window_hann[FFT_Q15_MAX_N / 2 + 1];     ///< First half of the Hann window.
+extern const q15_t fft_window_hamming[FFT_Q15_MAX_N / 2 + 1];  ///< First half of the Hamming window.
+extern const q15_t fft_window_blackman[FFT_Q15_MAX_N / 2 + 1]; ///< First half of the Blackman window.
+
+/**
+ * @brief Returns log2(n) if n is a supported transform length, or -1 otherwise.
+ */
+int fft_q15_log2(size_t n);
+
+/**
+ * @brief Forward FFT, in place.
+ *
+ * @param data Interleaved complex samples, 2 * n values. Replaced by X[k] / n.
+ * @param n Transform length, a power of two from 2 to FFT_Q15_MAX_N.
+ * @return int 0 on success, -1 if n is not supported.
+ */
+int fft_q15_forward(q15_t *data, size_t n);
+
+/**
+ * @brief Multiplies real samples by a window, in place.
+ *
+ * @param x Real samples, n values.
+ * @param n Block length, a power of two from 2 to FFT_Q15_MAX_N.
+ * @param window Window to apply.
+ */
+void fft_q15_window(q15_t *x, size_t n, fft_window_t window);
+
+/**
+ * @brief Loads real samples into an interleaved complex buffer (imaginary parts zero).
+ *
+ * @param cplx Destination, 2 * n values.
+ * @param x Real samples, n values.
+ * @param n Number of samples.
+ */
+void fft_q15_load_real(q15_t *cplx, const q15_t *x, size_t n);
+
+/**
+ * @brief Magnitude |X[k]| of the first n_bins bins, with an integer square root.
+ *
+ * @param cplx FFT output, interleaved complex.
+ * @param mag Output magnitudes, n_bins values (may not alias cplx).
+ * @param n_bins Number of bins, usually n / 2 for a real input.
+ */
+void fft_q15_magnitude(const q15_t *cplx, uint16_t *mag, size_t n_bins);
+
+/**
+ * @brief Finds the largest local maxima of a magnitude spectrum.
+ *
+ * Bin 0 (DC) is skipped. Peaks are returned sorted by decreasing magnitude.
+ *
+ * @param mag Magnitude spectrum.
+ * @param n_bins Number of bins.
+ * @param peaks Output, max_peaks entries.
+ * @param max_peaks Number of peaks wanted.
+ * @return size_t Number of peaks found (at most max_peaks).
+ */
+size_t fft_q15_peaks(const uint16_t *mag, size_t n_bins, fft_peak_t *peaks, size_t max_peaks);
+
+#endif // FFT_Q15_H
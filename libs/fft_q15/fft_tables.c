@@ -0,0 +1,452 @@
+/**
+ * @file fft_tables.c
+ * @brief Constant twiddle, bit-reversal and window tables for fft_q15.c.
+ *
+ * Generated by gen_fft_tables.py, do not edit by hand.
+ */
+
+#include "fft_q15.h"
+
+const q15_t fft_sin_q15[513] = {
+    0, 101, 201, 302, 402, 503, 603, 704, 804, 905, 1005, 1106,
+    1206, 1307, 1407, 1507, 1608, 1708, 1809, 1909, 2009, 2110, 2210, 2310,
+    2411, 2511, 2611, 2711, 2811, 2912, 3012, 3112, 3212, 3312, 3412, 3512,
+    3612, 3712, 3812, 3911, 4011, 4111, 4211, 4310, 4410, 4510, 4609, 4709,
+    4808, 4907, 5007, 5106, 5205, 5305, 5404, 5503, 5602, 5701, 5800, 5899,
+    5998, 6097, 6195, 6294, 6393, 6491, 6590, 6688, 6787, 6885, 6983, 7081,
+    7180, 7278, 7376, 7473, 7571, 7669, 7767, 7864, 7962, 8059, 8157, 8254,
+    8351, 8449, 8546, 8643, 8740, 8836, 8933, 9030, 9127, 9223, 9319, 9416,
+    9512, 9608, 9704, 9800, 9896, 9992, 10088, 10183, 10279, 10374, 10469, 10565,
+    10660, 10755, 10850, 10945, 11039, 11134, 11228, 11323, 11417, 11511, 11605, 11699,
+    11793, 11887, 11980, 12074, 12167, 12261, 12354, 12447, 12540, 12633, 12725, 12818,
+    12910, 13003, 13095, 13187, 13279, 13371, 13463, 13554, 13646, 13737, 13828, 13919,
+    14010, 14101, 14192, 14282, 14373, 14463, 14553, 14643, 14733, 14823, 14912, 15002,
+    15091, 15180, 15269, 15358, 15447, 15535, 15624, 15712, 15800, 15888, 15976, 16064,
+    16151, 16239, 16326, 16413, 16500, 16587, 16673, 16760, 16846, 16932, 17018, 17104,
+    17190, 17275, 17361, 17446, 17531, 17616, 17700, 17785, 17869, 17953, 18037, 18121,
+    18205, 18288, 18372, 18455, 18538, 18621, 18703, 18786, 18868, 18950, 19032, 19114,
+    19195, 19277, 19358, 19439, 19520, 19601, 19681, 19761, 19841, 19921, 20001, 20081,
+    20160, 20239, 20318, 20397, 20475, 20554, 20632, 20710, 20788, 20865, 20943, 21020,
+    21097, 21174, 21251, 21327, 21403, 21479, 21555, 21631, 21706, 21781, 21856, 21931,
+    22006, 22080, 22154, 22228, 22302, 22375, 22449, 22522, 22595, 22668, 22740, 22812,
+    22884, 22956, 23028, 23099, 23170, 23241, 23312, 23383, 23453, 23523, 23593, 23663,
+    23732, 23801, 23870, 23939, 24008, 24076, 24144, 24212, 24279, 24347, 24414, 24481,
+    24548, 24614, 24680, 24746, 24812, 24878, 24943, 25008, 25073, 25138, 25202, 25266,
+    25330, 25394, 25457, 25520, 25583, 25646, 25708, 25771, 25833, 25894, 25956, 26017,
+    26078, 26139, 26199, 26259, 26320, 26379, 26439, 26498, 26557, 26616, 26674, 26733,
+    26791, 26848, 26906, 26963, 27020, 27077, 27133, 27190, 27246, 27301, 27357, 27412,
+    27467, 27522, 27576, 27630, 27684, 27738, 27791, 27844, 27897, 27950, 28002, 28054,
+    28106, 28158, 28209, 28260, 28311, 28361, 28411, 28461, 28511, 28560, 28610, 28658,
+    28707, 28755, 28803, 28851, 28899, 28946, 28993, 29040, 29086, 29132, 29178, 29224,
+    29269, 29314, 29359, 29404, 29448, 29492, 29535, 29579, 29622, 29665, 29707, 29750,
+    29792, 29833, 29875, 29916, 29957, 29997, 30038, 30078, 30118, 30157, 30196, 30235,
+    30274, 30312, 30350, 30388, 30425, 30462, 30499, 30536, 30572, 30608, 30644, 30680,
+    30715, 30750, 30784, 30819, 30853, 30886, 30920, 30953, 30986, 31018, 31050, 31082,
+    31114, 31146, 31177, 31207, 31238, 31268, 31298, 31328, 31357, 31386, 31415, 31443,
+    31471, 31499, 31527, 31554, 31581, 31608, 31634, 31660, 31686, 31711, 31737, 31761,
+    31786, 31810, 31834, 31858, 31881, 31904, 31927, 31950, 31972, 31994, 32015, 32037,
+    32058, 32078, 32099, 32119, 32138, 32158, 32177, 32196, 32214, 32233, 32251, 32268,
+    32286, 32303, 32319, 32336, 32352, 32368, 32383, 32398, 32413, 32428, 32442, 32456,
+    32470, 32483, 32496, 32509, 32522, 32534, 32546, 32557, 32568, 32579, 32590, 32600,
+    32610, 32620, 32629, 32638, 32647, 32656, 32664, 32672, 32679, 32686, 32693, 32700,
+    32706, 32712, 32718, 32723, 32729, 32733, 32738, 32742, 32746, 32749, 32753, 32756,
+    32758, 32760, 32762, 32764, 32766, 32767, 32767, 32767, 32767,
+};
+
+const uint16_t fft_bitrev[2048] = {
+    0, 1024, 512, 1536, 256, 1280, 768, 1792, 128, 1152, 640, 1664, 384, 1408, 896, 1920,
+    64, 1088, 576, 1600, 320, 1344, 832, 1856, 192, 1216, 704, 1728, 448, 1472, 960, 1984,
+    32, 1056, 544, 1568, 288, 1312, 800, 1824, 160, 1184, 672, 1696, 416, 1440, 928, 1952,
+    96, 1120, 608, 1632, 352, 1376, 864, 1888, 224, 1248, 736, 1760, 480, 1504, 992, 2016,
+    16, 1040, 528, 1552, 272, 1296, 784, 1808, 144, 1168, 656, 1680, 400, 1424, 912, 1936,
+    80, 1104, 592, 1616, 336, 1360, 848, 1872, 208, 1232, 720, 1744, 464, 1488, 976, 2000,
+    48, 1072, 560, 1584, 304, 1328, 816, 1840, 176, 1200, 688, 1712, 432, 1456, 944, 1968,
+    112, 1136, 624, 1648, 368, 1392, 880, 1904, 240, 1264, 752, 1776, 496, 1520, 1008, 2032,
+    8, 1032, 520, 1544, 264, 1288, 776, 1800, 136, 1160, 648, 1672, 392, 1416, 904, 1928,
+    72, 1096, 584, 1608, 328, 1352, 840, 1864, 200, 1224, 712, 1736, 456, 1480, 968, 1992,
+    40, 1064, 552, 1576, 296, 1320, 808, 1832, 168, 1192, 680, 1704, 424, 1448, 936, 1960,
+    104, 1128, 616, 1640, 360, 1384, 872, 1896, 232, 1256, 744, 1768, 488, 1512, 1000, 2024,
+    24, 1048, 536, 1560, 280, 1304, 792, 1816, 152, 1176, 664, 1688, 408, 1432, 920, 1944,
+    88, 1112, 600, 1624, 344, 1368, 856, 1880, 216, 1240, 728, 1752, 472, 1496, 984, 2008,
+    56, 1080, 568, 1592, 312, 1336, 824, 1848, 184, 1208, 696, 1720, 440, 1464, 952, 1976,
+    120, 1144, 632, 1656, 376, 1400, 888, 1912, 248, 1272, 760, 1784, 504, 1528, 1016, 2040,
+    4, 1028, 516, 1540, 260, 1284, 772, 1796, 132, 1156, 644, 1668, 388, 1412, 900, 1924,
+    68, 1092, 580, 1604, 324, 1348, 836, 1860, 196, 1220, 708, 1732, 452, 1476, 964, 1988,
+    36, 1060, 548, 1572, 292, 1316, 804, 1828, 164, 1188, 676, 1700, 420, 1444, 932, 1956,
+    100, 1124, 612, 1636, 356, 1380, 868, 1892, 228, 1252, 740, 1764, 484, 1508, 996, 2020,
+    20, 1044, 532, 1556, 276, 1300, 788, 1812, 148, 1172, 660, 1684, 404, 1428, 916, 1940,
+    84, 1108, 596, 1620, 340, 1364, 852, 1876, 212, 1236, 724, 1748, 468, 1492, 980, 2004,
+    52, 1076, 564, 1588, 308, 1332, 820, 1844, 180, 1204, 692, 1716, 436, 1460, 948, 1972,
+    116, 1140, 628, 1652, 372, 1396, 884, 1908, 244, 1268, 756, 1780, 500, 1524, 1012, 2036,
+    12, 1036, 524, 1548, 268, 1292, 780, 1804, 140, 1164, 652, 1676, 396, 1420, 908, 1932,
+    76, 1100, 588, 1612, 332, 1356, 844, 1868, 204, 1228, 716, 1740, 460, 1484, 972, 1996,
+    44, 1068, 556, 1580, 300, 1324, 812, 1836, 172, 1196, 684, 1708, 428, 1452, 940, 1964,
+    108, 1132, 620, 1644, 364, 1388, 876, 1900, 236, 1260, 748, 1772, 492, 1516, 1004, 2028,
+    28, 1052, 540, 1564, 284, 1308, 796, 1820, 156, 1180, 668, 1692, 412, 1436, 924, 1948,
+    92, 1116, 604, 1628, 348, 1372, 860, 1884, 220, 1244, 732, 1756, 476, 1500, 988, 2012,
+    60, 1084, 572, 1596, 316, 1340, 828, 1852, 188, 1212, 700, 1724, 444, 1468, 956, 1980,
+    124, 1148, 636, 1660, 380, 1404, 892, 1916, 252, 1276, 764, 1788, 508, 1532, 1020, 2044,
+    2, 1026, 514, 1538, 258, 1282, 770, 1794, 130, 1154, 642, 1666, 386, 1410, 898, 1922,
+    66, 1090, 578, 1602, 322, 1346, 834, 1858, 194, 1218, 706, 1730, 450, 1474, 962, 1986,
+    34, 1058, 546, 1570, 290, 1314, 802, 1826, 162, 1186, 674, 1698, 418, 1442, 930, 1954,
+    98, 1122, 610, 1634, 354, 1378, 866, 1890, 226, 1250, 738, 1762, 482, 1506, 994, 2018,
+    18, 1042, 530, 1554, 274, 1298, 786, 1810, 146, 1170, 658, 1682, 402, 1426, 914, 1938,
+    82, 1106, 594, 1618, 338, 1362, 850, 1874, 210, 1234, 722, 1746, 466, 1490, 978, 2002,
+    50, 1074, 562, 1586, 306, 1330, 818, 1842, 178, 1202, 690, 1714, 434, 1458, 946, 1970,
+    114, 1138, 626, 1650, 370, 1394, 882, 1906, 242, 1266, 754, 1778, 498, 1522, 1010, 2034,
+    10, 1034, 522, 1546, 266, 1290, 778, 1802, 138, 1162, 650, 1674, 394, 1418, 906, 1930,
+    74, 1098, 586, 1610, 330, 1354, 842, 1866, 202, 1226, 714, 1738, 458, 1482, 970, 1994,
+    42, 1066, 554, 1578, 298, 1322, 810, 1834, 170, 1194, 682, 1706, 426, 1450, 938, 1962,
+    106, 1130, 618, 1642, 362, 1386, 874, 1898, 234, 1258, 746, 1770, 490, 1514, 1002, 2026,
+    26, 1050, 538, 1562, 282, 1306, 794, 1818, 154, 1178, 666, 1690, 410, 1434, 922, 1946,
+    90, 1114, 602, 1626, 346, 1370, 858, 1882, 218, 1242, 730, 1754, 474, 1498, 986, 2010,
+    58, 1082, 570, 1594, 314, 1338, 826, 1850, 186, 1210, 698, 1722, 442, 1466, 954, 1978,
+    122, 1146, 634, 1658, 378, 1402, 890, 1914, 250, 1274, 762, 1786, 506, 1530, 1018, 2042,
+    6, 1030, 518, 1542, 262, 1286, 774, 1798, 134, 1158, 646, 1670, 390, 1414, 902, 1926,
+    70, 1094, 582, 1606, 326, 1350, 838, 1862, 198, 1222, 710, 1734, 454, 1478, 966, 1990,
+    38, 1062, 550, 1574, 294, 1318, 806, 1830, 166, 1190, 678, 1702, 422, 1446, 934, 1958,
+    102, 1126, 614, 1638, 358, 1382, 870, 1894, 230, 1254, 742, 1766, 486, 1510, 998, 2022,
+    22, 1046, 534, 1558, 278, 1302, 790, 1814, 150, 1174, 662, 1686, 406, 1430, 918, 1942,
+    86, 1110, 598, 1622, 342, 1366, 854, 1878, 214, 1238, 726, 1750, 470, 1494, 982, 2006,
+    54, 1078, 566, 1590, 310, 1334, 822, 1846, 182, 1206, 694, 1718, 438, 1462, 950, 1974,
+    118, 1142, 630, 1654, 374, 1398, 886, 1910, 246, 1270, 758, 1782, 502, 1526, 1014, 2038,
+    14, 1038, 526, 1550, 270, 1294, 782, 1806, 142, 1166, 654, 1678, 398, 1422, 910, 1934,
+    78, 1102, 590, 1614, 334, 1358, 846, 1870, 206, 1230, 718, 1742, 462, 1486, 974, 1998,
+    46, 1070, 558, 1582, 302, 1326, 814, 1838, 174, 1198, 686, 1710, 430, 1454, 942, 1966,
+    110, 1134, 622, 1646, 366, 1390, 878, 1902, 238, 1262, 750, 1774, 494, 1518, 1006, 2030,
+    30, 1054, 542, 1566, 286, 1310, 798, 1822, 158, 1182, 670, 1694, 414, 1438, 926, 1950,
+    94, 1118, 606, 1630, 350, 1374, 862, 1886, 222, 1246, 734, 1758, 478, 1502, 990, 2014,
+    62, 1086, 574, 1598, 318, 1342, 830, 1854, 190, 1214, 702, 1726, 446, 1470, 958, 1982,
+    126, 1150, 638, 1662, 382, 1406, 894, 1918, 254, 1278, 766, 1790, 510, 1534, 1022, 2046,
+    1, 1025, 513, 1537, 257, 1281, 769, 1793, 129, 1153, 641, 1665, 385, 1409, 897, 1921,
+    65, 1089, 577, 1601, 321, 1345, 833, 1857, 193, 1217, 705, 1729, 449, 1473, 961, 1985,
+    33, 1057, 545, 1569, 289, 1313, 801, 1825, 161, 1185, 673, 1697, 417, 1441, 929, 1953,
+    97, 1121, 609, 1633, 353, 1377, 865, 1889, 225, 1249, 737, 1761, 481, 1505, 993, 2017,
+    17, 1041, 529, 1553, 273, 1297, 785, 1809, 145, 1169, 657, 1681, 401, 1425, 913, 1937,
+    81, 1105, 593, 1617, 337, 1361, 849, 1873, 209, 1233, 721, 1745, 465, 1489, 977, 2001,
+    49, 1073, 561, 1585, 305, 1329, 817, 1841, 177, 1201, 689, 1713, 433, 1457, 945, 1969,
+    113, 1137, 625, 1649, 369, 1393, 881, 1905, 241, 1265, 753, 1777, 497, 1521, 1009, 2033,
+    9, 1033, 521, 1545, 265, 1289, 777, 1801, 137, 1161, 649, 1673, 393, 1417, 905, 1929,
+    73, 1097, 585, 1609, 329, 1353, 841, 1865, 201, 1225, 713, 1737, 457, 1481, 969, 1993,
+    41, 1065, 553, 1577, 297, 1321, 809, 1833, 169, 1193, 681, 1705, 425, 1449, 937, 1961,
+    105, 1129, 617, 1641, 361, 1385, 873, 1897, 233, 1257, 745, 1769, 489, 1513, 1001, 2025,
+    25, 1049, 537, 1561, 281, 1305, 793, 1817, 153, 1177, 665, 1689, 409, 1433, 921, 1945,
+    89, 1113, 601, 1625, 345, 1369, 857, 1881, 217, 1241, 729, 1753, 473, 1497, 985, 2009,
+    57, 1081, 569, 1593, 313, 1337, 825, 1849, 185, 1209, 697, 1721, 441, 1465, 953, 1977,
+    121, 1145, 633, 1657, 377, 1401, 889, 1913, 249, 1273, 761, 1785, 505, 1529, 1017, 2041,
+    5, 1029, 517, 1541, 261, 1285, 773, 1797, 133, 1157, 645, 1669, 389, 1413, 901, 1925,
+    69, 1093, 581, 1605, 325, 1349, 837, 1861, 197, 1221, 709, 1733, 453, 1477, 965, 1989,
+    37, 1061, 549, 1573, 293, 1317, 805, 1829, 165, 1189, 677, 1701, 421, 1445, 933, 1957,
+    101, 1125, 613, 1637, 357, 1381, 869, 1893, 229, 1253, 741, 1765, 485, 1509, 997, 2021,
+    21, 1045, 533, 1557, 277, 1301, 789, 1813, 149, 1173, 661, 1685, 405, 1429, 917, 1941,
+    85, 1109, 597, 1621, 341, 1365, 853, 1877, 213, 1237, 725, 1749, 469, 1493, 981, 2005,
+    53, 1077, 565, 1589, 309, 1333, 821, 1845, 181, 1205, 693, 1717, 437, 1461, 949, 1973,
+    117, 1141, 629, 1653, 373, 1397, 885, 1909, 245, 1269, 757, 1781, 501, 1525, 1013, 2037,
+    13, 1037, 525, 1549, 269, 1293, 781, 1805, 141, 1165, 653, 1677, 397, 1421, 909, 1933,
+    77, 1101, 589, 1613, 333, 1357, 845, 1869, 205, 1229, 717, 1741, 461, 1485, 973, 1997,
+    45, 1069, 557, 1581, 301, 1325, 813, 1837, 173, 1197, 685, 1709, 429, 1453, 941, 1965,
+    109, 1133, 621, 1645, 365, 1389, 877, 1901, 237, 1261, 749, 1773, 493, 1517, 1005, 2029,
+    29, 1053, 541, 1565, 285, 1309, 797, 1821, 157, 1181, 669, 1693, 413, 1437, 925, 1949,
+    93, 1117, 605, 1629, 349, 1373, 861, 1885, 221, 1245, 733, 1757, 477, 1501, 989, 2013,
+    61, 1085, 573, 1597, 317, 1341, 829, 1853, 189, 1213, 701, 1725, 445, 1469, 957, 1981,
+    125, 1149, 637, 1661, 381, 1405, 893, 1917, 253, 1277, 765, 1789, 509, 1533, 1021, 2045,
+    3, 1027, 515, 1539, 259, 1283, 771, 1795, 131, 1155, 643, 1667, 387, 1411, 899, 1923,
+    67, 1091, 579, 1603, 323, 1347, 835, 1859, 195, 1219, 707, 1731, 451, 1475, 963, 1987,
+    35, 1059, 547, 1571, 291, 1315, 803, 1827, 163, 1187, 675, 1699, 419, 1443, 931, 1955,
+    99, 1123, 611, 1635, 355, 1379, 867, 1891, 227, 1251, 739, 1763, 483, 1507, 995, 2019,
+    19, 1043, 531, 1555, 275, 1299, 787, 1811, 147, 1171, 659, 1683, 403, 1427, 915, 1939,
+    83, 1107, 595, 1619, 339, 1363, 851, 1875, 211, 1235, 723, 1747, 467, 1491, 979, 2003,
+    51, 1075, 563, 1587, 307, 1331, 819, 1843, 179, 1203, 691, 1715, 435, 1459, 947, 1971,
+    115, 1139, 627, 1651, 371, 1395, 883, 1907, 243, 1267, 755, 1779, 499, 1523, 1011, 2035,
+    11, 1035, 523, 1547, 267, 1291, 779, 1803, 139, 1163, 651, 1675, 395, 1419, 907, 1931,
+    75, 1099, 587, 1611, 331, 1355, 843, 1867, 203, 1227, 715, 1739, 459, 1483, 971, 1995,
+    43, 1067, 555, 1579, 299, 1323, 811, 1835, 171, 1195, 683, 1707, 427, 1451, 939, 1963,
+    107, 1131, 619, 1643, 363, 1387, 875, 1899, 235, 1259, 747, 1771, 491, 1515, 1003, 2027,
+    27, 1051, 539, 1563, 283, 1307, 795, 1819, 155, 1179, 667, 1691, 411, 1435, 923, 1947,
+    91, 1115, 603, 1627, 347, 1371, 859, 1883, 219, 1243, 731, 1755, 475, 1499, 987, 2011,
+    59, 1083, 571, 1595, 315, 1339, 827, 1851, 187, 1211, 699, 1723, 443, 1467, 955, 1979,
+    123, 1147, 635, 1659, 379, 1403, 891, 1915, 251, 1275, 763, 1787, 507, 1531, 1019, 2043,
+    7, 1031, 519, 1543, 263, 1287, 775, 1799, 135, 1159, 647, 1671, 391, 1415, 903, 1927,
+    71, 1095, 583, 1607, 327, 1351, 839, 1863, 199, 1223, 711, 1735, 455, 1479, 967, 1991,
+    39, 1063, 551, 1575, 295, 1319, 807, 1831, 167, 1191, 679, 1703, 423, 1447, 935, 1959,
+    103, 1127, 615, 1639, 359, 1383, 871, 1895, 231, 1255, 743, 1767, 487, 1511, 999, 2023,
+    23, 1047, 535, 1559, 279, 1303, 791, 1815, 151, 1175, 663, 1687, 407, 1431, 919, 1943,
+    87, 1111, 599, 1623, 343, 1367, 855, 1879, 215, 1239, 727, 1751, 471, 1495, 983, 2007,
+    55, 1079, 567, 1591, 311, 1335, 823, 1847, 183, 1207, 695, 1719, 439, 1463, 951, 1975,
+    119, 1143, 631, 1655, 375, 1399, 887, 1911, 247, 1271, 759, 1783, 503, 1527, 1015, 2039,
+    15, 1039, 527, 1551, 271, 1295, 783, 1807, 143, 1167, 655, 1679, 399, 1423, 911, 1935,
+    79, 1103, 591, 1615, 335, 1359, 847, 1871, 207, 1231, 719, 1743, 463, 1487, 975, 1999,
+    47, 1071, 559, 1583, 303, 1327, 815, 1839, 175, 1199, 687, 1711, 431, 1455, 943, 1967,
+    111, 1135, 623, 1647, 367, 1391, 879, 1903, 239, 1263, 751, 1775, 495, 1519, 1007, 2031,
+    31, 1055, 543, 1567, 287, 1311, 799, 1823, 159, 1183, 671, 1695, 415, 1439, 927, 1951,
+    95, 1119, 607, 1631, 351, 1375, 863, 1887, 223, 1247, 735, 1759, 479, 1503, 991, 2015,
+    63, 1087, 575, 1599, 319, 1343, 831, 1855, 191, 1215, 703, 1727, 447, 1471, 959, 1983,
+    127, 1151, 639, 1663, 383, 1407, 895, 1919, 255, 1279, 767, 1791, 511, 1535, 1023, 2047,
+};
+
+const q15_t fft_window_hann[1025] = {
+    0, 0, 0, 1, 1, 2, 3, 4, 5, 6, 8, 9,
+    11, 13, 15, 17, 20, 22, 25, 28, 31, 34, 37, 41,
+    44, 48, 52, 56, 60, 65, 69, 74, 79, 84, 89, 94,
+    100, 105, 111, 117, 123, 129, 136, 142, 149, 156, 163, 170,
+    177, 185, 192, 200, 208, 216, 224, 233, 241, 250, 259, 268,
+    277, 286, 296, 305, 315, 325, 335, 345, 355, 366, 376, 387,
+    398, 409, 420, 432, 443, 455, 467, 479, 491, 503, 516, 528,
+    541, 554, 567, 580, 593, 607, 621, 634, 648, 662, 677, 691,
+    705, 720, 735, 750, 765, 780, 796, 811, 827, 843, 859, 875,
+    891, 908, 924, 941, 958, 975, 992, 1009, 1027, 1044, 1062, 1080,
+    1098, 1116, 1134, 1153, 1171, 1190, 1209, 1228, 1247, 1266, 1286, 1306,
+    1325, 1345, 1365, 1385, 1406, 1426, 1447, 1467, 1488, 1509, 1530, 1552,
+    1573, 1595, 1616, 1638, 1660, 1682, 1704, 1727, 1749, 1772, 1795, 1818,
+    1841, 1864, 1887, 1911, 1935, 1958, 1982, 2006, 2030, 2055, 2079, 2104,
+    2128, 2153, 2178, 2203, 2229, 2254, 2280, 2305, 2331, 2357, 2383, 2409,
+    2435, 2462, 2488, 2515, 2542, 2569, 2596, 2623, 2651, 2678, 2706, 2733,
+    2761, 2789, 2817, 2846, 2874, 2902, 2931, 2960, 2989, 3018, 3047, 3076,
+    3105, 3135, 3165, 3194, 3224, 3254, 3284, 3315, 3345, 3376, 3406, 3437,
+    3468, 3499, 3530, 3561, 3592, 3624, 3655, 3687, 3719, 3751, 3783, 3815,
+    3847, 3880, 3912, 3945, 3978, 4011, 4044, 4077, 4110, 4144, 4177, 4211,
+    4244, 4278, 4312, 4346, 4380, 4414, 4449, 4483, 4518, 4553, 4587, 4622,
+    4657, 4693, 4728, 4763, 4799, 4834, 4870, 4906, 4942, 4978, 5014, 5050,
+    5087, 5123, 5160, 5196, 5233, 5270, 5307, 5344, 5381, 5418, 5456, 5493,
+    5531, 5569, 5606, 5644, 5682, 5721, 5759, 5797, 5835, 5874, 5913, 5951,
+    5990, 6029, 6068, 6107, 6146, 6186, 6225, 6264, 6304, 6344, 6383, 6423,
+    6463, 6503, 6543, 6584, 6624, 6664, 6705, 6746, 6786, 6827, 6868, 6909,
+    6950, 6991, 7032, 7074, 7115, 7157, 7198, 7240, 7282, 7323, 7365, 7407,
+    7449, 7492, 7534, 7576, 7619, 7661, 7704, 7746, 7789, 7832, 7875, 7918,
+    7961, 8004, 8047, 8091, 8134, 8177, 8221, 8265, 8308, 8352, 8396, 8440,
+    8484, 8528, 8572, 8616, 8661, 8705, 8749, 8794, 8839, 8883, 8928, 8973,
+    9018, 9063, 9108, 9153, 9198, 9243, 9288, 9334, 9379, 9424, 9470, 9516,
+    9561, 9607, 9653, 9699, 9745, 9791, 9837, 9883, 9929, 9975, 10021, 10068,
+    10114, 10161, 10207, 10254, 10300, 10347, 10394, 10441, 10487, 10534, 10581, 10628,
+    10676, 10723, 10770, 10817, 10864, 10912, 10959, 11007, 11054, 11102, 11149, 11197,
+    11245, 11292, 11340, 11388, 11436, 11484, 11532, 11580, 11628, 11676, 11724, 11772,
+    11821, 11869, 11917, 11966, 12014, 12063, 12111, 12160, 12208, 12257, 12306, 12354,
+    12403, 12452, 12501, 12549, 12598, 12647, 12696, 12745, 12794, 12843, 12892, 12942,
+    12991, 13040, 13089, 13138, 13188, 13237, 13286, 13336, 13385, 13435, 13484, 13533,
+    13583, 13632, 13682, 13732, 13781, 13831, 13881, 13930, 13980, 14030, 14079, 14129,
+    14179, 14229, 14279, 14329, 14378, 14428, 14478, 14528, 14578, 14628, 14678, 14728,
+    14778, 14828, 14878, 14928, 14978, 15028, 15078, 15129, 15179, 15229, 15279, 15329,
+    15379, 15429, 15480, 15530, 15580, 15630, 15680, 15731, 15781, 15831, 15881, 15932,
+    15982, 16032, 16082, 16133, 16183, 16233, 16283, 16334, 16384, 16434, 16485, 16535,
+    16585, 16635, 16686, 16736, 16786, 16836, 16887, 16937, 16987, 17037, 17088, 17138,
+    17188, 17238, 17288, 17339, 17389, 17439, 17489, 17539, 17589, 17639, 17690, 17740,
+    17790, 17840, 17890, 17940, 17990, 18040, 18090, 18140, 18190, 18240, 18290, 18340,
+    18390, 18439, 18489, 18539, 18589, 18639, 18689, 18738, 18788, 18838, 18887, 18937,
+    18987, 19036, 19086, 19136, 19185, 19235, 19284, 19333, 19383, 19432, 19482, 19531,
+    19580, 19630, 19679, 19728, 19777, 19826, 19876, 19925, 19974, 20023, 20072, 20121,
+    20170, 20219, 20267, 20316, 20365, 20414, 20462, 20511, 20560, 20608, 20657, 20705,
+    20754, 20802, 20851, 20899, 20947, 20996, 21044, 21092, 21140, 21188, 21236, 21284,
+    21332, 21380, 21428, 21476, 21523, 21571, 21619, 21666, 21714, 21761, 21809, 21856,
+    21904, 21951, 21998, 22045, 22092, 22140, 22187, 22234, 22281, 22327, 22374, 22421,
+    22468, 22514, 22561, 22607, 22654, 22700, 22747, 22793, 22839, 22885, 22931, 22977,
+    23023, 23069, 23115, 23161, 23207, 23252, 23298, 23344, 23389, 23434, 23480, 23525,
+    23570, 23615, 23660, 23705, 23750, 23795, 23840, 23885, 23929, 23974, 24019, 24063,
+    24107, 24152, 24196, 24240, 24284, 24328, 24372, 24416, 24460, 24503, 24547, 24591,
+    24634, 24677, 24721, 24764, 24807, 24850, 24893, 24936, 24979, 25022, 25064, 25107,
+    25149, 25192, 25234, 25276, 25319, 25361, 25403, 25445, 25486, 25528, 25570, 25611,
+    25653, 25694, 25736, 25777, 25818, 25859, 25900, 25941, 25982, 26022, 26063, 26104,
+    26144, 26184, 26225, 26265, 26305, 26345, 26385, 26424, 26464, 26504, 26543, 26582,
+    26622, 26661, 26700, 26739, 26778, 26817, 26855, 26894, 26933, 26971, 27009, 27047,
+    27086, 27124, 27162, 27199, 27237, 27275, 27312, 27350, 27387, 27424, 27461, 27498,
+    27535, 27572, 27608, 27645, 27681, 27718, 27754, 27790, 27826, 27862, 27898, 27934,
+    27969, 28005, 28040, 28075, 28111, 28146, 28181, 28215, 28250, 28285, 28319, 28354,
+    28388, 28422, 28456, 28490, 28524, 28557, 28591, 28624, 28658, 28691, 28724, 28757,
+    28790, 28823, 28856, 28888, 28921, 28953, 28985, 29017, 29049, 29081, 29113, 29144,
+    29176, 29207, 29238, 29269, 29300, 29331, 29362, 29392, 29423, 29453, 29484, 29514,
+    29544, 29574, 29603, 29633, 29663, 29692, 29721, 29750, 29779, 29808, 29837, 29866,
+    29894, 29922, 29951, 29979, 30007, 30035, 30062, 30090, 30117, 30145, 30172, 30199,
+    30226, 30253, 30280, 30306, 30333, 30359, 30385, 30411, 30437, 30463, 30488, 30514,
+    30539, 30565, 30590, 30615, 30640, 30664, 30689, 30713, 30738, 30762, 30786, 30810,
+    30833, 30857, 30881, 30904, 30927, 30950, 30973, 30996, 31019, 31041, 31064, 31086,
+    31108, 31130, 31152, 31173, 31195, 31216, 31238, 31259, 31280, 31301, 31321, 31342,
+    31362, 31383, 31403, 31423, 31443, 31462, 31482, 31502, 31521, 31540, 31559, 31578,
+    31597, 31615, 31634, 31652, 31670, 31688, 31706, 31724, 31741, 31759, 31776, 31793,
+    31810, 31827, 31844, 31860, 31877, 31893, 31909, 31925, 31941, 31957, 31972, 31988,
+    32003, 32018, 32033, 32048, 32063, 32077, 32091, 32106, 32120, 32134, 32147, 32161,
+    32175, 32188, 32201, 32214, 32227, 32240, 32252, 32265, 32277, 32289, 32301, 32313,
+    32325, 32336, 32348, 32359, 32370, 32381, 32392, 32402, 32413, 32423, 32433, 32443,
+    32453, 32463, 32472, 32482, 32491, 32500, 32509, 32518, 32527, 32535, 32544, 32552,
+    32560, 32568, 32576, 32583, 32591, 32598, 32605, 32612, 32619, 32626, 32632, 32639,
+    32645, 32651, 32657, 32663, 32668, 32674, 32679, 32684, 32689, 32694, 32699, 32703,
+    32708, 32712, 32716, 32720, 32724, 32727, 32731, 32734, 32737, 32740, 32743, 32746,
+    32748, 32751, 32753, 32755, 32757, 32759, 32760, 32762, 32763, 32764, 32765, 32766,
+    32767, 32767, 32767, 32767, 32767,
+};
+
+const q15_t fft_window_hamming[1025] = {
+    2621, 2622, 2622, 2622, 2623, 2623, 2624, 2625, 2626, 2627, 2629, 2630,
+    2632, 2633, 2635, 2637, 2640, 2642, 2644, 2647, 2650, 2653, 2656, 2659,
+    2662, 2666, 2669, 2673, 2677, 2681, 2685, 2690, 2694, 2699, 2703, 2708,
+    2713, 2718, 2724, 2729, 2735, 2741, 2746, 2752, 2759, 2765, 2771, 2778,
+    2785, 2791, 2798, 2806, 2813, 2820, 2828, 2836, 2843, 2851, 2859, 2868,
+    2876, 2885, 2893, 2902, 2911, 2920, 2929, 2939, 2948, 2958, 2968, 2978,
+    2988, 2998, 3008, 3019, 3029, 3040, 3051, 3062, 3073, 3084, 3096, 3107,
+    3119, 3131, 3143, 3155, 3167, 3180, 3192, 3205, 3218, 3231, 3244, 3257,
+    3270, 3284, 3298, 3311, 3325, 3339, 3353, 3368, 3382, 3397, 3411, 3426,
+    3441, 3456, 3472, 3487, 3503, 3518, 3534, 3550, 3566, 3582, 3598, 3615,
+    3631, 3648, 3665, 3682, 3699, 3716, 3734, 3751, 3769, 3787, 3804, 3823,
+    3841, 3859, 3877, 3896, 3915, 3933, 3952, 3971, 3991, 4010, 4029, 4049,
+    4069, 4088, 4108, 4129, 4149, 4169, 4190, 4210, 4231, 4252, 4273, 4294,
+    4315, 4336, 4358, 4380, 4401, 4423, 4445, 4467, 4489, 4512, 4534, 4557,
+    4580, 4603, 4625, 4649, 4672, 4695, 4719, 4742, 4766, 4790, 4814, 4838,
+    4862, 4886, 4911, 4935, 4960, 4985, 5010, 5035, 5060, 5085, 5111, 5136,
+    5162, 5187, 5213, 5239, 5265, 5292, 5318, 5344, 5371, 5398, 5425, 5451,
+    5478, 5506, 5533, 5560, 5588, 5615, 5643, 5671, 5699, 5727, 5755, 5783,
+    5812, 5840, 5869, 5898, 5926, 5955, 5984, 6014, 6043, 6072, 6102, 6131,
+    6161, 6191, 6221, 6251, 6281, 6311, 6342, 6372, 6403, 6433, 6464, 6495,
+    6526, 6557, 6588, 6620, 6651, 6683, 6714, 6746, 6778, 6810, 6842, 6874,
+    6906, 6939, 6971, 7004, 7036, 7069, 7102, 7135, 7168, 7201, 7234, 7268,
+    7301, 7335, 7368, 7402, 7436, 7470, 7504, 7538, 7572, 7606, 7641, 7675,
+    7710, 7745, 7779, 7814, 7849, 7884, 7919, 7955, 7990, 8025, 8061, 8097,
+    8132, 8168, 8204, 8240, 8276, 8312, 8348, 8385, 8421, 8458, 8494, 8531,
+    8568, 8605, 8641, 8678, 8716, 8753, 8790, 8827, 8865, 8902, 8940, 8978,
+    9015, 9053, 9091, 9129, 9167, 9205, 9244, 9282, 9320, 9359, 9398, 9436,
+    9475, 9514, 9553, 9592, 9631, 9670, 9709, 9748, 9787, 9827, 9866, 9906,
+    9946, 9985, 10025, 10065, 10105, 10145, 10185, 10225, 10265, 10305, 10346, 10386,
+    10427, 10467, 10508, 10548, 10589, 10630, 10671, 10712, 10753, 10794, 10835, 10876,
+    10918, 10959, 11000, 11042, 11083, 11125, 11167, 11208, 11250, 11292, 11334, 11376,
+    11418, 11460, 11502, 11544, 11586, 11629, 11671, 11713, 11756, 11798, 11841, 11884,
+    11926, 11969, 12012, 12055, 12098, 12141, 12184, 12227, 12270, 12313, 12356, 12400,
+    12443, 12486, 12530, 12573, 12617, 12660, 12704, 12748, 12791, 12835, 12879, 12923,
+    12967, 13010, 13054, 13098, 13142, 13187, 13231, 13275, 13319, 13363, 13408, 13452,
+    13497, 13541, 13585, 13630, 13674, 13719, 13764, 13808, 13853, 13898, 13943, 13987,
+    14032, 14077, 14122, 14167, 14212, 14257, 14302, 14347, 14392, 14437, 14482, 14528,
+    14573, 14618, 14663, 14709, 14754, 14799, 14845, 14890, 14936, 14981, 15027, 15072,
+    15118, 15163, 15209, 15255, 15300, 15346, 15392, 15437, 15483, 15529, 15575, 15620,
+    15666, 15712, 15758, 15804, 15850, 15895, 15941, 15987, 16033, 16079, 16125, 16171,
+    16217, 16263, 16309, 16355, 16401, 16448, 16494, 16540, 16586, 16632, 16678, 16724,
+    16770, 16817, 16863, 16909, 16955, 17001, 17047, 17094, 17140, 17186, 17232, 17279,
+    17325, 17371, 17417, 17464, 17510, 17556, 17602, 17648, 17695, 17741, 17787, 17833,
+    17880, 17926, 17972, 18018, 18065, 18111, 18157, 18203, 18250, 18296, 18342, 18388,
+    18434, 18481, 18527, 18573, 18619, 18665, 18711, 18757, 18804, 18850, 18896, 18942,
+    18988, 19034, 19080, 19126, 19172, 19218, 19264, 19310, 19356, 19402, 19448, 19494,
+    19540, 19586, 19632, 19677, 19723, 19769, 19815, 19861, 19906, 19952, 19998, 20044,
+    20089, 20135, 20181, 20226, 20272, 20317, 20363, 20408, 20454, 20499, 20545, 20590,
+    20635, 20681, 20726, 20771, 20817, 20862, 20907, 20952, 20997, 21042, 21087, 21133,
+    21178, 21222, 21267, 21312, 21357, 21402, 21447, 21492, 21536, 21581, 21626, 21670,
+    21715, 21760, 21804, 21848, 21893, 21937, 21982, 22026, 22070, 22114, 22159, 22203,
+    22247, 22291, 22335, 22379, 22423, 22467, 22511, 22554, 22598, 22642, 22686, 22729,
+    22773, 22816, 22860, 22903, 22947, 22990, 23033, 23076, 23120, 23163, 23206, 23249,
+    23292, 23335, 23377, 23420, 23463, 23506, 23548, 23591, 23633, 23676, 23718, 23761,
+    23803, 23845, 23887, 23930, 23972, 24014, 24056, 24098, 24139, 24181, 24223, 24265,
+    24306, 24348, 24389, 24430, 24472, 24513, 24554, 24595, 24637, 24678, 24719, 24759,
+    24800, 24841, 24882, 24922, 24963, 25003, 25044, 25084, 25124, 25165, 25205, 25245,
+    25285, 25325, 25364, 25404, 25444, 25484, 25523, 25563, 25602, 25641, 25681, 25720,
+    25759, 25798, 25837, 25876, 25915, 25953, 25992, 26030, 26069, 26107, 26146, 26184,
+    26222, 26260, 26298, 26336, 26374, 26412, 26449, 26487, 26525, 26562, 26599, 26637,
+    26674, 26711, 26748, 26785, 26822, 26859, 26895, 26932, 26968, 27005, 27041, 27077,
+    27113, 27149, 27185, 27221, 27257, 27293, 27328, 27364, 27399, 27435, 27470, 27505,
+    27540, 27575, 27610, 27645, 27679, 27714, 27749, 27783, 27817, 27852, 27886, 27920,
+    27954, 27987, 28021, 28055, 28088, 28122, 28155, 28188, 28222, 28255, 28288, 28320,
+    28353, 28386, 28418, 28451, 28483, 28515, 28548, 28580, 28611, 28643, 28675, 28707,
+    28738, 28770, 28801, 28832, 28863, 28894, 28925, 28956, 28987, 29017, 29048, 29078,
+    29108, 29138, 29169, 29198, 29228, 29258, 29288, 29317, 29347, 29376, 29405, 29434,
+    29463, 29492, 29521, 29549, 29578, 29606, 29634, 29663, 29691, 29719, 29746, 29774,
+    29802, 29829, 29857, 29884, 29911, 29938, 29965, 29992, 30018, 30045, 30071, 30098,
+    30124, 30150, 30176, 30202, 30228, 30253, 30279, 30304, 30330, 30355, 30380, 30405,
+    30429, 30454, 30479, 30503, 30527, 30552, 30576, 30600, 30624, 30647, 30671, 30694,
+    30718, 30741, 30764, 30787, 30810, 30833, 30855, 30878, 30900, 30922, 30944, 30966,
+    30988, 31010, 31032, 31053, 31074, 31096, 31117, 31138, 31159, 31179, 31200, 31220,
+    31241, 31261, 31281, 31301, 31321, 31341, 31360, 31380, 31399, 31418, 31437, 31456,
+    31475, 31494, 31512, 31530, 31549, 31567, 31585, 31603, 31621, 31638, 31656, 31673,
+    31690, 31707, 31724, 31741, 31758, 31775, 31791, 31807, 31823, 31840, 31855, 31871,
+    31887, 31902, 31918, 31933, 31948, 31963, 31978, 31993, 32007, 32022, 32036, 32050,
+    32064, 32078, 32092, 32105, 32119, 32132, 32146, 32159, 32172, 32184, 32197, 32210,
+    32222, 32234, 32246, 32258, 32270, 32282, 32294, 32305, 32316, 32327, 32338, 32349,
+    32360, 32371, 32381, 32392, 32402, 32412, 32422, 32432, 32441, 32451, 32460, 32469,
+    32478, 32487, 32496, 32505, 32513, 32522, 32530, 32538, 32546, 32554, 32562, 32569,
+    32577, 32584, 32591, 32598, 32605, 32612, 32618, 32625, 32631, 32637, 32643, 32649,
+    32655, 32660, 32666, 32671, 32676, 32681, 32686, 32691, 32695, 32700, 32704, 32708,
+    32712, 32716, 32720, 32724, 32727, 32730, 32734, 32737, 32740, 32742, 32745, 32748,
+    32750, 32752, 32754, 32756, 32758, 32759, 32761, 32762, 32763, 32765, 32765, 32766,
+    32767, 32767, 32767, 32767, 32767,
+};
+
+const q15_t fft_window_blackman[1025] = {
+    0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 3,
+    4, 5, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15,
+    16, 17, 19, 20, 22, 23, 25, 27, 29, 30, 32, 34,
+    36, 38, 40, 42, 45, 47, 49, 52, 54, 57, 59, 62,
+    64, 67, 70, 73, 76, 79, 82, 85, 88, 91, 94, 98,
+    101, 105, 108, 112, 115, 119, 123, 126, 130, 134, 138, 142,
+    146, 151, 155, 159, 163, 168, 172, 177, 181, 186, 191, 196,
+    200, 205, 210, 215, 221, 226, 231, 236, 242, 247, 253, 258,
+    264, 269, 275, 281, 287, 293, 299, 305, 311, 317, 324, 330,
+    336, 343, 349, 356, 363, 369, 376, 383, 390, 397, 404, 412,
+    419, 426, 433, 441, 448, 456, 464, 472, 479, 487, 495, 503,
+    511, 520, 528, 536, 545, 553, 562, 570, 579, 588, 597, 606,
+    615, 624, 633, 642, 651, 661, 670, 680, 690, 699, 709, 719,
+    729, 739, 749, 759, 770, 780, 790, 801, 811, 822, 833, 844,
+    855, 866, 877, 888, 899, 911, 922, 934, 945, 957, 969, 981,
+    993, 1005, 1017, 1029, 1041, 1054, 1066, 1079, 1091, 1104, 1117, 1130,
+    1143, 1156, 1169, 1183, 1196, 1209, 1223, 1237, 1250, 1264, 1278, 1292,
+    1306, 1321, 1335, 1349, 1364, 1378, 1393, 1408, 1423, 1438, 1453, 1468,
+    1483, 1499, 1514, 1530, 1545, 1561, 1577, 1593, 1609, 1625, 1641, 1658,
+    1674, 1691, 1707, 1724, 1741, 1758, 1775, 1792, 1810, 1827, 1844, 1862,
+    1880, 1898, 1915, 1933, 1952, 1970, 1988, 2007, 2025, 2044, 2063, 2081,
+    2100, 2119, 2139, 2158, 2177, 2197, 2216, 2236, 2256, 2276, 2296, 2316,
+    2336, 2357, 2377, 2398, 2419, 2440, 2461, 2482, 2503, 2524, 2545, 2567,
+    2589, 2610, 2632, 2654, 2676, 2699, 2721, 2743, 2766, 2789, 2811, 2834,
+    2857, 2880, 2904, 2927, 2951, 2974, 2998, 3022, 3046, 3070, 3094, 3118,
+    3143, 3167, 3192, 3217, 3242, 3267, 3292, 3317, 3343, 3368, 3394, 3419,
+    3445, 3471, 3498, 3524, 3550, 3577, 3603, 3630, 3657, 3684, 3711, 3738,
+    3766, 3793, 3821, 3848, 3876, 3904, 3932, 3961, 3989, 4018, 4046, 4075,
+    4104, 4133, 4162, 4191, 4220, 4250, 4280, 4309, 4339, 4369, 4399, 4430,
+    4460, 4491, 4521, 4552, 4583, 4614, 4645, 4676, 4708, 4739, 4771, 4803,
+    4835, 4867, 4899, 4931, 4963, 4996, 5029, 5062, 5094, 5128, 5161, 5194,
+    5228, 5261, 5295, 5329, 5363, 5397, 5431, 5465, 5500, 5534, 5569, 5604,
+    5639, 5674, 5709, 5745, 5780, 5816, 5852, 5888, 5924, 5960, 5996, 6033,
+    6069, 6106, 6143, 6179, 6217, 6254, 6291, 6329, 6366, 6404, 6442, 6480,
+    6518, 6556, 6594, 6633, 6671, 6710, 6749, 6788, 6827, 6866, 6905, 6945,
+    6985, 7024, 7064, 7104, 7144, 7184, 7225, 7265, 7306, 7347, 7388, 7429,
+    7470, 7511, 7552, 7594, 7635, 7677, 7719, 7761, 7803, 7845, 7888, 7930,
+    7973, 8015, 8058, 8101, 8144, 8188, 8231, 8274, 8318, 8362, 8405, 8449,
+    8493, 8537, 8582, 8626, 8671, 8715, 8760, 8805, 8850, 8895, 8940, 8986,
+    9031, 9077, 9122, 9168, 9214, 9260, 9306, 9353, 9399, 9445, 9492, 9539,
+    9586, 9633, 9680, 9727, 9774, 9821, 9869, 9916, 9964, 10012, 10060, 10108,
+    10156, 10204, 10253, 10301, 10350, 10398, 10447, 10496, 10545, 10594, 10643, 10693,
+    10742, 10792, 10841, 10891, 10941, 10991, 11041, 11091, 11141, 11191, 11242, 11292,
+    11343, 11394, 11444, 11495, 11546, 11597, 11649, 11700, 11751, 11803, 11854, 11906,
+    11958, 12009, 12061, 12113, 12166, 12218, 12270, 12322, 12375, 12427, 12480, 12533,
+    12585, 12638, 12691, 12744, 12797, 12851, 12904, 12957, 13011, 13064, 13118, 13172,
+    13225, 13279, 13333, 13387, 13441, 13495, 13549, 13604, 13658, 13712, 13767, 13822,
+    13876, 13931, 13986, 14040, 14095, 14150, 14205, 14261, 14316, 14371, 14426, 14482,
+    14537, 14593, 14648, 14704, 14759, 14815, 14871, 14927, 14983, 15039, 15095, 15151,
+    15207, 15263, 15319, 15375, 15432, 15488, 15544, 15601, 15657, 15714, 15771, 15827,
+    15884, 15941, 15997, 16054, 16111, 16168, 16225, 16282, 16339, 16396, 16453, 16510,
+    16567, 16625, 16682, 16739, 16796, 16854, 16911, 16968, 17026, 17083, 17141, 17198,
+    17256, 17313, 17371, 17428, 17486, 17544, 17601, 17659, 17717, 17774, 17832, 17890,
+    17948, 18005, 18063, 18121, 18179, 18237, 18294, 18352, 18410, 18468, 18526, 18584,
+    18642, 18699, 18757, 18815, 18873, 18931, 18989, 19047, 19105, 19162, 19220, 19278,
+    19336, 19394, 19452, 19510, 19567, 19625, 19683, 19741, 19799, 19856, 19914, 19972,
+    20030, 20087, 20145, 20203, 20260, 20318, 20375, 20433, 20491, 20548, 20606, 20663,
+    20720, 20778, 20835, 20893, 20950, 21007, 21064, 21122, 21179, 21236, 21293, 21350,
+    21407, 21464, 21521, 21578, 21635, 21692, 21748, 21805, 21862, 21918, 21975, 22032,
+    22088, 22144, 22201, 22257, 22313, 22370, 22426, 22482, 22538, 22594, 22650, 22706,
+    22762, 22817, 22873, 22929, 22984, 23040, 23095, 23150, 23206, 23261, 23316, 23371,
+    23426, 23481, 23536, 23590, 23645, 23700, 23754, 23809, 23863, 23917, 23971, 24025,
+    24079, 24133, 24187, 24241, 24295, 24348, 24402, 24455, 24508, 24562, 24615, 24668,
+    24721, 24774, 24826, 24879, 24931, 24984, 25036, 25088, 25140, 25192, 25244, 25296,
+    25348, 25399, 25451, 25502, 25553, 25605, 25656, 25706, 25757, 25808, 25858, 25909,
+    25959, 26009, 26059, 26109, 26159, 26209, 26259, 26308, 26357, 26406, 26456, 26505,
+    26553, 26602, 26651, 26699, 26747, 26795, 26843, 26891, 26939, 26987, 27034, 27081,
+    27129, 27176, 27222, 27269, 27316, 27362, 27409, 27455, 27501, 27547, 27592, 27638,
+    27683, 27729, 27774, 27819, 27863, 27908, 27953, 27997, 28041, 28085, 28129, 28173,
+    28216, 28259, 28303, 28346, 28389, 28431, 28474, 28516, 28558, 28600, 28642, 28684,
+    28725, 28767, 28808, 28849, 28890, 28930, 28971, 29011, 29051, 29091, 29131, 29171,
+    29210, 29249, 29288, 29327, 29366, 29404, 29443, 29481, 29519, 29556, 29594, 29631,
+    29668, 29705, 29742, 29779, 29815, 29851, 29887, 29923, 29959, 29994, 30029, 30064,
+    30099, 30134, 30168, 30203, 30237, 30270, 30304, 30337, 30371, 30404, 30436, 30469,
+    30501, 30534, 30566, 30597, 30629, 30660, 30691, 30722, 30753, 30784, 30814, 30844,
+    30874, 30903, 30933, 30962, 30991, 31020, 31048, 31077, 31105, 31133, 31160, 31188,
+    31215, 31242, 31269, 31296, 31322, 31348, 31374, 31400, 31425, 31450, 31475, 31500,
+    31525, 31549, 31573, 31597, 31621, 31644, 31667, 31690, 31713, 31735, 31758, 31780,
+    31802, 31823, 31844, 31866, 31886, 31907, 31927, 31948, 31967, 31987, 32007, 32026,
+    32045, 32063, 32082, 32100, 32118, 32136, 32154, 32171, 32188, 32205, 32221, 32238,
+    32254, 32269, 32285, 32300, 32316, 32330, 32345, 32359, 32374, 32387, 32401, 32414,
+    32428, 32441, 32453, 32466, 32478, 32490, 32501, 32513, 32524, 32535, 32546, 32556,
+    32566, 32576, 32586, 32595, 32604, 32613, 32622, 32631, 32639, 32647, 32654, 32662,
+    32669, 32676, 32683, 32689, 32695, 32701, 32707, 32712, 32717, 32722, 32727, 32731,
+    32736, 32740, 32743, 32747, 32750, 32753, 32755, 32758, 32760, 32762, 32763, 32765,
+    32766, 32767, 32767, 32767, 32767,
+};
@@ -0,0 +1,72 @@
+"""
+Generates fft_tables.c: the constant tables used by fft_q15.c.
+
+- fft_sin_q15: a quarter wave of sin(2*pi*k/FFT_MAX_N) for k = 0 .. FFT_MAX_N/4, in Q15.
+  Every twiddle factor and window for N <= FFT_MAX_N is read from this range.
+- fft_bitrev: bit-reversed index for FFT_MAX_N points. For a smaller N = FFT_MAX_N >> s the
+  reversed index is fft_bitrev[i] >> s.
+- fft_window_*: the first half (FFT_MAX_N/2 + 1 points) of the periodic Hann, Hamming and
+  Blackman windows, in Q15. Windows for smaller N are read with a stride.
+
+Usage:
+    python gen_fft_tables.py > fft_tables.c
+"""
+
+import math
+
+FFT_MAX_N = 2048
+LOG2_MAX_N = 11
+
+
+def q15(x):
+    return max(-32768, min(32767, int(round(x * 32768))))
+
+
+def table(ctype, name, values, per_line=12):
+    lines = [f"const {ctype} {name}[{len(values)}] = {{"]
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def bitrev(i, bits):
+    r = 0
+    for _ in range(bits):
+        r = (r << 1) | (i & 1)
+        i >>= 1
+    return r
+
+
+def main():
+    n = FFT_MAX_N
+    half = n // 2 + 1
+    sin_q = [q15(math.sin(2 * math.pi * k / n)) for k in range(n // 4 + 1)]
+    rev = [bitrev(i, LOG2_MAX_N) for i in range(n)]
+    hann = [q15(0.5 - 0.5 * math.cos(2 * math.pi * k / n)) for k in range(half)]
+    hamming = [q15(0.54 - 0.46 * math.cos(2 * math.pi * k / n)) for k in range(half)]
+    blackman = [q15(0.42 - 0.5 * math.cos(2 * math.pi * k / n) + 0.08 * math.cos(4 * math.pi * k / n))
+                for k in range(half)]
+
+    print("/**")
+    print(" * @file fft_tables.c")
+    print(" * @brief Constant twiddle, bit-reversal and window tables for fft_q15.c.")
+    print(" *")
+    print(" * Generated by gen_fft_tables.py, do not edit by hand.")
+    print(" */")
+    print()
+    print('#include "fft_q15.h"')
+    print()
+    print(table("q15_t", "fft_sin_q15", sin_q))
+    print()
+    print(table("uint16_t", "fft_bitrev", rev, 16))
+    print()
+    print(table("q15_t", "fft_window_hann", hann))
+    print()
+    print(table("q15_t", "fft_window_hamming", hamming))
+    print()
+    print(table("q15_t", "fft_window_blackman", blackman))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,259 @@
+/**
+ * @file test_fft_q15.c
+ * @brief Accuracy of the Q15 FFT against a double-precision DFT, and its helpers.
+ *
+ * @details
+ * For every length from 4 to FFT_Q15_MAX_N the transform of three inputs (real noise,
+ * complex noise and a two-tone real signal) is compared with X[k] / N computed in double
+ * precision straight from the DFT sum, and the signal-to-error ratio over all bins and the
+ * largest error of a single bin must stay within the limits in `limits`. The limits are
+ * the measured figures less about 3 dB and plus about 50 % of the error, so a change to the
+ * scaling or rounding of the butterflies that costs accuracy fails the test.
+ *
+ * The known-answer checks cover a sine landing in its bin at half its amplitude, the
+ * magnitude and peak search on that spectrum, the window tables against their formulas,
+ * and the lengths the transform rejects.
+ */
+
+#include <math.h>
+#include "fft_q15.h"
+#include "host_test.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_N FFT_Q15_MAX_N
+
+typedef struct accuracy
+{
+    double snr_db;    ///< Signal power over error power, all bins.
+    double max_error; ///< Largest |X - reference| of one bin, in Q15 LSB.
+} accuracy_t;
+
+typedef enum input_kind
+{
+    INPUT_REAL_NOISE = 0,
+    INPUT_COMPLEX_NOISE,
+    INPUT_TWO_TONES,
+    INPUT_KINDS,
+} input_kind_t;
+
+/**
+ * @brief Worst accepted figures per log2(N), for each input kind.
+ */
+static const struct
+{
+    double min_snr_db;
+    double max_error;
+} limits[FFT_Q15_LOG2_MAX_N + 1][INPUT_KINDS] = {
+    // log2(N): {real noise}, {complex noise}, {two tones}
+    [2] = {{71, 2.0}, {75, 2.0}, {76, 2.0}},
+    [3] = {{68, 2.5}, {71, 2.5}, {74, 2.5}},
+    [4] = {{66, 2.5}, {67, 3.0}, {70, 2.5}},
+    [5] = {{60, 4.0}, {64, 2.5}, {67, 2.5}},
+    [6] = {{58, 3.5}, {60, 3.5}, {63, 3.5}},
+    [7] = {{55, 4.0}, {59, 4.5}, {60, 4.5}},
+    [8] = {{52, 4.5}, {55, 4.5}, {57, 5.5}},
+    [9] = {{49, 5.0}, {51, 5.0}, {54, 5.0}},
+    [10] = {{45, 5.0}, {49, 6.0}, {51, 5.5}},
+    [11] = {{43, 5.5}, {46, 6.0}, {48, 6.0}},
+};
+
+static q15_t data[2 * MAX_N];
+static q15_t input[2 * MAX_N];
+static double ref[2 * MAX_N];
+static double cos_table[MAX_N];
+static double sin_table[MAX_N];
+static uint32_t rng = 0x12345678u;
+
+static int32_t noise(int32_t amplitude)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (int32_t)(rng % (2u * (uint32_t)amplitude + 1u)) - amplitude;
+}
+
+static void make_input(input_kind_t kind, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        switch (kind)
+        {
+        case INPUT_REAL_NOISE:
+            input[2 * i] = (q15_t)noise(16384);
+            input[2 * i + 1] = 0;
+            break;
+        case INPUT_COMPLEX_NOISE:
+            input[2 * i] = (q15_t)noise(16384);
+            input[2 * i + 1] = (q15_t)noise(16384);
+            break;
+        default:
+            // A strong tone in bin N/8 and a weak one between bins, plus a little noise
+            input[2 * i] = (q15_t)lround(24000.0 * sin(2.0 * M_PI * (double)i / 8.0) +
+                                         600.0 * sin(2.0 * M_PI * (0.3 * n + 0.5) * i / n) + noise(8));
+            input[2 * i + 1] = 0;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief X[k] / n by the DFT sum, in Q15 LSB.
+ */
+static void reference_dft(size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        cos_table[i] = cos(2.0 * M_PI * i / n);
+        sin_table[i] = sin(2.0 * M_PI * i / n);
+    }
+    for (size_t k = 0; k < n; k++)
+    {
+        double re = 0.0, im = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t a = (k * i) % n;
+            double xr = input[2 * i], xi = input[2 * i + 1];
+            re += xr * cos_table[a] + xi * sin_table[a];
+            im += xi * cos_table[a] - xr * sin_table[a];
+        }
+        ref[2 * k] = re / n;
+        ref[2 * k + 1] = im / n;
+    }
+}
+
+static accuracy_t measure(input_kind_t kind, size_t n)
+{
+    make_input(kind, n);
+    reference_dft(n);
+    for (size_t i = 0; i < 2 * n; i++)
+    {
+        data[i] = input[i];
+    }
+    CHECK_EQ(fft_q15_forward(data, n), 0);
+
+    double signal = 0.0, error = 0.0;
+    accuracy_t a = {0.0, 0.0};
+    for (size_t k = 0; k < n; k++)
+    {
+        double er = data[2 * k] - ref[2 * k];
+        double ei = data[2 * k + 1] - ref[2 * k + 1];
+        double e = sqrt(er * er + ei * ei);
+        signal += ref[2 * k] * ref[2 * k] + ref[2 * k + 1] * ref[2 * k + 1];
+        error += e * e;
+        if (e > a.max_error)
+        {
+            a.max_error = e;
+        }
+    }
+    a.snr_db = 10.0 * log10(signal / error);
+    return a;
+}
+
+static void test_accuracy(void)
+{
+    for (int b = 2; b <= FFT_Q15_LOG2_MAX_N; b++)
+    {
+        size_t n = (size_t)1 << b;
+        for (int kind = 0; kind < INPUT_KINDS; kind++)
+        {
+            accuracy_t a = measure((input_kind_t)kind, n);
+            CHECK_RANGE(a.snr_db, limits[b][kind].min_snr_db, 200.0);
+            CHECK_RANGE(a.max_error, 0.0, limits[b][kind].max_error);
+        }
+    }
+}
+
+/**
+ * @brief A real sine of amplitude A in bin k shows up as A / 2 in bins k and N - k.
+ */
+static void test_sine_bin(void)
+{
+    static q15_t x[MAX_N];
+    static uint16_t mag[MAX_N / 2];
+    const size_t sizes[] = {256, 512, 1024, 2048};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        size_t n = sizes[s];
+        size_t bin = n / 16 + 3;
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = (q15_t)lround(20000.0 * cos(2.0 * M_PI * bin * i / n) + 4000.0 * cos(2.0 * M_PI * 3 * bin * i / n));
+        }
+        fft_q15_load_real(data, x, n);
+        CHECK_EQ(fft_q15_forward(data, n), 0);
+        fft_q15_magnitude(data, mag, n / 2);
+        CHECK_RANGE(mag[bin], 10000 - 3, 10000 + 3);
+        CHECK_RANGE(mag[3 * bin], 2000 - 3, 2000 + 3);
+        CHECK_RANGE(mag[0], 0, 3);
+        CHECK_RANGE(data[2 * (n - bin)], 10000 - 3, 10000 + 3); // Mirror image, real part
+
+        fft_peak_t peaks[3];
+        CHECK_EQ(fft_q15_peaks(mag, n / 2, peaks, 3), 3);
+        CHECK_EQ(peaks[0].bin, bin);
+        CHECK_EQ(peaks[1].bin, 3 * bin);
+        CHECK(peaks[2].mag <= 3);
+    }
+}
+
+static void test_windows(void)
+{
+    static q15_t x[MAX_N];
+    const size_t sizes[] = {16, 256, 2048};
+    const fft_window_t kinds[] = {FFT_WINDOW_HANN, FFT_WINDOW_HAMMING, FFT_WINDOW_BLACKMAN};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        size_t n = sizes[s];
+        for (size_t w = 0; w < 3; w++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                x[i] = 32767;
+            }
+            fft_q15_window(x, n, kinds[w]);
+            uint32_t off = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                double c = cos(2.0 * M_PI * i / n), c2 = cos(4.0 * M_PI * i / n);
+                double v = kinds[w] == FFT_WINDOW_HANN      ? 0.5 - 0.5 * c
+                           : kinds[w] == FFT_WINDOW_HAMMING ? 0.54 - 0.46 * c
+                                                            : 0.42 - 0.5 * c + 0.08 * c2;
+                if (fabs(x[i] - 32767.0 * v) > 1.5)
+                {
+                    off++;
+                }
+            }
+            CHECK_EQ(off, 0);
+        }
+    }
+
+    // The rectangular window leaves the samples alone
+    x[0] = -1234;
+    fft_q15_window(x, 16, FFT_WINDOW_RECT);
+    CHECK_EQ(x[0], -1234);
+}
+
+static void test_lengths(void)
+{
+    CHECK_EQ(fft_q15_log2(1), -1);
+    CHECK_EQ(fft_q15_log2(2), 1);
+    CHECK_EQ(fft_q15_log2(1024), 10);
+    CHECK_EQ(fft_q15_log2(MAX_N), FFT_Q15_LOG2_MAX_N);
+    CHECK_EQ(fft_q15_log2(2 * MAX_N), -1);
+    CHECK_EQ(fft_q15_log2(3), -1);
+    CHECK_EQ(fft_q15_forward(data, 3), -1);
+    CHECK_EQ(fft_q15_forward(data, 2 * MAX_N), -1);
+}
+
+int main(void)
+{
+    test_accuracy();
+    test_sine_bin();
+    test_windows();
+    test_lengths();
+    return host_test_result("test_fft_q15");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file biquad_q15.c
+ * @brief Q15 Direct Form I biquad cascade with Q14 coefficients, plus ADC <-> Q15 helpers.
+ */
+
+#include "fixed_filter.h"
+
+void biquad_cascade_q15_init(biquad_cascade_q15_t *c, const biquad_coeffs_q14_t *coeffs,
+                             biquad_state_q15_t *state, uint8_t num_stages)
+{
+    c->coeffs = coeffs;
+    c->state = state;
+    c->num_stages = num_stages;
+
+    for (uint8_t s = 0; s < num_stages; s++)
+    {
+        state[s].x1 = state[s].x2 = 0;
+        state[s].y1 = state[s].y2 = 0;
+    }
+}
+
+void biquad_cascade_q15_process(biquad_cascade_q15_t *c, const q15_t *in, q15_t *out, size_t n)
+{
+    const q15_t *src = in;
+
+    // Run the whole block through one section at a time so the coefficients and
+    // state stay in registers for the inner loop.
+    for (uint8_t s = 0; s < c->num_stages; s++)
+    {
+        const biquad_coeffs_q14_t *k = &c->coeffs[s];
+        int32_t b0 = k->b0, b1 = k->b1, b2 = k->b2;
+        int32_t a1 = k->a1, a2 = k->a2;
+        int32_t x1 = c->state[s].x1, x2 = c->state[s].x2;
+        int32_t y1 = c->state[s].y1, y2 = c->state[s].y2;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            int32_t x0 = src[i];
+
+            // 32-bit products, 64-bit sum: Q14 * Q15 = Q29.
+            int64_t acc = (int64_t)(1 << 13); // Rounding for the final >> 14
+            acc += b0 * x0;
+            acc += b1 * x1;
+            acc += b2 * x2;
+            acc -= a1 * y1;
+            acc -= a2 * y2;
+
+            int64_t y = acc >> 14;
+            int32_t y0 = (y > 32767) ? 32767 : (y < -32768) ? -32768 : (int32_t)y;
+
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            out[i] = (q15_t)y0;
+        }
+
+        c->state[s].x1 = (q15_t)x1;
+        c->state[s].x2 = (q15_t)x2;
+        c->state[s].y1 = (q15_t)y1;
+        c->state[s].y2 = (q15_t)y2;
+        src = out; // Later sections work on the previous section's output
+    }
+}
+
+void q15_from_adc12(const uint16_t *in, q15_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = (q15_t)(((int32_t)in[i] - 2048) * 16);
+    }
+}
+
+void q15_to_adc12(const q15_t *in, uint16_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        int32_t v = (((int32_t)in[i] + 8) >> 4) + 2048;
+        if (v < 0)
+        {
+            v = 0;
+        }
+        else if (v > 4095)
+        {
+            v = 4095;
+        }
+        out[i] = (uint16_t)v;
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file cic_decim.c
+ * @brief 4th-order CIC decimator and the oversampling stage built on it.
+ */
+
+#include <string.h>
+#include "fixed_filter.h"
+
+bool cic_decim_init(cic_decim_t *c, uint16_t factor)
+{
+    if (factor < CIC_MIN_FACTOR || factor > CIC_MAX_FACTOR)
+    {
+        return false;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->factor = factor;
+
+    // The gain is R^4, at most 2^32. With b = ceil(log2(R^4)), y < 4096 * 2^b, so shifting
+    // it by b - 20 leaves at most 32 bits, and scale = 16 * 2^(32 + shift) / R^4 < 2^17
+    // turns it into ADC code * 16 in the upper word of the product.
+    uint64_t gain = (uint64_t)factor * factor * factor * factor;
+    uint8_t bits = 0;
+    while (((uint64_t)1 << bits) < gain)
+    {
+        bits++;
+    }
+    c->shift = (bits > 20) ? (uint8_t)(bits - 20) : 0;
+    c->scale = (uint32_t)((((uint64_t)1 << (36 + c->shift)) + gain / 2) / gain);
+    return true;
+}
+
+/**
+ * @brief Runs the combs on the last integrator output and scales the result to 16 bits.
+ */
+static inline uint16_t cic_output(cic_decim_t *c, uint64_t y)
+{
+    for (uint32_t s = 0; s < CIC_ORDER; s++)
+    {
+        uint64_t d = y - c->comb[s];
+        c->comb[s] = y;
+        y = d;
+    }
+
+    uint64_t v = ((uint64_t)(uint32_t)(y >> c->shift) * c->scale + 0x80000000u) >> 32;
+    return (v > 0xFFFFu) ? 0xFFFFu : (uint16_t)v;
+}
+
+size_t cic_decim_process(cic_decim_t *c, const uint16_t *in, uint16_t *out, size_t n)
+{
+    uint64_t i0 = c->integ[0];
+    uint64_t i1 = c->integ[1];
+    uint64_t i2 = c->integ[2];
+    uint64_t i3 = c->integ[3];
+    size_t produced = 0;
+
+    while (n > 0)
+    {
+        // Integrate up to the next output without testing the phase per sample.
+        size_t run = (size_t)(c->factor - c->phase);
+        if (run > n)
+        {
+            run = n;
+        }
+        for (size_t i = 0; i < run; i++)
+        {
+            i0 += in[i];
+            i1 += i0;
+            i2 += i1;
+            i3 += i2;
+        }
+        in += run;
+        n -= run;
+
+        c->phase = (uint16_t)(c->phase + run);
+        if (c->phase == c->factor)
+        {
+            c->phase = 0;
+            out[produced++] = cic_output(c, i3);
+        }
+    }
+
+    c->integ[0] = i0;
+    c->integ[1] = i1;
+    c->integ[2] = i2;
+    c->integ[3] = i3;
+    return produced;
+}
+
+bool oversample_init(oversample_t *os, uint16_t factor, const q15_t *comp_taps, uint16_t num_taps, q15_t *state)
+{
+    fir_q15_init(&os->comp, comp_taps, num_taps, state);
+    return cic_decim_init(&os->cic, factor);
+}
+
+size_t oversample_process(oversample_t *os, const uint16_t *in, uint16_t *out, size_t n)
+{
+    size_t m = cic_decim_process(&os->cic, in, out, n);
+
+    // Flipping the top bit maps 0 .. 65535 to Q15 -1.0 .. +1.0 and back, in place.
+    q15_t *q = (q15_t *)out;
+    for (size_t i = 0; i < m; i++)
+    {
+        q[i] = (q15_t)(out[i] ^ 0x8000u);
+    }
+    fir_q15_process(&os->comp, q, q, m);
+    for (size_t i = 0; i < m; i++)
+    {
+        out[i] = (uint16_t)q[i] ^ 0x8000u;
+    }
+    return m;
+}
@@ -0,0 +1,74 @@
+"""
+Designs filters with scipy and prints them as C tables for fixed_filter.h.
+
+FIR taps are printed as Q15 and biquad sections as Q14, ready to paste into a project.
+The quantized responses are compared against the floating-point design so you can see how
+much the fixed-point rounding costs.
+
+Usage:
+    python design_filters.py fir <fs> <cutoff> <taps> [name]
+    python design_filters.py biquad <fs> <cutoff> <order> [name]
+
+Examples:
+    python design_filters.py fir 5000 1000 31 lowpass_taps
+    python design_filters.py biquad 100 5 2 smoothing_sos
+"""
+
+import sys
+import numpy as np
+from scipy import signal
+
+
+def to_fixed(values, frac_bits):
+    """Rounds to a signed 16-bit fixed-point integer with frac_bits fractional bits."""
+    scaled = np.round(np.asarray(values) * (1 << frac_bits))
+    return np.clip(scaled, -32768, 32767).astype(int)
+
+
+def print_array(ctype, name, values, per_line=8):
+    print(f"static const {ctype} {name}[{len(values)}] = {{")
+    for i in range(0, len(values), per_line):
+        print("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    print("};")
+
+
+def design_fir(fs, cutoff, taps, name='fir_taps'):
+    h = signal.firwin(taps, cutoff, fs=fs, window='hamming')
+    q = to_fixed(h, 15)
+    if np.sum(np.abs(q)) >= 2 * 32768:
+        print("// Warning: sum(|h|) >= 2, the 32-bit accumulator can overflow; scale the taps down")
+    w, resp = signal.freqz(h, worN=2048, fs=fs)
+    _, resp_q = signal.freqz(q / 32768.0, worN=2048, fs=fs)
+    err = np.max(np.abs(20 * np.log10(np.abs(resp_q) + 1e-12) - 20 * np.log10(np.abs(resp) + 1e-12))[w < cutoff])
+    print(f"// {taps}-tap Hamming low-pass, fs = {fs} Hz, cutoff = {cutoff} Hz, passband error {err:.3f} dB")
+    print_array("q15_t", name, q)
+
+
+def design_biquad(fs, cutoff, order, name='biquad_sos'):
+    sos = signal.butter(order, cutoff, fs=fs, output='sos')
+    print(f"// Butterworth low-pass, order {order}, fs = {fs} Hz, cutoff = {cutoff} Hz")
+    print(f"static const biquad_coeffs_q14_t {name}[{len(sos)}] = {{")
+    for b0, b1, b2, _, a1, a2 in sos:
+        q = to_fixed([b0, b1, b2, a1, a2], 14)
+        print("    {.b0 = %d, .b1 = %d, .b2 = %d, .a1 = %d, .a2 = %d}," % tuple(q))
+    print("};")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 5:
+        print(__doc__)
+        sys.exit(1)
+
+    kind = sys.argv[1]
+    fs = float(sys.argv[2])
+    cutoff = float(sys.argv[3])
+    n = int(sys.argv[4])
+    name = sys.argv[5] if len(sys.argv) > 5 else None
+
+    if kind == 'fir':
+        design_fir(fs, cutoff, n, *([name] if name else []))
+    elif kind == 'biquad':
+        design_biquad(fs, cutoff, n, *([name] if name else []))
+    else:
+        print(__doc__)
+        sys.exit(1)
@@ -0,0 +1,103 @@
+/**
+ * @file fir_q15.c
+ * @brief Q15 direct-form FIR and decimating FIR with a double-length delay line.
+ */
+
+#include <string.h>
+#include "fixed_filter.h"
+
+void fir_q15_init(fir_q15_t *f, const q15_t *coeffs, uint16_t num_taps, q15_t *state)
+{
+    f->coeffs = coeffs;
+    f->state = state;
+    f->num_taps = num_taps;
+    f->pos = 0;
+    memset(state, 0, 2u * num_taps * sizeof(q15_t));
+}
+
+/**
+ * @brief Pushes one sample into the delay line.
+ *
+ * The sample is stored at pos and pos + N, then pos moves one step back, so
+ * state[pos .. pos + N - 1] always holds x[n], x[n-1], ..., x[n-N+1].
+ */
+static inline const q15_t *fir_push(fir_q15_t *f, q15_t x)
+{
+    uint16_t n = f->num_taps;
+    uint16_t pos = (f->pos == 0) ? (uint16_t)(n - 1) : (uint16_t)(f->pos - 1);
+
+    f->state[pos] = x;
+    f->state[pos + n] = x;
+    f->pos = pos;
+    return &f->state[pos];
+}
+
+/**
+ * @brief Dot product of the coefficients with the contiguous history window.
+ */
+static inline q15_t fir_dot(const q15_t *h, const q15_t *x, uint16_t num_taps)
+{
+    int32_t acc = 1 << 14; // Rounding for the final >> 15
+    uint16_t k = num_taps >> 2;
+
+    // Unrolled by four: each MAC is a load pair, one MULS and one ADDS on the M0+.
+    while (k--)
+    {
+        acc += (int32_t)h[0] * x[0];
+        acc += (int32_t)h[1] * x[1];
+        acc += (int32_t)h[2] * x[2];
+        acc += (int32_t)h[3] * x[3];
+        h += 4;
+        x += 4;
+    }
+
+    k = num_taps & 3u;
+    while (k--)
+    {
+        acc += (int32_t)(*h++) * (*x++);
+    }
+
+    return q15_sat(acc >> 15);
+}
+
+void fir_q15_process(fir_q15_t *f, const q15_t *in, q15_t *out, size_t n)
+{
+    const q15_t *h = f->coeffs;
+    uint16_t taps = f->num_taps;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const q15_t *x = fir_push(f, in[i]);
+        out[i] = fir_dot(h, x, taps);
+    }
+}
+
+void fir_decim_q15_init(fir_decim_q15_t *d, const q15_t *coeffs, uint16_t num_taps, uint16_t factor, q15_t *state)
+{
+    fir_q15_init(&d->fir, coeffs, num_taps, state);
+    d->factor = factor ? factor : 1;
+    d->phase = 0;
+}
+
+size_t fir_decim_q15_process(fir_decim_q15_t *d, const q15_t *in, q15_t *out, size_t n)
+{
+    const q15_t *h = d->fir.coeffs;
+    uint16_t taps = d->fir.num_taps;
+    uint16_t phase = d->phase;
+    size_t produced = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const q15_t *x = fir_push(&d->fir, in[i]);
+
+        // Only every factor-th output is needed, so the others are never computed.
+        if (++phase == d->factor)
+        {
+            phase = 0;
+            out[produced++] = fir_dot(h, x, taps);
+        }
+    }
+
+    d->phase = phase;
+    return produced;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file fixed_filter.h
+ * @brief Fixed-point block filters for the Cortex-M0+: FIR, decimating FIR, biquad cascade and
+ *        CIC oversampling decimator.
+ *
+ * @details
+ * Samples and FIR coefficients are Q15 (`int16_t`, 1.0 = 32768). Products are formed with the
+ * M0+'s single-cycle 32-bit multiplier and accumulated at Q30/Q31 precision, then rounded and
+ * saturated back to Q15 once per output sample. Nothing uses floating point, since the RP2040
+ * has no FPU. It has no 64-bit multiplier either, so the only 64-bit multiply is the one per
+ * CIC output below (a short library routine); the FIR and biquad loops multiply in 32 bits.
+ *
+ * - The FIR keeps its history in a double-length delay line: each new sample is written twice,
+ *   N entries apart, so the last N samples are always contiguous and the inner loop needs no
+ *   modulo or wrap test. The loop is unrolled by four.
+ * - FIR accumulation is 32-bit, which is exact as long as sum(|h|) < 2. Any unity-gain
+ *   low-pass meets this; scale the coefficients down otherwise.
+ * - Biquads are Direct Form I with Q14 coefficients (so |a1| up to 2 can be represented) and a
+ *   64-bit accumulator. Only the additions are 64-bit; every product is a 32-bit multiply.
+ * - The CIC decimator has four integrator and four comb stages on 64-bit registers that wrap,
+ *   so the 12 + 4 * log2(R) bits of growth (44 at R = 256) never lose a bit; an add is an
+ *   ADDS/ADCS pair on the M0+. The integrators run in a branch-free inner loop between two
+ *   outputs. Each output is scaled to 16 bits (ADC code * 16) with one 32x32 -> 64 multiply.
+ *   oversample_process() follows it with a Q15 FIR that flattens the sinc^4 droop of the CIC
+ *   (taps generated by libs/build_config), so averaging R conversions gains up to
+ *   log2(R) / 2 bits of resolution when the input carries about an LSB of noise.
+ *
+ * Helpers convert between 12-bit unsigned ADC codes and Q15. This file has no dependency on the
+ * Pico SDK.
+ */
+
+#ifndef FIXED_FILTER_H
+#define FIXED_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef int16_t q15_t; ///< Signed Q1.15 value.
+
+/** Converts a floating-point constant to Q15 at compile time (for coefficient tables). */
+#define Q15(x) ((q15_t)((x) >= 0.999969482421875 ? 32767 : (x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/** Converts a floating-point constant to Q14 at compile time (for biquad coefficients). */
+#define Q14(x) ((q15_t)((x) * 16384.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/**
+ * @brief Saturates a 32-bit value to the Q15 range.
+ */
+static inline q15_t q15_sat(int32_t x)
+{
+    if (x > 32767)
+    {
+        return 32767;
+    }
+    if (x < -32768)
+    {
+        return -32768;
+    }
+    return (q15_t)x;
+}
+
+// ---------------------------------------------------------------------------
+// FIR
+// ---------------------------------------------------------------------------
+
+typedef struct fir_q15
+{
+    const q15_t *coeffs; ///< h[0] .. h[num_taps - 1].
+    q15_t *state;        ///< Delay line of 2 * num_taps samples.
+    uint16_t num_taps;   ///< Filter length.
+    uint16_t pos;        ///< Index of the newest sample in the delay line.
+} fir_q15_t;
+
+/**
+ * @brief Initializes an FIR filter and clears its history.
+ *
+ * @param f Pointer to the filter.
+ * @param coeffs Q15 coefficients, num_taps entries.
+ * @param num_taps Filter length.
+ * @param state Delay line storage of 2 * num_taps samples.
+ */
+void fir_q15_init(fir_q15_t *f, const q15_t *coeffs, uint16_t num_taps, q15_t *state);
+
+/**
+ * @brief Filters a block of samples. In-place operation (in == out) is allowed.
+ *
+ * @param f Pointer to the filter.
+ * @param in Input samples.
+ * @param out Output samples, n entries.
+ * @param n Number of samples.
+ */
+void fir_q15_process(fir_q15_t *f, const q15_t *in, q15_t *out, size_t n);
+
+// ---------------------------------------------------------------------------
+// Decimating FIR
+// ---------------------------------------------------------------------------
+
+typedef struct fir_decim_q15
+{
+    fir_q15_t fir;   ///< Underlying FIR (coefficients and delay line).
+    uint16_t factor; ///< Decimation factor M.
+    uint16_t phase;  ///< Input samples since the last output.
+} fir_decim_q15_t;
+
+/**
+ * @brief Initializes a decimating FIR that keeps one output every `factor` inputs.
+ *
+ * The coefficients must already band-limit the signal to fs / (2 * factor).
+ *
+ * @param d Pointer to the decimator.
+ * @param coeffs Q15 coefficients, num_taps entries.
+ * @param num_taps Filter length.
+ * @param factor Decimation factor (>= 1).
+ * @param state Delay line storage of 2 * num_taps samples.
+ */
+void fir_decim_q15_init(fir_decim_q15_t *d, const q15_t *coeffs, uint16_t num_taps, uint16_t factor, q15_t *state);
+
+/**
+ * @brief Feeds a block of input samples and writes the decimated outputs.
+ *
+ * Only the outputs that are kept are computed; the other inputs just enter the delay line.
+ * The block length does not need to be a multiple of the factor. In-place operation is allowed.
+ *
+ * @param d Pointer to the decimator.
+ * @param in Input samples.
+ * @param out Output samples, at most n / factor + 1 entries.
+ * @param n Number of input samples.
+ * @return size_t Number of output samples written.
+ */
+size_t fir_decim_q15_process(fir_decim_q15_t *d, const q15_t *in, q15_t *out, size_t n);
+
+// ---------------------------------------------------------------------------
+// Biquad cascade
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Coefficients of one biquad section, Q14.
+ *
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]   (a0 normalized to 1)
+ */
+typedef struct biquad_coeffs_q14
+{
+    q15_t b0, b1, b2; ///< Feed-forward coefficients.
+    q15_t a1, a2;     ///< Feedback coefficients, same sign convention as scipy.signal.
+} biquad_coeffs_q14_t;
+
+typedef struct biquad_state_q15
+{
+    q15_t x1, x2; ///< Previous two inputs.
+    q15_t y1, y2; ///< Previous two outputs.
+} biquad_state_q15_t;
+
+typedef struct biquad_cascade_q15
+{
+    const biquad_coeffs_q14_t *coeffs; ///< One entry per section.
+    biquad_state_q15_t *state;         ///< One entry per section.
+    uint8_t num_stages;                ///< Number of second-order sections.
+} biquad_cascade_q15_t;
+
+/**
+ * @brief Initializes a biquad cascade and clears its state.
+ *
+ * @param c Pointer to the cascade.
+ * @param coeffs Coefficients, num_stages entries.
+ * @param state State storage, num_stages entries.
+ * @param num_stages Number of sections.
+ */
+void biquad_cascade_q15_init(biquad_cascade_q15_t *c, const biquad_coeffs_q14_t *coeffs,
+                             biquad_state_q15_t *state, uint8_t num_stages);
+
+/**
+ * @brief Filters a block through every section. In-place operation is allowed.
+ *
+ * @param c Pointer to the cascade.
+ * @param in Input samples.
+ * @param out Output samples, n entries.
+ * @param n Number of samples.
+ */
+void biquad_cascade_q15_process(biquad_cascade_q15_t *c, const q15_t *in, q15_t *out, size_t n);
+
+// ---------------------------------------------------------------------------
+// CIC oversampling decimator
+// ---------------------------------------------------------------------------
+
+#define CIC_ORDER 4u          ///< Integrator and comb stages.
+#define CIC_MIN_FACTOR 4u     ///< Smallest decimation factor.
+#define CIC_MAX_FACTOR 256u   ///< Largest decimation factor (44-bit growth from 12-bit input).
+#define CIC_FULL_SCALE 65520u ///< Output for a constant input of 4095 (ADC code * 16).
+
+typedef struct cic_decim
+{
+    uint64_t integ[CIC_ORDER]; ///< Integrator registers, modulo 2^64.
+    uint64_t comb[CIC_ORDER];  ///< Previous input of each comb stage.
+    uint32_t scale;            ///< Output = ((y >> shift) * scale) >> 32.
+    uint16_t factor;           ///< Decimation factor R.
+    uint16_t phase;            ///< Input samples since the last output.
+    uint8_t shift;             ///< See scale.
+} cic_decim_t;
+
+/**
+ * @brief Initializes a 4th-order CIC decimator and clears its history.
+ *
+ * @param c Pointer to the decimator.
+ * @param factor Decimation factor R, CIC_MIN_FACTOR to CIC_MAX_FACTOR.
+ * @return bool false if the factor is out of range.
+ */
+bool cic_decim_init(cic_decim_t *c, uint16_t factor);
+
+/**
+ * @brief Feeds 12-bit ADC codes and writes one output every `factor` inputs.
+ *
+ * Outputs are unsigned 16-bit, scaled so that a constant ADC code a gives 16 * a. The block
+ * length does not need to be a multiple of the factor.
+ *
+ * @param c Pointer to the decimator.
+ * @param in ADC codes (0 .. 4095).
+ * @param out Outputs, at most n / factor + 1 entries.
+ * @param n Number of input samples.
+ * @return size_t Number of outputs written.
+ */
+size_t cic_decim_process(cic_decim_t *c, const uint16_t *in, uint16_t *out, size_t n);
+
+typedef struct oversample
+{
+    cic_decim_t cic; ///< Decimator.
+    fir_q15_t comp;  ///< Droop compensation at the output rate.
+} oversample_t;
+
+/**
+ * @brief Initializes a CIC decimator followed by a compensation FIR.
+ *
+ * @param os Pointer to the stage.
+ * @param factor Decimation factor, CIC_MIN_FACTOR to CIC_MAX_FACTOR.
+ * @param comp_taps Q15 compensation taps designed for this factor (e.g. cfg_cic_comp_taps).
+ * @param num_taps Number of compensation taps.
+ * @param state Delay line storage of 2 * num_taps samples.
+ * @return bool false if the factor is out of range.
+ */
+bool oversample_init(oversample_t *os, uint16_t factor, const q15_t *comp_taps, uint16_t num_taps, q15_t *state);
+
+/**
+ * @brief Decimates ADC codes to compensated 16-bit samples (ADC code * 16 at DC).
+ *
+ * @param os Pointer to the stage.
+ * @param in ADC codes (0 .. 4095).
+ * @param out Outputs, at most n / factor + 1 entries.
+ * @param n Number of input samples.
+ * @return size_t Number of outputs written.
+ */
+size_t oversample_process(oversample_t *os, const uint16_t *in, uint16_t *out, size_t n);
+
+// ---------------------------------------------------------------------------
+// ADC conversion
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Converts 12-bit unsigned ADC codes to Q15 centered on mid-scale.
+ *
+ * 0 -> -1.0, 2048 -> 0, 4095 -> just below +1.0. The output may alias the input buffer
+ * (same element size).
+ */
+void q15_from_adc12(const uint16_t *in, q15_t *out, size_t n);
+
+/**
+ * @brief Converts Q15 back to 12-bit unsigned ADC codes, rounding and clamping to 0..4095.
+ *
+ * The output may alias the input buffer.
+ */
+void q15_to_adc12(const q15_t *in, uint16_t *out, size_t n);
+
+#endif // FIXED_FILTER_H
@@ -0,0 +1,188 @@
+"""
+Generates golden_vectors.h, the bit-exact expected outputs of the fixed_filter tests.
+
+The input is the signal of DSP/DSP_pract1/practica1/test_simu.py, a 2 V sine at 500 Hz
+sampled every 180 us, put on the 3.3 V ADC scale around mid-scale, with a little uniform
+noise from a fixed LCG and a full-scale square burst at the end to drive the filters into
+saturation. The filters are designed with libs/build_config/gen_config.py, as the projects
+get them, and the expected outputs come from an integer model of the arithmetic documented
+in fixed_filter.h (round half up, arithmetic shifts, saturation to Q15), so a vector only
+changes if the documented behaviour changes. The model uses plain Python integers, which are
+exact, and gives the same result as the equivalent NumPy int64 code.
+
+Usage (from this folder):
+    python3 gen_golden.py > golden_vectors.h
+"""
+
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', '..', 'build_config'))
+import gen_config  # noqa: E402
+
+F0 = 500.0         # test_simu.py: f0
+TS = 0.000180      # test_simu.py: Ts
+AMPLITUDE_V = 2.0  # test_simu.py: Xa(t) = 2 sin(2 pi f0 t)
+VREF_V = 3.3
+N = 512
+SQUARE_FROM = 448  # Full-scale square wave from here on, 16 samples per half period
+
+FIR_TAPS = 31
+FIR_CUTOFF = 1000
+DECIM_FACTOR = 4
+BIQUAD_CUTOFFS = (500, 1000)
+CIC_FACTORS = (4, 16, 50)
+CIC_OUTPUTS = 64
+COMP_FACTOR = 50
+COMP_TAPS = 15
+
+
+class Lcg:
+    """Numerical Recipes LCG, so the noise does not depend on the Python version."""
+
+    def __init__(self, seed):
+        self.x = seed
+
+    def next(self, span):
+        self.x = (self.x * 1664525 + 1013904223) & 0xFFFFFFFF
+        return (self.x >> 16) % (2 * span + 1) - span
+
+
+def sat15(v):
+    return max(-32768, min(32767, v))
+
+
+def q15_input():
+    rng = Lcg(1)
+    x = []
+    for n in range(N):
+        if n >= SQUARE_FROM:
+            x.append(32767 if (n // 16) % 2 == 0 else -32768)
+            continue
+        v = AMPLITUDE_V / VREF_V * math.sin(2 * math.pi * F0 * n * TS)
+        x.append(sat15(round(v * 32768) + rng.next(64)))
+    return x
+
+
+def adc_input(r):
+    """R conversions per test_simu.py sample, clipped to 12 bits, then a 0/4095 square."""
+    rng = Lcg(2)
+    codes = []
+    total = r * CIC_OUTPUTS
+    for k in range(total):
+        if k >= total * 3 // 4:
+            codes.append(4095 if (k // (2 * r)) % 2 == 0 else 0)
+            continue
+        v = 2048 + AMPLITUDE_V / VREF_V * 2048 * math.sin(2 * math.pi * F0 * k * TS / r)
+        codes.append(max(0, min(4095, round(v) + rng.next(2))))
+    return codes
+
+
+def fir(h, x):
+    hist = [0] * len(h)
+    y = []
+    for v in x:
+        hist = [v] + hist[:-1]
+        y.append(sat15(((1 << 14) + sum(a * b for a, b in zip(h, hist))) >> 15))
+    return y
+
+
+def biquad_cascade(sections, x):
+    for b0, b1, b2, a1, a2 in sections:
+        x1 = x2 = y1 = y2 = 0
+        y = []
+        for x0 in x:
+            acc = (1 << 13) + b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2
+            y0 = sat15(acc >> 14)
+            x2, x1, y2, y1 = x1, x0, y1, y0
+            y.append(y0)
+        x = y
+    return x
+
+
+def cic(r, codes):
+    """Exact 4th-order CIC: the sum of the last 4(R-1)+1 inputs weighted by the sinc^4 kernel."""
+    kernel = [1]
+    for _ in range(gen_config.CIC_ORDER):
+        kernel = [sum(kernel[i - j] for j in range(r) if 0 <= i - j < len(kernel)) for i in range(len(kernel) + r - 1)]
+    gain = r ** gen_config.CIC_ORDER
+    bits = (gain - 1).bit_length()
+    shift = max(bits - 20, 0)
+    scale = ((1 << (36 + shift)) + gain // 2) // gain
+    out = []
+    for m in range(1, len(codes) // r + 1):
+        end = m * r  # Output m is taken after input end - 1
+        y = sum(kernel[i] * codes[end - 1 - i] for i in range(len(kernel)) if end - 1 - i >= 0)
+        out.append(min(0xFFFF, ((y >> shift) * scale + (1 << 31)) >> 32))
+    return out
+
+
+def oversample(r, taps, codes):
+    y = [v ^ 0x8000 for v in cic(r, codes)]
+    y = [v - 65536 if v >= 32768 else v for v in y]
+    return [(v & 0xFFFF) ^ 0x8000 for v in fir(taps, y)]
+
+
+def c_array(ctype, name, values, per_line=12):
+    lines = ['static const %s %s[%d] = {' % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    lines.append('};')
+    return lines
+
+
+def main():
+    fs = 1.0 / TS
+    x = q15_input()
+    fir_taps = gen_config.quantize(gen_config.design_fir(fs, FIR_CUTOFF, FIR_TAPS), 15)
+    decim_taps = gen_config.quantize(gen_config.design_fir(fs, fs / (2 * DECIM_FACTOR), FIR_TAPS), 15)
+    sos = [gen_config.quantize(gen_config.design_biquad(fs, fc), 14) for fc in BIQUAD_CUTOFFS]
+    # DC gain 1.5 on a full-scale input: the FIR output saturates
+    gain_taps = [16384, 16384, 16384]
+    comp_taps = gen_config.quantize(gen_config.design_cic_comp(COMP_FACTOR, COMP_TAPS), 15)
+
+    out = ['/**',
+           ' * @file golden_vectors.h',
+           ' * @brief Expected outputs of the fixed_filter tests.',
+           ' *',
+           ' * @details',
+           ' * Generated by gen_golden.py. Do not edit: change the generator and run it again.',
+           ' */',
+           '',
+           '#ifndef GOLDEN_VECTORS_H',
+           '#define GOLDEN_VECTORS_H',
+           '',
+           '#include <stdint.h>',
+           '#include "fixed_filter.h"',
+           '',
+           '#define GOLDEN_N %du ///< Q15 input samples.' % N,
+           '#define GOLDEN_DECIM_FACTOR %du ///< Decimation factor of golden_decim_out.' % DECIM_FACTOR,
+           '#define GOLDEN_CIC_OUTPUTS %du ///< Outputs of each CIC vector.' % CIC_OUTPUTS,
+           '#define GOLDEN_COMP_FACTOR %du ///< CIC factor of golden_oversample_out.' % COMP_FACTOR,
+           '']
+    out += c_array('q15_t', 'golden_in', x) + ['']
+    out += c_array('q15_t', 'golden_fir_taps', fir_taps) + ['']
+    out += c_array('q15_t', 'golden_fir_out', fir(fir_taps, x)) + ['']
+    out += c_array('q15_t', 'golden_gain_taps', gain_taps) + ['']
+    out += c_array('q15_t', 'golden_gain_out', fir(gain_taps, x)) + ['']
+    out += c_array('q15_t', 'golden_decim_taps', decim_taps) + ['']
+    decim = fir(decim_taps, x)[DECIM_FACTOR - 1::DECIM_FACTOR]
+    out += c_array('q15_t', 'golden_decim_out', decim) + ['']
+    out += ['static const biquad_coeffs_q14_t golden_sos[%d] = {' % len(sos)]
+    for b0, b1, b2, a1, a2 in sos:
+        out.append('    {.b0 = %d, .b1 = %d, .b2 = %d, .a1 = %d, .a2 = %d},' % (b0, b1, b2, a1, a2))
+    out += ['};', '']
+    out += c_array('q15_t', 'golden_biquad_out', biquad_cascade(sos, x)) + ['']
+    for r in CIC_FACTORS:
+        codes = adc_input(r)
+        out += c_array('uint16_t', 'golden_cic%d_in' % r, codes, 16) + ['']
+        out += c_array('uint16_t', 'golden_cic%d_out' % r, cic(r, codes)) + ['']
+    out += c_array('q15_t', 'golden_comp_taps', comp_taps) + ['']
+    out += c_array('uint16_t', 'golden_oversample_out', oversample(COMP_FACTOR, comp_taps, adc_input(COMP_FACTOR))) + ['']
+    out += ['#endif // GOLDEN_VECTORS_H']
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
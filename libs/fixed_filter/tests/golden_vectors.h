@@ -0,0 +1,569 @@
+/**
+ * @file golden_vectors.h
+ * @brief Expected outputs of the fixed_filter tests.
+ *
+ * @details
+ * Generated by gen_golden.py. Do not edit: change the generator and run it again.
+ */
+
+#ifndef GOLDEN_VECTORS_H
+#define GOLDEN_VECTORS_H
+
+#include <stdint.h>
+#include "fixed_filter.h"
+
+#define GOLDEN_N 512u ///< Q15 input samples.
+#define GOLDEN_DECIM_FACTOR 4u ///< Decimation factor of golden_decim_out.
+#define GOLDEN_CIC_OUTPUTS 64u ///< Outputs of each CIC vector.
+#define GOLDEN_COMP_FACTOR 50u ///< CIC factor of golden_oversample_out.
+
+static const q15_t golden_in[512] = {
+    -48, 10654, 17927, 19652, 15325, 6166, -4926, -14469, -19524, -18432, -11707, -1237,
+    9514, 17363, 19810, 16041, 7293, -3777, -13558, -19171, -18861, -12710, -2445, 8392,
+    16826, 19834, 16720, 8482, -2478, -12661, -18845, -19292, -13562, -3719, 7300, 16057,
+    19859, 17359, 9574, -1258, -11666, -18487, -19479, -14525, -4927, 6084, 15244, 19683,
+    18009, 10695, 61, -10609, -18011, -19732, -15309, -6181, 4876, 14509, 19513, 18481,
+    11650, 1210, -9523, -17416, -19818, -16111, -7289, 3734, 13629, 19217, 18865, 12703,
+    2457, -8472, -16741, -19913, -16811, -8497, 2462, 12657, 18854, 19264, 13637, 3727,
+    -7362, -16106, -19783, -17353, -9526, 1223, 11718, 18425, 19508, 14454, 4945, -6117,
+    -15301, -19703, -17968, -10595, -57, 10638, 18009, 19691, 15341, 6082, -4909, -14514,
+    -19536, -18453, -11637, -1239, 9583, 17396, 19811, 16037, 7305, -3727, -13552, -19181,
+    -18887, -12711, -2530, 8501, 16825, 19843, 16792, 8520, -2482, -12671, -18873, -19203,
+    -13543, -3706, 7261, 16014, 19781, 17416, 9579, -1212, -11725, -18490, -19520, -14421,
+    -4926, 6186, 15251, 19669, 17997, 10648, 30, -10644, -17918, -19739, -15249, -6129,
+    4897, 14528, 19466, 18526, 11632, 1277, -9517, -17422, -19850, -16041, -7325, 3691,
+    13547, 19293, 18854, 12643, 2473, -8475, -16808, -19875, -16764, -8407, 2476, 12624,
+    18845, 19175, 13642, 3678, -7306, -16042, -19807, -17376, -9596, 1227, 11632, 18477,
+    19517, 14437, 4933, -6182, -15277, -19672, -18019, -10596, 54, 10592, 18007, 19658,
+    15326, 6156, -4956, -14527, -19513, -18513, -11615, -1257, 9597, 17369, 19850, 16011,
+    7332, -3726, -13658, -19282, -18928, -12713, -2552, 8425, 16778, 19860, 16776, 8399,
+    -2496, -12649, -18834, -19285, -13575, -3774, 7328, 16086, 19779, 17346, 9548, -1210,
+    -11725, -18491, -19491, -14474, -4996, 6140, 15242, 19730, 17919, 10632, -60, -10698,
+    -17979, -19711, -15341, -6095, 4979, 14452, 19536, 18461, 11678, 1185, -9558, -17372,
+    -19872, -16048, -7345, 3759, 13632, 19215, 18919, 12659, 2538, -8393, -16765, -19850,
+    -16775, -8500, 2511, 12598, 18886, 19225, 13627, 3679, -7350, -16039, -19832, -17383,
+    -9563, 1203, 11680, 18418, 19520, 14521, 4886, -6076, -15287, -19680, -17997, -10703,
+    -53, 10611, 17950, 19735, 15350, 6168, -4888, -14534, -19460, -18473, -11642, -1257,
+    9512, 17373, 19820, 16080, 7300, -3775, -13591, -19239, -18870, -12650, -2433, 8435,
+    16826, 19884, 16787, 8439, -2505, -12614, -18858, -19274, -13618, -3726, 7264, 16072,
+    19870, 17346, 9523, -1311, -11733, -18477, -19508, -14449, -4900, 6151, 15336, 19762,
+    18002, 10664, 17, -10648, -17933, -19642, -15255, -6104, 4957, 14441, 19524, 18528,
+    11626, 1297, -9553, -17391, -19829, -16053, -7342, 3687, 13578, 19211, 18947, 12693,
+    2464, -8492, -16774, -19906, -16787, -8505, 2451, 12618, 18881, 19248, 13659, 3681,
+    -7339, -16031, -19808, -17407, -9581, 1307, 11680, 18439, 19498, 14464, 4905, -6085,
+    -15357, -19739, -18019, -10617, 0, 10687, 17915, 19663, 15335, 6189, -4978, -14487,
+    -19569, -18479, -11646, -1215, 9568, 17453, 19760, 16107, 7265, -3749, -13593, -19298,
+    -18875, -12664, -2525, 8421, 16752, 19918, 16704, 8434, -2482, -12626, -18927, -19276,
+    -13641, -3659, 7320, 16070, 19769, 17396, 9584, -1221, -11623, -18406, -19536, -14471,
+    -4930, 6128, 15295, 19733, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, -32768, -32768, -32768, -32768,
+    -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+    -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+};
+
+static const q15_t golden_fir_taps[31] = {
+    -53, -8, 81, 123, -28, -308, -316, 236, 875, 572, -945, -2173,
+    -789, 3862, 9351, 11807, 9351, 3862, -789, -2173, -945, 572, 875, 236,
+    -316, -308, -28, 123, 81, -8, -53,
+};
+
+static const q15_t golden_fir_out[512] = {
+    0, -17, -32, -10, 55, 94, 3, -191, -249, 54, 527, 529,
+    -339, -1360, -709, 3192, 9929, 16613, 19381, 15859, 6690, -4874, -14739, -19729,
+    -18498, -11612, -1213, 9550, 17373, 19805, 16062, 7300, -3732, -13601, -19242, -18899,
+    -12675, -2499, 8461, 16788, 19887, 16792, 8470, -2487, -12671, -18914, -19270, -13623,
+    -3730, 7326, 16099, 19856, 17429, 9575, -1258, -11698, -18496, -19541, -14513, -4978,
+    6101, 15287, 19725, 18029, 10715, 54, -10633, -18011, -19774, -15374, -6183, 4930,
+    14501, 19547, 18500, 11691, 1244, -9589, -17440, -19863, -16101, -7322, 3738, 13631,
+    19276, 18920, 12678, 2491, -8475, -16811, -19922, -16838, -8516, 2457, 12666, 18931,
+    19292, 13634, 3721, -7346, -16111, -19847, -17400, -9545, 1272, 11694, 18483, 19526,
+    14495, 4949, -6140, -15318, -19729, -17998, -10664, -6, 10659, 18010, 19752, 15339,
+    6143, -4966, -14526, -19556, -18494, -11674, -1224, 9600, 17430, 19833, 16070, 7317,
+    -3709, -13585, -19246, -18922, -12702, -2513, 8473, 16826, 19936, 16834, 8490, -2487,
+    -12674, -18899, -19234, -13588, -3725, 7292, 16049, 19826, 17434, 9599, -1246, -11712,
+    -18520, -19545, -14479, -4917, 6162, 15319, 19719, 17994, 10673, 24, -10637, -17985,
+    -19727, -15321, -6142, 4951, 14504, 19545, 18506, 11708, 1266, -9570, -17427, -19859,
+    -16108, -7342, 3710, 13608, 19266, 18920, 12672, 2469, -8505, -16826, -19902, -16786,
+    -8457, 2491, 12656, 18882, 19234, 13598, 3726, -7312, -16076, -19840, -17432, -9597,
+    1228, 11676, 18487, 19535, 14491, 4930, -6165, -15337, -19732, -17984, -10641, 12,
+    10663, 17999, 19739, 15335, 6148, -4962, -14531, -19570, -18509, -11685, -1232, 9596,
+    17433, 19846, 16085, 7314, -3745, -13650, -19319, -18982, -12741, -2537, 8450, 16793,
+    19891, 16787, 8456, -2501, -12679, -18914, -19269, -13626, -3738, 7314, 16084, 19837,
+    17408, 9558, -1268, -11704, -18504, -19552, -14519, -4970, 6124, 15309, 19721, 17980,
+    10628, -43, -10705, -18037, -19755, -15328, -6132, 4969, 14520, 19549, 18492, 11681,
+    1237, -9595, -17443, -19865, -16101, -7321, 3739, 13634, 19283, 18936, 12706, 2529,
+    -8432, -16770, -19888, -16812, -8497, 2468, 12665, 18914, 19266, 13610, 3712, -7339,
+    -16101, -19851, -17427, -9587, 1234, 11673, 18482, 19537, 14509, 4965, -6123, -15306,
+    -19731, -18024, -10710, -59, 10620, 17998, 19768, 15373, 6183, -4931, -14496, -19535,
+    -18487, -11691, -1263, 9559, 17410, 19843, 16089, 7314, -3745, -13635, -19275, -18912,
+    -12660, -2465, 8502, 16826, 19914, 16806, 8475, -2485, -12667, -18912, -19278, -13645,
+    -3756, 7311, 16100, 19860, 17415, 9535, -1314, -11748, -18522, -19537, -14480, -4919,
+    6181, 15369, 19781, 18038, 10682, 10, -10646, -17969, -19690, -15281, -6116, 4958,
+    14503, 19546, 18511, 11713, 1268, -9567, -17420, -19850, -16106, -7351, 3696, 13602,
+    19277, 18945, 12701, 2494, -8491, -16829, -19928, -16835, -8513, 2452, 12655, 18917,
+    19283, 13635, 3734, -7328, -16102, -19854, -17421, -9564, 1266, 11699, 18489, 19529,
+    14494, 4942, -6161, -15356, -19771, -18023, -10664, 6, 10660, 17992, 19732, 15336,
+    6159, -4951, -14528, -19577, -18518, -11687, -1222, 9613, 17448, 19853, 16079, 7301,
+    -3751, -13641, -19290, -18940, -12700, -2512, 8455, 16784, 19884, 16792, 8469, -2497,
+    -12695, -18945, -19294, -13629, -3743, 7297, 16072, 19870, 17476, 9566, -1396, -11854,
+    -18414, -19145, -14196, -5347, 5079, 15133, 23507, 29426, 32743, 32767, 32767, 32339,
+    32246, 32767, 32767, 32767, 31602, 30383, 32283, 32767, 32767, 30529, 11806, -11807,
+    -30615, -32768, -32768, -32023, -30189, -31949, -32768, -32768, -31949, -30189, -32023, -32768,
+    -32768, -30615, -11807, 11806, 30614, 32767, 32767, 32022, 30188, 31948, 32767, 32767,
+    31948, 30188, 32022, 32767, 32767, 30614, 11806, -11807,
+};
+
+static const q15_t golden_gain_taps[3] = {
+    16384, 16384, 16384,
+};
+
+static const q15_t golden_gain_out[512] = {
+    -24, 5303, 14267, 24117, 26452, 20572, 8283, -6614, -19459, -26212, -24831, -15688,
+    -1715, 12820, 23344, 26607, 21572, 9779, -5021, -18253, -25795, -25371, -17008, -3381,
+    11387, 22526, 26690, 22518, 11362, -3328, -16992, -25399, -25849, -18286, -4990, 9819,
+    21608, 26638, 23396, 12838, -1675, -15705, -24816, -26245, -19465, -6684, 8201, 20506,
+    26468, 24194, 14383, 74, -14279, -24176, -26526, -20611, -8307, 6602, 19449, 26252,
+    24822, 15671, 1669, -12864, -23378, -26672, -21609, -9833, 5037, 18290, 25856, 25393,
+    17013, 3344, -11378, -22563, -26732, -22610, -11423, 3311, 16987, 25388, 25878, 18314,
+    5001, -9870, -21625, -26621, -23331, -12828, 1708, 15683, 24826, 26194, 19454, 6641,
+    -8236, -20560, -26486, -24133, -14310, -7, 14295, 24169, 26521, 20557, 8257, -6670,
+    -19479, -26251, -24813, -15664, -1646, 12870, 23395, 26622, 21577, 9808, -4987, -18230,
+    -25810, -25389, -17064, -3370, 11398, 22585, 26730, 22578, 11415, -3316, -17013, -25373,
+    -25809, -18226, -4994, 9785, 21528, 26606, 23388, 12892, -1679, -15713, -24867, -26215,
+    -19433, -6580, 8256, 20553, 26459, 24157, 14338, 17, -14266, -24150, -26453, -20558,
+    -8240, 6648, 19446, 26260, 24812, 15718, 1696, -12831, -23394, -26656, -21608, -9837,
+    4957, 18266, 25847, 25395, 16985, 3321, -11405, -22579, -26723, -22523, -11347, 3347,
+    16973, 25322, 25831, 18248, 5007, -9835, -21577, -26612, -23389, -12872, 1632, 15668,
+    24813, 26216, 19444, 6594, -8263, -20565, -26484, -24143, -14280, 25, 14327, 24129,
+    26496, 20570, 8263, -6663, -19498, -26276, -24820, -15692, -1637, 12855, 23408, 26615,
+    21597, 9809, -5026, -18333, -25934, -25461, -17096, -3420, 11326, 22532, 26707, 22518,
+    11340, -3373, -16989, -25384, -25847, -18317, -5010, 9820, 21597, 26606, 23337, 12842,
+    -1693, -15713, -24853, -26228, -19480, -6665, 8193, 20556, 26446, 24141, 14246, -63,
+    -14368, -24194, -26515, -20573, -8228, 6668, 19484, 26225, 24838, 15662, 1653, -12872,
+    -23401, -26646, -21632, -9817, 5023, 18303, 25883, 25397, 17058, 3402, -11310, -22504,
+    -26695, -22562, -11382, 3305, 16998, 25355, 25869, 18266, 4978, -9855, -21610, -26627,
+    -23389, -12871, 1660, 15651, 24809, 26230, 19464, 6666, -8238, -20521, -26482, -24190,
+    -14376, -72, 14254, 24148, 26518, 20627, 8315, -6627, -19441, -26233, -24787, -15686,
+    -1693, 12814, 23353, 26637, 21600, 9803, -5033, -18302, -25850, -25379, -16976, -3324,
+    11414, 22573, 26749, 22555, 11361, -3340, -16988, -25373, -25875, -18309, -5040, 9805,
+    21603, 26644, 23370, 12779, -1760, -15760, -24859, -26217, -19428, -6599, 8294, 20625,
+    26550, 24214, 14342, 17, -14282, -24111, -26415, -20500, -8201, 6647, 19461, 26247,
+    24839, 15726, 1685, -12823, -23386, -26636, -21612, -9854, 4962, 18238, 25868, 25426,
+    17052, 3333, -11401, -22586, -26733, -22599, -11420, 3282, 16975, 25374, 25894, 18294,
+    5001, -9844, -21589, -26623, -23398, -12840, 1703, 15713, 24809, 26201, 19434, 6642,
+    -8268, -20590, -26557, -24187, -14318, 35, 14301, 24133, 26457, 20594, 8273, -6638,
+    -19517, -26267, -24847, -15670, -1646, 12903, 23391, 26660, 21566, 9812, -5038, -18320,
+    -25883, -25418, -17032, -3384, 11324, 22546, 26687, 22528, 11328, -3337, -17017, -25414,
+    -25922, -18288, -4990, 9866, 21580, 26618, 23375, 12880, -1630, -15625, -24782, -26206,
+    -19468, -6636, 8247, 20578, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 16383, -16384, -32768, -32768,
+    -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+    -16384, 16383, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 16383, -16384, -32768, -32768, -32768, -32768, -32768, -32768,
+    -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+};
+
+static const q15_t golden_decim_taps[31] = {
+    -39, -67, -68, 0, 156, 324, 327, 0, -621, -1189, -1139, 0,
+    2249, 5022, 7322, 8216, 7322, 5022, 2249, 0, -1139, -1189, -621, 0,
+    327, 324, 156, 0, -68, -67, -39,
+};
+
+static const q15_t golden_decim_out[128] = {
+    -82, 392, -1386, 6302, 12935, -17861, 8846, 6829, -17665, 15687, -2326, -12725,
+    18552, -10929, -4655, 16843, -16822, 4599, 10931, -18562, 12735, 2327, -15734, 17681,
+    -6846, -8936, 18255, -14320, 2, 14325, -18268, 8962, 6844, -17678, 15712, -2305,
+    -12719, 18535, -10930, -4615, 16823, -16804, 4626, 10942, -18559, 12717, 2310, -15700,
+    17657, -6839, -8961, 18246, -14328, 13, 14321, -18278, 8965, 6829, -17734, 15680,
+    -2333, -12730, 18535, -10943, -4640, 16793, -16852, 4641, 10920, -18563, 12739, 2363,
+    -15704, 17666, -6849, -8965, 18260, -14313, -41, 14353, -18253, 8941, 6829, -17674,
+    15724, -2323, -12738, 18539, -10971, -4592, 16852, -16791, 4643, 10943, -18558, 12718,
+    2334, -15742, 17675, -6839, -8947, 18258, -14348, -6, 14326, -18279, 8974, 6826,
+    -17704, 15687, -2341, -12736, 18389, -10403, -6301, 29349, 32767, 31339, 32767, -8216,
+    -32768, -30238, -32768, 8215, 32767, 30237, 32767, -8216,
+};
+
+static const biquad_coeffs_q14_t golden_sos[2] = {
+    {.b0 = 925, .b1 = 1850, .b2 = 925, .a1 = -20065, .a2 = 7380},
+    {.b0 = 2869, .b1 = 5737, .b2 = 2869, .a1 = -8508, .a2 = 3599},
+};
+
+static const q15_t golden_biquad_out[512] = {
+    -1, 102, 775, 2750, 6249, 10332, 13222, 13263, 9777, 3410, -4083, -10453,
+    -13721, -12838, -8039, -784, 6696, 12086, 13712, 11071, 4988, -2642, -9448, -13317,
+    -13043, -8706, -1656, 5911, 11636, 13739, 11565, 5792, -1785, -8809, -13090, -13295,
+    -9360, -2511, 5121, 11158, 13719, 12008, 6558, -935, -8139, -12812, -13500, -9991,
+    -3378, 4284, 10615, 13645, 12428, 7339, -39, -7407, -12467, -13645, -10574, -4210,
+    3464, 10056, 13510, 12752, 8023, 795, -6682, -12082, -13720, -11084, -4995, 2647,
+    9464, 13335, 13055, 8710, 1652, -5925, -11663, -13776, -11604, -5824, 1764, 8799,
+    13092, 13303, 9365, 2508, -5127, -11158, -13711, -11995, -6546, 942, 8137, 12802,
+    13484, 9970, 3353, -4309, -10629, -13640, -12406, -7309, 66, 7423, 12470, 13633,
+    10549, 4179, -3493, -10077, -13521, -12754, -8018, -788, 6685, 12075, 13706, 11073,
+    4997, -2632, -9444, -13321, -13052, -8714, -1655, 5923, 11659, 13768, 11595, 5815,
+    -1770, -8795, -13073, -13277, -9350, -2515, 5103, 11136, 13704, 12003, 6557, -938,
+    -8142, -12809, -13484, -9962, -3342, 4316, 10633, 13645, 12413, 7318, -54, -7407,
+    -12451, -13616, -10539, -4178, 3488, 10071, 13521, 12764, 8037, 809, -6672, -12075,
+    -13717, -11090, -5011, 2628, 9447, 13321, 13042, 8696, 1638, -5933, -11657, -13753,
+    -11571, -5795, 1778, 8793, 13070, 13277, 9347, 2505, -5119, -11151, -13715, -12013,
+    -6572, 917, 8120, 12792, 13476, 9960, 3341, -4319, -10636, -13642, -12399, -7296,
+    77, 7427, 12468, 13630, 10548, 4178, -3497, -10084, -13530, -12763, -8025, -793,
+    6683, 12077, 13710, 11073, 4982, -2668, -9495, -13375, -13102, -8758, -1695, 5887,
+    11626, 13735, 11561, 5786, -1790, -8811, -13093, -13301, -9368, -2518, 5111, 11143,
+    13702, 11993, 6545, -947, -8148, -12817, -13502, -9990, -3373, 4291, 10613, 13623,
+    12382, 7276, -102, -7454, -12491, -13643, -10550, -4176, 3495, 10077, 13521, 12754,
+    8018, 787, -6690, -12087, -13723, -11085, -4994, 2651, 9472, 13347, 13074, 8738,
+    1687, -5886, -11624, -13741, -11577, -5807, 1770, 8796, 13080, 13286, 9349, 2499,
+    -5130, -11163, -13723, -12015, -6571, 918, 8122, 12798, 13488, 9979, 3365, -4297,
+    -10625, -13651, -12431, -7342, 33, 7399, 12461, 13643, 10574, 4211, -3461, -10049,
+    -13503, -12751, -8030, -811, 6661, 12060, 13700, 11067, 4983, -2654, -9465, -13329,
+    -13042, -8693, -1634, 5939, 11667, 13765, 11582, 5801, -1781, -8808, -13095, -13307,
+    -9377, -2527, 5109, 11148, 13705, 11984, 6525, -970, -8166, -12823, -13490, -9960,
+    -3328, 4345, 10672, 13684, 12442, 7335, -44, -7397, -12435, -13594, -10516, -4160,
+    3500, 10079, 13527, 12768, 8039, 810, -6669, -12070, -13714, -11090, -5014, 2624,
+    9448, 13331, 13058, 8713, 1651, -5928, -11665, -13776, -11606, -5830, 1756, 8792,
+    13087, 13300, 9365, 2514, -5117, -11154, -13716, -12004, -6552, 939, 8137, 12801,
+    13481, 9965, 3342, -4329, -10657, -13669, -12426, -7317, 63, 7417, 12462, 13629,
+    10551, 4182, -3494, -10083, -13530, -12763, -8022, -786, 6692, 12085, 13714, 11073,
+    4982, -2662, -9480, -13351, -13073, -8732, -1676, 5899, 11631, 13736, 11562, 5786,
+    -1795, -8824, -13109, -13310, -9366, -2510, 5121, 11155, 13719, 12017, 6579, -904,
+    -8105, -12782, -13475, -9967, -3204, 5373, 14370, 22472, 28624, 32209, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32119, 28399, 18871, 4195,
+    -11408, -23877, -31271, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+    -32120, -28400, -18872, -4196, 11407, 23876, 31270, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32119, 28399, 18871, 4195, -11408, -23877, -31271, -32768,
+    -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+};
+
+static const uint16_t golden_cic4_in[256] = {
+    2047, 2225, 2395, 2558, 2715, 2854, 2979, 3083, 3169, 3235, 3275, 3291, 3277, 3244, 3189, 3104,
+    3002, 2884, 2747, 2596, 2433, 2260, 2087, 1912, 1738, 1574, 1415, 1273, 1142, 1032, 942, 875,
+    831, 808, 813, 843, 895, 972, 1066, 1182, 1316, 1468, 1629, 1796, 1969, 2147, 2320, 2485,
+    2644, 2791, 2926, 3041, 3137, 3209, 3259, 3285, 3289, 3261, 3214, 3147, 3051, 2937, 2807, 2662,
+    2503, 2340, 2164, 1989, 1815, 1647, 1486, 1333, 1196, 1077, 978, 899, 845, 813, 809, 823,
+    867, 933, 1022, 1131, 1257, 1398, 1557, 1719, 1891, 2069, 2243, 2414, 2576, 2730, 2871, 2991,
+    3095, 3178, 3241, 3278, 3290, 3277, 3239, 3181, 3094, 2990, 2868, 2727, 2576, 2411, 2244, 2066,
+    1891, 1718, 1553, 1401, 1259, 1128, 1019, 934, 866, 825, 807, 816, 848, 903, 978, 1080,
+    1196, 1335, 1487, 1647, 1814, 1991, 2164, 2336, 2505, 2662, 2809, 2939, 3051, 3145, 3216, 3265,
+    3289, 3286, 3260, 3211, 3138, 3043, 2927, 2794, 2648, 2487, 2319, 2145, 1969, 1794, 1629, 1468,
+    1316, 1183, 1067, 968, 893, 843, 811, 807, 830, 872, 940, 1033, 1141, 1270, 1414, 1571,
+    1737, 1912, 2087, 2259, 2433, 2593, 2748, 2881, 3006, 3106, 3189, 3243, 3280, 3291, 3274, 3236,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const uint16_t golden_cic4_out[64] = {
+    4708, 28295, 44917, 50817, 50981, 45481, 36020, 25536, 17316, 13915, 16365, 23924,
+    34249, 44100, 50439, 51258, 46316, 37171, 26647, 18004, 13978, 15803, 22899, 33068,
+    43144, 49985, 51470, 47116, 38306, 27770, 18789, 14159, 15325, 21911, 31878, 42119,
+    49464, 51619, 47899, 39453, 28930, 19611, 14393, 14884, 20932, 30679, 41077, 48877,
+    53805, 62070, 56509, 16892, 9214, 48628, 56306, 16892, 9214, 48628, 56306, 16892,
+    9214, 48628, 56306, 16892,
+};
+
+static const uint16_t golden_cic16_in[1024] = {
+    2047, 2094, 2137, 2178, 2225, 2266, 2309, 2350, 2392, 2437, 2479, 2520, 2557, 2597, 2639, 2674,
+    2711, 2751, 2786, 2822, 2855, 2886, 2919, 2949, 2978, 3008, 3034, 3062, 3084, 3108, 3131, 3153,
+    3173, 3189, 3207, 3223, 3235, 3248, 3256, 3264, 3272, 3281, 3286, 3288, 3288, 3291, 3288, 3282,
+    3277, 3271, 3265, 3256, 3246, 3233, 3219, 3204, 3189, 3167, 3147, 3131, 3105, 3081, 3056, 3031,
+    3002, 2978, 2945, 2914, 2883, 2851, 2817, 2781, 2744, 2707, 2669, 2631, 2593, 2553, 2516, 2471,
+    2431, 2390, 2348, 2305, 2261, 2217, 2177, 2130, 2086, 2045, 2000, 1956, 1912, 1869, 1827, 1781,
+    1738, 1696, 1656, 1615, 1574, 1533, 1492, 1456, 1414, 1377, 1341, 1305, 1272, 1236, 1207, 1173,
+    1142, 1112, 1083, 1060, 1035, 1006, 983, 964, 940, 923, 905, 891, 876, 862, 846, 839,
+    827, 822, 817, 812, 807, 808, 806, 807, 812, 816, 824, 832, 840, 852, 865, 881,
+    896, 912, 930, 951, 972, 994, 1017, 1042, 1069, 1095, 1123, 1153, 1183, 1214, 1250, 1284,
+    1316, 1353, 1391, 1427, 1466, 1508, 1545, 1586, 1629, 1667, 1709, 1754, 1794, 1837, 1881, 1924,
+    1968, 2014, 2058, 2100, 2146, 2188, 2235, 2274, 2321, 2361, 2406, 2443, 2488, 2529, 2568, 2609,
+    2647, 2683, 2722, 2757, 2791, 2828, 2861, 2894, 2925, 2955, 2985, 3012, 3041, 3065, 3092, 3115,
+    3135, 3155, 3177, 3192, 3207, 3226, 3235, 3249, 3261, 3269, 3274, 3283, 3284, 3288, 3289, 3288,
+    3289, 3283, 3277, 3273, 3263, 3253, 3245, 3228, 3215, 3202, 3183, 3165, 3147, 3122, 3102, 3079,
+    3054, 3026, 2998, 2969, 2939, 2909, 2875, 2843, 2811, 2775, 2737, 2702, 2663, 2626, 2587, 2546,
+    2506, 2462, 2422, 2382, 2338, 2293, 2251, 2206, 2165, 2122, 2078, 2031, 1991, 1946, 1904, 1860,
+    1816, 1773, 1728, 1686, 1644, 1606, 1564, 1522, 1483, 1448, 1410, 1369, 1332, 1301, 1262, 1229,
+    1197, 1168, 1139, 1108, 1081, 1053, 1029, 1003, 979, 960, 940, 918, 903, 883, 873, 859,
+    848, 835, 825, 818, 816, 808, 806, 805, 809, 812, 814, 820, 826, 832, 842, 856,
+    868, 881, 898, 914, 932, 953, 973, 998, 1022, 1045, 1072, 1103, 1129, 1158, 1191, 1222,
+    1258, 1292, 1324, 1362, 1401, 1437, 1477, 1517, 1554, 1596, 1635, 1680, 1722, 1761, 1807, 1851,
+    1892, 1938, 1979, 2023, 2068, 2110, 2156, 2198, 2240, 2283, 2329, 2372, 2413, 2455, 2495, 2535,
+    2577, 2616, 2654, 2694, 2729, 2768, 2803, 2835, 2871, 2902, 2932, 2965, 2990, 3021, 3044, 3070,
+    3096, 3117, 3142, 3161, 3181, 3197, 3212, 3226, 3241, 3250, 3259, 3270, 3277, 3280, 3285, 3287,
+    3290, 3286, 3284, 3284, 3275, 3269, 3263, 3253, 3242, 3227, 3211, 3199, 3181, 3161, 3138, 3120,
+    3098, 3074, 3045, 3022, 2993, 2965, 2932, 2902, 2868, 2833, 2800, 2768, 2730, 2693, 2652, 2614,
+    2577, 2537, 2497, 2455, 2411, 2371, 2326, 2283, 2240, 2199, 2154, 2112, 2069, 2022, 1979, 1935,
+    1892, 1848, 1804, 1762, 1721, 1678, 1638, 1594, 1555, 1514, 1475, 1436, 1400, 1361, 1324, 1290,
+    1256, 1226, 1190, 1160, 1128, 1103, 1074, 1045, 1021, 999, 973, 955, 933, 915, 898, 880,
+    869, 855, 845, 832, 823, 820, 814, 809, 807, 805, 810, 808, 814, 818, 827, 838,
+    848, 859, 873, 885, 901, 918, 937, 959, 980, 1005, 1028, 1054, 1081, 1105, 1139, 1166,
+    1196, 1233, 1264, 1297, 1334, 1371, 1406, 1448, 1485, 1526, 1566, 1606, 1646, 1688, 1730, 1770,
+    1814, 1858, 1903, 1946, 1989, 2032, 2076, 2122, 2166, 2210, 2250, 2293, 2336, 2381, 2424, 2462,
+    2507, 2543, 2585, 2624, 2665, 2702, 2738, 2776, 2807, 2844, 2876, 2909, 2939, 2967, 2999, 3028,
+    3053, 3076, 3101, 3123, 3144, 3167, 3181, 3202, 3216, 3230, 3243, 3255, 3264, 3270, 3276, 3283,
+    3288, 3290, 3289, 3288, 3283, 3283, 3273, 3267, 3257, 3248, 3236, 3223, 3208, 3192, 3175, 3156,
+    3136, 3113, 3089, 3066, 3039, 3015, 2985, 2955, 2927, 2892, 2860, 2829, 2794, 2759, 2721, 2685,
+    2646, 2607, 2570, 2529, 2489, 2444, 2404, 2360, 2319, 2276, 2231, 2188, 2145, 2103, 2060, 2015,
+    1968, 1926, 1883, 1838, 1796, 1756, 1711, 1671, 1627, 1589, 1545, 1506, 1466, 1428, 1392, 1352,
+    1318, 1284, 1250, 1214, 1182, 1155, 1123, 1094, 1069, 1042, 1016, 994, 972, 948, 927, 910,
+    895, 879, 866, 853, 842, 834, 824, 819, 814, 811, 805, 806, 807, 810, 813, 819,
+    831, 836, 848, 861, 874, 890, 906, 924, 941, 961, 985, 1010, 1031, 1058, 1085, 1113,
+    1144, 1172, 1207, 1239, 1272, 1308, 1342, 1379, 1416, 1456, 1494, 1532, 1575, 1612, 1655, 1695,
+    1740, 1780, 1825, 1866, 1911, 1953, 2001, 2042, 2086, 2129, 2175, 2218, 2263, 2306, 2345, 2392,
+    2432, 2471, 2514, 2555, 2596, 2634, 2673, 2708, 2745, 2782, 2817, 2850, 2882, 2915, 2948, 2975,
+    3003, 3030, 3060, 3085, 3104, 3130, 3148, 3170, 3186, 3204, 3218, 3232, 3247, 3258, 3267, 3271,
+    3277, 3283, 3289, 3289, 3291, 3286, 3283, 3280, 3273, 3267, 3257, 3245, 3234, 3221, 3205, 3187,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const uint16_t golden_cic16_out[64] = {
+    2062, 21301, 42569, 50081, 51350, 46834, 37946, 27442, 18590, 14160, 15523, 22239,
+    32243, 42416, 49577, 51509, 47607, 39080, 28587, 19405, 14380, 15074, 21284, 31070,
+    41384, 49012, 51583, 48306, 40173, 29739, 20254, 14665, 14712, 20376, 29895, 40314,
+    48385, 51585, 48931, 41253, 30924, 21169, 15031, 14408, 19506, 28728, 39216, 47692,
+    52456, 59597, 61257, 28673, 5695, 36847, 59825, 28673, 5695, 36847, 59825, 28673,
+    5695, 36847, 59825, 28673,
+};
+
+static const uint16_t golden_cic50_in[3200] = {
+    2047, 2064, 2077, 2089, 2106, 2118, 2132, 2144, 2158, 2175, 2189, 2204, 2214, 2229, 2246, 2256,
+    2269, 2286, 2300, 2315, 2327, 2339, 2354, 2367, 2380, 2395, 2407, 2422, 2434, 2447, 2461, 2475,
+    2489, 2501, 2515, 2529, 2541, 2554, 2564, 2576, 2589, 2604, 2617, 2628, 2639, 2655, 2666, 2675,
+    2687, 2699, 2713, 2725, 2738, 2748, 2760, 2771, 2785, 2792, 2803, 2818, 2826, 2836, 2847, 2858,
+    2868, 2882, 2890, 2900, 2911, 2922, 2932, 2940, 2949, 2958, 2968, 2977, 2987, 2996, 3008, 3013,
+    3023, 3033, 3042, 3050, 3058, 3065, 3076, 3081, 3088, 3099, 3105, 3113, 3119, 3127, 3135, 3138,
+    3145, 3152, 3160, 3166, 3172, 3177, 3182, 3190, 3192, 3197, 3203, 3207, 3214, 3217, 3226, 3227,
+    3231, 3234, 3238, 3246, 3250, 3249, 3253, 3259, 3259, 3264, 3267, 3271, 3274, 3276, 3274, 3279,
+    3278, 3282, 3285, 3285, 3284, 3287, 3286, 3286, 3289, 3288, 3289, 3289, 3288, 3289, 3288, 3290,
+    3289, 3287, 3286, 3286, 3285, 3283, 3280, 3279, 3278, 3273, 3271, 3269, 3265, 3261, 3261, 3258,
+    3252, 3250, 3247, 3241, 3238, 3237, 3230, 3226, 3224, 3216, 3211, 3208, 3201, 3196, 3191, 3185,
+    3179, 3176, 3170, 3162, 3158, 3150, 3147, 3136, 3133, 3124, 3119, 3108, 3104, 3097, 3088, 3082,
+    3073, 3063, 3057, 3047, 3037, 3031, 3022, 3013, 3003, 2994, 2986, 2975, 2968, 2957, 2950, 2940,
+    2928, 2918, 2911, 2898, 2887, 2880, 2866, 2857, 2848, 2837, 2824, 2816, 2802, 2791, 2780, 2768,
+    2759, 2746, 2733, 2723, 2710, 2698, 2689, 2672, 2661, 2652, 2638, 2625, 2615, 2598, 2589, 2577,
+    2564, 2550, 2537, 2524, 2511, 2499, 2484, 2471, 2460, 2446, 2431, 2419, 2405, 2393, 2380, 2365,
+    2352, 2335, 2323, 2312, 2296, 2280, 2267, 2252, 2241, 2228, 2214, 2197, 2186, 2171, 2159, 2144,
+    2130, 2116, 2099, 2085, 2071, 2060, 2045, 2029, 2015, 2005, 1991, 1973, 1959, 1949, 1931, 1917,
+    1904, 1892, 1879, 1864, 1851, 1835, 1824, 1808, 1793, 1782, 1769, 1752, 1741, 1724, 1714, 1701,
+    1687, 1671, 1657, 1643, 1634, 1617, 1604, 1591, 1582, 1569, 1555, 1543, 1529, 1513, 1502, 1491,
+    1478, 1464, 1453, 1439, 1427, 1416, 1402, 1393, 1381, 1367, 1356, 1347, 1333, 1320, 1311, 1298,
+    1289, 1278, 1264, 1256, 1247, 1234, 1225, 1215, 1202, 1193, 1181, 1175, 1165, 1151, 1144, 1136,
+    1124, 1117, 1105, 1096, 1089, 1078, 1071, 1061, 1051, 1043, 1038, 1029, 1021, 1013, 1004, 997,
+    991, 983, 976, 971, 962, 957, 951, 942, 938, 931, 923, 920, 910, 907, 899, 894,
+    891, 884, 883, 877, 873, 867, 863, 858, 856, 850, 845, 844, 841, 835, 833, 830,
+    830, 824, 822, 824, 818, 817, 818, 816, 815, 811, 809, 811, 811, 809, 805, 808,
+    809, 809, 806, 809, 809, 810, 808, 811, 810, 810, 813, 817, 818, 820, 819, 821,
+    826, 829, 832, 833, 834, 839, 841, 844, 848, 853, 856, 862, 868, 868, 873, 878,
+    884, 888, 892, 898, 906, 910, 917, 920, 928, 933, 939, 945, 954, 959, 964, 972,
+    979, 990, 994, 1003, 1008, 1020, 1027, 1032, 1042, 1052, 1057, 1069, 1076, 1085, 1094, 1101,
+    1113, 1121, 1132, 1138, 1148, 1161, 1170, 1178, 1189, 1197, 1212, 1218, 1231, 1239, 1252, 1265,
+    1276, 1287, 1298, 1307, 1318, 1329, 1340, 1354, 1365, 1378, 1389, 1401, 1414, 1422, 1438, 1448,
+    1459, 1475, 1486, 1496, 1511, 1524, 1535, 1551, 1562, 1577, 1590, 1602, 1614, 1628, 1641, 1652,
+    1666, 1680, 1695, 1708, 1720, 1734, 1747, 1763, 1777, 1791, 1801, 1815, 1829, 1846, 1860, 1870,
+    1888, 1898, 1914, 1928, 1944, 1957, 1970, 1986, 1996, 2013, 2026, 2041, 2054, 2066, 2083, 2098,
+    2111, 2123, 2138, 2151, 2165, 2182, 2192, 2210, 2222, 2236, 2250, 2265, 2279, 2289, 2303, 2319,
+    2333, 2347, 2360, 2373, 2385, 2402, 2412, 2426, 2438, 2453, 2466, 2479, 2492, 2505, 2519, 2532,
+    2545, 2557, 2569, 2584, 2594, 2610, 2621, 2633, 2647, 2656, 2669, 2684, 2696, 2707, 2718, 2731,
+    2742, 2753, 2767, 2778, 2790, 2798, 2810, 2820, 2832, 2843, 2852, 2863, 2875, 2886, 2897, 2907,
+    2914, 2926, 2936, 2944, 2955, 2966, 2974, 2985, 2991, 3003, 3009, 3019, 3027, 3035, 3046, 3051,
+    3061, 3070, 3078, 3083, 3091, 3102, 3108, 3114, 3124, 3130, 3136, 3144, 3151, 3154, 3160, 3167,
+    3175, 3180, 3186, 3192, 3197, 3203, 3207, 3214, 3218, 3223, 3224, 3229, 3233, 3237, 3240, 3244,
+    3251, 3251, 3256, 3260, 3262, 3266, 3269, 3271, 3272, 3273, 3277, 3281, 3279, 3282, 3284, 3284,
+    3287, 3285, 3290, 3289, 3289, 3290, 3289, 3289, 3289, 3291, 3289, 3287, 3289, 3284, 3285, 3281,
+    3283, 3278, 3279, 3275, 3274, 3270, 3272, 3267, 3264, 3260, 3259, 3256, 3255, 3251, 3243, 3244,
+    3238, 3232, 3229, 3226, 3223, 3217, 3213, 3205, 3200, 3196, 3191, 3185, 3178, 3173, 3169, 3160,
+    3154, 3146, 3144, 3137, 3126, 3122, 3113, 3108, 3098, 3092, 3083, 3075, 3070, 3062, 3054, 3042,
+    3033, 3026, 3020, 3009, 3002, 2989, 2980, 2973, 2962, 2955, 2944, 2933, 2925, 2915, 2903, 2892,
+    2884, 2871, 2861, 2850, 2840, 2832, 2820, 2811, 2800, 2788, 2773, 2766, 2750, 2738, 2728, 2716,
+    2704, 2692, 2683, 2669, 2656, 2645, 2634, 2622, 2607, 2597, 2582, 2569, 2556, 2542, 2530, 2516,
+    2503, 2493, 2481, 2467, 2452, 2439, 2424, 2411, 2400, 2384, 2370, 2356, 2347, 2330, 2318, 2304,
+    2290, 2274, 2260, 2246, 2233, 2220, 2207, 2191, 2180, 2163, 2152, 2137, 2121, 2107, 2095, 2079,
+    2067, 2053, 2040, 2027, 2013, 1995, 1984, 1969, 1957, 1942, 1925, 1915, 1899, 1884, 1872, 1857,
+    1842, 1831, 1817, 1803, 1789, 1774, 1760, 1745, 1735, 1718, 1707, 1695, 1681, 1665, 1653, 1638,
+    1628, 1615, 1601, 1585, 1576, 1559, 1548, 1533, 1520, 1510, 1497, 1483, 1470, 1459, 1446, 1433,
+    1424, 1410, 1397, 1389, 1376, 1365, 1353, 1342, 1329, 1318, 1304, 1297, 1284, 1271, 1263, 1251,
+    1238, 1228, 1220, 1211, 1196, 1187, 1178, 1170, 1159, 1150, 1140, 1127, 1122, 1110, 1104, 1093,
+    1083, 1077, 1067, 1059, 1050, 1043, 1033, 1023, 1018, 1009, 1000, 994, 988, 982, 973, 965,
+    957, 950, 947, 939, 931, 925, 922, 915, 910, 903, 900, 891, 888, 881, 879, 875,
+    871, 867, 859, 858, 853, 847, 848, 842, 840, 838, 834, 829, 830, 823, 823, 823,
+    820, 816, 817, 812, 812, 813, 808, 807, 809, 808, 808, 806, 808, 806, 806, 809,
+    810, 811, 810, 812, 813, 811, 816, 817, 820, 822, 823, 823, 825, 828, 831, 833,
+    836, 840, 843, 848, 852, 854, 857, 865, 869, 871, 876, 879, 887, 893, 894, 904,
+    905, 914, 919, 925, 929, 934, 944, 949, 958, 962, 971, 974, 983, 991, 997, 1004,
+    1014, 1020, 1028, 1037, 1046, 1054, 1062, 1073, 1080, 1091, 1098, 1109, 1115, 1123, 1137, 1146,
+    1154, 1165, 1172, 1182, 1192, 1206, 1214, 1223, 1233, 1246, 1258, 1270, 1281, 1292, 1299, 1313,
+    1325, 1337, 1346, 1360, 1369, 1383, 1394, 1405, 1416, 1429, 1443, 1456, 1469, 1480, 1491, 1502,
+    1518, 1530, 1543, 1556, 1570, 1581, 1595, 1606, 1621, 1633, 1647, 1659, 1674, 1685, 1699, 1716,
+    1729, 1739, 1752, 1768, 1784, 1798, 1808, 1824, 1835, 1850, 1867, 1878, 1893, 1907, 1918, 1935,
+    1946, 1964, 1978, 1988, 2004, 2020, 2032, 2048, 2058, 2077, 2091, 2102, 2115, 2131, 2143, 2158,
+    2173, 2186, 2198, 2212, 2229, 2240, 2258, 2269, 2283, 2295, 2312, 2324, 2338, 2354, 2366, 2380,
+    2394, 2404, 2420, 2433, 2447, 2458, 2471, 2486, 2501, 2512, 2525, 2538, 2553, 2565, 2577, 2588,
+    2602, 2613, 2628, 2641, 2651, 2662, 2677, 2686, 2698, 2714, 2726, 2736, 2746, 2759, 2768, 2779,
+    2794, 2802, 2813, 2828, 2838, 2846, 2856, 2867, 2880, 2890, 2902, 2911, 2921, 2929, 2940, 2951,
+    2957, 2970, 2976, 2985, 2997, 3006, 3013, 3023, 3031, 3039, 3050, 3059, 3067, 3075, 3079, 3090,
+    3098, 3105, 3113, 3117, 3123, 3130, 3140, 3146, 3150, 3157, 3163, 3172, 3178, 3184, 3189, 3195,
+    3200, 3202, 3211, 3215, 3220, 3225, 3225, 3233, 3236, 3239, 3243, 3249, 3252, 3256, 3257, 3263,
+    3265, 3265, 3271, 3273, 3275, 3274, 3279, 3280, 3283, 3283, 3285, 3287, 3286, 3285, 3287, 3287,
+    3288, 3290, 3289, 3289, 3287, 3286, 3289, 3287, 3285, 3283, 3285, 3285, 3279, 3282, 3277, 3278,
+    3275, 3270, 3268, 3265, 3264, 3262, 3257, 3255, 3249, 3248, 3242, 3239, 3234, 3232, 3225, 3221,
+    3216, 3216, 3209, 3204, 3199, 3191, 3187, 3182, 3178, 3171, 3165, 3158, 3154, 3145, 3138, 3134,
+    3125, 3118, 3110, 3102, 3096, 3088, 3080, 3074, 3066, 3055, 3047, 3040, 3034, 3021, 3013, 3005,
+    2998, 2989, 2977, 2968, 2961, 2950, 2942, 2929, 2921, 2910, 2901, 2889, 2881, 2870, 2858, 2847,
+    2836, 2828, 2817, 2804, 2793, 2783, 2770, 2757, 2748, 2737, 2723, 2714, 2699, 2690, 2675, 2663,
+    2653, 2640, 2625, 2613, 2600, 2589, 2577, 2563, 2549, 2540, 2523, 2510, 2499, 2486, 2473, 2462,
+    2445, 2434, 2422, 2406, 2391, 2378, 2364, 2354, 2337, 2323, 2313, 2297, 2284, 2271, 2258, 2240,
+    2229, 2215, 2199, 2189, 2174, 2161, 2143, 2132, 2116, 2103, 2088, 2077, 2060, 2044, 2034, 2017,
+    2004, 1992, 1977, 1960, 1949, 1936, 1919, 1906, 1891, 1879, 1865, 1853, 1839, 1825, 1807, 1794,
+    1782, 1766, 1754, 1740, 1729, 1716, 1698, 1688, 1673, 1659, 1647, 1635, 1621, 1606, 1594, 1583,
+    1566, 1553, 1540, 1531, 1518, 1503, 1490, 1477, 1468, 1455, 1441, 1429, 1420, 1405, 1395, 1380,
+    1371, 1360, 1346, 1335, 1325, 1314, 1300, 1290, 1278, 1266, 1257, 1247, 1235, 1225, 1215, 1203,
+    1195, 1183, 1172, 1165, 1154, 1143, 1135, 1124, 1116, 1109, 1096, 1087, 1080, 1072, 1063, 1053,
+    1047, 1037, 1028, 1021, 1014, 1008, 998, 991, 986, 974, 967, 961, 957, 951, 944, 935,
+    928, 923, 917, 913, 907, 904, 897, 891, 885, 883, 875, 872, 870, 864, 860, 855,
+    852, 849, 842, 843, 838, 835, 833, 828, 827, 823, 822, 820, 816, 817, 815, 813,
+    812, 810, 811, 811, 806, 806, 805, 805, 809, 807, 806, 808, 807, 808, 812, 810,
+    811, 816, 816, 815, 818, 820, 824, 823, 828, 829, 833, 834, 837, 842, 848, 850,
+    851, 857, 859, 865, 871, 876, 880, 882, 888, 892, 899, 905, 911, 913, 922, 927,
+    934, 937, 944, 952, 958, 966, 974, 982, 987, 993, 1004, 1007, 1019, 1027, 1032, 1040,
+    1051, 1059, 1066, 1076, 1086, 1093, 1103, 1110, 1118, 1128, 1141, 1148, 1156, 1168, 1178, 1190,
+    1199, 1209, 1219, 1229, 1239, 1251, 1262, 1275, 1285, 1296, 1306, 1315, 1330, 1341, 1353, 1365,
+    1377, 1387, 1398, 1412, 1422, 1433, 1447, 1460, 1474, 1483, 1499, 1509, 1522, 1536, 1547, 1561,
+    1575, 1589, 1600, 1612, 1627, 1640, 1652, 1664, 1678, 1694, 1704, 1718, 1733, 1747, 1762, 1772,
+    1790, 1802, 1814, 1827, 1843, 1857, 1869, 1883, 1898, 1913, 1929, 1941, 1955, 1971, 1981, 1997,
+    2009, 2026, 2039, 2054, 2069, 2079, 2093, 2108, 2124, 2136, 2151, 2165, 2181, 2192, 2209, 2219,
+    2234, 2249, 2262, 2275, 2292, 2306, 2318, 2329, 2345, 2356, 2370, 2383, 2400, 2412, 2428, 2438,
+    2451, 2467, 2479, 2493, 2506, 2517, 2530, 2544, 2558, 2571, 2582, 2593, 2609, 2622, 2630, 2644,
+    2657, 2669, 2683, 2695, 2705, 2715, 2729, 2738, 2754, 2762, 2777, 2784, 2799, 2807, 2820, 2831,
+    2844, 2850, 2862, 2875, 2884, 2893, 2906, 2916, 2923, 2936, 2943, 2956, 2962, 2972, 2982, 2990,
+    2999, 3011, 3018, 3028, 3035, 3043, 3054, 3062, 3068, 3076, 3084, 3093, 3100, 3109, 3112, 3121,
+    3129, 3137, 3144, 3148, 3156, 3163, 3165, 3171, 3179, 3185, 3191, 3194, 3199, 3206, 3209, 3214,
+    3219, 3226, 3230, 3232, 3239, 3243, 3245, 3250, 3252, 3258, 3260, 3264, 3263, 3269, 3268, 3271,
+    3275, 3278, 3277, 3282, 3284, 3281, 3285, 3284, 3286, 3288, 3290, 3291, 3288, 3290, 3290, 3289,
+    3291, 3288, 3287, 3285, 3284, 3286, 3284, 3280, 3280, 3277, 3276, 3274, 3274, 3268, 3266, 3265,
+    3260, 3257, 3257, 3251, 3251, 3247, 3240, 3237, 3236, 3229, 3226, 3222, 3216, 3214, 3207, 3202,
+    3198, 3190, 3183, 3180, 3176, 3168, 3163, 3157, 3150, 3141, 3138, 3129, 3120, 3116, 3108, 3098,
+    3095, 3086, 3078, 3067, 3062, 3053, 3046, 3037, 3030, 3017, 3010, 2999, 2994, 2983, 2976, 2964,
+    2954, 2945, 2936, 2928, 2917, 2906, 2896, 2885, 2876, 2865, 2852, 2843, 2832, 2819, 2811, 2797,
+    2790, 2777, 2765, 2751, 2743, 2728, 2718, 2705, 2693, 2681, 2671, 2659, 2644, 2635, 2622, 2610,
+    2596, 2585, 2569, 2559, 2545, 2531, 2517, 2506, 2493, 2480, 2466, 2454, 2442, 2428, 2416, 2401,
+    2387, 2375, 2362, 2345, 2333, 2321, 2307, 2293, 2278, 2262, 2248, 2236, 2222, 2209, 2192, 2178,
+    2165, 2154, 2139, 2125, 2111, 2095, 2081, 2069, 2055, 2040, 2028, 2014, 1996, 1982, 1970, 1955,
+    1944, 1926, 1912, 1900, 1887, 1870, 1858, 1843, 1829, 1818, 1805, 1788, 1776, 1761, 1750, 1735,
+    1720, 1710, 1695, 1681, 1668, 1656, 1642, 1627, 1615, 1600, 1590, 1573, 1563, 1547, 1539, 1526,
+    1513, 1496, 1485, 1471, 1462, 1448, 1434, 1426, 1410, 1399, 1387, 1377, 1365, 1355, 1343, 1331,
+    1319, 1308, 1298, 1287, 1276, 1262, 1252, 1239, 1229, 1221, 1209, 1197, 1189, 1181, 1167, 1158,
+    1150, 1138, 1132, 1122, 1111, 1105, 1093, 1085, 1076, 1068, 1060, 1049, 1040, 1036, 1027, 1020,
+    1010, 1003, 993, 988, 979, 975, 965, 958, 953, 947, 939, 933, 928, 924, 915, 908,
+    903, 901, 892, 887, 882, 878, 875, 868, 864, 861, 859, 854, 849, 844, 845, 838,
+    837, 834, 830, 826, 826, 822, 823, 819, 819, 815, 812, 811, 812, 810, 810, 809,
+    808, 806, 809, 805, 807, 806, 808, 806, 810, 810, 808, 809, 812, 813, 816, 818,
+    818, 820, 825, 826, 827, 833, 834, 839, 843, 846, 845, 853, 853, 860, 864, 866,
+    870, 874, 883, 888, 890, 896, 902, 904, 914, 918, 924, 930, 938, 941, 949, 957,
+    962, 967, 974, 982, 988, 997, 1003, 1011, 1020, 1027, 1039, 1044, 1054, 1062, 1069, 1079,
+    1090, 1096, 1108, 1116, 1126, 1133, 1144, 1155, 1164, 1171, 1181, 1195, 1204, 1212, 1223, 1233,
+    1243, 1254, 1266, 1278, 1290, 1300, 1310, 1324, 1335, 1344, 1356, 1368, 1379, 1390, 1405, 1415,
+    1428, 1440, 1451, 1463, 1476, 1488, 1504, 1513, 1527, 1539, 1554, 1568, 1580, 1592, 1605, 1619,
+    1633, 1647, 1658, 1670, 1686, 1699, 1710, 1728, 1740, 1751, 1767, 1781, 1796, 1808, 1824, 1834,
+    1847, 1864, 1877, 1889, 1904, 1921, 1933, 1949, 1961, 1977, 1989, 2005, 2017, 2030, 2044, 2061,
+    2074, 2085, 2101, 2115, 2127, 2145, 2157, 2171, 2185, 2200, 2213, 2229, 2240, 2256, 2269, 2281,
+    2294, 2310, 2322, 2339, 2350, 2365, 2380, 2392, 2404, 2416, 2430, 2444, 2459, 2473, 2483, 2500,
+    2509, 2526, 2537, 2550, 2563, 2575, 2589, 2601, 2611, 2623, 2637, 2650, 2660, 2674, 2685, 2699,
+    2710, 2723, 2732, 2747, 2757, 2770, 2779, 2789, 2804, 2816, 2826, 2836, 2845, 2855, 2868, 2879,
+    2887, 2898, 2911, 2921, 2928, 2940, 2947, 2959, 2970, 2979, 2986, 2995, 3004, 3013, 3021, 3033,
+    3039, 3046, 3057, 3065, 3070, 3078, 3087, 3094, 3101, 3112, 3118, 3125, 3132, 3140, 3147, 3152,
+    3156, 3163, 3172, 3175, 3182, 3189, 3193, 3196, 3205, 3207, 3214, 3217, 3221, 3227, 3232, 3237,
+    3241, 3243, 3249, 3249, 3255, 3255, 3259, 3263, 3267, 3268, 3271, 3272, 3274, 3279, 3281, 3283,
+    3282, 3284, 3284, 3287, 3285, 3287, 3288, 3288, 3290, 3288, 3287, 3288, 3290, 3286, 3287, 3288,
+    3283, 3283, 3282, 3281, 3278, 3277, 3274, 3272, 3272, 3271, 3266, 3266, 3259, 3257, 3254, 3253,
+    3249, 3245, 3238, 3238, 3230, 3228, 3225, 3219, 3215, 3209, 3202, 3199, 3196, 3187, 3185, 3179,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const uint16_t golden_cic50_out[64] = {
+    1638, 19680, 41909, 49890, 51417, 47137, 38386, 27882, 18902, 14238, 15341, 21875,
+    31797, 42022, 49369, 51543, 47871, 39497, 29033, 19728, 14484, 14931, 20935, 30620,
+    40975, 48780, 51594, 48549, 40592, 30198, 20604, 14798, 14587, 20039, 29451, 39897,
+    48124, 51569, 49163, 41651, 31373, 21531, 15184, 14315, 19190, 28293, 38789, 47410,
+    52214, 59015, 61934, 31450, 5484, 34070, 60036, 31450, 5484, 34070, 60036, 31450,
+    5484, 34070, 60036, 31450,
+};
+
+static const q15_t golden_comp_taps[15] = {
+    141, -354, -120, 1968, -1573, -5481, 9794, 24017, 9794, -5481, -1573, 1968,
+    -120, -354, 141,
+};
+
+static const uint16_t golden_oversample_out[64] = {
+    32634, 33048, 33063, 30921, 33338, 38950, 26043, 4674, 13679, 42497, 54516, 51750,
+    47125, 38964, 27682, 18126, 13256, 14424, 21300, 31746, 42510, 50243, 52533, 48666,
+    39852, 28835, 19042, 13520, 13992, 20311, 30506, 41408, 49622, 52587, 49380, 41004,
+    30063, 19963, 13850, 13630, 19368, 29277, 40273, 48933, 52560, 50026, 42119, 31300,
+    20941, 14290, 13322, 18272, 28449, 39959, 45917, 51085, 65107, 64530, 26485, 1216,
+    35316, 65329, 31101, 0,
+};
+
+#endif // GOLDEN_VECTORS_H
@@ -0,0 +1,289 @@
+/**
+ * @file test_fixed_filter.c
+ * @brief Bit-exact tests of the FIR, decimating FIR, biquad cascade and CIC decimator.
+ *
+ * @details
+ * Every filter runs over the inputs of golden_vectors.h (see gen_golden.py) in blocks of
+ * pseudo-random length, so state carried between calls and decimation phases that straddle
+ * two blocks are exercised, and must match the expected outputs exactly. The FIR outputs
+ * are also checked against a double-precision evaluation with the same taps, and the CIC
+ * against its documented DC gain at every supported factor.
+ */
+
+#include <string.h>
+#include "fixed_filter.h"
+#include "golden_vectors.h"
+#include "host_test.h"
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t lcg = 12345u;
+
+/**
+ * @brief Block length for the next call, 1 to 37 samples.
+ */
+static size_t next_chunk(void)
+{
+    lcg = lcg * 1664525u + 1013904223u;
+    return 1u + (lcg >> 16) % 37u;
+}
+
+static uint32_t mismatches_q15(const q15_t *got, const q15_t *want, size_t n)
+{
+    uint32_t bad = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (got[i] != want[i])
+        {
+            if (bad == 0)
+            {
+                fprintf(stderr, "  first mismatch at %zu: %d != %d\n", i, got[i], want[i]);
+            }
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static uint32_t mismatches_u16(const uint16_t *got, const uint16_t *want, size_t n)
+{
+    uint32_t bad = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (got[i] != want[i])
+        {
+            if (bad == 0)
+            {
+                fprintf(stderr, "  first mismatch at %zu: %u != %u\n", i, got[i], want[i]);
+            }
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static void run_fir(const q15_t *taps, uint16_t num_taps, const q15_t *want)
+{
+    q15_t state[2 * 64];
+    q15_t buf[GOLDEN_N];
+    fir_q15_t f;
+
+    // In place, in uneven blocks
+    memcpy(buf, golden_in, sizeof(buf));
+    fir_q15_init(&f, taps, num_taps, state);
+    for (size_t done = 0, len; done < GOLDEN_N; done += len)
+    {
+        len = next_chunk();
+        if (len > GOLDEN_N - done)
+        {
+            len = GOLDEN_N - done;
+        }
+        fir_q15_process(&f, &buf[done], &buf[done], len);
+    }
+    CHECK_EQ(mismatches_q15(buf, want, GOLDEN_N), 0);
+
+    // The Q15 result is the exact sum of products rounded to nearest, unless saturated
+    uint32_t off = 0;
+    for (size_t n = 0; n < GOLDEN_N; n++)
+    {
+        double exact = 0.0;
+        for (size_t k = 0; k < num_taps && k <= n; k++)
+        {
+            exact += (double)taps[k] * golden_in[n - k] / 32768.0;
+        }
+        if (exact > 32767.0)
+        {
+            exact = 32767.0;
+        }
+        if (exact < -32768.0)
+        {
+            exact = -32768.0;
+        }
+        if (buf[n] - exact > 0.5 || exact - buf[n] > 0.5)
+        {
+            off++;
+        }
+    }
+    CHECK_EQ(off, 0);
+}
+
+static void test_fir(void)
+{
+    run_fir(golden_fir_taps, COUNT(golden_fir_taps), golden_fir_out);
+    run_fir(golden_gain_taps, COUNT(golden_gain_taps), golden_gain_out);
+}
+
+static void test_decimator(void)
+{
+    q15_t state[2 * COUNT(golden_decim_taps)];
+    q15_t out[GOLDEN_N];
+    fir_decim_q15_t d;
+    size_t produced = 0;
+
+    fir_decim_q15_init(&d, golden_decim_taps, COUNT(golden_decim_taps), GOLDEN_DECIM_FACTOR, state);
+    for (size_t done = 0, len; done < GOLDEN_N; done += len)
+    {
+        len = next_chunk();
+        if (len > GOLDEN_N - done)
+        {
+            len = GOLDEN_N - done;
+        }
+        size_t m = fir_decim_q15_process(&d, &golden_in[done], &out[produced], len);
+        CHECK(m <= len / GOLDEN_DECIM_FACTOR + 1u);
+        produced += m;
+    }
+    CHECK_EQ(produced, COUNT(golden_decim_out));
+    CHECK_EQ(mismatches_q15(out, golden_decim_out, COUNT(golden_decim_out)), 0);
+}
+
+static void test_biquad(void)
+{
+    biquad_state_q15_t state[COUNT(golden_sos)];
+    biquad_cascade_q15_t c;
+    q15_t buf[GOLDEN_N];
+
+    memcpy(buf, golden_in, sizeof(buf));
+    biquad_cascade_q15_init(&c, golden_sos, state, COUNT(golden_sos));
+    for (size_t done = 0, len; done < GOLDEN_N; done += len)
+    {
+        len = next_chunk();
+        if (len > GOLDEN_N - done)
+        {
+            len = GOLDEN_N - done;
+        }
+        biquad_cascade_q15_process(&c, &buf[done], &buf[done], len);
+    }
+    CHECK_EQ(mismatches_q15(buf, golden_biquad_out, GOLDEN_N), 0);
+
+    // The full-scale square wave at the end overshoots and must have been clipped
+    bool clipped = false;
+    for (size_t i = 0; i < GOLDEN_N; i++)
+    {
+        clipped |= (buf[i] == 32767);
+    }
+    CHECK(clipped);
+}
+
+static void run_cic(uint16_t factor, const uint16_t *in, const uint16_t *want)
+{
+    cic_decim_t c;
+    uint16_t out[GOLDEN_CIC_OUTPUTS + 1];
+    size_t n = (size_t)factor * GOLDEN_CIC_OUTPUTS;
+    size_t produced = 0;
+
+    CHECK(cic_decim_init(&c, factor));
+    for (size_t done = 0, len; done < n; done += len)
+    {
+        len = next_chunk() * 3u;
+        if (len > n - done)
+        {
+            len = n - done;
+        }
+        produced += cic_decim_process(&c, &in[done], &out[produced], len);
+    }
+    CHECK_EQ(produced, GOLDEN_CIC_OUTPUTS);
+    CHECK_EQ(mismatches_u16(out, want, GOLDEN_CIC_OUTPUTS), 0);
+}
+
+static void test_cic(void)
+{
+    run_cic(4, golden_cic4_in, golden_cic4_out);
+    run_cic(16, golden_cic16_in, golden_cic16_out);
+    run_cic(50, golden_cic50_in, golden_cic50_out);
+
+    cic_decim_t c;
+    CHECK(!cic_decim_init(&c, CIC_MIN_FACTOR - 1u));
+    CHECK(!cic_decim_init(&c, CIC_MAX_FACTOR + 1u));
+
+    // Once the history is full, a constant code a gives exactly 16 * a at every factor
+    static uint16_t in[5 * CIC_MAX_FACTOR];
+    uint16_t out[6];
+    uint32_t wrong = 0;
+    for (uint16_t r = CIC_MIN_FACTOR; r <= CIC_MAX_FACTOR; r++)
+    {
+        for (uint16_t a = 0; a < 4096; a += 455)
+        {
+            for (size_t i = 0; i < 5u * r; i++)
+            {
+                in[i] = a;
+            }
+            cic_decim_init(&c, r);
+            size_t m = cic_decim_process(&c, in, out, 5u * r);
+            if (m != 5 || out[4] != 16u * a)
+            {
+                wrong++;
+            }
+        }
+        for (size_t i = 0; i < 5u * r; i++)
+        {
+            in[i] = 4095;
+        }
+        cic_decim_init(&c, r);
+        cic_decim_process(&c, in, out, 5u * r);
+        if (out[4] != CIC_FULL_SCALE)
+        {
+            wrong++;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_oversample(void)
+{
+    oversample_t os;
+    q15_t state[2 * COUNT(golden_comp_taps)];
+    uint16_t out[GOLDEN_CIC_OUTPUTS + 1];
+    size_t n = (size_t)GOLDEN_COMP_FACTOR * GOLDEN_CIC_OUTPUTS;
+    size_t produced = 0;
+
+    CHECK(oversample_init(&os, GOLDEN_COMP_FACTOR, golden_comp_taps, COUNT(golden_comp_taps), state));
+    for (size_t done = 0, len; done < n; done += len)
+    {
+        len = next_chunk() * 5u;
+        if (len > n - done)
+        {
+            len = n - done;
+        }
+        produced += oversample_process(&os, &golden_cic50_in[done], &out[produced], len);
+    }
+    CHECK_EQ(produced, GOLDEN_CIC_OUTPUTS);
+    CHECK_EQ(mismatches_u16(out, golden_oversample_out, GOLDEN_CIC_OUTPUTS), 0);
+}
+
+static void test_adc_conversion(void)
+{
+    uint16_t codes[4096];
+    q15_t q[4096];
+    for (uint32_t i = 0; i < 4096; i++)
+    {
+        codes[i] = (uint16_t)i;
+    }
+    q15_from_adc12(codes, q, 4096);
+    CHECK_EQ(q[0], -32768);
+    CHECK_EQ(q[2048], 0);
+    CHECK_EQ(q[4095], 32752);
+    q15_to_adc12(q, codes, 4096);
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < 4096; i++)
+    {
+        wrong += (codes[i] != i);
+    }
+    CHECK_EQ(wrong, 0);
+
+    // Out of the 12-bit range after filtering: clamped
+    q15_t edge[2] = {32767, -32768};
+    q15_to_adc12(edge, codes, 2);
+    CHECK_EQ(codes[0], 4095);
+    CHECK_EQ(codes[1], 0);
+}
+
+int main(void)
+{
+    test_fir();
+    test_decimator();
+    test_biquad();
+    test_cic();
+    test_oversample();
+    test_adc_conversion();
+    return host_test_result("test_fixed_filter");
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_oversample_enob.c
+ * @brief Effective resolution gained by the CIC decimator on a noisy synthetic sine.
+ *
+ * @details
+ * A 0.9 full-scale sine with Gaussian noise is quantized to 12-bit codes at 500 kS/s and
+ * decimated by each factor from 4 to 256. The effective number of bits of the input and of
+ * each output comes from a least-squares fit of a sine at the known frequency:
+ * ENOB = (SINAD - 1.76) / 6.02, with SINAD the power of a full-scale sine over the power of
+ * the residual. The sine sits at fs_out / 20.3, in the passband at every factor.
+ *
+ * White noise averaged over R conversions loses a factor R of its power, half a bit per
+ * doubling of R. The CIC's sinc^4 response also removes part of the noise below fs_out / 2,
+ * so it should do at least that well, up to the 16-bit output (ADC code * 16). At 256 the
+ * output must reach 14 bits with 1 LSB of noise and 15 with 0.5 LSB.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "fixed_filter.h"
+#include "host_test.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+#define INPUT_RATE_HZ 500000.0 ///< The ADC's full rate.
+#define AMPLITUDE 1843.0       ///< 0.9 of full scale, in ADC codes.
+#define OUTPUTS 4096u          ///< Outputs fitted per factor.
+#define SETTLE 8u              ///< Outputs dropped while the combs fill.
+#define CHUNK 777u             ///< Inputs per call; not a multiple of any factor.
+
+static uint16_t input[CHUNK];
+static uint16_t output[CHUNK / CIC_MIN_FACTOR + 1];
+static double fitted[OUTPUTS];
+
+/**
+ * @brief Gaussian sample from rand(), Box-Muller.
+ */
+static double gaussian(void)
+{
+    double u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    double u2 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Least-squares fit of a + b cos + c sin at a known frequency.
+ *
+ * @param x Samples.
+ * @param n Number of samples.
+ * @param cycles Cycles per sample of the sine.
+ * @param amplitude Output: amplitude of the fitted sine.
+ * @return double rms of the residual.
+ */
+static double fit_sine(const double *x, size_t n, double cycles, double *amplitude)
+{
+    double m[3][4] = {{0}};
+    for (size_t k = 0; k < n; k++)
+    {
+        double r[3] = {1.0, cos(2.0 * M_PI * cycles * k), sin(2.0 * M_PI * cycles * k)};
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                m[i][j] += r[i] * r[j];
+            }
+            m[i][3] += r[i] * x[k];
+        }
+    }
+
+    // Gaussian elimination on the normal equations
+    double p[3];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = i + 1; j < 3; j++)
+        {
+            double f = m[j][i] / m[i][i];
+            for (int k = i; k < 4; k++)
+            {
+                m[j][k] -= f * m[i][k];
+            }
+        }
+    }
+    for (int i = 2; i >= 0; i--)
+    {
+        p[i] = m[i][3];
+        for (int j = i + 1; j < 3; j++)
+        {
+            p[i] -= m[i][j] * p[j];
+        }
+        p[i] /= m[i][i];
+    }
+    *amplitude = hypot(p[1], p[2]);
+
+    double power = 0.0;
+    for (size_t k = 0; k < n; k++)
+    {
+        double e = x[k] - p[0] - p[1] * cos(2.0 * M_PI * cycles * k) - p[2] * sin(2.0 * M_PI * cycles * k);
+        power += e * e;
+    }
+    return sqrt(power / (double)n);
+}
+
+/**
+ * @brief Effective bits of a full-scale (4096-code) sine against an error of this rms, in codes.
+ */
+static double enob(double rms)
+{
+    double sinad = 20.0 * log10(2048.0 / sqrt(2.0) / rms);
+    return (sinad - 1.76) / 6.02;
+}
+
+/**
+ * @brief Fills a chunk of 12-bit conversions of the noisy sine.
+ */
+static void convert(uint16_t *x, size_t n, uint64_t *t, double freq_hz, double noise)
+{
+    for (size_t i = 0; i < n; i++, (*t)++)
+    {
+        double v = 2048.0 + AMPLITUDE * sin(2.0 * M_PI * freq_hz * (double)*t / INPUT_RATE_HZ) + noise * gaussian();
+        v = floor(v + 0.5);
+        x[i] = (uint16_t)(v < 0.0 ? 0.0 : v > 4095.0 ? 4095.0 : v);
+    }
+}
+
+/**
+ * @brief ENOB of the conversions themselves.
+ */
+static double input_enob(double noise)
+{
+    uint64_t t = 0;
+    double freq = INPUT_RATE_HZ / 4 / 20.3;
+    for (size_t done = 0; done < OUTPUTS; done += CHUNK)
+    {
+        size_t n = (OUTPUTS - done < CHUNK) ? OUTPUTS - done : CHUNK;
+        convert(input, n, &t, freq, noise);
+        for (size_t i = 0; i < n; i++)
+        {
+            fitted[done + i] = input[i];
+        }
+    }
+    double amplitude;
+    return enob(fit_sine(fitted, OUTPUTS, freq / INPUT_RATE_HZ, &amplitude));
+}
+
+/**
+ * @brief ENOB of the CIC output at one factor.
+ */
+static double cic_enob(uint16_t factor, double noise)
+{
+    cic_decim_t c;
+    CHECK(cic_decim_init(&c, factor));
+
+    double out_rate = INPUT_RATE_HZ / factor;
+    double freq = out_rate / 20.3;
+    uint64_t t = 0;
+    size_t produced = 0;
+    while (produced < SETTLE + OUTPUTS)
+    {
+        convert(input, CHUNK, &t, freq, noise);
+        size_t m = cic_decim_process(&c, input, output, CHUNK);
+        for (size_t i = 0; i < m && produced < SETTLE + OUTPUTS; i++, produced++)
+        {
+            if (produced >= SETTLE)
+            {
+                fitted[produced - SETTLE] = output[i] / 16.0;
+            }
+        }
+    }
+
+    // The gain is the sinc^4 droop at the sine's frequency (0.14 dB; the compensation FIR
+    // is not part of this test)
+    double amplitude;
+    double rms = fit_sine(fitted, OUTPUTS, freq / out_rate, &amplitude);
+    double w = M_PI * freq / INPUT_RATE_HZ;
+    double droop = 4.0 * 20.0 * log10(sin(w * factor) / (factor * sin(w)));
+    CHECK_RANGE(20.0 * log10(amplitude / AMPLITUDE) - droop, -0.01, 0.01);
+    return enob(rms);
+}
+
+static void test_enob(void)
+{
+    static const uint16_t factors[] = {4u, 8u, 16u, 32u, 50u, 64u, 128u, 256u};
+
+    double in = input_enob(1.0);
+    CHECK_RANGE(in, 9.9, 10.4);
+
+    double last = in;
+    for (size_t i = 0; i < COUNT(factors); i++)
+    {
+        double bits = cic_enob(factors[i], 1.0);
+        fprintf(stderr, "  R = %3u: %.2f -> %.2f effective bits\n", factors[i], in, bits);
+        CHECK(bits >= in + 0.5 * log2(factors[i]) - 0.1);
+        CHECK(bits > last);
+        last = bits;
+    }
+    CHECK(last >= 14.0);
+
+    // With less noise the resolution gets closer to the 16-bit output
+    double quiet_in = input_enob(0.5);
+    double quiet = cic_enob(256u, 0.5);
+    fprintf(stderr, "  R = 256, 0.5 LSB of noise: %.2f -> %.2f effective bits\n", quiet_in, quiet);
+    CHECK(quiet >= 15.0);
+}
+
+int main(void)
+{
+    srand(25);
+
+    test_enob();
+
+    return host_test_result("oversample_enob");
+}
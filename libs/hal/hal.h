@@ -0,0 +1,222 @@
+/**
+ * @file hal.h
+ * @brief Thin hardware abstraction for the main loops: time, timers, ADC, PWM, GPIO, UART
+ * and I2C.
+ *
+ * @details
+ * The calls map one to one onto the Pico SDK functions the programs used directly
+ * (adc_read(), add_repeating_timer_us(), pwm_set_chan_level(), i2c_read_blocking(), ...)
+ * and have two backends:
+ *
+ * - hal_pico.c, on the RP2040, a direct wrapper of the SDK.
+ * - hal_sim.c, on a Linux host (built with HAL_HOST), a deterministic simulator with a
+ *   virtual clock, scripted ADC waveforms, UART byte sinks and I2C device models
+ *   (hal_sim.h).
+ *
+ * Only the parts of a program that the simulator can model go through the HAL; DMA, PIO
+ * and multicore engines stay behind `#ifndef HAL_HOST`.
+ *
+ * On the host, time only moves in hal_sleep_us(), hal_idle() and the blocking transfers,
+ * which take as long as they would on the wire. A main loop that polls a flag must call
+ * hal_idle() once per pass, or its timers never fire.
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifndef HAL_HOST
+#include "pico/time.h"
+#endif
+
+#define HAL_ERROR -1 ///< I2C transfer not acknowledged (PICO_ERROR_GENERIC).
+
+#define HAL_ADC_BITS 12u      ///< ADC resolution.
+#define HAL_ADC_GPIO_BASE 26u ///< GPIO of ADC input 0; inputs 0-3 are GPIO26-29.
+
+#ifdef HAL_HOST
+#define HAL_CYCLES_MASK 0xFFFFFFFFu ///< hal_cycles() counts 32 bits.
+#else
+#define HAL_CYCLES_MASK 0x00FFFFFFu ///< hal_cycles() counts 24 bits (SysTick).
+#endif
+
+typedef struct hal_timer hal_timer_t;
+
+/**
+ * @brief Repeating timer callback, run in interrupt context.
+ *
+ * @return true to keep the timer running.
+ */
+typedef bool (*hal_timer_cb_t)(hal_timer_t *t);
+
+struct hal_timer
+{
+#ifdef HAL_HOST
+    uint64_t period_ns; ///< Time between two calls.
+    uint64_t due_ns;    ///< Virtual time of the next call.
+    hal_timer_t *next;  ///< Next active timer.
+#else
+    repeating_timer_t rt; ///< SDK timer.
+#endif
+    hal_timer_cb_t cb; ///< Callback.
+    void *user;        ///< Free for the callback.
+};
+
+/**
+ * @brief Initializes stdio, and on the host the simulator from the environment (hal_sim.h).
+ */
+void hal_init(void);
+
+/**
+ * @brief Microseconds since boot.
+ */
+uint64_t hal_time_us(void);
+
+/**
+ * @brief Lower 32 bits of hal_time_us().
+ */
+static inline uint32_t hal_time_us_32(void)
+{
+    return (uint32_t)hal_time_us();
+}
+
+/**
+ * @brief Free-running counter for timing code: clk_sys cycles from SysTick on the RP2040,
+ * nanoseconds of the calling thread's CPU time on the host.
+ *
+ * The difference of two readings, masked with HAL_CYCLES_MASK, is the count between them
+ * as long as it is less than one wrap (134 ms at 125 MHz on the RP2040). On the host the
+ * count is real CPU time; the virtual clock does not move.
+ */
+uint32_t hal_cycles(void);
+
+/**
+ * @brief Rate of hal_cycles() in Hz.
+ */
+uint32_t hal_cycles_hz(void);
+
+/**
+ * @brief Waits, running any timers that fall due.
+ */
+void hal_sleep_us(uint64_t us);
+
+/**
+ * @brief One pass of a polling loop: tight_loop_contents() on the RP2040, a short step of
+ * virtual time on the host.
+ */
+void hal_idle(void);
+
+/**
+ * @brief Starts a repeating timer called every period_us, start to start.
+ *
+ * @param t Timer storage, must stay valid while it runs.
+ * @param period_us Period in microseconds.
+ * @param cb Callback.
+ * @param user Stored in t->user.
+ * @return true if the timer was started.
+ */
+bool hal_timer_start(hal_timer_t *t, uint32_t period_us, hal_timer_cb_t cb, void *user);
+
+/**
+ * @brief Stops a repeating timer.
+ */
+void hal_timer_stop(hal_timer_t *t);
+
+/**
+ * @brief Initializes the ADC and the GPIO of an input.
+ *
+ * @param input ADC input 0-3 (GPIO26-29).
+ */
+void hal_adc_init(uint8_t input);
+
+/**
+ * @brief Selects the input used by hal_adc_read().
+ */
+void hal_adc_select(uint8_t input);
+
+/**
+ * @brief One blocking 12-bit conversion of the selected input (2 us).
+ */
+uint16_t hal_adc_read(void);
+
+/**
+ * @brief Starts PWM on a GPIO with the slice counting 0 .. wrap at clk_sys.
+ *
+ * @param gpio GPIO pin.
+ * @param wrap Counter top value.
+ * @param level Initial compare level.
+ */
+void hal_pwm_init(uint8_t gpio, uint16_t wrap, uint16_t level);
+
+/**
+ * @brief Sets the compare level of a GPIO's PWM channel; it takes effect at the next wrap.
+ */
+void hal_pwm_set_level(uint8_t gpio, uint16_t level);
+
+/**
+ * @brief Makes a GPIO an output, driven low.
+ */
+void hal_gpio_init_out(uint8_t gpio);
+
+/**
+ * @brief Drives an output GPIO.
+ */
+void hal_gpio_put(uint8_t gpio, bool value);
+
+/**
+ * @brief Writes bytes to stdio with no newline translation.
+ */
+void hal_stdio_write(const uint8_t *data, size_t len);
+
+/**
+ * @brief Reads one stdio character.
+ *
+ * @param timeout_us Time to wait, 0 to only check.
+ * @return int The character, or -1 if none arrived.
+ */
+int hal_stdio_getc(uint32_t timeout_us);
+
+/**
+ * @brief Initializes a UART, 8N1, on its TX and RX pins.
+ *
+ * @param port UART 0 or 1.
+ * @param baud Baud rate.
+ * @param tx_pin TX GPIO.
+ * @param rx_pin RX GPIO, or -1 for none.
+ */
+void hal_uart_init(uint8_t port, uint32_t baud, uint8_t tx_pin, int rx_pin);
+
+/**
+ * @brief Writes bytes to a UART and waits until they are in its FIFO.
+ */
+void hal_uart_write(uint8_t port, const uint8_t *data, size_t len);
+
+/**
+ * @brief Initializes an I2C controller on its SDA and SCL pins.
+ *
+ * @param port I2C 0 or 1.
+ * @param baud Bus clock in Hz.
+ * @param sda_pin SDA GPIO.
+ * @param scl_pin SCL GPIO.
+ */
+void hal_i2c_init(uint8_t port, uint32_t baud, uint8_t sda_pin, uint8_t scl_pin);
+
+/**
+ * @brief Blocking I2C write, as i2c_write_blocking().
+ *
+ * @param nostop Keep the bus for a repeated start.
+ * @return int Bytes written, or HAL_ERROR if the address was not acknowledged.
+ */
+int hal_i2c_write(uint8_t port, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+/**
+ * @brief Blocking I2C read, as i2c_read_blocking().
+ *
+ * @return int Bytes read, or HAL_ERROR if the address was not acknowledged.
+ */
+int hal_i2c_read(uint8_t port, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif // HAL_H
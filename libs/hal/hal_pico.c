@@ -0,0 +1,163 @@
+/**
+ * @file hal_pico.c
+ * @brief RP2040 backend of the HAL, a direct wrapper of the Pico SDK.
+ */
+
+#include "hal.h"
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/pwm.h"
+#include "hardware/uart.h"
+#include "hardware/i2c.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+void hal_init(void)
+{
+    stdio_init_all();
+
+    // SysTick free-running from the processor clock, with no interrupt
+    systick_hw->csr = 0;
+    systick_hw->rvr = HAL_CYCLES_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+uint64_t hal_time_us(void)
+{
+    return time_us_64();
+}
+
+uint32_t hal_cycles(void)
+{
+    // SysTick counts down
+    return HAL_CYCLES_MASK - systick_hw->cvr;
+}
+
+uint32_t hal_cycles_hz(void)
+{
+    return clock_get_hz(clk_sys);
+}
+
+void hal_sleep_us(uint64_t us)
+{
+    sleep_us(us);
+}
+
+void hal_idle(void)
+{
+    tight_loop_contents();
+}
+
+/**
+ * @brief Passes the SDK timer's call on to the HAL callback.
+ */
+static bool timer_trampoline(repeating_timer_t *rt)
+{
+    hal_timer_t *t = rt->user_data;
+    return t->cb(t);
+}
+
+bool hal_timer_start(hal_timer_t *t, uint32_t period_us, hal_timer_cb_t cb, void *user)
+{
+    t->cb = cb;
+    t->user = user;
+    // A negative delay keeps the period from one call's start to the next
+    return add_repeating_timer_us(-(int64_t)period_us, timer_trampoline, t, &t->rt);
+}
+
+void hal_timer_stop(hal_timer_t *t)
+{
+    cancel_repeating_timer(&t->rt);
+}
+
+void hal_adc_init(uint8_t input)
+{
+    adc_init();
+    adc_gpio_init(HAL_ADC_GPIO_BASE + input);
+    adc_select_input(input);
+}
+
+void hal_adc_select(uint8_t input)
+{
+    adc_select_input(input);
+}
+
+uint16_t hal_adc_read(void)
+{
+    return adc_read();
+}
+
+void hal_pwm_init(uint8_t gpio, uint16_t wrap, uint16_t level)
+{
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    pwm_set_wrap(slice, wrap);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(gpio), level);
+    pwm_set_enabled(slice, true);
+}
+
+void hal_pwm_set_level(uint8_t gpio, uint16_t level)
+{
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+void hal_gpio_init_out(uint8_t gpio)
+{
+    gpio_init(gpio);
+    gpio_put(gpio, false);
+    gpio_set_dir(gpio, GPIO_OUT);
+}
+
+void hal_gpio_put(uint8_t gpio, bool value)
+{
+    gpio_put(gpio, value);
+}
+
+void hal_stdio_write(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        putchar_raw(data[i]);
+    }
+}
+
+int hal_stdio_getc(uint32_t timeout_us)
+{
+    int c = getchar_timeout_us(timeout_us);
+    return c == PICO_ERROR_TIMEOUT ? -1 : c;
+}
+
+void hal_uart_init(uint8_t port, uint32_t baud, uint8_t tx_pin, int rx_pin)
+{
+    uart_init(uart_get_instance(port), baud);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+    if (rx_pin >= 0)
+    {
+        gpio_set_function((uint)rx_pin, GPIO_FUNC_UART);
+    }
+}
+
+void hal_uart_write(uint8_t port, const uint8_t *data, size_t len)
+{
+    uart_write_blocking(uart_get_instance(port), data, len);
+}
+
+void hal_i2c_init(uint8_t port, uint32_t baud, uint8_t sda_pin, uint8_t scl_pin)
+{
+    i2c_init(i2c_get_instance(port), baud);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+}
+
+int hal_i2c_write(uint8_t port, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    int n = i2c_write_blocking(i2c_get_instance(port), addr, src, len, nostop);
+    return n < 0 ? HAL_ERROR : n;
+}
+
+int hal_i2c_read(uint8_t port, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+    int n = i2c_read_blocking(i2c_get_instance(port), addr, dst, len, nostop);
+    return n < 0 ? HAL_ERROR : n;
+}
@@ -0,0 +1,649 @@
+/**
+ * @file hal_sim.c
+ * @brief Host backend of the HAL: virtual clock, timers, scripted ADC inputs, UART sinks
+ * and I2C device models.
+ */
+
+#define _POSIX_C_SOURCE 199309L // clock_gettime()
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hal_sim.h"
+
+#define NS_PER_US 1000u
+#define NS_PER_S 1000000000u
+#define UART_FIFO_DEPTH 32u // Bytes the UART TX FIFO holds before a write has to wait
+#define UART_CHAR_BITS 10u  // 8N1
+#define I2C_BYTE_BITS 9u    // 8 data bits and the ACK
+#define I2C_FRAME_BITS 2u   // START and STOP
+#define DEFAULT_RUN_S 10u
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static struct
+{
+    uint64_t now_ns;
+    uint64_t end_ns;
+    hal_sim_end_t on_end;
+    void *end_user;
+    bool ended;
+
+    hal_timer_t *timers;
+    bool in_timer;
+
+    hal_sim_wave_t wave[HAL_SIM_ADC_INPUTS];
+    uint8_t adc_input;
+    uint32_t rng;
+
+    hal_sim_sink_t sink[HAL_SIM_PORTS];
+    void *sink_user[HAL_SIM_PORTS];
+    uint32_t uart_baud[2];
+    uint64_t uart_done_ns[2]; // Time the last byte written leaves the shifter
+
+    uint32_t i2c_baud[HAL_SIM_I2C_PORTS];
+    hal_sim_i2c_dev_t *i2c[HAL_SIM_I2C_PORTS];
+
+    uint8_t input[HAL_SIM_INPUT_LEN];
+    size_t input_head;
+    size_t input_tail;
+
+    uint16_t pwm_level[HAL_SIM_GPIOS];
+    bool gpio[HAL_SIM_GPIOS];
+
+    hal_sim_stats_t stats;
+} sim;
+
+/**
+ * @brief Default end of a run: summary on stderr, then exit.
+ */
+static void default_end(void *user)
+{
+    (void)user;
+    const hal_sim_stats_t *s = &sim.stats;
+    fflush(stdout);
+    fprintf(stderr,
+            "hal_sim: %.6f s, stdio %llu B, uart0 %llu B, uart1 %llu B, %llu ADC reads, %llu timer calls"
+            " (%.3f us late on average), %u I2C transfers, %u NACKs\n",
+            (double)sim.now_ns / NS_PER_S, (unsigned long long)s->bytes[HAL_SIM_PORT_STDIO],
+            (unsigned long long)s->bytes[0], (unsigned long long)s->bytes[1], (unsigned long long)s->adc_reads,
+            (unsigned long long)s->timer_calls,
+            s->timer_calls ? (double)s->late_ns / NS_PER_US / (double)s->timer_calls : 0.0, s->i2c_transfers,
+            s->i2c_nacks);
+    exit(0);
+}
+
+static void check_end(void)
+{
+    if (!sim.ended && sim.end_ns && sim.now_ns >= sim.end_ns)
+    {
+        sim.ended = true;
+        sim.on_end(sim.end_user);
+    }
+}
+
+/**
+ * @brief Moves the clock to target, running the timers due on the way.
+ *
+ * Inside a timer callback the clock moves but no other timer runs, as with interrupts of
+ * the same priority.
+ */
+static void run_until(uint64_t target)
+{
+    while (!sim.in_timer)
+    {
+        hal_timer_t *due = NULL;
+        for (hal_timer_t *t = sim.timers; t; t = t->next)
+        {
+            if (t->due_ns <= target && (!due || t->due_ns < due->due_ns))
+            {
+                due = t;
+            }
+        }
+        if (!due)
+        {
+            break;
+        }
+
+        // A callback that overran leaves the next one late
+        if (due->due_ns > sim.now_ns)
+        {
+            sim.now_ns = due->due_ns;
+        }
+        check_end();
+        sim.stats.late_ns += sim.now_ns - due->due_ns;
+        sim.stats.timer_calls++;
+
+        sim.in_timer = true;
+        bool keep = due->cb(due);
+        sim.in_timer = false;
+
+        if (keep)
+        {
+            due->due_ns += due->period_ns;
+        }
+        else
+        {
+            hal_timer_stop(due);
+        }
+    }
+
+    // The run ends at end_ns, even in the middle of a wait
+    if (!sim.ended && sim.end_ns && target > sim.end_ns)
+    {
+        target = sim.end_ns;
+    }
+    if (target > sim.now_ns)
+    {
+        sim.now_ns = target;
+    }
+    check_end();
+}
+
+/**
+ * @brief xorshift32, uniform in [-1, 1).
+ */
+static double noise_unit(void)
+{
+    uint32_t x = sim.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim.rng = x;
+    return (double)x / 2147483648.0 - 1.0;
+}
+
+/**
+ * @brief Level of an input's waveform at the current time, in ADC counts.
+ */
+static uint16_t wave_sample(const hal_sim_wave_t *w)
+{
+    double t = (double)sim.now_ns / NS_PER_S;
+    double phase = w->freq_hz * t - floor(w->freq_hz * t);
+    double v = w->offset;
+
+    switch (w->kind)
+    {
+    case HAL_SIM_DC:
+        break;
+    case HAL_SIM_SINE:
+        v += w->amplitude * sin(2.0 * M_PI * phase);
+        break;
+    case HAL_SIM_SQUARE:
+        v += phase < 0.5 ? w->amplitude : -w->amplitude;
+        break;
+    case HAL_SIM_RAMP:
+        v += w->amplitude * (2.0 * phase - 1.0);
+        break;
+    case HAL_SIM_TABLE:
+        if (w->table_len && w->table_period_us)
+        {
+            uint64_t i = sim.now_ns / ((uint64_t)w->table_period_us * NS_PER_US);
+            v = w->table[i % w->table_len];
+        }
+        break;
+    }
+
+    if (w->noise > 0.0)
+    {
+        v += w->noise * noise_unit();
+    }
+
+    double max = (double)((1u << HAL_ADC_BITS) - 1u);
+    if (v < 0.0)
+    {
+        v = 0.0;
+    }
+    if (v > max)
+    {
+        v = max;
+    }
+    return (uint16_t)(v + 0.5);
+}
+
+void hal_sim_reset(void)
+{
+    memset(&sim, 0, sizeof(sim));
+    sim.end_ns = (uint64_t)DEFAULT_RUN_S * NS_PER_S;
+    sim.on_end = default_end;
+    sim.rng = 1u;
+    for (uint8_t i = 0; i < HAL_SIM_ADC_INPUTS; i++)
+    {
+        sim.wave[i].kind = HAL_SIM_DC;
+        sim.wave[i].offset = (double)(1u << (HAL_ADC_BITS - 1u));
+    }
+    sim.sink[HAL_SIM_PORT_STDIO] = hal_sim_sink_file;
+    sim.sink_user[HAL_SIM_PORT_STDIO] = stdout;
+}
+
+uint64_t hal_sim_now_ns(void)
+{
+    return sim.now_ns;
+}
+
+void hal_sim_advance_ns(uint64_t ns)
+{
+    run_until(sim.now_ns + ns);
+}
+
+void hal_sim_set_end(uint64_t end_us, hal_sim_end_t on_end, void *user)
+{
+    sim.end_ns = end_us * NS_PER_US;
+    sim.on_end = on_end ? on_end : default_end;
+    sim.end_user = user;
+    sim.ended = false;
+}
+
+void hal_sim_adc_wave(uint8_t input, const hal_sim_wave_t *w)
+{
+    if (input < HAL_SIM_ADC_INPUTS)
+    {
+        sim.wave[input] = *w;
+    }
+}
+
+void hal_sim_seed(uint32_t seed)
+{
+    // xorshift never leaves 0
+    sim.rng = seed ? seed : 1u;
+}
+
+void hal_sim_sink(uint8_t port, hal_sim_sink_t sink, void *user)
+{
+    if (port < HAL_SIM_PORTS)
+    {
+        sim.sink[port] = sink;
+        sim.sink_user[port] = user;
+    }
+}
+
+void hal_sim_sink_file(uint8_t port, const uint8_t *data, size_t len, void *user)
+{
+    (void)port;
+    fwrite(data, 1, len, (FILE *)user);
+}
+
+size_t hal_sim_input(const uint8_t *data, size_t len)
+{
+    size_t n = 0;
+    while (n < len && sim.input_head - sim.input_tail < HAL_SIM_INPUT_LEN)
+    {
+        sim.input[sim.input_head++ % HAL_SIM_INPUT_LEN] = data[n++];
+    }
+    return n;
+}
+
+void hal_sim_i2c_attach(uint8_t port, hal_sim_i2c_dev_t *d)
+{
+    d->next = sim.i2c[port];
+    sim.i2c[port] = d;
+}
+
+uint16_t hal_sim_pwm_level(uint8_t gpio)
+{
+    return gpio < HAL_SIM_GPIOS ? sim.pwm_level[gpio] : 0;
+}
+
+bool hal_sim_gpio(uint8_t gpio)
+{
+    return gpio < HAL_SIM_GPIOS && sim.gpio[gpio];
+}
+
+const hal_sim_stats_t *hal_sim_stats(void)
+{
+    return &sim.stats;
+}
+
+/**
+ * @brief Parses `kind,offset,amplitude,freq_hz[,noise]`.
+ */
+static bool parse_wave(const char *spec, hal_sim_wave_t *w)
+{
+    static const struct
+    {
+        const char *name;
+        hal_sim_wave_kind_t kind;
+    } kinds[] = {
+        {"dc", HAL_SIM_DC},
+        {"sine", HAL_SIM_SINE},
+        {"square", HAL_SIM_SQUARE},
+        {"ramp", HAL_SIM_RAMP},
+    };
+
+    char name[8];
+    double v[4] = {0.0, 0.0, 0.0, 0.0};
+    int n = sscanf(spec, "%7[a-z],%lf,%lf,%lf,%lf", name, &v[0], &v[1], &v[2], &v[3]);
+    if (n < 2)
+    {
+        return false;
+    }
+
+    memset(w, 0, sizeof(*w));
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++)
+    {
+        if (strcmp(name, kinds[i].name) == 0)
+        {
+            w->kind = kinds[i].kind;
+            w->offset = v[0];
+            w->amplitude = v[1];
+            w->freq_hz = v[2];
+            w->noise = v[3];
+            return true;
+        }
+    }
+    return false;
+}
+
+int hal_sim_configure_env(void)
+{
+    char var[16];
+    const char *s;
+
+    if ((s = getenv("HAL_SIM_SECONDS")) != NULL)
+    {
+        double seconds = strtod(s, NULL);
+        if (seconds <= 0.0)
+        {
+            fprintf(stderr, "hal_sim: bad HAL_SIM_SECONDS '%s'\n", s);
+            return -1;
+        }
+        sim.end_ns = (uint64_t)(seconds * NS_PER_S);
+    }
+
+    if ((s = getenv("HAL_SIM_SEED")) != NULL)
+    {
+        hal_sim_seed((uint32_t)strtoul(s, NULL, 0));
+    }
+
+    for (uint8_t i = 0; i < HAL_SIM_ADC_INPUTS; i++)
+    {
+        snprintf(var, sizeof(var), "HAL_SIM_ADC%u", i);
+        if ((s = getenv(var)) != NULL)
+        {
+            hal_sim_wave_t w;
+            if (!parse_wave(s, &w))
+            {
+                fprintf(stderr, "hal_sim: bad %s '%s'\n", var, s);
+                return -1;
+            }
+            hal_sim_adc_wave(i, &w);
+        }
+    }
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        snprintf(var, sizeof(var), "HAL_SIM_UART%u", i);
+        if ((s = getenv(var)) != NULL)
+        {
+            FILE *f = strcmp(s, "-") == 0 ? stdout : fopen(s, "wb");
+            if (f == NULL)
+            {
+                fprintf(stderr, "hal_sim: cannot open %s '%s'\n", var, s);
+                return -1;
+            }
+            hal_sim_sink(i, hal_sim_sink_file, f);
+        }
+    }
+
+    if ((s = getenv("HAL_SIM_INPUT")) != NULL)
+    {
+        hal_sim_input((const uint8_t *)s, strlen(s));
+    }
+    return 0;
+}
+
+void hal_init(void)
+{
+    hal_sim_reset();
+    if (hal_sim_configure_env() != 0)
+    {
+        exit(2);
+    }
+}
+
+uint64_t hal_time_us(void)
+{
+    return sim.now_ns / NS_PER_US;
+}
+
+uint32_t hal_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * NS_PER_S + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t hal_cycles_hz(void)
+{
+    return NS_PER_S;
+}
+
+void hal_sleep_us(uint64_t us)
+{
+    run_until(sim.now_ns + us * NS_PER_US);
+}
+
+void hal_idle(void)
+{
+    run_until(sim.now_ns + HAL_SIM_IDLE_US * NS_PER_US);
+}
+
+bool hal_timer_start(hal_timer_t *t, uint32_t period_us, hal_timer_cb_t cb, void *user)
+{
+    if (period_us == 0)
+    {
+        return false;
+    }
+    t->period_ns = (uint64_t)period_us * NS_PER_US;
+    t->due_ns = sim.now_ns + t->period_ns;
+    t->cb = cb;
+    t->user = user;
+    t->next = sim.timers;
+    sim.timers = t;
+    return true;
+}
+
+void hal_timer_stop(hal_timer_t *t)
+{
+    for (hal_timer_t **p = &sim.timers; *p; p = &(*p)->next)
+    {
+        if (*p == t)
+        {
+            *p = t->next;
+            return;
+        }
+    }
+}
+
+void hal_adc_init(uint8_t input)
+{
+    sim.adc_input = input;
+}
+
+void hal_adc_select(uint8_t input)
+{
+    sim.adc_input = input < HAL_SIM_ADC_INPUTS ? input : 0;
+}
+
+uint16_t hal_adc_read(void)
+{
+    // Sampled at the start of the conversion
+    uint16_t v = wave_sample(&sim.wave[sim.adc_input]);
+    sim.stats.adc_reads++;
+    run_until(sim.now_ns + HAL_SIM_ADC_CONV_US * NS_PER_US);
+    return v;
+}
+
+void hal_pwm_init(uint8_t gpio, uint16_t wrap, uint16_t level)
+{
+    (void)wrap;
+    hal_pwm_set_level(gpio, level);
+}
+
+void hal_pwm_set_level(uint8_t gpio, uint16_t level)
+{
+    if (gpio < HAL_SIM_GPIOS)
+    {
+        sim.pwm_level[gpio] = level;
+    }
+}
+
+void hal_gpio_init_out(uint8_t gpio)
+{
+    hal_gpio_put(gpio, false);
+}
+
+void hal_gpio_put(uint8_t gpio, bool value)
+{
+    if (gpio < HAL_SIM_GPIOS)
+    {
+        sim.gpio[gpio] = value;
+    }
+}
+
+/**
+ * @brief Counts the bytes of a port and hands them to its sink.
+ */
+static void emit(uint8_t port, const uint8_t *data, size_t len)
+{
+    sim.stats.bytes[port] += len;
+    if (sim.sink[port])
+    {
+        sim.sink[port](port, data, len, sim.sink_user[port]);
+    }
+}
+
+void hal_stdio_write(const uint8_t *data, size_t len)
+{
+    // USB CDC is taken to keep up; stdio writes take no time
+    emit(HAL_SIM_PORT_STDIO, data, len);
+}
+
+int hal_stdio_getc(uint32_t timeout_us)
+{
+    if (sim.input_head == sim.input_tail && timeout_us)
+    {
+        run_until(sim.now_ns + (uint64_t)timeout_us * NS_PER_US);
+    }
+    if (sim.input_head == sim.input_tail)
+    {
+        return -1;
+    }
+    return sim.input[sim.input_tail++ % HAL_SIM_INPUT_LEN];
+}
+
+void hal_uart_init(uint8_t port, uint32_t baud, uint8_t tx_pin, int rx_pin)
+{
+    (void)tx_pin;
+    (void)rx_pin;
+    sim.uart_baud[port] = baud;
+    sim.uart_done_ns[port] = sim.now_ns;
+}
+
+void hal_uart_write(uint8_t port, const uint8_t *data, size_t len)
+{
+    uint64_t char_ns = sim.uart_baud[port] ? (uint64_t)UART_CHAR_BITS * NS_PER_S / sim.uart_baud[port] : 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        // Wait for room in the FIFO: fewer than UART_FIFO_DEPTH bytes still to shift out
+        uint64_t room_ns = sim.uart_done_ns[port] > UART_FIFO_DEPTH * char_ns
+                               ? sim.uart_done_ns[port] - UART_FIFO_DEPTH * char_ns
+                               : 0;
+        if (room_ns > sim.now_ns)
+        {
+            run_until(room_ns);
+        }
+        if (sim.uart_done_ns[port] < sim.now_ns)
+        {
+            sim.uart_done_ns[port] = sim.now_ns;
+        }
+        sim.uart_done_ns[port] += char_ns;
+    }
+    emit(port, data, len);
+}
+
+void hal_i2c_init(uint8_t port, uint32_t baud, uint8_t sda_pin, uint8_t scl_pin)
+{
+    (void)sda_pin;
+    (void)scl_pin;
+    sim.i2c_baud[port] = baud;
+}
+
+/**
+ * @brief Finds the model at an address; the address is not acknowledged if there is none.
+ */
+static hal_sim_i2c_dev_t *i2c_find(uint8_t port, uint8_t addr)
+{
+    hal_sim_i2c_dev_t *d = sim.i2c[port];
+    while (d && d->addr != addr)
+    {
+        d = d->next;
+    }
+
+    if (d)
+    {
+        sim.stats.i2c_transfers++;
+    }
+    else
+    {
+        sim.stats.i2c_nacks++;
+    }
+    return d;
+}
+
+/**
+ * @brief Waits for a transfer's time on the bus; a NACK ends it after the address byte.
+ */
+static void i2c_wait(uint8_t port, size_t data_bytes)
+{
+    uint64_t bits = I2C_FRAME_BITS + I2C_BYTE_BITS * (1u + data_bytes);
+    if (sim.i2c_baud[port])
+    {
+        run_until(sim.now_ns + bits * NS_PER_S / sim.i2c_baud[port]);
+    }
+}
+
+int hal_i2c_write(uint8_t port, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)nostop;
+    hal_sim_i2c_dev_t *d = i2c_find(port, addr);
+    if (!d)
+    {
+        i2c_wait(port, 0);
+        return HAL_ERROR;
+    }
+    if (d->write)
+    {
+        d->write(d, src, len);
+    }
+    i2c_wait(port, len);
+    return (int)len;
+}
+
+int hal_i2c_read(uint8_t port, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+    (void)nostop;
+    hal_sim_i2c_dev_t *d = i2c_find(port, addr);
+    if (!d)
+    {
+        i2c_wait(port, 0);
+        return HAL_ERROR;
+    }
+
+    // The model answers with what it holds when the transfer starts
+    if (d->read)
+    {
+        d->read(d, dst, len);
+    }
+    else
+    {
+        memset(dst, 0xFF, len);
+    }
+    i2c_wait(port, len);
+    return (int)len;
+}
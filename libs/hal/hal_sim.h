@@ -0,0 +1,190 @@
+/**
+ * @file hal_sim.h
+ * @brief Deterministic host backend of the HAL: virtual clock, scripted ADC inputs, UART
+ * byte sinks and I2C device models.
+ *
+ * @details
+ * The simulator keeps a virtual clock in nanoseconds that starts at 0 and only moves when
+ * the program waits: hal_sleep_us(), hal_idle() (HAL_SIM_IDLE_US), an ADC conversion
+ * (HAL_SIM_ADC_CONV_US), or a UART or I2C transfer, which takes its time on the wire at the
+ * configured baud rate. Code in between takes no virtual time, so a run depends only on its
+ * inputs and is the same on every machine.
+ *
+ * Repeating timers fire in due order as the clock passes them. A callback runs like an
+ * interrupt: time it spends (e.g. in hal_adc_read()) moves the clock but does not fire
+ * other timers until it returns.
+ *
+ * Each ADC input plays a waveform (hal_sim_wave_t) evaluated at the time of the
+ * conversion, with optional uniform noise from a seeded generator, clamped to 12 bits.
+ * Bytes written to stdio or a UART go to a sink per port; by default stdio goes to stdout
+ * and the UARTs are only counted. I2C transfers are routed to the device models attached
+ * at their address; an address with no model is not acknowledged.
+ *
+ * A run ends when the clock reaches the end time: the default handler prints a summary on
+ * stderr and exits, so a firmware main loop that never returns still stops. hal_init()
+ * takes the configuration from the environment:
+ *
+ * - HAL_SIM_SECONDS: virtual run time (default 10).
+ * - HAL_SIM_ADC<n>: input n as `kind,offset,amplitude,freq_hz[,noise]`, kind one of dc,
+ *   sine, square or ramp, levels in ADC counts (default dc at 2048).
+ * - HAL_SIM_UART<n>: file the bytes of UART n are written to, `-` for stdout.
+ * - HAL_SIM_INPUT: characters waiting on stdio from the start.
+ * - HAL_SIM_SEED: noise seed (default 1).
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#define HAL_SIM_IDLE_US 1u      ///< Virtual time of one hal_idle().
+#define HAL_SIM_ADC_CONV_US 2u  ///< One conversion: 96 cycles of the 48 MHz ADC clock.
+#define HAL_SIM_ADC_INPUTS 5u   ///< Inputs 0-3 and the temperature sensor.
+#define HAL_SIM_PORT_STDIO 2u   ///< Sink index of stdio; the UARTs are 0 and 1.
+#define HAL_SIM_PORTS 3u        ///< Byte sinks: UART0, UART1 and stdio.
+#define HAL_SIM_I2C_PORTS 2u    ///< I2C controllers.
+#define HAL_SIM_GPIOS 30u       ///< GPIO pins.
+#define HAL_SIM_INPUT_LEN 256u  ///< stdio characters that can wait to be read.
+
+typedef enum hal_sim_wave_kind
+{
+    HAL_SIM_DC,     ///< offset.
+    HAL_SIM_SINE,   ///< offset + amplitude * sin(2 pi f t).
+    HAL_SIM_SQUARE, ///< offset + amplitude, then offset - amplitude, each half period.
+    HAL_SIM_RAMP,   ///< Sawtooth from offset - amplitude to offset + amplitude.
+    HAL_SIM_TABLE,  ///< table[] played back at table_period_us per sample, looping.
+} hal_sim_wave_kind_t;
+
+typedef struct hal_sim_wave
+{
+    hal_sim_wave_kind_t kind; ///< Shape.
+    double offset;            ///< Mean level in ADC counts.
+    double amplitude;         ///< Peak deviation in ADC counts.
+    double freq_hz;           ///< Frequency of the periodic shapes.
+    double noise;             ///< Peak of the uniform noise added, in ADC counts.
+    const uint16_t *table;    ///< HAL_SIM_TABLE samples.
+    size_t table_len;         ///< Samples in table.
+    uint32_t table_period_us; ///< Time each table sample is held.
+} hal_sim_wave_t;
+
+/**
+ * @brief Receives the bytes written to a port.
+ */
+typedef void (*hal_sim_sink_t)(uint8_t port, const uint8_t *data, size_t len, void *user);
+
+/**
+ * @brief Called when the clock reaches the end time; the default exits the process.
+ */
+typedef void (*hal_sim_end_t)(void *user);
+
+typedef struct hal_sim_i2c_dev hal_sim_i2c_dev_t;
+
+/**
+ * @brief I2C device model, one per address.
+ */
+struct hal_sim_i2c_dev
+{
+    uint8_t addr; ///< 7-bit address.
+    /// Receives the bytes of a write transfer.
+    void (*write)(hal_sim_i2c_dev_t *d, const uint8_t *src, size_t len);
+    /// Supplies the bytes of a read transfer.
+    void (*read)(hal_sim_i2c_dev_t *d, uint8_t *dst, size_t len);
+    void *ctx;               ///< Model state.
+    hal_sim_i2c_dev_t *next; ///< Next device on the same bus.
+};
+
+typedef struct hal_sim_stats
+{
+    uint64_t bytes[HAL_SIM_PORTS]; ///< Bytes written per port.
+    uint64_t adc_reads;            ///< ADC conversions.
+    uint64_t timer_calls;          ///< Timer callbacks run.
+    uint64_t late_ns;              ///< Total delay of timer calls past their due time.
+    uint32_t i2c_transfers;        ///< I2C transfers acknowledged.
+    uint32_t i2c_nacks;            ///< I2C transfers to an address with no model.
+} hal_sim_stats_t;
+
+/**
+ * @brief Clears the simulator: clock at 0, no timers or devices, DC inputs at mid-scale,
+ * default sinks, a 10 s run with the default end handler.
+ */
+void hal_sim_reset(void);
+
+/**
+ * @brief Current virtual time in nanoseconds.
+ */
+uint64_t hal_sim_now_ns(void);
+
+/**
+ * @brief Moves the clock forward, running the timers that fall due.
+ */
+void hal_sim_advance_ns(uint64_t ns);
+
+/**
+ * @brief Sets the end of the run.
+ *
+ * @param end_us Virtual time the run ends at, or 0 to run until the program exits.
+ * @param on_end Handler, or NULL for the default (summary on stderr, then exit(0)).
+ * @param user Passed to on_end.
+ */
+void hal_sim_set_end(uint64_t end_us, hal_sim_end_t on_end, void *user);
+
+/**
+ * @brief Sets the waveform of an ADC input; the table, if any, is not copied.
+ */
+void hal_sim_adc_wave(uint8_t input, const hal_sim_wave_t *w);
+
+/**
+ * @brief Seeds the noise generator.
+ */
+void hal_sim_seed(uint32_t seed);
+
+/**
+ * @brief Sends a port's bytes to a sink, or NULL to only count them.
+ */
+void hal_sim_sink(uint8_t port, hal_sim_sink_t sink, void *user);
+
+/**
+ * @brief Sink that writes to a FILE *, passed as user.
+ */
+void hal_sim_sink_file(uint8_t port, const uint8_t *data, size_t len, void *user);
+
+/**
+ * @brief Queues characters for hal_stdio_getc().
+ *
+ * @return size_t Characters queued; the rest did not fit.
+ */
+size_t hal_sim_input(const uint8_t *data, size_t len);
+
+/**
+ * @brief Attaches a device model to an I2C bus.
+ */
+void hal_sim_i2c_attach(uint8_t port, hal_sim_i2c_dev_t *d);
+
+/**
+ * @brief Level last set on a GPIO's PWM channel.
+ */
+uint16_t hal_sim_pwm_level(uint8_t gpio);
+
+/**
+ * @brief Level last driven on an output GPIO.
+ */
+bool hal_sim_gpio(uint8_t gpio);
+
+/**
+ * @brief Counters since the last hal_sim_reset().
+ */
+const hal_sim_stats_t *hal_sim_stats(void);
+
+/**
+ * @brief Configures the simulator from the environment (see above); called by hal_init().
+ *
+ * @return int 0, or -1 if a variable could not be parsed (reported on stderr).
+ */
+int hal_sim_configure_env(void);
+
+#endif // HAL_SIM_H
@@ -0,0 +1,121 @@
+/**
+ * @file hal_sim_tfluna.c
+ * @brief TF-Luna LiDAR model for the HAL simulator's I2C bus.
+ */
+
+#include <string.h>
+#include "hal_sim_tfluna.h"
+
+#define US_PER_S 1000000u
+
+/**
+ * @brief Frames produced up to the current virtual time at a frame rate.
+ */
+static uint64_t frames_now(const hal_sim_tfluna_t *m, uint16_t fps)
+{
+    uint64_t elapsed = hal_time_us() - m->frame_start_us;
+    return m->frame_base + (fps ? elapsed * fps / US_PER_S : 0u);
+}
+
+static void put16(uint8_t *regs, uint16_t v)
+{
+    regs[0] = (uint8_t)(v & 0xFF);
+    regs[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * @brief Latches the newest frame into the measurement block.
+ */
+static void update(hal_sim_tfluna_t *m)
+{
+    uint16_t fps = hal_sim_tfluna_fps(m);
+    uint64_t frame = frames_now(m, fps);
+    if (frame == m->frame || fps == 0)
+    {
+        return;
+    }
+    m->frame = frame;
+
+    // Time the frame was measured
+    uint64_t t_us = m->frame_start_us + (frame - m->frame_base) * US_PER_S / fps;
+    uint16_t distance = m->scene ? m->scene(t_us, m->user) : 100u;
+
+    put16(&m->regs[0x00], distance);
+    put16(&m->regs[0x02], distance ? HAL_SIM_TFLUNA_AMPLITUDE : 0u);
+    put16(&m->regs[0x04], (uint16_t)m->temp_centi);
+    put16(&m->regs[0x06], (uint16_t)(t_us / 1000u));
+}
+
+static void tfluna_write(hal_sim_i2c_dev_t *d, const uint8_t *src, size_t len)
+{
+    hal_sim_tfluna_t *m = d->ctx;
+    if (len == 0)
+    {
+        return;
+    }
+
+    update(m);
+    uint16_t fps = hal_sim_tfluna_fps(m);
+    m->ptr = src[0];
+    for (size_t i = 1; i < len; i++, m->ptr++)
+    {
+        if (m->ptr < HAL_SIM_TFLUNA_REGS)
+        {
+            m->regs[m->ptr] = src[i];
+        }
+    }
+
+    // A new rate counts from now; frames already produced are kept
+    if (hal_sim_tfluna_fps(m) != fps)
+    {
+        m->frame_base = frames_now(m, fps);
+        m->frame_start_us = hal_time_us();
+    }
+}
+
+static void tfluna_read(hal_sim_i2c_dev_t *d, uint8_t *dst, size_t len)
+{
+    hal_sim_tfluna_t *m = d->ctx;
+
+    update(m);
+    if (m->ptr == 0x00)
+    {
+        if (m->frame > m->read_frame + 1u)
+        {
+            m->frames_missed += (uint32_t)(m->frame - m->read_frame - 1u);
+        }
+        m->read_frame = m->frame;
+    }
+    m->reads++;
+
+    // Reads past the modelled registers return 0
+    for (size_t i = 0; i < len; i++, m->ptr++)
+    {
+        dst[i] = m->ptr < HAL_SIM_TFLUNA_REGS ? m->regs[m->ptr] : 0u;
+    }
+}
+
+void hal_sim_tfluna_init(hal_sim_tfluna_t *m, uint8_t addr, hal_sim_tfluna_scene_t scene, void *user)
+{
+    memset(m, 0, sizeof(*m));
+    m->dev.addr = addr;
+    m->dev.write = tfluna_write;
+    m->dev.read = tfluna_read;
+    m->dev.ctx = m;
+    m->scene = scene;
+    m->user = user;
+    m->temp_centi = 2500;
+    m->frame_start_us = hal_time_us();
+    put16(&m->regs[HAL_SIM_TFLUNA_FPS_LOW], HAL_SIM_TFLUNA_DEFAULT_FPS);
+}
+
+uint16_t hal_sim_tfluna_fps(const hal_sim_tfluna_t *m)
+{
+    return (uint16_t)(m->regs[HAL_SIM_TFLUNA_FPS_LOW] | (m->regs[HAL_SIM_TFLUNA_FPS_HIGH] << 8));
+}
+
+bool hal_sim_tfluna_ready(hal_sim_tfluna_t *m)
+{
+    update(m);
+    return m->frame > m->read_frame;
+}
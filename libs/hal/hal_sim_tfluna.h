@@ -0,0 +1,75 @@
+/**
+ * @file hal_sim_tfluna.h
+ * @brief TF-Luna LiDAR model for the HAL simulator's I2C bus.
+ *
+ * @details
+ * The model answers at its I2C address like the sensor: a write sets the register pointer
+ * (first byte) and stores any further bytes, a read returns registers from the pointer on,
+ * auto-incrementing. The measurement block (0x00 .. 0x07: distance, amplitude, temperature,
+ * tick) holds the latest frame; frames are produced every 1 / fps seconds of virtual time,
+ * and a frame's distance comes from a callback of the frame time, so a scene can be
+ * scripted (e.g. from the angle a simulated servo would be at). A distance of 0 stands for
+ * no return and is reported with amplitude 0.
+ *
+ * Writing the frame rate registers (0x26, 0x27) changes the rate from then on.
+ * hal_sim_tfluna_ready() tells whether a new frame has come since the last block read,
+ * which is what the sensor's data-ready output signals.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef HAL_SIM_TFLUNA_H
+#define HAL_SIM_TFLUNA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal_sim.h"
+
+#define HAL_SIM_TFLUNA_REGS 0x40u       ///< Modelled registers, 0x00 .. 0x3F.
+#define HAL_SIM_TFLUNA_FPS_LOW 0x26u    ///< Frame rate, low byte.
+#define HAL_SIM_TFLUNA_FPS_HIGH 0x27u   ///< Frame rate, high byte.
+#define HAL_SIM_TFLUNA_DEFAULT_FPS 100u ///< Frame rate at power-up.
+#define HAL_SIM_TFLUNA_AMPLITUDE 1000u  ///< Amplitude of a frame with a return.
+
+/**
+ * @brief Distance in cm seen at a frame time, 0 for no return.
+ */
+typedef uint16_t (*hal_sim_tfluna_scene_t)(uint64_t t_us, void *user);
+
+typedef struct hal_sim_tfluna
+{
+    hal_sim_i2c_dev_t dev;             ///< Bus attachment.
+    uint8_t regs[HAL_SIM_TFLUNA_REGS]; ///< Register file.
+    uint8_t ptr;                       ///< Register pointer.
+    uint64_t frame;                    ///< Frame held in the measurement block.
+    uint64_t frame_start_us;           ///< Time the current frame rate took effect.
+    uint64_t frame_base;               ///< Frames produced before frame_start_us.
+    uint64_t read_frame;               ///< Frame of the previous block read.
+    hal_sim_tfluna_scene_t scene;      ///< Distance callback, or NULL for a fixed 100 cm.
+    void *user;                        ///< Passed to scene.
+    int16_t temp_centi;                ///< Chip temperature reported.
+    uint32_t reads;                    ///< Read transfers.
+    uint32_t frames_missed;            ///< Frames never read, counted at each block read.
+} hal_sim_tfluna_t;
+
+/**
+ * @brief Initializes a sensor model; attach it with hal_sim_i2c_attach(port, &m->dev).
+ *
+ * @param m Pointer to the model.
+ * @param addr I2C address (0x10 by default).
+ * @param scene Distance callback, or NULL.
+ * @param user Passed to scene.
+ */
+void hal_sim_tfluna_init(hal_sim_tfluna_t *m, uint8_t addr, hal_sim_tfluna_scene_t scene, void *user);
+
+/**
+ * @brief Frame rate in Hz, from the frame rate registers.
+ */
+uint16_t hal_sim_tfluna_fps(const hal_sim_tfluna_t *m);
+
+/**
+ * @brief Whether a frame has come since the last read (the data-ready output).
+ */
+bool hal_sim_tfluna_ready(hal_sim_tfluna_t *m);
+
+#endif // HAL_SIM_TFLUNA_H
@@ -0,0 +1,79 @@
+/**
+ * @file host_test.h
+ * @brief Minimal checks for the host tests of the shared libraries.
+ *
+ * @details
+ * A test is a plain executable registered with CTest: it runs its cases with the CHECK
+ * macros, which report each failure on stderr with its location and keep going, and
+ * returns host_test_result() from main(), so CTest sees a non-zero exit status if any check
+ * failed.
+ *
+ * Header only, no Pico SDK dependency.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+static unsigned host_test_checks;   ///< Checks run.
+static unsigned host_test_failures; ///< Checks that failed.
+
+/**
+ * @brief Checks a condition.
+ */
+#define CHECK(cond)                                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        host_test_checks++;                                                             \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            host_test_failures++;                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);    \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief Checks that two integers are equal, printing both if they are not.
+ */
+#define CHECK_EQ(a, b)                                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        long long host_test_a = (long long)(a);                                         \
+        long long host_test_b = (long long)(b);                                         \
+        host_test_checks++;                                                             \
+        if (host_test_a != host_test_b)                                                 \
+        {                                                                               \
+            host_test_failures++;                                                       \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, \
+                    __LINE__, #a, #b, host_test_a, host_test_b);                        \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief Checks that a floating point value lies within [lo, hi].
+ */
+#define CHECK_RANGE(x, lo, hi)                                                          \
+    do                                                                                  \
+    {                                                                                   \
+        double host_test_x = (double)(x);                                               \
+        host_test_checks++;                                                             \
+        if (!(host_test_x >= (double)(lo) && host_test_x <= (double)(hi)))              \
+        {                                                                               \
+            host_test_failures++;                                                       \
+            fprintf(stderr, "%s:%d: CHECK_RANGE(%s) failed: %g not in [%g, %g]\n",      \
+                    __FILE__, __LINE__, #x, host_test_x, (double)(lo), (double)(hi));   \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief Prints the totals and returns the exit status for main().
+ */
+static inline int host_test_result(const char *name)
+{
+    fprintf(stderr, "%s: %u checks, %u failed\n", name, host_test_checks, host_test_failures);
+    return host_test_failures ? 1 : 0;
+}
+
+#endif // HOST_TEST_H
@@ -0,0 +1,687 @@
+/**
+ * @file pio_sim.c
+ * @brief Cycle-level simulator of an RP2040 PIO state machine, for the host tests.
+ */
+
+#include "pio_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Operand encodings, as in the instruction set (RP2040 datasheet, 3.4)
+enum
+{
+    COND_ALWAYS = 0,
+    COND_NOT_X,
+    COND_X_DEC,
+    COND_NOT_Y,
+    COND_Y_DEC,
+    COND_X_NE_Y,
+    COND_PIN,
+    COND_NOT_OSRE,
+};
+
+enum
+{
+    DEST_PINS = 0,
+    DEST_X,
+    DEST_Y,
+    DEST_NULL,
+    DEST_PINDIRS,
+    DEST_PC,
+    DEST_ISR,
+    DEST_OSR_OR_EXEC, // `out exec` or `mov osr`
+};
+
+enum
+{
+    SRC_PINS = 0,
+    SRC_X,
+    SRC_Y,
+    SRC_NULL,
+    SRC_STATUS = 5,
+    SRC_ISR,
+    SRC_OSR,
+};
+
+enum
+{
+    IRQ_SET = 0,
+    IRQ_WAIT,
+    IRQ_CLEAR,
+};
+
+#define PULL_BLOCK 1u
+#define PULL_IFEMPTY 2u
+
+#define MAX_TOKENS 10
+
+static int find(const char *const *names, size_t n, const char *s)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (names[i] && strcmp(names[i], s) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+#define FIND(names, s) find(names, sizeof(names) / sizeof(names[0]), s)
+
+static const char *const out_dest[] = {"pins", "x", "y", "null", "pindirs", "pc", "isr", NULL};
+static const char *const mov_dest[] = {"pins", "x", "y", NULL, NULL, "pc", "isr", "osr"};
+static const char *const mov_src[] = {"pins", "x", "y", "null", NULL, "status", "isr", "osr"};
+static const char *const set_dest[] = {"pins", "x", "y", NULL, "pindirs"};
+static const char *const jmp_cond[] = {NULL, "!x", "x--", "!y", "y--", "x!=y", "pin", "!osre"};
+
+static bool parse_number(const char *s, long *v)
+{
+    char *end;
+    *v = strtol(s, &end, 0);
+    return *s != '\0' && *end == '\0';
+}
+
+/**
+ * @brief Assembles the tokens of one instruction (side-set and delay already removed).
+ */
+static bool assemble(pio_sim_instr_t *in, char tok[][PIO_SIM_NAME_LEN], int n)
+{
+    long v;
+    int k;
+
+    if (strcmp(tok[0], "nop") == 0 && n == 1)
+    {
+        in->op = PIO_SIM_MOV; // mov y, y
+        in->cond = DEST_Y;
+        in->src = SRC_Y;
+        return true;
+    }
+    if (strcmp(tok[0], "jmp") == 0 && (n == 2 || n == 3))
+    {
+        in->op = PIO_SIM_JMP;
+        in->cond = COND_ALWAYS;
+        if (n == 3)
+        {
+            k = FIND(jmp_cond, tok[1]);
+            if (k < 0 || k == COND_PIN)
+            {
+                return false;
+            }
+            in->cond = (uint8_t)k;
+        }
+        snprintf(in->target, sizeof(in->target), "%s", tok[n - 1]);
+        return true;
+    }
+    if (strcmp(tok[0], "out") == 0 && n == 3)
+    {
+        k = FIND(out_dest, tok[1]);
+        if (k < 0 || !parse_number(tok[2], &v) || v < 1 || v > 32)
+        {
+            return false;
+        }
+        in->op = PIO_SIM_OUT;
+        in->cond = (uint8_t)k;
+        in->arg = (uint8_t)v;
+        return true;
+    }
+    if (strcmp(tok[0], "pull") == 0 && n <= 3)
+    {
+        in->op = PIO_SIM_PULL;
+        in->arg = PULL_BLOCK;
+        for (int i = 1; i < n; i++)
+        {
+            if (strcmp(tok[i], "noblock") == 0)
+            {
+                in->arg &= (uint8_t)~PULL_BLOCK;
+            }
+            else if (strcmp(tok[i], "ifempty") == 0)
+            {
+                in->arg |= PULL_IFEMPTY;
+            }
+            else if (strcmp(tok[i], "block") != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (strcmp(tok[0], "mov") == 0 && n == 3)
+    {
+        const char *src = tok[2];
+        in->mov_op = 0;
+        if (src[0] == '!' || src[0] == '~')
+        {
+            in->mov_op = 1;
+            src++;
+        }
+        else if (src[0] == ':' && src[1] == ':')
+        {
+            in->mov_op = 2;
+            src += 2;
+        }
+        int d = FIND(mov_dest, tok[1]);
+        int s = FIND(mov_src, src);
+        if (d < 0 || s < 0)
+        {
+            return false;
+        }
+        in->op = PIO_SIM_MOV;
+        in->cond = (uint8_t)d;
+        in->src = (uint8_t)s;
+        return true;
+    }
+    if (strcmp(tok[0], "set") == 0 && n == 3)
+    {
+        k = FIND(set_dest, tok[1]);
+        if (k < 0 || !parse_number(tok[2], &v) || v < 0 || v > 31)
+        {
+            return false;
+        }
+        in->op = PIO_SIM_SET;
+        in->cond = (uint8_t)k;
+        in->arg = (uint8_t)v;
+        return true;
+    }
+    if (strcmp(tok[0], "irq") == 0 && n >= 2)
+    {
+        int i = 1;
+        in->op = PIO_SIM_IRQ;
+        in->cond = IRQ_SET;
+        if (strcmp(tok[i], "nowait") == 0 || strcmp(tok[i], "set") == 0)
+        {
+            i++;
+        }
+        else if (strcmp(tok[i], "wait") == 0)
+        {
+            in->cond = IRQ_WAIT;
+            i++;
+        }
+        else if (strcmp(tok[i], "clear") == 0)
+        {
+            in->cond = IRQ_CLEAR;
+            i++;
+        }
+        if (i >= n || !parse_number(tok[i], &v) || v < 0 || v > 7)
+        {
+            return false;
+        }
+        in->arg = (uint8_t)v;
+        in->rel = (i + 1 < n && strcmp(tok[i + 1], "rel") == 0);
+        return i + 1 + (in->rel ? 1 : 0) == n;
+    }
+    return false;
+}
+
+/**
+ * @brief Handles one source line of the program being loaded.
+ */
+static bool load_line(pio_sim_program_t *p, char *line)
+{
+    char *semi = strchr(line, ';');
+    if (semi)
+    {
+        *semi = '\0';
+    }
+
+    char tok[MAX_TOKENS][PIO_SIM_NAME_LEN];
+    int n = 0;
+    for (char *t = strtok(line, " \t\r\n,"); t; t = strtok(NULL, " \t\r\n,"))
+    {
+        if (n == MAX_TOKENS)
+        {
+            return false;
+        }
+        snprintf(tok[n++], sizeof(tok[0]), "%s", t);
+    }
+
+    int first = 0;
+    while (first < n)
+    {
+        // Labels, with or without `public`, possibly followed by an instruction
+        int l = (strcmp(tok[first], "public") == 0 && first + 1 < n) ? first + 1 : first;
+        size_t len = strlen(tok[l]);
+        if (len < 2 || tok[l][len - 1] != ':')
+        {
+            break;
+        }
+        if (p->n_labels == PIO_SIM_MAX_LABELS)
+        {
+            return false;
+        }
+        tok[l][len - 1] = '\0';
+        snprintf(p->labels[p->n_labels], PIO_SIM_NAME_LEN, "%s", tok[l]);
+        p->label_addr[p->n_labels++] = p->len;
+        first = l + 1;
+    }
+    if (first == n)
+    {
+        return true;
+    }
+
+    char (*t)[PIO_SIM_NAME_LEN] = &tok[first];
+    n -= first;
+    if (strcmp(t[0], ".wrap_target") == 0)
+    {
+        p->wrap_target = p->len;
+        return true;
+    }
+    if (strcmp(t[0], ".wrap") == 0)
+    {
+        p->wrap = (uint8_t)(p->len - 1u);
+        return true;
+    }
+    if (strcmp(t[0], ".side_set") == 0)
+    {
+        long v;
+        if (n < 2 || !parse_number(t[1], &v) || v < 1 || v > 5)
+        {
+            return false;
+        }
+        p->sideset_bits = (uint8_t)v;
+        p->sideset_opt = (n > 2 && strcmp(t[2], "opt") == 0);
+        return true;
+    }
+    if (t[0][0] == '.')
+    {
+        return strcmp(t[0], ".origin") != 0; // Other directives do not change the code
+    }
+
+    if (p->len == PIO_SIM_MAX_INSTR)
+    {
+        return false;
+    }
+    pio_sim_instr_t *in = &p->code[p->len++];
+    memset(in, 0, sizeof(*in));
+    in->side = -1;
+
+    long v;
+    if (t[n - 1][0] == '[')
+    {
+        if (!parse_number(strtok(&t[n - 1][1], "]"), &v) || v < 0 || v > 31)
+        {
+            return false;
+        }
+        in->delay = (uint8_t)v;
+        n--;
+    }
+    if (n >= 3 && strcmp(t[n - 2], "side") == 0)
+    {
+        if (!parse_number(t[n - 1], &v) || p->sideset_bits == 0 || v < 0 || v >= (1 << p->sideset_bits))
+        {
+            return false;
+        }
+        in->side = (int8_t)v;
+        n -= 2;
+    }
+    if (p->sideset_bits && !p->sideset_opt && in->side < 0)
+    {
+        return false; // Side-set is mandatory on every instruction
+    }
+    return assemble(in, t, n);
+}
+
+int pio_sim_load(pio_sim_program_t *p, const char *path, const char *name)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        fprintf(stderr, "pio_sim: cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[200];
+    bool in_program = false;
+    bool found = false;
+    int err = 0;
+    memset(p, 0, sizeof(*p));
+    p->wrap = 0xFF;
+    while (fgets(line, sizeof(line), f))
+    {
+        char directive[PIO_SIM_NAME_LEN], prog[PIO_SIM_NAME_LEN];
+        if (sscanf(line, "%23s %23s", directive, prog) == 2 && strcmp(directive, ".program") == 0)
+        {
+            in_program = strcmp(prog, name) == 0;
+            found = found || in_program;
+            continue;
+        }
+        char copy[sizeof(line)];
+        memcpy(copy, line, sizeof(line));
+        if (in_program && !load_line(p, copy))
+        {
+            fprintf(stderr, "pio_sim: %s: cannot assemble: %s", name, line);
+            err = -1;
+        }
+    }
+    fclose(f);
+
+    if (!found || p->len == 0)
+    {
+        fprintf(stderr, "pio_sim: no program %s in %s\n", name, path);
+        return -1;
+    }
+    if (p->wrap == 0xFF)
+    {
+        p->wrap = (uint8_t)(p->len - 1u);
+    }
+    for (uint8_t i = 0; i < p->len; i++)
+    {
+        pio_sim_instr_t *in = &p->code[i];
+        if (in->op == PIO_SIM_JMP)
+        {
+            int addr = pio_sim_label(p, in->target);
+            if (addr < 0)
+            {
+                fprintf(stderr, "pio_sim: %s: unknown label %s\n", name, in->target);
+                err = -1;
+            }
+            in->arg = (uint8_t)(addr < 0 ? 0 : addr);
+        }
+    }
+    return err;
+}
+
+int pio_sim_label(const pio_sim_program_t *p, const char *label)
+{
+    for (uint8_t i = 0; i < p->n_labels; i++)
+    {
+        if (strcmp(p->labels[i], label) == 0)
+        {
+            return p->label_addr[i];
+        }
+    }
+    return -1;
+}
+
+pio_sim_config_t pio_sim_default_config(void)
+{
+    pio_sim_config_t c = {
+        .out_count = 32,
+        .set_count = 5,
+        .shift_right = true,
+        .autopull = false,
+        .pull_threshold = 32,
+        .status_n = 0,
+        .fifo_depth = 4,
+    };
+    return c;
+}
+
+void pio_sim_init(pio_sim_sm_t *sm, const pio_sim_program_t *prog, const pio_sim_config_t *cfg, uint8_t pc)
+{
+    memset(sm, 0, sizeof(*sm));
+    sm->prog = prog;
+    sm->cfg = *cfg;
+    sm->pc = pc;
+    sm->osr_count = 32; // Empty
+}
+
+bool pio_sim_put(pio_sim_sm_t *sm, uint32_t word)
+{
+    if (sm->fifo_level == sm->cfg.fifo_depth)
+    {
+        return false;
+    }
+    sm->fifo[(sm->fifo_head + sm->fifo_level) % sm->cfg.fifo_depth] = word;
+    sm->fifo_level++;
+    return true;
+}
+
+static uint32_t fifo_pop(pio_sim_sm_t *sm)
+{
+    uint32_t w = sm->fifo[sm->fifo_head];
+    sm->fifo_head = (sm->fifo_head + 1u) % sm->cfg.fifo_depth;
+    sm->fifo_level--;
+    return w;
+}
+
+/**
+ * @brief Writes value to count consecutive pins from base.
+ */
+static void write_pins(pio_sim_sm_t *sm, uint8_t base, uint8_t count, uint32_t value)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t bit = 1u << ((base + i) & 31u);
+        sm->pins = (value >> i) & 1u ? sm->pins | bit : sm->pins & ~bit;
+    }
+}
+
+static uint32_t bit_reverse(uint32_t v)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 32; i++)
+    {
+        r = (r << 1) | ((v >> i) & 1u);
+    }
+    return r;
+}
+
+static uint8_t irq_index(const pio_sim_sm_t *sm, const pio_sim_instr_t *in)
+{
+    if (!in->rel)
+    {
+        return in->arg;
+    }
+    return (uint8_t)((in->arg & 4u) | ((in->arg + sm->cfg.sm_index) & 3u));
+}
+
+/**
+ * @brief Executes an instruction; false if it stalls and must be retried.
+ */
+static bool execute(pio_sim_sm_t *sm, const pio_sim_instr_t *in, uint8_t *next)
+{
+    uint32_t v = 0;
+
+    switch (in->op)
+    {
+    case PIO_SIM_JMP:
+    {
+        bool take = true;
+        switch (in->cond)
+        {
+        case COND_NOT_X:
+            take = sm->x == 0;
+            break;
+        case COND_X_DEC:
+            take = sm->x != 0;
+            sm->x--;
+            break;
+        case COND_NOT_Y:
+            take = sm->y == 0;
+            break;
+        case COND_Y_DEC:
+            take = sm->y != 0;
+            sm->y--;
+            break;
+        case COND_X_NE_Y:
+            take = sm->x != sm->y;
+            break;
+        case COND_NOT_OSRE:
+            take = sm->osr_count < sm->cfg.pull_threshold;
+            break;
+        default:
+            break;
+        }
+        if (take)
+        {
+            *next = in->arg;
+        }
+        return true;
+    }
+
+    case PIO_SIM_OUT:
+        if (sm->cfg.autopull && sm->osr_count >= sm->cfg.pull_threshold)
+        {
+            if (sm->fifo_level == 0)
+            {
+                return false;
+            }
+            sm->osr = fifo_pop(sm);
+            sm->osr_count = 0;
+        }
+        if (sm->cfg.shift_right)
+        {
+            v = in->arg == 32 ? sm->osr : sm->osr & ((1u << in->arg) - 1u);
+            sm->osr = in->arg == 32 ? 0 : sm->osr >> in->arg;
+        }
+        else
+        {
+            v = in->arg == 32 ? sm->osr : sm->osr >> (32u - in->arg);
+            sm->osr = in->arg == 32 ? 0 : sm->osr << in->arg;
+        }
+        sm->osr_count = sm->osr_count + in->arg > 32u ? 32u : sm->osr_count + in->arg;
+        switch (in->cond)
+        {
+        case DEST_PINS:
+            write_pins(sm, sm->cfg.out_base, sm->cfg.out_count, v);
+            break;
+        case DEST_X:
+            sm->x = v;
+            break;
+        case DEST_Y:
+            sm->y = v;
+            break;
+        case DEST_PC:
+            *next = (uint8_t)(v & 31u);
+            break;
+        case DEST_ISR:
+            sm->isr = v;
+            break;
+        default:
+            break;
+        }
+        return true;
+
+    case PIO_SIM_PULL:
+        if ((in->arg & PULL_IFEMPTY) && sm->osr_count < sm->cfg.pull_threshold)
+        {
+            return true;
+        }
+        if (sm->fifo_level)
+        {
+            sm->osr = fifo_pop(sm);
+        }
+        else if (in->arg & PULL_BLOCK)
+        {
+            return false;
+        }
+        else
+        {
+            sm->osr = sm->x; // A non-blocking pull from an empty FIFO copies X
+        }
+        sm->osr_count = 0;
+        return true;
+
+    case PIO_SIM_MOV:
+        switch (in->src)
+        {
+        case SRC_PINS:
+            v = sm->pins >> sm->cfg.out_base;
+            break;
+        case SRC_X:
+            v = sm->x;
+            break;
+        case SRC_Y:
+            v = sm->y;
+            break;
+        case SRC_STATUS:
+            v = sm->fifo_level < sm->cfg.status_n ? 0xFFFFFFFFu : 0;
+            break;
+        case SRC_ISR:
+            v = sm->isr;
+            break;
+        case SRC_OSR:
+            v = sm->osr;
+            break;
+        default:
+            break;
+        }
+        v = in->mov_op == 1 ? ~v : in->mov_op == 2 ? bit_reverse(v) : v;
+        switch (in->cond)
+        {
+        case DEST_PINS:
+            write_pins(sm, sm->cfg.out_base, sm->cfg.out_count, v);
+            break;
+        case DEST_X:
+            sm->x = v;
+            break;
+        case DEST_Y:
+            sm->y = v;
+            break;
+        case DEST_PC:
+            *next = (uint8_t)(v & 31u);
+            break;
+        case DEST_ISR:
+            sm->isr = v;
+            break;
+        case DEST_OSR_OR_EXEC:
+            sm->osr = v;
+            sm->osr_count = 0;
+            break;
+        default:
+            break;
+        }
+        return true;
+
+    case PIO_SIM_SET:
+        if (in->cond == DEST_PINS)
+        {
+            write_pins(sm, sm->cfg.set_base, sm->cfg.set_count, in->arg);
+        }
+        else if (in->cond == DEST_X)
+        {
+            sm->x = in->arg;
+        }
+        else if (in->cond == DEST_Y)
+        {
+            sm->y = in->arg;
+        }
+        return true;
+
+    case PIO_SIM_IRQ:
+    {
+        uint8_t bit = (uint8_t)(1u << irq_index(sm, in));
+        if (in->cond == IRQ_CLEAR)
+        {
+            sm->irq &= (uint8_t)~bit;
+            return true;
+        }
+        if (in->cond == IRQ_WAIT && sm->issued)
+        {
+            // Raised on the first cycle, then held until something clears it
+            return (sm->irq & bit) == 0;
+        }
+        sm->irq |= bit;
+        return in->cond != IRQ_WAIT;
+    }
+    }
+    return true;
+}
+
+void pio_sim_step(pio_sim_sm_t *sm)
+{
+    sm->cycle++;
+    if (sm->delay)
+    {
+        sm->delay--;
+        return;
+    }
+
+    const pio_sim_instr_t *in = &sm->prog->code[sm->pc];
+    if (in->side >= 0 && !sm->issued)
+    {
+        write_pins(sm, sm->cfg.sideset_base, sm->prog->sideset_bits, (uint32_t)in->side);
+    }
+
+    uint8_t next = (sm->pc == sm->prog->wrap) ? sm->prog->wrap_target : (uint8_t)(sm->pc + 1u);
+    bool done = execute(sm, in, &next);
+    sm->issued = !done;
+    sm->stalled = !done;
+    if (done)
+    {
+        sm->pc = next;
+        sm->delay = in->delay;
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * @file pio_sim.h
+ * @brief Cycle-level simulator of an RP2040 PIO state machine, for the host tests.
+ *
+ * @details
+ * pio_sim_load() assembles one program straight from a .pio source file, so a test runs
+ * the same instructions the firmware loads; pio_sim_step() then executes one PIO cycle of a
+ * state machine. This is enough to compare a driver's host model with its program cycle by
+ * cycle.
+ *
+ * Supported: `jmp` (all conditions but `pin`), `out`, `pull`, `mov` (with `!`, `~` and `::`),
+ * `set`, `irq` and `nop`; delays; `.side_set n [opt]`; `.wrap_target`/`.wrap`; labels.
+ * `in`, `push` and `wait` are rejected by the loader. The TX FIFO is a queue the test fills
+ * with pio_sim_put(); `mov x, status` compares its level with status_n, as
+ * STATUS_TX_LESSTHAN does. Pins are the values the state machine drives: output pins
+ * change on the cycle of the instruction that writes them, side-set pins on the cycle the
+ * instruction is issued, even if it stalls.
+ *
+ * No Pico SDK dependency.
+ */
+
+#ifndef PIO_SIM_H
+#define PIO_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PIO_SIM_MAX_INSTR 32u  ///< Instruction memory of one PIO block.
+#define PIO_SIM_MAX_LABELS 16u ///< Labels per program.
+#define PIO_SIM_NAME_LEN 24u   ///< Longest label, with its terminator.
+
+typedef enum pio_sim_op
+{
+    PIO_SIM_JMP = 0,
+    PIO_SIM_OUT,
+    PIO_SIM_PULL,
+    PIO_SIM_MOV,
+    PIO_SIM_SET,
+    PIO_SIM_IRQ,
+} pio_sim_op_t;
+
+typedef struct pio_sim_instr
+{
+    pio_sim_op_t op;
+    uint8_t cond;      ///< jmp condition, `out`/`mov`/`set` destination, or irq mode.
+    uint8_t src;       ///< mov source.
+    uint8_t mov_op;    ///< mov operation: 0 none, 1 invert, 2 bit-reverse.
+    uint8_t arg;       ///< Bit count, set value, irq index, jump address or pull flags.
+    bool rel;          ///< irq index relative to the state machine.
+    int8_t side;       ///< Side-set value, -1 for none.
+    uint8_t delay;     ///< Extra cycles.
+    char target[PIO_SIM_NAME_LEN]; ///< Label of a jmp, until it is resolved.
+} pio_sim_instr_t;
+
+typedef struct pio_sim_program
+{
+    pio_sim_instr_t code[PIO_SIM_MAX_INSTR];
+    uint8_t len;                  ///< Instructions.
+    uint8_t wrap_target;          ///< First instruction of the loop.
+    uint8_t wrap;                 ///< Last instruction of the loop.
+    uint8_t sideset_bits;         ///< Side-set pins, not counting the opt bit.
+    bool sideset_opt;             ///< Side-set is optional.
+    char labels[PIO_SIM_MAX_LABELS][PIO_SIM_NAME_LEN];
+    uint8_t label_addr[PIO_SIM_MAX_LABELS];
+    uint8_t n_labels;
+} pio_sim_program_t;
+
+typedef struct pio_sim_config
+{
+    uint8_t out_base;      ///< First OUT pin.
+    uint8_t out_count;     ///< OUT pins.
+    uint8_t set_base;      ///< First SET pin.
+    uint8_t set_count;     ///< SET pins.
+    uint8_t sideset_base;  ///< First side-set pin.
+    bool shift_right;      ///< OSR shifts right (LSB first).
+    bool autopull;         ///< Refill the OSR when `out` finds it empty.
+    uint8_t pull_threshold; ///< Bits per OSR word, 1 to 32.
+    uint8_t status_n;      ///< `mov status` is all ones while the TX FIFO holds fewer words.
+    uint8_t fifo_depth;    ///< TX FIFO depth: 4, or 8 joined.
+    uint8_t sm_index;      ///< State machine number, for relative irq indices.
+} pio_sim_config_t;
+
+typedef struct pio_sim_sm
+{
+    const pio_sim_program_t *prog;
+    pio_sim_config_t cfg;
+    uint8_t pc;
+    uint32_t x, y, isr, osr;
+    uint32_t osr_count;  ///< Bits shifted out of the OSR since it was filled.
+    uint32_t fifo[8];
+    uint32_t fifo_head;  ///< Index of the oldest word.
+    uint32_t fifo_level; ///< Words queued.
+    uint32_t delay;      ///< Delay cycles left.
+    bool stalled;        ///< The last cycle's instruction could not complete.
+    bool issued;         ///< The current instruction's side-set has been applied.
+    uint32_t pins;       ///< Levels driven on GPIO 0-31.
+    uint8_t irq;         ///< IRQ flags 0-7 raised and not yet cleared.
+    uint64_t cycle;      ///< Cycles run.
+} pio_sim_sm_t;
+
+/**
+ * @brief Assembles one program of a .pio file.
+ *
+ * @param p Output program.
+ * @param path Source file.
+ * @param name Name after `.program`.
+ * @return int 0 on success, -1 if the file, the program, an instruction or a label cannot
+ *         be handled (the reason is printed on stderr).
+ */
+int pio_sim_load(pio_sim_program_t *p, const char *path, const char *name);
+
+/**
+ * @brief Address of a label, or -1.
+ */
+int pio_sim_label(const pio_sim_program_t *p, const char *label);
+
+/**
+ * @brief Default configuration: LSB first, no autopull, 32-bit threshold, 4-word FIFO.
+ */
+pio_sim_config_t pio_sim_default_config(void);
+
+/**
+ * @brief Resets a state machine as pio_sm_init() does: empty OSR and FIFO, pins low.
+ *
+ * @param sm State machine.
+ * @param prog Loaded program.
+ * @param cfg Pin mapping, shifting and FIFO.
+ * @param pc First instruction to run.
+ */
+void pio_sim_init(pio_sim_sm_t *sm, const pio_sim_program_t *prog, const pio_sim_config_t *cfg, uint8_t pc);
+
+/**
+ * @brief Queues a word in the TX FIFO; false if it is full.
+ */
+bool pio_sim_put(pio_sim_sm_t *sm, uint32_t word);
+
+/**
+ * @brief Runs one PIO cycle.
+ */
+void pio_sim_step(pio_sim_sm_t *sm);
+
+/**
+ * @brief Level of one GPIO driven by the state machine.
+ */
+static inline uint8_t pio_sim_pin(const pio_sim_sm_t *sm, uint8_t pin)
+{
+    return (uint8_t)((sm->pins >> pin) & 1u);
+}
+
+#endif // PIO_SIM_H
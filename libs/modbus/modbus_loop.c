@@ -0,0 +1,77 @@
+/**
+ * @file modbus_loop.c
+ * @brief In-memory Modbus-RTU bus joining a master to slaves, for running both on a host.
+ */
+
+#include "modbus_loop.h"
+
+#define IDLE_STEP_US 100u ///< Time step while the master has nothing to send.
+
+/**
+ * @brief Time to send n bytes, rounded up to a microsecond.
+ */
+static uint32_t wire_us(size_t n, const modbus_loop_config_t *cfg)
+{
+    uint64_t bits = (uint64_t)n * cfg->char_bits * 1000000u;
+    return (uint32_t)((bits + cfg->baud_rate - 1u) / cfg->baud_rate);
+}
+
+void modbus_loop_run(modbus_master_t *m, modbus_slave_t *const *slaves, size_t n_slaves,
+                     const modbus_loop_config_t *cfg, uint32_t duration_us, modbus_loop_result_t *res)
+{
+    uint8_t req[MODBUS_RTU_MAX_FRAME];
+    uint8_t resp[MODBUS_RTU_MAX_FRAME];
+    uint32_t gap = modbus_rtu_t35_us(cfg->baud_rate, cfg->char_bits);
+    uint32_t now = 0;
+
+    *res = (modbus_loop_result_t){0};
+
+    while (now < duration_us)
+    {
+        size_t n = modbus_master_poll(m, now, req);
+        if (n == 0)
+        {
+            now += IDLE_STEP_US;
+            continue;
+        }
+        res->requests++;
+        // The master's timeout runs from here; the request then takes the line.
+        uint32_t t = now + wire_us(n, cfg) + gap;
+
+        // Every slave sees the frame; at most one of them answers.
+        size_t len = 0;
+        for (size_t i = 0; i < n_slaves && len == 0; i++)
+        {
+            len = modbus_slave_handle(slaves[i], req, n, resp);
+        }
+        if (len == 0)
+        {
+            now = t;
+            continue;
+        }
+
+        res->responses++;
+        t += cfg->response_delay_us + wire_us(len, cfg) + gap;
+        if (cfg->drop_every && res->responses % cfg->drop_every == 0)
+        {
+            res->dropped++;
+            now = t;
+            continue;
+        }
+        if (cfg->corrupt_every && res->responses % cfg->corrupt_every == 0)
+        {
+            resp[res->responses % len] ^= (uint8_t)(1u << (res->responses % 8u));
+            res->corrupted++;
+        }
+        // A response after the timeout finds the master already moved on.
+        if (t - m->sent_us >= m->timeout_us)
+        {
+            res->late++;
+            now = t;
+            continue;
+        }
+        modbus_master_on_frame(m, resp, len, t);
+        now = t;
+    }
+    res->end_us = now;
+}
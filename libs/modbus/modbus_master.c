@@ -0,0 +1,141 @@
+/**
+ * @file modbus_master.c
+ * @brief Modbus-RTU polling master that keeps a cache of slave registers.
+ */
+
+#include "modbus_master.h"
+
+/**
+ * @brief True once time a has reached time b, modulo 2^32.
+ */
+static inline bool reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+void modbus_master_init(modbus_master_t *m, modbus_poll_t *polls, size_t n_polls, uint32_t period_us,
+                        uint32_t timeout_us, uint32_t stale_us, uint32_t gap_us)
+{
+    m->polls = polls;
+    m->n_polls = n_polls;
+    m->current = 0;
+    m->waiting = false;
+    m->sent_us = 0;
+    m->cycle_us = 0;
+    m->next_us = 0;
+    m->period_us = period_us;
+    m->timeout_us = timeout_us;
+    m->stale_us = stale_us;
+    m->gap_us = gap_us;
+
+    for (size_t i = 0; i < n_polls; i++)
+    {
+        modbus_poll_t *p = &polls[i];
+        p->valid = false;
+        p->updated_us = 0;
+        p->latency_us = 0;
+        p->max_latency_us = 0;
+        p->ok = 0;
+        p->timeouts = 0;
+        p->errors = 0;
+        p->exceptions = 0;
+        p->last_exception = 0;
+    }
+}
+
+/**
+ * @brief Moves to the next entry once the current one is done.
+ */
+static void advance(modbus_master_t *m, uint32_t now_us)
+{
+    m->waiting = false;
+    m->next_us = now_us + m->gap_us;
+    if (++m->current >= m->n_polls)
+    {
+        m->current = 0;
+        // The next pass starts a period after this one, or after the gap if polling is late.
+        uint32_t cycle = m->cycle_us + m->period_us;
+        if (!reached(m->next_us, cycle))
+        {
+            m->next_us = cycle;
+        }
+    }
+}
+
+size_t modbus_master_poll(modbus_master_t *m, uint32_t now_us, uint8_t *out)
+{
+    for (size_t i = 0; i < m->n_polls; i++)
+    {
+        modbus_poll_t *p = &m->polls[i];
+        if (p->valid && reached(now_us, p->updated_us + m->stale_us))
+        {
+            p->valid = false;
+        }
+    }
+
+    if (m->n_polls == 0)
+    {
+        return 0;
+    }
+    if (m->waiting)
+    {
+        if (!reached(now_us, m->sent_us + m->timeout_us))
+        {
+            return 0;
+        }
+        m->polls[m->current].timeouts++;
+        advance(m, now_us);
+    }
+    if (!reached(now_us, m->next_us))
+    {
+        return 0;
+    }
+
+    const modbus_poll_t *p = &m->polls[m->current];
+    if (m->current == 0)
+    {
+        m->cycle_us = now_us;
+    }
+    m->waiting = true;
+    m->sent_us = now_us;
+    return modbus_rtu_read_request(out, p->unit, p->function, p->start, p->count);
+}
+
+void modbus_master_on_frame(modbus_master_t *m, const uint8_t *frame, size_t len, uint32_t now_us)
+{
+    if (!m->waiting)
+    {
+        return; // Late response or another master's traffic
+    }
+
+    modbus_poll_t *p = &m->polls[m->current];
+    uint8_t exception = 0;
+    int n = modbus_rtu_parse_read(frame, len, p->unit, p->function, p->count, p->cache, &exception);
+
+    if (n == MODBUS_ERR_UNIT)
+    {
+        p->errors++;
+        return; // Not the answer; keep waiting until the timeout
+    }
+    if (n == MODBUS_ERR_EXCEPTION)
+    {
+        p->exceptions++;
+        p->last_exception = exception;
+    }
+    else if (n < 0)
+    {
+        p->errors++;
+    }
+    else
+    {
+        p->ok++;
+        p->valid = true;
+        p->updated_us = now_us;
+        p->latency_us = now_us - m->sent_us;
+        if (p->latency_us > p->max_latency_us)
+        {
+            p->max_latency_us = p->latency_us;
+        }
+    }
+    advance(m, now_us);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file modbus_master.h
+ * @brief Modbus-RTU polling master that keeps a cache of slave registers.
+ *
+ * @details
+ * The master walks a fixed poll list, one read request at a time, and stores each good
+ * response in the entry's cache array. With the cache mapped as read-only regions of a
+ * gateway slave (modbus_slave.h), the host reads slave registers from the RP2040 at once,
+ * and the latency-critical polling stays on the bus side.
+ *
+ * The caller owns the line and the clock. modbus_master_poll() returns the next request
+ * when one is due, modbus_master_on_frame() is given every frame received while waiting,
+ * and timeouts are checked on every modbus_master_poll() call. All times are microseconds
+ * from a free-running 32-bit counter, compared modulo 2^32. An entry's cache is valid only
+ * while its last good response is younger than stale_us.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef MODBUS_MASTER_H
+#define MODBUS_MASTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "modbus_rtu.h"
+
+typedef struct modbus_poll
+{
+    uint8_t unit;             ///< Slave address.
+    uint8_t function;         ///< MODBUS_FC_READ_HOLDING or MODBUS_FC_READ_INPUT.
+    uint16_t start;           ///< First register.
+    uint16_t count;           ///< Registers, 1 .. MODBUS_MAX_READ.
+    uint16_t *cache;          ///< Last values read, count registers.
+    volatile bool valid;      ///< The cache is fresh.
+    uint32_t updated_us;      ///< Time of the last good response.
+    uint32_t latency_us;      ///< Request sent to response received, last good poll.
+    uint32_t max_latency_us;  ///< Longest request-to-response time.
+    uint32_t ok;              ///< Good responses.
+    uint32_t timeouts;        ///< Requests with no response.
+    uint32_t errors;          ///< Bad CRC, length or count, or another unit's frame.
+    uint32_t exceptions;      ///< Exception responses.
+    uint8_t last_exception;   ///< Code of the last exception response.
+} modbus_poll_t;
+
+typedef struct modbus_master
+{
+    modbus_poll_t *polls;  ///< Poll list.
+    size_t n_polls;        ///< Entries in the list.
+    size_t current;        ///< Entry being polled or next to poll.
+    bool waiting;          ///< A request is out and its response is due.
+    uint32_t sent_us;      ///< Time the request went out.
+    uint32_t cycle_us;     ///< Start of the current pass over the list.
+    uint32_t next_us;      ///< Earliest time for the next request.
+    uint32_t period_us;    ///< Time between passes over the list.
+    uint32_t timeout_us;   ///< Response timeout.
+    uint32_t stale_us;     ///< Age after which a cache entry is invalid.
+    uint32_t gap_us;       ///< Silence kept between a response and the next request (t3.5).
+} modbus_master_t;
+
+/**
+ * @brief Initializes a master over a poll list; the first request is due at once.
+ *
+ * @param m Pointer to the master.
+ * @param polls Poll list, with unit, function, start, count and cache set.
+ * @param n_polls Number of entries.
+ * @param period_us Time between passes over the list.
+ * @param timeout_us Response timeout, counted from the call that returned the request.
+ * @param stale_us Age after which a cache entry is marked invalid.
+ * @param gap_us Silence between frames, modbus_rtu_t35_us() for the line.
+ */
+void modbus_master_init(modbus_master_t *m, modbus_poll_t *polls, size_t n_polls, uint32_t period_us,
+                        uint32_t timeout_us, uint32_t stale_us, uint32_t gap_us);
+
+/**
+ * @brief Checks timeouts and ages, and returns the next request if one is due.
+ *
+ * @param m Pointer to the master.
+ * @param now_us Current time.
+ * @param out Output request, at least 8 bytes.
+ * @return size_t Request length, 0 if nothing is to be sent now.
+ */
+size_t modbus_master_poll(modbus_master_t *m, uint32_t now_us, uint8_t *out);
+
+/**
+ * @brief Handles a frame received from the bus.
+ *
+ * @param m Pointer to the master.
+ * @param frame Frame including the CRC.
+ * @param len Frame length.
+ * @param now_us Time the frame ended.
+ */
+void modbus_master_on_frame(modbus_master_t *m, const uint8_t *frame, size_t len, uint32_t now_us);
+
+#endif // MODBUS_MASTER_H
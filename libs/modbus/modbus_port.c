@@ -0,0 +1,199 @@
+/**
+ * @file modbus_port.c
+ * @brief Modbus-RTU frame receiver on a UART, delimited by the hardware RX timeout.
+ */
+
+#include "modbus_port.h"
+#include "hardware/irq.h"
+
+#define RX_IRQS (UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS) ///< RX level and timeout.
+#define RX_LEVEL_HALF 2u                                           ///< IFLS RX level: 1/2 full.
+#define RX_LEVEL_BYTES 16u                                         ///< Bytes at that level.
+#define RX_TIMEOUT_BITS 32u                                        ///< PL011 receive timeout.
+#define DR_ERRORS (UART_UARTDR_OE_BITS | UART_UARTDR_BE_BITS | UART_UARTDR_PE_BITS | UART_UARTDR_FE_BITS)
+
+static modbus_port_t *ports[2] = {NULL, NULL}; ///< Port on each UART, by UART index.
+
+/**
+ * @brief Closes the frame being filled and publishes it if it is intact.
+ */
+static void modbus_port_end_frame(modbus_port_t *p)
+{
+    if (p->len == 0)
+    {
+        return;
+    }
+    if (p->bad)
+    {
+        p->stats.errors++;
+    }
+    else if (p->ready >= 0)
+    {
+        p->stats.dropped++;
+    }
+    else
+    {
+        p->ready_len = p->len;
+        p->ready_us = time_us_32();
+        p->ready = (int8_t)p->fill;
+        p->fill ^= 1u;
+        p->stats.frames++;
+    }
+    p->len = 0;
+    p->bad = false;
+}
+
+/**
+ * @brief Alarm callback: t3.5 has passed since the receive timeout.
+ */
+static int64_t modbus_port_t35_alarm(alarm_id_t id, void *user_data)
+{
+    (void)id;
+    modbus_port_t *p = user_data;
+    p->alarm = 0;
+
+    // A byte that arrived meanwhile is still in the FIFO; its receive timeout comes later.
+    if (uart_get_hw(p->uart)->fr & UART_UARTFR_RXFE_BITS)
+    {
+        modbus_port_end_frame(p);
+    }
+    return 0;
+}
+
+/**
+ * @brief UART handler: moves received bytes into the frame and times the silence.
+ */
+static void modbus_port_rx(modbus_port_t *p)
+{
+    uart_hw_t *hw = uart_get_hw(p->uart);
+    bool timeout = hw->mis & UART_UARTMIS_RTMIS_BITS;
+
+    if (p->alarm > 0)
+    {
+        // The line was quiet for 32 bits but not for t3.5: same frame.
+        cancel_alarm(p->alarm);
+        p->alarm = 0;
+        p->stats.continued++;
+    }
+
+    // On a level interrupt leave one byte behind, so the frame still ends with a timeout.
+    uint32_t n = timeout ? MODBUS_RTU_MAX_FRAME + 32u : RX_LEVEL_BYTES - 1u;
+    while (n-- && !(hw->fr & UART_UARTFR_RXFE_BITS))
+    {
+        uint32_t dr = hw->dr;
+        if (dr & DR_ERRORS)
+        {
+            p->bad = true;
+        }
+        if (p->len < MODBUS_RTU_MAX_FRAME)
+        {
+            p->buf[p->fill][p->len++] = (uint8_t)dr;
+        }
+        else
+        {
+            p->bad = true;
+        }
+    }
+
+    if (timeout)
+    {
+        hw->icr = UART_UARTICR_RTIC_BITS;
+        if (p->tail_us == 0)
+        {
+            modbus_port_end_frame(p);
+        }
+        else
+        {
+            alarm_id_t id = add_alarm_in_us(p->tail_us, modbus_port_t35_alarm, p, true);
+            if (id > 0)
+            {
+                p->alarm = id;
+            }
+            else
+            {
+                modbus_port_end_frame(p); // No alarm slot: close at the receive timeout
+            }
+        }
+    }
+}
+
+/**
+ * @brief UART0_IRQ handler.
+ */
+static void modbus_port_uart0_irq(void)
+{
+    modbus_port_rx(ports[0]);
+}
+
+/**
+ * @brief UART1_IRQ handler.
+ */
+static void modbus_port_uart1_irq(void)
+{
+    modbus_port_rx(ports[1]);
+}
+
+void modbus_port_init(modbus_port_t *p, uart_inst_t *uart, uint tx_pin, uint rx_pin, uint baud_rate,
+                      uart_parity_t parity, uint stop_bits)
+{
+    uint index = uart_get_index(uart);
+
+    p->uart = uart;
+    p->rs485 = NULL;
+    p->fill = 0;
+    p->len = 0;
+    p->bad = false;
+    p->alarm = 0;
+    p->ready = -1;
+    p->ready_len = 0;
+    p->ready_us = 0;
+    p->stats = (modbus_port_stats_t){0};
+
+    p->baud_rate = uart_init(uart, baud_rate);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(rx_pin, GPIO_FUNC_UART);
+    uart_set_hw_flow(uart, false, false);
+    uart_set_format(uart, 8, stop_bits, parity);
+    uart_set_fifo_enabled(uart, true);
+
+    // Start, 8 data bits, parity, stop bits; the timeout covers RX_TIMEOUT_BITS of t3.5.
+    p->char_bits = 9u + (parity != UART_PARITY_NONE ? 1u : 0u) + stop_bits;
+    p->t35_us = modbus_rtu_t35_us(p->baud_rate, p->char_bits);
+    uint32_t rt_us = (RX_TIMEOUT_BITS * 1000000u + p->baud_rate - 1u) / p->baud_rate;
+    p->tail_us = (p->t35_us > rt_us) ? p->t35_us - rt_us : 0;
+
+    ports[index] = p;
+    irq_set_exclusive_handler(index ? UART1_IRQ : UART0_IRQ, index ? modbus_port_uart1_irq : modbus_port_uart0_irq);
+    irq_set_enabled(index ? UART1_IRQ : UART0_IRQ, true);
+
+    uart_hw_t *hw = uart_get_hw(uart);
+    hw_write_masked(&hw->ifls, RX_LEVEL_HALF << UART_UARTIFLS_RXIFLSEL_LSB, UART_UARTIFLS_RXIFLSEL_BITS);
+    hw_set_bits(&hw->imsc, RX_IRQS);
+}
+
+const uint8_t *modbus_port_receive(modbus_port_t *p, size_t *len, uint32_t *end_us)
+{
+    int8_t ready = p->ready;
+    if (ready < 0)
+    {
+        return NULL;
+    }
+    *len = p->ready_len;
+    if (end_us != NULL)
+    {
+        *end_us = p->ready_us;
+    }
+    return p->buf[ready];
+}
+
+void modbus_port_send(modbus_port_t *p, const uint8_t *frame, size_t len)
+{
+    if (p->rs485 != NULL)
+    {
+        rs485_write_blocking(p->rs485, frame, len);
+    }
+    else
+    {
+        uart_write_blocking(p->uart, frame, len);
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file modbus_port.h
+ * @brief Modbus-RTU frame receiver on a UART, delimited by the hardware RX timeout.
+ *
+ * @details
+ * Frames end after 3.5 character times of silence (t3.5). The UART interrupts at a FIFO
+ * level of 16 bytes and on its receive timeout, which fires 32 bit periods after the last
+ * byte, as long as the FIFO is not empty. The level handler therefore leaves at least one
+ * byte in the FIFO, so every frame ends with a receive timeout; no per-byte interrupt or
+ * polling is needed. A one-shot alarm covers the rest of t3.5 (t3.5 minus 32 bit periods;
+ * 1715 us at 921600 baud, where t3.5 is fixed at 1750 us). A byte arriving before the alarm
+ * fires continues the frame.
+ *
+ * Frames are collected in a double buffer. The main loop takes a complete frame with
+ * modbus_port_receive() and gives it back with modbus_port_release(); a frame completed
+ * while the previous one is still held is dropped and counted. Frames with a framing,
+ * parity or overrun error, or longer than MODBUS_RTU_MAX_FRAME, are dropped too. The CRC
+ * is left to the caller (modbus_slave_handle(), modbus_rtu_parse_read()).
+ *
+ * Replies go out of the UART's own TX, or of a PIO RS485 transmitter attached with
+ * modbus_port_use_rs485(). That transmitter sends 8N1, so an RS485 port must use no parity
+ * and one stop bit. A port takes its UART's interrupt exclusively; the two UARTs can each
+ * run a port.
+ */
+
+#ifndef MODBUS_PORT_H
+#define MODBUS_PORT_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "modbus_rtu.h"
+#include "rs485.h"
+
+typedef struct modbus_port_stats
+{
+    uint32_t frames;    ///< Frames delivered.
+    uint32_t errors;    ///< Frames dropped for a line error or overflow.
+    uint32_t dropped;   ///< Frames dropped because the previous one was still held.
+    uint32_t continued; ///< Frames that resumed after the receive timeout, within t3.5.
+} modbus_port_stats_t;
+
+typedef struct modbus_port
+{
+    uart_inst_t *uart;                          ///< UART instance.
+    rs485_t *rs485;                             ///< PIO transmitter, or NULL for the UART TX.
+    uint baud_rate;                             ///< Baud rate actually set.
+    uint32_t char_bits;                         ///< Bits per character.
+    uint32_t t35_us;                            ///< Silent interval that ends a frame.
+    uint32_t tail_us;                           ///< Part of t3.5 after the receive timeout.
+    uint8_t buf[2][MODBUS_RTU_MAX_FRAME];       ///< Double frame buffer.
+    uint8_t fill;                               ///< Buffer being filled.
+    size_t len;                                 ///< Bytes in the buffer being filled.
+    bool bad;                                   ///< The frame being filled will be dropped.
+    alarm_id_t alarm;                           ///< Pending end-of-frame alarm, 0 if none.
+    volatile int8_t ready;                      ///< Buffer holding a complete frame, -1 if none.
+    volatile size_t ready_len;                  ///< Length of the complete frame.
+    volatile uint32_t ready_us;                 ///< Time the complete frame ended (t3.5 reached).
+    modbus_port_stats_t stats;                  ///< Counters.
+} modbus_port_t;
+
+/**
+ * @brief Sets up a UART for Modbus-RTU and starts receiving.
+ *
+ * @param p Pointer to the port.
+ * @param uart UART instance.
+ * @param tx_pin TX GPIO.
+ * @param rx_pin RX GPIO.
+ * @param baud_rate Baud rate.
+ * @param parity UART_PARITY_EVEN (the Modbus default) or UART_PARITY_NONE.
+ * @param stop_bits 1 or 2 (two with no parity keeps the standard 11-bit character).
+ */
+void modbus_port_init(modbus_port_t *p, uart_inst_t *uart, uint tx_pin, uint rx_pin, uint baud_rate,
+                      uart_parity_t parity, uint stop_bits);
+
+/**
+ * @brief Sends through a PIO RS485 transmitter instead of the UART TX.
+ *
+ * @param p Pointer to the port.
+ * @param r Transmitter started with rs485_init() on the port's TX and RX pins.
+ */
+static inline void modbus_port_use_rs485(modbus_port_t *p, rs485_t *r)
+{
+    p->rs485 = r;
+}
+
+/**
+ * @brief Takes the oldest complete frame, if there is one.
+ *
+ * @param p Pointer to the port.
+ * @param len Output, frame length including the CRC.
+ * @param end_us Output, time the frame ended; may be NULL.
+ * @return const uint8_t* The frame, valid until modbus_port_release(), or NULL.
+ */
+const uint8_t *modbus_port_receive(modbus_port_t *p, size_t *len, uint32_t *end_us);
+
+/**
+ * @brief Gives back the frame returned by modbus_port_receive().
+ */
+static inline void modbus_port_release(modbus_port_t *p)
+{
+    p->ready = -1;
+}
+
+/**
+ * @brief Sends a frame and returns once it is queued in the TX FIFO.
+ */
+void modbus_port_send(modbus_port_t *p, const uint8_t *frame, size_t len);
+
+#endif // MODBUS_PORT_H
@@ -0,0 +1,166 @@
+/**
+ * @file modbus_rtu.c
+ * @brief Modbus-RTU framing: CRC-16, character timing, and request/response encoding.
+ */
+
+#include "modbus_rtu.h"
+
+/** CRC-16/MODBUS lookup table (reflected poly 0xA001), one entry per byte value. */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+uint16_t modbus_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    while (len--)
+    {
+        crc = (uint16_t)(crc >> 8) ^ crc16_table[(uint8_t)(crc ^ *data++)];
+    }
+    return crc;
+}
+
+size_t modbus_rtu_seal(uint8_t *frame, size_t len)
+{
+    uint16_t crc = modbus_crc16(0xFFFF, frame, len);
+    frame[len] = (uint8_t)crc; // Low byte first, unlike the register values
+    frame[len + 1] = (uint8_t)(crc >> 8);
+    return len + 2u;
+}
+
+/**
+ * @brief n half characters in microseconds, rounded up.
+ */
+static uint32_t half_chars_us(uint32_t n, uint32_t baud_rate, uint32_t char_bits)
+{
+    uint64_t num = (uint64_t)n * char_bits * 1000000u;
+    uint64_t den = 2u * (uint64_t)baud_rate;
+    return (uint32_t)((num + den - 1u) / den);
+}
+
+uint32_t modbus_rtu_t35_us(uint32_t baud_rate, uint32_t char_bits)
+{
+    return (baud_rate > 19200u) ? 1750u : half_chars_us(7u, baud_rate, char_bits);
+}
+
+uint32_t modbus_rtu_t15_us(uint32_t baud_rate, uint32_t char_bits)
+{
+    return (baud_rate > 19200u) ? 750u : half_chars_us(3u, baud_rate, char_bits);
+}
+
+size_t modbus_rtu_read_request(uint8_t *out, uint8_t unit, uint8_t function, uint16_t start, uint16_t count)
+{
+    out[0] = unit;
+    out[1] = function;
+    modbus_put16(out + 2, start);
+    modbus_put16(out + 4, count);
+    return modbus_rtu_seal(out, 6);
+}
+
+size_t modbus_rtu_write_single_request(uint8_t *out, uint8_t unit, uint16_t reg, uint16_t value)
+{
+    out[0] = unit;
+    out[1] = MODBUS_FC_WRITE_SINGLE;
+    modbus_put16(out + 2, reg);
+    modbus_put16(out + 4, value);
+    return modbus_rtu_seal(out, 6);
+}
+
+size_t modbus_rtu_write_multiple_request(uint8_t *out, uint8_t unit, uint16_t start, const uint16_t *values,
+                                         uint16_t count)
+{
+    if (count == 0 || count > MODBUS_MAX_WRITE)
+    {
+        return 0;
+    }
+    out[0] = unit;
+    out[1] = MODBUS_FC_WRITE_MULTIPLE;
+    modbus_put16(out + 2, start);
+    modbus_put16(out + 4, count);
+    out[6] = (uint8_t)(2u * count);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        modbus_put16(out + 7 + 2u * i, values[i]);
+    }
+    return modbus_rtu_seal(out, 7u + 2u * count);
+}
+
+size_t modbus_rtu_exception(uint8_t *out, uint8_t unit, uint8_t function, uint8_t code)
+{
+    out[0] = unit;
+    out[1] = (uint8_t)(function | MODBUS_FC_EXCEPTION);
+    out[2] = code;
+    return modbus_rtu_seal(out, 3);
+}
+
+int modbus_rtu_parse_read(const uint8_t *frame, size_t len, uint8_t unit, uint8_t function, uint16_t count,
+                          uint16_t *regs, uint8_t *exception)
+{
+    if (len < 5u)
+    {
+        return MODBUS_ERR_SHORT;
+    }
+    if (modbus_crc16(0xFFFF, frame, len) != 0)
+    {
+        return MODBUS_ERR_CRC;
+    }
+    if (frame[0] != unit)
+    {
+        return MODBUS_ERR_UNIT;
+    }
+    if (frame[1] == (uint8_t)(function | MODBUS_FC_EXCEPTION))
+    {
+        if (exception != NULL)
+        {
+            *exception = frame[2];
+        }
+        return MODBUS_ERR_EXCEPTION;
+    }
+    if (frame[1] != function)
+    {
+        return MODBUS_ERR_FUNCTION;
+    }
+    if (frame[2] != 2u * count)
+    {
+        return MODBUS_ERR_COUNT;
+    }
+    if (len != 5u + 2u * count)
+    {
+        return MODBUS_ERR_SHORT;
+    }
+    for (uint16_t i = 0; i < count; i++)
+    {
+        regs[i] = modbus_get16(frame + 3 + 2u * i);
+    }
+    return count;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file modbus_rtu.h
+ * @brief Modbus-RTU framing: CRC-16, character timing, and request/response encoding.
+ *
+ * @details
+ * An RTU frame is `unit | function | data | CRC low | CRC high`, at most
+ * MODBUS_RTU_MAX_FRAME bytes. Frames are delimited by silence on the line: a gap of 3.5
+ * character times ends a frame (t3.5). Above 19200 baud the standard fixes t3.5 at 1750 us
+ * and t1.5 at 750 us instead of scaling them with the bit time.
+ *
+ * The CRC is CRC-16/MODBUS (reflected poly 0xA001, initial 0xFFFF), computed one byte at a
+ * time from a 256-entry table and sent low byte first. A frame whose CRC, computed over the
+ * whole frame including the CRC bytes, is zero is intact.
+ *
+ * Only the register functions are supported: read holding (0x03) and input (0x04)
+ * registers, write a single register (0x06) and write multiple registers (0x10).
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MODBUS_RTU_MAX_FRAME 256u  ///< Longest RTU frame.
+#define MODBUS_RTU_MIN_FRAME 4u    ///< Unit, function and CRC.
+#define MODBUS_MAX_READ 125u       ///< Most registers in one read.
+#define MODBUS_MAX_WRITE 123u      ///< Most registers in one write-multiple.
+#define MODBUS_BROADCAST 0u        ///< Unit address every slave acts on without replying.
+
+// Function codes
+#define MODBUS_FC_READ_HOLDING 0x03u  ///< Read holding registers.
+#define MODBUS_FC_READ_INPUT 0x04u    ///< Read input registers.
+#define MODBUS_FC_WRITE_SINGLE 0x06u  ///< Write single register.
+#define MODBUS_FC_WRITE_MULTIPLE 0x10u ///< Write multiple registers.
+#define MODBUS_FC_EXCEPTION 0x80u     ///< Set in the function code of an exception response.
+
+// Exception codes
+#define MODBUS_EX_ILLEGAL_FUNCTION 0x01u ///< Function not supported.
+#define MODBUS_EX_ILLEGAL_ADDRESS 0x02u  ///< Register range not mapped.
+#define MODBUS_EX_ILLEGAL_VALUE 0x03u    ///< Bad count or byte count.
+#define MODBUS_EX_DEVICE_FAILURE 0x04u   ///< Unrecoverable error while serving the request.
+#define MODBUS_EX_GATEWAY_PATH 0x0Au     ///< Gateway has no path to the unit.
+#define MODBUS_EX_GATEWAY_TARGET 0x0Bu   ///< Gateway target failed to respond.
+
+// Errors returned by modbus_rtu_parse_read()
+#define MODBUS_ERR_SHORT -1    ///< Frame too short or length does not match.
+#define MODBUS_ERR_CRC -2      ///< CRC mismatch.
+#define MODBUS_ERR_UNIT -3     ///< Response from another unit.
+#define MODBUS_ERR_FUNCTION -4 ///< Response to another function.
+#define MODBUS_ERR_COUNT -5    ///< Register count differs from the request.
+#define MODBUS_ERR_EXCEPTION -6 ///< Exception response; the code is returned separately.
+
+/**
+ * @brief Updates a CRC-16/MODBUS with a block of bytes.
+ *
+ * @param crc Running CRC; start with 0xFFFF.
+ * @param data Bytes to add.
+ * @param len Number of bytes.
+ * @return uint16_t Updated CRC.
+ */
+uint16_t modbus_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief True if a frame is long enough and its CRC checks.
+ */
+static inline int modbus_rtu_frame_ok(const uint8_t *frame, size_t len)
+{
+    return len >= MODBUS_RTU_MIN_FRAME && len <= MODBUS_RTU_MAX_FRAME && modbus_crc16(0xFFFF, frame, len) == 0;
+}
+
+/**
+ * @brief Appends the CRC to a frame body.
+ *
+ * @param frame Frame, with room for two more bytes.
+ * @param len Body length (unit to last data byte).
+ * @return size_t Frame length including the CRC.
+ */
+size_t modbus_rtu_seal(uint8_t *frame, size_t len);
+
+/**
+ * @brief Silent interval that ends a frame (t3.5), in microseconds.
+ *
+ * @param baud_rate Line rate.
+ * @param char_bits Bits per character: 11 for 8E1/8N2 as the standard requires, 10 for 8N1.
+ * @return uint32_t t3.5, rounded up.
+ */
+uint32_t modbus_rtu_t35_us(uint32_t baud_rate, uint32_t char_bits);
+
+/**
+ * @brief Longest gap allowed inside a frame (t1.5), in microseconds.
+ */
+uint32_t modbus_rtu_t15_us(uint32_t baud_rate, uint32_t char_bits);
+
+/**
+ * @brief Encodes a read request (0x03 or 0x04).
+ *
+ * @param out Output frame, at least 8 bytes.
+ * @return size_t Frame length (8).
+ */
+size_t modbus_rtu_read_request(uint8_t *out, uint8_t unit, uint8_t function, uint16_t start, uint16_t count);
+
+/**
+ * @brief Encodes a write-single request (0x06).
+ *
+ * @param out Output frame, at least 8 bytes.
+ * @return size_t Frame length (8).
+ */
+size_t modbus_rtu_write_single_request(uint8_t *out, uint8_t unit, uint16_t reg, uint16_t value);
+
+/**
+ * @brief Encodes a write-multiple request (0x10).
+ *
+ * @param out Output frame, at least 9 + 2 * count bytes.
+ * @param values count register values, 1 .. MODBUS_MAX_WRITE.
+ * @return size_t Frame length, or 0 if count is out of range.
+ */
+size_t modbus_rtu_write_multiple_request(uint8_t *out, uint8_t unit, uint16_t start, const uint16_t *values,
+                                         uint16_t count);
+
+/**
+ * @brief Encodes an exception response.
+ *
+ * @param out Output frame, at least 5 bytes.
+ * @return size_t Frame length (5).
+ */
+size_t modbus_rtu_exception(uint8_t *out, uint8_t unit, uint8_t function, uint8_t code);
+
+/**
+ * @brief Checks and decodes the response to a read request.
+ *
+ * @param frame Response frame including the CRC.
+ * @param len Frame length.
+ * @param unit Unit the request went to.
+ * @param function Function of the request.
+ * @param count Registers requested.
+ * @param regs Output, count register values.
+ * @param exception Output, the exception code when MODBUS_ERR_EXCEPTION is returned; may be NULL.
+ * @return int count on success, or a negative MODBUS_ERR_* code.
+ */
+int modbus_rtu_parse_read(const uint8_t *frame, size_t len, uint8_t unit, uint8_t function, uint16_t count,
+                          uint16_t *regs, uint8_t *exception);
+
+/**
+ * @brief Reads a big-endian register value.
+ */
+static inline uint16_t modbus_get16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Writes a big-endian register value.
+ */
+static inline void modbus_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+#endif // MODBUS_RTU_H
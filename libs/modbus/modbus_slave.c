@@ -0,0 +1,203 @@
+/**
+ * @file modbus_slave.c
+ * @brief Modbus-RTU slave: answers register requests from a list of mapped regions.
+ */
+
+#include "modbus_slave.h"
+
+void modbus_slave_init(modbus_slave_t *s, const modbus_region_t *regions, size_t n_regions, bool gateway)
+{
+    s->regions = regions;
+    s->n_regions = n_regions;
+    s->gateway = gateway;
+    s->stats = (modbus_slave_stats_t){0};
+}
+
+/**
+ * @brief True if any region belongs to the unit.
+ */
+static bool unit_known(const modbus_slave_t *s, uint8_t unit)
+{
+    for (size_t i = 0; i < s->n_regions; i++)
+    {
+        if (s->regions[i].unit == unit)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Region of a unit and table holding the whole range, or NULL.
+ */
+static const modbus_region_t *find_region(const modbus_slave_t *s, uint8_t unit, modbus_table_t table,
+                                          uint16_t start, uint16_t count)
+{
+    for (size_t i = 0; i < s->n_regions; i++)
+    {
+        const modbus_region_t *r = &s->regions[i];
+        if (r->unit == unit && r->table == table && start >= r->start &&
+            (uint32_t)start + count <= (uint32_t)r->start + r->count)
+        {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes registers to a unit's writable holding region; returns an exception code or 0.
+ */
+static uint8_t write_regs(modbus_slave_t *s, uint8_t unit, uint16_t start, const uint8_t *values, uint16_t count)
+{
+    const modbus_region_t *r = find_region(s, unit, MODBUS_TABLE_HOLDING, start, count);
+    if (r == NULL || !r->writable || r->remote)
+    {
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+    }
+    for (uint16_t i = 0; i < count; i++)
+    {
+        r->regs[start - r->start + i] = modbus_get16(values + 2u * i);
+    }
+    s->stats.writes += count;
+    return 0;
+}
+
+/**
+ * @brief Applies a request (length including the CRC) to one unit.
+ *
+ * @param ex Output, the exception code (0 if none).
+ * @return size_t Response length, 0 on an exception.
+ */
+static size_t serve(modbus_slave_t *s, uint8_t unit, const uint8_t *req, size_t len, uint8_t *resp, uint8_t *ex)
+{
+    uint8_t function = req[1];
+    uint16_t start = (len >= 8u) ? modbus_get16(req + 2) : 0;
+    uint16_t value = (len >= 8u) ? modbus_get16(req + 4) : 0;
+    *ex = 0;
+
+    switch (function)
+    {
+    case MODBUS_FC_READ_HOLDING:
+    case MODBUS_FC_READ_INPUT:
+    {
+        if (len != 8u || value == 0 || value > MODBUS_MAX_READ)
+        {
+            *ex = MODBUS_EX_ILLEGAL_VALUE;
+            return 0;
+        }
+        modbus_table_t table = (function == MODBUS_FC_READ_HOLDING) ? MODBUS_TABLE_HOLDING : MODBUS_TABLE_INPUT;
+        const modbus_region_t *r = find_region(s, unit, table, start, value);
+        if (r == NULL)
+        {
+            *ex = MODBUS_EX_ILLEGAL_ADDRESS;
+            return 0;
+        }
+        if (r->valid != NULL && !*r->valid)
+        {
+            *ex = MODBUS_EX_GATEWAY_TARGET;
+            return 0;
+        }
+        resp[0] = unit;
+        resp[1] = function;
+        resp[2] = (uint8_t)(2u * value);
+        for (uint16_t i = 0; i < value; i++)
+        {
+            modbus_put16(resp + 3 + 2u * i, r->regs[start - r->start + i]);
+        }
+        return modbus_rtu_seal(resp, 3u + 2u * value);
+    }
+    case MODBUS_FC_WRITE_SINGLE:
+    {
+        if (len != 8u)
+        {
+            *ex = MODBUS_EX_ILLEGAL_VALUE;
+            return 0;
+        }
+        *ex = write_regs(s, unit, start, req + 4, 1);
+        if (*ex)
+        {
+            return 0;
+        }
+        // The response echoes the request.
+        for (size_t i = 0; i < 6u; i++)
+        {
+            resp[i] = req[i];
+        }
+        return modbus_rtu_seal(resp, 6);
+    }
+    case MODBUS_FC_WRITE_MULTIPLE:
+    {
+        if (len < 11u || value == 0 || value > MODBUS_MAX_WRITE || req[6] != 2u * value || len != 9u + 2u * value)
+        {
+            *ex = MODBUS_EX_ILLEGAL_VALUE;
+            return 0;
+        }
+        *ex = write_regs(s, unit, start, req + 7, value);
+        if (*ex)
+        {
+            return 0;
+        }
+        resp[0] = unit;
+        resp[1] = function;
+        modbus_put16(resp + 2, start);
+        modbus_put16(resp + 4, value);
+        return modbus_rtu_seal(resp, 6);
+    }
+    default:
+        *ex = MODBUS_EX_ILLEGAL_FUNCTION;
+        return 0;
+    }
+}
+
+size_t modbus_slave_handle(modbus_slave_t *s, const uint8_t *req, size_t len, uint8_t *resp)
+{
+    if (!modbus_rtu_frame_ok(req, len))
+    {
+        s->stats.crc_errors++;
+        return 0;
+    }
+    s->stats.requests++;
+    uint8_t unit = req[0];
+    uint8_t ex;
+
+    if (unit == MODBUS_BROADCAST)
+    {
+        // Writes only, to every local unit, never answered.
+        for (size_t i = 0; i < s->n_regions; i++)
+        {
+            const modbus_region_t *r = &s->regions[i];
+            bool first = true;
+            for (size_t j = 0; j < i; j++)
+            {
+                first = first && s->regions[j].unit != r->unit;
+            }
+            if (first && !r->remote && (req[1] == MODBUS_FC_WRITE_SINGLE || req[1] == MODBUS_FC_WRITE_MULTIPLE))
+            {
+                serve(s, r->unit, req, len, resp, &ex);
+            }
+        }
+        return 0;
+    }
+
+    if (!unit_known(s, unit))
+    {
+        if (!s->gateway)
+        {
+            s->stats.ignored++;
+            return 0;
+        }
+        ex = MODBUS_EX_GATEWAY_PATH;
+    }
+    else
+    {
+        size_t n = serve(s, unit, req, len, resp, &ex);
+        if (!ex)
+        {
+            return n;
+        }
+    }
+    s->stats.exceptions++;
+    return modbus_rtu_exception(resp, unit, req[1], ex);
+}
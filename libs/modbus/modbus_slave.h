@@ -0,0 +1,86 @@
+/**
+ * @file modbus_slave.h
+ * @brief Modbus-RTU slave: answers register requests from a list of mapped regions.
+ *
+ * @details
+ * The register map is a list of regions, each a block of registers of one unit and one
+ * table (holding or input) backed by a plain uint16_t array that the application updates,
+ * e.g. with ADC or LiDAR readings. A request is served only if its whole range falls in one
+ * region; otherwise the slave answers ILLEGAL ADDRESS. Writes are accepted on writable
+ * holding regions only.
+ *
+ * One slave can serve several units. A gateway maps the registers it caches from other
+ * units (modbus_master.h) as read-only regions that are valid only while the cache is
+ * fresh, and answers GATEWAY TARGET when it is not. Requests for a unit with no region are
+ * ignored, as a slave on a shared bus must, or answered with GATEWAY PATH in gateway mode.
+ *
+ * Broadcast writes (unit 0) go to every local unit and are never answered.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef MODBUS_SLAVE_H
+#define MODBUS_SLAVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "modbus_rtu.h"
+
+typedef enum modbus_table
+{
+    MODBUS_TABLE_HOLDING = 0, ///< Read with 0x03, written with 0x06/0x10.
+    MODBUS_TABLE_INPUT,       ///< Read with 0x04, read-only.
+} modbus_table_t;
+
+typedef struct modbus_region
+{
+    uint8_t unit;               ///< Unit address.
+    modbus_table_t table;       ///< Register table.
+    uint16_t start;             ///< First register address.
+    uint16_t count;             ///< Number of registers.
+    uint16_t *regs;             ///< Backing storage, count values.
+    bool writable;              ///< Holding registers the master may write.
+    bool remote;                ///< Cached from another unit (not a broadcast target).
+    const volatile bool *valid; ///< Served only while *valid, if not NULL.
+} modbus_region_t;
+
+typedef struct modbus_slave_stats
+{
+    uint32_t requests;   ///< Intact frames received.
+    uint32_t crc_errors; ///< Frames dropped for a bad CRC or length.
+    uint32_t ignored;    ///< Frames for units not served here.
+    uint32_t exceptions; ///< Exception responses sent.
+    uint32_t writes;     ///< Registers written.
+} modbus_slave_stats_t;
+
+typedef struct modbus_slave
+{
+    const modbus_region_t *regions; ///< Register map.
+    size_t n_regions;               ///< Number of regions.
+    bool gateway;                   ///< Answer unknown units with GATEWAY PATH.
+    modbus_slave_stats_t stats;     ///< Counters.
+} modbus_slave_t;
+
+/**
+ * @brief Initializes a slave over a register map.
+ *
+ * @param s Pointer to the slave.
+ * @param regions Register map; regions of a unit and table must not overlap.
+ * @param n_regions Number of regions.
+ * @param gateway Answer requests for unmapped units instead of ignoring them.
+ */
+void modbus_slave_init(modbus_slave_t *s, const modbus_region_t *regions, size_t n_regions, bool gateway);
+
+/**
+ * @brief Handles one received frame.
+ *
+ * @param s Pointer to the slave.
+ * @param req Frame as received, including the CRC.
+ * @param len Frame length.
+ * @param resp Output response, MODBUS_RTU_MAX_FRAME bytes.
+ * @return size_t Response length, 0 when nothing must be sent.
+ */
+size_t modbus_slave_handle(modbus_slave_t *s, const uint8_t *req, size_t len, uint8_t *resp);
+
+#endif // MODBUS_SLAVE_H
@@ -0,0 +1,491 @@
+/**
+ * @file test_modbus.c
+ * @brief Modbus-RTU framing on recorded frames, the slave and master, and the loopback bus.
+ *
+ * @details
+ * The framing is checked against frames taken from the Modbus specification examples and
+ * from a bus capture: the check value of CRC-16/MODBUS, the encoded requests byte for byte,
+ * t3.5 and t1.5 below and above 19200 baud, and every error modbus_rtu_parse_read() reports.
+ * The table CRC must also agree with a bitwise one on random blocks.
+ *
+ * The slave must answer the recorded requests with the recorded responses, raise the
+ * exceptions of its register map, ignore other units and bad frames, and apply broadcast
+ * writes without answering. The master is stepped call by call through a poll, a timeout,
+ * the period and the cache age.
+ *
+ * modbus_loop_run() then joins a master to two slaves: every cache must end up equal to the
+ * slave registers, and dropped, corrupted and late responses must show up as timeouts and
+ * errors one for one.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "modbus_rtu.h"
+#include "modbus_slave.h"
+#include "modbus_master.h"
+#include "modbus_loop.h"
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+/** A recorded frame, CRC included. */
+typedef struct frame
+{
+    uint8_t bytes[16];
+    size_t len;
+} frame_t;
+
+// Read 3 holding registers from 0x6B of unit 0x11, and the answer
+static const frame_t read_req = {{0x11, 0x03, 0x00, 0x6B, 0x00, 0x03, 0x76, 0x87}, 8};
+static const frame_t read_resp = {{0x11, 0x03, 0x06, 0xAE, 0x41, 0x56, 0x52, 0x43, 0x40, 0x49, 0xAD}, 11};
+// Write 3 to register 1, answered with an echo
+static const frame_t write_single = {{0x11, 0x06, 0x00, 0x01, 0x00, 0x03, 0x9A, 0x9B}, 8};
+// Write 0x000A, 0x0102 from register 1, and the answer
+static const frame_t write_multi_req = {{0x11, 0x10, 0x00, 0x01, 0x00, 0x02, 0x04, 0x00, 0x0A, 0x01, 0x02, 0xC6, 0xF0}, 13};
+static const frame_t write_multi_resp = {{0x11, 0x10, 0x00, 0x01, 0x00, 0x02, 0x12, 0x98}, 8};
+// Read 10 holding registers from 0 of unit 1
+static const frame_t read10_req = {{0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD}, 8};
+// ILLEGAL ADDRESS to a read coils request of unit 0x0A
+static const frame_t exception_resp = {{0x0A, 0x81, 0x02, 0xB0, 0x53}, 5};
+
+/**
+ * @brief Bitwise CRC-16/MODBUS, the reference for the table.
+ */
+static uint16_t crc_bitwise(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++)
+        {
+            crc = (crc & 1u) ? (uint16_t)((crc >> 1) ^ 0xA001u) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static bool same(const uint8_t *out, size_t len, const frame_t *f)
+{
+    return len == f->len && memcmp(out, f->bytes, len) == 0;
+}
+
+static void test_crc(void)
+{
+    CHECK_EQ(modbus_crc16(0xFFFF, (const uint8_t *)"123456789", 9), 0x4B37);
+
+    uint8_t buf[MODBUS_RTU_MAX_FRAME];
+    for (int run = 0; run < 200; run++)
+    {
+        size_t len = (size_t)rand() % (sizeof(buf) - 1u);
+        for (size_t i = 0; i < len; i++)
+        {
+            buf[i] = (uint8_t)rand();
+        }
+        uint16_t crc = crc_bitwise(buf, len);
+        CHECK_EQ(modbus_crc16(0xFFFF, buf, len), crc);
+
+        // Split anywhere, the running CRC is the same
+        size_t split = len ? (size_t)rand() % len : 0u;
+        CHECK_EQ(modbus_crc16(modbus_crc16(0xFFFF, buf, split), buf + split, len - split), crc);
+    }
+
+    const frame_t *recorded[] = {&read_req, &read_resp, &write_single, &write_multi_req, &write_multi_resp,
+                                 &read10_req, &exception_resp};
+    for (size_t i = 0; i < ARRAY_LEN(recorded); i++)
+    {
+        const frame_t *f = recorded[i];
+        CHECK(modbus_rtu_frame_ok(f->bytes, f->len));
+        memcpy(buf, f->bytes, f->len - 2u);
+        CHECK(same(buf, modbus_rtu_seal(buf, f->len - 2u), f));
+
+        // Any single bit flip is caught
+        for (size_t bit = 0; bit < 8u * f->len; bit++)
+        {
+            memcpy(buf, f->bytes, f->len);
+            buf[bit / 8u] ^= (uint8_t)(1u << (bit % 8u));
+            CHECK(!modbus_rtu_frame_ok(buf, f->len));
+        }
+        CHECK(!modbus_rtu_frame_ok(f->bytes, f->len - 1u));
+    }
+    CHECK(!modbus_rtu_frame_ok(exception_resp.bytes, 3));
+}
+
+static void test_encode(void)
+{
+    uint8_t out[MODBUS_RTU_MAX_FRAME];
+    CHECK(same(out, modbus_rtu_read_request(out, 0x11, MODBUS_FC_READ_HOLDING, 0x6B, 3), &read_req));
+    CHECK(same(out, modbus_rtu_read_request(out, 0x01, MODBUS_FC_READ_HOLDING, 0, 10), &read10_req));
+    CHECK(same(out, modbus_rtu_write_single_request(out, 0x11, 1, 3), &write_single));
+    const uint16_t values[] = {0x000A, 0x0102};
+    CHECK(same(out, modbus_rtu_write_multiple_request(out, 0x11, 1, values, 2), &write_multi_req));
+    CHECK(same(out, modbus_rtu_exception(out, 0x0A, 0x01, MODBUS_EX_ILLEGAL_ADDRESS), &exception_resp));
+
+    uint16_t many[MODBUS_MAX_WRITE + 1u] = {0};
+    CHECK_EQ(modbus_rtu_write_multiple_request(out, 1, 0, many, 0), 0);
+    CHECK_EQ(modbus_rtu_write_multiple_request(out, 1, 0, many, MODBUS_MAX_WRITE + 1u), 0);
+    CHECK_EQ(modbus_rtu_write_multiple_request(out, 1, 0, many, MODBUS_MAX_WRITE), 9u + 2u * MODBUS_MAX_WRITE);
+    CHECK(9u + 2u * MODBUS_MAX_WRITE <= MODBUS_RTU_MAX_FRAME);
+    CHECK(5u + 2u * MODBUS_MAX_READ <= MODBUS_RTU_MAX_FRAME);
+
+    // 3.5 and 1.5 characters of 11 bits, rounded up; fixed above 19200 baud
+    CHECK_EQ(modbus_rtu_t35_us(9600, 11), 4011);
+    CHECK_EQ(modbus_rtu_t15_us(9600, 11), 1719);
+    CHECK_EQ(modbus_rtu_t35_us(19200, 11), 2006);
+    CHECK_EQ(modbus_rtu_t15_us(19200, 11), 860);
+    CHECK_EQ(modbus_rtu_t35_us(19200, 10), 1823);
+    CHECK_EQ(modbus_rtu_t35_us(19201, 11), 1750);
+    CHECK_EQ(modbus_rtu_t15_us(115200, 10), 750);
+}
+
+static void test_parse(void)
+{
+    uint16_t regs[MODBUS_MAX_READ];
+    uint8_t ex = 0;
+    uint8_t buf[MODBUS_RTU_MAX_FRAME];
+    const uint8_t *r = read_resp.bytes;
+    size_t n = read_resp.len;
+
+    CHECK_EQ(modbus_rtu_parse_read(r, n, 0x11, MODBUS_FC_READ_HOLDING, 3, regs, &ex), 3);
+    CHECK_EQ(regs[0], 0xAE41);
+    CHECK_EQ(regs[1], 0x5652);
+    CHECK_EQ(regs[2], 0x4340);
+
+    CHECK_EQ(modbus_rtu_parse_read(r, 4, 0x11, MODBUS_FC_READ_HOLDING, 3, regs, &ex), MODBUS_ERR_SHORT);
+    CHECK_EQ(modbus_rtu_parse_read(r, n - 1u, 0x11, MODBUS_FC_READ_HOLDING, 3, regs, &ex), MODBUS_ERR_CRC);
+    CHECK_EQ(modbus_rtu_parse_read(r, n, 0x12, MODBUS_FC_READ_HOLDING, 3, regs, &ex), MODBUS_ERR_UNIT);
+    CHECK_EQ(modbus_rtu_parse_read(r, n, 0x11, MODBUS_FC_READ_INPUT, 3, regs, &ex), MODBUS_ERR_FUNCTION);
+    CHECK_EQ(modbus_rtu_parse_read(r, n, 0x11, MODBUS_FC_READ_HOLDING, 2, regs, &ex), MODBUS_ERR_COUNT);
+    memcpy(buf, r, n);
+    buf[4] ^= 0x10;
+    CHECK_EQ(modbus_rtu_parse_read(buf, n, 0x11, MODBUS_FC_READ_HOLDING, 3, regs, &ex), MODBUS_ERR_CRC);
+
+    // The byte count says 3 registers, the frame holds 2
+    memcpy(buf, r, 7);
+    CHECK_EQ(modbus_rtu_parse_read(buf, modbus_rtu_seal(buf, 7), 0x11, MODBUS_FC_READ_HOLDING, 3, regs, &ex),
+             MODBUS_ERR_SHORT);
+
+    // An exception is reported with its code, for the function of the request only
+    CHECK_EQ(modbus_rtu_parse_read(exception_resp.bytes, exception_resp.len, 0x0A, 0x01, 1, regs, &ex),
+             MODBUS_ERR_EXCEPTION);
+    CHECK_EQ(ex, MODBUS_EX_ILLEGAL_ADDRESS);
+    CHECK_EQ(modbus_rtu_parse_read(exception_resp.bytes, exception_resp.len, 0x0A, 0x01, 1, regs, NULL),
+             MODBUS_ERR_EXCEPTION);
+    CHECK_EQ(modbus_rtu_parse_read(exception_resp.bytes, exception_resp.len, 0x0A, MODBUS_FC_READ_HOLDING, 1, regs,
+                                   &ex),
+             MODBUS_ERR_FUNCTION);
+}
+
+/**
+ * @brief Hands a frame to the slave and returns the exception code of its answer.
+ *
+ * @return int 0 for a normal answer, -1 for no answer.
+ */
+static int exchange(modbus_slave_t *s, const uint8_t *req, size_t len)
+{
+    uint8_t resp[MODBUS_RTU_MAX_FRAME];
+    size_t n = modbus_slave_handle(s, req, len, resp);
+    if (n == 0)
+    {
+        return -1;
+    }
+    CHECK(modbus_rtu_frame_ok(resp, n));
+    CHECK_EQ(resp[0], req[0]);
+    if (resp[1] & MODBUS_FC_EXCEPTION)
+    {
+        CHECK_EQ(n, 5);
+        CHECK_EQ(resp[1], req[1] | MODBUS_FC_EXCEPTION);
+        return resp[2];
+    }
+    return 0;
+}
+
+static void test_slave(void)
+{
+    uint16_t holding[0x70] = {0};
+    uint16_t input[4] = {1, 2, 3, 4};
+    uint16_t remote[2] = {7, 8};
+    uint16_t other[2] = {0};
+    bool remote_valid = true;
+    holding[0x6B] = 0xAE41;
+    holding[0x6C] = 0x5652;
+    holding[0x6D] = 0x4340;
+    const modbus_region_t regions[] = {
+        {.unit = 0x11, .table = MODBUS_TABLE_HOLDING, .start = 0, .count = 0x70, .regs = holding, .writable = true},
+        {.unit = 0x11, .table = MODBUS_TABLE_INPUT, .start = 200, .count = 4, .regs = input},
+        {.unit = 0x12, .table = MODBUS_TABLE_HOLDING, .start = 0, .count = 2, .regs = other, .writable = true},
+        {.unit = 0x20, .table = MODBUS_TABLE_HOLDING, .start = 0, .count = 2, .regs = remote, .remote = true,
+         .valid = &remote_valid},
+    };
+    modbus_slave_t s;
+    modbus_slave_init(&s, regions, ARRAY_LEN(regions), false);
+
+    // Recorded exchanges
+    uint8_t resp[MODBUS_RTU_MAX_FRAME];
+    CHECK(same(resp, modbus_slave_handle(&s, read_req.bytes, read_req.len, resp), &read_resp));
+    CHECK(same(resp, modbus_slave_handle(&s, write_single.bytes, write_single.len, resp), &write_single));
+    CHECK_EQ(holding[1], 3);
+    CHECK(same(resp, modbus_slave_handle(&s, write_multi_req.bytes, write_multi_req.len, resp), &write_multi_resp));
+    CHECK_EQ(holding[1], 0x000A);
+    CHECK_EQ(holding[2], 0x0102);
+    CHECK_EQ(s.stats.writes, 3);
+
+    // Exceptions of the register map
+    uint8_t req[MODBUS_RTU_MAX_FRAME];
+    size_t n;
+    n = modbus_rtu_read_request(req, 0x11, MODBUS_FC_READ_INPUT, 200, 4);
+    CHECK_EQ(exchange(&s, req, n), 0);
+    n = modbus_rtu_read_request(req, 0x11, MODBUS_FC_READ_INPUT, 201, 4); // One past the end
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_ADDRESS);
+    n = modbus_rtu_read_request(req, 0x11, MODBUS_FC_READ_HOLDING, 0x6F, 2);
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_ADDRESS);
+    n = modbus_rtu_read_request(req, 0x11, MODBUS_FC_READ_HOLDING, 0, 0);
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_VALUE);
+    n = modbus_rtu_read_request(req, 0x11, MODBUS_FC_READ_HOLDING, 0, MODBUS_MAX_READ + 1u);
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_VALUE);
+    n = modbus_rtu_write_single_request(req, 0x11, 200, 1); // Input registers are read-only
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_ADDRESS);
+    n = modbus_rtu_write_single_request(req, 0x20, 0, 1); // So are the cached ones
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_ADDRESS);
+    n = modbus_rtu_read_request(req, 0x11, 0x01, 0, 1); // Read coils
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_ILLEGAL_FUNCTION);
+    memcpy(req, write_multi_req.bytes, 11);
+    req[6] = 6; // Byte count disagrees with the register count
+    CHECK_EQ(exchange(&s, req, modbus_rtu_seal(req, 11)), MODBUS_EX_ILLEGAL_VALUE);
+    CHECK_EQ(holding[1], 0x000A);
+
+    // Cached registers are served while fresh
+    n = modbus_rtu_read_request(req, 0x20, MODBUS_FC_READ_HOLDING, 0, 2);
+    CHECK_EQ(exchange(&s, req, n), 0);
+    remote_valid = false;
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_GATEWAY_TARGET);
+    CHECK_EQ(s.stats.exceptions, 9);
+
+    // Other units and bad frames get no answer
+    uint32_t requests = s.stats.requests;
+    n = modbus_rtu_read_request(req, 0x33, MODBUS_FC_READ_HOLDING, 0, 1);
+    CHECK_EQ(exchange(&s, req, n), -1);
+    CHECK_EQ(s.stats.ignored, 1);
+    CHECK_EQ(exchange(&s, read_req.bytes, read_req.len - 1u), -1);
+    CHECK_EQ(exchange(&s, read_req.bytes, 3), -1);
+    CHECK_EQ(s.stats.crc_errors, 2);
+    CHECK_EQ(s.stats.requests, requests + 1u);
+
+    // A gateway answers unknown units
+    s.gateway = true;
+    n = modbus_rtu_read_request(req, 0x33, MODBUS_FC_READ_HOLDING, 0, 1);
+    CHECK_EQ(exchange(&s, req, n), MODBUS_EX_GATEWAY_PATH);
+
+    // Broadcast writes reach every local unit once, never the cached one, and get no answer
+    n = modbus_rtu_write_single_request(req, MODBUS_BROADCAST, 0, 0x5A5A);
+    CHECK_EQ(exchange(&s, req, n), -1);
+    CHECK_EQ(holding[0], 0x5A5A);
+    CHECK_EQ(other[0], 0x5A5A);
+    CHECK_EQ(remote[0], 7);
+    n = modbus_rtu_read_request(req, MODBUS_BROADCAST, MODBUS_FC_READ_HOLDING, 0, 1);
+    CHECK_EQ(exchange(&s, req, n), -1);
+}
+
+static void test_master(void)
+{
+    uint16_t cache[3];
+    modbus_poll_t polls[] = {
+        {.unit = 0x11, .function = MODBUS_FC_READ_HOLDING, .start = 0x6B, .count = 3, .cache = cache},
+    };
+    modbus_master_t m;
+    modbus_master_init(&m, polls, 1, 100000u, 20000u, 150000u, 2000u);
+    modbus_poll_t *p = &polls[0];
+    uint8_t out[MODBUS_RTU_MAX_FRAME];
+
+    // The first request is due at once and is the recorded one
+    CHECK(same(out, modbus_master_poll(&m, 0, out), &read_req));
+    CHECK_EQ(modbus_master_poll(&m, 10, out), 0);
+
+    // Frames from another unit are counted and the master keeps waiting
+    uint8_t other[MODBUS_RTU_MAX_FRAME];
+    memcpy(other, read_resp.bytes, read_resp.len - 2u);
+    other[0] = 0x12;
+    modbus_master_on_frame(&m, other, modbus_rtu_seal(other, read_resp.len - 2u), 3000);
+    CHECK_EQ(p->errors, 1);
+    CHECK(m.waiting);
+
+    modbus_master_on_frame(&m, read_resp.bytes, read_resp.len, 5000);
+    CHECK_EQ(p->ok, 1);
+    CHECK(p->valid);
+    CHECK_EQ(p->latency_us, 5000);
+    CHECK_EQ(cache[0], 0xAE41);
+    CHECK_EQ(cache[2], 0x4340);
+
+    // A response nobody waits for is ignored
+    modbus_master_on_frame(&m, exception_resp.bytes, exception_resp.len, 6000);
+    CHECK_EQ(p->errors + p->exceptions, 1);
+
+    // The next pass starts a period after the first
+    CHECK_EQ(modbus_master_poll(&m, 99999u, out), 0);
+    CHECK_EQ(modbus_master_poll(&m, 100000u, out), 8);
+
+    // No answer: a timeout 20 ms later, and the pass after that is a period later again
+    CHECK_EQ(modbus_master_poll(&m, 119999u, out), 0);
+    CHECK_EQ(p->timeouts, 0);
+    CHECK_EQ(modbus_master_poll(&m, 120000u, out), 0);
+    CHECK_EQ(p->timeouts, 1);
+    CHECK(p->valid);
+
+    // The cache goes stale 150 ms after the last good response
+    modbus_master_poll(&m, 154999u, out);
+    CHECK(p->valid);
+    modbus_master_poll(&m, 155000u, out);
+    CHECK(!p->valid);
+
+    // An exception is counted with its code and ends the poll
+    CHECK_EQ(modbus_master_poll(&m, 200000u, out), 8);
+    uint8_t ex[8];
+    modbus_master_on_frame(&m, ex, modbus_rtu_exception(ex, 0x11, MODBUS_FC_READ_HOLDING, 0x04), 204000u);
+    CHECK_EQ(p->exceptions, 1);
+    CHECK_EQ(p->last_exception, 0x04);
+    CHECK(!m.waiting);
+    CHECK(!p->valid);
+
+    // Times are compared modulo 2^32, up to 2^31 apart
+    modbus_master_init(&m, polls, 1, 100000u, 20000u, 0x40000000u, 2000u);
+    static const uint32_t starts[] = {0u, 0x60000000u, 0xC0000000u, 0xFFFFF000u};
+    for (size_t i = 0; i < ARRAY_LEN(starts); i++)
+    {
+        CHECK_EQ(modbus_master_poll(&m, starts[i], out), 8);
+        modbus_master_on_frame(&m, read_resp.bytes, read_resp.len, starts[i] + 5000u);
+        CHECK_EQ(p->latency_us, 5000);
+    }
+    CHECK_EQ(modbus_master_poll(&m, 0xFFFFF000u + 99999u, out), 0);
+    CHECK_EQ(modbus_master_poll(&m, 0xFFFFF000u + 100000u, out), 8);
+    CHECK(p->valid);
+}
+
+static void test_loop(void)
+{
+    uint16_t holding[10];
+    uint16_t input[MODBUS_MAX_READ];
+    for (size_t i = 0; i < ARRAY_LEN(holding); i++)
+    {
+        holding[i] = (uint16_t)(0x1000u + i);
+    }
+    for (size_t i = 0; i < ARRAY_LEN(input); i++)
+    {
+        input[i] = (uint16_t)rand();
+    }
+    const modbus_region_t regions1[] = {
+        {.unit = 1, .table = MODBUS_TABLE_HOLDING, .start = 0, .count = 10, .regs = holding},
+    };
+    const modbus_region_t regions2[] = {
+        {.unit = 2, .table = MODBUS_TABLE_INPUT, .start = 300, .count = MODBUS_MAX_READ, .regs = input},
+    };
+    modbus_slave_t s1, s2;
+    modbus_slave_t *const slaves[] = {&s1, &s2};
+
+    uint16_t cache1[10], cache2[MODBUS_MAX_READ], cache3[1];
+    modbus_poll_t polls[] = {
+        {.unit = 1, .function = MODBUS_FC_READ_HOLDING, .start = 0, .count = 10, .cache = cache1},
+        {.unit = 2, .function = MODBUS_FC_READ_INPUT, .start = 300, .count = MODBUS_MAX_READ, .cache = cache2},
+        {.unit = 3, .function = MODBUS_FC_READ_HOLDING, .start = 0, .count = 1, .cache = cache3},
+    };
+
+    // Baud rate, slave delay, drop and corrupt intervals. The last slave answers after the
+    // master's timeout.
+    static const struct
+    {
+        uint32_t baud, delay, drop, corrupt;
+    } cases[] = {
+        {19200u, 1000u, 0u, 0u},
+        {115200u, 200u, 0u, 0u},
+        {9600u, 2000u, 5u, 0u},
+        {115200u, 200u, 0u, 7u},
+        {38400u, 500u, 4u, 3u},
+        {115200u, 400000u, 0u, 0u},
+    };
+    for (size_t c = 0; c < ARRAY_LEN(cases); c++)
+    {
+        modbus_loop_config_t cfg = {
+            .baud_rate = cases[c].baud,
+            .char_bits = 11u,
+            .response_delay_us = cases[c].delay,
+            .drop_every = cases[c].drop,
+            .corrupt_every = cases[c].corrupt,
+        };
+        uint32_t gap = modbus_rtu_t35_us(cfg.baud_rate, cfg.char_bits);
+        modbus_slave_init(&s1, regions1, 1, false);
+        modbus_slave_init(&s2, regions2, 1, false);
+        memset(cache1, 0, sizeof(cache1));
+        memset(cache2, 0, sizeof(cache2));
+        modbus_master_t m;
+        modbus_master_init(&m, polls, ARRAY_LEN(polls), 500000u, 400000u, 2000000u, gap);
+
+        modbus_loop_result_t res;
+        modbus_loop_run(&m, slaves, ARRAY_LEN(slaves), &cfg, 10000000u, &res);
+        CHECK(res.end_us >= 10000000u);
+
+        // Every request is accounted for once, except one still waiting at the end
+        uint32_t accounted = 0;
+        for (size_t i = 0; i < ARRAY_LEN(polls); i++)
+        {
+            accounted += polls[i].ok + polls[i].timeouts + polls[i].errors + polls[i].exceptions;
+            CHECK_EQ(polls[i].exceptions, 0);
+        }
+        CHECK_EQ(res.requests, accounted + m.waiting);
+        CHECK_EQ(polls[2].ok, 0);
+
+        // Lost and late responses time out, corrupted ones are errors
+        uint32_t timeouts = polls[0].timeouts + polls[1].timeouts;
+        uint32_t errors = polls[0].errors + polls[1].errors;
+        uint32_t ok = polls[0].ok + polls[1].ok;
+        CHECK_EQ(res.responses, res.requests - polls[2].timeouts - (m.waiting && m.current == 2u));
+        CHECK(timeouts <= res.dropped + res.late && timeouts + 1u >= res.dropped + res.late);
+        CHECK_EQ(errors, res.corrupted);
+        CHECK_EQ(ok, res.responses - res.dropped - res.corrupted - res.late);
+        if (!cases[c].drop)
+        {
+            CHECK_EQ(res.dropped, 0);
+        }
+        if (!cases[c].corrupt)
+        {
+            CHECK_EQ(res.corrupted, 0);
+        }
+
+        if (cfg.response_delay_us >= m.timeout_us)
+        {
+            CHECK_EQ(ok, 0);
+            CHECK_EQ(res.late, res.responses);
+            CHECK(!polls[0].valid && !polls[1].valid);
+            continue;
+        }
+        CHECK_EQ(res.late, 0);
+        CHECK(polls[0].ok >= 5u && polls[1].ok >= 5u);
+        CHECK(polls[0].valid && polls[1].valid);
+        CHECK(!polls[2].valid);
+        CHECK(memcmp(cache1, holding, sizeof(holding)) == 0);
+        CHECK(memcmp(cache2, input, sizeof(input)) == 0);
+
+        // Latency is the two frames, two gaps and the slave delay at the line rate
+        for (size_t i = 0; i < 2u; i++)
+        {
+            size_t resp_len = 5u + 2u * polls[i].count;
+            uint64_t bits = (uint64_t)(8u + resp_len) * cfg.char_bits * 1000000u;
+            uint32_t latency = (uint32_t)(bits / cfg.baud_rate) + 2u * gap + cfg.response_delay_us;
+            CHECK_RANGE(polls[i].latency_us, latency, latency + 2u);
+            CHECK_EQ(polls[i].max_latency_us, polls[i].latency_us);
+        }
+    }
+}
+
+int main(void)
+{
+    srand(14);
+
+    test_crc();
+    test_encode();
+    test_parse();
+    test_slave();
+    test_master();
+    test_loop();
+
+    return host_test_result("modbus");
+}
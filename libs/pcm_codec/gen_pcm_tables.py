@@ -0,0 +1,120 @@
+"""
+Generates pcm_tables.c: the G.711 companding tables used by pcm_codec.c.
+
+- pcm_ulaw_encode / pcm_alaw_encode: the 8-bit code of every 12-bit ADC value. The ADC value
+  is centred on 2048 and scaled to 16-bit linear PCM, (code - 2048) << 4, then encoded with
+  the ITU-T G.711 segment rules (same results as the reference g711.c).
+- pcm_ulaw_decode / pcm_alaw_decode: the 12-bit ADC value that each 8-bit code stands for,
+  rounded (half counts down) and clamped to 0 .. 4095.
+
+Usage:
+    python gen_pcm_tables.py > pcm_tables.c
+"""
+
+ADC_BITS = 12
+ADC_MID = 1 << (ADC_BITS - 1)
+SHIFT = 16 - ADC_BITS
+
+ULAW_BIAS = 0x84
+ULAW_CLIP = 8159
+ULAW_SEG_END = [0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF]
+ALAW_SEG_END = [0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF]
+
+
+def segment(value, ends):
+    for i, end in enumerate(ends):
+        if value <= end:
+            return i
+    return len(ends)
+
+
+def linear_to_ulaw(pcm):
+    pcm >>= 2
+    if pcm < 0:
+        pcm = -pcm
+        mask = 0x7F
+    else:
+        mask = 0xFF
+    pcm = min(pcm, ULAW_CLIP) + (ULAW_BIAS >> 2)
+    seg = segment(pcm, ULAW_SEG_END)
+    if seg >= 8:
+        return 0x7F ^ mask
+    return ((seg << 4) | ((pcm >> (seg + 1)) & 0x0F)) ^ mask
+
+
+def ulaw_to_linear(u):
+    u = ~u & 0xFF
+    t = (((u & 0x0F) << 3) + ULAW_BIAS) << ((u & 0x70) >> 4)
+    return (ULAW_BIAS - t) if (u & 0x80) else (t - ULAW_BIAS)
+
+
+def linear_to_alaw(pcm):
+    pcm >>= 3
+    if pcm >= 0:
+        mask = 0xD5
+    else:
+        mask = 0x55
+        pcm = -pcm - 1
+    seg = segment(pcm, ALAW_SEG_END)
+    if seg >= 8:
+        return 0x7F ^ mask
+    aval = seg << 4
+    aval |= ((pcm >> 1) if seg < 2 else (pcm >> seg)) & 0x0F
+    return aval ^ mask
+
+
+def alaw_to_linear(a):
+    a ^= 0x55
+    t = (a & 0x0F) << 4
+    seg = (a & 0x70) >> 4
+    if seg == 0:
+        t += 8
+    elif seg == 1:
+        t += 0x108
+    else:
+        t = (t + 0x108) << (seg - 1)
+    return t if (a & 0x80) else -t
+
+
+def to_adc(linear):
+    # Half counts round down, as the encoder's shifts do, so a code of the smallest steps
+    # decodes to the one ADC value that encodes to it (round() would merge neighbours).
+    code = ADC_MID + ((linear + (1 << (SHIFT - 1)) - 1) >> SHIFT)
+    return max(0, min((1 << ADC_BITS) - 1, code))
+
+
+def table(ctype, name, values, per_line=16):
+    lines = [f"const {ctype} {name}[{len(values)}] = {{"]
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    codes = range(1 << ADC_BITS)
+    ulaw_enc = [linear_to_ulaw((c - ADC_MID) << SHIFT) for c in codes]
+    alaw_enc = [linear_to_alaw((c - ADC_MID) << SHIFT) for c in codes]
+    ulaw_dec = [to_adc(ulaw_to_linear(u)) for u in range(256)]
+    alaw_dec = [to_adc(alaw_to_linear(a)) for a in range(256)]
+
+    print("/**")
+    print(" * @file pcm_tables.c")
+    print(" * @brief G.711 mu-law and A-law tables for 12-bit ADC samples, used by pcm_codec.c.")
+    print(" *")
+    print(" * Generated by gen_pcm_tables.py, do not edit by hand.")
+    print(" */")
+    print()
+    print('#include "pcm_codec.h"')
+    print()
+    print(table("uint8_t", "pcm_ulaw_encode", ulaw_enc))
+    print()
+    print(table("uint8_t", "pcm_alaw_encode", alaw_enc))
+    print()
+    print(table("uint16_t", "pcm_ulaw_decode", ulaw_dec))
+    print()
+    print(table("uint16_t", "pcm_alaw_decode", alaw_dec))
+
+
+if __name__ == "__main__":
+    main()
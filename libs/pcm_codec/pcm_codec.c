@@ -0,0 +1,102 @@
+/**
+ * @file pcm_codec.c
+ * @brief Block PCM encoder/decoder for 12-bit ADC samples: linear 4/8/12-bit and G.711.
+ */
+
+#include "pcm_codec.h"
+#include "sample_frame.h"
+
+size_t pcm_encoded_len(pcm_format_t format, size_t n)
+{
+    switch (format)
+    {
+    case PCM_LINEAR4:
+        return (n + 1u) / 2u;
+    case PCM_LINEAR12:
+        return SAMPLE_FRAME_PACKED12_LEN(n);
+    default:
+        return n;
+    }
+}
+
+/**
+ * @brief One byte per sample through a 4096-entry table.
+ */
+static void pcm_encode_table(const uint8_t *table, const uint16_t *samples, size_t n, uint8_t *out)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = table[samples[i] & (PCM_ADC_CODES - 1u)];
+    }
+}
+
+size_t pcm_encode(pcm_format_t format, const uint16_t *samples, size_t n, uint8_t *out)
+{
+    switch (format)
+    {
+    case PCM_LINEAR4:
+        for (size_t i = 0; i + 1u < n; i += 2u)
+        {
+            *out++ = (uint8_t)(((samples[i] >> 8) & 0x0Fu) | ((samples[i + 1u] >> 4) & 0xF0u));
+        }
+        if (n & 1u)
+        {
+            *out = (uint8_t)((samples[n - 1u] >> 8) & 0x0Fu);
+        }
+        break;
+    case PCM_LINEAR8:
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = (uint8_t)(samples[i] >> 4);
+        }
+        break;
+    case PCM_LINEAR12:
+        return sample_frame_pack12(out, samples, n);
+    case PCM_ULAW:
+        pcm_encode_table(pcm_ulaw_encode, samples, n, out);
+        break;
+    case PCM_ALAW:
+        pcm_encode_table(pcm_alaw_encode, samples, n, out);
+        break;
+    default:
+        return 0;
+    }
+    return pcm_encoded_len(format, n);
+}
+
+void pcm_decode(pcm_format_t format, const uint8_t *in, size_t n, uint16_t *samples)
+{
+    switch (format)
+    {
+    case PCM_LINEAR4:
+        for (size_t i = 0; i < n; i++)
+        {
+            uint8_t nibble = (i & 1u) ? (in[i / 2u] >> 4) : (in[i / 2u] & 0x0Fu);
+            samples[i] = (uint16_t)((nibble << 8) | 0x80u);
+        }
+        break;
+    case PCM_LINEAR8:
+        for (size_t i = 0; i < n; i++)
+        {
+            samples[i] = (uint16_t)((in[i] << 4) | 0x08u);
+        }
+        break;
+    case PCM_LINEAR12:
+        sample_frame_unpack12(samples, in, n);
+        break;
+    case PCM_ULAW:
+        for (size_t i = 0; i < n; i++)
+        {
+            samples[i] = pcm_ulaw_decode[in[i]];
+        }
+        break;
+    case PCM_ALAW:
+        for (size_t i = 0; i < n; i++)
+        {
+            samples[i] = pcm_alaw_decode[in[i]];
+        }
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file pcm_codec.h
+ * @brief Block PCM encoder/decoder for 12-bit ADC samples: linear 4/8/12-bit and G.711.
+ *
+ * @details
+ * A block of ADC samples is quantized and packed in one pass, ready to be handed to a DMA
+ * channel as a single transfer:
+ *
+ * - PCM_LINEAR4: the top 4 bits, two samples per byte, first sample in the low nibble.
+ * - PCM_LINEAR8: the top 8 bits, one byte per sample.
+ * - PCM_LINEAR12: all 12 bits, two samples per three bytes (same packing as sample_frame).
+ * - PCM_ULAW, PCM_ALAW: ITU-T G.711 companding, one byte per sample. The input is taken as
+ *   a bipolar signal centred on mid scale (2048).
+ *
+ * Companding is a single table lookup per sample: the 4096-entry encode tables cover every
+ * ADC value, and 256-entry decode tables map each code back to the ADC value it stands for.
+ * The tables are generated by gen_pcm_tables.py and live in flash (8.5 KB in total).
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef PCM_CODEC_H
+#define PCM_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PCM_ADC_CODES 4096u ///< Number of 12-bit ADC values.
+
+typedef enum pcm_format
+{
+    PCM_LINEAR4 = 0, ///< 4-bit linear, two samples per byte.
+    PCM_LINEAR8,     ///< 8-bit linear.
+    PCM_LINEAR12,    ///< 12-bit linear, two samples per three bytes.
+    PCM_ULAW,        ///< G.711 mu-law.
+    PCM_ALAW,        ///< G.711 A-law.
+} pcm_format_t;
+
+// Generated tables (pcm_tables.c)
+extern const uint8_t pcm_ulaw_encode[PCM_ADC_CODES]; ///< mu-law code of each ADC value.
+extern const uint8_t pcm_alaw_encode[PCM_ADC_CODES]; ///< A-law code of each ADC value.
+extern const uint16_t pcm_ulaw_decode[256];          ///< ADC value of each mu-law code.
+extern const uint16_t pcm_alaw_decode[256];          ///< ADC value of each A-law code.
+
+/**
+ * @brief Bytes needed to encode n samples.
+ */
+size_t pcm_encoded_len(pcm_format_t format, size_t n);
+
+/**
+ * @brief Encodes a block of samples.
+ *
+ * @param format Output format.
+ * @param samples 12-bit ADC samples (higher bits are ignored).
+ * @param n Number of samples.
+ * @param out Destination, at least pcm_encoded_len(format, n) bytes.
+ * @return size_t Number of bytes written.
+ */
+size_t pcm_encode(pcm_format_t format, const uint16_t *samples, size_t n, uint8_t *out);
+
+/**
+ * @brief Decodes a block back to 12-bit ADC values (the centre of each quantization step
+ *        for the linear formats).
+ *
+ * @param format Input format.
+ * @param in Encoded bytes.
+ * @param n Number of samples.
+ * @param samples Destination, n values.
+ */
+void pcm_decode(pcm_format_t format, const uint8_t *in, size_t n, uint16_t *samples);
+
+#endif // PCM_CODEC_H
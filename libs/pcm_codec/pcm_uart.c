@@ -0,0 +1,41 @@
+/**
+ * @file pcm_uart.c
+ * @brief Sends encoded PCM blocks to a UART TX FIFO with one DMA transfer per block.
+ */
+
+#include "pcm_uart.h"
+#include "hardware/dma.h"
+
+void pcm_uart_init(pcm_uart_t *tx, uart_inst_t *uart)
+{
+    tx->uart = uart;
+    tx->blocks = 0;
+    tx->bytes = 0;
+    tx->dropped = 0;
+    tx->dma_chan = (uint)dma_claim_unused_channel(true);
+
+    dma_channel_config cfg = dma_channel_get_default_config(tx->dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false); // Always the data register
+    channel_config_set_dreq(&cfg, uart_get_dreq(uart, true));
+    dma_channel_configure(tx->dma_chan, &cfg, &uart_get_hw(uart)->dr, NULL, 0, false);
+}
+
+bool pcm_uart_busy(const pcm_uart_t *tx)
+{
+    return dma_channel_is_busy(tx->dma_chan);
+}
+
+bool pcm_uart_send(pcm_uart_t *tx, const uint8_t *data, size_t len)
+{
+    if (pcm_uart_busy(tx))
+    {
+        tx->dropped++;
+        return false;
+    }
+    dma_channel_transfer_from_buffer_now(tx->dma_chan, data, len);
+    tx->blocks++;
+    tx->bytes += (uint32_t)len;
+    return true;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file pcm_uart.h
+ * @brief Sends encoded PCM blocks to a UART TX FIFO with one DMA transfer per block.
+ *
+ * @details
+ * The DMA channel is paced by the UART's TX DREQ, so the CPU only starts a transfer per block
+ * and never touches the individual bytes. The caller encodes the next block into a second
+ * buffer while the current one is being sent (double buffering). If the previous block is
+ * still in flight when the next one is ready, the link is too slow for the chosen format
+ * and rate; pcm_uart_send() then refuses the block and counts it, instead of stalling the
+ * caller.
+ */
+
+#ifndef PCM_UART_H
+#define PCM_UART_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+
+typedef struct pcm_uart
+{
+    uart_inst_t *uart;  ///< UART, already initialized and with its TX pin set.
+    uint dma_chan;      ///< DMA channel feeding the TX FIFO.
+    uint32_t blocks;    ///< Blocks sent.
+    uint32_t bytes;     ///< Bytes sent.
+    uint32_t dropped;   ///< Blocks refused because the previous one was still being sent.
+} pcm_uart_t;
+
+/**
+ * @brief Claims a DMA channel for a UART.
+ *
+ * @param tx Pointer to the sender.
+ * @param uart UART instance, already set up with uart_init() (FIFOs enabled).
+ */
+void pcm_uart_init(pcm_uart_t *tx, uart_inst_t *uart);
+
+/**
+ * @brief True while a block is still being transferred to the FIFO.
+ */
+bool pcm_uart_busy(const pcm_uart_t *tx);
+
+/**
+ * @brief Starts sending a block.
+ *
+ * The buffer must not be modified until pcm_uart_busy() returns false.
+ *
+ * @param tx Pointer to the sender.
+ * @param data Encoded bytes.
+ * @param len Number of bytes.
+ * @return bool False if the previous block is still being sent (the block is dropped).
+ */
+bool pcm_uart_send(pcm_uart_t *tx, const uint8_t *data, size_t len);
+
+#endif // PCM_UART_H
@@ -0,0 +1,358 @@
+/**
+ * @file test_pcm_codec.c
+ * @brief Companding tables and block packing of pcm_codec.
+ *
+ * @details
+ * The generated tables are checked entry by entry against the ITU-T G.711 reference
+ * conversions (the segment search of the Sun g711.c), written out again here so the
+ * generator is not trusted: every 12-bit ADC value is centred, scaled to 16-bit PCM and
+ * encoded, and every code is decoded and scaled back to the ADC range. The tables must
+ * also be monotonic and round-trip: a decoded code encodes to itself, except in the first
+ * mu-law segment whose steps are finer than an ADC count.
+ *
+ * The packer is checked on blocks of every length from 0 to 67 with random samples and
+ * guard bytes after the output: byte counts, the nibble and 12-bit layouts, that the bits
+ * above 12 are ignored, that nothing past pcm_encoded_len() is written, and the decoding of
+ * each format back to within half a quantization step.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "pcm_codec.h"
+#include "sample_frame.h"
+
+#define MAX_BLOCK 67u
+#define GUARD 0xA5u
+#define ADC_MID 2048
+
+static const int16_t ulaw_seg_end[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+static const int16_t alaw_seg_end[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+
+static int search(int value, const int16_t *table)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        if (value <= table[i])
+        {
+            return i;
+        }
+    }
+    return 8;
+}
+
+/**
+ * @brief G.711 mu-law code of a 16-bit sample.
+ */
+static uint8_t ref_linear2ulaw(int pcm)
+{
+    int mask;
+    pcm >>= 2;
+    if (pcm < 0)
+    {
+        pcm = -pcm;
+        mask = 0x7F;
+    }
+    else
+    {
+        mask = 0xFF;
+    }
+    if (pcm > 8159)
+    {
+        pcm = 8159;
+    }
+    pcm += 0x84 >> 2;
+    int seg = search(pcm, ulaw_seg_end);
+    if (seg >= 8)
+    {
+        return (uint8_t)(0x7F ^ mask);
+    }
+    return (uint8_t)(((seg << 4) | ((pcm >> (seg + 1)) & 0x0F)) ^ mask);
+}
+
+static int ref_ulaw2linear(uint8_t u)
+{
+    u = (uint8_t)~u;
+    int t = (((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4);
+    return (u & 0x80) ? (0x84 - t) : (t - 0x84);
+}
+
+/**
+ * @brief G.711 A-law code of a 16-bit sample.
+ */
+static uint8_t ref_linear2alaw(int pcm)
+{
+    int mask;
+    pcm >>= 3;
+    if (pcm >= 0)
+    {
+        mask = 0xD5;
+    }
+    else
+    {
+        mask = 0x55;
+        pcm = -pcm - 1;
+    }
+    int seg = search(pcm, alaw_seg_end);
+    if (seg >= 8)
+    {
+        return (uint8_t)(0x7F ^ mask);
+    }
+    int aval = seg << 4;
+    aval |= (seg < 2 ? (pcm >> 1) : (pcm >> seg)) & 0x0F;
+    return (uint8_t)(aval ^ mask);
+}
+
+static int ref_alaw2linear(uint8_t a)
+{
+    a ^= 0x55;
+    int t = (a & 0x0F) << 4;
+    int seg = (a & 0x70) >> 4;
+    if (seg == 0)
+    {
+        t += 8;
+    }
+    else if (seg == 1)
+    {
+        t += 0x108;
+    }
+    else
+    {
+        t = (t + 0x108) << (seg - 1);
+    }
+    return (a & 0x80) ? t : -t;
+}
+
+/**
+ * @brief ADC value of a 16-bit sample, rounded with half counts down and clamped.
+ */
+static uint16_t ref_to_adc(int linear)
+{
+    int q = (int)floor((linear + 7) / 16.0);
+    int code = ADC_MID + q;
+    return (uint16_t)(code < 0 ? 0 : code > 4095 ? 4095 : code);
+}
+
+/**
+ * @brief Position of a code on the signal axis, for the monotonicity checks.
+ */
+static int ulaw_order(uint8_t u)
+{
+    return (u & 0x80) ? 0xFF - u : u - 0x80;
+}
+
+static int alaw_order(uint8_t a)
+{
+    a ^= 0x55;
+    return (a & 0x80) ? (a & 0x7F) : -1 - (a & 0x7F);
+}
+
+static void test_tables(void)
+{
+    size_t bad_enc = 0;
+    size_t bad_dec = 0;
+    for (int c = 0; c < (int)PCM_ADC_CODES; c++)
+    {
+        int linear = (c - ADC_MID) * 16;
+        bad_enc += pcm_ulaw_encode[c] != ref_linear2ulaw(linear);
+        bad_enc += pcm_alaw_encode[c] != ref_linear2alaw(linear);
+        if (c > 0)
+        {
+            CHECK(ulaw_order(pcm_ulaw_encode[c]) >= ulaw_order(pcm_ulaw_encode[c - 1]));
+            CHECK(alaw_order(pcm_alaw_encode[c]) >= alaw_order(pcm_alaw_encode[c - 1]));
+        }
+    }
+    for (int code = 0; code < 256; code++)
+    {
+        bad_dec += pcm_ulaw_decode[code] != ref_to_adc(ref_ulaw2linear((uint8_t)code));
+        bad_dec += pcm_alaw_decode[code] != ref_to_adc(ref_alaw2linear((uint8_t)code));
+    }
+    CHECK_EQ(bad_enc, 0);
+    CHECK_EQ(bad_dec, 0);
+
+    // Anchors: mid scale, full scale, and the codes of the smallest steps
+    CHECK_EQ(pcm_ulaw_encode[ADC_MID], 0xFF);
+    CHECK_EQ(pcm_alaw_encode[ADC_MID], 0xD5);
+    CHECK_EQ(pcm_ulaw_encode[4095], 0x80);
+    CHECK_EQ(pcm_ulaw_encode[0], 0x00);
+    CHECK_EQ(pcm_alaw_encode[4095], 0xAA);
+    CHECK_EQ(pcm_alaw_encode[0], 0x2A);
+    CHECK_EQ(pcm_ulaw_decode[0xFF], ADC_MID);
+    CHECK_EQ(pcm_ulaw_decode[0x7F], ADC_MID);
+    CHECK_EQ(pcm_ulaw_decode[0x00], 40); // -32124 / 16
+    CHECK_EQ(pcm_ulaw_decode[0x80], 4056);
+    CHECK_EQ(pcm_alaw_decode[0x2A], 32); // -32256 / 16
+    CHECK_EQ(pcm_alaw_decode[0xAA], 4064);
+
+    // Every ADC value decodes to within half a step of itself; steps grow with the level
+    for (int c = 0; c < (int)PCM_ADC_CODES; c++)
+    {
+        int mag = abs(c - ADC_MID);
+        double tol = mag / 32.0 + 1.0;
+        CHECK_RANGE(pcm_ulaw_decode[pcm_ulaw_encode[c]], c - tol, c + tol);
+        CHECK_RANGE(pcm_alaw_decode[pcm_alaw_encode[c]], c - tol, c + tol);
+    }
+
+    // The first mu-law segment has half-count steps, so its codes share values; every other
+    // code encodes back to itself, and a shared value to one of its codes.
+    uint8_t ulaw_users[PCM_ADC_CODES] = {0};
+    uint8_t alaw_users[PCM_ADC_CODES] = {0};
+    for (int code = 0; code < 256; code++)
+    {
+        ulaw_users[pcm_ulaw_decode[code]]++;
+        alaw_users[pcm_alaw_decode[code]]++;
+    }
+    size_t ulaw_shared = 0;
+    size_t alaw_shared = 0;
+    for (int code = 0; code < 256; code++)
+    {
+        uint16_t v = pcm_ulaw_decode[code];
+        CHECK_EQ(pcm_ulaw_decode[pcm_ulaw_encode[v]], v);
+        if (ulaw_users[v] == 1)
+        {
+            CHECK_EQ(pcm_ulaw_encode[v], code);
+        }
+        ulaw_shared += ulaw_users[v] > 1;
+
+        v = pcm_alaw_decode[code];
+        CHECK_EQ(pcm_alaw_decode[pcm_alaw_encode[v]], v);
+        if (alaw_users[v] == 1 && v > 0)
+        {
+            CHECK_EQ(pcm_alaw_encode[v], code);
+        }
+        alaw_shared += alaw_users[v] > 1;
+    }
+
+    // mu-law: 16 codes per sign on 2040 .. 2055, plus the extra zero; A-law: none
+    CHECK_EQ(ulaw_shared, 2 * 16 + 1);
+    CHECK_EQ(alaw_shared, 0);
+}
+
+static void test_lengths(void)
+{
+    static const size_t n[] = {0, 1, 2, 3, 64, 1023, 1024};
+    for (size_t i = 0; i < sizeof(n) / sizeof(n[0]); i++)
+    {
+        CHECK_EQ(pcm_encoded_len(PCM_LINEAR4, n[i]), (n[i] + 1u) / 2u);
+        CHECK_EQ(pcm_encoded_len(PCM_LINEAR8, n[i]), n[i]);
+        CHECK_EQ(pcm_encoded_len(PCM_LINEAR12, n[i]), (n[i] * 3u + 1u) / 2u);
+        CHECK_EQ(pcm_encoded_len(PCM_ULAW, n[i]), n[i]);
+        CHECK_EQ(pcm_encoded_len(PCM_ALAW, n[i]), n[i]);
+    }
+}
+
+/**
+ * @brief Encodes one block in one format and checks the layout and the decoding.
+ */
+static void check_block(pcm_format_t format, const uint16_t *samples, size_t n)
+{
+    uint8_t out[SAMPLE_FRAME_PACKED12_LEN(MAX_BLOCK) + 8u];
+    uint8_t noisy_out[sizeof(out)];
+    uint16_t noisy[MAX_BLOCK];
+    uint16_t decoded[MAX_BLOCK];
+    size_t len = pcm_encoded_len(format, n);
+
+    memset(out, GUARD, sizeof(out));
+    CHECK_EQ(pcm_encode(format, samples, n, out), len);
+    for (size_t i = len; i < sizeof(out); i++)
+    {
+        CHECK_EQ(out[i], GUARD);
+    }
+
+    // Bits above the 12-bit range are ignored
+    for (size_t i = 0; i < n; i++)
+    {
+        noisy[i] = (uint16_t)(samples[i] | ((unsigned)rand() << 12));
+    }
+    memset(noisy_out, GUARD, sizeof(noisy_out));
+    pcm_encode(format, noisy, n, noisy_out);
+    CHECK(memcmp(out, noisy_out, sizeof(out)) == 0);
+
+    pcm_decode(format, out, n, decoded);
+    for (size_t i = 0; i < n; i++)
+    {
+        uint16_t s = samples[i];
+        switch (format)
+        {
+        case PCM_LINEAR4:
+            CHECK_EQ((i & 1u) ? out[i / 2u] >> 4 : out[i / 2u] & 0x0Fu, s >> 8);
+            CHECK_EQ(decoded[i], (s & 0xF00u) | 0x80u);
+            break;
+        case PCM_LINEAR8:
+            CHECK_EQ(out[i], s >> 4);
+            CHECK_EQ(decoded[i], (s & 0xFF0u) | 0x08u);
+            break;
+        case PCM_LINEAR12:
+            CHECK_EQ(decoded[i], s);
+            break;
+        case PCM_ULAW:
+            CHECK_EQ(out[i], pcm_ulaw_encode[s]);
+            CHECK_EQ(decoded[i], pcm_ulaw_decode[out[i]]);
+            break;
+        case PCM_ALAW:
+            CHECK_EQ(out[i], pcm_alaw_encode[s]);
+            CHECK_EQ(decoded[i], pcm_alaw_decode[out[i]]);
+            break;
+        }
+    }
+
+    // The 12-bit packing is the sample frame's
+    if (format == PCM_LINEAR12)
+    {
+        uint8_t frame[sizeof(out)];
+        CHECK_EQ(sample_frame_pack12(frame, samples, n), len);
+        CHECK(memcmp(frame, out, len) == 0);
+    }
+
+    // An odd 4-bit block leaves the high nibble of its last byte clear
+    if (format == PCM_LINEAR4 && (n & 1u))
+    {
+        CHECK_EQ(out[len - 1u] >> 4, 0);
+    }
+}
+
+static void test_packer(void)
+{
+    uint16_t samples[MAX_BLOCK];
+    for (size_t n = 0; n <= MAX_BLOCK; n++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            samples[i] = (uint16_t)(rand() % PCM_ADC_CODES);
+        }
+        if (n >= 2)
+        {
+            samples[0] = 0;
+            samples[n - 1u] = PCM_ADC_CODES - 1u;
+        }
+        for (int f = PCM_LINEAR4; f <= PCM_ALAW; f++)
+        {
+            check_block((pcm_format_t)f, samples, n);
+        }
+    }
+
+    // Known bytes
+    static const uint16_t known[3] = {0x123, 0xABC, 0xFFF};
+    uint8_t out[8];
+    pcm_encode(PCM_LINEAR4, known, 3, out);
+    CHECK_EQ(out[0], 0xA1);
+    CHECK_EQ(out[1], 0x0F);
+    pcm_encode(PCM_LINEAR8, known, 3, out);
+    CHECK_EQ(out[0], 0x12);
+    CHECK_EQ(out[1], 0xAB);
+    CHECK_EQ(out[2], 0xFF);
+    CHECK_EQ(pcm_encode((pcm_format_t)99, known, 3, out), 0);
+}
+
+int main(void)
+{
+    srand(23);
+
+    test_tables();
+    test_lengths();
+    test_packer();
+
+    return host_test_result("pcm_codec");
+}
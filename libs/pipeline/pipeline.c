@@ -0,0 +1,79 @@
+/**
+ * @file pipeline.c
+ * @brief Two-stage acquisition/transmit pipeline joined by lock-free SPSC rings.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "pipeline.h"
+
+void pipeline_init(pipeline_t *pl, uint16_t *pool, uint16_t block_len, uint32_t n_blocks,
+                   pipeline_sink_t sink, void *ctx)
+{
+    spsc_ring_init(&pl->filled, pl->filled_slots, PIPELINE_MAX_BLOCKS);
+    spsc_ring_init(&pl->free, pl->free_slots, PIPELINE_MAX_BLOCKS);
+    pl->block_len = block_len;
+    pl->sink = sink;
+    pl->ctx = ctx;
+    pl->dropped = 0;
+    pl->sent = 0;
+
+    // Every block starts out on the free ring.
+    for (uint32_t i = 0; i < n_blocks && i < PIPELINE_MAX_BLOCKS; i++)
+    {
+        block_desc_t desc = {.data = pool + i * block_len, .count = 0, .channel = 0, .seq = 0};
+        spsc_ring_push(&pl->free, &desc);
+    }
+}
+
+uint16_t *pipeline_get_free(pipeline_t *pl)
+{
+    block_desc_t desc;
+    if (!spsc_ring_pop(&pl->free, &desc))
+    {
+        return NULL;
+    }
+    return desc.data;
+}
+
+void pipeline_submit(pipeline_t *pl, uint16_t *data, uint16_t count, uint8_t channel, uint32_t seq)
+{
+    block_desc_t desc = {.data = data, .count = count, .channel = channel, .seq = seq};
+
+    // Cannot fail: the filled ring has room for every block in the pool.
+    spsc_ring_push(&pl->filled, &desc);
+}
+
+bool pipeline_push_copy(pipeline_t *pl, const uint16_t *samples, uint16_t count, uint8_t channel, uint32_t seq)
+{
+    uint16_t *blk = pipeline_get_free(pl);
+    if (blk == NULL)
+    {
+        pl->dropped++;
+        return false;
+    }
+
+    if (count > pl->block_len)
+    {
+        count = pl->block_len;
+    }
+    memcpy(blk, samples, count * sizeof(uint16_t));
+    pipeline_submit(pl, blk, count, channel, seq);
+    return true;
+}
+
+bool pipeline_service(pipeline_t *pl)
+{
+    block_desc_t desc;
+    if (!spsc_ring_pop(&pl->filled, &desc))
+    {
+        return false;
+    }
+
+    pl->sink(&desc, pl->ctx);
+    pl->sent++;
+
+    // Give the block back to the producer.
+    spsc_ring_push(&pl->free, &desc);
+    return true;
+}
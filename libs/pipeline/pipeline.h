@@ -0,0 +1,107 @@
+/**
+ * @file pipeline.h
+ * @brief Two-stage acquisition/transmit pipeline joined by lock-free SPSC rings.
+ *
+ * @details
+ * The pipeline owns a pool of fixed-size sample blocks that circulate between two rings:
+ *
+ *   producer (core0)  --filled-->  consumer (core1)
+ *          ^                             |
+ *          +------------free-------------+
+ *
+ * The producer takes an empty block with pipeline_get_free(), fills it and publishes it
+ * with pipeline_submit(). The consumer calls pipeline_service(), which pops the oldest
+ * filled block, hands it to the sink (format and transmit) and returns it to the free ring.
+ * A slow sink therefore never stalls acquisition: the producer sees an empty free ring,
+ * counts the block as dropped and carries on. Dropped blocks also show up as gaps in the
+ * sequence numbers seen by the sink.
+ *
+ * This file has no dependency on the Pico SDK; pipeline_multicore.h runs the consumer on
+ * core1 of the RP2040, and on a host the two sides can be two threads.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spsc_ring.h"
+
+#define PIPELINE_MAX_BLOCKS 16 ///< Maximum number of blocks in the pool (power of two).
+
+/**
+ * @brief Consumer callback, called once per filled block in submission order.
+ *
+ * @param blk The filled block; valid only for the duration of the call.
+ * @param ctx User context given to pipeline_init().
+ */
+typedef void (*pipeline_sink_t)(const block_desc_t *blk, void *ctx);
+
+typedef struct pipeline
+{
+    spsc_ring_t filled;                        ///< Producer -> consumer.
+    spsc_ring_t free;                          ///< Consumer -> producer.
+    block_desc_t filled_slots[PIPELINE_MAX_BLOCKS];
+    block_desc_t free_slots[PIPELINE_MAX_BLOCKS];
+    uint16_t block_len;                        ///< Capacity of each block in samples.
+    pipeline_sink_t sink;                      ///< Consumer callback.
+    void *ctx;                                 ///< Consumer callback context.
+    uint32_t dropped;                          ///< Blocks the producer had to discard (producer-owned).
+    uint32_t sent;                             ///< Blocks handed to the sink (consumer-owned).
+} pipeline_t;
+
+/**
+ * @brief Initializes the pipeline over a caller-provided pool.
+ *
+ * @param pl Pointer to the pipeline.
+ * @param pool Storage for n_blocks * block_len samples.
+ * @param block_len Samples per block.
+ * @param n_blocks Number of blocks, a power of two up to PIPELINE_MAX_BLOCKS.
+ * @param sink Consumer callback.
+ * @param ctx Context passed to the sink.
+ */
+void pipeline_init(pipeline_t *pl, uint16_t *pool, uint16_t block_len, uint32_t n_blocks,
+                   pipeline_sink_t sink, void *ctx);
+
+/**
+ * @brief Producer side: takes an empty block.
+ *
+ * @param pl Pointer to the pipeline.
+ * @return uint16_t* The block (block_len samples), or NULL if all blocks are in flight.
+ */
+uint16_t *pipeline_get_free(pipeline_t *pl);
+
+/**
+ * @brief Producer side: publishes a block obtained with pipeline_get_free().
+ *
+ * @param pl Pointer to the pipeline.
+ * @param data The block.
+ * @param count Number of valid samples.
+ * @param channel Source channel.
+ * @param seq Sequence number of the block.
+ */
+void pipeline_submit(pipeline_t *pl, uint16_t *data, uint16_t count, uint8_t channel, uint32_t seq);
+
+/**
+ * @brief Producer side: publishes a copy of a block, or counts it as dropped.
+ *
+ * Convenience for sources that own their own buffer (e.g. a DMA ping-pong half).
+ *
+ * @param pl Pointer to the pipeline.
+ * @param samples Samples to copy.
+ * @param count Number of samples (at most block_len).
+ * @param channel Source channel.
+ * @param seq Sequence number of the block.
+ * @return true if the block was queued, false if it was dropped.
+ */
+bool pipeline_push_copy(pipeline_t *pl, const uint16_t *samples, uint16_t count, uint8_t channel, uint32_t seq);
+
+/**
+ * @brief Consumer side: passes the oldest filled block to the sink.
+ *
+ * @param pl Pointer to the pipeline.
+ * @return true if a block was processed, false if none was waiting.
+ */
+bool pipeline_service(pipeline_t *pl);
+
+#endif // PIPELINE_H
@@ -0,0 +1,49 @@
+/**
+ * @file pipeline_multicore.c
+ * @brief Runs the consumer side of a pipeline on core1 of the RP2040.
+ */
+
+#include "pipeline_multicore.h"
+#include "pico/multicore.h"
+
+static pipeline_t *core1_pipeline = NULL; ///< Pipeline serviced by core1.
+
+/**
+ * @brief Core1 entry point: drains the filled ring forever.
+ */
+static void pipeline_core1_entry(void)
+{
+    pipeline_t *pl = core1_pipeline;
+
+    while (true)
+    {
+        // Sleep until core0 signals a new block; a stale event just causes one extra pass.
+        if (!pipeline_service(pl))
+        {
+            __wfe();
+        }
+    }
+}
+
+void pipeline_multicore_launch(pipeline_t *pl)
+{
+    core1_pipeline = pl;
+    multicore_launch_core1(pipeline_core1_entry);
+}
+
+void pipeline_multicore_submit(pipeline_t *pl, uint16_t *data, uint16_t count, uint8_t channel, uint32_t seq)
+{
+    pipeline_submit(pl, data, count, channel, seq);
+    __sev();
+}
+
+bool pipeline_multicore_push_copy(pipeline_t *pl, const uint16_t *samples, uint16_t count,
+                                  uint8_t channel, uint32_t seq)
+{
+    bool queued = pipeline_push_copy(pl, samples, count, channel, seq);
+    if (queued)
+    {
+        __sev();
+    }
+    return queued;
+}
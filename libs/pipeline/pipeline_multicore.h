@@ -0,0 +1,42 @@
+/**
+ * @file pipeline_multicore.h
+ * @brief Runs the consumer side of a pipeline on core1 of the RP2040.
+ *
+ * @details
+ * Core0 keeps ownership of acquisition (ADC, DMA and their interrupts) and submits blocks;
+ * core1 loops on pipeline_service() and sleeps with WFE while the filled ring is empty.
+ * pipeline_multicore_submit() and pipeline_multicore_push_copy() wake it with SEV after
+ * publishing a block.
+ */
+
+#ifndef PIPELINE_MULTICORE_H
+#define PIPELINE_MULTICORE_H
+
+#include "pico/stdlib.h"
+#include "pipeline.h"
+
+/**
+ * @brief Launches core1 running the consumer loop for a pipeline.
+ *
+ * The pipeline must already be initialized. Only one pipeline can run on core1.
+ *
+ * @param pl Pointer to the pipeline.
+ */
+void pipeline_multicore_launch(pipeline_t *pl);
+
+/**
+ * @brief Publishes a block obtained with pipeline_get_free() from core0 and wakes core1.
+ *
+ * See pipeline_submit().
+ */
+void pipeline_multicore_submit(pipeline_t *pl, uint16_t *data, uint16_t count, uint8_t channel, uint32_t seq);
+
+/**
+ * @brief Copies a block into the pipeline from core0 and wakes core1.
+ *
+ * @return true if the block was queued, false if it was dropped (see pipeline_push_copy()).
+ */
+bool pipeline_multicore_push_copy(pipeline_t *pl, const uint16_t *samples, uint16_t count,
+                                  uint8_t channel, uint32_t seq);
+
+#endif // PIPELINE_MULTICORE_H
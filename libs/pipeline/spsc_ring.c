@@ -0,0 +1,48 @@
+/**
+ * @file spsc_ring.c
+ * @brief Lock-free single-producer/single-consumer ring of sample block descriptors.
+ */
+
+#include "spsc_ring.h"
+
+void spsc_ring_init(spsc_ring_t *ring, block_desc_t *slots, uint32_t capacity)
+{
+    ring->slots = slots;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const block_desc_t *desc)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail > ring->mask)
+    {
+        return false; // Full
+    }
+
+    ring->slots[head & ring->mask] = *desc;
+
+    // The slot contents must be visible before the consumer sees the new head.
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, block_desc_t *desc)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail)
+    {
+        return false; // Empty
+    }
+
+    *desc = ring->slots[tail & ring->mask];
+
+    // Only hand the slot back to the producer once it has been copied out.
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
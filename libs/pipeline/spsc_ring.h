@@ -0,0 +1,74 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer/single-consumer ring of sample block descriptors.
+ *
+ * @details
+ * One side only ever pushes and the other only ever pops, so the ring needs no lock:
+ * the producer owns `head`, the consumer owns `tail`, and each publishes its index with a
+ * release store that the other side reads with an acquire load. On the RP2040 this is safe
+ * between core0 and core1 (the atomics compile to plain loads/stores plus DMB barriers, no
+ * exclusive-access instructions are needed), and on a host it is safe between two threads.
+ *
+ * The capacity must be a power of two. This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+typedef struct block_desc
+{
+    uint16_t *data;  ///< First sample of the block.
+    uint16_t count;  ///< Number of valid samples.
+    uint8_t channel; ///< Source channel.
+    uint32_t seq;    ///< Block sequence number assigned by the producer.
+} block_desc_t;
+
+typedef struct spsc_ring
+{
+    block_desc_t *slots;   ///< Caller-provided slot storage.
+    uint32_t mask;         ///< Capacity - 1.
+    _Atomic uint32_t head; ///< Next slot to write, owned by the producer.
+    _Atomic uint32_t tail; ///< Next slot to read, owned by the consumer.
+} spsc_ring_t;
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * @param ring Pointer to the ring.
+ * @param slots Storage for `capacity` descriptors.
+ * @param capacity Number of slots, a power of two.
+ */
+void spsc_ring_init(spsc_ring_t *ring, block_desc_t *slots, uint32_t capacity);
+
+/**
+ * @brief Producer side: appends a descriptor.
+ *
+ * @param ring Pointer to the ring.
+ * @param desc Descriptor to copy into the ring.
+ * @return true if it was queued, false if the ring is full.
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const block_desc_t *desc);
+
+/**
+ * @brief Consumer side: removes the oldest descriptor.
+ *
+ * @param ring Pointer to the ring.
+ * @param desc Output for the descriptor.
+ * @return true if a descriptor was returned, false if the ring is empty.
+ */
+bool spsc_ring_pop(spsc_ring_t *ring, block_desc_t *desc);
+
+/**
+ * @brief Number of queued descriptors. Exact only when called from one of the two sides.
+ */
+static inline uint32_t spsc_ring_count(spsc_ring_t *ring)
+{
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+#endif // SPSC_RING_H
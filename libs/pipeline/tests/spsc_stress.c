@@ -0,0 +1,220 @@
+/**
+ * @file spsc_stress.c
+ * @brief Two-thread stress test of the SPSC ring and of the pipeline built on it.
+ *
+ * @details
+ * A producer and a consumer thread stand in for core0 and core1 and run millions of items
+ * through a small ring, so that it is full or empty most of the time and both indices wrap
+ * many times. The ring test checks that every descriptor arrives once, in order and with all
+ * of its fields (a torn slot copy would mix fields of two descriptors). The pipeline test
+ * fills every block with a pattern derived from its sequence number and checks it in the
+ * sink: a block handed back to the producer while the sink still reads it, or published
+ * before its samples, shows up as a corrupted pattern. Blocks the producer had to drop are
+ * accounted for by the sequence gaps.
+ *
+ * Both sides yield the processor when they have to wait, so the test also finishes on a
+ * single-CPU machine, where a spinning thread would hold it for a whole time slice.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "host_test.h"
+#include "pipeline.h"
+#include "spsc_ring.h"
+
+#define RING_ITEMS 5000000u
+#define RING_CAPACITY 4u
+#define PIPE_BLOCKS 2000000u
+#define PIPE_POOL 4u
+#define BLOCK_LEN 16u
+
+// ---- Raw ring --------------------------------------------------------------------------
+
+static spsc_ring_t ring;
+static block_desc_t ring_slots[RING_CAPACITY];
+static uint32_t ring_errors;
+static uint32_t ring_received;
+
+static block_desc_t ring_item(uint32_t i)
+{
+    block_desc_t d = {
+        .data = (uint16_t *)(uintptr_t)(i * 2654435761u), // Any value, only compared
+        .count = (uint16_t)(i ^ (i >> 16)),
+        .channel = (uint8_t)(i * 7u),
+        .seq = i,
+    };
+    return d;
+}
+
+static void *ring_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < RING_ITEMS; i++)
+    {
+        block_desc_t d = ring_item(i);
+        while (!spsc_ring_push(&ring, &d))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *ring_consumer(void *arg)
+{
+    (void)arg;
+    while (ring_received < RING_ITEMS)
+    {
+        block_desc_t d;
+        if (!spsc_ring_pop(&ring, &d))
+        {
+            sched_yield();
+            continue;
+        }
+        block_desc_t want = ring_item(ring_received);
+        if (d.seq != want.seq || d.data != want.data || d.count != want.count || d.channel != want.channel)
+        {
+            ring_errors++;
+        }
+        ring_received++;
+    }
+    return NULL;
+}
+
+static void test_ring(void)
+{
+    spsc_ring_init(&ring, ring_slots, RING_CAPACITY);
+    pthread_t prod, cons;
+    CHECK_EQ(pthread_create(&cons, NULL, ring_consumer, NULL), 0);
+    CHECK_EQ(pthread_create(&prod, NULL, ring_producer, NULL), 0);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    CHECK_EQ(ring_received, RING_ITEMS);
+    CHECK_EQ(ring_errors, 0);
+    CHECK_EQ(spsc_ring_count(&ring), 0);
+}
+
+// ---- Pipeline --------------------------------------------------------------------------
+
+static pipeline_t pl;
+static uint16_t pool[PIPE_POOL * BLOCK_LEN];
+static atomic_bool producer_done;
+
+static struct
+{
+    uint32_t blocks;
+    uint32_t next_seq; // Lowest sequence number the next block may have
+    uint32_t order_errors;
+    uint32_t data_errors;
+} seen;
+
+static uint16_t pattern(uint32_t seq, uint32_t i)
+{
+    return (uint16_t)(seq * 31u + i * 977u);
+}
+
+static void sink(const block_desc_t *blk, void *ctx)
+{
+    (void)ctx;
+    if (blk->seq < seen.next_seq || blk->count != BLOCK_LEN || blk->channel != (uint8_t)blk->seq)
+    {
+        seen.order_errors++;
+    }
+    for (uint32_t i = 0; i < blk->count; i++)
+    {
+        if (blk->data[i] != pattern(blk->seq, i))
+        {
+            seen.data_errors++;
+            break;
+        }
+    }
+    seen.next_seq = blk->seq + 1u;
+    seen.blocks++;
+}
+
+static void *pipe_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t seq = 0; seq < PIPE_BLOCKS; seq++)
+    {
+        // Half of the blocks are filled in place, the other half copied in
+        uint16_t block[BLOCK_LEN];
+        for (uint32_t i = 0; i < BLOCK_LEN; i++)
+        {
+            block[i] = pattern(seq, i);
+        }
+        if (seq & 1u)
+        {
+            if (!pipeline_push_copy(&pl, block, BLOCK_LEN, (uint8_t)seq, seq))
+            {
+                sched_yield();
+            }
+            continue;
+        }
+        uint16_t *b = pipeline_get_free(&pl);
+        if (b == NULL)
+        {
+            pl.dropped++;
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < BLOCK_LEN; i++)
+        {
+            b[i] = block[i];
+        }
+        pipeline_submit(&pl, b, BLOCK_LEN, (uint8_t)seq, seq);
+    }
+    atomic_store(&producer_done, true);
+    return NULL;
+}
+
+static void *pipe_consumer(void *arg)
+{
+    (void)arg;
+    while (true)
+    {
+        // Read the flag first: once it is set, whatever the producer queued is visible
+        bool done = atomic_load(&producer_done);
+        if (!pipeline_service(&pl))
+        {
+            if (done)
+            {
+                break;
+            }
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_pipeline(void)
+{
+    pipeline_init(&pl, pool, BLOCK_LEN, PIPE_POOL, sink, NULL);
+    atomic_init(&producer_done, false);
+    pthread_t prod, cons;
+    CHECK_EQ(pthread_create(&cons, NULL, pipe_consumer, NULL), 0);
+    CHECK_EQ(pthread_create(&prod, NULL, pipe_producer, NULL), 0);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    CHECK_EQ(seen.order_errors, 0);
+    CHECK_EQ(seen.data_errors, 0);
+    CHECK_EQ(seen.blocks, pl.sent);
+    CHECK_EQ(pl.sent + pl.dropped, PIPE_BLOCKS);
+    CHECK(pl.sent > 0);
+
+    // Every block is back on the free ring
+    CHECK_EQ(spsc_ring_count(&pl.filled), 0);
+    CHECK_EQ(spsc_ring_count(&pl.free), PIPE_POOL);
+    fprintf(stderr, "spsc_stress: pipeline sent %u, dropped %u\n", (unsigned)pl.sent, (unsigned)pl.dropped);
+}
+
+int main(void)
+{
+    test_ring();
+    test_pipeline();
+    return host_test_result("spsc_stress");
+}
@@ -0,0 +1,142 @@
+/**
+ * @file psk_mod.c
+ * @brief BPSK/QPSK modulator on PIO state machines fed by DMA.
+ */
+
+#include "psk_mod.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "psk_mod.pio.h"
+
+/**
+ * @brief Configures one state machine (one arm) of the modulator.
+ */
+static void psk_arm_init(psk_mod_t *m, uint arm, uint pin, const pio_sm_config *base)
+{
+    uint sm = m->sm[arm];
+    pio_sm_config c = *base;
+
+    pio_gpio_init(m->pio, pin);
+    pio_sm_set_consecutive_pindirs(m->pio, sm, pin, 1, true);
+    sm_config_set_out_pins(&c, pin, 1);
+    sm_config_set_out_shift(&c, true, true, 32); // LSB first, autopull every 32 bits
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv_int_frac(&c, m->timing.clkdiv_int, m->timing.clkdiv_frac);
+    pio_sm_init(m->pio, sm, m->offset, &c);
+    pio_sm_set_pins_with_mask(m->pio, sm, 0, 1u << pin);
+
+    // Each DMA transfer moves one word into the TX FIFO, paced by its DREQ.
+    dma_channel_config dc = dma_channel_get_default_config(m->dma_chan[arm]);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(m->pio, sm, true));
+    dma_channel_configure(m->dma_chan[arm], &dc, &m->pio->txf[sm], NULL, 0, false);
+}
+
+int psk_mod_init(psk_mod_t *m, PIO pio, const psk_config_t *cfg, uint pin_i, uint pin_q)
+{
+    int err = psk_compute_timing(cfg, clock_get_hz(clk_sys), &m->timing);
+    if (err)
+    {
+        return err;
+    }
+
+    m->pio = pio;
+    m->mode = cfg->mode;
+    m->n_arms = (cfg->mode == PSK_MODE_QPSK) ? 2 : 1;
+
+    pio_sm_config base;
+    if (cfg->mode == PSK_MODE_QPSK)
+    {
+        m->offset = pio_add_program(pio, &psk_qpsk_program);
+        base = psk_qpsk_program_get_default_config(m->offset);
+    }
+    else
+    {
+        m->offset = pio_add_program(pio, &psk_bpsk_program);
+        base = psk_bpsk_program_get_default_config(m->offset);
+    }
+
+    uint pins[2] = {pin_i, pin_q};
+    for (uint arm = 0; arm < m->n_arms; arm++)
+    {
+        m->sm[arm] = (uint)pio_claim_unused_sm(pio, true);
+        m->dma_chan[arm] = dma_claim_unused_channel(true);
+        psk_arm_init(m, arm, pins[arm], &base);
+    }
+    return 0;
+}
+
+void psk_mod_send(psk_mod_t *m, const uint32_t *words, size_t n_words)
+{
+    uint mask = 0;
+
+    for (uint arm = 0; arm < m->n_arms; arm++)
+    {
+        uint sm = m->sm[arm];
+        mask |= 1u << sm;
+
+        pio_sm_set_enabled(m->pio, sm, false);
+        pio_sm_clear_fifos(m->pio, sm);
+        pio_sm_restart(m->pio, sm);
+        pio_sm_clkdiv_restart(m->pio, sm);
+
+        // The ISR holds the loop count for the whole transmission (restart clears it).
+        pio_sm_put(m->pio, sm, m->timing.cycles_per_symbol - 1u);
+        pio_sm_exec(m->pio, sm, pio_encode_pull(false, true));
+        pio_sm_exec(m->pio, sm, pio_encode_out(pio_isr, 32));
+
+        uint entry = 0;
+        if (m->mode == PSK_MODE_QPSK)
+        {
+            entry = (arm == 0) ? psk_qpsk_offset_i_entry : psk_qpsk_offset_q_entry;
+        }
+        pio_sm_exec(m->pio, sm, pio_encode_jmp(m->offset + entry));
+    }
+
+    // Clear the stall flags so psk_mod_busy() only sees the stall at the end of this buffer.
+    m->pio->fdebug = (mask << PIO_FDEBUG_TXSTALL_LSB);
+
+    for (uint arm = 0; arm < m->n_arms; arm++)
+    {
+        dma_channel_transfer_from_buffer_now(m->dma_chan[arm], words, n_words);
+    }
+
+    // Both arms must see data on their first cycle or the quadrature offset would slip.
+    for (uint arm = 0; arm < m->n_arms; arm++)
+    {
+        while (pio_sm_is_tx_fifo_empty(m->pio, m->sm[arm]))
+        {
+            tight_loop_contents();
+        }
+    }
+    pio_enable_sm_mask_in_sync(m->pio, mask);
+}
+
+bool psk_mod_busy(const psk_mod_t *m)
+{
+    for (uint arm = 0; arm < m->n_arms; arm++)
+    {
+        uint sm = m->sm[arm];
+        if (dma_channel_is_busy(m->dma_chan[arm]) || !pio_sm_is_tx_fifo_empty(m->pio, sm))
+        {
+            return true;
+        }
+        // The FIFO is drained once the last word is in the OSR; the arm is done when it
+        // stalls on the next `out`.
+        if (!(m->pio->fdebug & (1u << (PIO_FDEBUG_TXSTALL_LSB + sm))))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void psk_mod_wait(const psk_mod_t *m)
+{
+    while (psk_mod_busy(m))
+    {
+        tight_loop_contents();
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file psk_mod.h
+ * @brief BPSK/QPSK modulator on PIO state machines fed by DMA.
+ *
+ * @details
+ * The data bits are streamed by DMA straight into the PIO TX FIFO, and the state machines
+ * switch the carrier phase on symbol boundaries on their own, so the CPU does nothing per bit
+ * or per symbol. BPSK uses one state machine and one pin. QPSK uses two state machines on the
+ * same PIO, started in sync, with one DMA channel each reading the same buffer.
+ *
+ * The PIO clock runs at carrier_hz * 2 * PSK_*_HALF_CYCLES, so at a 125 MHz system clock the
+ * carrier can reach 15.6 MHz (BPSK) or 10.4 MHz (QPSK), and the symbol rate can be as high as
+ * the carrier. Timing and symbol mapping are described in psk_model.h.
+ */
+
+#ifndef PSK_MOD_H
+#define PSK_MOD_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "psk_model.h"
+
+typedef struct psk_mod
+{
+    PIO pio;             ///< PIO block running the modulator.
+    uint sm[2];          ///< State machines: I (or the only one for BPSK), then Q.
+    uint offset;         ///< Program offset in the PIO instruction memory.
+    int dma_chan[2];     ///< DMA channel feeding each state machine.
+    uint n_arms;         ///< 1 for BPSK, 2 for QPSK.
+    psk_mode_t mode;     ///< Modulation.
+    psk_timing_t timing; ///< Clock divider and symbol timing.
+} psk_mod_t;
+
+/**
+ * @brief Loads the modulator program, claims state machines and DMA channels.
+ *
+ * @param m Pointer to the modulator.
+ * @param pio PIO block to use.
+ * @param cfg Modulation, carrier and symbol rate.
+ * @param pin_i Output pin (BPSK) or I arm pin (QPSK).
+ * @param pin_q Q arm pin (QPSK only, ignored for BPSK).
+ * @return int 0 on success, or a negative PSK_ERR_* code from psk_compute_timing().
+ */
+int psk_mod_init(psk_mod_t *m, PIO pio, const psk_config_t *cfg, uint pin_i, uint pin_q);
+
+/**
+ * @brief Starts sending a buffer; returns immediately.
+ *
+ * The buffer must stay valid until psk_mod_busy() returns false. Whole words are sent, so pad
+ * the last one. When the data runs out the carrier stops with the pins at their last level.
+ *
+ * @param m Pointer to the modulator.
+ * @param words Data bits, LSB first.
+ * @param n_words Number of 32-bit words.
+ */
+void psk_mod_send(psk_mod_t *m, const uint32_t *words, size_t n_words);
+
+/**
+ * @brief True while symbols are still being sent.
+ */
+bool psk_mod_busy(const psk_mod_t *m);
+
+/**
+ * @brief Waits until the last symbol has been sent.
+ */
+void psk_mod_wait(const psk_mod_t *m);
+
+#endif // PSK_MOD_H
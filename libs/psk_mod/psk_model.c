@@ -0,0 +1,110 @@
+/**
+ * @file psk_model.c
+ * @brief Timing and reference waveform model of the PIO BPSK/QPSK modulator.
+ */
+
+#include "psk_model.h"
+
+int psk_compute_timing(const psk_config_t *cfg, uint32_t sys_hz, psk_timing_t *t)
+{
+    uint32_t half;
+
+    switch (cfg->mode)
+    {
+    case PSK_MODE_BPSK:
+        half = PSK_BPSK_HALF_CYCLES;
+        break;
+    case PSK_MODE_QPSK:
+        half = PSK_QPSK_HALF_CYCLES;
+        break;
+    default:
+        return PSK_ERR_MODE;
+    }
+
+    if (cfg->symbol_rate_hz == 0 || cfg->carrier_hz == 0 || cfg->carrier_hz % cfg->symbol_rate_hz != 0)
+    {
+        return PSK_ERR_RATIO;
+    }
+
+    // PIO clock = carrier * 2 * half; divider in 1/256 steps, rounded to nearest.
+    uint64_t pio_hz = (uint64_t)cfg->carrier_hz * 2u * half;
+    uint64_t div256 = ((uint64_t)sys_hz * 256u + pio_hz / 2u) / pio_hz;
+    if (div256 < 256u || div256 > 65536u * 256u)
+    {
+        return PSK_ERR_RANGE;
+    }
+
+    t->half_cycles = half;
+    t->cycles_per_symbol = cfg->carrier_hz / cfg->symbol_rate_hz;
+    t->samples_per_symbol = 2u * half * t->cycles_per_symbol;
+    t->clkdiv_int = (uint16_t)(div256 >> 8); // 65536 wraps to 0, as the hardware expects
+    t->clkdiv_frac = (uint8_t)(div256 & 0xFFu);
+    t->carrier_mhz = (uint32_t)(((uint64_t)sys_hz * 256u * 1000u) / (div256 * 2u * half));
+    return 0;
+}
+
+uint16_t psk_symbol_phase(psk_mode_t mode, uint8_t symbol)
+{
+    static const uint16_t qpsk_phase[4] = {315, 225, 45, 135};
+
+    if (mode == PSK_MODE_QPSK)
+    {
+        return qpsk_phase[symbol & 3u];
+    }
+    return (symbol & 1u) ? 180 : 0;
+}
+
+/**
+ * @brief Level of one BPSK arm at a PIO cycle.
+ *
+ * @param start Cycle of the arm's first carrier edge.
+ * @param first_bit Index of the arm's first bit in the stream.
+ * @param stride Bits per symbol (the arm uses every stride-th bit).
+ */
+static uint8_t arm_level(const psk_timing_t *t, const uint32_t *words, size_t n_symbols, size_t cycle,
+                         size_t start, size_t first_bit, size_t stride)
+{
+    if (cycle < start || n_symbols == 0)
+    {
+        return 0;
+    }
+
+    size_t u = cycle - start;
+    size_t sym = u / t->samples_per_symbol;
+    int second_half = (u % (2u * t->half_cycles)) >= t->half_cycles;
+    if (sym >= n_symbols)
+    {
+        // Stalled on the next `out`: the pin keeps the last symbol's second-half level.
+        sym = n_symbols - 1u;
+        second_half = 1;
+    }
+
+    size_t bit_index = first_bit + sym * stride;
+    uint8_t bit = (uint8_t)((words[bit_index / 32u] >> (bit_index % 32u)) & 1u);
+
+    // First half is the inverted bit, second half the bit itself.
+    return second_half ? bit : (uint8_t)(bit ^ 1u);
+}
+
+void psk_reference(psk_mode_t mode, const psk_timing_t *t, const uint32_t *words, size_t n_symbols,
+                   uint8_t *out, size_t n_out)
+{
+    if (mode == PSK_MODE_QPSK)
+    {
+        size_t i_start = PSK_QPSK_LEAD_CYCLES;
+        size_t q_start = i_start + t->half_cycles / 2u; // Quarter carrier period later
+        for (size_t c = 0; c < n_out; c++)
+        {
+            uint8_t i = arm_level(t, words, n_symbols, c, i_start, 0, 2);
+            uint8_t q = arm_level(t, words, n_symbols, c, q_start, 1, 2);
+            out[c] = (uint8_t)(i | (q << 1));
+        }
+    }
+    else
+    {
+        for (size_t c = 0; c < n_out; c++)
+        {
+            out[c] = arm_level(t, words, n_symbols, c, PSK_BPSK_LEAD_CYCLES, 0, 1);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file psk_model.h
+ * @brief Timing and reference waveform model of the PIO BPSK/QPSK modulator.
+ *
+ * @details
+ * The modulator (psk_mod.pio) outputs a square carrier whose phase is set by the data bits:
+ *
+ * - BPSK, one pin: bit 0 sends the carrier high-then-low (0 deg), bit 1 low-then-high (180 deg).
+ * - QPSK, two pins: an I arm and a Q arm, each a BPSK modulator. Even bits (2k) drive I and
+ *   odd bits (2k + 1) drive Q. The Q arm runs a quarter carrier period behind the I arm, so
+ *   summing the two pins through equal resistors gives the four QPSK phases.
+ *
+ * Bits are consumed LSB first from 32-bit words, i.e. in byte order and LSB first within each
+ * byte on the little-endian RP2040.
+ *
+ * The state machines run at PSK_*_HALF_CYCLES PIO cycles per carrier half period, so the
+ * carrier frequency sets the PIO clock divider and every edge lands on an exact PIO cycle.
+ * A symbol lasts a whole number of carrier periods. The symbol timing and mapping are
+ * reproduced here cycle by cycle, so a logic analyzer capture of the pins (sampled at the
+ * PIO clock) can be compared directly with psk_reference(). The host test runs psk_mod.pio
+ * instruction by instruction against it.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef PSK_MODEL_H
+#define PSK_MODEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PSK_BPSK_HALF_CYCLES 4u ///< PIO cycles per carrier half period in the BPSK program.
+#define PSK_QPSK_HALF_CYCLES 6u ///< PIO cycles per carrier half period in the QPSK program.
+#define PSK_BPSK_LEAD_CYCLES 2u ///< Cycles from SM enable to the first carrier edge (BPSK).
+#define PSK_QPSK_LEAD_CYCLES 2u ///< Cycles from SM enable to the first I edge (QPSK).
+
+// Error codes returned by psk_compute_timing()
+#define PSK_ERR_MODE -1  ///< Unknown modulation.
+#define PSK_ERR_RATIO -2 ///< Carrier is not a whole multiple of the symbol rate.
+#define PSK_ERR_RANGE -3 ///< Carrier needs a PIO clock divider outside 1 .. 65536.
+
+typedef enum psk_mode
+{
+    PSK_MODE_BPSK = 1, ///< One bit per symbol, one output pin.
+    PSK_MODE_QPSK = 2, ///< Two bits per symbol, I and Q output pins.
+} psk_mode_t;
+
+typedef struct psk_config
+{
+    psk_mode_t mode;         ///< Modulation.
+    uint32_t carrier_hz;     ///< Carrier frequency.
+    uint32_t symbol_rate_hz; ///< Symbols per second; carrier_hz must be a multiple of it.
+} psk_config_t;
+
+typedef struct psk_timing
+{
+    uint32_t half_cycles;        ///< PIO cycles per carrier half period.
+    uint32_t cycles_per_symbol;  ///< Carrier periods per symbol.
+    uint32_t samples_per_symbol; ///< PIO cycles per symbol.
+    uint16_t clkdiv_int;         ///< PIO clock divider, integer part (0 means 65536).
+    uint8_t clkdiv_frac;         ///< PIO clock divider, fractional part in 1/256.
+    uint32_t carrier_mhz;        ///< Carrier actually produced, in millihertz.
+} psk_timing_t;
+
+/**
+ * @brief Computes the PIO clock divider and symbol timing for a configuration.
+ *
+ * The divider is rounded to the nearest 1/256. An integer divider gives a jitter-free
+ * carrier; a fractional one dithers single edges by one system clock.
+ *
+ * @param cfg Requested modulation, carrier and symbol rate.
+ * @param sys_hz System clock frequency.
+ * @param t Output timing.
+ * @return int 0 on success, or a negative PSK_ERR_* code.
+ */
+int psk_compute_timing(const psk_config_t *cfg, uint32_t sys_hz, psk_timing_t *t);
+
+/**
+ * @brief Number of 32-bit words that hold n_symbols symbols.
+ */
+static inline size_t psk_words_for_symbols(psk_mode_t mode, size_t n_symbols)
+{
+    return (n_symbols * (size_t)mode + 31u) / 32u;
+}
+
+/**
+ * @brief Phase of a symbol's carrier fundamental in degrees, against a bit-0 BPSK carrier.
+ *
+ * BPSK gives 0 or 180. For QPSK it is the phase of the summed I + Q signal: 315, 225, 45 and
+ * 135 for symbols 0 to 3, a Gray mapping where neighbouring phases differ by one bit.
+ *
+ * @param mode Modulation.
+ * @param symbol Symbol value (bit, or I | Q << 1).
+ * @return uint16_t Phase in degrees.
+ */
+uint16_t psk_symbol_phase(psk_mode_t mode, uint8_t symbol);
+
+/**
+ * @brief Generates the expected pin levels, one sample per PIO cycle from SM enable.
+ *
+ * Each sample is the BPSK pin level, or I | Q << 1 for QPSK. Before its first edge a pin is
+ * low; after the last symbol the state machine stalls waiting for data and the pins hold
+ * their last level.
+ *
+ * @param mode Modulation.
+ * @param t Timing from psk_compute_timing().
+ * @param words Data bits, LSB first.
+ * @param n_symbols Number of symbols in words.
+ * @param out Output levels.
+ * @param n_out Number of samples to generate.
+ */
+void psk_reference(psk_mode_t mode, const psk_timing_t *t, const uint32_t *words, size_t n_symbols,
+                   uint8_t *out, size_t n_out);
+
+#endif // PSK_MODEL_H
@@ -0,0 +1,460 @@
+/**
+ * @file test_psk_pio.c
+ * @brief psk_reference() against an instruction-level run of psk_mod.pio.
+ *
+ * @details
+ * The test reads psk_mod.pio itself, assembles the few instructions it uses and runs the
+ * state machines cycle by cycle as psk_mod_send() starts them: ISR loaded with
+ * cycles_per_symbol - 1, OSR empty, autopull every 32 bits, a jump to the entry point and,
+ * for QPSK, both arms enabled on the same cycle. The TX FIFO holds the whole buffer, as the
+ * DMA keeps it topped up. An `out` that finds the OSR empty and the FIFO drained stalls,
+ * which is where the transmission ends.
+ *
+ * The pin levels of every cycle must match psk_reference() for the symbols the buffer holds,
+ * including the last symbol of each arm, and once both arms have stalled the pins must hold.
+ * The timing and phase helpers of psk_model.h are checked as well.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "psk_model.h"
+
+#define MAX_INSTR 32
+#define MAX_LABELS 16
+#define MAX_WORDS 8u
+#define MAX_CYCLES 200000u
+
+typedef enum op
+{
+    OP_NOP = 0,
+    OP_OUT_X,
+    OP_OUT_NULL,
+    OP_MOV_Y_ISR,
+    OP_MOV_PINS_X,
+    OP_MOV_PINS_NOT_X,
+    OP_JMP,
+    OP_JMP_Y_DEC,
+} op_t;
+
+typedef struct instr
+{
+    op_t op;
+    uint8_t count;  ///< Bit count of an `out`.
+    uint8_t delay;  ///< Extra cycles, [n].
+    char target[24]; ///< Label of a `jmp`.
+    uint8_t addr;   ///< Resolved jump address.
+} instr_t;
+
+typedef struct program
+{
+    instr_t code[MAX_INSTR];
+    uint8_t len;
+    uint8_t wrap_target;
+    uint8_t wrap;
+    char labels[MAX_LABELS][24];
+    uint8_t label_addr[MAX_LABELS];
+    uint8_t n_labels;
+} program_t;
+
+typedef struct sm
+{
+    const program_t *prog;
+    uint8_t pc;
+    uint32_t x, y, isr, osr;
+    uint32_t shift;   ///< Bits shifted out of the OSR (32 = empty).
+    const uint32_t *fifo;
+    size_t fifo_len;
+    size_t fifo_pos;
+    uint32_t delay;   ///< Delay cycles left.
+    uint8_t pin;
+    bool stalled;
+} sm_t;
+
+static program_t bpsk, qpsk;
+
+static int label_index(const program_t *p, const char *name)
+{
+    for (int i = 0; i < p->n_labels; i++)
+    {
+        if (strcmp(p->labels[i], name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Assembles one line of a program; false for an instruction it does not know.
+ */
+static bool assemble_line(program_t *p, char *line)
+{
+    char *semi = strchr(line, ';');
+    if (semi)
+    {
+        *semi = '\0';
+    }
+
+    char tok[4][24];
+    int n = 0;
+    for (char *t = strtok(line, " \t\r\n,"); t && n < 4; t = strtok(NULL, " \t\r\n,"))
+    {
+        snprintf(tok[n++], sizeof(tok[0]), "%s", t);
+    }
+    if (n == 0)
+    {
+        return true;
+    }
+    if (strcmp(tok[0], ".wrap_target") == 0)
+    {
+        p->wrap_target = p->len;
+        return true;
+    }
+    if (strcmp(tok[0], ".wrap") == 0)
+    {
+        p->wrap = (uint8_t)(p->len - 1u);
+        return true;
+    }
+
+    // Labels, with or without `public`
+    char *label = (strcmp(tok[0], "public") == 0 && n > 1) ? tok[1] : tok[0];
+    size_t l = strlen(label);
+    if (label[l - 1] == ':')
+    {
+        label[l - 1] = '\0';
+        snprintf(p->labels[p->n_labels], sizeof(p->labels[0]), "%s", label);
+        p->label_addr[p->n_labels++] = p->len;
+        return true;
+    }
+
+    instr_t *in = &p->code[p->len++];
+    memset(in, 0, sizeof(*in));
+    if (tok[n - 1][0] == '[')
+    {
+        in->delay = (uint8_t)atoi(&tok[n - 1][1]);
+        n--;
+    }
+
+    if (strcmp(tok[0], "nop") == 0 && n == 1)
+    {
+        in->op = OP_NOP;
+    }
+    else if (strcmp(tok[0], "out") == 0 && n == 3)
+    {
+        in->count = (uint8_t)atoi(tok[2]);
+        if (strcmp(tok[1], "x") == 0)
+        {
+            in->op = OP_OUT_X;
+        }
+        else if (strcmp(tok[1], "null") == 0)
+        {
+            in->op = OP_OUT_NULL;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if (strcmp(tok[0], "mov") == 0 && n == 3)
+    {
+        if (strcmp(tok[1], "y") == 0 && strcmp(tok[2], "isr") == 0)
+        {
+            in->op = OP_MOV_Y_ISR;
+        }
+        else if (strcmp(tok[1], "pins") == 0 && strcmp(tok[2], "x") == 0)
+        {
+            in->op = OP_MOV_PINS_X;
+        }
+        else if (strcmp(tok[1], "pins") == 0 && (strcmp(tok[2], "!x") == 0 || strcmp(tok[2], "~x") == 0))
+        {
+            in->op = OP_MOV_PINS_NOT_X;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if (strcmp(tok[0], "jmp") == 0 && n == 2)
+    {
+        in->op = OP_JMP;
+        snprintf(in->target, sizeof(in->target), "%s", tok[1]);
+    }
+    else if (strcmp(tok[0], "jmp") == 0 && n == 3 && strcmp(tok[1], "y--") == 0)
+    {
+        in->op = OP_JMP_Y_DEC;
+        snprintf(in->target, sizeof(in->target), "%s", tok[2]);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Assembles the program called name from psk_mod.pio.
+ */
+static bool assemble(program_t *p, const char *name)
+{
+    FILE *f = fopen(PSK_MOD_PIO_PATH, "r");
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    char line[160];
+    bool in_program = false;
+    bool ok = true;
+    memset(p, 0, sizeof(*p));
+    p->wrap = 0xFF;
+    while (fgets(line, sizeof(line), f))
+    {
+        char directive[24], prog[24];
+        if (sscanf(line, "%23s %23s", directive, prog) == 2 && strcmp(directive, ".program") == 0)
+        {
+            in_program = strcmp(prog, name) == 0;
+            continue;
+        }
+        if (in_program && !assemble_line(p, line))
+        {
+            fprintf(stderr, "%s: cannot assemble: %s", name, line);
+            ok = false;
+        }
+    }
+    fclose(f);
+    if (p->wrap == 0xFF)
+    {
+        p->wrap = (uint8_t)(p->len - 1u);
+    }
+
+    for (uint8_t i = 0; i < p->len; i++)
+    {
+        instr_t *in = &p->code[i];
+        if (in->op == OP_JMP || in->op == OP_JMP_Y_DEC)
+        {
+            int k = label_index(p, in->target);
+            ok = ok && k >= 0;
+            in->addr = k >= 0 ? p->label_addr[k] : 0;
+        }
+    }
+    return ok && p->len > 0;
+}
+
+/**
+ * @brief Puts a state machine in the state psk_mod_send() leaves it in before enabling it.
+ */
+static void sm_start(sm_t *s, const program_t *p, const char *entry, const psk_timing_t *t, const uint32_t *words,
+                     size_t n_words)
+{
+    memset(s, 0, sizeof(*s));
+    s->prog = p;
+    int k = entry ? label_index(p, entry) : -1;
+    s->pc = k >= 0 ? p->label_addr[k] : 0;
+    s->isr = t->cycles_per_symbol - 1u;
+    s->shift = 32; // Empty after `out isr, 32`
+    s->fifo = words;
+    s->fifo_len = n_words;
+}
+
+/**
+ * @brief Runs one PIO cycle.
+ */
+static void sm_step(sm_t *s)
+{
+    if (s->delay)
+    {
+        s->delay--;
+        return;
+    }
+
+    const instr_t *in = &s->prog->code[s->pc];
+    uint8_t next = (s->pc == s->prog->wrap) ? s->prog->wrap_target : (uint8_t)(s->pc + 1u);
+
+    switch (in->op)
+    {
+    case OP_OUT_X:
+    case OP_OUT_NULL:
+        if (s->shift >= 32u)
+        {
+            // Autopull; with nothing to pull the instruction stalls and is retried
+            if (s->fifo_pos == s->fifo_len)
+            {
+                s->stalled = true;
+                return;
+            }
+            s->osr = s->fifo[s->fifo_pos++];
+            s->shift = 0;
+        }
+        {
+            uint32_t v = (in->count >= 32u) ? s->osr : s->osr & ((1u << in->count) - 1u);
+            s->osr = (in->count >= 32u) ? 0 : s->osr >> in->count;
+            s->shift += in->count;
+            if (in->op == OP_OUT_X)
+            {
+                s->x = v;
+            }
+        }
+        break;
+    case OP_MOV_Y_ISR:
+        s->y = s->isr;
+        break;
+    case OP_MOV_PINS_X:
+        s->pin = (uint8_t)(s->x & 1u);
+        break;
+    case OP_MOV_PINS_NOT_X:
+        s->pin = (uint8_t)(~s->x & 1u);
+        break;
+    case OP_JMP:
+        next = in->addr;
+        break;
+    case OP_JMP_Y_DEC:
+        if (s->y != 0)
+        {
+            next = in->addr;
+        }
+        s->y--;
+        break;
+    default:
+        break;
+    }
+    s->stalled = false;
+    s->pc = next;
+    s->delay = in->delay;
+}
+
+static uint8_t emulated[MAX_CYCLES];
+static uint8_t expected[MAX_CYCLES];
+
+/**
+ * @brief Runs a buffer through the program and compares every cycle with psk_reference().
+ */
+static void compare(psk_mode_t mode, uint32_t cycles_per_symbol, const uint32_t *words, size_t n_words)
+{
+    psk_config_t cfg = {mode, 1000000u * cycles_per_symbol, 1000000u};
+    psk_timing_t t;
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), 0);
+
+    size_t n_symbols = n_words * 32u / (size_t)mode;
+    size_t n_cycles = PSK_QPSK_LEAD_CYCLES + t.half_cycles + (n_symbols + 2u) * t.samples_per_symbol;
+    sm_t arm[2];
+    size_t n_arms = (mode == PSK_MODE_QPSK) ? 2u : 1u;
+    if (mode == PSK_MODE_QPSK)
+    {
+        sm_start(&arm[0], &qpsk, "i_entry", &t, words, n_words);
+        sm_start(&arm[1], &qpsk, "q_entry", &t, words, n_words);
+    }
+    else
+    {
+        sm_start(&arm[0], &bpsk, NULL, &t, words, n_words);
+    }
+
+    for (size_t c = 0; c < n_cycles; c++)
+    {
+        for (size_t a = 0; a < n_arms; a++)
+        {
+            sm_step(&arm[a]);
+        }
+        emulated[c] = (uint8_t)(arm[0].pin | (n_arms == 2u ? arm[1].pin << 1 : 0));
+    }
+    psk_reference(mode, &t, words, n_symbols, expected, n_cycles);
+
+    size_t first_bad = n_cycles;
+    for (size_t c = 0; c < n_cycles && first_bad == n_cycles; c++)
+    {
+        if (emulated[c] != expected[c])
+        {
+            first_bad = c;
+        }
+    }
+    if (first_bad != n_cycles)
+    {
+        fprintf(stderr, "mode %d, %u periods/symbol, %zu words: cycle %zu (symbol %zu) is %u, expected %u\n",
+                (int)mode, (unsigned)cycles_per_symbol, n_words, first_bad,
+                first_bad / t.samples_per_symbol, emulated[first_bad], expected[first_bad]);
+    }
+    CHECK_EQ(first_bad, n_cycles);
+
+    // Every arm used the whole buffer and is now waiting for more
+    for (size_t a = 0; a < n_arms; a++)
+    {
+        CHECK(arm[a].stalled);
+        CHECK_EQ(arm[a].fifo_pos, n_words);
+        CHECK_EQ(arm[a].shift, 32);
+    }
+}
+
+static void test_waveforms(void)
+{
+    static const uint32_t periods[] = {1, 2, 5};
+    uint32_t words[MAX_WORDS];
+    srand(3);
+
+    for (size_t p = 0; p < sizeof(periods) / sizeof(periods[0]); p++)
+    {
+        for (size_t n = 1; n <= MAX_WORDS; n++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                words[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+            }
+            compare(PSK_MODE_BPSK, periods[p], words, n);
+            compare(PSK_MODE_QPSK, periods[p], words, n);
+        }
+    }
+
+    // Last bits set, so a symbol lost at the end of the buffer changes the final levels
+    const uint32_t tail[2] = {0x00000000u, 0xC0000000u};
+    compare(PSK_MODE_QPSK, 1, tail, 2);
+    compare(PSK_MODE_BPSK, 1, tail, 2);
+}
+
+static void test_timing(void)
+{
+    psk_timing_t t;
+    psk_config_t cfg = {PSK_MODE_BPSK, 1000000u, 250000u};
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), 0);
+    CHECK_EQ(t.half_cycles, PSK_BPSK_HALF_CYCLES);
+    CHECK_EQ(t.cycles_per_symbol, 4);
+    CHECK_EQ(t.samples_per_symbol, 2u * PSK_BPSK_HALF_CYCLES * 4u);
+    CHECK_EQ(t.clkdiv_int, 15); // 125 MHz / 8 MHz = 15.625
+    CHECK_EQ(t.clkdiv_frac, 160);
+    CHECK_EQ(t.carrier_mhz, 1000000000u);
+
+    cfg.mode = PSK_MODE_QPSK;
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), 0);
+    CHECK_EQ(t.half_cycles, PSK_QPSK_HALF_CYCLES);
+
+    cfg.symbol_rate_hz = 300000u;
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), PSK_ERR_RATIO);
+    cfg.symbol_rate_hz = 0;
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), PSK_ERR_RATIO);
+    cfg = (psk_config_t){PSK_MODE_BPSK, 20000000u, 20000000u}; // Needs a divider below 1
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), PSK_ERR_RANGE);
+    cfg = (psk_config_t){PSK_MODE_BPSK, 100u, 100u}; // Needs a divider above 65536
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), PSK_ERR_RANGE);
+    cfg = (psk_config_t){(psk_mode_t)3, 1000u, 100u};
+    CHECK_EQ(psk_compute_timing(&cfg, 125000000u, &t), PSK_ERR_MODE);
+
+    CHECK_EQ(psk_words_for_symbols(PSK_MODE_QPSK, 16), 1);
+    CHECK_EQ(psk_words_for_symbols(PSK_MODE_QPSK, 17), 2);
+    CHECK_EQ(psk_words_for_symbols(PSK_MODE_BPSK, 33), 2);
+
+    CHECK_EQ(psk_symbol_phase(PSK_MODE_BPSK, 1), 180);
+    CHECK_EQ(psk_symbol_phase(PSK_MODE_QPSK, 0), 315);
+    CHECK_EQ(psk_symbol_phase(PSK_MODE_QPSK, 3), 135);
+}
+
+int main(void)
+{
+    CHECK(assemble(&bpsk, "psk_bpsk"));
+    CHECK(assemble(&qpsk, "psk_qpsk"));
+    CHECK(label_index(&qpsk, "i_entry") >= 0 && label_index(&qpsk, "q_entry") >= 0);
+    if (bpsk.len && qpsk.len)
+    {
+        test_waveforms();
+    }
+    test_timing();
+    return host_test_result("test_psk_pio");
+}
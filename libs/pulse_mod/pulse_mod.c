@@ -0,0 +1,154 @@
+/**
+ * @file pulse_mod.c
+ * @brief PPM and PAM pulse outputs on PIO state machines, and PWM on a PWM slice, fed from a
+ * DMA sample ring.
+ */
+
+#include "pulse_mod.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pwm.h"
+#include "pulse_mod.pio.h"
+
+/// Written to the feeding channel's count-and-trigger register when its count runs out.
+static const uint32_t pulse_reload_count = 0xFFFFFFFFu;
+
+/**
+ * @brief Fills the ring with sample 0 and claims the two DMA channels that feed it to dest.
+ */
+static void pulse_out_init_dma(pulse_out_t *out, volatile void *dest, uint dreq)
+{
+    pulse_ring_init(&out->queue, out->ring, PULSE_OUT_RING_LEN, pulse_word(out->mode, &out->cfg, 0));
+
+    out->dma_chan = (uint)dma_claim_unused_channel(true);
+    out->reload_chan = (uint)dma_claim_unused_channel(true);
+
+    // Feeding channel: wraps around the ring forever, one word per request.
+    dma_channel_config dc = dma_channel_get_default_config(out->dma_chan);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_ring(&dc, false, PULSE_OUT_RING_BITS + 2u); // Wrap the read address
+    channel_config_set_dreq(&dc, dreq);
+    channel_config_set_chain_to(&dc, out->reload_chan);
+    dma_channel_configure(out->dma_chan, &dc, dest, out->ring, pulse_reload_count, false);
+
+    // Reload channel: restarts the feeding channel, keeping its read address.
+    dma_channel_config rc = dma_channel_get_default_config(out->reload_chan);
+    channel_config_set_transfer_data_size(&rc, DMA_SIZE_32);
+    channel_config_set_read_increment(&rc, false);
+    channel_config_set_write_increment(&rc, false);
+    dma_channel_configure(out->reload_chan, &rc, &dma_hw->ch[out->dma_chan].al1_transfer_count_trig,
+                          &pulse_reload_count, 1, false);
+}
+
+int pulse_out_init(pulse_out_t *out, PIO pio, pulse_mode_t mode, uint first_pin, uint pam_bits, uint32_t frame_hz,
+                   uint32_t pulse_ns)
+{
+    if (mode == PULSE_MODE_PWM)
+    {
+        return PULSE_ERR_RANGE; // See pulse_out_init_pwm()
+    }
+    uint n_pins = (mode == PULSE_MODE_PAM) ? pam_bits : 1u;
+    int err = pulse_timing(&out->cfg, clock_get_hz(clk_sys), frame_hz, pulse_ns, n_pins);
+    if (err)
+    {
+        return err;
+    }
+
+    out->pio = pio;
+    out->mode = mode;
+    out->sm = (uint)pio_claim_unused_sm(pio, true);
+
+    uint offset;
+    pio_sm_config c;
+    if (mode == PULSE_MODE_PAM)
+    {
+        offset = pio_add_program(pio, &pulse_pam_program);
+        c = pulse_pam_program_get_default_config(offset);
+        sm_config_set_out_pins(&c, first_pin, n_pins);
+    }
+    else
+    {
+        offset = pio_add_program(pio, &pulse_ppm_program);
+        c = pulse_ppm_program_get_default_config(offset);
+        sm_config_set_set_pins(&c, first_pin, 1);
+    }
+    sm_config_set_out_shift(&c, true, true, 32); // Low half first, one frame word per autopull
+    sm_config_set_clkdiv_int_frac(&c, out->cfg.clkdiv, 0);
+
+    for (uint i = 0; i < n_pins; i++)
+    {
+        pio_gpio_init(pio, first_pin + i);
+    }
+    pio_sm_set_consecutive_pindirs(pio, out->sm, first_pin, n_pins, true);
+    pio_sm_set_pins_with_mask(pio, out->sm, 0, ((1u << n_pins) - 1u) << first_pin);
+    pio_sm_init(pio, out->sm, offset, &c);
+
+    // The ISR holds the pulse width count for the whole run.
+    pio_sm_put(pio, out->sm, out->cfg.pulse_cycles - PULSE_MIN_WIDTH);
+    pio_sm_exec(pio, out->sm, pio_encode_pull(false, true));
+    pio_sm_exec(pio, out->sm, pio_encode_out(pio_isr, 32));
+
+    pulse_out_init_dma(out, &pio->txf[out->sm], pio_get_dreq(pio, out->sm, true));
+    return 0;
+}
+
+int pulse_out_init_pwm(pulse_out_t *out, uint pin, uint32_t frame_hz)
+{
+    int err = pulse_pwm_timing(&out->cfg, clock_get_hz(clk_sys), frame_hz);
+    if (err)
+    {
+        return err;
+    }
+
+    out->pio = NULL;
+    out->mode = PULSE_MODE_PWM;
+    out->slice = pwm_gpio_to_slice_num(pin);
+
+    // One counter period per frame; the level written at each wrap applies from the next one.
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_config c = pwm_get_default_config();
+    pwm_config_set_clkdiv_int(&c, out->cfg.clkdiv);
+    pwm_config_set_wrap(&c, (uint16_t)(out->cfg.frame_cycles - 1u));
+    pwm_init(out->slice, &c, false);
+    pwm_hw->slice[out->slice].cc = 0;
+
+    pulse_out_init_dma(out, &pwm_hw->slice[out->slice].cc, pwm_get_dreq(out->slice));
+    return 0;
+}
+
+void pulse_out_start(pulse_out_t *out)
+{
+    dma_channel_start(out->dma_chan);
+    if (out->pio == NULL)
+    {
+        pwm_set_enabled(out->slice, true);
+        return;
+    }
+
+    // Let the FIFO fill so the first frames are not stretched by a stall.
+    while (!pio_sm_is_tx_fifo_full(out->pio, out->sm))
+    {
+        tight_loop_contents();
+    }
+    pio_sm_set_enabled(out->pio, out->sm, true);
+}
+
+/**
+ * @brief Ring slot the DMA reads next.
+ */
+static uint32_t pulse_out_next(const pulse_out_t *out)
+{
+    return ((uint32_t)dma_channel_hw_addr(out->dma_chan)->read_addr - (uint32_t)out->ring) / sizeof(uint32_t);
+}
+
+size_t pulse_out_queue(pulse_out_t *out, const uint16_t *samples, size_t n)
+{
+    return pulse_ring_queue(&out->queue, pulse_out_next(out), out->mode, &out->cfg, samples, n);
+}
+
+void pulse_out_write(pulse_out_t *out, uint16_t sample)
+{
+    pulse_ring_hold(&out->queue, pulse_out_next(out), out->mode, &out->cfg, sample);
+}
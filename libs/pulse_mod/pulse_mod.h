@@ -0,0 +1,107 @@
+/**
+ * @file pulse_mod.h
+ * @brief PPM and PAM pulse outputs on PIO state machines, and PWM on a PWM slice, fed from a
+ * DMA sample ring.
+ *
+ * @details
+ * The state machine plays one frame per FIFO word (see pulse_model.h). A DMA channel reads a
+ * ring of frame words into the TX FIFO, paced by the FIFO's DREQ, and never stops: a second
+ * channel re-arms it if its transfer count ever runs out. The frame timing therefore comes
+ * only from the PIO clock, whatever the CPU is doing. For PWM the slice's counter wraps once
+ * per frame and the same DMA writes one compare level per wrap, paced by the wrap DREQ.
+ *
+ * pulse_out_queue() streams samples, one frame each: they go into the ring behind the ones
+ * still waiting, from the slot after the DMA read pointer, and the last one is held until
+ * the next write (see pulse_ring_t). A caller that queues a block of samples per block
+ * period, at the frame rate, therefore sends every sample in order. pulse_out_write() is
+ * the hold case: it drops the queue and sends one sample in every frame from the DMA read
+ * pointer on. Either way a frame word is a single 32-bit store, so a write racing the DMA
+ * only decides whether that frame gets the old or the new sample, and a sample reaches the
+ * pin after the frames queued before it and the 4 words in the TX FIFO.
+ */
+
+#ifndef PULSE_MOD_H
+#define PULSE_MOD_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "pulse_model.h"
+
+#define PULSE_OUT_RING_BITS 7u                        ///< log2 of the ring length.
+#define PULSE_OUT_RING_LEN (1u << PULSE_OUT_RING_BITS) ///< Frame words in the ring; up to one less can be queued.
+
+typedef struct pulse_out
+{
+    /// Frame words read by DMA; aligned to its size for the DMA ring wrap.
+    uint32_t ring[PULSE_OUT_RING_LEN] __attribute__((aligned(PULSE_OUT_RING_LEN * sizeof(uint32_t))));
+    PIO pio;              ///< PIO block running the modulator, or NULL for PWM.
+    uint sm;              ///< State machine.
+    uint slice;           ///< PWM slice (PWM only).
+    uint dma_chan;        ///< DMA channel feeding the FIFO from the ring.
+    uint reload_chan;     ///< DMA channel re-arming dma_chan.
+    pulse_mode_t mode;    ///< Modulation.
+    pulse_config_t cfg;   ///< Frame timing.
+    pulse_ring_t queue;   ///< Write position in the ring.
+} pulse_out_t;
+
+/**
+ * @brief Loads the modulator program and claims a state machine and two DMA channels.
+ *
+ * The ring starts filled with sample 0, with nothing queued.
+ *
+ * @param out Pointer to the output.
+ * @param pio PIO block to use.
+ * @param mode PULSE_MODE_PPM or PULSE_MODE_PAM (PULSE_MODE_PWM is refused with
+ *             PULSE_ERR_RANGE, see pulse_out_init_pwm()).
+ * @param first_pin PPM output pin, or the least significant ladder pin for PAM.
+ * @param pam_bits Ladder resolution for PAM (1 to 16); ignored for PPM.
+ * @param frame_hz Frames (samples) per second.
+ * @param pulse_ns Pulse width in nanoseconds.
+ * @return int 0 on success, or a negative PULSE_ERR_* code from pulse_timing().
+ */
+int pulse_out_init(pulse_out_t *out, PIO pio, pulse_mode_t mode, uint first_pin, uint pam_bits, uint32_t frame_hz,
+                   uint32_t pulse_ns);
+
+/**
+ * @brief Sets up a PWM slice whose period is one frame and claims two DMA channels.
+ *
+ * The pin is high for pulse_pwm_level() counts of each frame. The DMA writes the whole
+ * compare register, so the slice's other channel gets the same level. The ring starts
+ * filled with sample 0 (pin low), with nothing queued.
+ *
+ * @param out Pointer to the output.
+ * @param pin PWM output pin.
+ * @param frame_hz Frames (samples) per second.
+ * @return int 0 on success, or PULSE_ERR_RANGE from pulse_pwm_timing().
+ */
+int pulse_out_init_pwm(pulse_out_t *out, uint pin, uint32_t frame_hz);
+
+/**
+ * @brief Starts the DMA and the state machine or PWM slice.
+ */
+void pulse_out_start(pulse_out_t *out);
+
+/**
+ * @brief Queues samples, one frame each, behind the frames still waiting.
+ *
+ * The last sample queued is sent in every frame after it until the next write. If the DMA
+ * has already played every queued frame, the samples go out from the next frame on.
+ *
+ * @param out Pointer to the output.
+ * @param samples Input samples, 0 .. PULSE_SAMPLE_MAX.
+ * @param n Number of samples.
+ * @return size_t Number of samples queued; less than n if the ring is full.
+ */
+size_t pulse_out_queue(pulse_out_t *out, const uint16_t *samples, size_t n);
+
+/**
+ * @brief Sends a sample in every frame from now on, until the next write.
+ *
+ * Frames still queued are dropped.
+ *
+ * @param out Pointer to the output.
+ * @param sample Input sample, 0 .. PULSE_SAMPLE_MAX.
+ */
+void pulse_out_write(pulse_out_t *out, uint16_t sample);
+
+#endif // PULSE_MOD_H
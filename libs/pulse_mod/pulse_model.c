@@ -0,0 +1,232 @@
+/**
+ * @file pulse_model.c
+ * @brief Sample-to-pulse mapping and timing model of the PIO PPM/PAM modulators.
+ */
+
+#include "pulse_model.h"
+
+int pulse_timing(pulse_config_t *c, uint32_t sys_hz, uint32_t frame_hz, uint32_t pulse_ns, uint32_t pam_bits)
+{
+    if (frame_hz == 0 || pam_bits == 0 || pam_bits > 16u)
+    {
+        return PULSE_ERR_RANGE;
+    }
+
+    // Start from the divider that fits the frame in 16-bit counts and step up for rounding.
+    uint32_t div = (uint32_t)(((uint64_t)sys_hz / frame_hz) >> 16);
+    if (div == 0)
+    {
+        div = 1;
+    }
+
+    uint32_t frame;
+    uint32_t pulse;
+    for (;; div++)
+    {
+        if (div > 0xFFFFu)
+        {
+            return PULSE_ERR_RANGE;
+        }
+        uint32_t pio_hz = sys_hz / div;
+        frame = (pio_hz + frame_hz / 2u) / frame_hz;
+        pulse = (uint32_t)(((uint64_t)pulse_ns * pio_hz + 500000000u) / 1000000000u);
+
+        // The longest count is the PAM tail, F - P - 3 (the PPM delay and tail are shorter).
+        if (frame < pulse + PULSE_PPM_OVERHEAD || frame - pulse - 3u <= PULSE_MAX_COUNT)
+        {
+            break;
+        }
+    }
+
+    if (pulse < PULSE_MIN_WIDTH || frame < pulse + PULSE_PPM_OVERHEAD)
+    {
+        return PULSE_ERR_WIDTH;
+    }
+
+    c->clkdiv = (uint16_t)div;
+    c->frame_cycles = frame;
+    c->pulse_cycles = pulse;
+    c->min_rise = PULSE_PPM_MIN_RISE;
+    c->max_rise = frame - pulse - 2u; // Zero tail
+    c->pam_top = (uint16_t)((1u << pam_bits) - 1u);
+    return 0;
+}
+
+int pulse_pwm_timing(pulse_config_t *c, uint32_t sys_hz, uint32_t frame_hz)
+{
+    if (frame_hz == 0)
+    {
+        return PULSE_ERR_RANGE;
+    }
+
+    // The counter runs 0 .. frame - 1 and the level goes up to frame (always high), so the
+    // level must fit 16 bits. The divider has an 8-bit integer part.
+    uint32_t div = (sys_hz / frame_hz) >> 16;
+    if (div == 0)
+    {
+        div = 1;
+    }
+    uint32_t frame = 0;
+    for (; div <= 0xFFu; div++)
+    {
+        frame = (sys_hz / div + frame_hz / 2u) / frame_hz;
+        if (frame <= PULSE_MAX_COUNT)
+        {
+            break;
+        }
+    }
+    if (div > 0xFFu || frame < 2u)
+    {
+        return PULSE_ERR_RANGE;
+    }
+
+    c->clkdiv = (uint16_t)div;
+    c->frame_cycles = frame;
+    c->pulse_cycles = 0;
+    c->min_rise = 0;
+    c->max_rise = 0;
+    c->pam_top = 0;
+    return 0;
+}
+
+uint32_t pulse_pwm_level(const pulse_config_t *c, uint16_t sample)
+{
+    if (sample > PULSE_SAMPLE_MAX)
+    {
+        sample = PULSE_SAMPLE_MAX;
+    }
+    return (uint32_t)(((uint64_t)sample * c->frame_cycles + PULSE_SAMPLE_MAX / 2u) / PULSE_SAMPLE_MAX);
+}
+
+uint32_t pulse_ppm_position(const pulse_config_t *c, uint16_t sample)
+{
+    if (sample > PULSE_SAMPLE_MAX)
+    {
+        sample = PULSE_SAMPLE_MAX;
+    }
+    uint32_t span = c->max_rise - c->min_rise;
+    return c->min_rise + (uint32_t)(((uint64_t)sample * span + PULSE_SAMPLE_MAX / 2u) / PULSE_SAMPLE_MAX);
+}
+
+uint16_t pulse_pam_level(const pulse_config_t *c, uint16_t sample)
+{
+    if (sample > PULSE_SAMPLE_MAX)
+    {
+        sample = PULSE_SAMPLE_MAX;
+    }
+    return (uint16_t)(((uint32_t)sample * c->pam_top + PULSE_SAMPLE_MAX / 2u) / PULSE_SAMPLE_MAX);
+}
+
+uint32_t pulse_word(pulse_mode_t mode, const pulse_config_t *c, uint16_t sample)
+{
+    uint32_t low;
+    uint32_t tail;
+
+    if (mode == PULSE_MODE_PWM)
+    {
+        // Channel A in the low half of the compare register, channel B in the high half
+        uint32_t level = pulse_pwm_level(c, sample);
+        return level | (level << 16);
+    }
+    if (mode == PULSE_MODE_PAM)
+    {
+        // out pins, mov x, (W + 1), mov pins, out y, (T + 1): F = W + T + 6.
+        low = pulse_pam_level(c, sample);
+        tail = c->frame_cycles - c->pulse_cycles - 3u;
+    }
+    else
+    {
+        // out x, (D + 1), set, mov x, (W + 1), set, out y, (T + 1): F = D + W + T + 8.
+        uint32_t rise = pulse_ppm_position(c, sample);
+        low = rise - PULSE_PPM_MIN_RISE;
+        tail = c->frame_cycles - rise - c->pulse_cycles - 2u;
+    }
+    return low | (tail << 16);
+}
+
+void pulse_reference(pulse_mode_t mode, const pulse_config_t *c, const uint16_t *samples, size_t n_samples,
+                     uint16_t *out, size_t n_out)
+{
+    size_t frame = 0;
+    size_t start = 0; // First cycle of the current frame
+
+    for (size_t t = 0; t < n_out; t++)
+    {
+        if (t - start >= c->frame_cycles)
+        {
+            frame++;
+            start = t;
+        }
+        uint16_t sample = samples[(frame < n_samples) ? frame : n_samples - 1u];
+
+        // The PAM level is set by the frame's first instruction, so it shows from cycle 1.
+        uint32_t rise = (mode == PULSE_MODE_PAM) ? 1u : pulse_ppm_position(c, sample);
+        uint32_t u = (uint32_t)(t - start);
+        uint16_t high = (mode == PULSE_MODE_PAM) ? pulse_pam_level(c, sample) : 1u;
+
+        // The pins are low outside the pulses, including before the first one.
+        out[t] = (u >= rise && u < rise + c->pulse_cycles) ? high : 0u;
+    }
+}
+
+void pulse_ring_init(pulse_ring_t *r, uint32_t *words, uint32_t len, uint32_t word)
+{
+    r->words = words;
+    r->len = len;
+    r->write = 0;
+    r->queued = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        words[i] = word;
+    }
+}
+
+size_t pulse_ring_queue(pulse_ring_t *r, uint32_t next, pulse_mode_t mode, const pulse_config_t *c,
+                        const uint16_t *samples, size_t n)
+{
+    uint32_t mask = r->len - 1u;
+
+    // Frames still waiting. The reader only moves forward, so more than were left after the
+    // last write means it has gone past them into the held words: restart at the reader.
+    uint32_t queued = (r->write - next) & mask;
+    if (queued > r->queued)
+    {
+        r->write = next & mask;
+        queued = 0;
+    }
+
+    size_t room = r->len - 1u - queued;
+    if (n > room)
+    {
+        n = room;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    // A word is one 32-bit store, so a slot the reader takes while it is written goes out
+    // as the old or the new frame, never a mix.
+    uint32_t word = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        word = pulse_word(mode, c, samples[i]);
+        r->words[(r->write + i) & mask] = word;
+    }
+    r->write = (r->write + (uint32_t)n) & mask;
+    r->queued = queued + (uint32_t)n;
+
+    // Hold the last sample up to the slot before the reader
+    for (uint32_t i = r->queued; i < r->len; i++)
+    {
+        r->words[(next + i) & mask] = word;
+    }
+    return n;
+}
+
+void pulse_ring_hold(pulse_ring_t *r, uint32_t next, pulse_mode_t mode, const pulse_config_t *c, uint16_t sample)
+{
+    r->write = next & (r->len - 1u);
+    r->queued = 0;
+    pulse_ring_queue(r, next, mode, c, &sample, 1);
+}
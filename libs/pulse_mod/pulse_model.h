@@ -0,0 +1,198 @@
+/**
+ * @file pulse_model.h
+ * @brief Sample-to-pulse mapping and timing model of the PIO PPM/PAM modulators.
+ *
+ * @details
+ * Both modulators (pulse_mod.pio) send one fixed-length frame per FIFO word:
+ *
+ * - PPM: one pin. A pulse of fixed width starts at a position within the frame proportional
+ *   to the sample, between min_rise and max_rise.
+ * - PAM: consecutive pins driving an R-2R ladder. A pulse of fixed width starts at the
+ *   beginning of the frame with a level proportional to the sample, 0 .. pam_top.
+ *
+ * A frame word holds two 16-bit loop counts, so the PIO program needs no arithmetic: the
+ * delay before the pulse (PPM) or the pulse level (PAM) in the low half, and the idle tail
+ * that completes the frame in the high half. Every path through a program takes a fixed
+ * number of cycles per count, so the frame length never depends on the sample.
+ *
+ * Times are counted in PIO cycles from the first instruction of the frame, and a level
+ * takes effect on the cycle after the instruction that sets it. pulse_reference() reproduces
+ * the pin levels cycle by cycle from the same formulas as the words.
+ *
+ * PWM uses a PWM slice instead of a state machine: its counter wraps once per frame and the
+ * frame word is the compare level, so the pin is high for a share of the frame proportional
+ * to the sample.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef PULSE_MODEL_H
+#define PULSE_MODEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PULSE_SAMPLE_MAX 4095u     ///< Largest input sample (12-bit ADC).
+#define PULSE_MIN_WIDTH 3u         ///< Shortest pulse, in PIO cycles.
+#define PULSE_PPM_MIN_RISE 3u      ///< Earliest PPM pulse start (zero delay count).
+#define PULSE_PPM_OVERHEAD 8u      ///< Fixed cycles per PPM frame beyond the three counts.
+#define PULSE_PAM_OVERHEAD 6u      ///< Fixed cycles per PAM frame beyond the two counts.
+#define PULSE_MAX_COUNT 0xFFFFu    ///< Largest loop count that fits a half word.
+
+// Error codes returned by pulse_timing()
+#define PULSE_ERR_WIDTH -1 ///< Pulse too short, or too long for the frame.
+#define PULSE_ERR_RANGE -2 ///< Frame too long even at the largest clock divider.
+
+typedef enum pulse_mode
+{
+    PULSE_MODE_PPM = 0, ///< Pulse position modulation, one pin.
+    PULSE_MODE_PAM,     ///< Pulse amplitude modulation, R-2R ladder pins.
+    PULSE_MODE_PWM,     ///< Pulse width modulation on a PWM slice, one period per frame.
+} pulse_mode_t;
+
+/**
+ * @brief Frame words read in a circle by the DMA, and where the driver writes the next ones.
+ *
+ * The reader takes one word per frame and never stops; `next` below is the slot it reads
+ * next. Samples are queued one per slot behind the ones still waiting, and every slot after
+ * the last queued sample holds that sample's word, so when the queue runs dry the output
+ * keeps the last sample instead of replaying old ones.
+ *
+ * The reader is behind the writer by less than the ring as long as the driver writes at
+ * least once per ring of frames; `queued` tells a reader that has gone past the last queued
+ * sample (into the held words) from one that has not. The queue then restarts at the
+ * reader, so a late block goes out as soon as possible rather than a lap later.
+ */
+typedef struct pulse_ring
+{
+    uint32_t *words; ///< Frame words, read by the DMA.
+    uint32_t len;    ///< Number of words, a power of two.
+    uint32_t write;  ///< Slot of the next queued frame.
+    uint32_t queued; ///< Frames queued ahead of the reader at the end of the last write.
+} pulse_ring_t;
+
+typedef struct pulse_config
+{
+    uint16_t clkdiv;       ///< Integer PIO (or PWM) clock divider.
+    uint32_t frame_cycles; ///< PIO (or PWM counter) cycles per frame.
+    uint32_t pulse_cycles; ///< Pulse width in PIO cycles (at least PULSE_MIN_WIDTH).
+    uint32_t min_rise;     ///< PPM pulse start for sample 0.
+    uint32_t max_rise;     ///< PPM pulse start for PULSE_SAMPLE_MAX.
+    uint16_t pam_top;      ///< PAM level for PULSE_SAMPLE_MAX.
+} pulse_config_t;
+
+/**
+ * @brief Computes the clock divider and cycle counts for a frame rate and pulse width.
+ *
+ * The divider is the smallest integer that fits the frame in 16-bit loop counts, so the
+ * timing resolution is 1 / clk_sys for frame rates above about 2 kHz at 125 MHz.
+ *
+ * @param c Output configuration.
+ * @param sys_hz System clock frequency.
+ * @param frame_hz Frames (samples) per second.
+ * @param pulse_ns Pulse width in nanoseconds.
+ * @param pam_bits PAM ladder resolution in bits (1 to 16, ignored for PPM).
+ * @return int 0 on success, or a negative PULSE_ERR_* code.
+ */
+int pulse_timing(pulse_config_t *c, uint32_t sys_hz, uint32_t frame_hz, uint32_t pulse_ns, uint32_t pam_bits);
+
+/**
+ * @brief Computes the PWM clock divider and period for a frame rate.
+ *
+ * The divider is the smallest integer that fits the period in the 16-bit counter, so at
+ * 125 MHz a 10 kHz frame is 12500 counts, finer than the 12-bit samples. pulse_cycles,
+ * min_rise, max_rise and pam_top are not used and left at 0.
+ *
+ * @param c Output configuration.
+ * @param sys_hz System clock frequency.
+ * @param frame_hz Frames (samples) per second.
+ * @return int 0 on success, or PULSE_ERR_RANGE.
+ */
+int pulse_pwm_timing(pulse_config_t *c, uint32_t sys_hz, uint32_t frame_hz);
+
+/**
+ * @brief PWM compare level for a sample, 0 .. frame_cycles, rounded; larger samples are
+ * clamped. frame_cycles keeps the pin high for the whole frame.
+ */
+uint32_t pulse_pwm_level(const pulse_config_t *c, uint16_t sample);
+
+/**
+ * @brief PPM pulse start for a sample, in PIO cycles from the start of the frame.
+ *
+ * Linear from min_rise (sample 0) to max_rise (PULSE_SAMPLE_MAX), rounded to the nearest
+ * cycle; larger samples are clamped.
+ */
+uint32_t pulse_ppm_position(const pulse_config_t *c, uint16_t sample);
+
+/**
+ * @brief PAM pulse level for a sample, 0 .. pam_top, rounded; larger samples are clamped.
+ */
+uint16_t pulse_pam_level(const pulse_config_t *c, uint16_t sample);
+
+/**
+ * @brief FIFO word that sends one frame for a sample.
+ *
+ * @param mode Modulation.
+ * @param c Timing from pulse_timing().
+ * @param sample Input sample, 0 .. PULSE_SAMPLE_MAX.
+ * @return uint32_t Low half: delay count (PPM) or level (PAM); high half: tail count. For
+ *         PWM, the compare level in both halves, so it serves either channel of the slice.
+ */
+uint32_t pulse_word(pulse_mode_t mode, const pulse_config_t *c, uint16_t sample);
+
+/**
+ * @brief Generates the expected output, one value per PIO cycle, for frames sent back to back.
+ *
+ * Each value is the PPM pin level or the PAM ladder level; PWM is not modelled. Frame k carries samples[k]; after
+ * the last sample the frames repeat it, as the driver does when no new sample arrives.
+ *
+ * @param mode Modulation.
+ * @param c Timing from pulse_timing().
+ * @param samples Input samples, one per frame (at least one).
+ * @param n_samples Number of samples.
+ * @param out Output levels.
+ * @param n_out Number of cycles to generate.
+ */
+void pulse_reference(pulse_mode_t mode, const pulse_config_t *c, const uint16_t *samples, size_t n_samples,
+                     uint16_t *out, size_t n_out);
+
+/**
+ * @brief Fills a ring with one frame word and empties its queue.
+ *
+ * @param r Ring.
+ * @param words Storage read by the DMA.
+ * @param len Number of words, a power of two.
+ * @param word Frame word played until the first write.
+ */
+void pulse_ring_init(pulse_ring_t *r, uint32_t *words, uint32_t len, uint32_t word);
+
+/**
+ * @brief Queues samples, one frame each, behind the frames still waiting.
+ *
+ * At most len - 1 frames can wait, so the reader can always tell an empty queue from a full
+ * one; samples that do not fit are not queued. The last queued sample is held in every
+ * slot after it.
+ *
+ * @param r Ring.
+ * @param next Slot the reader takes next.
+ * @param mode Modulation.
+ * @param c Timing from pulse_timing().
+ * @param samples Input samples, 0 .. PULSE_SAMPLE_MAX.
+ * @param n Number of samples.
+ * @return size_t Number of samples queued.
+ */
+size_t pulse_ring_queue(pulse_ring_t *r, uint32_t next, pulse_mode_t mode, const pulse_config_t *c,
+                        const uint16_t *samples, size_t n);
+
+/**
+ * @brief Drops the queue and sends one sample in every frame from the reader on.
+ *
+ * @param r Ring.
+ * @param next Slot the reader takes next.
+ * @param mode Modulation.
+ * @param c Timing from pulse_timing().
+ * @param sample Input sample, 0 .. PULSE_SAMPLE_MAX.
+ */
+void pulse_ring_hold(pulse_ring_t *r, uint32_t next, pulse_mode_t mode, const pulse_config_t *c, uint16_t sample);
+
+#endif // PULSE_MODEL_H
@@ -0,0 +1,276 @@
+/**
+ * @file test_pulse_pio.c
+ * @brief pulse_reference() against a cycle-level run of pulse_mod.pio.
+ *
+ * @details
+ * pulse_ppm and pulse_pam are assembled from pulse_mod.pio and run on pio_sim as
+ * pulse_out_init() and pulse_out_start() set them up: ISR loaded with the width count, OSR
+ * empty, autopull every 32 bits from a joined 8-word FIFO that is kept full, and the pins
+ * low. The FIFO gets one pulse_word() per sample and then repeats the last one, as the
+ * driver's DMA ring does.
+ *
+ * A level takes effect on the cycle after the instruction that sets it, so the level of
+ * cycle t is read before the state machine runs cycle t. Every cycle must match
+ * pulse_reference() and the program must never stall. The mapping, word and timing helpers
+ * of pulse_model.h are checked as well.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "pio_sim.h"
+#include "pulse_model.h"
+
+#define PIN_BASE 2u
+#define FIFO_DEPTH 8u
+#define N_SAMPLES 24u
+#define EXTRA_FRAMES 3u
+#define MAX_CYCLES 200000u
+
+static pio_sim_program_t ppm, pam;
+static uint16_t expected[MAX_CYCLES];
+
+static uint16_t random_sample(void)
+{
+    return (uint16_t)(rand() % (PULSE_SAMPLE_MAX + 1u));
+}
+
+/**
+ * @brief Runs n_samples frames plus EXTRA_FRAMES repeats and compares every cycle.
+ */
+static void run_pio(pulse_mode_t mode, const pulse_config_t *c, uint32_t pam_bits, const uint16_t *samples,
+                    size_t n_samples)
+{
+    size_t n_cycles = (n_samples + EXTRA_FRAMES) * c->frame_cycles;
+    CHECK(n_cycles <= MAX_CYCLES);
+    if (n_cycles > MAX_CYCLES)
+    {
+        return;
+    }
+    pulse_reference(mode, c, samples, n_samples, expected, n_cycles);
+
+    pio_sim_config_t cfg = pio_sim_default_config();
+    if (mode == PULSE_MODE_PAM)
+    {
+        cfg.out_base = PIN_BASE;
+        cfg.out_count = (uint8_t)pam_bits;
+    }
+    else
+    {
+        cfg.set_base = PIN_BASE;
+        cfg.set_count = 1;
+    }
+    cfg.shift_right = true;
+    cfg.autopull = true;
+    cfg.pull_threshold = 32;
+    cfg.fifo_depth = FIFO_DEPTH;
+
+    pio_sim_sm_t sm;
+    pio_sim_init(&sm, mode == PULSE_MODE_PAM ? &pam : &ppm, &cfg, 0);
+    sm.isr = c->pulse_cycles - PULSE_MIN_WIDTH;
+
+    size_t fed = 0;
+    uint32_t mask = (mode == PULSE_MODE_PAM) ? (1u << pam_bits) - 1u : 1u;
+    size_t mismatches = 0;
+    size_t first_bad = 0;
+    size_t stalls = 0;
+    for (size_t t = 0; t < n_cycles; t++)
+    {
+        while (sm.fifo_level < FIFO_DEPTH)
+        {
+            uint16_t s = samples[(fed < n_samples) ? fed : n_samples - 1u];
+            pio_sim_put(&sm, pulse_word(mode, c, s));
+            fed++;
+        }
+        uint16_t level = (uint16_t)((sm.pins >> PIN_BASE) & mask);
+        if (level != expected[t] && mismatches++ == 0)
+        {
+            first_bad = t;
+        }
+        pio_sim_step(&sm);
+        stalls += sm.stalled;
+    }
+    if (mismatches)
+    {
+        fprintf(stderr, "  %s frame %u cycles: %zu mismatches, first at cycle %zu\n",
+                mode == PULSE_MODE_PAM ? "PAM" : "PPM", (unsigned)c->frame_cycles, mismatches, first_bad);
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(stalls, 0);
+
+    // The program reads one word per frame, so the run ends on a frame boundary
+    CHECK_EQ(sm.pc, 0);
+    CHECK_EQ(sm.osr_count, 32);
+}
+
+static void test_mode(pulse_mode_t mode, uint32_t sys_hz, uint32_t frame_hz, uint32_t pulse_ns, uint32_t pam_bits)
+{
+    pulse_config_t c;
+    CHECK_EQ(pulse_timing(&c, sys_hz, frame_hz, pulse_ns, pam_bits), 0);
+
+    // Extremes, a value past the 12-bit range (clamped), then noise
+    uint16_t samples[N_SAMPLES] = {0, PULSE_SAMPLE_MAX, 0, 0xFFFF, 1, PULSE_SAMPLE_MAX - 1u, PULSE_SAMPLE_MAX / 2u};
+    for (size_t i = 7; i < N_SAMPLES; i++)
+    {
+        samples[i] = random_sample();
+    }
+    run_pio(mode, &c, pam_bits, samples, N_SAMPLES);
+
+    // A single sample repeated from the first frame
+    run_pio(mode, &c, pam_bits, &samples[6], 1);
+}
+
+static void test_timing(void)
+{
+    pulse_config_t c;
+
+    // 125 MHz, 48 kHz frames, 1 us pulse: full clock, 2604 cycles per frame
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 1000u, 8u), 0);
+    CHECK_EQ(c.clkdiv, 1);
+    CHECK_EQ(c.frame_cycles, 2604);
+    CHECK_EQ(c.pulse_cycles, 125);
+    CHECK_EQ(c.min_rise, PULSE_PPM_MIN_RISE);
+    CHECK_EQ(c.max_rise, 2604 - 125 - 2);
+    CHECK_EQ(c.pam_top, 255);
+
+    // Slow frames need a divider so the PAM tail count fits 16 bits
+    static const uint32_t rates[] = {10u, 100u, 1000u, 1907u, 1908u, 2000u};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        CHECK_EQ(pulse_timing(&c, 125000000u, rates[i], 50000u, 16u), 0);
+        CHECK(c.frame_cycles - c.pulse_cycles - 3u <= PULSE_MAX_COUNT);
+        CHECK(c.pulse_cycles >= PULSE_MIN_WIDTH);
+        double frame_hz = 125e6 / c.clkdiv / c.frame_cycles;
+        CHECK_RANGE(frame_hz, rates[i] * 0.999, rates[i] * 1.001);
+        if (c.clkdiv > 1)
+        {
+            // The next smaller divider would not fit
+            uint32_t pio_hz = 125000000u / (c.clkdiv - 1u);
+            uint32_t frame = (pio_hz + rates[i] / 2u) / rates[i];
+            uint32_t pulse = (uint32_t)(((uint64_t)50000u * pio_hz + 500000000u) / 1000000000u);
+            CHECK(frame - pulse - 3u > PULSE_MAX_COUNT);
+        }
+    }
+
+    // Errors
+    CHECK_EQ(pulse_timing(&c, 125000000u, 0u, 1000u, 8u), PULSE_ERR_RANGE);
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 1000u, 0u), PULSE_ERR_RANGE);
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 1000u, 17u), PULSE_ERR_RANGE);
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 16u, 8u), PULSE_ERR_WIDTH);       // 2 cycles
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 20800u, 8u), PULSE_ERR_WIDTH);    // Fills the frame
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 24u, 8u), 0);                     // 3 cycles
+    CHECK_EQ(c.pulse_cycles, PULSE_MIN_WIDTH);
+}
+
+static void test_mapping(void)
+{
+    pulse_config_t c;
+    CHECK_EQ(pulse_timing(&c, 125000000u, 48000u, 1000u, 8u), 0);
+
+    CHECK_EQ(pulse_ppm_position(&c, 0), c.min_rise);
+    CHECK_EQ(pulse_ppm_position(&c, PULSE_SAMPLE_MAX), c.max_rise);
+    CHECK_EQ(pulse_ppm_position(&c, 0xFFFF), c.max_rise);
+    CHECK_EQ(pulse_pam_level(&c, 0), 0);
+    CHECK_EQ(pulse_pam_level(&c, PULSE_SAMPLE_MAX), c.pam_top);
+    CHECK_EQ(pulse_pam_level(&c, 0xFFFF), c.pam_top);
+
+    uint32_t prev_rise = 0;
+    uint16_t prev_level = 0;
+    for (uint16_t s = 0; s <= PULSE_SAMPLE_MAX; s++)
+    {
+        uint32_t rise = pulse_ppm_position(&c, s);
+        uint16_t level = pulse_pam_level(&c, s);
+        double ideal_rise = c.min_rise + (double)s * (c.max_rise - c.min_rise) / PULSE_SAMPLE_MAX;
+        double ideal_level = (double)s * c.pam_top / PULSE_SAMPLE_MAX;
+        CHECK_RANGE(rise, ideal_rise - 0.5, ideal_rise + 0.5);
+        CHECK_RANGE(level, ideal_level - 0.5, ideal_level + 0.5);
+        CHECK(rise >= prev_rise);
+        CHECK(level >= prev_level);
+        prev_rise = rise;
+        prev_level = level;
+
+        // The counts of a frame word add up to the frame length
+        uint32_t w = pulse_word(PULSE_MODE_PPM, &c, s);
+        uint32_t width = c.pulse_cycles - PULSE_MIN_WIDTH;
+        CHECK_EQ((w & 0xFFFFu) + PULSE_PPM_MIN_RISE, rise);
+        CHECK_EQ((w & 0xFFFFu) + width + (w >> 16) + PULSE_PPM_OVERHEAD, c.frame_cycles);
+        w = pulse_word(PULSE_MODE_PAM, &c, s);
+        CHECK_EQ(w & 0xFFFFu, level);
+        CHECK_EQ(width + (w >> 16) + PULSE_PAM_OVERHEAD, c.frame_cycles);
+    }
+}
+
+static void test_pwm(void)
+{
+    pulse_config_t c;
+
+    // 125 MHz, 10 kHz frames: full clock, 12500 counts per period
+    CHECK_EQ(pulse_pwm_timing(&c, 125000000u, 10000u), 0);
+    CHECK_EQ(c.clkdiv, 1);
+    CHECK_EQ(c.frame_cycles, 12500);
+
+    uint32_t prev = 0;
+    for (uint16_t s = 0; s <= PULSE_SAMPLE_MAX; s++)
+    {
+        uint32_t level = pulse_pwm_level(&c, s);
+        double ideal = (double)s * c.frame_cycles / PULSE_SAMPLE_MAX;
+        CHECK_RANGE(level, ideal - 0.5, ideal + 0.5);
+        CHECK(level > prev || s == 0);
+        prev = level;
+
+        // Both channels of the slice get the level
+        uint32_t w = pulse_word(PULSE_MODE_PWM, &c, s);
+        CHECK_EQ(w & 0xFFFFu, level);
+        CHECK_EQ(w >> 16, level);
+    }
+    CHECK_EQ(pulse_pwm_level(&c, 0), 0);
+    CHECK_EQ(pulse_pwm_level(&c, PULSE_SAMPLE_MAX), c.frame_cycles);
+    CHECK_EQ(pulse_pwm_level(&c, 0xFFFF), c.frame_cycles);
+
+    // Slow frames need a divider so the always-high level fits 16 bits
+    static const uint32_t rates[] = {10000u, 1908u, 1907u, 1000u, 100u, 8u};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        CHECK_EQ(pulse_pwm_timing(&c, 125000000u, rates[i]), 0);
+        CHECK(c.frame_cycles <= PULSE_MAX_COUNT);
+        double frame_hz = 125e6 / c.clkdiv / c.frame_cycles;
+        CHECK_RANGE(frame_hz, rates[i] * 0.999, rates[i] * 1.001);
+        if (c.clkdiv > 1)
+        {
+            uint32_t frame = (125000000u / (c.clkdiv - 1u) + rates[i] / 2u) / rates[i];
+            CHECK(frame > PULSE_MAX_COUNT);
+        }
+    }
+
+    // The divider's integer part is 8 bits
+    CHECK_EQ(pulse_pwm_timing(&c, 125000000u, 0u), PULSE_ERR_RANGE);
+    CHECK_EQ(pulse_pwm_timing(&c, 125000000u, 7u), PULSE_ERR_RANGE);
+    CHECK_EQ(pulse_pwm_timing(&c, 125000000u, 100000000u), PULSE_ERR_RANGE);
+}
+
+int main(void)
+{
+    srand(11);
+
+    if (pio_sim_load(&ppm, PULSE_MOD_PIO_PATH, "pulse_ppm") != 0 ||
+        pio_sim_load(&pam, PULSE_MOD_PIO_PATH, "pulse_pam") != 0)
+    {
+        fprintf(stderr, "cannot load %s\n", PULSE_MOD_PIO_PATH);
+        return 1;
+    }
+
+    test_timing();
+    test_mapping();
+    test_pwm();
+
+    // Short frames exercise every count down to zero; 48 kHz is a full-clock frame.
+    test_mode(PULSE_MODE_PPM, 1000000u, 50000u, 3000u, 1u);
+    test_mode(PULSE_MODE_PPM, 1000000u, 10000u, 5000u, 1u);
+    test_mode(PULSE_MODE_PPM, 125000000u, 48000u, 1000u, 1u);
+    test_mode(PULSE_MODE_PAM, 1000000u, 50000u, 3000u, 1u);
+    test_mode(PULSE_MODE_PAM, 1000000u, 10000u, 5000u, 4u);
+    test_mode(PULSE_MODE_PAM, 125000000u, 48000u, 1000u, 8u);
+    test_mode(PULSE_MODE_PAM, 125000000u, 48000u, 2000u, 16u);
+
+    return host_test_result("pulse_pio");
+}
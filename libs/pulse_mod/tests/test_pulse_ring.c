@@ -0,0 +1,219 @@
+/**
+ * @file test_pulse_ring.c
+ * @brief pulse_ring_queue() and pulse_ring_hold() against a reader that takes one word per
+ * frame, as the driver's DMA does.
+ *
+ * @details
+ * Every sample of a run is distinct, so each frame read maps back to the sample it carries.
+ * Blocks of samples are queued once per block period, late by a random number of frames:
+ * the frames must carry every sample in order, each for one frame unless the queue ran dry,
+ * and then only the last queued sample is repeated. A writer that is on time after the
+ * first block never lets the queue run dry.
+ *
+ * The other cases: a block queued after the reader has played every held frame goes out
+ * from the next frame, a full ring refuses what does not fit and takes it once the reader
+ * has moved on, and a hold drops the queue and sends its sample from the next frame.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "pulse_model.h"
+
+#define RING_LEN 128u
+#define BLOCK 64u
+#define BLOCKS 60u
+#define SAMPLES (BLOCKS * BLOCK)
+
+static pulse_config_t cfg;
+static pulse_ring_t ring;
+static uint32_t words[RING_LEN];
+static uint32_t reader;             ///< Slot read next.
+static uint16_t sample_of[0x10000]; ///< PPM delay count of a sample back to the sample.
+static uint16_t samples[SAMPLES];
+
+/**
+ * @brief Reads one frame and returns the sample it carries.
+ */
+static uint16_t read_frame(void)
+{
+    uint32_t w = words[reader];
+    reader = (reader + 1u) & (RING_LEN - 1u);
+    return sample_of[w & 0xFFFFu];
+}
+
+static void setup(void)
+{
+    // 10 kHz frames: the PPM delay count is distinct for every 12-bit sample
+    CHECK_EQ(pulse_timing(&cfg, 125000000u, 10000u, 2000u, 4u), 0);
+    memset(sample_of, 0xFF, sizeof(sample_of));
+    for (uint16_t s = 0; s <= PULSE_SAMPLE_MAX; s++)
+    {
+        uint32_t w = pulse_word(PULSE_MODE_PPM, &cfg, s);
+        CHECK_EQ(sample_of[w & 0xFFFFu], 0xFFFF);
+        sample_of[w & 0xFFFFu] = s;
+    }
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        samples[i] = (uint16_t)(i % (PULSE_SAMPLE_MAX + 1u));
+    }
+    pulse_ring_init(&ring, words, RING_LEN, pulse_word(PULSE_MODE_PPM, &cfg, 0));
+    reader = (uint32_t)rand() & (RING_LEN - 1u);
+}
+
+/**
+ * @brief Streams the samples in blocks, each queued at the end of its block period plus up
+ * to max_late frames, and checks the frames that come out.
+ *
+ * @return uint32_t Frames in which the last queued sample was repeated.
+ */
+static uint32_t run_stream(uint32_t max_late)
+{
+    setup();
+
+    uint32_t due = BLOCK + (uint32_t)rand() % (max_late + 1u); // Frame the next block is queued at
+    size_t queued = 0;
+    size_t expected = 0; // Sample the next frame must carry
+    uint32_t repeats = 0;
+    uint32_t order_errors = 0;
+    bool started = false;
+    for (uint32_t t = 0; expected < SAMPLES && t < 4u * SAMPLES; t++)
+    {
+        if (t == due && queued < SAMPLES)
+        {
+            CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + queued, BLOCK), BLOCK);
+            queued += BLOCK;
+            due = (uint32_t)(queued + BLOCK) + (uint32_t)rand() % (max_late + 1u);
+            started = true;
+        }
+
+        uint16_t s = read_frame();
+        if (!started)
+        {
+            CHECK_EQ(s, 0);
+        }
+        else if (s == samples[expected])
+        {
+            expected++;
+        }
+        else if (expected > 0 && s == samples[expected - 1u] && expected == queued)
+        {
+            repeats++; // The queue ran dry: the last sample is held
+        }
+        else
+        {
+            order_errors++;
+        }
+    }
+    CHECK_EQ(order_errors, 0);
+    CHECK_EQ(expected, SAMPLES);
+    return repeats;
+}
+
+static void test_stream(void)
+{
+    // On time, the reader never waits; late blocks only ever repeat the last sample
+    CHECK_EQ(run_stream(0), 0);
+    for (uint32_t late = 1; late <= 40u; late += 13u)
+    {
+        uint32_t repeats = run_stream(late);
+        CHECK(repeats <= BLOCKS * late);
+    }
+}
+
+static void test_underrun(void)
+{
+    setup();
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples, 10), 10);
+    for (uint32_t i = 0; i < 10u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[i]);
+    }
+
+    // The reader plays the held sample up to the end of the lap, then the next block starts
+    // at once
+    for (uint32_t i = 10; i < RING_LEN - 1u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[9]);
+    }
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + 10, 5), 5);
+    for (uint32_t i = 10; i < 15u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[i]);
+    }
+    CHECK_EQ(read_frame(), samples[14]);
+}
+
+static void test_full(void)
+{
+    setup();
+
+    // One slot always stays free
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples, 200), RING_LEN - 1u);
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + RING_LEN - 1u, 10), 0);
+
+    for (uint32_t i = 0; i < 20u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[i]);
+    }
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + RING_LEN - 1u, 30), 20);
+    for (uint32_t i = 20; i < RING_LEN - 1u + 20u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[i]);
+    }
+    CHECK_EQ(read_frame(), samples[RING_LEN - 1u + 19u]);
+}
+
+static void test_hold(void)
+{
+    setup();
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples, 50), 50);
+    CHECK_EQ(read_frame(), samples[0]);
+
+    // The hold replaces what was queued, from the next frame
+    pulse_ring_hold(&ring, reader, PULSE_MODE_PPM, &cfg, 3000);
+    for (uint32_t i = 0; i < RING_LEN - 1u; i++)
+    {
+        CHECK_EQ(read_frame(), 3000);
+    }
+
+    // A queue after a hold starts at the reader
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + 100, 3), 3);
+    CHECK_EQ(read_frame(), samples[100]);
+    pulse_ring_hold(&ring, reader, PULSE_MODE_PPM, &cfg, 7);
+    CHECK_EQ(read_frame(), 7);
+    CHECK_EQ(read_frame(), 7);
+
+    // After several laps of a hold the reader's position is ambiguous, but every slot holds
+    // the same sample: the next block still goes out in order within a lap
+    for (uint32_t i = 0; i < 3u * RING_LEN + 5u; i++)
+    {
+        CHECK_EQ(read_frame(), 7);
+    }
+    CHECK_EQ(pulse_ring_queue(&ring, reader, PULSE_MODE_PPM, &cfg, samples + 200, 20), 20);
+    uint32_t waited = 0;
+    uint16_t s;
+    while ((s = read_frame()) == 7 && waited < RING_LEN)
+    {
+        waited++;
+    }
+    CHECK(waited < RING_LEN);
+    CHECK_EQ(s, samples[200]);
+    for (uint32_t i = 201; i < 220u; i++)
+    {
+        CHECK_EQ(read_frame(), samples[i]);
+    }
+}
+
+int main(void)
+{
+    srand(10);
+
+    test_stream();
+    test_underrun();
+    test_full();
+    test_hold();
+
+    return host_test_result("pulse_ring");
+}
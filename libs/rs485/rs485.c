@@ -0,0 +1,150 @@
+/**
+ * @file rs485.c
+ * @brief RS485 half-duplex transmitter on a PIO state machine with exact DE/RE switching.
+ */
+
+#include "rs485.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "rs485_tx.pio.h"
+
+static rs485_t *active_rs485 = NULL; ///< Driver serviced by the interrupts.
+
+/**
+ * @brief IO_IRQ_BANK0 handler: first start bit on RX after the bus was released.
+ */
+static void rs485_rx_edge_irq(void)
+{
+    rs485_t *r = active_rs485;
+    if (r == NULL || !(gpio_get_irq_event_mask(r->rx_pin) & GPIO_IRQ_EDGE_FALL))
+    {
+        return;
+    }
+    gpio_acknowledge_irq(r->rx_pin, GPIO_IRQ_EDGE_FALL);
+    gpio_set_irq_enabled(r->rx_pin, GPIO_IRQ_EDGE_FALL, false);
+
+    uint32_t reply = time_us_32() - r->release_us;
+    r->stats.replies++;
+    r->stats.last_reply_us = reply;
+    if (reply > r->stats.max_reply_us)
+    {
+        r->stats.max_reply_us = reply;
+    }
+}
+
+/**
+ * @brief PIO IRQ 0 handler: timestamps DE rising and falling.
+ */
+static void rs485_pio_irq(void)
+{
+    rs485_t *r = active_rs485;
+    if (r == NULL)
+    {
+        return;
+    }
+    uint rise_flag = r->sm;
+    uint fall_flag = (r->sm + 2u) & 3u;
+
+    // Both flags can be pending; take them in the order the program raises them.
+    for (uint pass = 0; pass < 2; pass++)
+    {
+        if (!r->in_frame && pio_interrupt_get(r->pio, rise_flag))
+        {
+            pio_interrupt_clear(r->pio, rise_flag);
+            r->assert_us = time_us_32();
+            r->in_frame = true;
+            // A new frame before any reply: the last one went unanswered.
+            gpio_set_irq_enabled(r->rx_pin, GPIO_IRQ_EDGE_FALL, false);
+        }
+        if (r->in_frame && pio_interrupt_get(r->pio, fall_flag))
+        {
+            pio_interrupt_clear(r->pio, fall_flag);
+            r->release_us = time_us_32();
+            r->in_frame = false;
+
+            uint32_t frame = r->release_us - r->assert_us;
+            r->stats.frames++;
+            r->stats.last_frame_us = frame;
+            if (frame > r->stats.max_frame_us)
+            {
+                r->stats.max_frame_us = frame;
+            }
+
+            // Time the reply from here; a stale edge from before the release is dropped.
+            gpio_acknowledge_irq(r->rx_pin, GPIO_IRQ_EDGE_FALL);
+            gpio_set_irq_enabled(r->rx_pin, GPIO_IRQ_EDGE_FALL, true);
+        }
+    }
+}
+
+void rs485_init(rs485_t *r, PIO pio, uint tx_pin, uint de_pin, uint rx_pin, uint baud_rate)
+{
+    r->pio = pio;
+    r->de_pin = de_pin;
+    r->rx_pin = rx_pin;
+    r->assert_us = 0;
+    r->release_us = 0;
+    r->in_frame = false;
+    r->stats = (rs485_stats_t){0};
+
+    r->offset = pio_add_program(pio, &rs485_tx_program);
+    r->sm = (uint)pio_claim_unused_sm(pio, true);
+
+    // TX idles high, DE low (receiving).
+    uint32_t pins = (1u << tx_pin) | (1u << de_pin);
+    pio_gpio_init(pio, tx_pin);
+    pio_gpio_init(pio, de_pin);
+    pio_sm_set_pins_with_mask(pio, r->sm, 1u << tx_pin, pins);
+    pio_sm_set_pindirs_with_mask(pio, r->sm, pins, pins);
+    gpio_pull_up(rx_pin);
+
+    // RS485_CYCLES_PER_BIT PIO cycles per bit; divider in 1/256 steps, rounded to nearest.
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint64_t pio_hz = (uint64_t)baud_rate * RS485_CYCLES_PER_BIT;
+    uint64_t div256 = ((uint64_t)sys_hz * 256u + pio_hz / 2u) / pio_hz;
+    r->baud_rate = (uint)(((uint64_t)sys_hz * 256u) / (div256 * RS485_CYCLES_PER_BIT));
+
+    pio_sm_config c = rs485_tx_program_get_default_config(r->offset);
+    sm_config_set_out_pins(&c, tx_pin, 1);
+    sm_config_set_set_pins(&c, tx_pin, 1);
+    sm_config_set_sideset_pins(&c, de_pin);
+    sm_config_set_out_shift(&c, true, false, 32); // LSB first, explicit pull per byte
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_mov_status(&c, STATUS_TX_LESSTHAN, 1);
+    sm_config_set_clkdiv_int_frac(&c, (uint16_t)(div256 >> 8), (uint8_t)(div256 & 0xFFu));
+    pio_sm_init(pio, r->sm, r->offset, &c);
+
+    active_rs485 = r;
+    pio_interrupt_clear(pio, r->sm);
+    pio_interrupt_clear(pio, (r->sm + 2u) & 3u);
+    pio_set_irq0_source_enabled(pio, (enum pio_interrupt_source)(pis_interrupt0 + r->sm), true);
+    pio_set_irq0_source_enabled(pio, (enum pio_interrupt_source)(pis_interrupt0 + ((r->sm + 2u) & 3u)), true);
+    irq_add_shared_handler(pio_get_irq_num(pio, 0), rs485_pio_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(pio_get_irq_num(pio, 0), true);
+    gpio_add_raw_irq_handler(rx_pin, rs485_rx_edge_irq);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    pio_sm_set_enabled(pio, r->sm, true);
+}
+
+void rs485_write_blocking(rs485_t *r, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        pio_sm_put_blocking(r->pio, r->sm, data[i]);
+    }
+}
+
+bool rs485_tx_idle(const rs485_t *r)
+{
+    // Stalled on the first `pull` with nothing queued: the bus has been released.
+    return pio_sm_is_tx_fifo_empty(r->pio, r->sm) && pio_sm_get_pc(r->pio, r->sm) == r->offset;
+}
+
+void rs485_get_stats(rs485_t *r, rs485_stats_t *out)
+{
+    uint32_t status = save_and_disable_interrupts();
+    *out = r->stats;
+    restore_interrupts(status);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file rs485.h
+ * @brief RS485 half-duplex transmitter on a PIO state machine with exact DE/RE switching.
+ *
+ * @details
+ * The TX line and the transceiver's DE/RE pin are both driven by rs485_tx.pio, so the
+ * driver enables the bus one bit before a burst and releases it on the PIO cycle its last
+ * stop bit ends (see rs485_model.h), at any baud rate and with no CPU involvement. Bytes
+ * are written to the state machine's TX FIFO, either with rs485_write_blocking() or by a
+ * DMA channel paced by rs485_tx_dreq(), e.g. as the TX sink of a uart_bridge direction.
+ * Reception stays on the hardware UART's RX pin.
+ *
+ * With DE and /RE tied together the receiver is off while transmitting, so the driver
+ * pulls the RX pin up to keep the UART from seeing a break while RO floats.
+ *
+ * The PIO raises an interrupt when DE rises and when it falls; the handler timestamps both
+ * and then arms a falling-edge interrupt on the RX pin to time the start of the reply. This
+ * gives per-frame latency counters with microsecond resolution; the switching itself is
+ * bit-exact whatever the interrupt latency. Only one driver can be active at a time. It
+ * uses the state machine's IRQ flags 0 and 2 (relative) and shares PIOx_IRQ_0 and
+ * IO_IRQ_BANK0.
+ */
+
+#ifndef RS485_H
+#define RS485_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "rs485_model.h"
+
+typedef struct rs485_stats
+{
+    uint32_t frames;        ///< Bursts sent (DE high periods).
+    uint32_t last_frame_us; ///< DE high time of the last frame.
+    uint32_t max_frame_us;  ///< Longest DE high time.
+    uint32_t replies;       ///< Frames followed by a start bit on RX before the next frame.
+    uint32_t last_reply_us; ///< DE release to the reply's start bit, last frame.
+    uint32_t max_reply_us;  ///< Longest release-to-reply time.
+} rs485_stats_t;
+
+typedef struct rs485
+{
+    PIO pio;                 ///< PIO block.
+    uint sm;                 ///< State machine.
+    uint offset;             ///< Program offset.
+    uint de_pin;             ///< DE/RE GPIO (high = transmit).
+    uint rx_pin;             ///< RX GPIO, timed for replies.
+    uint baud_rate;          ///< Baud rate actually produced.
+    uint32_t assert_us;      ///< Time DE last rose.
+    uint32_t release_us;     ///< Time DE last fell.
+    bool in_frame;           ///< DE is high.
+    rs485_stats_t stats;     ///< Latency counters.
+} rs485_t;
+
+/**
+ * @brief Loads the transmitter, sets TX idle and DE low, and starts it.
+ *
+ * @param r Pointer to the driver.
+ * @param pio PIO block to use.
+ * @param tx_pin GPIO to the transceiver's DI input.
+ * @param de_pin GPIO to DE and /RE.
+ * @param rx_pin GPIO from the transceiver's RO output (read by a UART).
+ * @param baud_rate Baud rate; the divider is rounded to 1/256.
+ */
+void rs485_init(rs485_t *r, PIO pio, uint tx_pin, uint de_pin, uint rx_pin, uint baud_rate);
+
+/**
+ * @brief TX FIFO register, the destination for a DMA channel.
+ */
+static inline volatile void *rs485_tx_fifo(const rs485_t *r)
+{
+    return &r->pio->txf[r->sm];
+}
+
+/**
+ * @brief DREQ pacing writes to rs485_tx_fifo().
+ */
+static inline uint rs485_tx_dreq(const rs485_t *r)
+{
+    return pio_get_dreq(r->pio, r->sm, true);
+}
+
+/**
+ * @brief Queues bytes, waiting for room in the TX FIFO.
+ */
+void rs485_write_blocking(rs485_t *r, const uint8_t *data, size_t len);
+
+/**
+ * @brief True once every queued byte is sent and the bus is released.
+ */
+bool rs485_tx_idle(const rs485_t *r);
+
+/**
+ * @brief Copies the latency counters, consistent with each other.
+ */
+void rs485_get_stats(rs485_t *r, rs485_stats_t *out);
+
+#endif // RS485_H
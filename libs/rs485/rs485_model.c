@@ -0,0 +1,233 @@
+/**
+ * @file rs485_model.c
+ * @brief Cycle-level mock of the PIO RS485 transmitter and a turnaround analyzer.
+ */
+
+#include "rs485_model.h"
+
+typedef enum mock_op
+{
+    OP_PULL,         ///< pull block
+    OP_IRQ,          ///< irq nowait (no effect on the pins)
+    OP_SET_PINS,     ///< set pins, arg
+    OP_SET_X,        ///< set x, arg
+    OP_OUT_PINS,     ///< out pins, 1
+    OP_JMP_X_DEC,    ///< jmp x-- target
+    OP_MOV_X_STATUS, ///< mov x, status (TX FIFO level < 1)
+    OP_JMP_NOT_X,    ///< jmp !x target
+    OP_JMP,          ///< jmp target
+} mock_op_t;
+
+typedef struct mock_instr
+{
+    mock_op_t op;   ///< Operation.
+    uint8_t arg;    ///< SET value or jump target.
+    uint8_t delay;  ///< Delay cycles.
+    int8_t side;    ///< Side-set value, -1 for none.
+} mock_instr_t;
+
+/// rs485_tx.pio, line by line.
+static const mock_instr_t program[] = {
+    {OP_PULL, 0, 0, 0},         // 0: wrap target
+    {OP_IRQ, 0, 7, 1},          // 1
+    {OP_SET_PINS, 0, 6, -1},    // 2
+    {OP_SET_X, 7, 0, -1},       // 3
+    {OP_OUT_PINS, 0, 6, -1},    // 4: bit
+    {OP_JMP_X_DEC, 4, 0, -1},   // 5
+    {OP_SET_PINS, 1, 5, -1},    // 6
+    {OP_MOV_X_STATUS, 0, 0, -1},// 7
+    {OP_JMP_NOT_X, 10, 0, -1},  // 8
+    {OP_IRQ, 2, 0, 0},          // 9: wrap
+    {OP_SET_PINS, 0, 4, -1},    // 10: more
+    {OP_PULL, 0, 0, -1},        // 11
+    {OP_SET_X, 7, 0, -1},       // 12
+    {OP_JMP, 4, 0, -1},         // 13
+};
+
+#define WRAP_TOP 9u
+#define WRAP_TARGET 0u
+
+void rs485_mock_run(const uint8_t *bytes, const uint32_t *ready, size_t n, uint8_t *tx, uint8_t *de,
+                    size_t n_out)
+{
+    uint32_t fifo[RS485_FIFO_DEPTH];
+    uint32_t fifo_head = 0, fifo_tail = 0;
+    size_t next = 0;
+
+    uint32_t pc = 0, x = 0, osr = 0, delay = 0;
+    uint8_t pin_tx = 1, pin_de = 0;
+
+    for (size_t t = 0; t < n_out; t++)
+    {
+        // DMA: the next byte goes in as soon as it is ready and there is room.
+        while (next < n && ready[next] <= t && fifo_head - fifo_tail < RS485_FIFO_DEPTH)
+        {
+            fifo[fifo_head++ % RS485_FIFO_DEPTH] = bytes[next++] * 0x01010101u;
+        }
+
+        if (delay)
+        {
+            delay--;
+        }
+        else
+        {
+            const mock_instr_t *in = &program[pc];
+            uint32_t npc = (pc == WRAP_TOP) ? WRAP_TARGET : pc + 1u;
+            bool stall = false;
+
+            // Side-set takes effect on the first cycle, even if the instruction stalls.
+            if (in->side >= 0)
+            {
+                pin_de = (uint8_t)in->side;
+            }
+
+            switch (in->op)
+            {
+            case OP_PULL:
+                if (fifo_head == fifo_tail)
+                {
+                    stall = true;
+                }
+                else
+                {
+                    osr = fifo[fifo_tail++ % RS485_FIFO_DEPTH];
+                }
+                break;
+            case OP_IRQ:
+                break;
+            case OP_SET_PINS:
+                pin_tx = in->arg;
+                break;
+            case OP_SET_X:
+                x = in->arg;
+                break;
+            case OP_OUT_PINS:
+                pin_tx = (uint8_t)(osr & 1u);
+                osr >>= 1;
+                break;
+            case OP_JMP_X_DEC:
+                if (x != 0)
+                {
+                    npc = in->arg;
+                }
+                x--;
+                break;
+            case OP_MOV_X_STATUS:
+                x = (fifo_head == fifo_tail) ? 0xFFFFFFFFu : 0u;
+                break;
+            case OP_JMP_NOT_X:
+                if (x == 0)
+                {
+                    npc = in->arg;
+                }
+                break;
+            case OP_JMP:
+                npc = in->arg;
+                break;
+            }
+
+            if (!stall)
+            {
+                pc = npc;
+                delay = in->delay;
+            }
+        }
+
+        tx[t] = pin_tx;
+        de[t] = pin_de;
+    }
+}
+
+void rs485_measure(const uint8_t *tx, const uint8_t *de, size_t n, uint8_t *decoded, rs485_timing_t *t)
+{
+    const size_t bit = RS485_CYCLES_PER_BIT;
+    size_t burst_start = 0, last_end = 0, skip_until = 0;
+    bool in_burst = false, first = false, have_end = false;
+
+    *t = (rs485_timing_t){0};
+    t->min_lead = UINT32_MAX;
+    t->min_release = INT32_MAX;
+    t->max_release = INT32_MIN;
+
+    for (size_t i = 1; i < n; i++)
+    {
+        if (de[i] && !de[i - 1])
+        {
+            t->bursts++;
+            burst_start = i;
+            in_burst = true;
+            first = true;
+            have_end = false;
+        }
+        else if (!de[i] && de[i - 1] && in_burst)
+        {
+            if (have_end)
+            {
+                int32_t release = (int32_t)i - (int32_t)last_end;
+                t->min_release = (release < t->min_release) ? release : t->min_release;
+                t->max_release = (release > t->max_release) ? release : t->max_release;
+            }
+            in_burst = false;
+        }
+
+        // A start bit is a falling edge on an idle line; the byte is decoded ahead.
+        if (i < skip_until || !(tx[i - 1] && !tx[i]))
+        {
+            continue;
+        }
+        size_t s = i;
+        size_t e = s + RS485_FRAME_BITS * bit;
+        if (e > n)
+        {
+            break;
+        }
+
+        uint8_t value = 0;
+        for (uint32_t k = 0; k < 8u; k++)
+        {
+            value |= (uint8_t)((tx[s + (k + 1u) * bit + bit / 2u] & 1u) << k);
+        }
+        if (!tx[s + 9u * bit + bit / 2u])
+        {
+            t->framing_errors++;
+        }
+        for (size_t j = s; j < e; j++)
+        {
+            if (!de[j])
+            {
+                t->unguarded++;
+                break;
+            }
+        }
+        if (decoded != NULL)
+        {
+            decoded[t->bytes] = value;
+        }
+        t->bytes++;
+
+        if (in_burst && first)
+        {
+            uint32_t lead = (uint32_t)(s - burst_start);
+            t->min_lead = (lead < t->min_lead) ? lead : t->min_lead;
+            t->max_lead = (lead > t->max_lead) ? lead : t->max_lead;
+            first = false;
+        }
+        else if (in_burst && have_end && s - last_end > t->max_gap)
+        {
+            t->max_gap = (uint32_t)(s - last_end);
+        }
+        last_end = e;
+        have_end = true;
+        skip_until = s + 9u * bit + bit / 2u + 1u;
+    }
+
+    if (t->min_lead == UINT32_MAX)
+    {
+        t->min_lead = 0;
+    }
+    if (t->min_release == INT32_MAX)
+    {
+        t->min_release = 0;
+        t->max_release = 0;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file rs485_model.h
+ * @brief Cycle-level mock of the PIO RS485 transmitter and a turnaround analyzer.
+ *
+ * @details
+ * The transmitter (rs485_tx.pio) runs at RS485_CYCLES_PER_BIT PIO cycles per bit and drives
+ * both the TX line and the transceiver's DE/RE pin, so the bus direction follows the data
+ * exactly instead of waiting for a software timer:
+ *
+ * - DE rises RS485_LEAD_BITS bit before the first start bit of a burst (the line idles high,
+ *   so the transceiver drives a mark while it settles).
+ * - Bytes already in the TX FIFO follow back to back with DE held high.
+ * - DE falls on the cycle the last stop bit ends, when the FIFO is empty at that point.
+ *
+ * rs485_mock_run() executes the program instruction by instruction, with its delays, FIFO
+ * stalls and side-set, and gives the TX and DE levels at every PIO cycle. rs485_measure()
+ * decodes such a trace, from the mock or from a logic analyzer sampling at the PIO clock,
+ * and reports the lead and release times and any bit sent with DE low. On the host the two
+ * together check the turnaround against the program.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef RS485_MODEL_H
+#define RS485_MODEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define RS485_CYCLES_PER_BIT 8u ///< PIO cycles per bit.
+#define RS485_LEAD_BITS 1u      ///< Bits between DE rising and the first start bit.
+#define RS485_FRAME_BITS 10u    ///< Start, 8 data bits, stop (8N1).
+#define RS485_FIFO_DEPTH 8u     ///< Joined TX FIFO.
+
+typedef struct rs485_timing
+{
+    uint32_t bursts;          ///< DE high periods.
+    uint32_t bytes;           ///< Bytes decoded.
+    uint32_t framing_errors;  ///< Bytes whose stop bit was low.
+    uint32_t unguarded;       ///< Bytes with at least one cycle sent while DE was low.
+    uint32_t min_lead;        ///< Shortest DE rise to start bit, in cycles.
+    uint32_t max_lead;        ///< Longest DE rise to start bit, in cycles.
+    int32_t min_release;      ///< Earliest DE fall after the last stop bit ends, in cycles.
+    int32_t max_release;      ///< Latest DE fall after the last stop bit ends, in cycles.
+    uint32_t max_gap;         ///< Longest idle time between two bytes of a burst, in cycles.
+} rs485_timing_t;
+
+/**
+ * @brief Runs the transmitter program on a byte stream.
+ *
+ * Byte i enters the TX FIFO at cycle ready[i], or later if the FIFO is full (as a DMA
+ * channel paced by the FIFO's DREQ would). The state machine starts at cycle 0 with TX
+ * high and DE low.
+ *
+ * @param bytes Bytes to send.
+ * @param ready Earliest cycle each byte is written to the FIFO, non-decreasing.
+ * @param n Number of bytes.
+ * @param tx Output, TX level at each cycle.
+ * @param de Output, DE level at each cycle.
+ * @param n_out Number of cycles to run.
+ */
+void rs485_mock_run(const uint8_t *bytes, const uint32_t *ready, size_t n, uint8_t *tx, uint8_t *de,
+                    size_t n_out);
+
+/**
+ * @brief Decodes a TX/DE trace and measures the direction switching.
+ *
+ * @param tx TX level at each cycle.
+ * @param de DE level at each cycle.
+ * @param n Number of cycles.
+ * @param decoded Output, the decoded bytes (room for n / (RS485_FRAME_BITS * cycles per bit)),
+ *                or NULL.
+ * @param t Output timing.
+ */
+void rs485_measure(const uint8_t *tx, const uint8_t *de, size_t n, uint8_t *decoded, rs485_timing_t *t);
+
+#endif // RS485_MODEL_H
@@ -0,0 +1,248 @@
+/**
+ * @file test_rs485.c
+ * @brief rs485_mock_run() against rs485_tx.pio on pio_sim, and the turnaround analyzer.
+ *
+ * @details
+ * Each scenario is a byte stream with the cycle each byte reaches the TX FIFO: single
+ * bytes, back-to-back bursts longer than the FIFO, bytes that arrive just before or just
+ * after the FIFO is checked at the end of a stop bit, and random traffic. It is sent
+ * through the hand-written mock and through the program assembled from rs485_tx.pio,
+ * configured as rs485_init() does (side-set DE, joined 8-word FIFO, STATUS_TX_LESSTHAN 1,
+ * TX idle high), and the TX and DE levels must agree on every cycle. The IRQ flags the
+ * program raises must mark the DE edges, with the relative numbering of each state machine.
+ *
+ * rs485_measure() must then decode every byte of the trace with a one-bit lead, DE released
+ * as the last stop bit ends, and no bit sent with DE low; damaged traces must be reported.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "pio_sim.h"
+#include "rs485_model.h"
+
+#define TX_PIN 4u
+#define DE_PIN 5u
+#define MAX_BYTES 64u
+#define MAX_CYCLES 20000u
+#define BIT RS485_CYCLES_PER_BIT
+#define FRAME (RS485_FRAME_BITS * BIT)
+
+static pio_sim_program_t prog;
+static uint8_t mock_tx[MAX_CYCLES], mock_de[MAX_CYCLES];
+static uint8_t sim_tx[MAX_CYCLES], sim_de[MAX_CYCLES];
+
+typedef struct scenario
+{
+    uint8_t bytes[MAX_BYTES];
+    uint32_t ready[MAX_BYTES];
+    size_t n;
+    size_t cycles;
+} scenario_t;
+
+/**
+ * @brief Runs the assembled program as rs485_init() sets it up.
+ */
+static void run_pio(const scenario_t *sc, uint8_t sm_index)
+{
+    pio_sim_config_t cfg = pio_sim_default_config();
+    cfg.out_base = TX_PIN;
+    cfg.out_count = 1;
+    cfg.set_base = TX_PIN;
+    cfg.set_count = 1;
+    cfg.sideset_base = DE_PIN;
+    cfg.shift_right = true;
+    cfg.autopull = false;
+    cfg.pull_threshold = 32;
+    cfg.status_n = 1;
+    cfg.fifo_depth = RS485_FIFO_DEPTH;
+    cfg.sm_index = sm_index;
+
+    pio_sim_sm_t sm;
+    pio_sim_init(&sm, &prog, &cfg, 0);
+    sm.pins = 1u << TX_PIN;
+
+    uint8_t rise_flag = (uint8_t)(1u << sm_index);
+    uint8_t fall_flag = (uint8_t)(1u << ((sm_index + 2u) & 3u));
+    size_t next = 0;
+    size_t bad_irq = 0;
+    for (size_t t = 0; t < sc->cycles; t++)
+    {
+        while (next < sc->n && sc->ready[next] <= t && sm.fifo_level < RS485_FIFO_DEPTH)
+        {
+            pio_sim_put(&sm, sc->bytes[next++] * 0x01010101u);
+        }
+        uint8_t de_before = pio_sim_pin(&sm, DE_PIN);
+        pio_sim_step(&sm);
+        sim_tx[t] = pio_sim_pin(&sm, TX_PIN);
+        sim_de[t] = pio_sim_pin(&sm, DE_PIN);
+
+        // The CPU takes each flag as it is raised; no other flag may be used
+        bool rose = sim_de[t] && !de_before;
+        bool fell = !sim_de[t] && de_before;
+        bad_irq += ((sm.irq & rise_flag) != 0) != rose;
+        bad_irq += ((sm.irq & fall_flag) != 0) != fell;
+        bad_irq += (sm.irq & ~(rise_flag | fall_flag)) != 0;
+        sm.irq = 0;
+    }
+    CHECK_EQ(bad_irq, 0);
+}
+
+/**
+ * @brief Compares the mock with the program and checks the measured turnaround.
+ */
+static void check(const scenario_t *sc, const char *name)
+{
+    CHECK(sc->cycles <= MAX_CYCLES);
+    rs485_mock_run(sc->bytes, sc->ready, sc->n, mock_tx, mock_de, sc->cycles);
+
+    for (uint8_t sm_index = 0; sm_index < 4u; sm_index++)
+    {
+        run_pio(sc, sm_index);
+        size_t mismatches = 0;
+        size_t first = 0;
+        for (size_t t = 0; t < sc->cycles; t++)
+        {
+            if ((mock_tx[t] != sim_tx[t] || mock_de[t] != sim_de[t]) && mismatches++ == 0)
+            {
+                first = t;
+            }
+        }
+        if (mismatches)
+        {
+            fprintf(stderr, "  %s: %zu cycles differ, first at %zu\n", name, mismatches, first);
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    uint8_t decoded[MAX_CYCLES / FRAME];
+    rs485_timing_t tm;
+    rs485_measure(mock_tx, mock_de, sc->cycles, decoded, &tm);
+    CHECK_EQ(tm.bytes, sc->n);
+    CHECK(memcmp(decoded, sc->bytes, sc->n) == 0);
+    CHECK_EQ(tm.framing_errors, 0);
+    CHECK_EQ(tm.unguarded, 0);
+    CHECK_EQ(tm.min_lead, RS485_LEAD_BITS * BIT);
+    CHECK_EQ(tm.max_lead, RS485_LEAD_BITS * BIT);
+    CHECK_EQ(tm.min_release, 0);
+    CHECK_EQ(tm.max_release, 0);
+    CHECK_EQ(mock_de[sc->cycles - 1u], 0);
+    CHECK_EQ(mock_tx[sc->cycles - 1u], 1);
+}
+
+static void test_scenarios(void)
+{
+    scenario_t sc;
+
+    // One byte
+    memset(&sc, 0, sizeof(sc));
+    sc.bytes[0] = 0xA5;
+    sc.ready[0] = 3;
+    sc.n = 1;
+    sc.cycles = 2u * FRAME + 20u;
+    check(&sc, "single");
+
+    // 40 bytes ready at once: the FIFO refills as it drains, one burst without gaps
+    memset(&sc, 0, sizeof(sc));
+    for (size_t i = 0; i < 40u; i++)
+    {
+        sc.bytes[i] = (uint8_t)(i * 37u + 1u);
+    }
+    sc.n = 40;
+    sc.cycles = 42u * FRAME;
+    check(&sc, "burst");
+    rs485_timing_t tm;
+    rs485_measure(mock_tx, mock_de, sc.cycles, NULL, &tm);
+    CHECK_EQ(tm.bursts, 1);
+    CHECK_EQ(tm.max_gap, 0);
+
+    // A second byte arriving around the end of the first one's stop bit, cycle by cycle:
+    // early enough it joins the burst, later it starts a new one after a full release.
+    for (uint32_t late = FRAME - 16u; late <= FRAME + 16u; late++)
+    {
+        memset(&sc, 0, sizeof(sc));
+        sc.bytes[0] = 0x00;
+        sc.bytes[1] = 0xFF;
+        sc.ready[1] = late;
+        sc.n = 2;
+        sc.cycles = 4u * FRAME;
+        check(&sc, "late");
+    }
+
+    // Random bytes and arrival times
+    for (int run = 0; run < 20; run++)
+    {
+        memset(&sc, 0, sizeof(sc));
+        uint32_t t = 0;
+        for (size_t i = 0; i < MAX_BYTES; i++)
+        {
+            sc.bytes[i] = (uint8_t)rand();
+            t += (rand() % 4 == 0) ? (uint32_t)(rand() % (3 * FRAME)) : 0u;
+            sc.ready[i] = t;
+        }
+        sc.n = MAX_BYTES;
+        sc.cycles = t + (MAX_BYTES + 2u) * FRAME;
+        if (sc.cycles > MAX_CYCLES)
+        {
+            sc.cycles = MAX_CYCLES;
+            continue;
+        }
+        check(&sc, "random");
+    }
+}
+
+static void test_measure_errors(void)
+{
+    scenario_t sc;
+    memset(&sc, 0, sizeof(sc));
+    sc.bytes[0] = 0x3C;
+    sc.bytes[1] = 0x81;
+    sc.n = 2;
+    sc.cycles = 3u * FRAME;
+    rs485_mock_run(sc.bytes, sc.ready, sc.n, mock_tx, mock_de, sc.cycles);
+
+    // Find the first start bit
+    size_t start = 1;
+    while (!(mock_tx[start - 1u] && !mock_tx[start]))
+    {
+        start++;
+    }
+
+    // DE released two bits early: the last byte is sent partly unguarded
+    rs485_timing_t tm;
+    memcpy(sim_de, mock_de, sc.cycles);
+    for (size_t t = start + 2u * FRAME - 2u * BIT; t < sc.cycles; t++)
+    {
+        sim_de[t] = 0;
+    }
+    rs485_measure(mock_tx, sim_de, sc.cycles, NULL, &tm);
+    CHECK_EQ(tm.bytes, 2);
+    CHECK_EQ(tm.unguarded, 1);
+    CHECK_EQ(tm.min_release, -2 * (int32_t)BIT);
+
+    // A low stop bit on the first byte
+    memcpy(sim_tx, mock_tx, sc.cycles);
+    for (size_t t = start + 9u * BIT; t < start + FRAME; t++)
+    {
+        sim_tx[t] = 0;
+    }
+    rs485_measure(sim_tx, mock_de, sc.cycles, NULL, &tm);
+    CHECK(tm.framing_errors >= 1);
+}
+
+int main(void)
+{
+    srand(13);
+
+    if (pio_sim_load(&prog, RS485_TX_PIO_PATH, "rs485_tx") != 0)
+    {
+        fprintf(stderr, "cannot load %s\n", RS485_TX_PIO_PATH);
+        return 1;
+    }
+
+    test_scenarios();
+    test_measure_errors();
+
+    return host_test_result("rs485");
+}
@@ -0,0 +1,291 @@
+/**
+ * @file sample_frame.c
+ * @brief Compact binary frames for streaming ADC samples to a host.
+ */
+
+#include "sample_frame.h"
+
+/** CRC-16/CCITT-FALSE lookup table (poly 0x1021), one entry per byte value. */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t sample_frame_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    while (len--)
+    {
+        crc = (uint16_t)(crc << 8) ^ crc16_table[(uint8_t)(crc >> 8) ^ *data++];
+    }
+    return crc;
+}
+
+size_t sample_frame_pack12(uint8_t *out, const uint16_t *samples, size_t count)
+{
+    uint8_t *p = out;
+    size_t pairs = count / 2;
+
+    for (size_t i = 0; i < pairs; i++)
+    {
+        uint16_t a = samples[0] & 0x0FFF;
+        uint16_t b = samples[1] & 0x0FFF;
+        p[0] = (uint8_t)a;
+        p[1] = (uint8_t)((a >> 8) | (b << 4));
+        p[2] = (uint8_t)(b >> 4);
+        samples += 2;
+        p += 3;
+    }
+
+    // An odd trailing sample takes two bytes.
+    if (count & 1u)
+    {
+        uint16_t a = samples[0] & 0x0FFF;
+        p[0] = (uint8_t)a;
+        p[1] = (uint8_t)(a >> 8);
+        p += 2;
+    }
+    return (size_t)(p - out);
+}
+
+void sample_frame_unpack12(uint16_t *samples, const uint8_t *in, size_t count)
+{
+    size_t pairs = count / 2;
+
+    for (size_t i = 0; i < pairs; i++)
+    {
+        samples[0] = (uint16_t)(in[0] | ((in[1] & 0x0F) << 8));
+        samples[1] = (uint16_t)((in[1] >> 4) | (in[2] << 4));
+        samples += 2;
+        in += 3;
+    }
+
+    if (count & 1u)
+    {
+        samples[0] = (uint16_t)(in[0] | ((in[1] & 0x0F) << 8));
+    }
+}
+
+/**
+ * @brief Writes the header fields of a frame.
+ */
+static void put_header(uint8_t *out, uint8_t type, uint8_t channel, uint16_t seq, uint16_t count)
+{
+    out[0] = SAMPLE_FRAME_SYNC0;
+    out[1] = SAMPLE_FRAME_SYNC1;
+    out[2] = type;
+    out[3] = channel;
+    out[4] = (uint8_t)seq;
+    out[5] = (uint8_t)(seq >> 8);
+    out[6] = (uint8_t)count;
+    out[7] = (uint8_t)(count >> 8);
+}
+
+/**
+ * @brief Appends the CRC over everything after the sync word.
+ *
+ * @return size_t Total frame length.
+ */
+static size_t put_crc(uint8_t *out, size_t payload_len)
+{
+    size_t body = SAMPLE_FRAME_HEADER_LEN + payload_len;
+    uint16_t crc = sample_frame_crc16(0xFFFF, out + 2, body - 2);
+    out[body] = (uint8_t)crc;
+    out[body + 1] = (uint8_t)(crc >> 8);
+    return body + SAMPLE_FRAME_CRC_LEN;
+}
+
+size_t sample_frame_encode12(uint8_t *out, size_t out_size, uint8_t channel, uint16_t seq,
+                             const uint16_t *samples, uint16_t count)
+{
+    if (out_size < SAMPLE_FRAME_RAW12_LEN(count))
+    {
+        return 0;
+    }
+
+    put_header(out, SAMPLE_FRAME_TYPE_RAW12, channel, seq, count);
+    size_t payload_len = sample_frame_pack12(out + SAMPLE_FRAME_HEADER_LEN, samples, count);
+    return put_crc(out, payload_len);
+}
+
+/**
+ * @brief Number of 16-bit words per payload element, or 0 if the type is not a word type.
+ */
+static size_t words_per_element(uint8_t type)
+{
+    switch (type)
+    {
+    case SAMPLE_FRAME_TYPE_RAW16:
+    case SAMPLE_FRAME_TYPE_SPECTRUM16:
+        return 1;
+    case SAMPLE_FRAME_TYPE_PEAKS:
+    case SAMPLE_FRAME_TYPE_STATUS:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+size_t sample_frame_encode16(uint8_t *out, size_t out_size, uint8_t type, uint8_t channel, uint16_t seq,
+                             const uint16_t *words, uint16_t count)
+{
+    size_t per = words_per_element(type);
+    size_t n_words = per * count;
+    if (per == 0 || out_size < SAMPLE_FRAME_WORDS16_LEN(n_words))
+    {
+        return 0;
+    }
+
+    put_header(out, type, channel, seq, count);
+    uint8_t *p = out + SAMPLE_FRAME_HEADER_LEN;
+    for (size_t i = 0; i < n_words; i++)
+    {
+        p[2 * i] = (uint8_t)words[i];
+        p[2 * i + 1] = (uint8_t)(words[i] >> 8);
+    }
+    return put_crc(out, 2 * n_words);
+}
+
+size_t sample_frame_encode_status(uint8_t *out, size_t out_size, uint8_t channel, uint16_t seq,
+                                  const uint32_t *fields, uint16_t count)
+{
+    if (out_size < SAMPLE_FRAME_STATUS_LEN(count))
+    {
+        return 0;
+    }
+
+    put_header(out, SAMPLE_FRAME_TYPE_STATUS, channel, seq, count);
+    uint8_t *p = out + SAMPLE_FRAME_HEADER_LEN;
+    for (size_t i = 0; i < count; i++)
+    {
+        p[4 * i] = (uint8_t)fields[i];
+        p[4 * i + 1] = (uint8_t)(fields[i] >> 8);
+        p[4 * i + 2] = (uint8_t)(fields[i] >> 16);
+        p[4 * i + 3] = (uint8_t)(fields[i] >> 24);
+    }
+    return put_crc(out, 4u * count);
+}
+
+/**
+ * @brief Payload length in bytes for a frame type and element count.
+ *
+ * @return long Length, or -1 for an unknown type.
+ */
+static long payload_len(uint8_t type, uint16_t count)
+{
+    switch (type)
+    {
+    case SAMPLE_FRAME_TYPE_RAW12:
+        return (long)SAMPLE_FRAME_PACKED12_LEN((size_t)count);
+    case SAMPLE_FRAME_TYPE_RAW16:
+    case SAMPLE_FRAME_TYPE_SPECTRUM16:
+    case SAMPLE_FRAME_TYPE_PEAKS:
+    case SAMPLE_FRAME_TYPE_STATUS:
+        return (long)(2u * words_per_element(type) * count);
+    default:
+        return -1;
+    }
+}
+
+int sample_frame_decode(const uint8_t *frame, size_t len, sample_frame_header_t *hdr,
+                        uint16_t *samples, size_t max_samples)
+{
+    if (len < SAMPLE_FRAME_HEADER_LEN)
+    {
+        return SAMPLE_FRAME_ERR_SHORT;
+    }
+    if (frame[0] != SAMPLE_FRAME_SYNC0 || frame[1] != SAMPLE_FRAME_SYNC1)
+    {
+        return SAMPLE_FRAME_ERR_SYNC;
+    }
+
+    hdr->type = frame[2];
+    hdr->channel = frame[3];
+    hdr->seq = (uint16_t)(frame[4] | (frame[5] << 8));
+    hdr->count = (uint16_t)(frame[6] | (frame[7] << 8));
+
+    long plen = payload_len(hdr->type, hdr->count);
+    if (plen < 0)
+    {
+        return SAMPLE_FRAME_ERR_TYPE;
+    }
+
+    size_t total = SAMPLE_FRAME_HEADER_LEN + (size_t)plen + SAMPLE_FRAME_CRC_LEN;
+    if (len < total)
+    {
+        return SAMPLE_FRAME_ERR_SHORT;
+    }
+
+    uint16_t crc = sample_frame_crc16(0xFFFF, frame + 2, total - SAMPLE_FRAME_CRC_LEN - 2);
+    uint16_t rx_crc = (uint16_t)(frame[total - 2] | (frame[total - 1] << 8));
+    if (crc != rx_crc)
+    {
+        return SAMPLE_FRAME_ERR_CRC;
+    }
+
+    const uint8_t *payload = frame + SAMPLE_FRAME_HEADER_LEN;
+    if (hdr->type == SAMPLE_FRAME_TYPE_RAW12)
+    {
+        if (hdr->count > max_samples)
+        {
+            return SAMPLE_FRAME_ERR_SPACE;
+        }
+        sample_frame_unpack12(samples, payload, hdr->count);
+    }
+    else
+    {
+        size_t n_words = (size_t)plen / 2;
+        if (n_words > max_samples)
+        {
+            return SAMPLE_FRAME_ERR_SPACE;
+        }
+        for (size_t i = 0; i < n_words; i++)
+        {
+            samples[i] = (uint16_t)(payload[2 * i] | (payload[2 * i + 1] << 8));
+        }
+    }
+    return (int)total;
+}
+
+uint16_t sample_frame_track_seq(sample_frame_seq_t *tracker, uint16_t seq)
+{
+    uint16_t lost = 0;
+
+    if (tracker->started)
+    {
+        lost = (uint16_t)(seq - tracker->next);
+        tracker->dropped += lost;
+    }
+    tracker->started = true;
+    tracker->next = (uint16_t)(seq + 1);
+    return lost;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file sample_frame.h
+ * @brief Compact binary frames for streaming ADC samples to a host.
+ *
+ * @details
+ * Every frame has the same little-endian layout:
+ *
+ * | Offset | Size | Field                                           |
+ * |--------|------|-------------------------------------------------|
+ * | 0      | 2    | Sync word 0xA5 0x5A                             |
+ * | 2      | 1    | Frame type (SAMPLE_FRAME_TYPE_*)                |
+ * | 3      | 1    | Channel (ADC input the samples come from)       |
+ * | 4      | 2    | Sequence number, incremented once per frame     |
+ * | 6      | 2    | Number of samples in the payload                |
+ * | 8      | n    | Payload                                         |
+ * | 8 + n  | 2    | CRC-16/CCITT-FALSE of bytes 2 .. 8 + n - 1      |
+ *
+ * The count field is the number of elements in the payload; what an element is depends on the type.
+ *
+ * For SAMPLE_FRAME_TYPE_RAW12 the payload holds 12-bit samples packed two per three bytes:
+ * `b0 = a[7:0]`, `b1 = a[11:8] | b[3:0] << 4`, `b2 = b[11:4]`. An odd trailing sample takes
+ * two bytes. A block of 1024 samples is 1546 bytes on the wire, against roughly 6 KB when each
+ * sample is printed as a decimal line. A gap in the sequence numbers tells the host how many
+ * frames were lost.
+ *
+ * SAMPLE_FRAME_TYPE_RAW16 carries one little-endian u16 per sample, for oversampled output with
+ * more than 12 bits (ADC code * 16 at full resolution, see oversample_process()).
+ *
+ * SAMPLE_FRAME_TYPE_SPECTRUM16 carries one little-endian u16 magnitude per FFT bin, and
+ * SAMPLE_FRAME_TYPE_PEAKS carries `count` (bin, magnitude) pairs of u16, largest peak first.
+ * A 512-bin spectrum is 1034 bytes and eight peaks are 42 bytes.
+ *
+ * SAMPLE_FRAME_TYPE_STATUS carries `count` little-endian u32 counters describing the capture
+ * itself (see capture_stats_to_fields() for the field order). Status frames share the sequence
+ * counter of the data frames they are interleaved with.
+ *
+ * This file has no dependency on the Pico SDK. The matching Python decoder is sample_frame.py.
+ */
+
+#ifndef SAMPLE_FRAME_H
+#define SAMPLE_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SAMPLE_FRAME_SYNC0 0xA5u    ///< First sync byte.
+#define SAMPLE_FRAME_SYNC1 0x5Au    ///< Second sync byte.
+#define SAMPLE_FRAME_HEADER_LEN 8u  ///< Sync, type, channel, sequence and count.
+#define SAMPLE_FRAME_CRC_LEN 2u     ///< Trailing CRC-16.
+
+// Frame types
+#define SAMPLE_FRAME_TYPE_RAW12 0x01u      ///< Raw 12-bit ADC samples, packed two per three bytes.
+#define SAMPLE_FRAME_TYPE_SPECTRUM16 0x02u ///< Magnitude spectrum, one u16 per bin.
+#define SAMPLE_FRAME_TYPE_PEAKS 0x03u      ///< Spectral peaks, one (bin, magnitude) u16 pair each.
+#define SAMPLE_FRAME_TYPE_STATUS 0x04u     ///< Capture status counters, one u32 each.
+#define SAMPLE_FRAME_TYPE_RAW16 0x05u      ///< 16-bit samples, one u16 each.
+
+/** Bytes needed to pack n 12-bit samples. */
+#define SAMPLE_FRAME_PACKED12_LEN(n) (((n) * 3u + 1u) / 2u)
+
+/** Total frame size for n 12-bit samples; use it to size transmit buffers. */
+#define SAMPLE_FRAME_RAW12_LEN(n) (SAMPLE_FRAME_HEADER_LEN + SAMPLE_FRAME_PACKED12_LEN(n) + SAMPLE_FRAME_CRC_LEN)
+
+/** Total frame size for n 16-bit words (n RAW16 samples, n bins of a spectrum, or 2 * n for n peaks). */
+#define SAMPLE_FRAME_WORDS16_LEN(n) (SAMPLE_FRAME_HEADER_LEN + 2u * (n) + SAMPLE_FRAME_CRC_LEN)
+
+/** Total frame size for a status frame of n u32 fields. */
+#define SAMPLE_FRAME_STATUS_LEN(n) (SAMPLE_FRAME_HEADER_LEN + 4u * (n) + SAMPLE_FRAME_CRC_LEN)
+
+typedef struct sample_frame_header
+{
+    uint8_t type;    ///< Frame type.
+    uint8_t channel; ///< Source channel.
+    uint16_t seq;    ///< Sequence number.
+    uint16_t count;  ///< Number of elements in the payload.
+} sample_frame_header_t;
+
+typedef struct sample_frame_seq
+{
+    bool started;     ///< At least one frame has been seen.
+    uint16_t next;    ///< Sequence number expected next.
+    uint32_t dropped; ///< Total frames missing from the sequence so far.
+} sample_frame_seq_t;
+
+// Error codes returned by sample_frame_decode()
+#define SAMPLE_FRAME_ERR_SHORT -1 ///< Not enough bytes for a complete frame.
+#define SAMPLE_FRAME_ERR_SYNC -2  ///< Sync word not found at the start of the buffer.
+#define SAMPLE_FRAME_ERR_TYPE -3  ///< Unknown frame type.
+#define SAMPLE_FRAME_ERR_CRC -4   ///< CRC mismatch.
+#define SAMPLE_FRAME_ERR_SPACE -5 ///< Output sample buffer is too small.
+
+/**
+ * @brief Updates a CRC-16/CCITT-FALSE (poly 0x1021) with a block of bytes.
+ *
+ * @param crc Running CRC; start with 0xFFFF.
+ * @param data Bytes to add.
+ * @param len Number of bytes.
+ * @return uint16_t Updated CRC.
+ */
+uint16_t sample_frame_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Packs 12-bit samples two per three bytes.
+ *
+ * @param out Destination, at least SAMPLE_FRAME_PACKED12_LEN(count) bytes.
+ * @param samples Samples to pack; only the low 12 bits are used.
+ * @param count Number of samples.
+ * @return size_t Number of bytes written.
+ */
+size_t sample_frame_pack12(uint8_t *out, const uint16_t *samples, size_t count);
+
+/**
+ * @brief Unpacks 12-bit samples packed by sample_frame_pack12().
+ *
+ * @param samples Destination for count samples.
+ * @param in Packed bytes.
+ * @param count Number of samples.
+ */
+void sample_frame_unpack12(uint16_t *samples, const uint8_t *in, size_t count);
+
+/**
+ * @brief Builds a complete SAMPLE_FRAME_TYPE_RAW12 frame.
+ *
+ * @param out Destination buffer.
+ * @param out_size Size of the destination buffer.
+ * @param channel Channel to tag the frame with.
+ * @param seq Sequence number.
+ * @param samples Samples to send.
+ * @param count Number of samples.
+ * @return size_t Frame length in bytes, or 0 if out_size is too small.
+ */
+size_t sample_frame_encode12(uint8_t *out, size_t out_size, uint8_t channel, uint16_t seq,
+                             const uint16_t *samples, uint16_t count);
+
+/**
+ * @brief Builds a frame whose payload is little-endian 16-bit words.
+ *
+ * Used for SAMPLE_FRAME_TYPE_RAW16 (one word per sample), SAMPLE_FRAME_TYPE_SPECTRUM16 (one
+ * word per bin) and SAMPLE_FRAME_TYPE_PEAKS (two words per peak: bin, then magnitude).
+ *
+ * @param out Destination buffer.
+ * @param out_size Size of the destination buffer.
+ * @param type SAMPLE_FRAME_TYPE_RAW16, SAMPLE_FRAME_TYPE_SPECTRUM16 or SAMPLE_FRAME_TYPE_PEAKS.
+ * @param channel Channel to tag the frame with.
+ * @param seq Sequence number.
+ * @param words Payload words, count elements of the given type.
+ * @param count Number of elements (samples, bins or peaks).
+ * @return size_t Frame length in bytes, or 0 if out_size is too small or the type is not a word type.
+ */
+size_t sample_frame_encode16(uint8_t *out, size_t out_size, uint8_t type, uint8_t channel, uint16_t seq,
+                             const uint16_t *words, uint16_t count);
+
+/**
+ * @brief Builds a SAMPLE_FRAME_TYPE_STATUS frame of u32 fields.
+ *
+ * @param out Destination buffer.
+ * @param out_size Size of the destination buffer.
+ * @param channel Channel to tag the frame with.
+ * @param seq Sequence number.
+ * @param fields Status fields.
+ * @param count Number of fields.
+ * @return size_t Frame length in bytes, or 0 if out_size is too small.
+ */
+size_t sample_frame_encode_status(uint8_t *out, size_t out_size, uint8_t channel, uint16_t seq,
+                                  const uint32_t *fields, uint16_t count);
+
+/**
+ * @brief Decodes one frame that starts at the beginning of a buffer.
+ *
+ * RAW12 samples are unpacked to one value each; word-type payloads are copied as they are,
+ * so a PEAKS frame with count peaks fills 2 * count values, and a STATUS frame fills
+ * 2 * count values (low half of each field first).
+ *
+ * @param frame Received bytes, starting at the sync word.
+ * @param len Number of bytes available.
+ * @param hdr Output for the decoded header.
+ * @param samples Output for the decoded values.
+ * @param max_samples Capacity of the samples buffer, in values.
+ * @return int Frame length in bytes on success, or a negative SAMPLE_FRAME_ERR_* code.
+ */
+int sample_frame_decode(const uint8_t *frame, size_t len, sample_frame_header_t *hdr,
+                        uint16_t *samples, size_t max_samples);
+
+/**
+ * @brief Checks a received sequence number and counts the frames missing before it.
+ *
+ * @param tracker Sequence tracker, zero-initialized before the first frame.
+ * @param seq Sequence number of the frame just received.
+ * @return uint16_t Number of frames lost between the previous frame and this one.
+ */
+uint16_t sample_frame_track_seq(sample_frame_seq_t *tracker, uint16_t seq);
+
+#endif // SAMPLE_FRAME_H
@@ -0,0 +1,238 @@
+"""
+Decoder for the binary sample frames sent by the RP2040 acquisition projects.
+
+The frame layout is documented in sample_frame.h:
+
+    A5 5A | type | channel | seq (u16) | count (u16) | payload | crc16 (u16)
+
+All multi-byte fields are little-endian. The CRC is CRC-16/CCITT-FALSE over everything after
+the sync word. RAW12 payloads pack two 12-bit samples into three bytes; RAW16 payloads hold one
+u16 per oversampled sample (ADC code * 16 at full resolution); SPECTRUM16 payloads
+hold one u16 magnitude per bin and PEAKS payloads one (bin, magnitude) u16 pair per peak.
+STATUS payloads hold u32 capture counters, see STATUS_FIELDS.
+
+Usage:
+    from sample_frame import read_samples
+    data = read_samples(ser, 1024)   # ser is an open pyserial.Serial
+"""
+
+import struct
+import numpy as np
+
+SYNC = b'\xA5\x5A'
+HEADER_LEN = 8
+CRC_LEN = 2
+
+TYPE_RAW12 = 0x01
+TYPE_SPECTRUM16 = 0x02
+TYPE_PEAKS = 0x03
+TYPE_STATUS = 0x04
+TYPE_RAW16 = 0x05
+
+# Number of u16 words per element for the word-type frames.
+WORDS_PER_ELEMENT = {TYPE_RAW16: 1, TYPE_SPECTRUM16: 1, TYPE_PEAKS: 2, TYPE_STATUS: 2}
+
+# Field order of a STATUS frame, as written by capture_stats_to_fields() (libs/adc_capture).
+# Times are in microseconds and cover the reporting window since the previous status frame.
+STATUS_FIELDS = ('nominal_us', 'intervals', 'min_interval', 'max_interval', 'mean_interval',
+                 'max_jitter', 'mean_jitter', 'late', 'overruns')
+
+
+def crc16(data, crc=0xFFFF):
+    """
+    CRC-16/CCITT-FALSE (poly 0x1021), same as sample_frame_crc16() in C.
+    """
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def packed12_len(count):
+    """Bytes needed for count packed 12-bit samples."""
+    return (count * 3 + 1) // 2
+
+
+def pack12(samples):
+    """Packs 12-bit samples two per three bytes."""
+    samples = np.asarray(samples, dtype=np.uint16) & 0x0FFF
+    out = bytearray()
+    pairs = len(samples) // 2
+    for i in range(pairs):
+        a, b = int(samples[2 * i]), int(samples[2 * i + 1])
+        out += bytes((a & 0xFF, (a >> 8) | ((b & 0x0F) << 4), b >> 4))
+    if len(samples) & 1:
+        a = int(samples[-1])
+        out += bytes((a & 0xFF, a >> 8))
+    return bytes(out)
+
+
+def unpack12(payload, count):
+    """Unpacks count 12-bit samples packed by pack12()."""
+    raw = np.frombuffer(payload[:packed12_len(count)], dtype=np.uint8).astype(np.uint16)
+    pairs = count // 2
+    out = np.empty(count, dtype=np.uint16)
+    trip = raw[:pairs * 3].reshape(-1, 3)
+    out[0:pairs * 2:2] = trip[:, 0] | ((trip[:, 1] & 0x0F) << 8)
+    out[1:pairs * 2:2] = (trip[:, 1] >> 4) | (trip[:, 2] << 4)
+    if count & 1:
+        out[-1] = raw[pairs * 3] | ((raw[pairs * 3 + 1] & 0x0F) << 8)
+    return out
+
+
+def payload_len(frame_type, count):
+    """Payload length for a frame type, or None if the type is unknown."""
+    if frame_type == TYPE_RAW12:
+        return packed12_len(count)
+    if frame_type in WORDS_PER_ELEMENT:
+        return 2 * WORDS_PER_ELEMENT[frame_type] * count
+    return None
+
+
+def decode_payload(frame_type, payload, count):
+    """
+    Decodes a payload: RAW12 and RAW16 give count samples, SPECTRUM16 count magnitudes, PEAKS
+    a (count, 2) array of (bin, magnitude) rows and STATUS a dict keyed by STATUS_FIELDS.
+    """
+    if frame_type == TYPE_RAW12:
+        return unpack12(payload, count)
+    if frame_type == TYPE_STATUS:
+        values = np.frombuffer(payload, dtype='<u4').astype(np.uint32)
+        return dict(zip(STATUS_FIELDS, (int(v) for v in values)))
+    words = np.frombuffer(payload, dtype='<u2').astype(np.uint16)
+    if frame_type == TYPE_PEAKS:
+        return words.reshape(count, 2)
+    return words
+
+
+def encode12(samples, seq=0, channel=0):
+    """Builds a RAW12 frame, mainly for testing the decoder without hardware."""
+    body = struct.pack('<BBHH', TYPE_RAW12, channel, seq & 0xFFFF, len(samples)) + pack12(samples)
+    return SYNC + body + struct.pack('<H', crc16(body))
+
+
+def encode16(frame_type, words, count, seq=0, channel=0):
+    """Builds a RAW16, SPECTRUM16 or PEAKS frame from a flat list of u16 words."""
+    payload = np.asarray(words, dtype='<u2').tobytes()
+    body = struct.pack('<BBHH', frame_type, channel, seq & 0xFFFF, count) + payload
+    return SYNC + body + struct.pack('<H', crc16(body))
+
+
+class Frame:
+    """A decoded frame."""
+
+    def __init__(self, frame_type, channel, seq, data):
+        self.type = frame_type
+        self.channel = channel
+        self.seq = seq
+        self.data = data
+
+
+class FrameDecoder:
+    """
+    Incremental decoder. Feed it raw bytes as they arrive; it resynchronizes on the sync
+    word, drops frames with a bad CRC and counts frames missing from the sequence numbers.
+    """
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.next_seq = None
+        self.dropped = 0
+        self.crc_errors = 0
+
+    def feed(self, data):
+        """
+        Adds received bytes and returns the list of complete frames found so far.
+        """
+        self.buffer += data
+        frames = []
+
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                # Keep a trailing 0xA5 in case the sync word is split across reads.
+                del self.buffer[:max(len(self.buffer) - 1, 0)]
+                return frames
+            del self.buffer[:start]
+
+            if len(self.buffer) < HEADER_LEN:
+                return frames
+
+            frame_type, channel, seq, count = struct.unpack_from('<BBHH', self.buffer, 2)
+            plen = payload_len(frame_type, count)
+            if plen is None:
+                del self.buffer[:1]  # Not a real frame; look for the next sync word.
+                continue
+
+            total = HEADER_LEN + plen + CRC_LEN
+            if len(self.buffer) < total:
+                return frames
+
+            body = bytes(self.buffer[2:total - CRC_LEN])
+            (rx_crc,) = struct.unpack_from('<H', self.buffer, total - CRC_LEN)
+            if crc16(body) != rx_crc:
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+
+            payload = body[HEADER_LEN - 2:]
+            frames.append(Frame(frame_type, channel, seq, decode_payload(frame_type, payload, count)))
+            del self.buffer[:total]
+
+            if self.next_seq is not None:
+                self.dropped += (seq - self.next_seq) & 0xFFFF
+            self.next_seq = (seq + 1) & 0xFFFF
+
+
+def read_samples(ser, n_samples, frame_type=TYPE_RAW12, channel=None):
+    """
+    Reads frames from an open serial port until n_samples samples have been collected.
+
+    Args:
+        ser: An open pyserial.Serial instance.
+        n_samples (int): Number of samples to return.
+        frame_type (int): Only frames of this type are used.
+        channel (int): Only frames from this channel are used (None for any).
+    Returns:
+        np.ndarray: The samples, and prints a warning if frames were dropped.
+    """
+    decoder = FrameDecoder()
+    chunks = []
+    total = 0
+
+    while total < n_samples:
+        data = ser.read(max(ser.in_waiting, 1))
+        for frame in decoder.feed(data):
+            if frame.type != frame_type or (channel is not None and frame.channel != channel):
+                continue
+            chunks.append(frame.data)
+            total += len(frame.data)
+
+    if decoder.dropped:
+        print(f"Warning: {decoder.dropped} frames dropped, the record has gaps")
+    if decoder.crc_errors:
+        print(f"Warning: {decoder.crc_errors} frames discarded with a bad CRC")
+
+    return np.concatenate(chunks)[:n_samples]
+
+
+def read_frame(ser, frame_type, channel=None):
+    """
+    Reads frames from an open serial port until one of the given type arrives.
+
+    Args:
+        ser: An open pyserial.Serial instance.
+        frame_type (int): Frame type wanted, e.g. TYPE_SPECTRUM16 or TYPE_PEAKS.
+        channel (int): Only frames from this channel are used (None for any).
+    Returns:
+        Frame: The first matching frame.
+    """
+    decoder = FrameDecoder()
+
+    while True:
+        data = ser.read(max(ser.in_waiting, 1))
+        for frame in decoder.feed(data):
+            if frame.type == frame_type and (channel is None or frame.channel == channel):
+                return frame
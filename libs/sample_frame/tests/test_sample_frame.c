@@ -0,0 +1,429 @@
+/**
+ * @file test_sample_frame.c
+ * @brief CRC, 12-bit packing, frame round trips, decoder errors and sequence tracking, and a
+ * stream for the Python decoder.
+ *
+ * @details
+ * The CRC is checked against the CRC-16/CCITT-FALSE check value, and pack12/unpack12 against
+ * the documented byte layout and on random blocks of every length up to 67, odd ones
+ * included. Every frame type is encoded and decoded back with random contents, and each
+ * decoder error is provoked: short buffers, a truncated frame at every length, bad sync,
+ * unknown types, every single-bit error and a sample buffer one value too small.
+ *
+ * Frames of every type are then written into one stream with sequence gaps, boot text,
+ * junk, false syncs and a frame with a bad CRC, and decoded from the start as
+ * FrameDecoder in sample_frame.py does it. With a path argument, the stream and the
+ * expected listing are written to <path>.bin and <path>.txt, which tests/test_sample_frame.py
+ * replays through the Python decoder.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "sample_frame.h"
+
+#define MAX_COUNT 67u
+#define STATUS_COUNT 9u ///< Fields of a capture status frame (STATUS_FIELDS in sample_frame.py).
+#define STREAM_CAP 16384u
+
+static uint8_t stream[STREAM_CAP];
+static size_t stream_len;
+
+static uint8_t frame[SAMPLE_FRAME_STATUS_LEN(MAX_COUNT)];
+static uint16_t values[2u * MAX_COUNT];
+static uint16_t decoded[2u * MAX_COUNT + 1u];
+
+/**
+ * @brief Appends bytes to the stream.
+ */
+static void put(const uint8_t *data, size_t len)
+{
+    CHECK(stream_len + len <= STREAM_CAP);
+    if (stream_len + len <= STREAM_CAP)
+    {
+        memcpy(stream + stream_len, data, len);
+        stream_len += len;
+    }
+}
+
+static void test_crc(void)
+{
+    const uint8_t check[] = "123456789";
+    CHECK_EQ(sample_frame_crc16(0xFFFF, check, 9), 0x29B1);
+    CHECK_EQ(sample_frame_crc16(0xFFFF, check, 0), 0xFFFF);
+
+    // Feeding the bytes in pieces gives the same CRC
+    for (size_t split = 0; split <= 9; split++)
+    {
+        CHECK_EQ(sample_frame_crc16(sample_frame_crc16(0xFFFF, check, split), check + split, 9 - split), 0x29B1);
+    }
+}
+
+static void test_pack12(void)
+{
+    // b0 = a[7:0], b1 = a[11:8] | b[3:0] << 4, b2 = b[11:4]; an odd sample takes two bytes
+    const uint16_t pair[3] = {0xABC, 0x123, 0x456};
+    uint8_t packed[SAMPLE_FRAME_PACKED12_LEN(3u) + 1u];
+    memset(packed, 0xEE, sizeof(packed));
+    CHECK_EQ(sample_frame_pack12(packed, pair, 3), 5);
+    CHECK_EQ(packed[0], 0xBC);
+    CHECK_EQ(packed[1], 0x3A);
+    CHECK_EQ(packed[2], 0x12);
+    CHECK_EQ(packed[3], 0x56);
+    CHECK_EQ(packed[4], 0x04);
+    CHECK_EQ(packed[5], 0xEE);
+
+    for (size_t count = 0; count <= MAX_COUNT; count++)
+    {
+        uint16_t samples[MAX_COUNT];
+        uint16_t back[MAX_COUNT + 1u];
+        uint8_t bytes[SAMPLE_FRAME_PACKED12_LEN(MAX_COUNT) + 1u];
+        for (size_t i = 0; i < count; i++)
+        {
+            samples[i] = (uint16_t)rand(); // Bits above 11 must be dropped
+        }
+        memset(bytes, 0xEE, sizeof(bytes));
+        back[count] = 0xBEEF;
+
+        size_t len = sample_frame_pack12(bytes, samples, count);
+        CHECK_EQ(len, SAMPLE_FRAME_PACKED12_LEN(count));
+        CHECK_EQ(bytes[len], 0xEE);
+        sample_frame_unpack12(back, bytes, count);
+        for (size_t i = 0; i < count; i++)
+        {
+            CHECK_EQ(back[i], samples[i] & 0x0FFF);
+        }
+        CHECK_EQ(back[count], 0xBEEF);
+    }
+}
+
+/**
+ * @brief Encodes one frame with random contents.
+ *
+ * @param type Frame type.
+ * @param count Number of elements.
+ * @param fields Output for the STATUS fields.
+ * @return size_t Frame length, with the values the decoder must give back in values[].
+ */
+static size_t random_frame(uint8_t type, uint8_t channel, uint16_t seq, uint16_t count, uint32_t *fields)
+{
+    size_t n_values = (type == SAMPLE_FRAME_TYPE_PEAKS || type == SAMPLE_FRAME_TYPE_STATUS) ? 2u * count : count;
+    for (size_t i = 0; i < n_values; i++)
+    {
+        values[i] = (uint16_t)rand();
+    }
+
+    switch (type)
+    {
+    case SAMPLE_FRAME_TYPE_RAW12:
+        for (size_t i = 0; i < count; i++)
+        {
+            values[i] &= 0x0FFF;
+        }
+        return sample_frame_encode12(frame, sizeof(frame), channel, seq, values, count);
+    case SAMPLE_FRAME_TYPE_STATUS:
+        for (size_t i = 0; i < count; i++)
+        {
+            fields[i] = values[2 * i] | ((uint32_t)values[2 * i + 1] << 16);
+        }
+        return sample_frame_encode_status(frame, sizeof(frame), channel, seq, fields, count);
+    default:
+        return sample_frame_encode16(frame, sizeof(frame), type, channel, seq, values, count);
+    }
+}
+
+/**
+ * @brief Expected frame length and number of decoded values for a type and count.
+ */
+static size_t frame_len(uint8_t type, uint16_t count, size_t *n_values)
+{
+    switch (type)
+    {
+    case SAMPLE_FRAME_TYPE_RAW12:
+        *n_values = count;
+        return SAMPLE_FRAME_RAW12_LEN((size_t)count);
+    case SAMPLE_FRAME_TYPE_PEAKS:
+        *n_values = 2u * count;
+        return SAMPLE_FRAME_WORDS16_LEN(2u * count);
+    case SAMPLE_FRAME_TYPE_STATUS:
+        *n_values = 2u * count;
+        return SAMPLE_FRAME_STATUS_LEN((size_t)count);
+    default:
+        *n_values = count;
+        return SAMPLE_FRAME_WORDS16_LEN((size_t)count);
+    }
+}
+
+static void test_roundtrip(void)
+{
+    static const uint8_t types[] = {SAMPLE_FRAME_TYPE_RAW12, SAMPLE_FRAME_TYPE_SPECTRUM16, SAMPLE_FRAME_TYPE_PEAKS,
+                                    SAMPLE_FRAME_TYPE_STATUS, SAMPLE_FRAME_TYPE_RAW16};
+    uint32_t fields[MAX_COUNT];
+
+    for (size_t t = 0; t < sizeof(types); t++)
+    {
+        for (uint16_t count = 0; count <= MAX_COUNT; count++)
+        {
+            uint8_t channel = (uint8_t)rand();
+            uint16_t seq = (uint16_t)rand();
+            size_t n_values;
+            size_t expected = frame_len(types[t], count, &n_values);
+            size_t len = random_frame(types[t], channel, seq, count, fields);
+            CHECK_EQ(len, expected);
+
+            sample_frame_header_t hdr;
+            memset(decoded, 0xEE, sizeof(decoded));
+            CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, n_values), (int)len);
+            CHECK_EQ(hdr.type, types[t]);
+            CHECK_EQ(hdr.channel, channel);
+            CHECK_EQ(hdr.seq, seq);
+            CHECK_EQ(hdr.count, count);
+            CHECK(memcmp(decoded, values, n_values * sizeof(uint16_t)) == 0);
+            CHECK_EQ(decoded[n_values], 0xEEEE);
+
+            // Extra bytes after the frame are not part of it
+            CHECK_EQ(sample_frame_decode(frame, sizeof(frame), &hdr, decoded, n_values), (int)len);
+
+            if (n_values > 0)
+            {
+                CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, n_values - 1u), SAMPLE_FRAME_ERR_SPACE);
+            }
+        }
+    }
+
+    // The encoders refuse a buffer one byte short, and sample_frame_encode16() a non-word type
+    uint16_t words[4] = {1, 2, 3, 4};
+    uint32_t status[2] = {5, 6};
+    CHECK_EQ(sample_frame_encode12(frame, SAMPLE_FRAME_RAW12_LEN(3u) - 1u, 0, 0, words, 3), 0);
+    CHECK_EQ(sample_frame_encode16(frame, SAMPLE_FRAME_WORDS16_LEN(4u) - 1u, SAMPLE_FRAME_TYPE_RAW16, 0, 0, words, 4),
+             0);
+    CHECK_EQ(sample_frame_encode16(frame, SAMPLE_FRAME_WORDS16_LEN(4u) - 1u, SAMPLE_FRAME_TYPE_PEAKS, 0, 0, words, 2),
+             0);
+    CHECK_EQ(sample_frame_encode_status(frame, SAMPLE_FRAME_STATUS_LEN(2u) - 1u, 0, 0, status, 2), 0);
+    CHECK_EQ(sample_frame_encode16(frame, sizeof(frame), SAMPLE_FRAME_TYPE_RAW12, 0, 0, words, 4), 0);
+    CHECK_EQ(sample_frame_encode16(frame, sizeof(frame), 0x07, 0, 0, words, 4), 0);
+}
+
+static void test_errors(void)
+{
+    sample_frame_header_t hdr;
+    uint32_t fields[STATUS_COUNT];
+    size_t len = random_frame(SAMPLE_FRAME_TYPE_RAW12, 1, 100, 31, fields);
+
+    // Every truncation is short, whether or not the header is complete
+    for (size_t n = 0; n < len; n++)
+    {
+        CHECK_EQ(sample_frame_decode(frame, n, &hdr, decoded, MAX_COUNT), SAMPLE_FRAME_ERR_SHORT);
+    }
+
+    frame[0] ^= 0x01;
+    CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, MAX_COUNT), SAMPLE_FRAME_ERR_SYNC);
+    frame[0] ^= 0x01;
+    frame[1] = SAMPLE_FRAME_SYNC0;
+    CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, MAX_COUNT), SAMPLE_FRAME_ERR_SYNC);
+    frame[1] = SAMPLE_FRAME_SYNC1;
+
+    // Unknown types are refused before the length or the CRC is looked at
+    static const uint8_t unknown[] = {0x00, 0x06, 0x07, 0x5A, 0xA5, 0xFF};
+    for (size_t i = 0; i < sizeof(unknown); i++)
+    {
+        frame[2] = unknown[i];
+        CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, MAX_COUNT), SAMPLE_FRAME_ERR_TYPE);
+    }
+    frame[2] = SAMPLE_FRAME_TYPE_RAW12;
+    CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, MAX_COUNT), (int)len);
+
+    // A single-bit error after the sync word never decodes. In the channel, sequence,
+    // payload and CRC it is a CRC error; in the type or count it may also change the
+    // length or the type.
+    for (size_t bit = 16; bit < 8u * len; bit++)
+    {
+        frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        int r = sample_frame_decode(frame, len, &hdr, decoded, 2u * MAX_COUNT);
+        if (bit / 8 == 2 || bit / 8 == 6 || bit / 8 == 7)
+        {
+            CHECK(r < 0);
+        }
+        else
+        {
+            CHECK_EQ(r, SAMPLE_FRAME_ERR_CRC);
+        }
+        frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    CHECK_EQ(sample_frame_decode(frame, len, &hdr, decoded, MAX_COUNT), (int)len);
+}
+
+static void test_track_seq(void)
+{
+    sample_frame_seq_t t;
+    memset(&t, 0, sizeof(t));
+
+    // The first frame sets the sequence, whatever its number
+    CHECK_EQ(sample_frame_track_seq(&t, 500), 0);
+    CHECK_EQ(sample_frame_track_seq(&t, 501), 0);
+    CHECK_EQ(t.dropped, 0);
+
+    CHECK_EQ(sample_frame_track_seq(&t, 505), 3);
+    CHECK_EQ(t.dropped, 3);
+
+    // Across the 16-bit wrap
+    memset(&t, 0, sizeof(t));
+    CHECK_EQ(sample_frame_track_seq(&t, 0xFFFE), 0);
+    CHECK_EQ(sample_frame_track_seq(&t, 0xFFFF), 0);
+    CHECK_EQ(sample_frame_track_seq(&t, 0x0000), 0);
+    CHECK_EQ(sample_frame_track_seq(&t, 0x0002), 1);
+    CHECK_EQ(t.dropped, 1);
+
+    // A sender that restarts from 0, or a repeated frame, looks like a gap of nearly 65536:
+    // the count is the distance forward, as in sample_frame.py
+    memset(&t, 0, sizeof(t));
+    sample_frame_track_seq(&t, 1000);
+    CHECK_EQ(sample_frame_track_seq(&t, 0), 65535u - 1000u);
+    CHECK_EQ(sample_frame_track_seq(&t, 0), 65535);
+    CHECK_EQ(t.dropped, 65535u - 1000u + 65535u);
+    CHECK_EQ(sample_frame_track_seq(&t, 1), 0);
+}
+
+/**
+ * @brief Writes frames of every type into the stream, between boot text and junk.
+ */
+static void build_stream(void)
+{
+    static const uint8_t types[] = {SAMPLE_FRAME_TYPE_RAW12, SAMPLE_FRAME_TYPE_RAW16, SAMPLE_FRAME_TYPE_SPECTRUM16,
+                                    SAMPLE_FRAME_TYPE_PEAKS, SAMPLE_FRAME_TYPE_STATUS};
+    static const char boot[] = "boot: sample_frame test stream\r\n";
+    const uint8_t false_sync[] = {SAMPLE_FRAME_SYNC0, SAMPLE_FRAME_SYNC1, 0x09, 0x00, SAMPLE_FRAME_SYNC0};
+    uint32_t fields[STATUS_COUNT];
+    uint16_t seq = 0xFFF0; // Crosses the 16-bit wrap
+
+    put((const uint8_t *)boot, sizeof(boot) - 1u);
+    for (uint32_t k = 0; k < 30u; k++)
+    {
+        uint8_t type = types[k % sizeof(types)];
+        uint16_t count = (type == SAMPLE_FRAME_TYPE_STATUS) ? STATUS_COUNT : (uint16_t)(rand() % MAX_COUNT);
+        size_t len = random_frame(type, (uint8_t)(k % 3u), seq, count, fields);
+
+        if (k == 11u)
+        {
+            frame[len / 2] ^= 0x10; // Bad CRC
+        }
+        put(frame, len);
+
+        if (k % 7u == 3u)
+        {
+            put(false_sync, sizeof(false_sync));
+        }
+        if (k % 5u == 2u)
+        {
+            uint8_t junk[3] = {(uint8_t)rand(), SAMPLE_FRAME_SYNC0, (uint8_t)rand()};
+            put(junk, sizeof(junk));
+        }
+        seq = (uint16_t)(seq + 1u + (k % 9u == 4u ? 2u : 0u)); // Some frames are missing
+    }
+}
+
+/**
+ * @brief Decodes the stream from the start as FrameDecoder does, and writes the listing the
+ * Python decoder must reproduce: one line per frame, then the counters.
+ */
+static void decode_stream(FILE *listing)
+{
+    sample_frame_seq_t tracker;
+    memset(&tracker, 0, sizeof(tracker));
+    uint32_t frames = 0, crc_errors = 0;
+    size_t pos = 0;
+
+    while (pos + 1u < stream_len)
+    {
+        if (stream[pos] != SAMPLE_FRAME_SYNC0 || stream[pos + 1u] != SAMPLE_FRAME_SYNC1)
+        {
+            pos++;
+            continue;
+        }
+
+        sample_frame_header_t hdr;
+        int r = sample_frame_decode(stream + pos, stream_len - pos, &hdr, decoded, 2u * MAX_COUNT);
+        if (r == SAMPLE_FRAME_ERR_SHORT)
+        {
+            break;
+        }
+        if (r < 0)
+        {
+            crc_errors += r == SAMPLE_FRAME_ERR_CRC;
+            pos++;
+            continue;
+        }
+
+        if (listing)
+        {
+            fprintf(listing, "%u %u %u", hdr.type, hdr.channel, hdr.seq);
+            if (hdr.type == SAMPLE_FRAME_TYPE_STATUS)
+            {
+                for (size_t i = 0; i < hdr.count; i++)
+                {
+                    fprintf(listing, " %lu", (unsigned long)(decoded[2 * i] | ((uint32_t)decoded[2 * i + 1] << 16)));
+                }
+            }
+            else
+            {
+                size_t n = (hdr.type == SAMPLE_FRAME_TYPE_PEAKS) ? 2u * hdr.count : hdr.count;
+                for (size_t i = 0; i < n; i++)
+                {
+                    fprintf(listing, " %u", decoded[i]);
+                }
+            }
+            fprintf(listing, "\n");
+        }
+        sample_frame_track_seq(&tracker, hdr.seq);
+        frames++;
+        pos += (size_t)r;
+    }
+
+    // 30 frames less the corrupted one; three gaps of two, and the corrupted frame
+    CHECK_EQ(frames, 29);
+    CHECK_EQ(crc_errors, 1);
+    CHECK_EQ(tracker.dropped, 3u * 2u + 1u);
+    CHECK_EQ(pos, stream_len);
+    if (listing)
+    {
+        fprintf(listing, "frames=%u crc_errors=%u dropped=%lu\n", frames, crc_errors,
+                (unsigned long)tracker.dropped);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    srand(2);
+
+    test_crc();
+    test_pack12();
+    test_roundtrip();
+    test_errors();
+    test_track_seq();
+
+    build_stream();
+    FILE *listing = NULL;
+    if (argc > 1)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s.bin", argv[1]);
+        FILE *bin = fopen(path, "wb");
+        CHECK(bin != NULL);
+        if (bin)
+        {
+            CHECK_EQ(fwrite(stream, 1, stream_len, bin), stream_len);
+            fclose(bin);
+        }
+        snprintf(path, sizeof(path), "%s.txt", argv[1]);
+        listing = fopen(path, "w");
+        CHECK(listing != NULL);
+    }
+    decode_stream(listing);
+    if (listing)
+    {
+        fclose(listing);
+    }
+
+    return host_test_result("sample_frame");
+}
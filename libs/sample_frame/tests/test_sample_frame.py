@@ -0,0 +1,96 @@
+"""
+@brief Replays the stream written by tests/test_sample_frame.c through sample_frame.py.
+
+The C test writes <prefix>.bin, a byte stream of frames of every type with sequence gaps,
+boot text, junk, false syncs and a frame with a bad CRC, and <prefix>.txt, the frames and
+counters the C decoder got from it. FrameDecoder must produce the same listing whatever the
+size of the chunks it is fed, and encode12() and encode16() must give back the bytes the C
+encoder wrote. The CRC check value and pack12()/unpack12() are checked as well.
+
+sample_frame.py needs numpy; without it the test is skipped (exit status 77).
+
+Usage: python test_sample_frame.py <prefix>
+"""
+
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+try:
+    import sample_frame as sf  # noqa: E402
+except ImportError as e:
+    print(f"test_sample_frame.py: skipped, {e}")
+    sys.exit(77)
+
+checks = 0
+failures = 0
+
+def check(cond, what):
+    """@brief Counts a check and reports it on stderr if it failed."""
+    global checks, failures
+    checks += 1
+    if not cond:
+        failures += 1
+        print(f"test_sample_frame.py: {what} failed", file=sys.stderr)
+
+def listing(frames, decoder):
+    """@brief The frames and counters in the format of the C listing."""
+    lines = []
+    for f in frames:
+        if f.type == sf.TYPE_STATUS:
+            values = list(f.data.values())
+        else:
+            values = [int(v) for v in f.data.reshape(-1)]
+        lines.append(" ".join(str(v) for v in [f.type, f.channel, f.seq] + values))
+    lines.append(f"frames={len(frames)} crc_errors={decoder.crc_errors} dropped={decoder.dropped}")
+    return lines
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: python test_sample_frame.py <prefix>")
+        return 2
+    with open(sys.argv[1] + ".bin", "rb") as f:
+        data = f.read()
+    with open(sys.argv[1] + ".txt") as f:
+        expected = f.read().splitlines()
+    check(len(expected) == 30, "listing length")
+
+    check(sf.crc16(b"123456789") == 0x29B1, "CRC check value")
+    rng = random.Random(2)
+    for count in range(68):
+        samples = [rng.randrange(4096) for _ in range(count)]
+        packed = sf.pack12(samples)
+        check(len(packed) == sf.packed12_len(count), f"packed length of {count}")
+        check([int(v) for v in sf.unpack12(packed, count)] == samples, f"pack12 round trip of {count}")
+
+    for chunk in (1, 2, 7, 64, 1000, len(data)):
+        decoder = sf.FrameDecoder()
+        frames = []
+        for i in range(0, len(data), chunk):
+            frames.extend(decoder.feed(data[i:i + chunk]))
+        got = listing(frames, decoder)
+        check(got == expected, f"listing in chunks of {chunk}")
+        if got != expected:
+            for i, (a, b) in enumerate(zip(got, expected)):
+                if a != b:
+                    print(f"  line {i}: {a[:80]!r} != {b[:80]!r}", file=sys.stderr)
+                    break
+        check(len(decoder.buffer) == 0, f"nothing left over in chunks of {chunk}")
+
+    # The Python encoders write the same bytes as the C ones
+    for f in frames:
+        if f.type == sf.TYPE_RAW12:
+            encoded = sf.encode12(f.data, seq=f.seq, channel=f.channel)
+        elif f.type == sf.TYPE_STATUS:
+            continue
+        else:
+            encoded = sf.encode16(f.type, f.data.reshape(-1), len(f.data), seq=f.seq, channel=f.channel)
+        check(encoded in data, f"re-encoding frame {f.seq} of type {f.type}")
+
+    print(f"sample_frame.py: {checks} checks, {failures} failed")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,258 @@
+/**
+ * @file scope_trigger.c
+ * @brief Oscilloscope-style triggered capture over a continuous sample stream.
+ */
+
+#include "scope_trigger.h"
+
+#include <string.h>
+
+#define SCOPE_SCAN_BITS 32u ///< Samples whose condition is tested at once.
+
+bool scope_trigger_init(scope_trigger_t *s, const scope_trigger_config_t *cfg, uint16_t *storage,
+                        uint32_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1u)) != 0 || cfg->post == 0 ||
+        cfg->pre > capacity || cfg->post > capacity - cfg->pre)
+    {
+        return false;
+    }
+
+    s->cfg = *cfg;
+    switch (cfg->type)
+    {
+    case SCOPE_TRIGGER_RISING:
+        // With level 0 the range is empty: the condition is always true and never changes.
+        s->range_low = 0;
+        s->range_high = (int32_t)cfg->level - 1;
+        break;
+    case SCOPE_TRIGGER_FALLING:
+        s->range_low = cfg->level;
+        s->range_high = 0xFFFF;
+        break;
+    case SCOPE_TRIGGER_WINDOW:
+    default:
+        s->range_low = cfg->low;
+        s->range_high = cfg->high;
+        break;
+    }
+
+    s->data = storage;
+    s->mask = capacity - 1u;
+    s->written = 0;
+    s->valid = 0;
+    s->state = SCOPE_STOPPED;
+    s->last_cond = 1; // No 0 -> 1 change before a sample with a false condition is seen
+    s->waited = 0;
+    s->trigger_at = 0;
+    s->forced = false;
+    s->windows = 0;
+    s->forced_windows = 0;
+    return true;
+}
+
+void scope_trigger_arm(scope_trigger_t *s)
+{
+    s->state = SCOPE_ARMED;
+    s->waited = 0;
+    s->forced = false;
+}
+
+void scope_trigger_flush(scope_trigger_t *s)
+{
+    s->valid = 0;
+    s->last_cond = 1;
+    s->waited = 0;
+    if (s->state == SCOPE_TRIGGERED)
+    {
+        s->state = SCOPE_ARMED;
+        s->forced = false;
+    }
+}
+
+uint32_t scope_trigger_condition(const uint16_t *x, uint32_t n, int32_t low, int32_t high)
+{
+    uint32_t cond = 0;
+
+    // (x - low) | (high - x) is negative exactly when x < low or x > high.
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t v = x[i];
+        cond |= ((uint32_t)((v - low) | (high - v)) >> 31) << i;
+    }
+    return cond;
+}
+
+/**
+ * @brief Appends samples to the history.
+ *
+ * @param s Pointer to the scope.
+ * @param x Samples.
+ * @param n Number of samples, at most the capacity.
+ */
+static void history_write(scope_trigger_t *s, const uint16_t *x, uint32_t n)
+{
+    uint32_t capacity = s->mask + 1u;
+    uint32_t at = s->written & s->mask;
+    uint32_t first = capacity - at;
+
+    if (first > n)
+    {
+        first = n;
+    }
+    memcpy(&s->data[at], x, first * sizeof(uint16_t));
+    memcpy(&s->data[0], x + first, (n - first) * sizeof(uint16_t));
+
+    s->written += n;
+    s->valid = (s->valid + n > capacity) ? capacity : s->valid + n;
+}
+
+/**
+ * @brief Condition of a single sample (0 or 1).
+ */
+static inline uint32_t sample_condition(const scope_trigger_t *s, uint16_t x)
+{
+    return scope_trigger_condition(&x, 1, s->range_low, s->range_high);
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero mask.
+ *
+ * Only called once per trigger, so a plain loop is enough (the M0+ has no CTZ instruction).
+ */
+static uint32_t lowest_bit(uint32_t m)
+{
+    uint32_t i = 0;
+    while ((m & 1u) == 0)
+    {
+        m >>= 1;
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Scans up to 32 samples of an armed scope for the trigger.
+ *
+ * @param s Pointer to the scope.
+ * @param x Samples.
+ * @param n Number of samples, 1 to 32.
+ * @return uint32_t Offset of the trigger sample in x, or n if the trigger did not fire.
+ */
+static uint32_t scan_armed(scope_trigger_t *s, const uint16_t *x, uint32_t n)
+{
+    uint32_t cond = scope_trigger_condition(x, n, s->range_low, s->range_high);
+    uint32_t prev = (cond << 1) | s->last_cond; // Bit i: condition of the sample before x[i]
+    uint32_t edges = cond & ~prev;
+    s->last_cond = (cond >> (n - 1u)) & 1u;
+
+    // A trigger needs pre contiguous samples before it, and x[i] has valid + i of them.
+    uint32_t skip = (s->valid >= s->cfg.pre) ? 0 : s->cfg.pre - s->valid;
+    if (skip >= n)
+    {
+        return n;
+    }
+    edges &= ~0u << skip;
+
+    uint32_t at = (edges != 0) ? lowest_bit(edges) : n;
+    uint32_t eligible = n - skip;
+
+    if (s->cfg.mode == SCOPE_MODE_AUTO)
+    {
+        uint32_t left = (s->waited < s->cfg.auto_timeout) ? s->cfg.auto_timeout - s->waited : 0;
+        if (left < eligible && skip + left < at)
+        {
+            s->forced = true;
+            return skip + left;
+        }
+    }
+    if (at == n)
+    {
+        s->waited += eligible;
+    }
+    return at;
+}
+
+size_t scope_trigger_process(scope_trigger_t *s, const uint16_t *x, size_t n)
+{
+    size_t done = 0;
+
+    while (done < n && s->state != SCOPE_READY)
+    {
+        const uint16_t *p = x + done;
+        uint32_t len = (n - done > s->mask + 1u) ? s->mask + 1u : (uint32_t)(n - done);
+
+        if (s->state == SCOPE_ARMED)
+        {
+            if (len > SCOPE_SCAN_BITS)
+            {
+                len = SCOPE_SCAN_BITS;
+            }
+            uint32_t at = scan_armed(s, p, len);
+            if (at < len)
+            {
+                // Store up to the trigger; the triggered state takes it from there.
+                history_write(s, p, at);
+                done += at;
+                s->trigger_at = s->written;
+                s->waited = 0;
+                s->state = SCOPE_TRIGGERED;
+                continue;
+            }
+            history_write(s, p, len);
+        }
+        else if (s->state == SCOPE_TRIGGERED)
+        {
+            uint32_t left = s->trigger_at + s->cfg.post - s->written;
+            if (len > left)
+            {
+                len = left;
+            }
+            history_write(s, p, len);
+            s->last_cond = sample_condition(s, p[len - 1u]);
+            if (s->written == s->trigger_at + s->cfg.post)
+            {
+                s->state = SCOPE_READY;
+                s->windows++;
+                if (s->forced)
+                {
+                    s->forced_windows++;
+                }
+            }
+        }
+        else
+        {
+            history_write(s, p, len);
+            s->last_cond = sample_condition(s, p[len - 1u]);
+        }
+        done += len;
+    }
+    return done;
+}
+
+size_t scope_trigger_read(scope_trigger_t *s, uint16_t *out, bool *forced)
+{
+    if (s->state != SCOPE_READY)
+    {
+        return 0;
+    }
+
+    uint32_t len = scope_trigger_window_len(s);
+    if (out != NULL)
+    {
+        uint32_t start = s->trigger_at - s->cfg.pre;
+        for (uint32_t i = 0; i < len; i++)
+        {
+            out[i] = s->data[(start + i) & s->mask];
+        }
+    }
+    if (forced != NULL)
+    {
+        *forced = s->forced;
+    }
+
+    s->forced = false;
+    s->waited = 0;
+    s->state = (s->cfg.mode == SCOPE_MODE_SINGLE) ? SCOPE_STOPPED : SCOPE_ARMED;
+    return len;
+}
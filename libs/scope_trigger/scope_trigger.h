@@ -0,0 +1,184 @@
+/**
+ * @file scope_trigger.h
+ * @brief Oscilloscope-style triggered capture over a continuous sample stream.
+ *
+ * @details
+ * Blocks of samples are fed to scope_trigger_process() as they arrive. They go into a circular
+ * history buffer, and while the scope is armed the detector looks for the trigger event. Once
+ * it fires and `post` more samples have arrived, a window of `pre + post` samples is ready:
+ * `pre` samples from before the trigger, the trigger sample at index `pre`, and the rest after
+ * it. Only these windows need to be sent to the host.
+ *
+ * Every trigger type is the same test on a per-sample condition, which is true when the sample
+ * is outside a range `[low, high]`. The trigger is a 0 -> 1 change of the condition:
+ *
+ * | Type                     | Range               | Fires when                              |
+ * |--------------------------|---------------------|-----------------------------------------|
+ * | SCOPE_TRIGGER_RISING     | `[0, level - 1]`    | the signal goes from below level to at or above it |
+ * | SCOPE_TRIGGER_FALLING    | `[level, 0xFFFF]`   | the signal goes from at or above level to below it |
+ * | SCOPE_TRIGGER_WINDOW     | `[low, high]`       | the signal leaves the window            |
+ *
+ * The detector builds the condition of 32 samples at a time into a bit mask with sign-bit
+ * arithmetic, then finds the transitions with two shifts and a mask. There is one branch per
+ * 32 samples, not one per sample, and the position of the first transition is only worked out
+ * once the trigger fires. The condition of the last sample of a block is carried into the next,
+ * so an edge split across blocks, or across the end of the history buffer, is found like any
+ * other.
+ *
+ * A trigger is only accepted once at least `pre` contiguous samples precede it, so every window
+ * is complete. scope_trigger_flush() forgets the history after a gap in the stream.
+ *
+ * Modes:
+ * - SCOPE_MODE_SINGLE: captures one window, then stops until scope_trigger_arm().
+ * - SCOPE_MODE_NORMAL: re-arms after every window is read; nothing is captured without a trigger.
+ * - SCOPE_MODE_AUTO: as normal, but if no trigger comes within `auto_timeout` samples of being
+ *   ready for one, a window is captured anyway and flagged as forced, so a flat or out-of-range
+ *   signal is still shown.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SCOPE_TRIGGER_H
+#define SCOPE_TRIGGER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef enum scope_trigger_type
+{
+    SCOPE_TRIGGER_RISING = 0, ///< Signal crosses level going up.
+    SCOPE_TRIGGER_FALLING,    ///< Signal crosses level going down.
+    SCOPE_TRIGGER_WINDOW,     ///< Signal leaves [low, high].
+} scope_trigger_type_t;
+
+typedef enum scope_mode
+{
+    SCOPE_MODE_SINGLE = 0, ///< One window, then stop.
+    SCOPE_MODE_NORMAL,     ///< A window per trigger.
+    SCOPE_MODE_AUTO,       ///< A window per trigger, or a forced one after auto_timeout samples.
+} scope_mode_t;
+
+typedef enum scope_state
+{
+    SCOPE_STOPPED = 0, ///< Not looking for a trigger; samples still go into the history.
+    SCOPE_ARMED,       ///< Looking for a trigger.
+    SCOPE_TRIGGERED,   ///< Trigger found, collecting the post-trigger samples.
+    SCOPE_READY,       ///< A window is complete and waits for scope_trigger_read().
+} scope_state_t;
+
+typedef struct scope_trigger_config
+{
+    scope_trigger_type_t type; ///< Trigger type.
+    scope_mode_t mode;         ///< Capture mode.
+    uint16_t level;            ///< Level of the edge triggers.
+    uint16_t low;              ///< Lower bound of the window trigger.
+    uint16_t high;             ///< Upper bound of the window trigger.
+    uint32_t pre;              ///< Samples kept from before the trigger.
+    uint32_t post;             ///< Samples from the trigger on (at least 1).
+    uint32_t auto_timeout;     ///< Samples to wait for a trigger in SCOPE_MODE_AUTO.
+} scope_trigger_config_t;
+
+typedef struct scope_trigger
+{
+    scope_trigger_config_t cfg; ///< Configuration.
+    int32_t range_low;          ///< The condition is false from range_low ...
+    int32_t range_high;         ///< ... up to range_high.
+    uint16_t *data;             ///< History storage.
+    uint32_t mask;              ///< Capacity - 1 (capacity is a power of two).
+    uint32_t written;           ///< Samples written since init.
+    uint32_t valid;             ///< Contiguous samples in the history, up to the capacity.
+    scope_state_t state;        ///< Current state.
+    uint32_t last_cond;         ///< Condition of the last sample written (0 or 1).
+    uint32_t waited;            ///< Samples scanned without a trigger since being ready for one.
+    uint32_t trigger_at;        ///< Sample number of the trigger.
+    bool forced;                ///< The window was captured by the auto timeout.
+    uint32_t windows;           ///< Windows captured.
+    uint32_t forced_windows;    ///< Windows forced by the auto timeout.
+} scope_trigger_t;
+
+/**
+ * @brief Initializes a scope over caller-provided history storage. The scope starts stopped.
+ *
+ * @param s Pointer to the scope.
+ * @param cfg Configuration.
+ * @param storage History storage, capacity samples.
+ * @param capacity Number of samples, a power of two and at least pre + post.
+ * @return bool false if the configuration does not fit in the storage, or post is 0.
+ */
+bool scope_trigger_init(scope_trigger_t *s, const scope_trigger_config_t *cfg, uint16_t *storage,
+                        uint32_t capacity);
+
+/**
+ * @brief Starts looking for a trigger.
+ *
+ * Only an event after this call fires the trigger: a signal that is already past the level
+ * has to come back and cross it again.
+ *
+ * @param s Pointer to the scope.
+ */
+void scope_trigger_arm(scope_trigger_t *s);
+
+/**
+ * @brief Forgets the history after samples were lost, and cancels a window being collected.
+ *
+ * An armed or triggered scope stays armed, and needs `pre` new samples before it can fire.
+ *
+ * @param s Pointer to the scope.
+ */
+void scope_trigger_flush(scope_trigger_t *s);
+
+/**
+ * @brief Feeds samples to the scope.
+ *
+ * Stops right after the sample that completes a window, so that the window is not overwritten
+ * before it is read. Call it again with the remaining samples after scope_trigger_read().
+ *
+ * @param s Pointer to the scope.
+ * @param x Samples, in stream order.
+ * @param n Number of samples.
+ * @return size_t Number of samples consumed; less than n only when a window became ready.
+ */
+size_t scope_trigger_process(scope_trigger_t *s, const uint16_t *x, size_t n);
+
+/**
+ * @brief A window is ready to be read.
+ */
+static inline bool scope_trigger_ready(const scope_trigger_t *s)
+{
+    return s->state == SCOPE_READY;
+}
+
+/**
+ * @brief Number of samples in a window.
+ */
+static inline uint32_t scope_trigger_window_len(const scope_trigger_t *s)
+{
+    return s->cfg.pre + s->cfg.post;
+}
+
+/**
+ * @brief Copies the ready window out of the history, oldest sample first, and re-arms the
+ *        scope in normal and auto modes (single mode stops).
+ *
+ * @param s Pointer to the scope.
+ * @param out Destination, scope_trigger_window_len() samples, or NULL to drop the window.
+ * @param forced Optional output: true if the auto timeout captured the window (may be NULL).
+ * @return size_t Window length (samples copied unless out is NULL), 0 if no window was ready.
+ */
+size_t scope_trigger_read(scope_trigger_t *s, uint16_t *out, bool *forced);
+
+/**
+ * @brief Builds the trigger condition of up to 32 samples as a bit mask.
+ *
+ * Bit i is 1 when x[i] is outside [low, high]. Exposed for testing and benchmarking.
+ *
+ * @param x Samples.
+ * @param n Number of samples, 1 to 32.
+ * @param low Lower bound of the range where the condition is false.
+ * @param high Upper bound of that range.
+ * @return uint32_t Condition mask.
+ */
+uint32_t scope_trigger_condition(const uint16_t *x, uint32_t n, int32_t low, int32_t high);
+
+#endif // SCOPE_TRIGGER_H
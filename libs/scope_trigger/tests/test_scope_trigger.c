@@ -0,0 +1,487 @@
+/**
+ * @file test_scope_trigger.c
+ * @brief Triggered capture against synthetic waveforms and a sample-by-sample model.
+ *
+ * @details
+ * The scope is checked against model_t, which applies the rules of scope_trigger.h one sample
+ * at a time with plain comparisons: no condition masks, no 32-sample scans, no ring. Both are
+ * fed the same waveforms (sines with noise, square waves, ramps, flat stretches, full-scale
+ * noise) in random chunks, with random flushes and re-arms, for every trigger type and mode.
+ * Their state must agree after every chunk, and every window must be the right slice of the
+ * stream, with the trigger sample at index pre.
+ *
+ * The history is small (32 to 256 samples) so windows cross the end of the ring all the time,
+ * and the sample counter starts a few hundred samples short of 2^32 in half the runs, so it
+ * wraps in the middle of a window.
+ *
+ * A single step is then moved sample by sample across the end of the ring and across the
+ * scan blocks, with chunk sizes that split it every possible way: it must fire once, at the
+ * step, or not at all when fewer than pre samples precede it. The auto timeout is checked on
+ * a flat signal, where the forced windows come at a known period.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "scope_trigger.h"
+
+#define MAX_CAPACITY 256u
+#define STREAM_LEN 60000u
+
+static uint16_t storage[MAX_CAPACITY];
+static uint16_t stream[STREAM_LEN];
+static uint16_t window[MAX_CAPACITY];
+
+/**
+ * @brief The scope, one sample at a time.
+ */
+typedef struct model
+{
+    scope_trigger_config_t cfg; ///< Configuration.
+    scope_state_t state;        ///< Current state.
+    uint32_t index;             ///< Samples fed.
+    uint32_t valid;             ///< Contiguous samples fed since init or the last flush.
+    uint32_t last_cond;         ///< Condition of the last sample fed, 1 before any.
+    uint32_t waited;            ///< Samples that could have fired but did not.
+    uint32_t trigger_at;        ///< Index of the trigger sample.
+    bool forced;                ///< The auto timeout fired.
+} model_t;
+
+static uint32_t model_condition(const scope_trigger_config_t *cfg, uint16_t x)
+{
+    switch (cfg->type)
+    {
+    case SCOPE_TRIGGER_RISING:
+        return x >= cfg->level;
+    case SCOPE_TRIGGER_FALLING:
+        return x < cfg->level;
+    case SCOPE_TRIGGER_WINDOW:
+    default:
+        return x < cfg->low || x > cfg->high;
+    }
+}
+
+static void model_init(model_t *m, const scope_trigger_config_t *cfg)
+{
+    memset(m, 0, sizeof(*m));
+    m->cfg = *cfg;
+    m->state = SCOPE_STOPPED;
+    m->last_cond = 1;
+}
+
+static void model_arm(model_t *m)
+{
+    m->state = SCOPE_ARMED;
+    m->waited = 0;
+    m->forced = false;
+}
+
+static void model_flush(model_t *m)
+{
+    m->valid = 0;
+    m->last_cond = 1;
+    m->waited = 0;
+    if (m->state == SCOPE_TRIGGERED)
+    {
+        m->state = SCOPE_ARMED;
+        m->forced = false;
+    }
+}
+
+static void model_feed(model_t *m, uint16_t x)
+{
+    uint32_t cond = model_condition(&m->cfg, x);
+
+    if (m->state == SCOPE_ARMED && m->valid >= m->cfg.pre)
+    {
+        bool edge = cond && !m->last_cond;
+        bool timeout = m->cfg.mode == SCOPE_MODE_AUTO && m->waited == m->cfg.auto_timeout;
+        if (edge || timeout)
+        {
+            m->state = SCOPE_TRIGGERED;
+            m->trigger_at = m->index;
+            m->forced = !edge;
+            m->waited = 0;
+        }
+        else
+        {
+            m->waited++;
+        }
+    }
+    m->last_cond = cond;
+    m->valid++;
+    m->index++;
+    if (m->state == SCOPE_TRIGGERED && m->index == m->trigger_at + m->cfg.post)
+    {
+        m->state = SCOPE_READY;
+    }
+}
+
+static void model_read(model_t *m)
+{
+    m->state = (m->cfg.mode == SCOPE_MODE_SINGLE) ? SCOPE_STOPPED : SCOPE_ARMED;
+    m->waited = 0;
+    m->forced = false;
+}
+
+/**
+ * @brief Fills the stream with stretches of different waveforms.
+ */
+static void make_stream(void)
+{
+    size_t i = 0;
+    while (i < STREAM_LEN)
+    {
+        size_t len = 50u + (size_t)rand() % 2000u;
+        if (len > STREAM_LEN - i)
+        {
+            len = STREAM_LEN - i;
+        }
+        int kind = rand() % 5;
+        int32_t mid = rand() % 4096;
+        int32_t amp = rand() % 2048;
+        int32_t period = 4 + rand() % 400;
+        for (size_t k = 0; k < len; k++, i++)
+        {
+            int32_t v;
+            switch (kind)
+            {
+            case 0: // Sine with noise
+                v = mid + (int32_t)(amp * sin(6.283185307 * (double)k / period)) + rand() % 64 - 32;
+                break;
+            case 1: // Square wave
+                v = ((int32_t)k % period < period / 2) ? mid - amp : mid + amp;
+                break;
+            case 2: // Ramp
+                v = mid - amp + (int32_t)((2 * amp * (int32_t)(k % (size_t)period)) / period);
+                break;
+            case 3: // Flat
+                v = mid;
+                break;
+            default: // Full-scale noise
+                v = rand() & 0xFFFF;
+                break;
+            }
+            stream[i] = (uint16_t)(v < 0 ? 0 : v > 0xFFFF ? 0xFFFF : v);
+        }
+    }
+}
+
+static scope_trigger_config_t random_config(uint32_t capacity)
+{
+    scope_trigger_config_t cfg = {0};
+    cfg.type = (scope_trigger_type_t)(rand() % 3);
+    cfg.mode = (scope_mode_t)(rand() % 3);
+    cfg.level = (uint16_t)(rand() % 4097);
+    cfg.low = (uint16_t)(rand() % 4096);
+    cfg.high = (uint16_t)(cfg.low + rand() % 1024);
+    cfg.post = 1u + (uint32_t)rand() % capacity;
+    cfg.pre = (uint32_t)rand() % (capacity - cfg.post + 1u);
+    cfg.auto_timeout = (uint32_t)rand() % 600u;
+    return cfg;
+}
+
+/**
+ * @brief Feeds the stream to a scope and the model in random chunks and compares them.
+ */
+static void run_random(const scope_trigger_config_t *cfg, uint32_t capacity, uint32_t base)
+{
+    scope_trigger_t s;
+    model_t m;
+    CHECK(scope_trigger_init(&s, cfg, storage, capacity));
+    model_init(&m, cfg);
+
+    // The counter only matters modulo 2^32: starting it near the top makes it wrap early
+    s.written = base;
+
+    scope_trigger_arm(&s);
+    model_arm(&m);
+
+    size_t at = 0;
+    size_t bad = 0;
+    uint32_t windows = 0;
+    uint32_t forced_windows = 0;
+    while (at < STREAM_LEN)
+    {
+        size_t n = 1u + (size_t)rand() % ((rand() & 1) ? 40u : 700u);
+        if (n > STREAM_LEN - at)
+        {
+            n = STREAM_LEN - at;
+        }
+        size_t done = scope_trigger_process(&s, &stream[at], n);
+        for (size_t k = 0; k < done; k++)
+        {
+            model_feed(&m, stream[at + k]);
+        }
+        at += done;
+
+        bad += s.state != m.state;
+        bad += done < n && m.state != SCOPE_READY;
+        if (m.state == SCOPE_READY)
+        {
+            bool forced = false;
+            size_t len = scope_trigger_read(&s, window, &forced);
+            bad += len != cfg->pre + cfg->post;
+            bad += s.trigger_at - base != m.trigger_at;
+            bad += forced != m.forced;
+            bad += memcmp(window, &stream[m.trigger_at - cfg->pre], len * sizeof(uint16_t)) != 0;
+            windows++;
+            forced_windows += m.forced;
+            model_read(&m);
+        }
+
+        // Lost samples now and then, and a re-arm some time after a single capture
+        int event = rand() % 64;
+        if (event == 0)
+        {
+            scope_trigger_flush(&s);
+            model_flush(&m);
+        }
+        else if (event < 8 && m.state == SCOPE_STOPPED)
+        {
+            scope_trigger_arm(&s);
+            model_arm(&m);
+        }
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(s.windows, windows);
+    CHECK_EQ(s.forced_windows, forced_windows);
+    CHECK_EQ(s.written - base, STREAM_LEN);
+}
+
+static void test_random(void)
+{
+    static const uint32_t capacities[] = {32u, 64u, 256u};
+    for (int run = 0; run < 300; run++)
+    {
+        if (run % 30 == 0)
+        {
+            make_stream();
+        }
+        uint32_t capacity = capacities[run % 3];
+        scope_trigger_config_t cfg = random_config(capacity);
+        uint32_t base = (run & 1) ? 0xFFFFFFFFu - (uint32_t)rand() % 1000u : 0u;
+        uint32_t before = host_test_failures;
+        run_random(&cfg, capacity, base);
+        if (host_test_failures != before)
+        {
+            fprintf(stderr, "  run %d: type %d mode %d level %u window [%u, %u] pre %u post %u auto %u "
+                    "capacity %u base %u\n", run, cfg.type, cfg.mode, cfg.level, cfg.low, cfg.high,
+                    cfg.pre, cfg.post, cfg.auto_timeout, capacity, base);
+        }
+    }
+}
+
+/**
+ * @brief Value of sample i of a stream that steps at p, for each trigger type.
+ */
+static uint16_t step_sample(scope_trigger_type_t type, uint32_t i, uint32_t p)
+{
+    bool after = i >= p;
+    switch (type)
+    {
+    case SCOPE_TRIGGER_RISING:
+        return (uint16_t)(after ? 2000u + (i & 511u) : i % 50u);
+    case SCOPE_TRIGGER_FALLING:
+        return (uint16_t)(after ? i % 50u : 2000u + (i & 511u));
+    case SCOPE_TRIGGER_WINDOW:
+    default:
+        return (uint16_t)(after ? ((i & 1u) ? 3500u : 200u) + i % 50u : 1500u + i % 50u);
+    }
+}
+
+static void test_step(void)
+{
+    static const uint32_t chunks[] = {1u, 7u, 31u, 32u, 33u, 64u, 100u, 300u};
+    static const uint32_t bases[] = {0u, 0xFFFFFFFFu - 150u};
+    const uint32_t capacity = 64u;
+    const uint32_t n = 300u;
+
+    for (int type = SCOPE_TRIGGER_RISING; type <= SCOPE_TRIGGER_WINDOW; type++)
+    {
+        scope_trigger_config_t cfg = {
+            .type = (scope_trigger_type_t)type,
+            .mode = SCOPE_MODE_NORMAL,
+            .level = 1000,
+            .low = 1000,
+            .high = 3000,
+            .pre = 10,
+            .post = 20,
+        };
+        for (uint32_t p = 0; p < 200u; p++)
+        {
+            for (uint32_t i = 0; i < n; i++)
+            {
+                stream[i] = step_sample(cfg.type, i, p);
+            }
+            for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+            {
+                for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++)
+                {
+                    scope_trigger_t s;
+                    CHECK(scope_trigger_init(&s, &cfg, storage, capacity));
+                    s.written = bases[b];
+                    scope_trigger_arm(&s);
+
+                    uint32_t windows = 0;
+                    uint32_t at = 0;
+                    while (at < n)
+                    {
+                        uint32_t len = (n - at < chunks[c]) ? n - at : chunks[c];
+                        at += (uint32_t)scope_trigger_process(&s, &stream[at], len);
+                        if (scope_trigger_ready(&s))
+                        {
+                            bool forced = true;
+                            CHECK_EQ(scope_trigger_read(&s, window, &forced), cfg.pre + cfg.post);
+                            CHECK(!forced);
+                            CHECK_EQ(s.trigger_at - bases[b], p);
+                            CHECK(memcmp(window, &stream[p - cfg.pre],
+                                         (cfg.pre + cfg.post) * sizeof(uint16_t)) == 0);
+                            windows++;
+                        }
+                    }
+                    CHECK_EQ(windows, (p < cfg.pre) ? 0 : 1);
+                    CHECK_EQ(s.state, SCOPE_ARMED);
+                }
+            }
+        }
+    }
+}
+
+static void test_modes(void)
+{
+    scope_trigger_config_t cfg = {
+        .type = SCOPE_TRIGGER_RISING,
+        .mode = SCOPE_MODE_AUTO,
+        .level = 1000,
+        .pre = 16,
+        .post = 48,
+        .auto_timeout = 100,
+    };
+    scope_trigger_t s;
+    bool forced;
+
+    // Auto on a flat signal: the first window once pre samples and the timeout have passed,
+    // the next one a timeout after each window is read
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        stream[i] = 500;
+    }
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+    scope_trigger_arm(&s);
+    uint32_t expect = cfg.pre + cfg.auto_timeout;
+    uint32_t at = 0;
+    while (at < 1000u)
+    {
+        at += (uint32_t)scope_trigger_process(&s, &stream[at], 1000u - at);
+        if (scope_trigger_ready(&s))
+        {
+            CHECK_EQ(s.trigger_at, expect);
+            CHECK_EQ(scope_trigger_read(&s, NULL, &forced), 64);
+            CHECK(forced);
+            expect += cfg.post + cfg.auto_timeout;
+        }
+    }
+    CHECK_EQ(s.windows, 6);
+    CHECK_EQ(s.forced_windows, 6);
+
+    // Single: one window, then the rest of the stream goes by without another
+    cfg.mode = SCOPE_MODE_SINGLE;
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        stream[i] = ((i / 50u) & 1u) ? 1500 : 500;
+    }
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+    scope_trigger_arm(&s);
+    CHECK_EQ(scope_trigger_process(&s, stream, 1000u), 50u + cfg.post);
+    CHECK_EQ(s.trigger_at, 50);
+    CHECK_EQ(scope_trigger_read(&s, window, &forced), 64);
+    CHECK(!forced);
+    CHECK_EQ(s.state, SCOPE_STOPPED);
+    CHECK_EQ(scope_trigger_process(&s, &stream[50u + cfg.post], 1000u - 50u - cfg.post),
+             1000u - 50u - cfg.post);
+    CHECK_EQ(s.windows, 1);
+
+    // Armed while the signal is high: the next rising edge fires, not the level
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+    CHECK_EQ(scope_trigger_process(&s, stream, 60u), 60u);
+    scope_trigger_arm(&s);
+    CHECK_EQ(scope_trigger_process(&s, &stream[60], 940u), 150u - 60u + cfg.post);
+    CHECK_EQ(s.trigger_at, 150);
+
+    // Normal: one window per edge, none forced however long the signal stays flat
+    cfg.mode = SCOPE_MODE_NORMAL;
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+    scope_trigger_arm(&s);
+    at = 0;
+    while (at < 1000u)
+    {
+        at += (uint32_t)scope_trigger_process(&s, &stream[at], 1000u - at);
+        scope_trigger_read(&s, NULL, NULL);
+    }
+    CHECK_EQ(s.windows, 10);
+    CHECK_EQ(s.forced_windows, 0);
+
+    // A flush drops a window being collected, and the next trigger needs pre new samples
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+    scope_trigger_arm(&s);
+    CHECK_EQ(scope_trigger_process(&s, stream, 60u), 60u);
+    CHECK_EQ(s.state, SCOPE_TRIGGERED);
+    scope_trigger_flush(&s);
+    CHECK_EQ(s.state, SCOPE_ARMED);
+    CHECK_EQ(scope_trigger_process(&s, &stream[100], 10u), 10u);  // Low, fewer than pre
+    CHECK_EQ(scope_trigger_process(&s, &stream[150], 50u), 50u);  // High, not fired
+    CHECK_EQ(s.state, SCOPE_ARMED);
+    CHECK_EQ(scope_trigger_process(&s, &stream[200], 100u), 50u + cfg.post);
+    CHECK_EQ(s.trigger_at, 60u + 10u + 50u + 50u);
+    CHECK(scope_trigger_ready(&s));
+
+    // Configurations that do not fit
+    cfg.pre = 16;
+    cfg.post = 0;
+    CHECK(!scope_trigger_init(&s, &cfg, storage, 64u));
+    cfg.post = 49;
+    CHECK(!scope_trigger_init(&s, &cfg, storage, 64u));
+    cfg.post = 48;
+    CHECK(!scope_trigger_init(&s, &cfg, storage, 96u));
+    CHECK(scope_trigger_init(&s, &cfg, storage, 64u));
+}
+
+static void test_condition(void)
+{
+    uint16_t x[32];
+    size_t bad = 0;
+    for (int run = 0; run < 20000; run++)
+    {
+        uint32_t n = 1u + (uint32_t)rand() % 32u;
+        int32_t low = rand() % 0x10001;
+        int32_t high = (rand() & 3) ? low + rand() % 4096 - 64 : 0xFFFF;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int r = rand() % 4;
+            x[i] = (uint16_t)(r == 0 ? 0 : r == 1 ? 0xFFFF : rand() & 0xFFFF);
+        }
+        uint32_t cond = scope_trigger_condition(x, n, low, high);
+        uint32_t expect = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            expect |= (uint32_t)(x[i] < low || x[i] > high) << i;
+        }
+        bad += cond != expect;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+int main(void)
+{
+    srand(24);
+
+    test_condition();
+    test_modes();
+    test_step();
+    test_random();
+
+    return host_test_result("scope_trigger");
+}
@@ -0,0 +1,254 @@
+/**
+ * @file sh_model.c
+ * @brief Period mapping, potentiometer filtering and timing model of the PIO Sample and
+ * Hold pulse.
+ */
+
+#include "sh_model.h"
+
+/// 2^(k / 16) in Q16, k = 0 .. 16.
+static const uint32_t exp2_q16[17] = {
+    65536, 68438, 71468, 74632, 77936, 81386, 84990, 88752, 92682,
+    96785, 101070, 105545, 110218, 115098, 120194, 125515, 131072,
+};
+
+uint32_t sh_period_ns(uint32_t min_ns, uint32_t octaves, uint16_t reading)
+{
+    if (reading > SH_ADC_MAX)
+    {
+        reading = SH_ADC_MAX;
+    }
+
+    // Position on the scale in 1/4096 octave, rounded.
+    uint32_t pos = ((uint32_t)reading * octaves * 4096u + SH_ADC_MAX / 2u) / SH_ADC_MAX;
+    uint32_t whole = pos >> 12;
+    uint32_t k = (pos >> 8) & 15u;
+    uint32_t frac = pos & 255u;
+
+    uint32_t mant = exp2_q16[k] + (((exp2_q16[k + 1] - exp2_q16[k]) * frac + 128u) >> 8);
+    uint64_t period = (((uint64_t)min_ns * mant + 32768u) >> 16) << whole;
+    return period > UINT32_MAX ? UINT32_MAX : (uint32_t)period;
+}
+
+void sh_knob_init(sh_knob_t *k, uint8_t shift, uint16_t hyst)
+{
+    k->acc = 0;
+    k->value = 0;
+    k->held = 0;
+    k->hyst = hyst;
+    k->shift = shift;
+    k->primed = false;
+}
+
+bool sh_knob_update(sh_knob_t *k, uint16_t raw)
+{
+    if (raw > SH_ADC_MAX)
+    {
+        raw = SH_ADC_MAX;
+    }
+
+    if (!k->primed)
+    {
+        k->acc = (uint32_t)raw << k->shift;
+        k->value = raw;
+        k->held = raw;
+        k->primed = true;
+        return true;
+    }
+
+    // acc += raw - acc / 2^shift, i.e. value += (raw - value) / 2^shift.
+    k->acc = k->acc - (k->acc >> k->shift) + raw;
+    k->value = (uint16_t)((k->acc + (1u << k->shift >> 1)) >> k->shift);
+
+    uint16_t target = k->value;
+    if (target <= k->hyst)
+    {
+        target = 0;
+    }
+    else if (target >= SH_ADC_MAX - k->hyst)
+    {
+        target = SH_ADC_MAX;
+    }
+    else if ((target > k->held ? target - k->held : k->held - target) <= k->hyst)
+    {
+        return false;
+    }
+
+    if (target == k->held)
+    {
+        return false;
+    }
+    k->held = target;
+    return true;
+}
+
+int sh_timing(sh_timing_t *t, uint32_t sys_hz, uint32_t period_ns, uint32_t pulse_ns)
+{
+    uint64_t period = ((uint64_t)period_ns * sys_hz + 500000000u) / 1000000000u;
+    uint64_t high = ((uint64_t)pulse_ns * sys_hz + 500000000u) / 1000000000u;
+
+    // The counts are 32-bit, H = high - 3 and L = low - 8.
+    if (period < SH_HIGH_OVERHEAD + SH_LOW_OVERHEAD || period > (uint64_t)UINT32_MAX)
+    {
+        return SH_ERR_RANGE;
+    }
+    if (high > period / 2u)
+    {
+        high = period / 2u;
+    }
+    if (high < SH_HIGH_OVERHEAD)
+    {
+        high = SH_HIGH_OVERHEAD;
+    }
+    if (period - high < SH_LOW_OVERHEAD)
+    {
+        high = period - SH_LOW_OVERHEAD;
+    }
+
+    t->period_cycles = (uint32_t)period;
+    t->high_cycles = (uint32_t)high;
+    return 0;
+}
+
+typedef enum mock_op
+{
+    OP_MOV_Y_STATUS, ///< mov y, status (TX FIFO level < 2)
+    OP_JMP_NOT_Y,    ///< jmp !y target
+    OP_JMP,          ///< jmp target
+    OP_PULL_NOBLOCK, ///< pull noblock (copies X when the FIFO is empty)
+    OP_MOV_X_OSR,    ///< mov x, osr
+    OP_SET_PINS,     ///< set pins, arg
+    OP_MOV_Y_X,      ///< mov y, x
+    OP_JMP_Y_DEC,    ///< jmp y-- target
+    OP_MOV_Y_OSR,    ///< mov y, osr
+} mock_op_t;
+
+typedef struct mock_instr
+{
+    mock_op_t op;  ///< Operation.
+    uint8_t arg;   ///< SET value or jump target.
+    uint8_t delay; ///< Delay cycles.
+} mock_instr_t;
+
+/// sh_pulse.pio, line by line.
+static const mock_instr_t program[] = {
+    {OP_MOV_Y_STATUS, 0, 0}, // 0: wrap target
+    {OP_JMP_NOT_Y, 3, 0},    // 1
+    {OP_JMP, 6, 2},          // 2
+    {OP_PULL_NOBLOCK, 0, 0}, // 3: load
+    {OP_MOV_X_OSR, 0, 0},    // 4
+    {OP_PULL_NOBLOCK, 0, 0}, // 5
+    {OP_SET_PINS, 1, 0},     // 6: run
+    {OP_MOV_Y_X, 0, 0},      // 7
+    {OP_JMP_Y_DEC, 8, 0},    // 8: high
+    {OP_SET_PINS, 0, 0},     // 9
+    {OP_MOV_Y_OSR, 0, 0},    // 10
+    {OP_JMP_Y_DEC, 11, 0},   // 11: low, wrap
+};
+
+#define WRAP_TOP 11u
+#define WRAP_TARGET 0u
+
+void sh_mock_run(const uint32_t *words, const uint32_t *ready, size_t n, uint8_t *pin, size_t n_out)
+{
+    uint32_t fifo[SH_FIFO_DEPTH];
+    uint32_t fifo_head = 0, fifo_tail = 0;
+    size_t next = 0;
+
+    uint32_t pc = 0, x = 0, y = 0, osr = 0, delay = 0;
+    uint8_t level = 0;
+
+    for (size_t t = 0; t < n_out; t++)
+    {
+        // The CPU writes a pair once both words fit.
+        while (next < n && ready[next] <= t && fifo_head - fifo_tail <= SH_FIFO_DEPTH - 2u)
+        {
+            fifo[fifo_head++ % SH_FIFO_DEPTH] = words[2u * next];
+            fifo[fifo_head++ % SH_FIFO_DEPTH] = words[2u * next + 1u];
+            next++;
+        }
+
+        if (delay)
+        {
+            delay--;
+        }
+        else
+        {
+            const mock_instr_t *in = &program[pc];
+            uint32_t npc = (pc == WRAP_TOP) ? WRAP_TARGET : pc + 1u;
+
+            switch (in->op)
+            {
+            case OP_MOV_Y_STATUS:
+                y = (fifo_head - fifo_tail < 2u) ? 0xFFFFFFFFu : 0u;
+                break;
+            case OP_JMP_NOT_Y:
+                if (y == 0)
+                {
+                    npc = in->arg;
+                }
+                break;
+            case OP_JMP:
+                npc = in->arg;
+                break;
+            case OP_PULL_NOBLOCK:
+                osr = (fifo_head == fifo_tail) ? x : fifo[fifo_tail++ % SH_FIFO_DEPTH];
+                break;
+            case OP_MOV_X_OSR:
+                x = osr;
+                break;
+            case OP_SET_PINS:
+                level = in->arg;
+                break;
+            case OP_MOV_Y_X:
+                y = x;
+                break;
+            case OP_JMP_Y_DEC:
+                if (y != 0)
+                {
+                    npc = in->arg;
+                }
+                y--;
+                break;
+            case OP_MOV_Y_OSR:
+                y = osr;
+                break;
+            }
+
+            pc = npc;
+            delay = in->delay;
+        }
+
+        pin[t] = level;
+    }
+}
+
+size_t sh_measure(const uint8_t *pin, size_t n, sh_timing_t *out, size_t max_out)
+{
+    size_t count = 0;
+    size_t rise = 0, fall = 0;
+    bool started = false;
+
+    for (size_t t = 1; t < n; t++)
+    {
+        if (pin[t] && !pin[t - 1])
+        {
+            if (started)
+            {
+                if (count < max_out)
+                {
+                    out[count].period_cycles = (uint32_t)(t - rise);
+                    out[count].high_cycles = (uint32_t)(fall - rise);
+                }
+                count++;
+            }
+            rise = t;
+            started = true;
+        }
+        else if (!pin[t] && pin[t - 1])
+        {
+            fall = t;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file sh_model.h
+ * @brief Period mapping, potentiometer filtering and timing model of the PIO Sample and
+ * Hold pulse.
+ *
+ * @details
+ * The pulse (sh_pulse.pio) is generated entirely by a PIO state machine at the system
+ * clock, so its timing does not depend on what the CPU is doing. Each period is one high
+ * phase (the S&H switch closed) and one low phase, set by two loop counts:
+ *
+ * - high: H + SH_HIGH_OVERHEAD cycles, low: L + SH_LOW_OVERHEAD cycles.
+ * - The counts are 32-bit, so at 125 MHz the period can run from under 100 ns to over
+ *   30 s in 8 ns steps.
+ * - A new (H, L) pair in the TX FIFO takes effect at the next period boundary.
+ *
+ * The potentiometer sets the period on a logarithmic scale, SH_OCTAVES octaves up from
+ * the shortest period, so each turn of the knob changes the rate by the same ratio.
+ * Readings go through a first-order low-pass and a hysteresis band first, so ADC noise
+ * does not retune the pulse.
+ *
+ * sh_mock_run() executes the program instruction by instruction, and sh_measure() reads
+ * the periods back from a pin trace. Together they check on the host that an update never
+ * produces a runt or stretched period.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef SH_MODEL_H
+#define SH_MODEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SH_ADC_MAX 4095u        ///< Largest potentiometer reading (12-bit ADC).
+#define SH_HIGH_OVERHEAD 3u     ///< Cycles of the high phase beyond its count.
+#define SH_LOW_OVERHEAD 8u      ///< Cycles of the low phase beyond its count.
+#define SH_FIFO_DEPTH 4u        ///< TX FIFO words; holds two pairs.
+#define SH_MIN_PERIOD_NS 10000u ///< Default shortest period: 100 kHz.
+#define SH_OCTAVES 12u          ///< Default span: 4096:1, down to about 24 Hz.
+
+// Error codes returned by sh_timing()
+#define SH_ERR_RANGE -1 ///< Period too short for the program, or too long for the counts.
+#define SH_ERR_BUSY -2  ///< No room in the TX FIFO for a pair (sh_pulse_set()).
+
+typedef struct sh_timing
+{
+    uint32_t period_cycles; ///< PIO cycles per period.
+    uint32_t high_cycles;   ///< Cycles the switch is closed.
+} sh_timing_t;
+
+typedef struct sh_knob
+{
+    uint32_t acc;   ///< Low-pass state, the filtered reading scaled by 2^shift.
+    uint16_t value; ///< Filtered reading.
+    uint16_t held;  ///< Reading the output was last set from.
+    uint16_t hyst;  ///< Change in the filtered reading that moves held.
+    uint8_t shift;  ///< Low-pass time constant, 2^shift readings.
+    bool primed;    ///< A reading has been taken.
+} sh_knob_t;
+
+/**
+ * @brief Period for a potentiometer reading, min_ns * 2^(octaves * reading / SH_ADC_MAX).
+ *
+ * Exact at every 1/16 octave and linear between them (under 0.05% off).
+ *
+ * @param min_ns Period at reading 0.
+ * @param octaves Octaves covered up to SH_ADC_MAX (1 to 20).
+ * @param reading Filtered reading, 0 .. SH_ADC_MAX; larger readings are clamped.
+ * @return uint32_t Period in nanoseconds, saturated at UINT32_MAX.
+ */
+uint32_t sh_period_ns(uint32_t min_ns, uint32_t octaves, uint16_t reading);
+
+/**
+ * @brief Initializes a potentiometer filter.
+ *
+ * @param k Pointer to the filter.
+ * @param shift Low-pass time constant as a power of two (0 for none).
+ * @param hyst Hysteresis band in ADC counts.
+ */
+void sh_knob_init(sh_knob_t *k, uint8_t shift, uint16_t hyst);
+
+/**
+ * @brief Filters a reading and reports whether the held value moved.
+ *
+ * held follows the filtered value only when it moves more than hyst away, or when it
+ * reaches within hyst of either end, so both ends of the scale stay reachable. The first
+ * reading sets both at once.
+ *
+ * @param k Pointer to the filter.
+ * @param raw ADC reading.
+ * @return true if held changed.
+ */
+bool sh_knob_update(sh_knob_t *k, uint16_t raw);
+
+/**
+ * @brief Converts a period and pulse width to PIO cycles.
+ *
+ * The pulse is clamped to half the period, and to the program's shortest high and low
+ * phases.
+ *
+ * @param t Output timing.
+ * @param sys_hz PIO clock (clk_sys, divider 1).
+ * @param period_ns Period in nanoseconds.
+ * @param pulse_ns Pulse width in nanoseconds.
+ * @return int 0 on success, or SH_ERR_RANGE.
+ */
+int sh_timing(sh_timing_t *t, uint32_t sys_hz, uint32_t period_ns, uint32_t pulse_ns);
+
+/**
+ * @brief High count H, the first word of a pair.
+ */
+static inline uint32_t sh_high_word(const sh_timing_t *t)
+{
+    return t->high_cycles - SH_HIGH_OVERHEAD;
+}
+
+/**
+ * @brief Low count L, the second word of a pair.
+ */
+static inline uint32_t sh_low_word(const sh_timing_t *t)
+{
+    return t->period_cycles - t->high_cycles - SH_LOW_OVERHEAD;
+}
+
+/**
+ * @brief Runs the pulse program on a sequence of timing updates.
+ *
+ * Pair i (words[2i], words[2i + 1]) is written to the FIFO at cycle ready[i], or later if
+ * there is no room for both words. ready[0] should be 0, for the pair the driver writes
+ * before it starts the state machine. The pin starts low.
+ *
+ * @param words High and low counts, two per update.
+ * @param ready Earliest cycle each pair is written, non-decreasing.
+ * @param n Number of pairs.
+ * @param pin Output, pin level at each cycle.
+ * @param n_out Number of cycles to run.
+ */
+void sh_mock_run(const uint32_t *words, const uint32_t *ready, size_t n, uint8_t *pin, size_t n_out);
+
+/**
+ * @brief Measures the complete periods of a pin trace, from rising edge to rising edge.
+ *
+ * @param pin Pin level at each cycle.
+ * @param n Number of cycles.
+ * @param out Output timings, one per complete period.
+ * @param max_out Room in out.
+ * @return size_t Number of periods found (may exceed max_out; only max_out are stored).
+ */
+size_t sh_measure(const uint8_t *pin, size_t n, sh_timing_t *out, size_t max_out);
+
+#endif // SH_MODEL_H
@@ -0,0 +1,62 @@
+/**
+ * @file sh_pulse.c
+ * @brief Sample and Hold switch pulse generated by a PIO state machine.
+ */
+
+#include "sh_pulse.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "sh_pulse.pio.h"
+
+int sh_pulse_init(sh_pulse_t *p, PIO pio, uint pin, uint32_t period_ns, uint32_t pulse_ns)
+{
+    int err = sh_timing(&p->timing, clock_get_hz(clk_sys), period_ns, pulse_ns);
+    if (err)
+    {
+        return err;
+    }
+
+    p->pio = pio;
+    p->sm = (uint)pio_claim_unused_sm(pio, true);
+
+    uint offset = pio_add_program(pio, &sh_pulse_program);
+    pio_sm_config c = sh_pulse_program_get_default_config(offset);
+    sm_config_set_set_pins(&c, pin, 1);
+    sm_config_set_mov_status(&c, STATUS_TX_LESSTHAN, 2); // mov status: all ones until a whole pair is queued
+    sm_config_set_clkdiv_int_frac(&c, 1, 0);             // Full clk_sys resolution; the counts are 32-bit
+
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, p->sm, pin, 1, true);
+    pio_sm_set_pins_with_mask(pio, p->sm, 0, 1u << pin);
+    pio_sm_init(pio, p->sm, offset, &c);
+
+    // The first pair is loaded by the first period.
+    pio_sm_put(pio, p->sm, sh_high_word(&p->timing));
+    pio_sm_put(pio, p->sm, sh_low_word(&p->timing));
+    pio_sm_set_enabled(pio, p->sm, true);
+    return 0;
+}
+
+int sh_pulse_set(sh_pulse_t *p, uint32_t period_ns, uint32_t pulse_ns)
+{
+    sh_timing_t t;
+    int err = sh_timing(&t, clock_get_hz(clk_sys), period_ns, pulse_ns);
+    if (err)
+    {
+        return err;
+    }
+
+    // Both words must go in back to back; the state machine only takes whole pairs.
+    uint32_t irq = save_and_disable_interrupts();
+    if (pio_sm_get_tx_fifo_level(p->pio, p->sm) > SH_FIFO_DEPTH - 2u)
+    {
+        restore_interrupts(irq);
+        return SH_ERR_BUSY;
+    }
+    pio_sm_put(p->pio, p->sm, sh_high_word(&t));
+    pio_sm_put(p->pio, p->sm, sh_low_word(&t));
+    restore_interrupts(irq);
+
+    p->timing = t;
+    return 0;
+}
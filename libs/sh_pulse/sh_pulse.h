@@ -0,0 +1,52 @@
+/**
+ * @file sh_pulse.h
+ * @brief Sample and Hold switch pulse generated by a PIO state machine.
+ *
+ * @details
+ * The state machine repeats the last period and pulse width it was given, with no CPU
+ * involvement (see sh_model.h for the program timing). sh_pulse_set() queues a new
+ * pair of counts. The state machine picks it up at the start of its next period, so the
+ * switch never sees a runt or a stretched pulse, whatever the update rate.
+ */
+
+#ifndef SH_PULSE_H
+#define SH_PULSE_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "sh_model.h"
+
+typedef struct sh_pulse
+{
+    PIO pio;            ///< PIO block running the pulse program.
+    uint sm;            ///< State machine.
+    sh_timing_t timing; ///< Last timing queued.
+} sh_pulse_t;
+
+/**
+ * @brief Loads the pulse program, claims a state machine and starts the pulse.
+ *
+ * @param p Pointer to the pulse output.
+ * @param pio PIO block to use.
+ * @param pin Output pin, low between pulses.
+ * @param period_ns Period in nanoseconds.
+ * @param pulse_ns Pulse width in nanoseconds (clamped to half the period).
+ * @return int 0 on success, or SH_ERR_RANGE.
+ */
+int sh_pulse_init(sh_pulse_t *p, PIO pio, uint pin, uint32_t period_ns, uint32_t pulse_ns);
+
+/**
+ * @brief Queues a new period and pulse width for the next period boundary.
+ *
+ * The timing is computed from the current clk_sys. The call never blocks: if the two
+ * previous updates are still queued (periods longer than the update interval), it
+ * returns SH_ERR_BUSY and the caller retries later.
+ *
+ * @param p Pointer to the pulse output.
+ * @param period_ns Period in nanoseconds.
+ * @param pulse_ns Pulse width in nanoseconds (clamped to half the period).
+ * @return int 0 on success, SH_ERR_RANGE or SH_ERR_BUSY.
+ */
+int sh_pulse_set(sh_pulse_t *p, uint32_t period_ns, uint32_t pulse_ns);
+
+#endif // SH_PULSE_H
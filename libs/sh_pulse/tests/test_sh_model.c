@@ -0,0 +1,359 @@
+/**
+ * @file test_sh_model.c
+ * @brief sh_mock_run() against sh_pulse.pio on pio_sim, the period map and the knob filter.
+ *
+ * @details
+ * Sequences of timing updates, written at the start of the run, in the middle of a phase,
+ * right at a period boundary, back to back and at random, are played through the
+ * hand-written mock and through the program assembled from sh_pulse.pio, configured as
+ * sh_pulse_init() does it (SET pin, mov status below 2 words, 4-word FIFO). The pin levels
+ * must agree on every cycle. sh_measure() must then read back only whole periods of the
+ * programmed timings, each update in its turn: no runt or stretched period.
+ *
+ * sh_period_ns() must be monotonic, exact at the ends and within 0.05 % of the exponential
+ * curve, and sh_timing() must round and clamp as documented. The knob filter must reach
+ * both ends of the scale on a ramp, follow a step and hold still on a noisy reading, with
+ * the Sample_Hold firmware's settings.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "pio_sim.h"
+#include "sh_model.h"
+
+#define PIN 15u
+#define MAX_UPDATES 16u
+#define MAX_CYCLES 60000u
+#define MAX_PERIODS 4096u
+
+static pio_sim_program_t prog;
+static uint8_t mock_pin[MAX_CYCLES], sim_pin[MAX_CYCLES];
+static sh_timing_t periods[MAX_PERIODS];
+
+typedef struct scenario
+{
+    sh_timing_t timing[MAX_UPDATES];
+    uint32_t words[2u * MAX_UPDATES];
+    uint32_t ready[MAX_UPDATES];
+    size_t n;
+    size_t cycles;
+} scenario_t;
+
+static void add(scenario_t *sc, uint32_t period, uint32_t high, uint32_t ready)
+{
+    sh_timing_t t = {.period_cycles = period, .high_cycles = high};
+    sc->timing[sc->n] = t;
+    sc->words[2u * sc->n] = sh_high_word(&t);
+    sc->words[2u * sc->n + 1u] = sh_low_word(&t);
+    sc->ready[sc->n] = ready;
+    sc->n++;
+}
+
+/**
+ * @brief Runs the assembled program as sh_pulse_init() and sh_pulse_set() drive it.
+ */
+static void run_pio(const scenario_t *sc)
+{
+    pio_sim_config_t cfg = pio_sim_default_config();
+    cfg.set_base = PIN;
+    cfg.set_count = 1;
+    cfg.status_n = 2;
+    cfg.fifo_depth = SH_FIFO_DEPTH;
+
+    pio_sim_sm_t sm;
+    pio_sim_init(&sm, &prog, &cfg, 0);
+    size_t next = 0;
+    for (size_t t = 0; t < sc->cycles; t++)
+    {
+        // sh_pulse_set() writes both words, or neither
+        while (next < sc->n && sc->ready[next] <= t && sm.fifo_level <= SH_FIFO_DEPTH - 2u)
+        {
+            pio_sim_put(&sm, sc->words[2u * next]);
+            pio_sim_put(&sm, sc->words[2u * next + 1u]);
+            next++;
+        }
+        pio_sim_step(&sm);
+        sim_pin[t] = pio_sim_pin(&sm, PIN);
+    }
+    CHECK_EQ(next, sc->n);
+}
+
+/**
+ * @brief Compares the mock with the program and checks the periods of the trace.
+ */
+static void check(const scenario_t *sc, const char *name)
+{
+    CHECK(sc->cycles <= MAX_CYCLES);
+    sh_mock_run(sc->words, sc->ready, sc->n, mock_pin, sc->cycles);
+    run_pio(sc);
+
+    size_t mismatches = 0, first = 0;
+    for (size_t t = 0; t < sc->cycles; t++)
+    {
+        if (mock_pin[t] != sim_pin[t] && mismatches++ == 0)
+        {
+            first = t;
+        }
+    }
+    if (mismatches)
+    {
+        fprintf(stderr, "  %s: %zu cycles differ, first at %zu\n", name, mismatches, first);
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // Every period is one of the updates, in order; none is skipped while later ones
+    // follow, and the first rise comes 5 cycles in, after the load path.
+    size_t n = sh_measure(mock_pin, sc->cycles, periods, MAX_PERIODS);
+    CHECK(n > 0 && n <= MAX_PERIODS);
+    CHECK_EQ((const uint8_t *)memchr(mock_pin, 1, sc->cycles) - mock_pin, 5);
+    size_t u = 0, bad = 0;
+    for (size_t i = 0; i < n && i < MAX_PERIODS; i++)
+    {
+        while (u < sc->n && memcmp(&periods[i], &sc->timing[u], sizeof(periods[i])) != 0)
+        {
+            u++;
+        }
+        bad += u == sc->n;
+    }
+    if (bad)
+    {
+        fprintf(stderr, "  %s: %zu periods out of place\n", name, bad);
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(u, sc->n - 1u);
+}
+
+static void test_mock(void)
+{
+    scenario_t sc;
+
+    // One timing, repeated by the program on its own
+    memset(&sc, 0, sizeof(sc));
+    add(&sc, 40, 12, 0);
+    sc.cycles = 2000;
+    check(&sc, "steady");
+    CHECK_EQ(sh_measure(mock_pin, sc.cycles, NULL, 0), (2000u - 5u) / 40u);
+
+    // The shortest phases the program allows
+    memset(&sc, 0, sizeof(sc));
+    add(&sc, SH_HIGH_OVERHEAD + SH_LOW_OVERHEAD, SH_HIGH_OVERHEAD, 0);
+    add(&sc, 50, 25, 300);
+    sc.cycles = 1000;
+    check(&sc, "shortest");
+
+    // An update written at every cycle of a period, in the high phase, the low phase and
+    // right at the boundary
+    for (uint32_t at = 200; at < 260; at++)
+    {
+        memset(&sc, 0, sizeof(sc));
+        add(&sc, 60, 20, 0);
+        add(&sc, 33, 9, at);
+        sc.cycles = 600;
+        check(&sc, "boundary");
+    }
+
+    // Pairs back to back: the FIFO holds two, the third waits for room
+    memset(&sc, 0, sizeof(sc));
+    add(&sc, 100, 30, 0);
+    add(&sc, 80, 40, 150);
+    add(&sc, 90, 11, 150);
+    add(&sc, 70, 35, 150);
+    add(&sc, 120, 60, 150);
+    sc.cycles = 1500;
+    check(&sc, "back to back");
+
+    // Random updates
+    for (int run = 0; run < 40; run++)
+    {
+        memset(&sc, 0, sizeof(sc));
+        uint32_t t = 0;
+        for (size_t i = 0; i < MAX_UPDATES; i++)
+        {
+            uint32_t period = 11u + (uint32_t)rand() % 400u;
+            uint32_t high = SH_HIGH_OVERHEAD + (uint32_t)rand() % (period - SH_HIGH_OVERHEAD - SH_LOW_OVERHEAD + 1u);
+            // Distinct from the previous update, so that each one shows in the trace
+            if (sc.n && sc.timing[sc.n - 1u].period_cycles == period)
+            {
+                period++;
+            }
+            add(&sc, period, high, t);
+            t += (uint32_t)rand() % 1200u;
+        }
+        sc.cycles = t + 2000u;
+        check(&sc, "random");
+    }
+}
+
+static void test_period_map(void)
+{
+    // The Sample_Hold range: 10 us to 40.96 ms
+    CHECK_EQ(sh_period_ns(SH_MIN_PERIOD_NS, SH_OCTAVES, 0), 10000u);
+    CHECK_EQ(sh_period_ns(SH_MIN_PERIOD_NS, SH_OCTAVES, SH_ADC_MAX), 40960000u);
+    CHECK_EQ(sh_period_ns(SH_MIN_PERIOD_NS, SH_OCTAVES, 65535u), 40960000u);
+
+    static const uint32_t mins[] = {1000u, 10000u, 123457u};
+    for (size_t m = 0; m < sizeof(mins) / sizeof(mins[0]); m++)
+    {
+        for (uint32_t oct = 1; oct <= 20u; oct++)
+        {
+            uint32_t prev = 0;
+            double worst = 0.0;
+            size_t bad = 0;
+            for (uint16_t r = 0; r <= SH_ADC_MAX; r++)
+            {
+                uint32_t p = sh_period_ns(mins[m], oct, r);
+                bad += p < prev;
+                prev = p;
+                double exact = mins[m] * exp2((double)oct * r / SH_ADC_MAX);
+                if (exact < UINT32_MAX)
+                {
+                    double e = fabs(p - exact) / exact;
+                    worst = e > worst ? e : worst;
+                }
+                else
+                {
+                    bad += p != UINT32_MAX;
+                }
+            }
+            CHECK_EQ(bad, 0);
+            CHECK(worst < 0.0005 + 0.5 / mins[m]);
+        }
+    }
+}
+
+static void test_timing(void)
+{
+    sh_timing_t t;
+
+    // 100 kHz at 125 MHz: 1250 cycles, a 100 us pulse clamped to half the period
+    CHECK_EQ(sh_timing(&t, 125000000u, 10000u, 100000u), 0);
+    CHECK_EQ(t.period_cycles, 1250);
+    CHECK_EQ(t.high_cycles, 625);
+    CHECK_EQ(sh_high_word(&t), 625 - SH_HIGH_OVERHEAD);
+    CHECK_EQ(sh_low_word(&t), 625 - SH_LOW_OVERHEAD);
+
+    // 24 Hz: the pulse keeps its width
+    CHECK_EQ(sh_timing(&t, 125000000u, 40960000u, 100000u), 0);
+    CHECK_EQ(t.period_cycles, 5120000);
+    CHECK_EQ(t.high_cycles, 12500);
+
+    // Rounded to the nearest cycle
+    CHECK_EQ(sh_timing(&t, 125000000u, 1003u, 203u), 0);
+    CHECK_EQ(t.period_cycles, 125);
+    CHECK_EQ(t.high_cycles, 25);
+    CHECK_EQ(sh_timing(&t, 125000000u, 1004u, 205u), 0);
+    CHECK_EQ(t.period_cycles, 126);
+    CHECK_EQ(t.high_cycles, 26);
+
+    // The shortest phases
+    CHECK_EQ(sh_timing(&t, 125000000u, 88u, 0u), 0);
+    CHECK_EQ(t.period_cycles, 11);
+    CHECK_EQ(t.high_cycles, SH_HIGH_OVERHEAD);
+    CHECK_EQ(sh_low_word(&t), 0);
+    CHECK_EQ(sh_timing(&t, 125000000u, 80u, 0u), SH_ERR_RANGE);
+    CHECK_EQ(sh_timing(&t, 125000000u, 0u, 0u), SH_ERR_RANGE);
+
+    // 32-bit counts: the longest period_ns fits at 125 MHz, not at a (fictitious) 2 GHz
+    CHECK_EQ(sh_timing(&t, 125000000u, UINT32_MAX, 100000u), 0);
+    CHECK_EQ(t.period_cycles, 536870912);
+    CHECK_EQ(sh_timing(&t, 2000000000u, UINT32_MAX, 100000u), SH_ERR_RANGE);
+
+    // A timing from sh_timing() gives exactly that period on the mock
+    static uint32_t words[2], ready[1];
+    CHECK_EQ(sh_timing(&t, 125000000u, 2000u, 500u), 0);
+    words[0] = sh_high_word(&t);
+    words[1] = sh_low_word(&t);
+    sh_mock_run(words, ready, 1, mock_pin, 2000);
+    sh_timing_t got[8];
+    CHECK(sh_measure(mock_pin, 2000, got, 8) >= 7u);
+    CHECK_EQ(got[3].period_cycles, 250);
+    CHECK_EQ(got[3].high_cycles, 63); // 62.5 rounded up
+}
+
+static void test_knob(void)
+{
+    sh_knob_t k;
+
+    // The first reading sets the output at once
+    sh_knob_init(&k, 3, 24);
+    CHECK(sh_knob_update(&k, 1000));
+    CHECK_EQ(k.held, 1000);
+    CHECK_EQ(k.value, 1000);
+
+    // At rest with +-16 counts of noise: the output never moves
+    size_t changes = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        changes += sh_knob_update(&k, (uint16_t)(1000 + rand() % 33 - 16));
+    }
+    CHECK_EQ(changes, 0);
+    CHECK_EQ(k.held, 1000);
+
+    // A step: the output follows the low-pass once it has moved past the band, and
+    // settles within the band of the new reading
+    changes = 0;
+    int first = -1;
+    for (int i = 0; i < 100; i++)
+    {
+        if (sh_knob_update(&k, 1500))
+        {
+            changes++;
+            first = first < 0 ? i : first;
+        }
+    }
+    CHECK(changes >= 1u && changes <= 500u / 25u); // Each change moves it past the band
+    CHECK_EQ(first, 0); // 500 / 8 = 62 counts after one reading, past the band
+    CHECK(abs((int)k.held - 1500) <= 24);
+    CHECK_EQ(k.value, 1500);
+
+    // A slow ramp up and down reaches both ends exactly; the output moves in steps
+    // larger than the band in between
+    sh_knob_init(&k, 3, 24);
+    bool bottom = false, top = false;
+    size_t small = 0;
+    uint16_t held = 0;
+    for (int i = 0; i < 3 * 8192; i++)
+    {
+        int phase = i % 8192;
+        uint16_t raw = (uint16_t)(phase < 4096 ? phase : 8191 - phase);
+        if (sh_knob_update(&k, raw) && i > 0)
+        {
+            uint16_t step = (uint16_t)abs((int)k.held - (int)held);
+            small += step <= 24u && k.held != 0 && k.held != SH_ADC_MAX;
+        }
+        held = k.held;
+        top |= k.held == SH_ADC_MAX;
+        bottom |= top && k.held == 0;
+    }
+    CHECK(top);
+    CHECK(bottom);
+    CHECK_EQ(small, 0);
+
+    // Readings past the ADC range are clamped; shift 0 is no filtering
+    sh_knob_init(&k, 0, 0);
+    sh_knob_update(&k, 9000);
+    CHECK_EQ(k.held, SH_ADC_MAX);
+    CHECK(sh_knob_update(&k, 7));
+    CHECK_EQ(k.held, 7);
+}
+
+int main(void)
+{
+    srand(20);
+
+    if (pio_sim_load(&prog, SH_PULSE_PIO_PATH, "sh_pulse") != 0)
+    {
+        fprintf(stderr, "cannot load %s\n", SH_PULSE_PIO_PATH);
+        return 1;
+    }
+
+    test_mock();
+    test_period_map();
+    test_timing();
+    test_knob();
+
+    return host_test_result("sh_model");
+}
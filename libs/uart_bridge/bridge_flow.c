@@ -0,0 +1,76 @@
+/**
+ * @file bridge_flow.c
+ * @brief Flow control of one direction of a UART bridge: RX ring, TX spans and counters.
+ */
+
+#include "bridge_flow.h"
+
+void bridge_flow_init(bridge_flow_t *f, uint8_t *storage, uint32_t capacity)
+{
+    byte_ring_init(&f->ring, storage, capacity);
+    f->tx_max = capacity / 4u;
+    f->tx_len = 0;
+    f->rx_stalled = false;
+    f->stats = (bridge_counters_t){0};
+}
+
+void bridge_flow_rx_commit(bridge_flow_t *f, uint32_t n)
+{
+    byte_ring_commit(&f->ring, n);
+    f->stats.rx_bytes += n;
+}
+
+void bridge_flow_rx_status(bridge_flow_t *f, uint32_t dr)
+{
+    if (dr & BRIDGE_DR_OE)
+    {
+        f->stats.overruns++;
+    }
+    if (dr & (BRIDGE_DR_FE | BRIDGE_DR_PE | BRIDGE_DR_BE))
+    {
+        f->stats.errors++;
+    }
+}
+
+void bridge_flow_rx_stall(bridge_flow_t *f)
+{
+    if (!f->rx_stalled)
+    {
+        f->rx_stalled = true;
+        f->stats.stalls++;
+    }
+}
+
+const uint8_t *bridge_flow_tx_begin(bridge_flow_t *f, uint32_t *len)
+{
+    uint32_t avail = 0;
+    const uint8_t *span = NULL;
+
+    if (f->tx_len == 0)
+    {
+        span = byte_ring_read_span(&f->ring, &avail);
+    }
+    // Short transfers hand space back to the RX side sooner.
+    if (avail > f->tx_max)
+    {
+        avail = f->tx_max;
+    }
+    if (avail)
+    {
+        f->tx_len = avail;
+        f->stats.tx_transfers++;
+    }
+    *len = avail;
+    return span;
+}
+
+bool bridge_flow_tx_end(bridge_flow_t *f)
+{
+    byte_ring_consume(&f->ring, f->tx_len);
+    f->stats.tx_bytes += f->tx_len;
+    f->tx_len = 0;
+
+    bool resume = f->rx_stalled;
+    f->rx_stalled = false;
+    return resume;
+}
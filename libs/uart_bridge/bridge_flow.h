@@ -0,0 +1,121 @@
+/**
+ * @file bridge_flow.h
+ * @brief Flow control of one direction of a UART bridge: RX ring, TX spans and counters.
+ *
+ * @details
+ * One direction of the bridge moves bytes received on one UART out of the other one. The RX
+ * interrupt reads the hardware FIFO straight into the free span of a byte_ring_t, and the
+ * TX side hands the readable span to a DMA channel, so every byte is copied once, from the
+ * RX data register into the ring, and read once by the DMA.
+ *
+ * When the ring is full the RX interrupt is masked (bridge_flow_rx_stall()) and the bytes
+ * wait in the 32-byte hardware FIFO; bridge_flow_tx_end() reports when a finished transfer
+ * has made room so the interrupt can be unmasked. If the far side keeps sending while RX is
+ * masked the hardware FIFO overruns, and the UART reports it with the OE flag, which
+ * bridge_flow_rx_status() counts.
+ *
+ * Each DMA interrupt starts one transfer of at most a quarter of the ring, so at equal baud
+ * rates a direction keeps up only while the interrupt latency, in characters, is no longer
+ * than tx_max (and than the 32-byte FIFO).
+ *
+ * The RX side (producer) runs in the UART interrupt and the TX side (consumer) in the DMA
+ * interrupt. Both must run at the same priority on the same core, so that neither preempts
+ * the other while it updates tx_len or rx_stalled; the ring itself is lock-free.
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef BRIDGE_FLOW_H
+#define BRIDGE_FLOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "byte_ring.h"
+
+// Status bits of a UART data register read (PL011 UARTDR layout)
+#define BRIDGE_DR_FE (1u << 8)  ///< Framing error.
+#define BRIDGE_DR_PE (1u << 9)  ///< Parity error.
+#define BRIDGE_DR_BE (1u << 10) ///< Break.
+#define BRIDGE_DR_OE (1u << 11) ///< Overrun: the FIFO was full and a byte was lost.
+
+typedef struct bridge_counters
+{
+    uint32_t rx_bytes;     ///< Bytes stored in the ring.
+    uint32_t tx_bytes;     ///< Bytes sent by finished DMA transfers.
+    uint32_t tx_transfers; ///< DMA transfers started.
+    uint32_t overruns;     ///< Hardware RX FIFO overruns (bytes lost before the ring).
+    uint32_t errors;       ///< Framing, parity and break errors.
+    uint32_t stalls;       ///< Times RX was paused because the ring was full.
+} bridge_counters_t;
+
+typedef struct bridge_flow
+{
+    byte_ring_t ring;        ///< Bytes received and not yet sent.
+    uint32_t tx_max;         ///< Longest DMA transfer, a quarter of the ring.
+    uint32_t tx_len;         ///< Length of the transfer in flight, 0 when TX is idle.
+    bool rx_stalled;         ///< RX interrupt masked until the ring has room.
+    bridge_counters_t stats; ///< Counters of this direction.
+} bridge_flow_t;
+
+/**
+ * @brief Initializes a direction with an empty ring and zeroed counters.
+ *
+ * @param f Pointer to the direction.
+ * @param storage Ring storage for capacity bytes.
+ * @param capacity Ring size in bytes, a power of two of at least 4.
+ */
+void bridge_flow_init(bridge_flow_t *f, uint8_t *storage, uint32_t capacity);
+
+/**
+ * @brief RX side: where to store received bytes.
+ *
+ * @param f Pointer to the direction.
+ * @param len Output, bytes that can be stored at the returned address (0 if the ring is full).
+ * @return uint8_t* Where to store them.
+ */
+static inline uint8_t *bridge_flow_rx_span(bridge_flow_t *f, uint32_t *len)
+{
+    return byte_ring_write_span(&f->ring, len);
+}
+
+/**
+ * @brief RX side: publishes n bytes stored in the span.
+ */
+void bridge_flow_rx_commit(bridge_flow_t *f, uint32_t n);
+
+/**
+ * @brief RX side: counts the error flags of a data register read.
+ *
+ * @param f Pointer to the direction.
+ * @param dr Value read from the data register (status bits BRIDGE_DR_*).
+ */
+void bridge_flow_rx_status(bridge_flow_t *f, uint32_t dr);
+
+/**
+ * @brief RX side: records that RX is paused because the ring is full.
+ *
+ * The caller masks the RX interrupts; bridge_flow_tx_end() says when to unmask them.
+ */
+void bridge_flow_rx_stall(bridge_flow_t *f);
+
+/**
+ * @brief TX side: the next span to send, if TX is idle and bytes are waiting.
+ *
+ * On success the span is in flight until bridge_flow_tx_end().
+ *
+ * @param f Pointer to the direction.
+ * @param len Output, bytes to send (0 when there is nothing to start).
+ * @return const uint8_t* Start of the span.
+ */
+const uint8_t *bridge_flow_tx_begin(bridge_flow_t *f, uint32_t *len);
+
+/**
+ * @brief TX side: hands the bytes of the finished transfer back to the ring.
+ *
+ * @param f Pointer to the direction.
+ * @return true RX was stalled and now has room: unmask its interrupts.
+ * @return false Nothing to resume.
+ */
+bool bridge_flow_tx_end(bridge_flow_t *f);
+
+#endif // BRIDGE_FLOW_H
@@ -0,0 +1,199 @@
+/**
+ * @file bridge_sim.c
+ * @brief Character-time model of one bridge direction, for running the flow logic on a host.
+ */
+
+#include "bridge_sim.h"
+
+/// Byte n of the test sequence; not a power-of-two period, so lost bytes always show.
+static inline uint8_t sim_byte(uint32_t n)
+{
+    return (uint8_t)(n % 251u);
+}
+
+typedef struct sim_fifo
+{
+    uint16_t data[BRIDGE_SIM_FIFO_DEPTH]; ///< Byte plus BRIDGE_DR_* status bits.
+    uint32_t head;                        ///< Entries written.
+    uint32_t tail;                        ///< Entries read.
+} sim_fifo_t;
+
+static inline uint32_t fifo_count(const sim_fifo_t *q)
+{
+    return q->head - q->tail;
+}
+
+static inline void fifo_push(sim_fifo_t *q, uint16_t v)
+{
+    q->data[q->head++ % BRIDGE_SIM_FIFO_DEPTH] = v;
+}
+
+static inline uint16_t fifo_pop(sim_fifo_t *q)
+{
+    return q->data[q->tail++ % BRIDGE_SIM_FIFO_DEPTH];
+}
+
+typedef struct sim_state
+{
+    bridge_flow_t flow;   ///< Direction under test.
+    sim_fifo_t rx;        ///< RX FIFO of the input UART.
+    sim_fifo_t tx;        ///< TX FIFO of the output UART.
+    bool rx_masked;       ///< RX and RT interrupts masked.
+    uint32_t idle;        ///< Characters since the last byte arrived.
+    const uint8_t *dma;   ///< DMA read address.
+    uint32_t dma_left;    ///< DMA transfers left.
+    bool dma_irq;         ///< DMA completion interrupt pending.
+} sim_state_t;
+
+static void sim_tx_kick(sim_state_t *s)
+{
+    uint32_t len;
+    const uint8_t *span = bridge_flow_tx_begin(&s->flow, &len);
+    if (len)
+    {
+        s->dma = span;
+        s->dma_left = len;
+    }
+}
+
+/// Same steps as the UART interrupt handler in uart_bridge.c.
+static void sim_rx_irq(sim_state_t *s)
+{
+    while (fifo_count(&s->rx))
+    {
+        uint32_t space;
+        uint8_t *dst = bridge_flow_rx_span(&s->flow, &space);
+        if (space == 0)
+        {
+            bridge_flow_rx_stall(&s->flow);
+            s->rx_masked = true;
+            break;
+        }
+        uint32_t n = 0;
+        while (n < space && fifo_count(&s->rx))
+        {
+            uint16_t dr = fifo_pop(&s->rx);
+            if (dr & 0xF00u)
+            {
+                bridge_flow_rx_status(&s->flow, dr);
+            }
+            dst[n++] = (uint8_t)dr;
+        }
+        bridge_flow_rx_commit(&s->flow, n);
+    }
+    sim_tx_kick(s);
+}
+
+/// Same steps as the DMA interrupt handler in uart_bridge.c.
+static void sim_dma_irq(sim_state_t *s)
+{
+    if (bridge_flow_tx_end(&s->flow))
+    {
+        s->rx_masked = false;
+    }
+    sim_tx_kick(s);
+}
+
+void bridge_sim_run(const bridge_sim_config_t *cfg, uint8_t *storage, bridge_sim_result_t *res)
+{
+    sim_state_t s = {0};
+    uint32_t period = cfg->service_period ? cfg->service_period : 1u;
+    uint32_t tx_steps = cfg->tx_char_steps ? cfg->tx_char_steps : 1u;
+    uint32_t sent = 0;
+    uint32_t tx_phase = 0;
+    uint32_t expect = 0;
+
+    bridge_flow_init(&s.flow, storage, cfg->ring_capacity);
+    s.idle = BRIDGE_SIM_TIMEOUT_STEPS;
+    *res = (bridge_sim_result_t){0};
+
+    for (uint32_t step = 0;; step++)
+    {
+        // Far side: one byte per character, lost if the FIFO is full (PL011 sets OE on the
+        // last entry, which is read normally).
+        if (sent < cfg->n_bytes)
+        {
+            if (fifo_count(&s.rx) < BRIDGE_SIM_FIFO_DEPTH)
+            {
+                fifo_push(&s.rx, sim_byte(sent));
+            }
+            else
+            {
+                s.rx.data[(s.rx.head - 1u) % BRIDGE_SIM_FIFO_DEPTH] |= BRIDGE_DR_OE;
+                res->lost++;
+            }
+            sent++;
+            s.idle = 0;
+        }
+        else if (s.idle < BRIDGE_SIM_TIMEOUT_STEPS)
+        {
+            s.idle++;
+        }
+
+        // Output line: one byte every tx_steps characters.
+        if (++tx_phase >= tx_steps)
+        {
+            tx_phase = 0;
+            if (fifo_count(&s.tx))
+            {
+                uint8_t b = (uint8_t)fifo_pop(&s.tx);
+                // Resynchronise on the byte shifted out, so a run of losses counts once.
+                if (b != sim_byte(expect))
+                {
+                    res->mismatches++;
+                    while (b != sim_byte(expect))
+                    {
+                        expect++;
+                    }
+                }
+                expect++;
+                res->delivered++;
+            }
+        }
+
+        // DMA is much faster than the line: it fills the TX FIFO within the step.
+        while (s.dma_left && fifo_count(&s.tx) < BRIDGE_SIM_FIFO_DEPTH)
+        {
+            fifo_push(&s.tx, *s.dma++);
+            if (--s.dma_left == 0)
+            {
+                s.dma_irq = true;
+            }
+        }
+
+        uint32_t fill = byte_ring_count(&s.flow.ring);
+        if (fill > res->max_fill)
+        {
+            res->max_fill = fill;
+        }
+
+        // CPU: take the pending interrupts, DMA first (lower IRQ number).
+        if (step % period == 0)
+        {
+            if (s.dma_irq)
+            {
+                s.dma_irq = false;
+                sim_dma_irq(&s);
+            }
+            uint32_t level = fifo_count(&s.rx);
+            bool rx_irq = level >= BRIDGE_SIM_RX_LEVEL || (level && s.idle >= BRIDGE_SIM_TIMEOUT_STEPS);
+            if (rx_irq && !s.rx_masked)
+            {
+                sim_rx_irq(&s);
+            }
+        }
+
+        if (sent == cfg->n_bytes && res->delivered + res->lost >= cfg->n_bytes)
+        {
+            res->steps = step + 1u;
+            break;
+        }
+        // A stuck direction would never deliver everything; give up well after the end.
+        if (step > 4u * (cfg->n_bytes + cfg->ring_capacity) * tx_steps + 1000u)
+        {
+            res->steps = step + 1u;
+            break;
+        }
+    }
+    res->stats = s.flow.stats;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file bridge_sim.h
+ * @brief Character-time model of one bridge direction, for running the flow logic on a host.
+ *
+ * @details
+ * The model steps in character times (10 bit periods at 8N1). Each step the far side puts
+ * the next byte of a known sequence into a 32-byte RX FIFO, the TX FIFO on the other UART
+ * shifts one byte out, and a modelled DMA channel refills the TX FIFO from the span handed
+ * over by bridge_flow_tx_begin(). The RX interrupt fires like the PL011's: at a FIFO level
+ * of 16 (half full) or after a receive timeout once the line is idle with bytes waiting.
+ *
+ * The CPU only takes interrupts every service_period characters, which stands in for
+ * interrupt latency and time spent in other handlers. The interrupt handlers make the same
+ * bridge_flow_* calls, in the same order, as uart_bridge.c, and every byte shifted out is
+ * compared with the sequence sent, so a run shows whether the direction keeps up without
+ * drops at a given ring size and latency, and how backpressure behaves when the output
+ * side is slower (tx_char_steps > 1).
+ *
+ * This file has no dependency on the Pico SDK.
+ */
+
+#ifndef BRIDGE_SIM_H
+#define BRIDGE_SIM_H
+
+#include <stdint.h>
+#include "bridge_flow.h"
+
+#define BRIDGE_SIM_FIFO_DEPTH 32u    ///< PL011 FIFO depth.
+#define BRIDGE_SIM_RX_LEVEL 16u      ///< RX interrupt level (FIFO half full).
+#define BRIDGE_SIM_TIMEOUT_STEPS 4u  ///< Receive timeout: 32 bit periods, rounded up to characters.
+
+typedef struct bridge_sim_config
+{
+    uint32_t n_bytes;         ///< Bytes sent by the far side, back to back.
+    uint32_t ring_capacity;   ///< Ring size, a power of two.
+    uint32_t service_period;  ///< Characters between two chances to run an interrupt (>= 1).
+    uint32_t tx_char_steps;   ///< Characters per byte on the output line (1 = same baud rate).
+} bridge_sim_config_t;
+
+typedef struct bridge_sim_result
+{
+    bridge_counters_t stats; ///< Counters of the direction at the end of the run.
+    uint32_t delivered;      ///< Bytes shifted out of the output UART.
+    uint32_t mismatches;     ///< Gaps in the output sequence (a run of lost bytes counts once).
+    uint32_t lost;           ///< Bytes dropped by the RX FIFO model.
+    uint32_t max_fill;       ///< Highest ring occupancy seen.
+    uint32_t steps;          ///< Characters simulated until the output went idle.
+} bridge_sim_result_t;
+
+/**
+ * @brief Runs one direction until every byte is delivered or lost.
+ *
+ * @param cfg Traffic, ring size and timing.
+ * @param storage Ring storage for cfg->ring_capacity bytes.
+ * @param res Output result.
+ */
+void bridge_sim_run(const bridge_sim_config_t *cfg, uint8_t *storage, bridge_sim_result_t *res);
+
+#endif // BRIDGE_SIM_H
@@ -0,0 +1,54 @@
+/**
+ * @file byte_ring.c
+ * @brief Lock-free single-producer/single-consumer byte ring with contiguous spans.
+ */
+
+#include "byte_ring.h"
+
+void byte_ring_init(byte_ring_t *ring, uint8_t *storage, uint32_t capacity)
+{
+    ring->data = storage;
+    ring->mask = capacity - 1u;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+uint8_t *byte_ring_write_span(byte_ring_t *ring, uint32_t *len)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t offset = head & ring->mask;
+    uint32_t free = ring->mask + 1u - (head - tail);
+    uint32_t to_end = ring->mask + 1u - offset;
+
+    *len = (free < to_end) ? free : to_end;
+    return ring->data + offset;
+}
+
+void byte_ring_commit(byte_ring_t *ring, uint32_t n)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // The bytes must be visible before the consumer sees the new head.
+    atomic_store_explicit(&ring->head, head + n, memory_order_release);
+}
+
+const uint8_t *byte_ring_read_span(byte_ring_t *ring, uint32_t *len)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t offset = tail & ring->mask;
+    uint32_t avail = head - tail;
+    uint32_t to_end = ring->mask + 1u - offset;
+
+    *len = (avail < to_end) ? avail : to_end;
+    return ring->data + offset;
+}
+
+void byte_ring_consume(byte_ring_t *ring, uint32_t n)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Only hand the bytes back to the producer once they have been read.
+    atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+}
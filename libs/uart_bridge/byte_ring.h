@@ -0,0 +1,84 @@
+/**
+ * @file byte_ring.h
+ * @brief Lock-free single-producer/single-consumer byte ring with contiguous spans.
+ *
+ * @details
+ * Same ownership rules as spsc_ring.h: the producer owns `head`, the consumer owns `tail`,
+ * and each publishes its index with a release store. Instead of copying bytes in and out,
+ * both sides work on contiguous spans of the storage: the producer writes straight into the
+ * free span and commits, the consumer hands the readable span to a DMA channel and consumes
+ * it when the transfer is done. A span never wraps, so a full ring may take two spans.
+ *
+ * The capacity must be a power of two. This file has no dependency on the Pico SDK.
+ */
+
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+typedef struct byte_ring
+{
+    uint8_t *data;         ///< Caller-provided storage.
+    uint32_t mask;         ///< Capacity - 1.
+    _Atomic uint32_t head; ///< Bytes written since init, owned by the producer.
+    _Atomic uint32_t tail; ///< Bytes read since init, owned by the consumer.
+} byte_ring_t;
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * @param ring Pointer to the ring.
+ * @param storage Storage for capacity bytes.
+ * @param capacity Number of bytes, a power of two.
+ */
+void byte_ring_init(byte_ring_t *ring, uint8_t *storage, uint32_t capacity);
+
+/**
+ * @brief Number of bytes waiting. Exact only when called from one of the two sides.
+ */
+static inline uint32_t byte_ring_count(byte_ring_t *ring)
+{
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+/**
+ * @brief Free bytes. Exact only when called from one of the two sides.
+ */
+static inline uint32_t byte_ring_space(byte_ring_t *ring)
+{
+    return ring->mask + 1u - byte_ring_count(ring);
+}
+
+/**
+ * @brief Producer side: the free span starting at the write position.
+ *
+ * @param ring Pointer to the ring.
+ * @param len Output, bytes that can be written at the returned address.
+ * @return uint8_t* Where to write.
+ */
+uint8_t *byte_ring_write_span(byte_ring_t *ring, uint32_t *len);
+
+/**
+ * @brief Producer side: publishes n bytes written into the span.
+ */
+void byte_ring_commit(byte_ring_t *ring, uint32_t n);
+
+/**
+ * @brief Consumer side: the readable span starting at the read position.
+ *
+ * @param ring Pointer to the ring.
+ * @param len Output, bytes readable at the returned address.
+ * @return const uint8_t* Where to read.
+ */
+const uint8_t *byte_ring_read_span(byte_ring_t *ring, uint32_t *len);
+
+/**
+ * @brief Consumer side: hands n read bytes back to the producer.
+ */
+void byte_ring_consume(byte_ring_t *ring, uint32_t n);
+
+#endif // BYTE_RING_H
@@ -0,0 +1,263 @@
+/**
+ * @file test_bridge_flow.c
+ * @brief Byte ring, bridge flow control and the character-time model of a bridge direction.
+ *
+ * @details
+ * byte_ring_t is driven with random span sizes through many wraps and every byte read back
+ * is checked. bridge_flow_t is checked call by call: transfer lengths, one transfer at a
+ * time, stall and resume, error counting.
+ *
+ * bridge_sim_run() then plays whole directions through the simulated UART FIFOs, interrupt
+ * level and timeout, DMA and interrupt latency:
+ *
+ * - Same baud rate, ring sizes from 64 bytes and interrupt latencies up to 31 characters:
+ *   every byte arrives in order, nothing stalls or overruns, as long as the latency is at
+ *   most a quarter of the ring (one DMA transfer). A 64-byte ring falls behind beyond 16.
+ * - Latency longer than the 32-byte FIFO: bytes are lost, and each run of lost bytes shows
+ *   as one gap in the output and one OE flag.
+ * - A slower output line: a burst that fits the ring and the FIFO stalls RX but loses
+ *   nothing; a longer one overruns.
+ * - A burst shorter than the interrupt level is picked up by the receive timeout.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "byte_ring.h"
+#include "bridge_flow.h"
+#include "bridge_sim.h"
+
+#define MAX_RING 4096u
+
+static uint8_t storage[MAX_RING];
+
+static void test_byte_ring(void)
+{
+    static const uint32_t capacities[] = {4u, 16u, 256u};
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++)
+    {
+        uint32_t cap = capacities[c];
+        byte_ring_t ring;
+        byte_ring_init(&ring, storage, cap);
+        CHECK_EQ(byte_ring_count(&ring), 0);
+        CHECK_EQ(byte_ring_space(&ring), cap);
+
+        uint32_t written = 0;
+        uint32_t read = 0;
+        size_t bad = 0;
+        for (int i = 0; i < 20000; i++)
+        {
+            uint32_t len;
+            if (rand() & 1)
+            {
+                uint8_t *dst = byte_ring_write_span(&ring, &len);
+                CHECK(len <= byte_ring_space(&ring));
+                CHECK(dst + len <= storage + cap);
+                uint32_t n = len ? (uint32_t)rand() % (len + 1u) : 0u;
+                for (uint32_t k = 0; k < n; k++)
+                {
+                    dst[k] = (uint8_t)(written + k);
+                }
+                byte_ring_commit(&ring, n);
+                written += n;
+            }
+            else
+            {
+                const uint8_t *src = byte_ring_read_span(&ring, &len);
+                CHECK(len <= byte_ring_count(&ring));
+                CHECK(src + len <= storage + cap);
+                uint32_t n = len ? (uint32_t)rand() % (len + 1u) : 0u;
+                for (uint32_t k = 0; k < n; k++)
+                {
+                    bad += src[k] != (uint8_t)(read + k);
+                }
+                byte_ring_consume(&ring, n);
+                read += n;
+            }
+            CHECK_EQ(byte_ring_count(&ring), written - read);
+            CHECK_EQ(byte_ring_count(&ring) + byte_ring_space(&ring), cap);
+        }
+        CHECK_EQ(bad, 0);
+        CHECK(written > 10u * cap);
+
+        // A full ring has no write span; an empty one no read span
+        uint32_t len;
+        byte_ring_init(&ring, storage, cap);
+        byte_ring_write_span(&ring, &len);
+        CHECK_EQ(len, cap);
+        byte_ring_commit(&ring, cap);
+        byte_ring_write_span(&ring, &len);
+        CHECK_EQ(len, 0);
+        byte_ring_consume(&ring, cap);
+        byte_ring_read_span(&ring, &len);
+        CHECK_EQ(len, 0);
+
+        // Spans stop at the end of the storage
+        byte_ring_commit(&ring, cap - 1u);
+        byte_ring_consume(&ring, cap - 1u);
+        byte_ring_write_span(&ring, &len);
+        CHECK_EQ(len, 1);
+        byte_ring_commit(&ring, 1);
+        byte_ring_write_span(&ring, &len);
+        CHECK_EQ(len, cap - 1u);
+    }
+}
+
+static void test_flow(void)
+{
+    bridge_flow_t f;
+    uint32_t len;
+    bridge_flow_init(&f, storage, 64);
+    CHECK_EQ(f.tx_max, 16);
+
+    // Nothing to send
+    CHECK(bridge_flow_tx_begin(&f, &len) == NULL || len == 0);
+    CHECK_EQ(len, 0);
+    CHECK_EQ(f.stats.tx_transfers, 0);
+
+    // 40 bytes go out as transfers of at most a quarter of the ring, one at a time
+    uint8_t *dst = bridge_flow_rx_span(&f, &len);
+    CHECK_EQ(len, 64);
+    memset(dst, 0x55, 40);
+    bridge_flow_rx_commit(&f, 40);
+    CHECK_EQ(f.stats.rx_bytes, 40);
+    const uint8_t *src = bridge_flow_tx_begin(&f, &len);
+    CHECK(src == storage);
+    CHECK_EQ(len, 16);
+    bridge_flow_tx_begin(&f, &len);
+    CHECK_EQ(len, 0); // Still in flight
+    CHECK(!bridge_flow_tx_end(&f));
+    CHECK_EQ(f.stats.tx_bytes, 16);
+    bridge_flow_tx_begin(&f, &len);
+    CHECK_EQ(len, 16);
+    bridge_flow_tx_end(&f);
+    bridge_flow_tx_begin(&f, &len);
+    CHECK_EQ(len, 8);
+    bridge_flow_tx_end(&f);
+    CHECK_EQ(f.stats.tx_bytes, 40);
+    CHECK_EQ(f.stats.tx_transfers, 3);
+
+    // Fill the ring: RX stalls once, however often it finds no room, until a transfer ends
+    bridge_flow_rx_span(&f, &len);
+    CHECK_EQ(len, 24); // Up to the end of the storage
+    bridge_flow_rx_commit(&f, 24);
+    bridge_flow_rx_span(&f, &len);
+    CHECK_EQ(len, 40);
+    bridge_flow_rx_commit(&f, 40);
+    bridge_flow_rx_span(&f, &len);
+    CHECK_EQ(len, 0);
+    bridge_flow_rx_stall(&f);
+    bridge_flow_rx_stall(&f);
+    CHECK(f.rx_stalled);
+    CHECK_EQ(f.stats.stalls, 1);
+    bridge_flow_tx_begin(&f, &len);
+    CHECK_EQ(len, 16);
+    CHECK(bridge_flow_tx_end(&f)); // Resume RX
+    CHECK(!f.rx_stalled);
+    bridge_flow_tx_begin(&f, &len);
+    CHECK(!bridge_flow_tx_end(&f));
+
+    // Error flags of the data register
+    bridge_flow_rx_status(&f, BRIDGE_DR_OE | 0x41u);
+    bridge_flow_rx_status(&f, BRIDGE_DR_FE);
+    bridge_flow_rx_status(&f, BRIDGE_DR_PE | BRIDGE_DR_BE);
+    bridge_flow_rx_status(&f, BRIDGE_DR_OE | BRIDGE_DR_BE);
+    CHECK_EQ(f.stats.overruns, 2);
+    CHECK_EQ(f.stats.errors, 3);
+}
+
+/**
+ * @brief Runs one direction and checks the counters that hold in every run.
+ */
+static bridge_sim_result_t run(uint32_t n_bytes, uint32_t capacity, uint32_t service, uint32_t tx_steps)
+{
+    bridge_sim_config_t cfg = {
+        .n_bytes = n_bytes,
+        .ring_capacity = capacity,
+        .service_period = service,
+        .tx_char_steps = tx_steps,
+    };
+    bridge_sim_result_t res;
+    bridge_sim_run(&cfg, storage, &res);
+
+    CHECK_EQ(res.delivered + res.lost, n_bytes);
+    CHECK_EQ(res.stats.rx_bytes, res.delivered);
+    CHECK(res.max_fill <= capacity);
+    CHECK_EQ(res.stats.errors, 0);
+
+    // The last transfer may have left before its DMA interrupt was taken
+    CHECK(res.stats.tx_bytes <= res.delivered && res.delivered - res.stats.tx_bytes <= capacity / 4u);
+
+    // A run of losses at the very end leaves no gap behind it
+    CHECK(res.stats.overruns >= res.mismatches && res.stats.overruns <= res.mismatches + 1u);
+    CHECK(res.lost == 0 || res.stats.overruns > 0);
+    return res;
+}
+
+static void test_sim(void)
+{
+    // The example of the hello_uart README
+    bridge_sim_result_t r = run(100000u, 4096u, 8u, 1u);
+    CHECK_EQ(r.lost, 0);
+    CHECK_EQ(r.mismatches, 0);
+    CHECK_EQ(r.stats.stalls, 0);
+    CHECK(r.steps < 100000u + 64u);
+
+    // Same baud rate: a ring keeps up while the latency is within the FIFO and within one
+    // transfer (a quarter of the ring), since one transfer starts per DMA interrupt.
+    for (uint32_t cap = 64u; cap <= MAX_RING; cap *= 4u)
+    {
+        for (uint32_t service = 1u; service < BRIDGE_SIM_FIFO_DEPTH; service++)
+        {
+            r = run(20000u, cap, service, 1u);
+            if (service <= cap / 4u)
+            {
+                CHECK_EQ(r.lost, 0);
+                CHECK_EQ(r.stats.stalls, 0);
+                CHECK_EQ(r.stats.overruns, 0);
+            }
+            else
+            {
+                CHECK(r.stats.stalls > 0);
+                CHECK(r.lost > 0);
+            }
+        }
+    }
+
+    // Latency past the 32-byte FIFO: bursts of losses, each one gap and one OE
+    for (uint32_t service = BRIDGE_SIM_FIFO_DEPTH + 1u; service <= 40u; service++)
+    {
+        r = run(20000u, 1024u, service, 1u);
+        CHECK(r.lost > 0);
+        CHECK(r.mismatches > 0);
+        CHECK(r.lost >= r.stats.overruns);
+    }
+
+    // Output at half speed: the backlog grows by half the burst. 300 bytes fill the ring,
+    // RX stalls and the FIFO holds the rest until a transfer ends; 800 bytes overrun it.
+    r = run(300u, 128u, 1u, 2u);
+    CHECK(r.stats.stalls > 0);
+    CHECK_EQ(r.lost, 0);
+    CHECK_EQ(r.max_fill, 128);
+    r = run(800u, 128u, 1u, 2u);
+    CHECK(r.stats.stalls > 0);
+    CHECK(r.lost > 0);
+
+    // A burst below the interrupt level goes out after the receive timeout
+    r = run(5u, 256u, 1u, 1u);
+    CHECK_EQ(r.delivered, 5);
+    CHECK_EQ(r.stats.tx_transfers, 1);
+    CHECK(r.steps >= 5u + BRIDGE_SIM_TIMEOUT_STEPS);
+}
+
+int main(void)
+{
+    srand(31);
+
+    test_byte_ring();
+    test_flow();
+    test_sim();
+
+    return host_test_result("bridge_flow");
+}
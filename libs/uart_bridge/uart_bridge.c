@@ -0,0 +1,185 @@
+/**
+ * @file uart_bridge.c
+ * @brief Full-duplex bridge between two UARTs: FIFO interrupts in, ring buffers, DMA out.
+ */
+
+#include "uart_bridge.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define RX_IRQS (UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS) ///< RX level and timeout.
+#define RX_LEVEL_HALF 2u                                           ///< IFLS RX level: 1/2 full.
+#define DR_STATUS (BRIDGE_DR_FE | BRIDGE_DR_PE | BRIDGE_DR_BE | BRIDGE_DR_OE)
+
+static uart_bridge_t *active_bridge = NULL; ///< Bridge serviced by the interrupts.
+static bool dma_irq_installed = false;      ///< The shared DMA_IRQ_0 handler is registered once.
+
+/**
+ * @brief Starts the next DMA transfer of a direction, if it is idle and has bytes waiting.
+ */
+static void uart_bridge_tx_kick(uart_bridge_t *b, uint i)
+{
+    uint32_t len;
+    const uint8_t *span = bridge_flow_tx_begin(&b->dir[i], &len);
+    if (len)
+    {
+        dma_channel_transfer_from_buffer_now(b->dma_chan[i], span, len);
+    }
+}
+
+/**
+ * @brief RX handler of direction i: moves the hardware FIFO into the ring.
+ */
+static void uart_bridge_rx(uart_bridge_t *b, uint i)
+{
+    bridge_flow_t *f = &b->dir[i];
+    uart_hw_t *hw = uart_get_hw(b->uart[i]);
+
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS))
+    {
+        uint32_t space;
+        uint8_t *dst = bridge_flow_rx_span(f, &space);
+        if (space == 0)
+        {
+            // Leave the rest in the FIFO; the DMA handler unmasks RX when there is room.
+            bridge_flow_rx_stall(f);
+            hw_clear_bits(&hw->imsc, RX_IRQS);
+            break;
+        }
+
+        uint32_t n = 0;
+        while (n < space && !(hw->fr & UART_UARTFR_RXFE_BITS))
+        {
+            uint32_t dr = hw->dr;
+            if (dr & DR_STATUS)
+            {
+                bridge_flow_rx_status(f, dr);
+            }
+            dst[n++] = (uint8_t)dr;
+        }
+        bridge_flow_rx_commit(f, n);
+    }
+    uart_bridge_tx_kick(b, i);
+}
+
+/**
+ * @brief UART0_IRQ handler.
+ */
+static void uart_bridge_uart0_irq(void)
+{
+    uart_bridge_t *b = active_bridge;
+    uart_bridge_rx(b, uart_get_index(b->uart[0]) == 0 ? 0 : 1);
+}
+
+/**
+ * @brief UART1_IRQ handler.
+ */
+static void uart_bridge_uart1_irq(void)
+{
+    uart_bridge_t *b = active_bridge;
+    uart_bridge_rx(b, uart_get_index(b->uart[0]) == 1 ? 0 : 1);
+}
+
+/**
+ * @brief DMA_IRQ_0 handler: finishes a transfer, resumes a stalled RX and starts the next span.
+ */
+static void uart_bridge_dma_irq(void)
+{
+    uart_bridge_t *b = active_bridge;
+    if (b == NULL)
+    {
+        return;
+    }
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint ch = b->dma_chan[i];
+        if (dma_channel_get_irq0_status(ch))
+        {
+            dma_channel_acknowledge_irq0(ch);
+            if (bridge_flow_tx_end(&b->dir[i]))
+            {
+                hw_set_bits(&uart_get_hw(b->uart[i])->imsc, RX_IRQS);
+            }
+            uart_bridge_tx_kick(b, i);
+        }
+    }
+}
+
+void uart_bridge_init(uart_bridge_t *b, const uart_bridge_port_t ports[2], uint baud_rate,
+                      uint8_t *storage, uint32_t capacity)
+{
+    for (uint i = 0; i < 2; i++)
+    {
+        uart_inst_t *uart = ports[i].uart;
+        b->uart[i] = uart;
+        b->baud_rate = uart_init(uart, baud_rate);
+        gpio_set_function(ports[i].tx_pin, GPIO_FUNC_UART);
+        gpio_set_function(ports[i].rx_pin, GPIO_FUNC_UART);
+        uart_set_hw_flow(uart, false, false);
+        uart_set_format(uart, 8, 1, UART_PARITY_NONE);
+        uart_set_fifo_enabled(uart, true);
+
+        bridge_flow_init(&b->dir[i], storage + i * capacity, capacity);
+    }
+
+    for (uint i = 0; i < 2; i++)
+    {
+        // Direction i is sent on the other UART.
+        uart_inst_t *out = b->uart[i ^ 1];
+        b->dma_chan[i] = (uint)dma_claim_unused_channel(true);
+
+        dma_channel_config cfg = dma_channel_get_default_config(b->dma_chan[i]);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false); // Always the data register
+        channel_config_set_dreq(&cfg, uart_get_dreq(out, true));
+        dma_channel_configure(b->dma_chan[i], &cfg, &uart_get_hw(out)->dr, NULL, 0, false);
+    }
+}
+
+void uart_bridge_set_tx_sink(uart_bridge_t *b, uint dir, volatile void *dest, uint dreq)
+{
+    uint ch = b->dma_chan[dir];
+    dma_channel_config cfg = dma_get_channel_config(ch);
+    channel_config_set_dreq(&cfg, dreq);
+    dma_channel_set_config(ch, &cfg, false);
+    dma_channel_set_write_addr(ch, dest, false);
+}
+
+void uart_bridge_start(uart_bridge_t *b)
+{
+    active_bridge = b;
+
+    for (uint i = 0; i < 2; i++)
+    {
+        dma_channel_set_irq0_enabled(b->dma_chan[i], true);
+    }
+    if (!dma_irq_installed)
+    {
+        irq_add_shared_handler(DMA_IRQ_0, uart_bridge_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        dma_irq_installed = true;
+    }
+
+    irq_set_exclusive_handler(UART0_IRQ, uart_bridge_uart0_irq);
+    irq_set_exclusive_handler(UART1_IRQ, uart_bridge_uart1_irq);
+    irq_set_enabled(UART0_IRQ, true);
+    irq_set_enabled(UART1_IRQ, true);
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uart_hw_t *hw = uart_get_hw(b->uart[i]);
+        // Interrupt at half full, plus the receive timeout for the end of a burst.
+        hw_write_masked(&hw->ifls, RX_LEVEL_HALF << UART_UARTIFLS_RXIFLSEL_LSB, UART_UARTIFLS_RXIFLSEL_BITS);
+        hw_set_bits(&hw->imsc, RX_IRQS);
+    }
+}
+
+void uart_bridge_get_stats(uart_bridge_t *b, uint dir, bridge_counters_t *out)
+{
+    uint32_t status = save_and_disable_interrupts();
+    *out = b->dir[dir].stats;
+    restore_interrupts(status);
+}
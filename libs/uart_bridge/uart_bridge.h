@@ -0,0 +1,84 @@
+/**
+ * @file uart_bridge.h
+ * @brief Full-duplex bridge between two UARTs: FIFO interrupts in, ring buffers, DMA out.
+ *
+ * @details
+ * Each direction has its own ring (bridge_flow_t). The RX side uses the hardware FIFO with
+ * the interrupt at half full (16 bytes) plus the receive timeout, so the CPU takes one
+ * interrupt per 16 bytes under load, and the tail of a burst is picked up 32 bit periods
+ * after the line goes idle. The handler reads the data register straight into the ring. The
+ * TX side hands the waiting bytes to a DMA channel paced by the other UART's TX DREQ; the
+ * DMA_IRQ_0 handler returns the bytes to the ring and starts the next span. No byte is
+ * dropped in software: when a ring fills up, its RX interrupt is masked, and bytes wait in
+ * the 32-byte hardware FIFO until a transfer completes. Only when the far side keeps
+ * sending past that does the FIFO overrun, which is counted.
+ *
+ * The UART and DMA handlers run at the same (default) priority, which bridge_flow.h
+ * requires. Only one bridge can be active at a time; it takes the UART0_IRQ and UART1_IRQ
+ * handlers exclusively and shares DMA_IRQ_0.
+ */
+
+#ifndef UART_BRIDGE_H
+#define UART_BRIDGE_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "bridge_flow.h"
+
+typedef struct uart_bridge_port
+{
+    uart_inst_t *uart; ///< UART instance.
+    uint tx_pin;       ///< TX GPIO.
+    uint rx_pin;       ///< RX GPIO.
+} uart_bridge_port_t;
+
+typedef struct uart_bridge
+{
+    uart_inst_t *uart[2]; ///< The two UARTs.
+    uint dma_chan[2];     ///< DMA channel writing to uart[i ^ 1].
+    bridge_flow_t dir[2]; ///< dir[i]: received on uart[i], sent on uart[i ^ 1].
+    uint baud_rate;       ///< Baud rate actually set.
+} uart_bridge_t;
+
+/**
+ * @brief Sets up both UARTs (8N1, FIFOs on, no flow control) and claims two DMA channels.
+ *
+ * @param b Pointer to the bridge.
+ * @param ports The two UARTs and their pins.
+ * @param baud_rate Baud rate of both UARTs.
+ * @param storage Ring storage, 2 * capacity bytes (the first half for bytes received on
+ *                ports[0]).
+ * @param capacity Ring size of each direction, a power of two.
+ */
+void uart_bridge_init(uart_bridge_t *b, const uart_bridge_port_t ports[2], uint baud_rate,
+                      uint8_t *storage, uint32_t capacity);
+
+/**
+ * @brief Sends one direction to another FIFO instead of the other UART's TX.
+ *
+ * For a transmitter the UART cannot drive itself, e.g. the PIO RS485 transmitter
+ * (rs485_tx_fifo(), rs485_tx_dreq()). Call between uart_bridge_init() and
+ * uart_bridge_start().
+ *
+ * @param b Pointer to the bridge.
+ * @param dir 0 for bytes received on ports[0], 1 for ports[1].
+ * @param dest FIFO register written one byte at a time.
+ * @param dreq DREQ pacing the writes.
+ */
+void uart_bridge_set_tx_sink(uart_bridge_t *b, uint dir, volatile void *dest, uint dreq);
+
+/**
+ * @brief Installs the interrupt handlers and starts forwarding.
+ */
+void uart_bridge_start(uart_bridge_t *b);
+
+/**
+ * @brief Copies the counters of one direction, consistent with each other.
+ *
+ * @param b Pointer to the bridge.
+ * @param dir 0 for bytes received on ports[0], 1 for ports[1].
+ * @param out Output counters.
+ */
+void uart_bridge_get_stats(uart_bridge_t *b, uint dir, bridge_counters_t *out);
+
+#endif // UART_BRIDGE_H
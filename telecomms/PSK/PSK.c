@@ -1,14 +1,24 @@
 /**
  * @file PSK.c
- * @brief Generates the carrier signals for Binary Phase Shift Keying (BPSK) modulation.
+ * @brief BPSK/QPSK modulator: switches the carrier phase from a bit stream with PIO.
  *
  * @details
- * This program demonstrates how to generate the two fundamental carrier signals required for BPSK
- * modulation using the RP2040's PWM hardware. It configures two PWM outputs to produce square waves
- * of the same frequency but with a 180-degree phase difference.
+ * The modulator (libs/psk_mod) runs on PIO state machines fed by DMA. Every carrier edge and
+ * every phase switch happens on an exact PIO clock cycle, so the symbol timing has no jitter
+ * from the CPU, and the CPU is free while a buffer is being sent.
  *
- * To create a complete BPSK modulator, you would need to add logic (e.g., using a multiplexer
- * or another GPIO) to switch between these two signals based on a digital data stream (0s and 1s).
+ * - BPSK: one output pin. Bit 0 is sent at 0 degrees, bit 1 at 180 degrees.
+ * - QPSK: an I pin and a Q pin, each a BPSK arm, with Q a quarter period behind I. Summing
+ *   the two pins through equal resistors gives the four phases 45/135/225/315 degrees.
+ *
+ * With CARRIER_SOURCE set to CARRIER_DDS the carrier is instead a sine from the DDS engine
+ * (libs/dds) on a PWM-DAC pin, and the phase of each symbol is applied as a DDS phase offset
+ * once per DMA block, so one block is one symbol. The carrier frequency is then free (sub-Hz
+ * resolution, no integer ratio to the symbol rate) and QPSK comes out of a single pin.
+ *
+ * The program repeatedly sends a test frame: a 0xAA preamble followed by a counter byte. In
+ * BPSK the preamble alternates the phase every symbol, which is easy to see on a scope. The
+ * timing is printed once at startup.
  *
  * @author Adrián Silva Palafox
  * @date 2025-03-06
@@ -16,80 +26,154 @@
 
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/pwm.h"
-#include "hardware/clocks.h"
+#include "hardware/pio.h"
+#include "psk_mod.h"
+#include "dds_out.h"
+
+// Carrier sources
+#define CARRIER_PIO 0 ///< Square carrier switched by the PIO modulator, DMA bit feed.
+#define CARRIER_DDS 1 ///< Sine carrier from the DDS on a PWM-DAC, phase set per DMA block.
+
+// Modulation settings
+#define MODE PSK_MODE_BPSK         ///< PSK_MODE_BPSK or PSK_MODE_QPSK.
+#define CARRIER_SOURCE CARRIER_PIO ///< CARRIER_PIO or CARRIER_DDS.
+#define CARRIER_HZ 1000000u        ///< Carrier frequency (PIO carrier).
+#define SYMBOL_RATE_HZ 250000u     ///< Symbols per second; CARRIER_HZ must be a multiple of it.
+#define PIN_I 2                    ///< BPSK output, or the I arm for QPSK.
+#define PIN_Q 4                    ///< Q arm (QPSK only).
+#define FRAME_GAP_MS 1             ///< Idle time between test frames (PIO carrier).
+
+// DDS carrier settings
+#define DDS_PIN 6                  ///< PWM-DAC output, followed by an RC low-pass filter.
+#define DDS_TOP 255u               ///< PWM wrap: 8-bit levels at clk_sys / 256 = 488 kS/s.
+#define DDS_CARRIER_MHZ 30000000u  ///< Carrier in millihertz (30 kHz).
+#define DDS_SAMPLES_PER_SYMBOL 64u ///< DMA block length, i.e. 7.6 kBd at 488 kS/s.
+
+#define FRAME_BYTES 8u                              ///< Preamble + counter, a multiple of 4.
+static uint32_t frame_words[FRAME_BYTES / 4u];      ///< Frame being sent (read by DMA).
 
 /**
- * @brief Configures a GPIO pin to output a PWM signal with a 50% duty cycle.
- *
- * @param gpio The GPIO pin number to configure.
- * @param freq_hz The desired frequency of the PWM signal in Hertz.
- * @param inverted If true, the PWM output is inverted (active low). If false, it's normal (active high).
- *
- * @details
- * This function sets up a PWM slice to generate a square wave at a specific frequency.
- * The key to creating the 180-degree phase shift is the `inverted` parameter, which controls
- * the PWM channel's output polarity.
+ * @brief Builds the next test frame: seven 0xAA bytes and a counter.
  */
-void setup_pwm_phase(uint gpio, uint freq_hz, bool inverted)
+static void build_frame(uint8_t counter)
 {
-    // Configure the GPIO pin for PWM functionality
-    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    uint8_t *bytes = (uint8_t *)frame_words;
 
-    // Find out which PWM slice and channel is connected to this GPIO
-    uint slice_num = pwm_gpio_to_slice_num(gpio);
-    uint channel = pwm_gpio_to_channel(gpio);
-
-    // Calculate the clock divider and wrap value to achieve the desired frequency
-    uint32_t clock_freq = clock_get_hz(clk_sys);
-    float divider = (float)clock_freq / (freq_hz * 4096); // Using a common resolution for calculation
-    if (divider < 1.0f) divider = 1.0f; // Hardware minimum divider
-
-    uint32_t wrap = (uint32_t)((float)clock_freq / (divider * freq_hz)) - 1;
+    for (uint32_t i = 0; i < FRAME_BYTES - 1u; i++)
+    {
+        bytes[i] = 0xAA;
+    }
+    bytes[FRAME_BYTES - 1u] = counter;
+}
 
-    // Set the PWM clock divider
-    pwm_set_clkdiv(slice_num, divider);
-    // Set the PWM wrap value, which determines the period
-    pwm_set_wrap(slice_num, wrap);
+#if CARRIER_SOURCE == CARRIER_DDS
 
-    // Set the output polarity. This is how the 180-degree phase shift is created.
-    // One channel is normal, the other is inverted.
-    pwm_set_output_polarity(slice_num, !inverted, inverted);
+static uint16_t dds_buffer[2 * DDS_SAMPLES_PER_SYMBOL]; ///< Ping-pong buffer played by DMA.
 
-    // Set the duty cycle to 50% to create a square wave
-    pwm_set_chan_level(slice_num, channel, wrap / 2);
+/**
+ * @brief DDS block hook: sets the carrier phase of the next symbol.
+ *
+ * Runs in the DMA interrupt before each block is generated. The frame is sent back to back,
+ * and the counter byte is updated whenever the frame starts again.
+ */
+static void dds_symbol_hook(void *ctx, dds_t *dds, uint32_t block)
+{
+    static uint8_t counter = 0;
+    const uint32_t bits_per_symbol = (uint32_t)MODE;
+    const uint32_t symbols_per_frame = FRAME_BYTES * 8u / bits_per_symbol;
+    (void)ctx;
 
-    // Enable the PWM slice
-    pwm_set_enabled(slice_num, true);
+    uint32_t symbol = block % symbols_per_frame;
+    if (symbol == 0)
+    {
+        build_frame(counter++);
+    }
 
-    printf("GPIO %d configured: Freq=%d Hz, Inverted=%s\n", gpio, freq_hz, inverted ? "Yes" : "No");
+    uint32_t bit = symbol * bits_per_symbol;
+    uint8_t value = (uint8_t)((frame_words[bit / 32u] >> (bit % 32u)) & ((1u << bits_per_symbol) - 1u));
+    dds_set_phase_offset(dds, DDS_PHASE_DEG(psk_symbol_phase(MODE, value)));
 }
 
 /**
- * @brief Main function to initialize and configure the BPSK carrier signals.
+ * @brief Sends the test frame continuously on a DDS sine carrier.
  */
-int main()
+static void run_dds_carrier(void)
 {
-    // Initialize stdio for debugging output via USB
-    stdio_init_all();
-    sleep_ms(2000); // Wait for the serial connection to establish
-
-    printf("Configuring PWM signals for BPSK carrier generation...\n");
+    static dds_out_t out;
+    static dds_t dds;
+
+    dds_out_init_pwm(&out, DDS_PIN, DDS_TOP, dds_buffer, DDS_SAMPLES_PER_SYMBOL);
+    dds_init(&dds, out.sample_rate_mhz, DDS_TOP, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&dds, DDS_CARRIER_MHZ);
+    dds_out_set_block_hook(&out, dds_symbol_hook, NULL);
+    dds_out_start(&out, &dds);
+
+    uint64_t symbol_rate_mhz = out.sample_rate_mhz / DDS_SAMPLES_PER_SYMBOL;
+    uint32_t carrier_mhz = dds_frequency_mhz(dds.tuning, out.sample_rate_mhz);
+    printf("%s on DDS: carrier %lu.%03lu Hz, %lu.%03lu Bd\n", (MODE == PSK_MODE_QPSK) ? "QPSK" : "BPSK",
+           (unsigned long)(carrier_mhz / 1000u), (unsigned long)(carrier_mhz % 1000u),
+           (unsigned long)(symbol_rate_mhz / 1000u), (unsigned long)(symbol_rate_mhz % 1000u));
+
+    // Everything happens in the DMA interrupt.
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
 
-    // Define the GPIO pins for the two phases of the carrier signal
-    const uint CARRIER_0_DEG_PIN = 2;   // Represents the 0-degree phase carrier
-    const uint CARRIER_180_DEG_PIN = 4; // Represents the 180-degree phase carrier
+#else
 
-    // Set up the two PWM signals with the same frequency but opposite polarity
-    setup_pwm_phase(CARRIER_0_DEG_PIN, 1000, false); // 1 kHz, normal polarity (0 degrees)
-    setup_pwm_phase(CARRIER_180_DEG_PIN, 1000, true);  // 1 kHz, inverted polarity (180 degrees)
+/**
+ * @brief Sends test frames forever with the PIO modulator.
+ */
+static void run_pio_modulator(void)
+{
+    psk_config_t cfg = {
+        .mode = MODE,
+        .carrier_hz = CARRIER_HZ,
+        .symbol_rate_hz = SYMBOL_RATE_HZ,
+    };
+
+    psk_mod_t mod;
+    int err = psk_mod_init(&mod, pio0, &cfg, PIN_I, PIN_Q);
+    if (err)
+    {
+        printf("PSK configuration rejected (error %d)\n", err);
+        while (true)
+        {
+            tight_loop_contents();
+        }
+    }
 
-    printf("BPSK carrier signals are now active on GPIO %d and GPIO %d.\n", CARRIER_0_DEG_PIN, CARRIER_180_DEG_PIN);
+    printf("%s: carrier %lu.%03lu Hz, %lu carrier periods per symbol, PIO clkdiv %u + %u/256\n",
+           (MODE == PSK_MODE_QPSK) ? "QPSK" : "BPSK",
+           (unsigned long)(mod.timing.carrier_mhz / 1000u), (unsigned long)(mod.timing.carrier_mhz % 1000u),
+           (unsigned long)mod.timing.cycles_per_symbol, mod.timing.clkdiv_int, mod.timing.clkdiv_frac);
 
-    // The main loop is idle as the PWM hardware generates the signals independently.
+    uint8_t counter = 0;
     while (true)
     {
-        tight_loop_contents();
+        // The previous frame is finished, so its buffer can be rewritten.
+        build_frame(counter++);
+        psk_mod_send(&mod, frame_words, FRAME_BYTES / 4u);
+        psk_mod_wait(&mod);
+        sleep_ms(FRAME_GAP_MS);
     }
 }
 
+#endif
+
+/**
+ * @brief Main function: starts the selected modulator.
+ */
+int main()
+{
+    stdio_init_all();
+    sleep_ms(2000); // Wait for the serial connection to establish
+
+#if CARRIER_SOURCE == CARRIER_DDS
+    run_dds_carrier();
+#else
+    run_pio_modulator();
+#endif
+}
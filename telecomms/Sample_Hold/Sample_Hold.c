@@ -3,8 +3,16 @@
  * @author Adrián Silva Palafox (adriansilpa@gmail.com)
  * @brief Drives an external Sample and Hold circuit with a variable sampling frequency.
  * @details This program generates a periodic pulse to control the switch of a Sample and Hold
- *          circuit. The frequency of this pulse (the sampling rate) is controlled by an
- *          analog input, read by the ADC from a potentiometer.
+ *          circuit. The pulse is generated by a PIO state machine (libs/sh_pulse), so its
+ *          timing is independent of the CPU; a new period takes effect at the next period
+ *          boundary without a runt or stretched pulse. The frequency of this pulse (the
+ *          sampling rate) is controlled by a potentiometer, read by the ADC at KNOB_RATE_HZ,
+ *          low-pass filtered and passed through a hysteresis band, and mapped on a
+ *          logarithmic scale from 100 kHz down to about 24 Hz.
+ *
+ *          The ADC, timer and LED go through libs/hal, so with HAL_HOST the program runs as
+ *          a Linux executable on the HAL simulator; there the PIO is replaced by the timing
+ *          model of sh_model.h.
  * @version 0.1
  * @date 2025-02-17
  *
@@ -12,47 +20,75 @@
  *
  */
 #include <stdio.h>
-#include "pico/stdlib.h"
-#include "hardware/gpio.h"
-#include "hardware/adc.h"
-#include "hardware/timer.h"
-#include "hardware/pwm.h"
+#include "hal.h"
+#ifdef HAL_HOST
+#include "sh_model.h"
+#else
+#include "hardware/pio.h"
+#include "sh_pulse.h"
+#endif
 
 // MACROS
-/* Sampling period limits in microseconds */
-#define HZ_100_PERIOD 10000 // 100 Hz
-#define HZ_1000_PERIOD 1000 // 1 kHz
+/* Sampling period range: SH_PERIOD_OCTAVES octaves up from SH_PERIOD_MIN_NS */
+#define SH_PERIOD_MIN_NS SH_MIN_PERIOD_NS // 100 kHz with the potentiometer at 0
+#define SH_PERIOD_OCTAVES SH_OCTAVES      // 4096:1, about 24 Hz at full scale
+#define SH_PULSE_NS 100000                // Switch closed for 100 us, or half the period if shorter
+
+/* Potentiometer filtering */
+#define KNOB_RATE_HZ 50 // Potentiometer readings per second
+#define KNOB_SHIFT 3    // Low-pass time constant: 2^3 readings (160 ms)
+#define KNOB_HYST 24    // ADC counts the filtered reading must move to retune the pulse
 
 /* Pinouts */
 #define INBOARD_LED_PIN 25   // The onboard LED pin.
 #define BJT_BASE_PIN 16      // GPIO pin to control the switch (e.g., a BJT) of the S&H circuit.
-#define ADC_PIN 26           // ADC pin to read the potentiometer for frequency control.
+#define ADC_INPUT 0          // ADC input (GPIO26) reading the potentiometer for frequency control.
 
 // GLOBAL VARIABLES
-int64_t sample_period_us = HZ_1000_PERIOD;      // Initial sample period (1 kHz).
+uint32_t sample_period_ns = SH_PERIOD_MIN_NS;     // Current sample period (100 kHz).
 const float conversion_factor = 3.3f / (1 << 12); // For 12-bit ADC.
 volatile uint16_t adc_reading;
+sh_knob_t knob;                                   // Filter for the potentiometer readings.
 
-/**
- * @brief Calculates the new sampling period based on the ADC reading.
- * @param adc_lec The 12-bit value from the ADC.
- * @details Maps the ADC range (0-4095) to the desired sampling period range (1kHz to 100Hz).
- */
-void update_sample_period(uint16_t adc_lec)
+#ifdef HAL_HOST
+/* No PIO on the host: the timing the driver would queue is computed and kept instead */
+#define SIM_SYS_HZ 125000000u // clk_sys the timing is computed for
+sh_timing_t sh_timing_now;    // Timing last queued.
+
+static int pulse_init(uint32_t period_ns)
 {
-    // Linearly map the ADC value to the sample period range.
-    sample_period_us = adc_lec * (HZ_100_PERIOD - HZ_1000_PERIOD) / 4095 + HZ_1000_PERIOD;
+    return sh_timing(&sh_timing_now, SIM_SYS_HZ, period_ns, SH_PULSE_NS);
 }
 
+static int pulse_set(uint32_t period_ns)
+{
+    return sh_timing(&sh_timing_now, SIM_SYS_HZ, period_ns, SH_PULSE_NS);
+}
+#else
+sh_pulse_t sh_pulse; // PIO pulse output driving the switch.
+
+static int pulse_init(uint32_t period_ns)
+{
+    return sh_pulse_init(&sh_pulse, pio0, BJT_BASE_PIN, period_ns, SH_PULSE_NS);
+}
+
+static int pulse_set(uint32_t period_ns)
+{
+    return sh_pulse_set(&sh_pulse, period_ns, SH_PULSE_NS);
+}
+#endif
+
 // TIMER CALLBACK
 volatile bool timer_flag = false;
 /**
  * @brief Callback function for the repeating timer.
- * @details This function is called when the sampling timer fires. It sets a flag
- *          to trigger the generation of the sampling pulse in the main loop.
+ * @details This function is called KNOB_RATE_HZ times per second. It sets a flag to
+ *          trigger a potentiometer reading in the main loop; the pulse itself does not
+ *          depend on it.
  */
-bool timer_sampler_callback(__unused struct repeating_timer *t)
+bool timer_sampler_callback(hal_timer_t *t)
 {
+    (void)t;
     timer_flag = true;
     return true;
 }
@@ -62,51 +98,49 @@ bool timer_sampler_callback(__unused struct repeating_timer *t)
  */
 int main()
 {
-    stdio_init_all();
-    adc_init();
+    hal_init();
 
     // ADC configuration for the potentiometer
-    adc_gpio_init(ADC_PIN);
-    adc_select_input(0);
+    hal_adc_init(ADC_INPUT);
 
-    // GPIO configuration for the S&H switch control
-    gpio_init(BJT_BASE_PIN);
-    gpio_set_dir(BJT_BASE_PIN, GPIO_OUT);
-    gpio_put(BJT_BASE_PIN, 0); // Ensure the switch is initially off.
+    // PIO pulse for the S&H switch control; the pin idles low (switch off).
+    if (pulse_init(sample_period_ns) != 0)
+    {
+        printf("S&H pulse: period out of range\n");
+    }
+    sh_knob_init(&knob, KNOB_SHIFT, KNOB_HYST);
 
     // PWM configuration for the onboard LED. Note: This seems to be for debug/visual feedback
     // and is not directly related to the sample and hold functionality.
-    gpio_set_function(INBOARD_LED_PIN, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(INBOARD_LED_PIN);
-    pwm_set_wrap(slice_num, 255); // Set a wrap value for the PWM.
-    pwm_set_chan_level(slice_num, pwm_gpio_to_channel(INBOARD_LED_PIN), 128); // 50% duty cycle.
-    pwm_set_enabled(slice_num, true);
+    hal_pwm_init(INBOARD_LED_PIN, 255, 128); // Wrap at 255, 50% duty cycle.
 
-    // Periodic Timer setup
-    struct repeating_timer timer_sampler;
-    add_repeating_timer_us(sample_period_us, timer_sampler_callback, NULL, &timer_sampler);
+    // Periodic Timer setup for the potentiometer readings
+    hal_timer_t timer_sampler;
+    hal_timer_start(&timer_sampler, 1000000 / KNOB_RATE_HZ, timer_sampler_callback, NULL);
 
+    bool pending = false; // A new period waits for room in the PIO FIFO.
     while (true)
     {
-        // Check if it's time to generate a new sample pulse.
         if (timer_flag)
         {
             timer_flag = false;
 
-            // To dynamically change the timer's period, we must cancel and re-initialize it.
-            cancel_repeating_timer(&timer_sampler);
-            add_repeating_timer_us(sample_period_us, timer_sampler_callback, NULL, &timer_sampler);
+            // Read the potentiometer; the period only changes when the filtered
+            // reading leaves the hysteresis band.
+            adc_reading = hal_adc_read();
+            if (sh_knob_update(&knob, adc_reading))
+            {
+                sample_period_ns = sh_period_ns(SH_PERIOD_MIN_NS, SH_PERIOD_OCTAVES, knob.held);
+                pending = true;
+            }
 
-            // Generate a short pulse (100us) on the BJT_BASE_PIN.
-            // This pulse briefly closes the switch in the external S&H circuit, allowing the
-            // capacitor to charge to the input signal's voltage.
-            gpio_put(BJT_BASE_PIN, 1);
-            sleep_us(100);
-            gpio_put(BJT_BASE_PIN, 0);
+            // Queue the new period; the state machine applies it at its next period boundary.
+            if (pending && pulse_set(sample_period_ns) != SH_ERR_BUSY)
+            {
+                pending = false;
+                printf("S&H rate: %lu Hz\n", (unsigned long)(1000000000u / sample_period_ns));
+            }
         }
-
-        // Continuously read the potentiometer to get the desired sampling frequency.
-        adc_reading = adc_read() & 0xFFF0; // Read and clear the last 4 bits to reduce noise.
-        update_sample_period(adc_reading);
+        hal_idle();
     }
 }
@@ -4,9 +4,14 @@
  *
  * This program reads an analog signal from the ADC and uses it to generate
  * several types of modulated signals:
- * - Pulse Width Modulation (PWM)
- * - Pulse Code Modulation (PCM)
- * - A fixed pulse train for Pulse Amplitude Modulation (PAM) demonstration.
+ * - Pulse Width Modulation (PWM), Pulse Position Modulation (PPM) and Pulse Amplitude
+ *   Modulation (PAM): one frame per ADC sample, played by DMA from a sample ring (libs/pulse_mod)
+ *   on a PWM slice and two PIO state machines, so the frame timing does not depend on the speed
+ *   of the main loop. The loop queues every sample of each ADC block.
+ * - Pulse Code Modulation (PCM): the ADC is sampled at a fixed rate by DMA, each block is
+ *   encoded in one pass (4/8/12-bit linear or G.711 mu-law/A-law, libs/pcm_codec) and sent
+ *   to UART1 by DMA.
+ * - A sine carrier from the DDS engine (libs/dds), played on a PWM-DAC by DMA.
  *
  * The generated signals can be observed on GPIO pins or via serial communication.
  *
@@ -17,23 +22,55 @@
 #include "pico/stdlib.h"
 #include "hardware/clocks.h"
 #include "hardware/adc.h"
-#include "hardware/pwm.h"
 #include "hardware/uart.h"
+#include "dds_out.h"
+#include "pulse_mod.h"
+#include "adc_capture.h"
+#include "pcm_codec.h"
+#include "pcm_uart.h"
 
 // ADC CONFIG
 #define ADC_PIN 26           ///< ADC input pin for the modulating signal.
-volatile uint16_t adc_value; ///< Variable to store the 12-bit ADC value.
-uint8_t _8bit_adc;           ///< Variable to store the 8-bit quantized ADC value for PCM.
+#define ADC_INPUT 0          ///< ADC input of ADC_PIN.
 
 // UART CONFIG
 #define UART0_TX_PIN 0   ///< UART0 TX pin.
 #define UART1_TX_PIN 8   ///< UART1 TX pin.
 #define BAUD_RATE 115200 ///< UART baud rate.
 
-// PWM OUTPUT CONFIG
-#define PWM_PWM_PIN 22 ///< GPIO pin for the PWM signal output.
-#define PWM_PAM_PIN 29 ///< GPIO pin for the PAM carrier signal output.
-const uint16_t pwm_duty_pam = 0xFFFF * 0.95; ///< Fixed duty cycle for the PAM carrier pulse.
+// PCM CONFIG
+#define PCM_FORMAT PCM_LINEAR8       ///< PCM_LINEAR4/8/12, PCM_ULAW or PCM_ALAW.
+#define PCM_SAMPLE_RATE_HZ 10000u    ///< ADC sample rate, paced by the ADC clock.
+#define PCM_BLOCK_LENGTH 64u         ///< Samples per block (6.4 ms at 10 kS/s).
+#define PCM_BAUD_RATE 921600         ///< UART1 baud rate for the PCM stream.
+#define PCM_MAX_BYTES ((PCM_BLOCK_LENGTH * 3u + 1u) / 2u) ///< Largest encoded block (12-bit).
+static uint16_t adc_buffer[2 * PCM_BLOCK_LENGTH];  ///< Ping-pong buffer filled by DMA.
+static uint8_t pcm_buffer[2][PCM_MAX_BYTES];       ///< Encoded blocks, one being sent by DMA.
+static adc_capture_t capture;                      ///< Free-running ADC capture.
+static pcm_uart_t pcm_tx;                          ///< DMA sender on UART1.
+
+// PULSE MODULATION CONFIG (PWM, PPM AND PAM)
+#define PULSE_FRAME_HZ PCM_SAMPLE_RATE_HZ ///< Frames per second, one ADC sample per frame.
+#define PULSE_WIDTH_NS 2000u  ///< Width of every PPM and PAM pulse.
+#define PWM_PWM_PIN 22        ///< GPIO pin for the PWM signal output.
+#define PPM_PIN 14            ///< GPIO pin for the PPM output.
+#define PAM_FIRST_PIN 10      ///< Least significant bit of the PAM R-2R ladder.
+#define PAM_BITS 4            ///< PAM ladder resolution (GPIO 10-13).
+static pulse_out_t pwm_out;   ///< PWM modulator.
+static pulse_out_t ppm_out;   ///< PPM modulator.
+static pulse_out_t pam_out;   ///< PAM modulator.
+
+// A whole block is queued while the previous one is still being played
+_Static_assert(PCM_BLOCK_LENGTH < PULSE_OUT_RING_LEN, "an ADC block must fit in the pulse ring");
+
+// DDS CARRIER CONFIG
+#define DDS_CARRIER_PIN 16        ///< PWM-DAC output of the sine carrier (add an RC low-pass filter).
+#define DDS_CARRIER_TOP 255u      ///< PWM wrap: 8-bit levels at clk_sys / 256 = 488 kS/s.
+#define DDS_CARRIER_MHZ 10000000u ///< Carrier frequency in millihertz (10 kHz).
+#define DDS_BLOCK_LENGTH 256u     ///< Levels generated per DMA block.
+static uint16_t dds_buffer[2 * DDS_BLOCK_LENGTH]; ///< Ping-pong buffer played by DMA.
+static dds_out_t dds_carrier_out;                 ///< PWM-DAC output of the carrier.
+static dds_t dds_carrier;                         ///< Carrier generator.
 
 // PROTOTYPES
 
@@ -48,60 +85,80 @@ int main()
     // INITIALIZATION OF PERIPHERALS AND SYSTEM
     stdio_init_all(); // For USB CDC (printf)
     uart_init(uart0, BAUD_RATE);
-    uart_init(uart1, BAUD_RATE);
+    uart_init(uart1, PCM_BAUD_RATE);
     adc_init();
 
     // GPIO ALTERNATE FUNCTION CONFIG
     gpio_set_function(UART0_TX_PIN, GPIO_FUNC_UART);
     gpio_set_function(UART1_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(PWM_PWM_PIN, GPIO_FUNC_PWM);
-    gpio_set_function(PWM_PAM_PIN, GPIO_FUNC_PWM);
     adc_gpio_init(ADC_PIN);
-    adc_select_input(0); // Select ADC0 (GPIO26)
 
-    // PWM CONFIGS
-    pwm_config pwm_config = pwm_get_default_config();
-
-    // Get PWM slice and channel for the PWM output pin
-    uint slice_num_pwm = pwm_gpio_to_slice_num(PWM_PWM_PIN);
-    uint chnn_slice_pwm = pwm_gpio_to_channel(PWM_PWM_PIN);
-    // Get PWM slice and channel for the PAM carrier pin
-    uint slice_num_pam = pwm_gpio_to_slice_num(PWM_PAM_PIN);
-    uint chnn_slice_pam = pwm_gpio_to_channel(PWM_PAM_PIN);
-
-    // Configure PWM for PWM output. The wrap value sets the period.
-    // A wrap of 0xFFF matches the 12-bit resolution of the ADC.
-    pwm_set_wrap(slice_num_pwm, 0x0FFF - 1);
-    // Configure PWM for PAM carrier. A 16-bit wrap value for higher resolution timing.
-    pwm_set_wrap(slice_num_pam, 0xFFFF);
+    // PWM, PPM AND PAM
+    // The PWM slice and the PIO play one frame per word from a DMA ring; the loop queues the
+    // samples. One PWM period is one frame, so the duty cycle follows every ADC sample.
+    int err = pulse_out_init_pwm(&pwm_out, PWM_PWM_PIN, PULSE_FRAME_HZ);
+    if (err == 0)
+    {
+        err = pulse_out_init(&ppm_out, pio0, PULSE_MODE_PPM, PPM_PIN, 0, PULSE_FRAME_HZ, PULSE_WIDTH_NS);
+    }
+    if (err == 0)
+    {
+        err = pulse_out_init(&pam_out, pio0, PULSE_MODE_PAM, PAM_FIRST_PIN, PAM_BITS, PULSE_FRAME_HZ, PULSE_WIDTH_NS);
+    }
+    if (err)
+    {
+        printf("PWM/PPM/PAM configuration rejected (error %d)\n", err);
+        while (true)
+        {
+            tight_loop_contents();
+        }
+    }
+    pulse_out_start(&pwm_out);
+    pulse_out_start(&ppm_out);
+    pulse_out_start(&pam_out);
 
-    // Set the fixed duty cycle for the PAM carrier signal.
-    // Note: This creates a constant pulse train. True PAM would require modulating this amplitude.
-    pwm_set_chan_level(slice_num_pam, chnn_slice_pam, pwm_duty_pam);
-    // Initialize the PWM output to 0.
-    pwm_set_chan_level(slice_num_pwm, chnn_slice_pwm, 0);
+    // DDS CARRIER
+    // The DMA interrupt generates the samples, so the carrier does not depend on the loop below.
+    dds_out_init_pwm(&dds_carrier_out, DDS_CARRIER_PIN, DDS_CARRIER_TOP, dds_buffer, DDS_BLOCK_LENGTH);
+    dds_init(&dds_carrier, dds_carrier_out.sample_rate_mhz, DDS_CARRIER_TOP, DDS_WAVE_SINE);
+    dds_set_frequency_mhz(&dds_carrier, DDS_CARRIER_MHZ);
+    dds_out_start(&dds_carrier_out, &dds_carrier);
 
-    // Enable both PWM slices.
-    pwm_set_enabled(slice_num_pam, true);
-    pwm_set_enabled(slice_num_pwm, true);
+    // PCM
+    // The ADC runs free at PCM_SAMPLE_RATE_HZ, so the sample rate no longer depends on the loop.
+    pcm_uart_init(&pcm_tx, uart1);
+    adc_capture_init(&capture, ADC_INPUT, PCM_SAMPLE_RATE_HZ, adc_buffer, PCM_BLOCK_LENGTH);
+    adc_capture_start(&capture);
+    uint pcm_index = 0;
 
     while (true)
     {
         // 1. Sample the analog signal
-        adc_value = adc_read();
-
-        // 2. Generate Pulse Width Modulation (PWM)
-        // The width of the pulse is directly proportional to the ADC value.
-        pwm_set_chan_level(slice_num_pwm, chnn_slice_pwm, adc_value);
+        // DMA fills one block at a time; every sample of the block goes to every modulator.
+        uint32_t seq;
+        const uint16_t *block = adc_capture_acquire(&capture, &seq);
+        if (block == NULL)
+        {
+            tight_loop_contents();
+            continue;
+        }
 
-        // 3. Generate Pulse Position Modulation (PPM)
-        // Note: The comment mentions PPM is implemented in PIO, but no PIO code is present here.
-        // True PPM would involve shifting the position of a pulse based on the ADC value.
+        // 2. Generate Pulse Width Modulation (PWM), Pulse Position Modulation (PPM) and Pulse
+        // Amplitude Modulation (PAM)
+        // The pulse width (PWM), position (PPM) and height (PAM) of each frame follow one ADC
+        // sample. The block is queued behind the frames of the previous one still being played.
+        pulse_out_queue(&pwm_out, block, PCM_BLOCK_LENGTH);
+        pulse_out_queue(&ppm_out, block, PCM_BLOCK_LENGTH);
+        pulse_out_queue(&pam_out, block, PCM_BLOCK_LENGTH);
 
-        // 4. Generate Pulse Code Modulation (PCM)
-        // The 12-bit ADC value is quantized to an 8-bit value.
-        _8bit_adc = (adc_value * 0xFF) / 0xFFF;
-        // The 8-bit value is transmitted as raw binary data over USB CDC.
-        printf("%c", _8bit_adc);
+        // 3. Generate Pulse Code Modulation (PCM)
+        // The whole block is quantized in one pass and handed to DMA as one transfer. While it
+        // is being sent, the next block is encoded into the other buffer.
+        size_t len = pcm_encode(PCM_FORMAT, block, PCM_BLOCK_LENGTH, pcm_buffer[pcm_index]);
+        if (pcm_uart_send(&pcm_tx, pcm_buffer[pcm_index], len))
+        {
+            pcm_index ^= 1u;
+        }
+        adc_capture_release(&capture);
     }
 }